@@ -0,0 +1,157 @@
+/**
+ * @file audio_cache_index.h
+ * @brief RAM index of the audio files cached on SD, with LRU eviction
+ *
+ * Asking whether a URL's file is cached used to cost an SD exists() per
+ * key — a FAT directory walk that slows down as AUDIO_FILES_DIR fills up.
+ * The index maps a hash of each URL to the file's local path, size, last
+ * play and content checksum. It is held in PSRAM sorted by hash, loaded
+ * from AUDIO_CACHE_INDEX_FILE at boot and written back (via a .tmp rename)
+ * a while after it changes.
+ *
+ * File layout:
+ *
+ *   header    magic, version, record size, count, clock, checksum
+ *   records   urlHash, size, lastPlayed, checksum, path
+ *
+ * When the indexed files outgrow the budget, evict() deletes the least
+ * recently played. The budget is AUDIO_CACHE_BUDGET_BYTES, cut down so that
+ * AUDIO_CACHE_MIN_FREE_BYTES stay free on the card.
+ *
+ * Without an index file (first boot with it, or a damaged file) the index
+ * starts incomplete: the caller probes the card for each key, add()s what
+ * it finds, then calls markComplete(). A miss on a complete index means the
+ * file isn't cached.
+ *
+ * All calls come from loop().
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_CACHE_INDEX_H
+#define AUDIO_CACHE_INDEX_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+#ifndef AUDIO_CACHE_INDEX_FILE
+#define AUDIO_CACHE_INDEX_FILE "/audio_cache.idx"
+#endif
+
+/// Most bytes of audio kept on SD
+#ifndef AUDIO_CACHE_BUDGET_BYTES
+#define AUDIO_CACHE_BUDGET_BYTES (1024ULL * 1024 * 1024)
+#endif
+
+/// Card space left for everything else (logs, catalog, partial downloads)
+#ifndef AUDIO_CACHE_MIN_FREE_BYTES
+#define AUDIO_CACHE_MIN_FREE_BYTES (64ULL * 1024 * 1024)
+#endif
+
+/// Background prefetch stops once the cache fills this much of its budget
+#ifndef AUDIO_CACHE_PREFETCH_PERCENT
+#define AUDIO_CACHE_PREFETCH_PERCENT 90
+#endif
+
+/// Quiet time before a changed index is written back
+#ifndef AUDIO_CACHE_INDEX_SAVE_DELAY_MS
+#define AUDIO_CACHE_INDEX_SAVE_DELAY_MS 10000
+#endif
+
+#ifndef AUDIO_CACHE_PATH_LENGTH
+#define AUDIO_CACHE_PATH_LENGTH 96
+#endif
+
+#define AUDIO_CACHE_INDEX_MAGIC   0x49435042u   ///< "BPCI"
+#define AUDIO_CACHE_INDEX_VERSION 1
+
+// ============================================================================
+// INDEX
+// ============================================================================
+
+class AudioCacheIndex
+{
+public:
+    struct Entry {
+        uint32_t urlHash;
+        uint32_t size;
+        uint32_t lastPlayed;              // Index clock at the latest play (or download)
+        uint32_t checksum;                // CRC-32 of the content, 0 if unknown
+        char path[AUDIO_CACHE_PATH_LENGTH];
+    };
+
+    ~AudioCacheIndex();
+
+    static uint32_t hashUrl(const char* url);
+
+    /**
+     * @brief Replace the index with the one in @p path
+     * @return false if missing, damaged or from another version (index left
+     *         empty and incomplete)
+     */
+    bool load(fs::FS& fs, const char* path);
+
+    /// Write the index to @p path; clears dirty() on success
+    bool save(fs::FS& fs, const char* path);
+
+    const Entry* find(const char* url) const;
+
+    /// Record (or replace) @p url's file; counts as a play. Any other URL
+    /// indexed at the same path is dropped, so eviction can't delete it.
+    bool add(const char* url, const char* path, uint32_t size, uint32_t checksum);
+
+    /// Move @p url to the recent end of the LRU order
+    bool touch(const char* url);
+
+    /// Drop @p url's entry (the file is left alone)
+    bool forget(const char* url);
+
+    /**
+     * @brief Delete least recently played files until the total fits @p budget
+     * @return Number of files deleted
+     */
+    int evict(fs::FS& fs, uint64_t budget);
+
+    /**
+     * @brief Re-read every file with a known checksum; drop and delete the
+     *        ones that no longer match (or are gone)
+     * @return Number of entries dropped
+     */
+    int verify(fs::FS& fs);
+
+    void clear();
+
+    bool complete() const { return indexComplete; }
+    void markComplete();
+    bool dirty() const { return indexDirty; }
+    unsigned long changedAt() const { return lastChange; }
+
+    size_t count() const { return entryCount; }
+    uint64_t totalBytes() const { return total; }
+
+    void printStatus(uint64_t budget) const;
+
+private:
+    int position(uint32_t hash) const;  // Lower bound in the sorted entries
+    bool reserve(size_t capacity);
+    void removeAt(size_t i);
+    void changed();
+
+    Entry* entries = nullptr;           // PSRAM, sorted by urlHash
+    size_t entryCount = 0;
+    size_t entryCapacity = 0;
+    uint64_t total = 0;
+    uint32_t clock = 0;                 // Plays and downloads recorded
+    bool indexComplete = false;
+    bool indexDirty = false;
+    unsigned long lastChange = 0;
+};
+
+/// Global instance used by the audio file manager
+AudioCacheIndex& getAudioCacheIndex();
+
+#endif // AUDIO_CACHE_INDEX_H
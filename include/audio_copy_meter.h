@@ -0,0 +1,154 @@
+/**
+ * @file audio_copy_meter.h
+ * @brief Per-stream copy() instrumentation and adaptive copy sizing
+ *
+ * ExtendedAudioPlayer::copy() pulls one chunk from the source through the
+ * decoder into the output chain. AudioCopyMeter times every call and
+ * records, per stream and since the last reset:
+ *
+ *   bytes in         encoded bytes the AudioPlayer read from the source
+ *   PCM out          bytes that reached the codec (or the output ring)
+ *   write blocked    time spent inside the codec/ring write (DMA full)
+ *   decode           the rest of the call: read, decode, volume, mixing
+ *   duration         log2 histogram of whole copy() calls
+ *
+ * The chunk size handed to AudioPlayer::copy() adapts so a call stays
+ * within AUDIO_COPY_BUDGET_US: it halves when a call runs over and grows
+ * by AUDIO_COPY_STEP_BYTES while calls take under half the budget, between
+ * AUDIO_COPY_MIN_BYTES and AUDIO_COPY_BUFFER_SIZE. loop() then gets
+ * control back at a predictable rate whatever the codec and bitrate.
+ *
+ * Written only by the task that drives the player with plain stores;
+ * readers take a snapshot copy, so fields may be a call apart.
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_COPY_METER_H
+#define AUDIO_COPY_METER_H
+
+#include <Arduino.h>
+#include <config.h>
+#include "AudioTools/CoreAudio/BaseStream.h"
+
+using namespace audio_tools;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Target duration of one copy() call
+#ifndef AUDIO_COPY_BUDGET_US
+#define AUDIO_COPY_BUDGET_US 8000
+#endif
+
+/// Smallest chunk the adaptive size shrinks to
+#ifndef AUDIO_COPY_MIN_BYTES
+#define AUDIO_COPY_MIN_BYTES 256
+#endif
+
+/// Growth per call while comfortably under budget
+#ifndef AUDIO_COPY_STEP_BYTES
+#define AUDIO_COPY_STEP_BYTES 256
+#endif
+
+/// Growth cap in effect, AUDIO_COPY_MIN_BYTES..AUDIO_COPY_BUFFER_SIZE
+/// (runtime tunable "a.copymax")
+extern int32_t audioCopyMaxBytes;
+
+/// Duration histogram: first bucket is < this, each next one doubles (last is open-ended)
+#define AUDIO_COPY_HISTOGRAM_BUCKETS 8
+#define AUDIO_COPY_HISTOGRAM_FIRST_US 250
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+struct AudioCopyStats {
+    uint32_t copies;          // copy() calls with a stream playing
+    uint32_t idleCopies;      // Calls that moved no input
+    uint32_t bytesIn;         // Encoded bytes read from the source
+    uint32_t pcmOut;          // PCM bytes written to the codec/ring
+    uint64_t copyUs;          // Total time in copy()
+    uint32_t copyMaxUs;
+    uint64_t blockedUs;       // Part of copyUs spent blocked in the codec/ring write
+    uint32_t overBudget;      // Calls longer than AUDIO_COPY_BUDGET_US
+    uint32_t duration[AUDIO_COPY_HISTOGRAM_BUCKETS];
+};
+
+// ============================================================================
+// OUTPUT STAGE
+// ============================================================================
+
+/**
+ * @brief Pass-through stage in front of the codec that counts PCM and write time
+ */
+class AudioWriteMeter : public AudioStream
+{
+public:
+    void setOutput(AudioStream& output) { _output = &output; }
+
+    size_t write(const uint8_t* data, size_t len) override;
+    size_t readBytes(uint8_t* data, size_t len) override { return 0; }
+    int availableForWrite() override { return _output ? _output->availableForWrite() : 0; }
+    void setAudioInfo(AudioInfo info) override;
+
+    uint32_t bytes() const { return _bytes; }
+    uint32_t blockedUs() const { return _blockedUs; }
+    AudioInfo format() const { return _format; }
+
+private:
+    AudioStream* _output = nullptr;
+    AudioInfo _format = AUDIO_INFO_DEFAULT();
+    uint32_t _bytes = 0;              // Running totals; AudioCopyMeter takes deltas
+    uint32_t _blockedUs = 0;
+};
+
+// ============================================================================
+// METER
+// ============================================================================
+
+class AudioCopyMeter
+{
+public:
+    /// Stage to place between the mixer and the codec (or output ring)
+    AudioWriteMeter& getOutputStage() { return stage; }
+
+    /// Start per-stream counters for @p key (keeps the adapted chunk size)
+    void beginStream(const char* key);
+
+    /// Chunk size to pass to AudioPlayer::copy()
+    size_t nextCopyBytes() const { return copyBytes; }
+
+    /// Call before AudioPlayer::copy()
+    void startCopy();
+    /// Call after it, with the bytes it returned; adapts the chunk size
+    void endCopy(size_t bytesIn);
+
+    /// PCM written to the codec since boot (advances while anything plays)
+    uint32_t pcmOutTotal() const { return stage.bytes(); }
+
+    AudioCopyStats getStreamStats() const { return streamStats; }
+    AudioCopyStats getTotalStats() const { return totalStats; }
+    /// Zero the totals (applied by the player's task at its next copy())
+    void requestReset() { resetRequested = true; }
+    void printStats() const;
+
+private:
+    AudioWriteMeter stage;
+    AudioCopyStats streamStats = {};
+    AudioCopyStats totalStats = {};
+    char streamKey[64] = {0};
+    size_t copyBytes = AUDIO_COPY_BUFFER_SIZE / 4;
+    volatile bool resetRequested = false;
+
+    // Snapshot taken by startCopy()
+    uint32_t startUs = 0;
+    uint32_t startPcm = 0;
+    uint32_t startBlockedUs = 0;
+
+    static void add(AudioCopyStats& s, uint32_t us, size_t bytesIn, uint32_t pcm, uint32_t blocked);
+    static void printLine(const char* label, const AudioCopyStats& s, const AudioInfo& info);
+};
+
+#endif // AUDIO_COPY_METER_H
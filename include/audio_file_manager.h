@@ -38,6 +38,9 @@ using namespace audio_tools;
 #ifndef CACHE_ETAG_FILE
 #define CACHE_ETAG_FILE "/audio_cache_etag.txt"
 #endif
+#ifndef CACHE_VALIDATORS_FILE
+#define CACHE_VALIDATORS_FILE "/audio_cache_http.txt"  ///< Catalog response ETag / Last-Modified
+#endif
 #ifndef CACHE_CHECK_INTERVAL_MS
 #define CACHE_CHECK_INTERVAL_MS 300000  ///< Lightweight cache check interval (5 minutes)
 #endif
@@ -47,15 +50,24 @@ using namespace audio_tools;
 #ifndef MAX_AUDIO_FILES
 #define MAX_AUDIO_FILES 50      ///< Maximum number of known sequences
 #endif
-#ifndef MAX_HTTP_RESPONSE_SIZE
-#define MAX_HTTP_RESPONSE_SIZE 8192 ///< Maximum HTTP response size
-#endif
 #ifndef AUDIO_FILES_DIR
 #define AUDIO_FILES_DIR "/audio"    ///< Directory for cached audio files
 #endif
 #ifndef MAX_FILENAME_LENGTH
 #define MAX_FILENAME_LENGTH 64      ///< Maximum length for generated filenames
 #endif
+#ifndef DIAL_STATS_MAX
+#define DIAL_STATS_MAX 48           ///< Keys whose dial counts are remembered
+#endif
+#ifndef DIAL_STATS_HALF_LIFE
+#define DIAL_STATS_HALF_LIFE 32     ///< Dials after which a key's count weighs half
+#endif
+#ifndef DIAL_STATS_SAVE_DELAY_MS
+#define DIAL_STATS_SAVE_DELAY_MS 30000 ///< Quiet time before changed dial stats go to NVS
+#endif
+#ifndef DIAL_PREDICT_FILES
+#define DIAL_PREDICT_FILES 2        ///< Missing files fetched ahead for one partial dial
+#endif
 
 // ============================================================================
 // FUNCTION DECLARATIONS
@@ -68,9 +80,32 @@ using namespace audio_tools;
  * Loads cached audio files from SD card if available.
  *
  * @return AudioSource pointer if SD card available and initialized, nullptr otherwise
+ *
+ * Same as mountAudioStorage() followed by loadAudioCatalog().
  */
 AudioSource *initializeAudioFileManager();
 
+/**
+ * @brief First half of initializeAudioFileManager(): mount the SD card and
+ * load the cache index
+ *
+ * Doesn't touch the AudioKeyRegistry, so it can run on a boot task while
+ * the main loop already plays generators.
+ *
+ * @return AudioSource pointer if SD card available and initialized, nullptr otherwise
+ */
+AudioSource *mountAudioStorage();
+
+/**
+ * @brief Second half: register the SD catalog cache and queue missing files
+ *
+ * Writes the registry — call it from the task that plays audio, after
+ * mountAudioStorage() returned.
+ *
+ * @return Entries registered (0 without SD or cache)
+ */
+int loadAudioCatalog();
+
 /**
  * @brief Download audio file list from remote server
  * @return true if download successful, false otherwise
@@ -178,13 +213,84 @@ int getDownloadQueueCount();
 bool isDownloadQueueEmpty();
 
 /**
- * @brief Pre-cache DNS resolutions before VPN tunnel starts
- * 
- * Resolves hostnames used by audio file manager and caches the IP addresses.
- * Call this BEFORE starting WireGuard/VPN, as the tunnel may break public DNS.
- * Subsequent HTTP requests will use cached IPs if DNS fails.
+ * @brief Hold background downloads (e.g. while the handset is off-hook)
+ *
+ * Queued and active prefetch, catalog and log transfers wait until
+ * resumed; files requested with requestAudioFileNow() or predicted from
+ * the dial in progress still run.
+ */
+void setAudioDownloadsSuspended(bool suspended);
+
+/**
+ * @brief Download a key's file ahead of everything else
+ *
+ * For a dialed key whose file is missing from SD and couldn't be streamed.
+ * The file is queued (or its queued download promoted) as interactive, so
+ * it runs even while downloads are suspended and may pause a prefetch.
+ *
+ * @param audioKey Registry key with a URL source
+ * @return true if the file is queued
+ */
+bool requestAudioFileNow(const char* audioKey);
+
+// ============================================================================
+// DIAL STATISTICS AND PREDICTION
+// ============================================================================
+
+/**
+ * @brief Count a dial of @p audioKey
+ *
+ * Per-key dial counts and recency decide which missing files the download
+ * queue fetches first. They persist in NVS, written once the player has
+ * been idle for DIAL_STATS_SAVE_DELAY_MS after a change.
+ */
+void recordAudioKeyDialed(const char* audioKey);
+
+/**
+ * @brief Fetch ahead the files a partial dial may reach
+ *
+ * Ranks @p audioKeys by dial statistics and queues the first
+ * DIAL_PREDICT_FILES that are missing from SD as predicted downloads, which
+ * start ahead of background work and run while downloads are suspended.
+ * Earlier predictions not repeated here drop back to background prefetch.
+ *
+ * @param audioKeys Keys the digits so far can still complete to
+ * @param count Number of keys
+ * @return Number of files queued or promoted
+ */
+int predictAudioKeys(const char* const* audioKeys, int count);
+
+/**
+ * @brief Return all predicted downloads to background prefetch
+ *
+ * Call when the dial is over (matched, reset or hung up).
+ */
+void clearAudioPrediction();
+
+/**
+ * @brief Note that a key's file started playing from SD
+ *
+ * Moves it to the recent end of the cache index's LRU order so eviction
+ * takes files nobody plays first.
+ */
+void noteAudioFilePlayed(const char* audioKey);
+
+/**
+ * @brief Print the SD cache index (files, sizes, play order) and budget
+ */
+void printAudioCacheStatus();
+
+/**
+ * @brief Re-read every cached file against its size and checksum
+ * @return Number of damaged or missing files dropped (and deleted)
+ * @note Reads the whole cache — a debug-console operation
+ */
+int verifyAudioCache();
+
+/**
+ * @brief Print per-key dial statistics, hottest first
  */
-void preCacheDNS();
+void printDialStats();
 
 /**
  * @brief Register a single audio entry with the AudioKeyRegistry and create its playlist
@@ -0,0 +1,139 @@
+/**
+ * @file audio_file_stream.h
+ * @brief PSRAM read-ahead for SD file playback, filled by a reader task
+ *
+ * Handing the SD File straight to the decoder turns every small decoder
+ * read (Helix asks for a few hundred bytes at a time) into a VFS + FatFs
+ * call on the decode path. Each one waits for the card, and while WebQueue
+ * is writing a download to the same card that wait can be long enough to
+ * be heard.
+ *
+ * FileReadaheadStream takes over the open File and keeps up to
+ * AUDIO_FILE_READAHEAD_BYTES of it in PSRAM, split into blocks of
+ * AUDIO_FILE_READ_BLOCK. A reader task (core 1, with the rest of the SD
+ * I/O) refills each block as soon as the decoder has finished with it.
+ * Every read is one whole block at a block-aligned file offset, so the
+ * card sees few large cluster-aligned reads. readBytes() copies from
+ * memory; it only waits (bounded by AUDIO_FILE_WAIT_MS) when the reader
+ * has fallen behind entirely, and that wait is counted as an underrun.
+ *
+ * One stream is open at a time; open() and close() come from the task
+ * that drives the player.
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_FILE_STREAM_H
+#define AUDIO_FILE_STREAM_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "AudioTools/CoreAudio/BaseStream.h"
+
+using namespace audio_tools;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// File bytes held ahead of the decoder (a multiple of AUDIO_FILE_READ_BLOCK)
+#ifndef AUDIO_FILE_READAHEAD_BYTES
+#define AUDIO_FILE_READAHEAD_BYTES 32768
+#endif
+
+/// Bytes per SD read; a multiple of the FAT cluster size keeps reads aligned
+#ifndef AUDIO_FILE_READ_BLOCK
+#define AUDIO_FILE_READ_BLOCK 8192
+#endif
+
+/// Longest readBytes() waits for the reader when nothing is buffered
+#ifndef AUDIO_FILE_WAIT_MS
+#define AUDIO_FILE_WAIT_MS 50
+#endif
+
+/// Above the decode task, so a freed block is refilled at once
+#ifndef AUDIO_FILE_READER_PRIORITY
+#define AUDIO_FILE_READER_PRIORITY 4
+#endif
+
+#define AUDIO_FILE_READ_BLOCKS (AUDIO_FILE_READAHEAD_BYTES / AUDIO_FILE_READ_BLOCK)
+
+// ============================================================================
+// READ-AHEAD STREAM
+// ============================================================================
+
+/// Counters since boot
+struct FileReadaheadStats {
+    uint32_t files;           // Files played through the read-ahead
+    uint32_t reads;           // SD reads made by the reader
+    uint32_t bytesRead;
+    uint32_t maxReadUs;       // Slowest single SD read
+    uint32_t underruns;       // readBytes() found nothing buffered (episodes)
+    uint32_t waitMs;          // Time readBytes() spent waiting for the reader
+};
+
+class FileReadaheadStream : public AudioStream
+{
+public:
+    ~FileReadaheadStream();
+
+    /**
+     * @brief Take over an open file and start reading ahead from its position
+     * @param file Open SD file; left empty, the stream now owns the handle
+     * @return false (file untouched) if there's no PSRAM or reader task —
+     *         play the File directly
+     */
+    bool open(File& file);
+
+    /// Stop the reader and close the file
+    void close();
+    bool isOpen() const { return _open; }
+
+    size_t readBytes(uint8_t* data, size_t len) override;
+    size_t write(const uint8_t* data, size_t len) override { return 0; }
+
+    /// Bytes of the file the decoder has not read yet
+    int available() override;
+
+    size_t size() const { return _size; }
+    size_t position() const { return _position; }
+
+    /// Bytes buffered ahead of the decoder
+    size_t level() const;
+
+    FileReadaheadStats getStats() const { return stats; }
+    void printStatus() const;
+
+private:
+    File _file;                       // Reader task only, under _lock
+    bool _open = false;
+    bool _unavailable = false;        // No PSRAM or task: open() always declines
+    size_t _size = 0;
+    size_t _position = 0;             // Next byte the decoder gets
+
+    // Blocks (allocated on first open and kept, so PSRAM doesn't fragment)
+    uint8_t* _blocks = nullptr;
+    uint32_t _blockLen[AUDIO_FILE_READ_BLOCKS] = {0};
+    volatile uint32_t _filled = 0;    // Blocks the reader has produced
+    volatile uint32_t _consumed = 0;  // Blocks the decoder has finished
+    size_t _blockOffset = 0;          // Decoder's offset in block _consumed
+    size_t _fileOffset = 0;           // Where the reader reads next
+    volatile bool _eof = false;       // Reader reached the end (or a read failed)
+    bool _starved = false;            // Inside an underrun episode
+
+    SemaphoreHandle_t _lock = nullptr;       // Held around file access
+    SemaphoreHandle_t _dataReady = nullptr;  // Given after each block
+    TaskHandle_t _reader = nullptr;
+
+    FileReadaheadStats stats = {};
+
+    bool start();
+    /// Read one block if there's room; false with nothing to do
+    bool fillBlock();
+    static void readerTask(void* arg);
+};
+
+#endif // AUDIO_FILE_STREAM_H
@@ -17,10 +17,11 @@
 #include <config.h>
 #include "AudioTools.h"
 #include "AudioTools/CoreAudio/AudioEffects/SoundGenerator.h"
-#include <map>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
+#include "psram_alloc.h"
 
 using namespace audio_tools;
 
@@ -57,6 +58,8 @@ struct AudioLink {
     std::string audioKey;            ///< Audio key name (owned copy)
     AudioTiming timing;              ///< Playback timing metadata
 
+    PSRAM_OBJECT_ALLOC
+
     AudioLink() = default;
     AudioLink(const char* key, AudioTiming t = {})
         : audioKey(key ? key : ""), timing(t) {}
@@ -69,6 +72,8 @@ struct FileData {
     std::string path;            ///< Local file path (for FILE_STREAM)
     std::string alternatePath;   ///< Original URL for streaming fallback
     std::string ext;             ///< File extension (e.g., "wav", "mp3")
+
+    PSRAM_OBJECT_ALLOC
 };
 
 /**
@@ -83,6 +88,7 @@ struct AudioEntry {
     AudioStreamType type;           ///< Discriminant
     AudioTiming timing;              ///< Playback timing metadata
     uint32_t contentHash = 0;        ///< Hash of source JSON for change detection
+    uint16_t versions = 1;           ///< Registry versions holding this entry (registry-internal, never copied)
     AudioLink* previous = nullptr;   ///< Audio to play before this entry (owned, nullable)
     AudioLink* next     = nullptr;   ///< Audio to play after this entry (owned, nullable)
 
@@ -91,6 +97,8 @@ struct AudioEntry {
         SoundGenerator<int16_t>* generator; ///< Not owned. Valid when type is GENERATOR
     };
 
+    PSRAM_OBJECT_ALLOC
+
     AudioEntry() : type(AudioStreamType::NONE), file(nullptr) {}
 
     /**
@@ -187,6 +195,24 @@ typedef const char* (*AudioKeyResolverCallback)(const char* audioKey);
  */
 typedef bool (*AudioKeyExistsCallback)(const char* audioKey);
 
+// ============================================================================
+// KEY IDS
+// ============================================================================
+
+/**
+ * @brief Small integer naming a registered key
+ *
+ * Stable for as long as the key stays registered (re-registering a key
+ * keeps its ID). IDs of unregistered keys are reused.
+ */
+typedef uint16_t AudioKeyId;
+static constexpr AudioKeyId AUDIO_KEY_NONE = 0xFFFF;
+
+/// Initial slot count of the key index (power of two, grows at 3/4 load)
+#ifndef AUDIO_KEY_INDEX_INITIAL_SLOTS
+#define AUDIO_KEY_INDEX_INITIAL_SLOTS 64
+#endif
+
 // ============================================================================
 // AUDIO KEY REGISTRY
 // ============================================================================
@@ -194,23 +220,85 @@ typedef bool (*AudioKeyExistsCallback)(const char* audioKey);
 /**
  * @brief Registry for mapping audioKeys to audio resources
  * 
- * Uses a single unified map where each entry can represent either:
+ * Each entry can represent either:
  * - A file path (FILE_STREAM)
  * - A URL (URL_STREAM)  
  * - A tone generator (GENERATOR)
  * 
+ * Entries are held by key ID. Lookups go through an open-addressing hash
+ * index (kept in PSRAM when available) that compares the caller's
+ * const char* directly against the stored keys, so no temporary
+ * std::string is built on the hot paths (dialed digits, playback checks).
+ * 
+ * The key set is versioned. A batch of changes (a catalog refresh) goes to
+ * a draft from beginUpdate() and is published by commitUpdate() with one
+ * atomic pointer swap, so lookups never take a lock and never see half an
+ * update. Unchanged entries are shared between versions and copied only
+ * when a draft changes them. A replaced version is freed by
+ * reclaimRetired() once no ReadGuard is alive and the player is idle.
+ * Calling the register/unregister methods on the published registry itself
+ * still changes it in place: fine at boot and from the loop task while
+ * nothing else reads, otherwise go through an update.
+ * 
  * Can be subclassed to provide custom resolution logic.
  */
 class AudioKeyRegistry {
 public:
     AudioKeyRegistry() = default;
-    virtual ~AudioKeyRegistry() = default;
+    virtual ~AudioKeyRegistry();
+    AudioKeyRegistry(const AudioKeyRegistry&) = delete;
+    AudioKeyRegistry& operator=(const AudioKeyRegistry&) = delete;
     
     // ========================================================================
     // KEY REGISTRATION
     // ========================================================================
     static AudioKeyRegistry instance;
 
+    // ========================================================================
+    // VERSIONS
+    // ========================================================================
+    
+    /**
+     * @brief Start a batch of changes on a private copy of the key set
+     * 
+     * The draft shares this registry's entries and callbacks. Register and
+     * unregister on it freely; readers of this registry don't see any of it.
+     * @return The draft (pass to commitUpdate() or abortUpdate()), or
+     *         nullptr when out of memory
+     */
+    AudioKeyRegistry* beginUpdate() const;
+    
+    /// Publish a draft's key set with one atomic swap; frees the draft object
+    void commitUpdate(AudioKeyRegistry* draft);
+    
+    /// Throw a draft away; readers never saw it
+    void abortUpdate(AudioKeyRegistry* draft) { delete draft; }
+    
+    /**
+     * @brief Free replaced versions no reader can still be using
+     * @param playerIdle Asked after the ReadGuard check: true if no playback
+     *        holds entries from an old version (nullptr = always idle)
+     * @return Number of versions freed
+     */
+    size_t reclaimRetired(bool (*playerIdle)());
+    
+    /// Replaced versions not yet freed
+    size_t retiredCount() const { return retired.size(); }
+    
+    /**
+     * @brief Held by tasks other than the loop task while they look keys up
+     * 
+     * Retired versions stay allocated while any guard is alive. The audio
+     * decode task holds one around each command it runs.
+     */
+    class ReadGuard {
+    public:
+        ReadGuard() { readers.fetch_add(1); }
+        ~ReadGuard() { readers.fetch_sub(1); }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
     /**
      * @brief Register a path-based audioKey (file or URL)
      * @param audioKey The key name
@@ -311,6 +399,20 @@ public:
      */
     virtual SoundGenerator<int16_t>* getGenerator(const char* audioKey) const;
     
+    /**
+     * @brief ID of a registered key (AUDIO_KEY_NONE if not registered)
+     * @param len Key length, for keys that are not NUL-terminated
+     * @note Only the registry itself is searched, not the fallback callbacks
+     */
+    AudioKeyId findKeyId(const char* audioKey) const;
+    AudioKeyId findKeyId(const char* audioKey, size_t len) const;
+    
+    /// Entry for a key ID (nullptr if the ID is free)
+    const AudioEntry* getEntry(AudioKeyId id) const;
+    
+    /// Key name for a key ID (nullptr if the ID is free)
+    const char* getKeyName(AudioKeyId id) const;
+    
     /**
      * @brief Resolve an audioKey to its resource path
      * @return The path/URL, or nullptr if not found or is a generator
@@ -343,17 +445,50 @@ public:
     /**
      * @brief Get the number of registered keys
      */
-    size_t size() const { return registry.size(); }
+    size_t size() const { return current().liveCount; }
+    
+    /**
+     * @brief Changes whenever a key is added or removed
+     *
+     * Lets caches built over the key set (e.g. the dial trie) notice
+     * that they are stale without being told.
+     */
+    uint32_t getGeneration() const { return current().generation; }
+    
+    /**
+     * @brief Iterates registered entries in key ID order as {key, entry} pairs
+     *
+     * Walks the version published when begin() was called.
+     */
+    class const_iterator {
+    public:
+        using value_type = std::pair<const char*, const AudioEntry&>;
+        
+        const_iterator(const PsramVector<AudioEntry*>& entries, size_t pos)
+            : entries(&entries), pos(pos) { skipFree(); }
+        value_type operator*() const {
+            const AudioEntry& e = *(*entries)[pos];
+            return value_type(e.audioKey.c_str(), e);
+        }
+        const_iterator& operator++() { ++pos; skipFree(); return *this; }
+        bool operator!=(const const_iterator& o) const { return pos != o.pos; }
+        bool operator==(const const_iterator& o) const { return pos == o.pos; }
+        
+    private:
+        const PsramVector<AudioEntry*>* entries;
+        size_t pos;
+        void skipFree() { while (pos < entries->size() && !(*entries)[pos]) ++pos; }
+    };
     
     /**
      * @brief Get iterator to beginning of registry
      */
-    std::map<std::string, AudioEntry>::const_iterator begin() const { return registry.begin(); }
+    const_iterator begin() const { return const_iterator(current().entries, 0); }
     
     /**
      * @brief Get iterator to end of registry
      */
-    std::map<std::string, AudioEntry>::const_iterator end() const { return registry.end(); }
+    const_iterator end() const { return const_iterator(current().entries, current().entries.size()); }
     
     /**
      * @brief List all registered keys to serial output
@@ -363,12 +498,69 @@ public:
     void listKeys() const;
     
 protected:
-    // Unified registry - single map for all entry types
-    std::map<std::string, AudioEntry> registry;
+    /**
+     * @brief One version of the key set
+     * 
+     * Entries are shared between versions (AudioEntry::versions counts the
+     * holders); a version copies an entry before changing one it shares.
+     */
+    struct KeySet {
+        // Entries by key ID (nullptr = free ID, listed in freeIds).
+        // Entries, their FileData/AudioLinks and these tables live in PSRAM.
+        PsramVector<AudioEntry*> entries;
+        PsramVector<AudioKeyId> freeIds;
+        size_t liveCount = 0;
+        
+        // Open-addressing index: slot -> key ID, with the key's hash alongside
+        // so most probes never touch the key string
+        AudioKeyId* indexIds = nullptr;
+        uint32_t* indexHashes = nullptr;
+        size_t indexSlots = 0;          // Power of two
+        size_t indexUsed = 0;           // Live + tombstone slots
+        uint32_t generation = 0;
+        
+        // Owns dynamically-created generators (from JSON config), together
+        // with the other versions still listing them.
+        // Static generators (dialtone, ringback) are NOT in this list.
+        PsramVector<std::shared_ptr<SoundGenerator<int16_t>>> ownedGenerators;
+        
+        PSRAM_OBJECT_ALLOC
+        
+        KeySet() = default;
+        KeySet(const KeySet&) = delete;
+        KeySet& operator=(const KeySet&) = delete;
+        ~KeySet();
+        
+        // Copy sharing every entry; nullptr when out of memory
+        KeySet* clone() const;
+        void clear();
+        // Slot holding the key, or -1
+        int findSlot(const char* key, size_t len, uint32_t hash) const;
+        AudioKeyId findKeyId(const char* key, size_t len) const;
+        AudioEntry* lookup(const char* audioKey) const;
+        // This version's own copy of an entry, safe to change
+        AudioEntry* own(AudioKeyId id);
+        AudioEntry* ownByKey(const char* audioKey);
+        // Own entry for the key, creating it (and its ID) if missing; nullptr if the index is full
+        AudioEntry* entryFor(const char* audioKey);
+        // Move @p entry into the key's slot (keeps the key's ID)
+        void store(const char* audioKey, AudioEntry&& entry);
+        void removeKey(const char* audioKey);
+        bool growIndex();
+    };
+    
+    static uint32_t hashKey(const char* key, size_t len);
+    static void release(AudioEntry* e);
+    
+    // Published version; nullptr until the first write
+    std::atomic<KeySet*> keys{nullptr};
+    // Versions replaced by commitUpdate(), freed by reclaimRetired()
+    PsramVector<KeySet*> retired;
+    // Live ReadGuards, across all registries
+    static std::atomic<int> readers;
     
-    // Owns dynamically-created generators (from JSON config).
-    // Static generators (dialtone, ringback) are NOT in this list.
-    std::vector<std::unique_ptr<SoundGenerator<int16_t>>> ownedGenerators;
+    const KeySet& current() const;
+    KeySet& writable();
     
     // Dynamic resolution callbacks (fallback when key not in registry)
     AudioKeyResolverCallback keyResolver = nullptr;
@@ -0,0 +1,142 @@
+/**
+ * @file audio_mixer.h
+ * @brief Output gain and overlay mixer between the player and the codec
+ *
+ * The main stream (whatever ExtendedAudioPlayer is decoding) passes through
+ * write() scaled by the master volume (setMainGain()), with the overlays
+ * summed into it. At full gain with no overlay the bytes pass untouched;
+ * otherwise the gain and the mix are one Q15 pass over each block. Each overlay
+ * channel plays a registered generator or a clip already held in the
+ * decoded-PCM cache, with its own gain and optional duration, so a click
+ * or warning tone can sit on top of a clip or the dial tone without
+ * stopping the main stream or re-initializing its decoder.
+ *
+ * When no main stream is playing, ExtendedAudioPlayer::copy() calls pump()
+ * to write the overlays over silence.
+ *
+ * Mixing accumulates in int32 with Q15 gains. A sum past
+ * AUDIO_MIXER_LIMIT_KNEE is bent towards full scale by a soft limiter
+ * (AUDIO_MIXER_SOFT_LIMIT) rather than clipped. Overlays are
+ * rendered in the default format (AUDIO_INFO_DEFAULT()); while the main
+ * stream runs at another rate or channel count they hold their place
+ * rather than play at the wrong pitch. Overlays advance only by what the
+ * output accepted: a generator's samples that didn't get written are held
+ * for the caller's retry. All calls come from the task that drives the
+ * player.
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include <Arduino.h>
+#include <config.h>
+#include "AudioTools/CoreAudio/BaseStream.h"
+#include "AudioTools/CoreAudio/AudioEffects/SoundGenerator.h"
+#include "audio_pcm_cache.h"
+
+using namespace audio_tools;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Simultaneous overlays on top of the main stream
+#ifndef AUDIO_MIXER_CHANNELS
+#define AUDIO_MIXER_CHANNELS 3
+#endif
+
+/// Samples mixed per pass (bounds the stack scratch buffers)
+#ifndef AUDIO_MIXER_BLOCK_SAMPLES
+#define AUDIO_MIXER_BLOCK_SAMPLES 256
+#endif
+
+/// Bytes written per pump() while only overlays are playing
+#ifndef AUDIO_MIXER_PUMP_BYTES
+#define AUDIO_MIXER_PUMP_BYTES 512
+#endif
+
+/// 1 = soft-limit mixed samples above the knee; 0 = saturate at full scale
+#ifndef AUDIO_MIXER_SOFT_LIMIT
+#define AUDIO_MIXER_SOFT_LIMIT 1
+#endif
+
+/// Level the soft limiter starts at (24576 = -2.5 dBFS)
+#ifndef AUDIO_MIXER_LIMIT_KNEE
+#define AUDIO_MIXER_LIMIT_KNEE 24576
+#endif
+
+// ============================================================================
+// MIXER
+// ============================================================================
+
+class AudioOverlayMixer : public AudioStream
+{
+public:
+    void setOutput(AudioStream& output) { _output = &output; }
+    AudioStream* getOutput() const { return _output; }
+
+    /// Gain on the main stream, 0.0–1.0 (overlays carry their own)
+    void setMainGain(float gain);
+    float getMainGain() const { return _mainGainQ15 / 32768.0f; }
+
+    /**
+     * @brief Start a generator overlay
+     * @param key        Name reported by isPlaying()
+     * @param generator  Already-registered generator (not the one the main stream uses)
+     * @param gain       0.0–1.0
+     * @param durationMs 0 = until stop()
+     * @return Channel index, or -1 if all channels are busy
+     */
+    int start(const char* key, SoundGenerator<int16_t>* generator, float gain, unsigned long durationMs);
+
+    /// Start a cached-clip overlay (pinned until it ends); -1 if busy or the format differs
+    int start(const char* key, const PcmCacheEntry* clip, float gain, unsigned long durationMs);
+
+    void stop(const char* key);
+    void stopAll();
+
+    bool isActive() const;
+    bool isPlaying(const char* key) const;
+
+    /// Write @p bytes of overlays over silence (only while no main stream plays)
+    size_t pump(size_t bytes);
+
+    // AudioStream: main stream pass-through
+    size_t write(const uint8_t* data, size_t len) override;
+    size_t readBytes(uint8_t* data, size_t len) override { return 0; }
+    int availableForWrite() override { return _output ? _output->availableForWrite() : 0; }
+    void setAudioInfo(AudioInfo info) override;
+
+private:
+    struct Channel {
+        bool active;
+        char key[32];
+        SoundGenerator<int16_t>* generator;
+        const PcmCacheEntry* clip;
+        size_t clipPos;               // Bytes of the clip already played
+        int32_t gainQ15;
+        uint32_t remainingSamples;    // 0 = unlimited
+        size_t mixed;                 // Samples mixed into the block being written
+        size_t heldSamples;           // Generator output read but not yet written
+        int16_t held[AUDIO_MIXER_BLOCK_SAMPLES];
+    };
+
+    AudioStream* _output = nullptr;
+    AudioInfo _format = AUDIO_INFO_DEFAULT();   // Format of the PCM passing through
+    Channel _channels[AUDIO_MIXER_CHANNELS] = {};
+    int32_t _mainGainQ15 = 32768;               // 32768 = unity: main stream untouched
+    int32_t _acc[AUDIO_MIXER_BLOCK_SAMPLES];    // Mix accumulator (one task, so not on its stack)
+
+    int claim(const char* key, float gain, unsigned long durationMs);
+    void release(Channel& ch);
+    /// Sum every active overlay into _acc (interleaved samples), without advancing them
+    void mixInto(size_t samples);
+    /// Advance the overlays by the @p samples the output took
+    void commit(size_t samples);
+    /// Gain, mix and limit @p samples of @p main (nullptr = silence) into @p out
+    void render(const int16_t* main, int16_t* out, size_t samples);
+};
+
+#endif // AUDIO_MIXER_H
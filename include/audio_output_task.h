@@ -0,0 +1,189 @@
+/**
+ * @file audio_output_task.h
+ * @brief Optional decode and I2S output tasks behind a PSRAM PCM ring
+ *
+ * With AUDIO_OUTPUT_TASK_ENABLED=1 playback no longer depends on loop()
+ * reaching audioPlayer.copy():
+ *
+ *   AudioDecode task (core 1)  ExtendedAudioPlayer::copy() → mixer (volume)
+ *                              → AudioPcmRing (PSRAM)
+ *   AudioOut task (core 1)     AudioPcmRing → loopback tap → codec (I2S)
+ *
+ * AudioOut runs above AudioDecode, which runs above loop(). It blocks in
+ * the I2S write, so the ring absorbs SD seeks, decoder bursts and slow
+ * network or telnet work in loop(). If the ring runs dry while playing,
+ * silence is written and an underrun is counted.
+ *
+ * loop() and the other tasks never touch the player directly. The play,
+ * queue and stop entry points post an AudioCommand to a FreeRTOS queue.
+ * The decode task is higher priority on the same core, so it runs the
+ * command at once and the caller gets the real result back. State queries
+ * (isActive(), isAudioKeyPlaying()) read fields the decode task writes.
+ *
+ * Caveat: the registry is still updated from loop(). The decode task reads
+ * it only when a stream starts, and catalog refreshes are only started
+ * while the player is idle (audioMaintenanceLoop()), but the two are not
+ * locked against each other. Keep the mode off until that path is
+ * serialized if catalogs change while the phone is in use.
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_OUTPUT_TASK_H
+#define AUDIO_OUTPUT_TASK_H
+
+#include <Arduino.h>
+#include "AudioTools/CoreAudio/BaseStream.h"
+
+class ExtendedAudioPlayer;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// PCM ring size in bytes (power of two). 65536 = ~740ms mono @ 44.1kHz
+#ifndef AUDIO_OUTPUT_RING_BYTES
+#define AUDIO_OUTPUT_RING_BYTES 65536
+#endif
+
+/// Free ring space required before the decode task runs another copy()
+#ifndef AUDIO_OUTPUT_HEADROOM_BYTES
+#define AUDIO_OUTPUT_HEADROOM_BYTES 16384
+#endif
+
+/// Bytes the output task moves into I2S per write (DMA-sized)
+#ifndef AUDIO_OUTPUT_CHUNK_BYTES
+#define AUDIO_OUTPUT_CHUNK_BYTES 1024
+#endif
+
+#ifndef AUDIO_OUTPUT_TASK_PRIORITY
+#define AUDIO_OUTPUT_TASK_PRIORITY 5
+#endif
+
+#ifndef AUDIO_DECODE_TASK_PRIORITY
+#define AUDIO_DECODE_TASK_PRIORITY 3
+#endif
+
+/// Commands queued from loop() and other tasks
+#ifndef AUDIO_COMMAND_QUEUE_SIZE
+#define AUDIO_COMMAND_QUEUE_SIZE 8
+#endif
+
+/// How long a caller waits for the decode task to run its command
+#ifndef AUDIO_COMMAND_TIMEOUT_MS
+#define AUDIO_COMMAND_TIMEOUT_MS 250
+#endif
+
+// ============================================================================
+// PCM RING
+// ============================================================================
+
+/**
+ * @brief Single-producer, single-consumer PCM ring with backpressure
+ *
+ * The decode task writes (through the player's mixer), the output
+ * task reads. Unlike MicRingBuffer the writer never overwrites unread
+ * audio: write() waits for room. While a flush is pending it takes nothing
+ * (returns what it wrote so far), so a blocked writer is released and the
+ * next stream's first PCM isn't lost before the output task applies it.
+ */
+class AudioPcmRing : public AudioStream
+{
+public:
+    AudioPcmRing() = default;
+    ~AudioPcmRing() { end(); }
+
+    /// Allocate @p capacityBytes (rounded down to a power of two), PSRAM preferred
+    bool begin(size_t capacityBytes);
+    void end() override;
+    bool isActive() const { return _buffer != nullptr; }
+
+    size_t write(const uint8_t* data, size_t len) override;
+    size_t readBytes(uint8_t* data, size_t len) override;
+    int available() override { return (int)level(); }
+    int availableForWrite() override { return (int)(capacity() - level()); }
+
+    /// Bytes queued for the output task
+    size_t level() const;
+    size_t capacity() const { return _mask + 1; }
+
+    /// Drop everything queued (consumer side) and release a waiting writer
+    void requestFlush() { __atomic_store_n(&_flushRequested, true, __ATOMIC_RELEASE); }
+    /// A flush the output task hasn't applied yet (write() takes nothing)
+    bool flushPending() const { return __atomic_load_n(&_flushRequested, __ATOMIC_ACQUIRE); }
+    /// Apply a pending flush (output task only)
+    void serviceFlush();
+
+private:
+    uint8_t* _buffer = nullptr;
+    uint32_t _mask = 0;
+    uint32_t _head = 0;   // Total bytes written (producer)
+    uint32_t _tail = 0;   // Total bytes read (consumer)
+    bool _flushRequested = false;
+};
+
+// ============================================================================
+// COMMANDS
+// ============================================================================
+
+enum class AudioCommandType : uint8_t {
+    PLAY_KEY,
+    QUEUE_KEY,
+    PLAY_PLAYLIST,
+    STOP,
+    EMERGENCY_STOP
+};
+
+struct AudioCommand {
+    AudioCommandType type;
+    char audioKey[64];
+    unsigned long durationMs;
+    TaskHandle_t replyTo;     // Notified with the result (nullptr = fire and forget)
+    uint32_t sequence;        // Echoed in the reply so late replies are ignored
+};
+
+/**
+ * @brief Run a player command on the decode task
+ * @return The player's result, or true if the decode task did not answer
+ *         within AUDIO_COMMAND_TIMEOUT_MS (the command still runs)
+ */
+bool postAudioCommand(AudioCommandType type, const char* audioKey = nullptr, unsigned long durationMs = 0);
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+/// Output task counters (since start or the last reset)
+struct AudioOutputStats {
+    uint32_t underruns;       // Ring ran dry while playing (episodes)
+    uint32_t underrunBytes;   // Silence written to cover them
+    uint32_t bytesOut;        // PCM moved into I2S
+    uint32_t ringLevel;       // Bytes queued now
+    uint32_t ringLowWater;    // Lowest level seen while playing
+    uint32_t ringCapacity;
+    uint32_t commands;        // Commands run by the decode task
+    uint32_t commandTimeouts; // Callers that stopped waiting for a result
+    uint32_t decodeWaits;     // Times the decoder waited for ring space
+};
+
+/**
+ * @brief Allocate the ring and start the decode and output tasks
+ * @param player Player the decode task drives; its output must be getAudioOutputRing()
+ * @param sink   Final stage before the codec (loopback tap or the codec itself)
+ * @return true if both tasks are running
+ */
+bool startAudioOutputTask(ExtendedAudioPlayer& player, AudioStream& sink);
+void stopAudioOutputTask();
+bool isAudioOutputTaskRunning();
+
+/// true when called on the decode task (the only task that may drive the player)
+bool isAudioDecodeTaskContext();
+
+/// The ring the player writes into while the tasks run
+AudioPcmRing& getAudioOutputRing();
+
+AudioOutputStats getAudioOutputStats();
+void resetAudioOutputStats();
+void printAudioOutputStats();
+
+#endif // AUDIO_OUTPUT_TASK_H
@@ -0,0 +1,166 @@
+/**
+ * @file audio_pcm_cache.h
+ * @brief LRU cache of decoded PCM for short, frequently played clips
+ *
+ * Short files (click, wrong_number, recorded dialtone/ringback) are decoded
+ * again on every play. With AUDIO_PCM_CACHE_ENABLED=1 the first play of a
+ * small file records the decoder's output (PcmCaptureStream sits between
+ * the AudioPlayer and the mixer). If the file plays through to EOF
+ * the capture is kept in PSRAM. Later plays of the same file are served as
+ * raw PCM from a MemoryStream through the "audio/pcm" passthrough decoder,
+ * which skips MP3/AAC decode and its start-up latency.
+ *
+ * Entries are keyed by SD path plus file size and mtime, so a re-downloaded
+ * clip misses and its stale entry is dropped. The least recently used
+ * entries are evicted to stay within AUDIO_PCM_CACHE_BUDGET_BYTES.
+ *
+ * All calls come from the task that drives the player (loop(), or the
+ * decode task with AUDIO_OUTPUT_TASK_ENABLED).
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_PCM_CACHE_H
+#define AUDIO_PCM_CACHE_H
+
+#include <Arduino.h>
+#include <time.h>
+#include <config.h>
+#include "AudioTools/CoreAudio/BaseStream.h"
+
+using namespace audio_tools;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Total PSRAM the cache may hold. 1 MB = ~12s mono @ 44.1kHz
+#ifndef AUDIO_PCM_CACHE_BUDGET_BYTES
+#define AUDIO_PCM_CACHE_BUDGET_BYTES (1024 * 1024)
+#endif
+
+/// Largest decoded clip kept. Longer captures are abandoned
+#ifndef AUDIO_PCM_CACHE_MAX_CLIP_BYTES
+#define AUDIO_PCM_CACHE_MAX_CLIP_BYTES (256 * 1024)
+#endif
+
+/// Only files up to this encoded size are considered for caching
+#ifndef AUDIO_PCM_CACHE_MAX_FILE_BYTES
+#define AUDIO_PCM_CACHE_MAX_FILE_BYTES (48 * 1024)
+#endif
+
+#ifndef AUDIO_PCM_CACHE_MAX_ENTRIES
+#define AUDIO_PCM_CACHE_MAX_ENTRIES 8
+#endif
+
+/// Capture buffer growth step
+#ifndef AUDIO_PCM_CACHE_GROW_BYTES
+#define AUDIO_PCM_CACHE_GROW_BYTES (32 * 1024)
+#endif
+
+// ============================================================================
+// CACHE
+// ============================================================================
+
+struct PcmCacheEntry {
+    char path[64];
+    size_t fileSize;          // Encoded file identity...
+    time_t mtime;             // ...so a re-downloaded clip misses
+    AudioInfo info;           // Decoder output format
+    uint8_t* data;            // PSRAM
+    size_t length;
+    uint32_t lastUsed;        // LRU tick
+    uint8_t pins;             // Players using it; never evicted while > 0
+};
+
+/// Counters since boot
+struct PcmCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t captures;        // Clips committed
+    uint32_t abandoned;       // Captures dropped (stopped early, too long, no memory)
+    uint32_t evictions;
+};
+
+class AudioPcmCache
+{
+public:
+    /**
+     * @brief Find the decoded PCM for this exact file version
+     *
+     * An entry for the same path with a different size or mtime is stale
+     * and is dropped.
+     */
+    const PcmCacheEntry* lookup(const char* path, size_t fileSize, time_t mtime);
+
+    /// Entry for @p path without re-checking the file (nullptr if not cached)
+    const PcmCacheEntry* peek(const char* path);
+
+    /// Protect an entry from eviction while it plays (counted)
+    void pin(const PcmCacheEntry* entry);
+    void unpin(const PcmCacheEntry* entry);
+
+    /// Start recording decoder output for @p path (ends any earlier capture)
+    bool beginCapture(const char* path, size_t fileSize, time_t mtime);
+    bool isCapturing() const { return capturing; }
+    /// Append decoded PCM; abandons the capture if it outgrows the limits
+    void append(const uint8_t* data, size_t len);
+    /// Keep the capture (the file played through to EOF)
+    bool commitCapture();
+    void abortCapture();
+
+    /// Latest decoder output format, recorded with the next committed clip
+    void noteAudioInfo(AudioInfo info) { lastInfo = info; }
+
+    size_t usedBytes() const { return used; }
+    int entryCount() const;
+    PcmCacheStats getStats() const { return stats; }
+    void printStatus() const;
+
+private:
+    PcmCacheEntry entries[AUDIO_PCM_CACHE_MAX_ENTRIES] = {};
+    size_t used = 0;
+    uint32_t useTick = 0;
+    AudioInfo lastInfo = AUDIO_INFO_DEFAULT();
+    PcmCacheStats stats = {};
+
+    // Capture in progress
+    PcmCacheEntry pending = {};
+    size_t pendingCapacity = 0;
+    bool capturing = false;
+
+    int indexOf(const PcmCacheEntry* entry) const;
+    void freeEntry(int index);
+    int findFreeSlot();
+    bool evictLeastRecent();
+};
+
+/// Process-wide cache used by ExtendedAudioSource
+AudioPcmCache& getAudioPcmCache();
+
+// ============================================================================
+// CAPTURE STAGE
+// ============================================================================
+
+/**
+ * @brief Pass-through stage that feeds decoded PCM to the cache
+ *
+ * Place between the AudioPlayer and the mixer so the cache holds
+ * PCM before volume is applied. write() forwards everything and appends
+ * what was accepted to the capture in progress, if any.
+ */
+class PcmCaptureStream : public AudioStream
+{
+public:
+    void setOutput(AudioStream& output) { _output = &output; }
+
+    size_t write(const uint8_t* data, size_t len) override;
+    size_t readBytes(uint8_t* data, size_t len) override { return 0; }
+    int availableForWrite() override { return _output ? _output->availableForWrite() : 0; }
+    void setAudioInfo(AudioInfo info) override;
+
+private:
+    AudioStream* _output = nullptr;
+};
+
+#endif // AUDIO_PCM_CACHE_H
@@ -5,6 +5,11 @@
  * Works with AudioKeyRegistry to create playlists that reference
  * registered audio keys. Each playlist is a sequence of audio items
  * with optional durations.
+ *
+ * Playlists are edited as Playlist objects; playback reads a compiled copy
+ * (PlaylistSpan) that resolveAllPlaylists() lays out in one PsramArena:
+ * contiguous PackedPlaylistNode arrays holding key IDs, not key strings.
+ * Edits take effect at the next resolve.
  * 
  * @date 2025
  */
@@ -12,7 +17,8 @@
 #pragma once
 
 #include "audio_key_registry.h"
-#include <vector>
+#include "psram_alloc.h"
+#include <atomic>
 #include <map>
 #include <string>
 
@@ -74,7 +80,7 @@ struct PlaylistNode {
  */
 struct Playlist {
     std::string name;                   ///< Playlist name
-    std::vector<PlaylistNode> nodes;    ///< Ordered list of audio items
+    PsramVector<PlaylistNode> nodes;    ///< Ordered list of audio items
     AudioKeyRegistry* keyRegistry;      ///< Registry for looking up entries by name
     
     Playlist() : keyRegistry(nullptr) {}
@@ -166,7 +172,7 @@ struct Playlist {
      * 
      * @param desiredNodes The desired playlist structure
      */
-    void update(const std::vector<PlaylistNode>& desiredNodes) {
+    void update(const PsramVector<PlaylistNode>& desiredNodes) {
         for (size_t i = 0; i < desiredNodes.size(); i++) {
             if (nodes.size() <= i) {
                 // Append new node
@@ -195,15 +201,53 @@ struct Playlist {
      */
     template<typename... Args>
     void update(Args&&... args) {
-        std::vector<PlaylistNode> desiredNodes = {std::forward<Args>(args)...};
+        PsramVector<PlaylistNode> desiredNodes = {std::forward<Args>(args)...};
         update(desiredNodes);
     }
 };
 
+// ============================================================================
+// COMPILED PLAYLISTS
+// ============================================================================
+
+/**
+ * @brief A playlist item as played: interned key and packed timing (8 bytes)
+ */
+struct PackedPlaylistNode {
+    AudioKeyId key;             ///< Registry key ID
+    uint16_t gapCs;             ///< Gap before this item, 10 ms units (saturates)
+    uint32_t durationMs;        ///< Duration in milliseconds (0 = play to completion)
+
+    unsigned long gapMs() const { return gapCs * 10UL; }
+};
+
+/**
+ * @brief A compiled playlist's nodes, contiguous in the playlist arena
+ *
+ * Valid until the second rebuild after it was obtained; take what you need
+ * (e.g. queue the keys) rather than keeping it.
+ */
+struct PlaylistSpan {
+    const PackedPlaylistNode* nodes = nullptr;
+    size_t count = 0;
+
+    const PackedPlaylistNode* begin() const { return nodes; }
+    const PackedPlaylistNode* end() const { return nodes + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
 // ============================================================================
 // AUDIO PLAYLIST REGISTRY
 // ============================================================================
 
+/**
+ * @brief Callback type for selecting playlists by the audioKeys they reference
+ * @param audioKey A node's key
+ * @return true if the key is one of interest
+ */
+typedef bool (*PlaylistKeyFilter)(const char* audioKey, void* userData);
+
 /**
  * @brief Registry for managing named audio playlists
  * 
@@ -214,6 +258,9 @@ struct Playlist {
  */
 class AudioPlaylistRegistry {
 public:
+    using PlaylistMap = std::map<std::string, Playlist, std::less<std::string>,  // alloc-ok
+                                 PsramAllocator<std::pair<const std::string, Playlist>>>;
+
     AudioPlaylistRegistry() = default;
     virtual ~AudioPlaylistRegistry() = default;
     
@@ -360,6 +407,29 @@ public:
      */
     virtual size_t resolveAllPlaylists();
     
+    /**
+     * @brief Resolve only the playlists with a node whose audioKey matches
+     * 
+     * Used after a catalog refresh so that playlists untouched by the
+     * change are not walked again.
+     * 
+     * @param filter Returns true for audioKeys that changed
+     * @return Total number of successfully resolved nodes in those playlists
+     */
+    virtual size_t resolvePlaylistsReferencing(PlaylistKeyFilter filter, void* userData);
+    
+    /**
+     * @brief Compiled nodes of a playlist, as of the last resolve
+     * @return An empty span if the playlist is unknown, empty, or not yet resolved
+     * @note Safe to call from the audio task while the loop task resolves
+     */
+    PlaylistSpan getPlaylistSpan(const char* name) const;
+    
+    /**
+     * @brief Whether a compiled playlist by this name exists
+     */
+    bool hasCompiledPlaylist(const char* name) const;
+    
     // ========================================================================
     // ITERATION
     // ========================================================================
@@ -372,19 +442,42 @@ public:
     /**
      * @brief Get iterator to beginning of playlists
      */
-    std::map<std::string, Playlist>::const_iterator begin() const { return playlists.begin(); }
+    PlaylistMap::const_iterator begin() const { return playlists.begin(); }
     
     /**
      * @brief Get iterator to end of playlists
      */
-    std::map<std::string, Playlist>::const_iterator end() const { return playlists.end(); }
+    PlaylistMap::const_iterator end() const { return playlists.end(); }
     
 protected:
     // The key registry for resolving audioKeys
     AudioKeyRegistry* keyRegistry = nullptr;
     
     // Map of playlist name -> Playlist
-    std::map<std::string, Playlist> playlists;
+    PlaylistMap playlists;
+    
+private:
+    // Compiled playlist in the table, sorted by name
+    struct CompiledPlaylist {
+        const char* name;
+        const PackedPlaylistNode* nodes;
+        uint32_t count;
+    };
+    
+    struct CompiledTable {
+        const CompiledPlaylist* playlists;
+        size_t count;
+    };
+    
+    /// Lay out every playlist in the idle arena and publish it
+    size_t rebuildCompiled();
+    const CompiledPlaylist* findCompiled(const char* name) const;
+    
+    // Double-buffered: a rebuild fills the arena readers are not using, then
+    // swaps the table pointer; the old arena is reset by the rebuild after
+    PsramArena arenas[2];
+    int idleArena = 0;
+    std::atomic<const CompiledTable*> compiled{nullptr};
 };
 
 // ============================================================================
@@ -0,0 +1,95 @@
+/**
+ * @file audio_queue.h
+ * @brief Fixed-capacity, allocation-free play queue for ExtendedAudioPlayer
+ *
+ * Items are stored in a ring of AUDIO_QUEUE_CAPACITY slots, so enqueue and
+ * dequeue are O(1) and never touch the heap, however long a queued
+ * playlist is. Each item holds a small key ID, not its own copy of the key
+ * string. The queue interns its keys in a table with one slot per queue
+ * entry, reference-counted so a slot is reused once no queued item names
+ * it. A playlist that queues "click" between every clip therefore stores
+ * the string once.
+ *
+ * Every operation takes a spinlock, so the queue may be used from loop(),
+ * the decode task or a web handler. pop() and peek() copy the key out
+ * under the lock, so the caller never holds a pointer into the table.
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_QUEUE_H
+#define AUDIO_QUEUE_H
+
+#include <Arduino.h>
+#include "audio_key_registry.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Items that can wait behind the current stream
+#ifndef AUDIO_QUEUE_CAPACITY
+#define AUDIO_QUEUE_CAPACITY 32
+#endif
+
+/// Longest key that can be queued (including the terminator)
+#ifndef AUDIO_QUEUE_KEY_LENGTH
+#define AUDIO_QUEUE_KEY_LENGTH 64
+#endif
+
+// ============================================================================
+// QUEUE
+// ============================================================================
+
+typedef uint8_t QueueKeyId;
+
+/**
+ * @brief A queued audio item: stream type, interned key and duration limit
+ */
+struct QueuedAudioItem {
+    AudioStreamType type = AudioStreamType::NONE;
+    QueueKeyId keyId = 0;
+    unsigned long durationMs = 0;
+};
+
+class AudioQueue
+{
+public:
+    /**
+     * @brief Append an item
+     * @return false if the queue is full or the key is empty or too long
+     */
+    bool push(AudioStreamType type, const char* audioKey, unsigned long durationMs);
+
+    /// Remove the front item, copying its key into @p key; false if empty
+    bool pop(QueuedAudioItem& item, char* key, size_t keySize);
+
+    /// Front item without removing it; false if empty
+    bool peek(QueuedAudioItem& item, char* key, size_t keySize) const;
+
+    void clear();
+
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return AUDIO_QUEUE_CAPACITY; }
+
+private:
+    struct KeySlot {
+        char key[AUDIO_QUEUE_KEY_LENGTH];
+        uint32_t hash;
+        uint8_t refs;                 // Queued items naming this key
+    };
+
+    QueuedAudioItem _items[AUDIO_QUEUE_CAPACITY] = {};
+    KeySlot _keys[AUDIO_QUEUE_CAPACITY] = {};   // One per item, so interning can't fail
+    uint32_t _head = 0;               // Total items pushed
+    uint32_t _tail = 0;               // Total items popped
+    mutable portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    static uint32_t hashKey(const char* key);
+    // Both called with _lock held
+    int intern(const char* key, uint32_t hash);
+    void copyKey(QueueKeyId id, char* key, size_t keySize) const;
+};
+
+#endif // AUDIO_QUEUE_H
@@ -0,0 +1,144 @@
+/**
+ * @file audio_url_stream.h
+ * @brief PSRAM jitter buffer for URL playback with write-through to the SD cache
+ *
+ * A first play of a key whose file has not been downloaded yet falls back
+ * to streaming its URL. URLStream alone only holds URL_STREAM_BUFFER_SIZE
+ * bytes, so any Wi-Fi hiccup reaches the decoder, and WebQueue later
+ * downloads the same file a second time.
+ *
+ * UrlJitterStream sits between the URLStream and the decoder. open() waits
+ * (bounded) until AUDIO_URL_PREBUFFER_MS of audio is buffered, and every
+ * read then tops the ring up from whatever the network has ready, so decode
+ * runs ahead of short stalls by up to AUDIO_URL_JITTER_MS. Given a cache
+ * path, every byte pulled from the network is also written to
+ * "<path>.part" on SD. The file is renamed to <path> only when the byte
+ * count reaches the Content-Length; a stopped or truncated stream leaves no
+ * file behind. WebQueue skips a queued download whose file already exists,
+ * so a played-through stream is never fetched again.
+ *
+ * Sizes are in ms of audio at an assumed AUDIO_URL_ASSUMED_KBPS, since the
+ * bitrate is not known until the decoder has seen the first frames. All
+ * calls come from the task that drives the player.
+ *
+ * @date 2026
+ */
+
+#ifndef AUDIO_URL_STREAM_H
+#define AUDIO_URL_STREAM_H
+
+#include <Arduino.h>
+#include <config.h>
+#include "AudioTools/CoreAudio/BaseStream.h"
+#include "AudioTools/Communication/HTTP/URLStream.h"
+#if SD_USE_MMC
+  #include <SD_MMC.h>
+#else
+  #include <SD.h>
+#endif
+
+using namespace audio_tools;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Audio the ring can hold ahead of the decoder
+#ifndef AUDIO_URL_JITTER_MS
+#define AUDIO_URL_JITTER_MS 4000
+#endif
+
+/// Audio buffered before open() returns
+#ifndef AUDIO_URL_PREBUFFER_MS
+#define AUDIO_URL_PREBUFFER_MS 300
+#endif
+
+/// Give up pre-buffering after this long and play what arrived
+#ifndef AUDIO_URL_PREBUFFER_TIMEOUT_MS
+#define AUDIO_URL_PREBUFFER_TIMEOUT_MS 1500
+#endif
+
+/// Bitrate used to turn the ms above into bytes
+#ifndef AUDIO_URL_ASSUMED_KBPS
+#define AUDIO_URL_ASSUMED_KBPS 128
+#endif
+
+/// Most bytes pulled from the network (and written to SD) per read
+#ifndef AUDIO_URL_FILL_BYTES
+#define AUDIO_URL_FILL_BYTES 4096
+#endif
+
+/// Bytes of encoded audio per ms at the assumed bitrate
+#define AUDIO_URL_BYTES_PER_MS (AUDIO_URL_ASSUMED_KBPS / 8)
+
+// ============================================================================
+// JITTER STREAM
+// ============================================================================
+
+/// Counters since boot
+struct UrlStreamStats {
+    uint32_t streams;         // URL streams opened
+    uint32_t bytesIn;         // Bytes pulled from the network
+    uint32_t underruns;       // Ring ran dry while the stream was still open (episodes)
+    uint32_t lastPrebufferMs; // Time the last open() spent pre-buffering
+    uint32_t cached;          // Streams written through to SD in full
+    uint32_t cacheDiscarded;  // Write-throughs dropped (stopped early, short, SD error)
+};
+
+class UrlJitterStream : public AudioStream
+{
+public:
+    ~UrlJitterStream();
+
+    /**
+     * @brief Start buffering an already-opened URLStream
+     * @param source    URLStream after a successful begin()
+     * @param cachePath SD path to fill as the stream plays (nullptr = no write-through)
+     * @return false if nothing at all arrived before the pre-buffer timeout
+     */
+    bool open(URLStream& source, const char* cachePath = nullptr);
+
+    /// Stop reading; keeps the SD file only if it is complete
+    void close();
+    bool isOpen() const { return _source != nullptr; }
+
+    size_t readBytes(uint8_t* data, size_t len) override;
+    size_t write(const uint8_t* data, size_t len) override { return 0; }
+    int available() override;
+
+    /// Bytes buffered ahead of the decoder
+    size_t level() const { return _head - _tail; }
+    size_t capacity() const { return _capacity; }
+
+    UrlStreamStats getStats() const { return stats; }
+    void printStatus() const;
+
+private:
+    URLStream* _source = nullptr;
+
+    // Ring (allocated on first open and kept, so PSRAM doesn't fragment)
+    uint8_t* _buffer = nullptr;
+    size_t _capacity = 0;
+    uint32_t _head = 0;               // Total bytes written
+    uint32_t _tail = 0;               // Total bytes read
+    bool _starved = false;            // Inside an underrun episode
+
+    // Write-through
+    File _cacheFile;
+    char _cachePath[128] = {0};
+    char _partPath[136] = {0};
+    int _contentLength = 0;           // From the reply headers (<= 0 if unknown)
+    int _received = 0;
+
+    UrlStreamStats stats = {};
+
+    bool allocate();
+    /// Move up to @p maxBytes the network has ready into the ring (and SD)
+    size_t fill(size_t maxBytes);
+    void teeToCache(const uint8_t* data, size_t len);
+    void openCache(const char* cachePath);
+    void commitCache();
+    void discardCache(const char* reason);
+};
+
+#endif // AUDIO_URL_STREAM_H
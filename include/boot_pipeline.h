@@ -0,0 +1,101 @@
+#pragma once
+/**
+ * @file boot_pipeline.h
+ * @brief Boot stages with dependencies, each timed in µs since reset
+ *
+ * setup() runs what a pick-up needs (AudioKit, player, DTMF, phone) inline
+ * and hands the slow stages to boot tasks that wait for their dependencies,
+ * so dial tone doesn't wait for the SD card:
+ *
+ *   bootPipeline.run(BootStage::AUDIO_KIT, initKit);
+ *   bootPipeline.runAsync(BootStage::STORAGE, mountSd, BOOT_BIT(BootStage::AUDIO_KIT));
+ *
+ * Stages that finish somewhere else (WiFi, VPN, catalog) are marked with
+ * begin()/end(). Only the first begin() and end() of a stage count, so
+ * calls on a reconnect are harmless. The "boot" debug command prints the
+ * timings and buildBootJson() ships them.
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#ifndef BOOT_TASK_STACK
+#define BOOT_TASK_STACK 8192            // SD mount + cache index load
+#endif
+#ifndef BOOT_TASK_CORE
+#define BOOT_TASK_CORE 0                // Keep core 1 for audio
+#endif
+#ifndef BOOT_TASK_PRIORITY
+#define BOOT_TASK_PRIORITY 1
+#endif
+
+enum class BootStage : uint8_t {
+    AUDIO_KIT,      // Codec + mic capture
+    PLAYER,         // Generators + audio player
+    DTMF,           // Goertzel decoder
+    PHONE,          // Hook sensing — dial tone ready
+    STORAGE,        // SD mount + cache index (boot task)
+    CATALOG,        // SD catalog into the registry (main loop)
+    WIFI,           // initWiFi() → connected
+    VPN,            // WireGuard bring-up
+    COUNT
+};
+
+#define BOOT_BIT(stage) (1u << (uint8_t)(stage))
+
+class BootPipeline {
+public:
+    using StageFn = bool(*)();
+
+    /// Run fn now on this task, timed as stage s; returns fn's result
+    bool run(BootStage s, StageFn fn);
+
+    /// Run fn on its own boot task once every stage in `after` has ended
+    /// (BOOT_BIT()s). False if the task couldn't be created — the stage
+    /// then ends as failed and never runs.
+    bool runAsync(BootStage s, StageFn fn, uint32_t after = 0);
+
+    void begin(BootStage s);
+    void end(BootStage s, bool ok = true);
+
+    /// Stage ended (from any task)
+    bool done(BootStage s) const;
+
+    /// Stage ended and succeeded
+    bool ok(BootStage s) const { return done(s) && _rec[(int)s].ok; }
+
+    void printStatus() const;
+
+    /// Append "boot_stages":{"name":[start_us,end_us,ok],...}, to a JSON object
+    void appendJson(String& out) const;
+
+    static const char* name(BootStage s);
+
+private:
+    struct Record {
+        int64_t startUs = 0;            // esp_timer, 0 = not started
+        int64_t endUs   = 0;            // 0 = not ended
+        bool    ok      = false;
+        int8_t  core    = -1;
+    };
+
+    struct Job {
+        BootPipeline* self = nullptr;
+        BootStage     stage = BootStage::COUNT;
+        StageFn       fn = nullptr;
+        uint32_t      after = 0;
+    };
+
+    Record             _rec[(int)BootStage::COUNT];
+    Job                _jobs[(int)BootStage::COUNT];
+    EventGroupHandle_t _ended = nullptr;  // One bit per ended stage
+    portMUX_TYPE       _mux = portMUX_INITIALIZER_UNLOCKED;
+
+    bool start();
+    static void taskMain(void* arg);
+};
+
+extern BootPipeline bootPipeline;
@@ -0,0 +1,134 @@
+#pragma once
+/**
+ * @file capture_stream.h
+ * @brief Live mic capture as binary frames over a TCP socket
+ *
+ * The "CapStream" task (core 0, below Goertzel) listens on
+ * CAPTURE_STREAM_PORT. A client gets a stream header, then frames of mic
+ * audio read from its own MicRingReader cursor, so detection is untouched.
+ * The audio is downsampled by CAPTURE_STREAM_DOWNSAMPLE and sent as raw
+ * int16 or IMA ADPCM (4:1). There is no duration limit: it runs until the
+ * client disconnects or stop().
+ *
+ * Trigger mode sends nothing until the detector rejects a tone (any
+ * GoertzelDetectorStats reject counter moves) or mark() is called. Then it
+ * sends the last CAPTURE_PREROLL_MS, kept in a PSRAM ring, followed by
+ * CAPTURE_POSTROLL_MS of live audio. While idle, the socket is checked
+ * every CAPTURE_IDLE_PROBE_MS, so a client that left is dropped (and the
+ * power manager released) without waiting for the next trigger.
+ *
+ * Wire format, little-endian:
+ *   header  "BPCM" ver:u8 codec:u8 (0 PCM16, 1 IMA ADPCM) 0:u16 rate:u32 mode:u8 (1 = trigger) 0:u8[3]
+ *   frame   type:u8 0:u8 samples:u16 index:u32 len:u16 payload[len]
+ *     'A' audio. ADPCM payload: predictor:i16 stepIndex:u8 0:u8, then
+ *         samples/2 bytes, low nibble first (each frame decodes alone)
+ *     'G' samples were lost (reader lapped); payload empty
+ *     'T' trigger; payload = reason text
+ * index counts samples at the stream rate since the client connected.
+ *
+ *   captureStream.start(CaptureCodec::ADPCM, false);
+ *   python3 tools/analyze_audio/analyze_audio.py --stream <phone-ip>
+ *
+ * start()/stop()/mark() from loop().
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#ifndef CAPTURE_STREAM_PORT
+#define CAPTURE_STREAM_PORT 2325
+#endif
+#ifndef CAPTURE_STREAM_DOWNSAMPLE
+#define CAPTURE_STREAM_DOWNSAMPLE 2         // 44.1 kHz mic → 22.05 kHz stream (pair average)
+#endif
+#ifndef CAPTURE_STREAM_FRAME_SAMPLES
+#define CAPTURE_STREAM_FRAME_SAMPLES 512    // Stream-rate samples per 'A' frame (even)
+#endif
+#ifndef CAPTURE_PREROLL_MS
+#define CAPTURE_PREROLL_MS 3000             // Trigger mode: audio kept before a trigger (PSRAM)
+#endif
+#ifndef CAPTURE_POSTROLL_MS
+#define CAPTURE_POSTROLL_MS 2000            // Trigger mode: live audio sent after it
+#endif
+#ifndef CAPTURE_IDLE_PROBE_MS
+#define CAPTURE_IDLE_PROBE_MS 1000          // Trigger mode: check an idle client is still there
+#endif
+#ifndef CAPTURE_STREAM_STACK
+#define CAPTURE_STREAM_STACK 6144
+#endif
+#ifndef CAPTURE_STREAM_PRIORITY
+#define CAPTURE_STREAM_PRIORITY 0           // Below GoertzelTask (1) on core 0
+#endif
+
+enum class CaptureCodec : uint8_t { PCM16 = 0, ADPCM = 1 };
+
+class CaptureStream {
+public:
+    /// Listen and start the task. False if already running or out of memory.
+    bool start(CaptureCodec codec, bool trigger);
+    /// Drop the client and end the task
+    void stop();
+
+    bool running() const { return _task != nullptr; }
+    bool clientConnected() const { return _connected; }
+
+    /// Trigger mode: send the pre-roll now
+    void mark() { _markRequested = true; }
+
+    void printStatus();
+
+private:
+    static constexpr int STREAM_RATE = AUDIO_SAMPLE_RATE / CAPTURE_STREAM_DOWNSAMPLE;
+    static constexpr size_t FRAME_HEADER = 10;
+    static constexpr size_t MAX_PAYLOAD = CAPTURE_STREAM_FRAME_SAMPLES * 2;
+
+    WiFiServer   _server{CAPTURE_STREAM_PORT};
+    WiFiClient   _client;
+    TaskHandle_t _task = nullptr;
+    CaptureCodec _codec = CaptureCodec::PCM16;
+    bool _trigger = false;
+    volatile bool _stopRequested = false;
+    volatile bool _markRequested = false;
+    volatile bool _connected = false;
+
+    // CapStream task state
+    int16_t  _frame[CAPTURE_STREAM_FRAME_SAMPLES];
+    size_t   _frameFill = 0;
+    uint8_t  _packet[FRAME_HEADER + MAX_PAYLOAD];
+    uint32_t _index = 0;            // Stream samples since connect
+    uint32_t _frameStart = 0;       // index of _frame[0]
+    int32_t  _adpcmPredictor = 0;
+    int      _adpcmStep = 0;        // Step table index
+    int32_t  _carry = 0;            // Downsampler: partial sum
+    int      _carryCount = 0;
+    int16_t* _preroll = nullptr;    // Trigger mode ring (PSRAM)
+    size_t   _prerollLen = 0;
+    size_t   _prerollHead = 0;
+    size_t   _prerollFill = 0;
+    uint32_t _postrollLeft = 0;
+    uint32_t _lastRejects = 0;
+    unsigned long _lastProbeMs = 0;
+
+    // Counters (since start())
+    volatile uint32_t _clients = 0;
+    volatile uint32_t _bytes = 0;
+    volatile uint32_t _lostSamples = 0;
+    volatile uint32_t _triggers = 0;
+
+    static void taskMain(void* arg);
+    void run();
+    bool accept();
+    void pushSample(int16_t s);
+    void emit(int16_t s);
+    bool flushFrame();
+    bool sendFrame(char type, uint16_t samples, uint32_t index, const uint8_t* payload, size_t len);
+    bool sendTrigger(const char* reason);
+    static uint32_t rejectCount();
+};
+
+extern CaptureStream captureStream;
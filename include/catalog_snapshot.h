@@ -0,0 +1,81 @@
+/**
+ * @file catalog_snapshot.h
+ * @brief Binary snapshot of the registered audio catalog for fast boot
+ *
+ * Re-parsing audio_files.json on every boot costs a JSON parse per entry
+ * before the phone can answer. After each successful catalog registration
+ * the catalog entries (those with a contentHash) are also written as a
+ * snapshot:
+ *
+ *   header    magic, version, record sizes, counts, source JSON size and
+ *             hash, checksum
+ *   entries   fixed-size records: type, timing, hash, string offsets, link indices
+ *   links     fixed-size previous/next records (the playlist nodes)
+ *   pool      NUL-terminated strings, offset 0 is ""
+ *
+ * Boot reads the whole file into one PSRAM blob with a single read,
+ * checks it, and registers entries straight from the records. Generators
+ * are runtime objects, so their records point at the generator's source
+ * JSON in the pool and are rebuilt through a callback.
+ *
+ * The snapshot is only used when it matches the size and the FNV-1a hash
+ * of the JSON it was written from (the size is checked first, so a resized
+ * catalog isn't read twice); otherwise (or when missing, damaged or from
+ * another version) the caller falls back to the JSON.
+ *
+ * @date 2026
+ */
+
+#ifndef CATALOG_SNAPSHOT_H
+#define CATALOG_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "audio_key_registry.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+#ifndef AUDIO_SNAPSHOT_FILE
+#define AUDIO_SNAPSHOT_FILE "/audio_files.bin"
+#endif
+
+#define CATALOG_SNAPSHOT_MAGIC   0x53435042u   ///< "BPCS"
+#define CATALOG_SNAPSHOT_VERSION 2
+#define CATALOG_SOURCE_HASH_SEED 2166136261u  ///< catalogSourceHash() of no bytes
+
+// ============================================================================
+// API
+// ============================================================================
+
+/// Source JSON of a generator entry (nullptr if unknown — entry is left out)
+using CatalogGeneratorSource = const char* (*)(const char* audioKey, void* userData);
+
+/// Rebuild a generator from its source JSON (nullptr on failure — entry is skipped)
+using CatalogGeneratorBuilder = SoundGenerator<int16_t>* (*)(const char* audioKey, const char* json, void* userData);
+
+/// FNV-1a of catalog JSON bytes; feed chunks in order, starting from the seed
+uint32_t catalogSourceHash(const uint8_t* data, size_t len, uint32_t hash = CATALOG_SOURCE_HASH_SEED);
+
+/**
+ * @brief Write the registry's catalog entries to @p path (via a .tmp rename)
+ * @param sourceSize Size of the catalog JSON the entries were parsed from
+ * @param sourceHash catalogSourceHash() of that JSON
+ * @return true if the snapshot was written
+ */
+bool writeCatalogSnapshot(fs::FS& fs, const char* path, const AudioKeyRegistry& registry,
+                          uint32_t sourceSize, uint32_t sourceHash,
+                          CatalogGeneratorSource generatorSource, void* userData);
+
+/**
+ * @brief Register the entries of a snapshot
+ * @param source The catalog JSON now on SD; a different size or hash means
+ *               stale. Read to hash it, then rewound to the start.
+ * @return Entries registered, or -1 if the snapshot is missing, stale or invalid
+ *         (nothing is registered then)
+ */
+int loadCatalogSnapshot(fs::FS& fs, const char* path, File& source, AudioKeyRegistry& registry,
+                        CatalogGeneratorBuilder generatorBuilder, void* userData);
+
+#endif // CATALOG_SNAPSHOT_H
@@ -0,0 +1,115 @@
+/**
+ * @file catalog_stream_parser.h
+ * @brief Incremental splitter for the audio catalog's top-level JSON object
+ *
+ * The catalog is one JSON object whose members are audio entries (plus a
+ * few scalars such as "lastModified"). Parsing it as a whole needs the
+ * entire body in a String and again in a JsonDocument. CatalogStreamParser
+ * instead takes the body in arbitrary chunks, as they come off the network
+ * or the SD card, and hands each top-level member to a callback as soon as
+ * its value is complete: the key, and the value's raw JSON text. The
+ * callback deserializes that one small value with ArduinoJson.
+ *
+ * Only the member being read is buffered (AUDIO_CATALOG_ENTRY_MAX_BYTES),
+ * so memory use no longer depends on catalog size. A member whose value is
+ * larger is skipped and counted rather than failing the whole catalog.
+ *
+ * @date 2026
+ */
+
+#ifndef CATALOG_STREAM_PARSER_H
+#define CATALOG_STREAM_PARSER_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Largest single catalog member value (raw JSON text)
+#ifndef AUDIO_CATALOG_ENTRY_MAX_BYTES
+#define AUDIO_CATALOG_ENTRY_MAX_BYTES 2048
+#endif
+
+/// Longest member key
+#ifndef AUDIO_CATALOG_KEY_MAX_BYTES
+#define AUDIO_CATALOG_KEY_MAX_BYTES 64
+#endif
+
+// ============================================================================
+// PARSER
+// ============================================================================
+
+class CatalogStreamParser
+{
+public:
+    /**
+     * @brief Called once per complete top-level member
+     * @param key Member name (unescaped, NUL-terminated)
+     * @param json The value's JSON text (NUL-terminated; valid until return)
+     * @param len Length of @p json
+     */
+    using MemberCallback = void (*)(const char* key, const char* json, size_t len, void* userData);
+
+    ~CatalogStreamParser() { end(); }
+
+    /// Start a new document; false if the value buffer can't be allocated
+    bool begin(MemberCallback callback, void* userData);
+
+    /**
+     * @brief Feed the next chunk of the document
+     * @return false once the input is not a JSON object (stays false)
+     */
+    bool feed(const uint8_t* data, size_t len);
+
+    /// True if the whole object was read (its closing brace seen)
+    bool finish() const { return state == State::DONE; }
+
+    /// Release the value buffer
+    void end();
+
+    size_t membersRead() const { return members; }
+    size_t membersSkipped() const { return skipped; }
+    size_t bytesRead() const { return bytes; }
+    const char* error() const { return errorText; }
+
+private:
+    enum class State : uint8_t {
+        EXPECT_OBJECT,      // Before the root '{'
+        EXPECT_KEY,         // After '{' or ','
+        IN_KEY,
+        EXPECT_COLON,
+        EXPECT_VALUE,
+        IN_VALUE,
+        EXPECT_NEXT,        // After a value: ',' or '}'
+        DONE,
+        FAILED,
+    };
+
+    MemberCallback callback = nullptr;
+    void* userData = nullptr;
+    State state = State::EXPECT_OBJECT;
+
+    char key[AUDIO_CATALOG_KEY_MAX_BYTES];
+    size_t keyLen = 0;
+    bool keyEscape = false;
+
+    char* value = nullptr;           // AUDIO_CATALOG_ENTRY_MAX_BYTES + 1
+    size_t valueLen = 0;
+    bool valueOverflow = false;
+    int depth = 0;                   // Open braces/brackets in the value
+    bool inString = false;
+    bool escape = false;
+    bool scalar = false;             // Value is a number/true/false/null
+
+    size_t members = 0;
+    size_t skipped = 0;
+    size_t bytes = 0;
+    const char* errorText = nullptr;
+
+    void fail(const char* why);
+    void append(char c);
+    void emit();
+};
+
+#endif // CATALOG_STREAM_PARSER_H
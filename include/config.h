@@ -124,6 +124,85 @@
 #define AUDIO_COPY_BUFFER_SIZE 4096
 #endif
 
+// Loopback cancellation: the player's output is tapped into a reference ring
+// and its per-bin Goertzel magnitudes are subtracted from the mic's, so DTMF
+// stays live (barge-in) during clip/ringback playback instead of muting.
+#ifndef LOOPBACK_CANCEL_ENABLED
+#define LOOPBACK_CANCEL_ENABLED 1
+#endif
+
+// Output write → mic arrival delay: TX DMA queue (~6 × 5.8ms) plus RX framing
+#ifndef LOOPBACK_REF_DELAY_MS
+#define LOOPBACK_REF_DELAY_MS 40
+#endif
+
+// Audio output task: 1 = a core-1 task decodes into a PSRAM PCM ring and a
+// second, higher-priority task drains it into I2S, so a slow loop() no longer
+// underruns the codec. loop() then only posts play/queue/stop commands.
+#ifndef AUDIO_OUTPUT_TASK_ENABLED
+#define AUDIO_OUTPUT_TASK_ENABLED 0
+#endif
+
+// Decoded-PCM cache: 1 = keep the decoded output of short clips (click,
+// wrong_number, ...) in PSRAM and replay it as raw PCM instead of decoding
+// the file again (see audio_pcm_cache.h)
+#ifndef AUDIO_PCM_CACHE_ENABLED
+#define AUDIO_PCM_CACHE_ENABLED 1
+#endif
+
+// URL playback: 1 = streamed keys play from a PSRAM jitter buffer and are
+// written through to their SD cache path, so a first play needs no second
+// download (see audio_url_stream.h)
+#ifndef AUDIO_URL_JITTER_ENABLED
+#define AUDIO_URL_JITTER_ENABLED 1
+#endif
+
+// File playback: 1 = clips are read from SD in large aligned blocks by a
+// reader task into a PSRAM read-ahead, and the decoder reads from memory
+// (see audio_file_stream.h)
+#ifndef AUDIO_FILE_READAHEAD_ENABLED
+#define AUDIO_FILE_READAHEAD_ENABLED 1
+#endif
+
+// Goertzel task pacing: 1 = sleep until the mic capture task publishes a DMA
+// frame to the mic ring; 0 = legacy copy() + vTaskDelay(1) polling
+#ifndef GOERTZEL_EVENT_DRIVEN
+#define GOERTZEL_EVENT_DRIVEN 1
+#endif
+
+// DTMF keypad calibration (*#225#): give up after this long without all
+// twelve keys, and accept tones this far over the noise floor while sweeping
+#ifndef GOERTZEL_CALIBRATION_TIMEOUT_MS
+#define GOERTZEL_CALIBRATION_TIMEOUT_MS 60000
+#endif
+#ifndef GOERTZEL_CALIBRATION_SNR_DB
+#define GOERTZEL_CALIBRATION_SNR_DB 9.0f
+#endif
+// Margin kept below the weakest calibrated key, and the SNR range it may set
+#ifndef GOERTZEL_CALIBRATION_MARGIN_DB
+#define GOERTZEL_CALIBRATION_MARGIN_DB 6.0f
+#endif
+#ifndef GOERTZEL_MIN_SNR_DB
+#define GOERTZEL_MIN_SNR_DB 6.0f
+#endif
+#ifndef GOERTZEL_MAX_SNR_DB
+#define GOERTZEL_MAX_SNR_DB 40.0f
+#endif
+// Twist a calibration may allow (and accepts while sweeping)
+#ifndef GOERTZEL_CALIBRATION_MAX_TWIST
+#define GOERTZEL_CALIBRATION_MAX_TWIST 20.0f
+#endif
+
+// Bytes per I2S RX DMA buffer and number of buffers (AudioTools defaults).
+// The mic capture task reads one frame per wake and counts an overrun when it
+// falls further behind than the whole DMA ring.
+#ifndef MIC_DMA_FRAME_BYTES
+#define MIC_DMA_FRAME_BYTES 512
+#endif
+#ifndef MIC_DMA_FRAME_COUNT
+#define MIC_DMA_FRAME_COUNT 6
+#endif
+
 // Interval for checking DTMF input during audio playback (milliseconds)
 #ifndef DTMF_CHECK_DURING_PLAYBACK_INTERVAL_MS
 #define DTMF_CHECK_DURING_PLAYBACK_INTERVAL_MS 200
@@ -233,6 +312,22 @@
 #ifndef HTTP_TIMEOUT_OTA_MS
 #define HTTP_TIMEOUT_OTA_MS 60000
 #endif
+// Keep-alive connections shared by all subsystems (http_pool.h)
+#ifndef HTTP_POOL_SIZE
+#define HTTP_POOL_SIZE 4
+#endif
+// Idle time before a pooled connection is closed
+#ifndef HTTP_POOL_IDLE_MS
+#define HTTP_POOL_IDLE_MS 15000
+#endif
+// Resolved hosts remembered for new connections (http_dns.h)
+#ifndef HTTP_DNS_CACHE_SIZE
+#define HTTP_DNS_CACHE_SIZE 8
+#endif
+// Age at which a cached address is looked up again (kept if that fails)
+#ifndef HTTP_DNS_TTL_MS
+#define HTTP_DNS_TTL_MS 600000
+#endif
 
 // ============================================================================
 // PERSISTENT TCP LOG STREAM
@@ -259,6 +354,52 @@
 #define TASK_WDT_TIMEOUT_S 6
 #endif
 
+// ============================================================================
+// BOOT CONFIGURATION
+// ============================================================================
+// Pause after Serial.begin() so a monitor can attach before the first lines.
+// Every millisecond of it delays dial tone after power-on; set to 2000 when
+// boot logs on serial are needed.
+#ifndef BOOT_SERIAL_WAIT_MS
+#define BOOT_SERIAL_WAIT_MS 0
+#endif
+
+// ============================================================================
+// PERFORMANCE SUITE (`perfsuite` debug command)
+// ============================================================================
+// Fixed sample clips keep results comparable between builds; a missing one
+// reports null for its codec.
+#ifndef PERF_MP3_FILE
+#define PERF_MP3_FILE "/perf/sample.mp3"
+#endif
+#ifndef PERF_AAC_FILE
+#define PERF_AAC_FILE "/perf/sample.aac"     // ADTS
+#endif
+#ifndef PERF_WAV_FILE
+#define PERF_WAV_FILE "/perf/sample.wav"
+#endif
+#ifndef PERF_DECODE_MS
+#define PERF_DECODE_MS 3000                  // Decode time spent per codec at most
+#endif
+#ifndef PERF_CPU_MS
+#define PERF_CPU_MS 3000                     // Dial tone + detector window for per-core load
+#endif
+#ifndef PERF_GOERTZEL_HOPS
+#define PERF_GOERTZEL_HOPS 200               // Hops timed per case (tone, silence)
+#endif
+#ifndef PERF_SD_BYTES
+#define PERF_SD_BYTES (1024 * 1024)          // Temp file written, read back and removed
+#endif
+#ifndef PERF_DOWNLOAD_BYTES
+#define PERF_DOWNLOAD_BYTES (1024 * 1024)    // Requested from the server's /perf/blob
+#endif
+#ifndef PERF_DOWNLOAD_TIMEOUT_MS
+#define PERF_DOWNLOAD_TIMEOUT_MS 30000
+#endif
+#ifndef PERF_SERVER_URL
+#define PERF_SERVER_URL ""                   // e.g. "http://10.253.0.1:3000"; "" = the log server's
+#endif
+
 // ============================================================================
 // PHONE HARDWARE CONFIGURATION
 // ============================================================================
@@ -273,6 +414,20 @@
 
 #define SHK 21
 #define RING_CYCLE_MS 750
+
+// Hook switch: edges interrupt, a settle timer debounces (phone_service.h)
+#ifndef HOOK_DEBOUNCE_MS
+#define HOOK_DEBOUNCE_MS 20           // Line quiet this long after an edge = settled
+#endif
+#ifndef HOOK_PULSE_DIAL
+#define HOOK_PULSE_DIAL 0             // 1 = decode rotary dial pulses on the hook line
+#endif
+#ifndef HOOK_PULSE_BREAK_MAX_MS
+#define HOOK_PULSE_BREAK_MAX_MS 120   // Pulse dial: a longer break is a hang-up
+#endif
+#ifndef HOOK_PULSE_DIGIT_GAP_MS
+#define HOOK_PULSE_DIGIT_GAP_MS 250   // Pulse dial: off-hook this long ends a digit
+#endif
 //#define ASSUME_HOOK 1
 // PINOUT
 // Row1:
@@ -0,0 +1,124 @@
+/**
+ * @file decoder_pool.h
+ * @brief Decoders created on first use and freed again when idle
+ *
+ * A statically constructed MP3/AAC decoder costs its RAM for the whole run,
+ * even when the catalog holds no file of that type. A LazyDecoder stands in
+ * for one in the player's MultiDecoder: it is registered per MIME type like
+ * the real one, but only constructs the real decoder when MultiDecoder
+ * selects it (begin()) or writes to it. The object goes to PSRAM when there
+ * is any, keeping internal SRAM for WiFi, WireGuard and task stacks; what
+ * the decoder allocates itself follows the heap's usual placement.
+ *
+ *   LazyDecoder mp3(LazyDecoder::make<MP3DecoderHelix>, sizeof(MP3DecoderHelix), "mp3");
+ *   audioPlayer.addDecoder(mp3, "audio/mpeg");
+ *
+ * decoderPool.tick() (loop) destroys decoders that have had no write for
+ * DECODER_IDLE_MS while nothing plays. The next file of that type creates
+ * it again, costing only a constructor and begin().
+ *
+ * Writes come from the task that drives the player (loop(), or the decode
+ * task with AUDIO_OUTPUT_TASK_ENABLED); the pool mutex keeps tick() from
+ * freeing a decoder mid-write.
+ *
+ * @date 2026
+ */
+
+#ifndef DECODER_POOL_H
+#define DECODER_POOL_H
+
+#include <Arduino.h>
+#include <new>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "AudioTools/AudioCodecs/AudioCodecsBase.h"
+
+using namespace audio_tools;
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Decoders idle this long (and nothing playing) are destroyed
+#ifndef DECODER_IDLE_MS
+#define DECODER_IDLE_MS 60000
+#endif
+
+#ifndef DECODER_POOL_MAX
+#define DECODER_POOL_MAX 6
+#endif
+
+// ============================================================================
+// LAZY DECODER
+// ============================================================================
+
+class LazyDecoder : public AudioDecoder {
+public:
+    /// Placement-constructs the real decoder in mem (sizeof bytes)
+    using Factory = AudioDecoder* (*)(void* mem);
+
+    template <class T>
+    static AudioDecoder* make(void* mem) { return new (mem) T(); }
+
+    LazyDecoder(Factory factory, size_t size, const char* name);
+    ~LazyDecoder();
+
+    using AudioDecoder::setOutput;
+    void setOutput(Print& out) override;
+    bool begin() override;
+    void end() override;
+    size_t write(const uint8_t* data, size_t len) override;
+    AudioInfo audioInfo() override;
+    bool isResultPCM() override;
+    operator bool() override;
+
+    const char* name() const { return _name; }
+    bool live() const { return _decoder != nullptr; }
+    bool inPsram() const { return _inPsram; }
+    size_t size() const { return _size; }
+    uint32_t creations() const { return _creations; }
+
+private:
+    friend class DecoderPool;
+
+    Factory       _factory;
+    size_t        _size;
+    const char*   _name;
+    AudioDecoder* _decoder = nullptr;
+    void*         _mem = nullptr;
+    bool          _inPsram = false;
+    bool          _open = false;           // Between begin() and end()
+    unsigned long _lastUsed = 0;
+    uint32_t      _creations = 0;
+
+    bool create();                         // Pool mutex held
+    void destroy();                        // Pool mutex held
+};
+
+// ============================================================================
+// POOL
+// ============================================================================
+
+class DecoderPool {
+public:
+    /// Free decoders idle for DECODER_IDLE_MS; call from loop()
+    void tick(bool playerActive);
+
+    void printStatus();
+
+private:
+    friend class LazyDecoder;
+
+    LazyDecoder*      _decoders[DECODER_POOL_MAX] = {};
+    int               _count = 0;
+    SemaphoreHandle_t _lock = nullptr;
+    unsigned long     _lastTick = 0;
+
+    void add(LazyDecoder* d);
+    void lock();
+    void unlock();
+};
+
+extern DecoderPool decoderPool;
+
+#endif // DECODER_POOL_H
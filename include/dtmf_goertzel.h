@@ -1,13 +1,22 @@
 #ifndef DTMF_GOERTZEL_H
 #define DTMF_GOERTZEL_H
 
-#include "AudioTools/CoreAudio/GoerzelStream.h"
 #include "AudioTools/CoreAudio/StreamCopy.h"
+#include "dtmf_goertzel_engine.h"
+#include "mic_ring_buffer.h"
 
 // Initialize Goertzel-based DTMF decoder
 // More efficient than FFT when only detecting specific frequencies
 // Goertzel is O(n*k) vs FFT O(n log n), much faster for 8 DTMF frequencies
-void initGoertzelDecoder(GoertzelStream &goertzel, StreamCopy &copier, bool startTask=false);
+// All 8 bins run in one fixed-point pass per block (see dtmf_goertzel_engine.h)
+// Returns false (and starts no task) if the engine rejects the configured geometry
+bool initGoertzelDecoder(DtmfGoertzelStream &goertzel, StreamCopy &copier, bool startTask=false);
+
+// Whether initGoertzelDecoder() would accept this window/hop pair (ms)
+bool goertzelGeometryValid(float windowMs, float hopMs);
+
+// The Goertzel task's cursor into the mic ring (source for its StreamCopy)
+MicRingReader& getGoertzelMicReader();
 
 // Start Goertzel processing on a separate FreeRTOS task (core 0)
 // This prevents blocking the main loop (audio runs on core 1)
@@ -19,17 +28,100 @@ void stopGoertzelTask();
 // Check if Goertzel task is running
 bool isGoertzelTaskRunning();
 
+// The task is past its start-up delay and evaluating audio
+bool isGoertzelDetecting();
+
 // Get pending key from Goertzel decoder (returns 0 if none)
 char getGoertzelKey();
 
 // Reset Goertzel detection state (clear any stale partial detections)
 void resetGoertzelState();
 
-// Process accumulated Goertzel block data (call after feeding samples via StreamCopy)
+// Evaluate the latest completed Goertzel block (call after feeding samples via StreamCopy)
 void processGoertzelBlock();
 
+// Goertzel task counters (reset when the task starts)
+struct GoertzelTaskStats {
+    uint32_t wakeups;         // Task loop iterations
+    uint32_t frames;          // copy() calls that moved audio
+    uint32_t overruns;        // Times the task fell more than the mic ring behind
+    uint32_t missedFrames;    // DMA frames' worth of samples skipped by those overruns
+    uint32_t droppedResults;  // Window results discarded before evaluation
+    uint32_t analysedHops;    // Hops the Goertzel bank ran on
+    uint32_t gatedHops;       // Hops the energy gate skipped
+};
+GoertzelTaskStats getGoertzelTaskStats();
+
+// Detector statistics (since boot or the last reset). Written only by the
+// Goertzel task with plain 32-bit stores; readers take a snapshot copy, so
+// fields may be a window apart but never torn.
+#define GOERTZEL_HISTOGRAM_BUCKETS 8
+#define GOERTZEL_LATENCY_BUCKET_MS 20
+struct GoertzelDetectorStats {
+    uint32_t evaluations;          // Window results evaluated
+    uint32_t mutedWindows;         // Window results discarded while muted
+    uint32_t silentWindows;        // Nothing above presence (noise floor updates)
+    uint32_t gatedWindows;         // Whole window under the energy gate (bank skipped)
+    uint32_t detections[16];       // Digits emitted, per key (row * 4 + col)
+    uint32_t rejectPartial;        // Only a row or only a column present
+    uint32_t rejectFloor;          // Pair below the detection floor
+    uint32_t rejectTwist;
+    uint32_t rejectHarmonic;
+    uint32_t rejectEnergy;
+    uint32_t queueDrops;           // Digits lost to a full key queue
+    // Weaker band magnitude, log2 buckets: <16, <32, ... <1024, >=1024
+    uint32_t emitMagnitude[GOERTZEL_HISTOGRAM_BUCKETS];    // At emission
+    uint32_t rejectMagnitude[GOERTZEL_HISTOGRAM_BUCKETS];  // Two-band windows rejected by a gate
+    // First hit to emission, GOERTZEL_LATENCY_BUCKET_MS buckets (last is open-ended)
+    uint32_t latency[GOERTZEL_HISTOGRAM_BUCKETS];
+    uint32_t latencyMinMs;
+    uint32_t latencyMaxMs;
+    uint32_t latencyTotalMs;       // Sum over all emissions (mean = total / emitted)
+};
+GoertzelDetectorStats getGoertzelDetectorStats();
+// Zero the detector statistics (applied by the Goertzel task at its next evaluation)
+void resetGoertzelDetectorStats();
+// Detector + task statistics as a JSON object (for /api/dtmf/stats)
+String getGoertzelStatsJson();
+// Print detector + task statistics to the log
+void printGoertzelStats();
+
+// Detection thresholds in effect: PhoneConfig values, or a stored keypad
+// calibration. SNR gates are relative to each bin's running noise floor;
+// the magnitudes are absolute minimums applied on top.
+struct GoertzelThresholds {
+    float presenceSnrDb;          // Per-bin presence over its noise floor
+    float detectionSnrDb;         // Chosen row and col over their noise floors
+    float minPresenceMagnitude;   // Absolute per-bin presence minimum
+    float minDetectionMagnitude;  // Absolute row/col minimum
+    float maxTwistRatio;
+    bool calibrated;              // Loaded from a keypad calibration
+};
+GoertzelThresholds getGoertzelThresholds();
+// Re-derive the thresholds after PhoneConfig changed at runtime (a stored
+// calibration still wins). Applied by the Goertzel task at its next evaluation.
+void reloadGoertzelThresholds();
+
+// Current noise-floor estimate (0-3 rows, 4-7 cols)
+float getGoertzelNoiseFloor(int bin);
+
+// Keypad calibration: press 1-9, *, 0, # once each (any order). Detected
+// keys are not dialled; when all twelve are seen the thresholds are derived
+// and saved to NVS. Runs in the Goertzel task; times out after
+// GOERTZEL_CALIBRATION_TIMEOUT_MS.
+void startGoertzelCalibration();
+bool isGoertzelCalibrating();
+// Forget the stored calibration and return to the PhoneConfig thresholds
+void clearGoertzelCalibration();
+
 // Mute/unmute Goertzel detection (suppresses false detections from DAC→ADC loopback)
 void setGoertzelMuted(bool muted);
 bool isGoertzelMuted();
 
+// Park the Goertzel task without stopping it (low-power state: the mic ring
+// isn't being filled). Unpausing resumes at live audio with fresh state, so
+// there's no startup delay.
+void setGoertzelPaused(bool paused);
+bool isGoertzelPaused();
+
 #endif // DTMF_GOERTZEL_H
@@ -0,0 +1,531 @@
+/**
+ * @file dtmf_goertzel_engine.h
+ * @brief Dedicated 8-bin DTMF Goertzel engine (fixed-point, single pass)
+ *
+ * Replaces the generic AudioTools GoertzelStream (one float detector per
+ * frequency, callback per bin) with a purpose-built kernel that runs all four
+ * row and four column recurrences in a single pass over an int16 block:
+ *
+ *   s[n] = x[n] + c·s[n-1] − s[n-2]      c = 2·cos(2π·f/fs) in Q30
+ *
+ * States are int32, the per-sample multiply is a 32×32→64 MAC, and the float
+ * magnitude is only computed once per block per bin. No callbacks, no
+ * volatile accumulators — process() fills a packed DtmfBandMagnitudes.
+ *
+ * Magnitudes are scaled exactly like GoertzelStream's (input normalized to
+ * ±1.0, |X(k)| not divided by N) so existing PhoneConfig thresholds keep
+ * their meaning. After decimation each bin is multiplied by
+ * decimation/|H(f)|, so a tone reads the same as it would at the codec rate.
+ *
+ * Sliding mode: DtmfGoertzelStream can run the engine on hop-sized sub-blocks
+ * and sum the last window/hop complex results (phase-aligned to the absolute
+ * sample index). That is the exact DFT of the whole window, so a 2048-sample
+ * window with a 512-sample hop has block-mode accuracy, a result every hop,
+ * and the same per-sample cost.
+ *
+ * Decimating front-end: DTMF energy lives below 1.7 kHz, so the stream first
+ * low-passes and decimates the codec rate by GOERTZEL_DECIMATION (44.1 kHz →
+ * 8.82 kHz by default) with a polyphase FIR that only computes the kept
+ * output samples. The Goertzel kernel then runs on 1/5 of the samples.
+ * Window and hop are configured in milliseconds so the rate is free to change.
+ *
+ * Talk-off extras: with GOERTZEL_HARMONIC_BINS the same pass also runs the
+ * 2nd harmonic of every DTMF frequency and sums x², so the detector can
+ * require the tone pair to dominate the block instead of merely being the
+ * strongest bins in it.
+ *
+ * Energy gate: every hop's energy is summed first (one MAC per sample).
+ * When it is below what any tone passing the presence threshold would put
+ * into a hop (setGateMagnitude()), the bank is skipped and the hop counts
+ * as zero in the window sum. The hop before the first open one is kept and
+ * analysed late, so an onset that started there is still counted. A window
+ * whose hops were all gated comes out flagged DtmfBandMagnitudes::gated.
+ *
+ * Optional backend: with -DGOERTZEL_USE_ESP_DSP=1 the bins are computed as
+ * sin/cos correlations with esp-dsp's dsps_dotprod_f32 (SIMD on ESP32-S3).
+ * Basis tables live in PSRAM; the fixed-point kernel remains the default.
+ *
+ * @author Bowie Phone Project
+ * @date 2026
+ */
+
+#ifndef DTMF_GOERTZEL_ENGINE_H
+#define DTMF_GOERTZEL_ENGINE_H
+
+#include <Arduino.h>
+#include "AudioTools/CoreAudio/AudioOutput.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+#ifndef GOERTZEL_USE_ESP_DSP
+#define GOERTZEL_USE_ESP_DSP 0
+#endif
+
+/// Largest block the fixed-point kernel is rated for. At 44.1 kHz and 697 Hz a
+/// full-scale on-bin tone grows the int32 state to ~7e8 after 4096 samples.
+#ifndef GOERTZEL_ENGINE_MAX_BLOCK
+#define GOERTZEL_ENGINE_MAX_BLOCK 4096
+#endif
+
+/// Integer decimation ahead of the Goertzel kernel (1 = run at codec rate).
+/// 5 takes 44.1 kHz to 8.82 kHz: Nyquist 4.41 kHz keeps every DTMF bin and
+/// its 2nd harmonic.
+#ifndef GOERTZEL_DECIMATION
+#define GOERTZEL_DECIMATION 5
+#endif
+
+/// Anti-alias FIR length (input-rate taps). Cost is taps/decimation MACs per
+/// input sample; 20 taps put the stopband past ~6 kHz, so nothing folds onto
+/// the 697-1633 Hz bins.
+#ifndef GOERTZEL_DECIMATOR_TAPS
+#define GOERTZEL_DECIMATOR_TAPS 20
+#endif
+
+/// Anti-alias FIR cutoff in Hz (passband must cover 1633 Hz with headroom)
+#ifndef GOERTZEL_DECIMATOR_CUTOFF_HZ
+#define GOERTZEL_DECIMATOR_CUTOFF_HZ 3000.0f
+#endif
+
+/// Loopback canceller: reference bins at or below this carry no loopback
+#ifndef LOOPBACK_REF_MIN_MAGNITUDE
+#define LOOPBACK_REF_MIN_MAGNITUDE 5.0f
+#endif
+
+/// Coupling estimate tracking rates: fast toward a smaller mic/ref ratio
+/// (pure loopback) and slow toward a larger one (a key press adds energy)
+#ifndef LOOPBACK_COUPLING_ATTACK
+#define LOOPBACK_COUPLING_ATTACK 0.3f
+#endif
+#ifndef LOOPBACK_COUPLING_RELEASE
+#define LOOPBACK_COUPLING_RELEASE 0.02f
+#endif
+
+/// Starting and maximum mic/ref coupling per bin
+#ifndef LOOPBACK_COUPLING_INITIAL
+#define LOOPBACK_COUPLING_INITIAL 1.0f
+#endif
+#ifndef LOOPBACK_COUPLING_MAX
+#define LOOPBACK_COUPLING_MAX 4.0f
+#endif
+
+/// Over-subtraction margin applied to the estimated loopback
+#ifndef LOOPBACK_OVERSUBTRACT
+#define LOOPBACK_OVERSUBTRACT 1.5f
+#endif
+
+/// Noise floor: per-bin tracking rates toward lower and higher magnitudes.
+/// Falls in a few windows, rises over seconds, so brief noise bursts and
+/// tone onsets barely lift it (minimum-statistics style)
+#ifndef GOERTZEL_NOISE_FLOOR_FALL
+#define GOERTZEL_NOISE_FLOOR_FALL 0.2f
+#endif
+#ifndef GOERTZEL_NOISE_FLOOR_RISE
+#define GOERTZEL_NOISE_FLOOR_RISE 0.01f
+#endif
+
+/// Starting estimate and lower bound for a bin's noise floor
+#ifndef GOERTZEL_NOISE_FLOOR_INITIAL
+#define GOERTZEL_NOISE_FLOOR_INITIAL 2.0f
+#endif
+#ifndef GOERTZEL_NOISE_FLOOR_MIN
+#define GOERTZEL_NOISE_FLOOR_MIN 0.5f
+#endif
+
+/// Also run the 2nd harmonic of each DTMF frequency (8 more bins in the
+/// same pass) for talk-off rejection. 0 = fundamentals only.
+#ifndef GOERTZEL_HARMONIC_BINS
+#define GOERTZEL_HARMONIC_BINS 1
+#endif
+
+#if GOERTZEL_HARMONIC_BINS
+#define GOERTZEL_BIN_COUNT 16
+#else
+#define GOERTZEL_BIN_COUNT 8
+#endif
+
+/// Skip the bank on hops without the energy of a detectable tone
+#ifndef GOERTZEL_ENERGY_GATE
+#define GOERTZEL_ENERGY_GATE 1
+#endif
+
+/// Gate level relative to the energy a hop-filling tone at the gate
+/// magnitude carries. 0.25 (−6 dB) covers an onset partway into the hop
+/// and passband ripple.
+#ifndef GOERTZEL_GATE_MARGIN
+#define GOERTZEL_GATE_MARGIN 0.25f
+#endif
+
+/// Completed-window results DtmfGoertzelStream holds until readMagnitudes()
+#ifndef GOERTZEL_PENDING_RESULTS
+#define GOERTZEL_PENDING_RESULTS 4
+#endif
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+/**
+ * @brief Magnitudes of the 8 DTMF bins (and validation extras) for one block
+ */
+struct DtmfBandMagnitudes
+{
+    float row[4];          ///< 697 / 770 / 852 / 941 Hz (per PhoneConfig::rowFreqs)
+    float col[4];          ///< 1209 / 1336 / 1477 / 1633 Hz (per PhoneConfig::colFreqs)
+    float rowHarmonic[4];  ///< 2× each row frequency (0 without GOERTZEL_HARMONIC_BINS)
+    float colHarmonic[4];  ///< 2× each column frequency
+    /// Whole-block in-band energy as the magnitude one tone carrying all of
+    /// it would read: row² + col² ≈ total² for a clean DTMF pair.
+    /// 0 = not measured.
+    float total;
+    /// Every hop in the window was under the energy gate: the bank didn't
+    /// run and the bin magnitudes are 0
+    bool gated;
+};
+
+/**
+ * @brief Complex DFT value of the bins for one block
+ *
+ * X(ω) = Σ x[n]·e^(−iωn) over the block, input normalized to ±1.0, phase
+ * referenced to the block's first sample. Index 0-3 rows, 4-7 cols, then
+ * (with GOERTZEL_HARMONIC_BINS) 8-11 row and 12-15 col 2nd harmonics.
+ */
+struct DtmfBinSpectrum
+{
+    float re[GOERTZEL_BIN_COUNT];
+    float im[GOERTZEL_BIN_COUNT];
+    float energy;          ///< Σ (x[n] − mean)² over the block (normalized input)
+};
+
+/// Frequency of engine bin @p bin (see DtmfBinSpectrum for the layout)
+inline float dtmfBinFrequency(const float rowFreqs[4], const float colFreqs[4], int bin)
+{
+    float freq = (bin & 4) ? colFreqs[bin & 3] : rowFreqs[bin & 3];
+    return (bin >= 8) ? 2.0f * freq : freq;
+}
+
+/// Magnitude slot for engine bin @p bin
+inline float& dtmfBinMagnitude(DtmfBandMagnitudes& mags, int bin)
+{
+    switch (bin >> 2) {
+        case 0:  return mags.row[bin & 3];
+        case 1:  return mags.col[bin & 3];
+        case 2:  return mags.rowHarmonic[bin & 3];
+        default: return mags.colHarmonic[bin & 3];
+    }
+}
+
+inline float dtmfBinMagnitude(const DtmfBandMagnitudes& mags, int bin)
+{
+    switch (bin >> 2) {
+        case 0:  return mags.row[bin & 3];
+        case 1:  return mags.col[bin & 3];
+        case 2:  return mags.rowHarmonic[bin & 3];
+        default: return mags.colHarmonic[bin & 3];
+    }
+}
+
+/**
+ * @brief Stateless-per-block 8-bin (16 with harmonics) Goertzel kernel
+ *
+ * The same pass also sums x² for the block energy.
+ */
+class DtmfGoertzelEngine
+{
+public:
+    DtmfGoertzelEngine() = default;
+    ~DtmfGoertzelEngine() { end(); }
+
+    /**
+     * @brief Precompute coefficients for the DTMF (and harmonic) bins
+     * @param rowFreqs 4 row frequencies in Hz
+     * @param colFreqs 4 column frequencies in Hz
+     * @param sampleRate Input sample rate in Hz
+     * @param blockSize Samples per block (1..GOERTZEL_ENGINE_MAX_BLOCK)
+     * @return true on success
+     */
+    bool begin(const float rowFreqs[4], const float colFreqs[4], float sampleRate, int blockSize);
+
+    /**
+     * @brief Release backend tables
+     */
+    void end();
+
+    /**
+     * @brief Run all 8 recurrences over exactly blockSize() samples
+     * @param samples Mono int16 block
+     * @param out Receives the 8 magnitudes
+     */
+    void process(const int16_t* samples, DtmfBandMagnitudes& out);
+
+    /**
+     * @brief Run all 8 recurrences and return complex bin values
+     * @param samples Mono int16 block of blockSize() samples
+     * @param out Receives X(ω) per bin (see DtmfBinSpectrum)
+     */
+    void analyze(const int16_t* samples, DtmfBinSpectrum& out);
+
+    /// Bin angular frequency in radians/sample (see DtmfBinSpectrum layout)
+    float omega(int bin) const { return _omega[bin]; }
+
+    int blockSize() const { return _blockSize; }
+    float sampleRate() const { return _sampleRate; }
+
+private:
+    int _blockSize = 0;
+    float _sampleRate = 0;
+    int32_t _coeffQ30[GOERTZEL_BIN_COUNT] = {};  ///< 2·cos(ω) in Q30
+    float _omega[GOERTZEL_BIN_COUNT] = {};
+    float _cos[GOERTZEL_BIN_COUNT] = {};
+    float _sin[GOERTZEL_BIN_COUNT] = {};
+    float _endRe[GOERTZEL_BIN_COUNT] = {};       ///< e^(−iω(N−1)): Goertzel output → block-start phase
+    float _endIm[GOERTZEL_BIN_COUNT] = {};
+#if GOERTZEL_USE_ESP_DSP
+    float* _basis = nullptr;       ///< [bin][cos|sin][n] correlation tables (PSRAM)
+    float* _scratch = nullptr;     ///< Normalized float copy of the input block
+#endif
+};
+
+/**
+ * @brief Polyphase FIR low-pass + integer decimator for int16 PCM
+ *
+ * Windowed-sinc (Hamming) taps in Q15, normalized to unity DC gain. push()
+ * takes every input sample into a doubled history ring but only evaluates
+ * the filter on the one-in-factor() samples that are kept, which is the
+ * polyphase form's cost without splitting the taps into sub-filters.
+ */
+class DtmfDecimator
+{
+public:
+    DtmfDecimator() = default;
+    ~DtmfDecimator() { end(); }
+
+    /**
+     * @brief Design the filter and allocate the history
+     * @param factor Decimation factor (1 = pass-through)
+     * @param taps FIR length at the input rate
+     * @param cutoffHz Low-pass cutoff in Hz
+     * @param sampleRate Input sample rate in Hz
+     * @return true on success
+     */
+    bool begin(int factor, int taps, float cutoffHz, float sampleRate);
+    void end();
+
+    /// Clear history and phase
+    void reset();
+
+    /**
+     * @brief Feed one input sample
+     * @param x Input sample
+     * @param out Receives the decimated sample when one is produced
+     * @return true if @p out was written
+     */
+    bool push(int16_t x, int16_t& out);
+
+    /// |H(f)| of the designed filter (used to undo passband droop per bin)
+    float gainAt(float freqHz) const;
+
+    int factor() const { return _factor; }
+
+private:
+    int16_t* _coeffs = nullptr;    ///< Q15 taps
+    int16_t* _history = nullptr;   ///< 2×taps ring: every sample written twice
+    int _taps = 0;
+    int _pos = 0;
+    int _phase = 0;
+    int _factor = 1;
+    float _sampleRate = 0;
+};
+
+/**
+ * @brief Print sink that frames mic PCM into blocks for DtmfGoertzelEngine
+ *
+ * Drop-in target for StreamCopy (kit → DtmfGoertzelStream). write() collects
+ * int16 samples (first channel only when interleaved), decimates them to
+ * detectorSampleRate() and runs the engine every hop. Each hop yields the magnitudes of the trailing window; results
+ * queue (up to GOERTZEL_PENDING_RESULTS) until readMagnitudes() takes them.
+ * It is written and read from the same (Goertzel) task.
+ */
+class DtmfGoertzelStream : public AudioOutput
+{
+public:
+    DtmfGoertzelStream() = default;
+    ~DtmfGoertzelStream() { end(); }
+
+    /**
+     * @brief Configure decimator and bins, allocate the hop and window buffers
+     * @param info Input audio format (16-bit PCM expected)
+     * @param rowFreqs 4 row frequencies in Hz
+     * @param colFreqs 4 column frequencies in Hz
+     * @param windowMs Analysis window length in ms
+     * @param hopMs Time between results in ms; 0 or >= windowMs = non-overlapping
+     *        blocks. The window is rounded to a whole number of hops.
+     * @return true on success
+     */
+    bool begin(AudioInfo info, const float rowFreqs[4], const float colFreqs[4],
+               float windowMs, float hopMs = 0);
+    void end() override;
+
+    size_t write(const uint8_t* data, size_t len) override;
+    int availableForWrite() override { return inputHopSamples() * _channels * (int)sizeof(int16_t); }
+
+    /**
+     * @brief Take the oldest pending window result
+     * @param out Receives magnitudes if one is pending
+     * @return true if a result was pending
+     */
+    bool readMagnitudes(DtmfBandMagnitudes& out);
+
+    /**
+     * @brief Clear the window history, partial hop and pending results
+     */
+    void reset();
+
+    /// Most hops one window can span (one _gatedMask bit each)
+    static constexpr int MAX_CHUNKS = 32;
+
+    /**
+     * @brief Hop size and hops per window for a window/hop pair, as begin() uses them
+     * @param detectorRate Sample rate after decimation
+     * @return false if the hop rounds to no samples or the window spans
+     *         more than MAX_CHUNKS hops
+     */
+    static bool geometry(float detectorRate, float windowMs, float hopMs,
+                         int& hopSize, int& chunkCount);
+
+    /// Window and hop in detector-rate samples
+    int windowSize() const { return _hopSize * _chunkCount; }
+    int hopSize() const { return _hopSize; }
+
+    /// Sample rate the Goertzel kernel runs at (input rate / decimation())
+    float detectorSampleRate() const { return _engine.sampleRate(); }
+    int decimation() const { return _decimator.factor(); }
+
+    /// Input (codec-rate) frames consumed per hop
+    int inputHopSamples() const { return _hopSize * _decimator.factor(); }
+
+    /// Results discarded because readMagnitudes() fell behind
+    uint32_t droppedBlocks() const { return _droppedBlocks; }
+
+    /**
+     * @brief Set the energy gate from a per-bin magnitude
+     * @param magnitude Weakest magnitude (codec-rate scale) that could pass
+     *        presence; hops without that much energy skip the bank.
+     *        0 = always run it.
+     */
+    void setGateMagnitude(float magnitude);
+
+    /// Hops analysed, and hops the energy gate skipped
+    uint32_t analysedHops() const { return _analysedHops; }
+    uint32_t gatedHops() const { return _gatedHops; }
+
+private:
+    void completeHop();
+    void analyzeInto(const int16_t* samples, const float* rotRe, const float* rotIm,
+                     DtmfBinSpectrum& slot);
+
+    DtmfDecimator _decimator;
+    DtmfGoertzelEngine _engine;
+    float _binScale[GOERTZEL_BIN_COUNT] = {};  ///< decimation / |H(f)|: keeps codec-rate magnitude scale
+    int16_t* _block = nullptr;     ///< Current hop being filled
+    int16_t* _prevBlock = nullptr; ///< Previous hop, for late analysis when the gate opens
+    int _hopSize = 0;
+    int _fill = 0;
+    DtmfBinSpectrum* _chunks = nullptr;  ///< Last window/hop hop spectra (absolute phase)
+    int _chunkCount = 0;
+    int _chunkIndex = 0;
+    float _rotRe[GOERTZEL_BIN_COUNT] = {};     ///< e^(−iω·start) of the current hop
+    float _rotIm[GOERTZEL_BIN_COUNT] = {};
+    float _stepRe[GOERTZEL_BIN_COUNT] = {};    ///< e^(−iω·hop)
+    float _stepIm[GOERTZEL_BIN_COUNT] = {};
+    float _prevRotRe[GOERTZEL_BIN_COUNT] = {}; ///< Rotation of _prevBlock
+    float _prevRotIm[GOERTZEL_BIN_COUNT] = {};
+    float _gateEnergy = 0;         ///< Hop energy below which the bank is skipped (0 = off)
+    uint32_t _gatedMask = 0;       ///< Bit per chunk slot holding a gated (zero) hop
+    uint32_t _analysedHops = 0;
+    uint32_t _gatedHops = 0;
+    int _channels = 1;
+    int _channelIndex = 0;         ///< Position within the current interleaved frame
+    uint8_t _pendingByte = 0;      ///< Low byte of a sample split across writes
+    bool _hasPendingByte = false;
+    DtmfBandMagnitudes _pending[GOERTZEL_PENDING_RESULTS] = {};
+    int _pendingHead = 0;
+    int _pendingCount = 0;
+    uint32_t _droppedBlocks = 0;
+};
+
+/**
+ * @brief Per-bin subtraction of the known output spectrum from the mic
+ *
+ * The reference is the player's own PCM run through a second
+ * DtmfGoertzelStream in lockstep with the mic. For each bin the loopback
+ * coupling g = |mic| / |ref| is tracked as a running minimum: it falls
+ * quickly and rises slowly, so a key press over playback barely moves it.
+ * The cleaned magnitude is max(0, |mic| − β·g·|ref|). Bins with no
+ * reference energy pass through untouched. Harmonic bins are cleaned the
+ * same way; the block energy cannot be, so it is marked unmeasured (0)
+ * whenever the reference is playing.
+ */
+class DtmfLoopbackCanceller
+{
+public:
+    DtmfLoopbackCanceller() { reset(); }
+
+    /// Forget the learned coupling
+    void reset();
+
+    /**
+     * @brief Subtract the estimated loopback from one window result
+     * @param mic Mic magnitudes, cleaned in place
+     * @param ref Reference magnitudes for the same window
+     */
+    void process(DtmfBandMagnitudes& mic, const DtmfBandMagnitudes& ref);
+
+    /// Current coupling estimate (DtmfBinSpectrum bin layout)
+    float coupling(int bin) const { return _coupling[bin]; }
+
+private:
+    float _coupling[GOERTZEL_BIN_COUNT];
+};
+
+/**
+ * @brief Running per-bin noise-floor estimate
+ *
+ * Fed only with windows the detector classified as silence. Each bin
+ * follows an asymmetric EMA (fast down, slow up) clamped at
+ * GOERTZEL_NOISE_FLOOR_MIN, which approximates the minimum of recent
+ * silent windows. Thresholds are then expressed as SNR over this floor.
+ */
+class DtmfNoiseFloor
+{
+public:
+    DtmfNoiseFloor() { reset(); }
+
+    /// Return every bin to GOERTZEL_NOISE_FLOOR_INITIAL
+    void reset();
+
+    /// Fold one silent window into the estimate
+    void update(const DtmfBandMagnitudes& mags);
+
+    /// A window with no bin magnitudes (gated) but whose whole energy reads
+    /// @p ceiling: no bin can be louder, so floors above it fall towards it
+    void limit(float ceiling);
+
+    /// Floor estimate (0-3 rows, 4-7 cols)
+    float floor(int bin) const { return _floor[bin]; }
+    float rowFloor(int row) const { return _floor[row]; }
+    float colFloor(int col) const { return _floor[4 + col]; }
+
+    /// Highest floor across all bins
+    float maxFloor() const;
+
+private:
+    float _floor[8];
+};
+
+/// Amplitude ratio for a level in dB (20·log10)
+inline float dtmfDbToRatio(float db) { return powf(10.0f, db / 20.0f); }
+inline float dtmfRatioToDb(float ratio) { return ratio > 0 ? 20.0f * log10f(ratio) : -120.0f; }
+
+#endif // DTMF_GOERTZEL_ENGINE_H
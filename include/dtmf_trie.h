@@ -0,0 +1,109 @@
+/**
+ * @file dtmf_trie.h
+ * @brief Compact 16-ary trie over DTMF sequences for digit-by-digit matching
+ *
+ * Holds every dialable sequence (registered audio keys and special
+ * commands) so the sequence processor can follow a dial one digit at a
+ * time. A cursor is a node index; step() moves it one digit in O(1), and
+ * the node then says whether the digits so far are a complete sequence,
+ * whether more digits could follow, or neither (dead end).
+ *
+ * Nodes are 6 bytes: a bitmask of the digits that continue (0-9, *, #,
+ * A-D) and the index of the first child. Children of a node are stored
+ * contiguously in digit order, so a child's index is firstChild plus the
+ * number of mask bits below its digit.
+ *
+ * Fill with add() then call build(); lookups are read-only afterwards.
+ * The built nodes sit in one PSRAM arena block that each build() replaces.
+ *
+ * @date 2026
+ */
+
+#ifndef DTMF_TRIE_H
+#define DTMF_TRIE_H
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include "psram_alloc.h"
+
+class DtmfTrie
+{
+public:
+    typedef uint16_t Node;
+    static constexpr Node ROOT = 0;
+    static constexpr Node DEAD = 0xFFFF;
+
+    /// What a sequence ending at a node is (may be both)
+    enum TerminalFlags : uint8_t {
+        TERMINAL_KEY = 0x01,          ///< Registered audio key
+        TERMINAL_COMMAND = 0x02,      ///< Special command
+    };
+
+    /// 0-15 for 0-9, *, #, A-D; -1 for anything else
+    static int digitIndex(char digit);
+
+    /**
+     * @brief Stage a sequence for the next build()
+     * @return false if it contains non-DTMF characters (skipped)
+     */
+    bool add(const char* sequence, uint8_t flags);
+
+    /**
+     * @brief Build the trie from the staged sequences, replacing the old one
+     * @return false if the sequences need more than DEAD nodes (trie left empty)
+     */
+    bool build();
+
+    void clear();
+
+    /// True once build() has succeeded
+    bool ready() const { return nodeTotal != 0; }
+
+    /// Follow @p digit from @p node (DEAD if nothing continues with it)
+    Node step(Node node, char digit) const;
+
+    /// TerminalFlags of the sequence ending at @p node (0 if none)
+    uint8_t terminal(Node node) const { return node < nodeTotal ? nodes[node].flags : 0; }
+
+    /// True if longer sequences continue past @p node
+    bool canContinue(Node node) const { return node < nodeTotal && nodes[node].childMask != 0; }
+
+    /// Called for each sequence forEachUnder() finds; return false to stop
+    typedef bool (*SequenceVisitor)(const char* sequence, uint8_t flags, void* userData);
+
+    /**
+     * @brief Visit the complete sequences at or below @p node, in digit order
+     * @param prefix Digits that led to @p node (each visited sequence starts with them)
+     * @param flags Only sequences with one of these TerminalFlags
+     * @return Number of sequences visited (including the one that stopped the walk)
+     *
+     * Keys aren't stored, so this walks the subtree rebuilding the digits —
+     * cost is the subtree size, meant for a cursor a few digits in.
+     */
+    size_t forEachUnder(Node node, const char* prefix, uint8_t flags,
+                        SequenceVisitor visit, void* userData) const;
+
+    size_t nodeCount() const { return nodeTotal; }
+    size_t sequenceCount() const { return sequences; }
+
+private:
+    struct TrieNode {
+        uint16_t childMask;           // Bit per digitIndex() that has a child
+        uint16_t firstChild;
+        uint8_t flags;                // TerminalFlags
+    };
+
+    static constexpr size_t MAX_VISIT_LENGTH = 32;
+
+    bool visitFrom(Node node, char* sequence, size_t length, uint8_t flags,
+                   SequenceVisitor visit, void* userData, size_t& visited) const;
+
+    PsramArena arena;                 // Holds nodes; reset by every build()
+    TrieNode* nodes = nullptr;
+    size_t nodeTotal = 0;
+    PsramVector<std::pair<std::string, uint8_t>> staged;
+    size_t sequences = 0;
+};
+
+#endif // DTMF_TRIE_H
@@ -20,12 +20,24 @@
 #include "AudioTools/AudioCodecs/CodecCopy.h"
 #include "audio_key_registry.h"
 #include "file_utils.h"
+#include "mic_ring_buffer.h"
+#include "audio_mixer.h"
+#include "audio_copy_meter.h"
+#include "audio_queue.h"
+#if AUDIO_PCM_CACHE_ENABLED
+#include "audio_pcm_cache.h"
+#endif
+#if AUDIO_URL_JITTER_ENABLED
+#include "audio_url_stream.h"
+#endif
+#if AUDIO_FILE_READAHEAD_ENABLED
+#include "audio_file_stream.h"
+#endif
 #if SD_USE_MMC
   #include <SD_MMC.h>
 #else
   #include <SD.h>
 #endif
-#include <vector>
 
 using namespace audio_tools;
 
@@ -37,43 +49,55 @@ using namespace audio_tools;
 #define DEFAULT_AUDIO_VOLUME 0.7f  ///< Default audio volume (0.0 to 1.0)
 #endif
 
+/// 1 = set the volume in the codec (setHardwareVolume()) so the PCM passes
+/// through at full scale; 0 = Q15 gain in the mixer. The ES8388's output
+/// volume moves in coarse steps.
+#ifndef AUDIO_HW_VOLUME
+#define AUDIO_HW_VOLUME 0
+#endif
+
 #ifndef URL_STREAM_BUFFER_SIZE
 #define URL_STREAM_BUFFER_SIZE 2048  ///< Buffer size for URL streaming
 #endif
 
-// Maximum time (ms) copy() can return 0 bytes before we declare a stall.
-// Generators produce data every call; file/URL streams may briefly stall
-// during seeks, but >3 s of nothing means the decoder is stuck.
-static constexpr unsigned long COPY_STALL_TIMEOUT_MS = 3000;
-// Maximum consecutive zero-byte copy() calls before stall (secondary check)
-static constexpr int COPY_STALL_MAX_ZERO = 300;
+// Look-ahead: while the current item plays out, the next queued file is
+// opened and sniffed so the transition skips the SD open. Generators and
+// URL streams trigger it as soon as something is queued behind them; a
+// duration-limited item within AUDIO_PREFETCH_LEAD_MS of its limit, or a
+// file within AUDIO_PREFETCH_LEAD_BYTES of EOF, triggers it too.
+#ifndef AUDIO_PREFETCH_ENABLED
+#define AUDIO_PREFETCH_ENABLED 1
+#endif
 
-// ============================================================================
-// QUEUED AUDIO ITEM
-// ============================================================================
+#ifndef AUDIO_PREFETCH_LEAD_MS
+#define AUDIO_PREFETCH_LEAD_MS 1000
+#endif
 
-/**
- * @brief Represents a queued audio item with all playback parameters
- */
-struct QueuedAudioItem {
-    AudioStreamType type;
-    char audioKey[64];
-    unsigned long durationMs;
-    
-    QueuedAudioItem() : type(AudioStreamType::NONE), durationMs(0) {
-        audioKey[0] = '\0';
-    }
-    
-    QueuedAudioItem(AudioStreamType t, const char* key, unsigned long duration)
-        : type(t), durationMs(duration) {
-        if (key) {
-            strncpy(audioKey, key, sizeof(audioKey) - 1);
-            audioKey[sizeof(audioKey) - 1] = '\0';
-        } else {
-            audioKey[0] = '\0';
-        }
-    }
-};
+#ifndef AUDIO_PREFETCH_LEAD_BYTES
+#define AUDIO_PREFETCH_LEAD_BYTES 32768
+#endif
+
+// Fast start: the first AUDIO_FAST_START_MS of AUDIO_FAST_START_KEY are
+// rendered at begin() and written straight to the output on off-hook, so
+// the tone is in the DMA ring before the generator pipeline is set up. The
+// generator then skips what was written and carries on sample-exact.
+#ifndef AUDIO_FAST_START_ENABLED
+#define AUDIO_FAST_START_ENABLED 1
+#endif
+
+#ifndef AUDIO_FAST_START_KEY
+#define AUDIO_FAST_START_KEY "dialtone"
+#endif
+
+#ifndef AUDIO_FAST_START_MS
+#define AUDIO_FAST_START_MS 30
+#endif
+
+// Maximum time (ms) a playing stream may go without any PCM reaching the
+// codec before we declare a stall. File/URL streams may briefly stall during
+// seeks or network hiccups, but >3 s of no output means the source is dead
+// or the decoder is stuck (e.g. it consumes input it can't decode).
+static constexpr unsigned long COPY_STALL_TIMEOUT_MS = 3000;
 
 // ============================================================================
 // AUDIO EVENT CALLBACK
@@ -85,6 +109,18 @@ struct QueuedAudioItem {
  */
 typedef void (*AudioEventCallback)(bool isPlaying);
 
+/**
+ * @brief Callback for a file key that could not be played from SD or streamed
+ * @param audioKey The key that failed
+ */
+typedef void (*AudioMissingFileCallback)(const char* audioKey);
+
+/**
+ * @brief Callback for a file key that started playing from its local file
+ * @param audioKey The key playing
+ */
+typedef void (*AudioFilePlayedCallback)(const char* audioKey);
+
 // ============================================================================
 // EXTENDED AUDIO SOURCE
 // ============================================================================
@@ -140,6 +176,12 @@ public:
     bool setGeneratorStream(const char* generatorName);
     bool setFileStream(const char* filePath);
     
+    /// Discard @p bytes of the next generator after begin() (already played by fast start)
+    void skipNextGeneratorBytes(size_t bytes) { generatorSkipBytes = bytes; }
+    
+    /// Write the next URL stream through to @p localPath on SD (one-shot, nullptr clears)
+    void setStreamCachePath(const char* localPath);
+    
     AudioStreamType getCurrentStreamType() const { return currentType; }
     const char* getCurrentKey() const { return currentKey; }
     
@@ -152,6 +194,43 @@ public:
     // Check if a generator is registered
     bool hasGenerator(const char* name) const;
     
+    // ========================================================================
+    // LOOK-AHEAD
+    // ========================================================================
+    
+    /**
+     * @brief Open and sniff a file ahead of time
+     * 
+     * A later selectStream() for the same path takes over the open handle
+     * instead of re-opening it. Replaces any earlier prefetch.
+     * 
+     * @param filePath SD path of the next item
+     * @return true if the file is open and staged
+     */
+    bool prefetchFile(const char* filePath);
+    
+    /// Close a staged file that was never played
+    void cancelPrefetch();
+    
+    /// Path of the staged file ("" if none)
+    const char* getPrefetchedPath() const { return prefetchPath; }
+    
+    /// Bytes left in the current file stream (-1 if not a file stream)
+    long remainingFileBytes();
+    
+#if AUDIO_PCM_CACHE_ENABLED
+    /// Cache entry being played in place of the current file (nullptr if decoding)
+    const PcmCacheEntry* getCachedPcm() const { return cachedPcm; }
+#endif
+    
+#if AUDIO_URL_JITTER_ENABLED
+    const UrlJitterStream& getUrlJitter() const { return urlJitter; }
+#endif
+    
+#if AUDIO_FILE_READAHEAD_ENABLED
+    const FileReadaheadStream& getFileReadahead() const { return fileReadahead; }
+#endif
+    
 protected:
     // Registry reference
     AudioKeyRegistry* registry = nullptr;
@@ -164,20 +243,47 @@ protected:
     
     // Generator stream wrapper
     GeneratedSoundStream<int16_t> generatorStream;
+    size_t generatorSkipBytes = 0;  // One-shot, see skipNextGeneratorBytes()
     
     // URL streaming
     URLStream* urlStream = nullptr;
     int urlBufferSize = 2048;
+    char streamCachePath[128] = {0};  // One-shot, see setStreamCachePath()
+#if AUDIO_URL_JITTER_ENABLED
+    UrlJitterStream urlJitter;  // What the decoder reads while a URL plays
+#endif
     
     // File streaming (uses SD card)
     File currentFile;
     char detectedFileMime[32] = {0};  // Actual MIME from file magic bytes (may differ from extension)
+#if AUDIO_FILE_READAHEAD_ENABLED
+    FileReadaheadStream fileReadahead;  // What the decoder reads; owns currentFile's handle once open
+#endif
+    
+    // Look-ahead file staged by prefetchFile()
+    File prefetchedFile;
+    char prefetchPath[64] = {0};
+    char prefetchMime[32] = {0};
+    
+#if AUDIO_PCM_CACHE_ENABLED
+    // Decoded PCM served instead of the current file (see audio_pcm_cache.h)
+    MemoryStream cacheStream;
+    const PcmCacheEntry* cachedPcm = nullptr;
+    
+    // Serve the open file from the PCM cache, or start capturing its decode
+    bool useCachedPcm(const char* filePath);
+    // Keep or drop the capture for the file being closed
+    void finishPcmCapture();
+#endif
     
     // Helper to close current stream
     void closeCurrentStream();
     
     // Detect actual audio format from first bytes of an open file
     static const char* detectMimeFromFileContent(File& file);
+    
+    // Open a file and sniff its format into mimeOut (empty if unknown)
+    static bool openAudioFile(const char* filePath, File& file, char* mimeOut, size_t mimeSize);
 };
 
 // ============================================================================
@@ -251,6 +357,34 @@ public:
      */
     bool playAudioKey(const char* audioKey, unsigned long durationMs = 0);
     
+    /**
+     * @brief playAudioKey() with the pre-rendered fast start when available
+     * 
+     * For AUDIO_FAST_START_KEY while idle, the pre-rendered opening is
+     * written to the output first and the generator continues from where it
+     * ends. Anything else is a plain playAudioKey().
+     */
+    bool playAudioKeyFast(const char* audioKey);
+    
+    // ========================================================================
+    // OVERLAYS
+    // ========================================================================
+    
+    /**
+     * @brief Mix @p audioKey on top of whatever is playing, without stopping it
+     * 
+     * Generators play directly (except the one the main stream is using).
+     * File keys overlay only once their decoded PCM is in the PCM cache.
+     * The queue and the main stream are untouched.
+     * 
+     * @param volume     Overlay gain relative to the master volume (0.0–1.0)
+     * @param durationMs 0 = to the end of the clip, or until stopped for a generator
+     * @return true if the overlay started
+     */
+    bool playOverlay(const char* audioKey, float volume = 1.0f, unsigned long durationMs = 0);
+    void stopOverlay(const char* audioKey);
+    bool isOverlayActive() const { return mixer.isActive(); }
+    
     /**
      * @brief Play audio by file path or URL, clearing queue
      * @param path File path or URL to play
@@ -330,6 +464,26 @@ public:
      */
     size_t getLastCopyBytes() const { return lastCopyBytes; }
     
+    /**
+     * @brief Per-stream copy() throughput, timing and adaptive chunk size
+     */
+    const AudioCopyMeter& getCopyMeter() const { return copyMeter; }
+    void resetCopyStats() { copyMeter.requestReset(); }
+    
+#if AUDIO_URL_JITTER_ENABLED
+    /**
+     * @brief Print the URL jitter buffer level and write-through counters
+     */
+    void printUrlStreamStatus() const;
+#endif
+    
+#if AUDIO_FILE_READAHEAD_ENABLED
+    /**
+     * @brief Print the file read-ahead level, SD read timing and underruns
+     */
+    void printFileStreamStatus() const;
+#endif
+    
     /**
      * @brief Set active state (false clears queue)
      */
@@ -382,8 +536,20 @@ public:
     
     /**
      * @brief Set volume (0.0 to 1.0, persisted to storage)
+     *
+     * Applied as a Q15 gain in the mixer's output pass, or by the codec
+     * when AUDIO_HW_VOLUME and a hardware setter accepts it.
      */
     void setVolume(float volume);
+
+    /**
+     * @brief Codec volume setter (0.0 to 1.0) used with AUDIO_HW_VOLUME
+     *
+     *   audioPlayer.setHardwareVolume([](float v) { return kit.setVolume(v); });
+     *
+     * False from @p apply falls back to the software gain.
+     */
+    void setHardwareVolume(bool (*apply)(float));
     
     /**
      * @brief Get current volume
@@ -399,6 +565,18 @@ public:
      */
     void setAudioEventCallback(AudioEventCallback callback) { eventCallback = callback; }
     
+    /**
+     * @brief Set callback for file keys whose local file is missing
+     *        (and that streaming couldn't play) — e.g. to fetch it now
+     */
+    void setMissingFileCallback(AudioMissingFileCallback callback) { missingFileCallback = callback; }
+    
+    /**
+     * @brief Set callback for file keys that start playing from SD
+     *        — e.g. to keep them recent in the cache's LRU order
+     */
+    void setFilePlayedCallback(AudioFilePlayedCallback callback) { filePlayedCallback = callback; }
+    
     // ========================================================================
     // REGISTRY
     // ========================================================================
@@ -463,7 +641,12 @@ protected:
     CopyDecoder pcmDecoder{true};  // Passthrough for raw PCM (generators)
     char firstDecoderMime[32] = {0};  // MIME of first decoder for MultiDecoder conversion
     AudioStream* output = nullptr;
-    VolumeStream volumeStream;
+    AudioOverlayMixer mixer;  // Master volume and overlays, one pass per block
+    AudioCopyMeter copyMeter;  // Times copy(); its stage sits after the mixer
+    RingTapStream referenceTap{getLoopbackReferenceRing()};  // Loopback reference for Goertzel
+#if AUDIO_PCM_CACHE_ENABLED
+    PcmCaptureStream pcmCaptureTap;  // Decoder output → PCM cache, ahead of the volume
+#endif
     
     // Registry for key resolution
     AudioKeyRegistry* registry = nullptr;
@@ -478,6 +661,8 @@ protected:
     bool streamingEnabled = false;  // True if streaming fallback is enabled
     bool isPlaying = false;
     float currentVolume = 0.5f;
+    bool (*hardwareVolume)(float) = nullptr;
+    bool hardwareVolumeActive = false;  // The codec holds currentVolume; the mixer's gain is unity
     
     // Current playback state
     AudioStreamType currentType = AudioStreamType::NONE;
@@ -487,18 +672,37 @@ protected:
     unsigned long playbackEndTime = 0;   // Set when playback naturally ends (not on stop())
     size_t lastCopyBytes = 0;
     
-    // Stall detection: force-stop if copy() produces 0 useful bytes too long
-    unsigned long lastNonZeroCopyTime = 0;  // millis() of last copy() that returned >0
-    int zeroCopyCount = 0;                  // Consecutive copy() calls returning 0
+    // Look-ahead for the queue front (see AUDIO_PREFETCH_ENABLED)
+    bool prefetchAttempted = false;  // Reset whenever the current item or queue changes
+    
+#if AUDIO_FAST_START_ENABLED
+    // Opening of AUDIO_FAST_START_KEY, rendered at begin() (internal RAM)
+    // and again whenever the registry's generator for it changes
+    int16_t* fastStartBuffer = nullptr;
+    size_t fastStartBytes = 0;
+    SoundGenerator<int16_t>* fastStartGenerator = nullptr;  // Rendered from
+    uint32_t fastStartHash = 0;                             // Its entry's contentHash
+    void prepareFastStart();
+    bool fastStartStale() const;
+#endif
+    
+    // Stall detection: force-stop if no PCM reaches the codec for COPY_STALL_TIMEOUT_MS
+    unsigned long lastPcmOutTime = 0;  // millis() when PCM out last advanced (0 = not playing)
+    uint32_t lastPcmOutBytes = 0;      // copyMeter.pcmOutTotal() at that time
     
     // Audio queue
-    std::vector<QueuedAudioItem> audioQueue;
+    AudioQueue audioQueue;
     
     // Event callback
     AudioEventCallback eventCallback = nullptr;
+    AudioMissingFileCallback missingFileCallback = nullptr;
+    AudioFilePlayedCallback filePlayedCallback = nullptr;
     
     // Helper methods
     bool startStream(AudioStreamType type, const char* audioKey, unsigned long durationMs);
+    bool resolveFileKey(const char* audioKey, const char*& localPath, const char*& streamingPath) const;
+    bool shouldPrefetch();
+    void prefetchNext();
     void stopInternal();
     void onStreamEnd();
     AudioStreamType detectStreamType(const char* audioKey) const;
@@ -507,6 +711,8 @@ protected:
     // Volume persistence
     void loadVolumeFromStorage();
     void saveVolumeToStorage();
+    /// Push currentVolume to the codec or the mixer
+    void applyVolume();
     
     // Static callback for EOF handling
     static void onEOFCallback(AudioPlayer& player);
@@ -10,6 +10,7 @@
 #define FILE_UTILS_H
 
 #include <Arduino.h>
+#include <FS.h>
 
 // ============================================================================
 // CONSTANTS
@@ -23,6 +24,10 @@
 #define AUDIO_FILES_DIR "/audio"    ///< Default directory for audio files
 #endif
 
+#ifndef AUDIO_CACHE_SHARDS
+#define AUDIO_CACHE_SHARDS 16       ///< Subdirectories files are spread over (power of two, 0 = flat)
+#endif
+
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
@@ -52,7 +57,9 @@ bool urlToBaseFilename(const char* url, char* filename, const char* ext = nullpt
  * @brief Get local file path for a URL (uses base filename for lookups)
  * 
  * Converts a URL to a local filesystem path by generating a filename and
- * prepending the base directory.
+ * prepending the base directory and a shard subdirectory ("/audio/0c/x.mp3").
+ * The shard is a hash of the filename without its extension, so a file
+ * re-saved under a corrected extension stays in the same directory.
  * 
  * @param url Original URL
  * @param localPath Output buffer for local path (should be at least 128 bytes)
@@ -63,6 +70,14 @@ bool urlToBaseFilename(const char* url, char* filename, const char* ext = nullpt
 bool getLocalPathForUrl(const char* url, char* localPath, const char* ext = nullptr, 
                         const char* baseDir = AUDIO_FILES_DIR);
 
+/**
+ * @brief Path a URL's file had before files were sharded ("/audio/x.mp3")
+ *
+ * Only for moving files cached by older firmware into their shard.
+ */
+bool getUnshardedPathForUrl(const char* url, char* localPath, const char* ext = nullptr,
+                            const char* baseDir = AUDIO_FILES_DIR);
+
 /**
  * @brief Convert path to local path representation
  * 
@@ -78,4 +93,17 @@ bool getLocalPathForUrl(const char* url, char* localPath, const char* ext = null
 const char* asLocalPath(const char* path, const char* ext = nullptr,
                         const char* baseDir = AUDIO_FILES_DIR);
 
+/**
+ * @brief Allocate a freshly created file's clusters up front
+ *
+ * Extends @p file to @p size bytes in one step so the FAT driver allocates
+ * its whole cluster chain at once — contiguous wherever the card's free
+ * space allows — instead of a cluster at a time between other writes.
+ * The file is left positioned at 0, ready to be written sequentially; it
+ * reads as @p size bytes long whatever has been written.
+ *
+ * @return true if the space was allocated
+ */
+bool preallocateFile(fs::File& file, size_t size);
+
 #endif // FILE_UTILS_H
@@ -0,0 +1,43 @@
+/**
+ * @file http_dns.h
+ * @brief Host name cache for HttpClient connections
+ *
+ * New connections resolve their host here instead of inside the TLS/TCP
+ * client. An address is reused for HTTP_DNS_TTL_MS, then looked up again;
+ * if that lookup fails the old address is kept, since public DNS is often
+ * unreachable once the WireGuard tunnel is up. Safe from any task.
+ *
+ * @date 2026
+ */
+
+#ifndef HTTP_DNS_H
+#define HTTP_DNS_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+class HttpDns {
+public:
+    /**
+     * @brief Address for @p host (an IP literal is parsed, not cached)
+     * @return false if it was never resolved and can't be now
+     */
+    static bool resolve(const char* host, IPAddress& ip);
+
+    /// Drop @p host, e.g. after its cached address refused a connection
+    static void forget(const char* host);
+
+    /// Resolve the host of @p url now, e.g. while public DNS still works
+    static bool prefetch(const char* url);
+
+    /**
+     * @brief Host and port of "scheme://host[:port]/..." (port from the
+     *        scheme when absent)
+     * @return false if @p url has no host or it doesn't fit in @p cap
+     */
+    static bool urlHost(const char* url, char* host, size_t cap, uint16_t& port);
+
+    static void printStatus();
+};
+
+#endif // HTTP_DNS_H
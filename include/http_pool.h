@@ -0,0 +1,96 @@
+/**
+ * @file http_pool.h
+ * @brief Keep-alive HttpClient connections shared by every subsystem
+ *
+ * WebQueue slots, the remote logger, the update check and the audio cache
+ * check all lease their HttpClient from here. A released client keeps its
+ * TCP/TLS connection open for HTTP_POOL_IDLE_MS, so the next request to
+ * that scheme://host:port — from whichever subsystem — skips DNS, connect
+ * and the TLS handshake. New connections resolve through HttpDns.
+ *
+ * Pooled clients have their own TLS context (useOwnSecure) and keep-alive
+ * on, so they can be used from any task. A lease is one caller's at a
+ * time; the pool itself is guarded by a mutex.
+ *
+ * @date 2026
+ */
+
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include "http_utils.h"
+#include <freertos/semphr.h>
+
+class HttpPool {
+public:
+    /**
+     * @brief Lease a client for @p url: one connected to its origin if idle,
+     *        else a new one, else the least recently used idle one
+     * @return nullptr if all HTTP_POOL_SIZE clients are leased
+     */
+    HttpClient* acquire(const char* url, int timeoutMs = HTTP_TIMEOUT_MS);
+
+    /// Give a lease back; the connection is kept if it can carry another request
+    void release(HttpClient* http, bool keepConnection = true);
+
+    /// True if an idle client holds a connection to @p url's origin
+    bool hasIdle(const char* url);
+
+    /// Free clients idle longer than HTTP_POOL_IDLE_MS (connection and TLS state)
+    void closeIdle();
+
+    void printStatus();
+
+private:
+    struct Entry {
+        HttpClient*   http      = nullptr;
+        bool          leased    = false;
+        unsigned long idleSince = 0;
+    };
+    Entry             _entries[HTTP_POOL_SIZE];
+    SemaphoreHandle_t _lock = nullptr;
+    uint32_t          _reused = 0;  // Leases that got a warm connection
+    uint32_t          _leases = 0;
+
+    bool lock();
+    void unlock() { xSemaphoreGive(_lock); }
+    void closeIdleLocked(unsigned long now);
+};
+
+extern HttpPool httpPool;
+
+/**
+ * @brief Scoped lease: released (connection kept if reusable) on destruction
+ *
+ * Falls back to a private client when the pool is exhausted, so callers
+ * never have to handle a missing client.
+ *
+ *   HttpLease http(url, HTTP_TIMEOUT_SHORT_MS);
+ *   if (http->get(url)) { String body = http->getString(); }
+ */
+class HttpLease {
+public:
+    HttpLease(const char* url, int timeoutMs = HTTP_TIMEOUT_MS)
+        : _http(httpPool.acquire(url, timeoutMs)), _pooled(_http != nullptr) {
+        if (!_http) {
+            _http = new HttpClient(timeoutMs);
+            _http->useOwnSecure();
+        }
+    }
+    ~HttpLease() {
+        if (_pooled) httpPool.release(_http, true);
+        else delete _http;
+    }
+
+    HttpClient* operator->() { return _http; }
+    HttpClient& operator*() { return *_http; }
+
+private:
+    HttpLease(const HttpLease&);
+    HttpLease& operator=(const HttpLease&);
+
+    HttpClient* _http;
+    bool        _pooled;
+};
+
+#endif // HTTP_POOL_H
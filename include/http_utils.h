@@ -5,6 +5,7 @@
 #include <SD_MMC.h>
 #include <Update.h>
 #include "config.h"
+#include "http_dns.h"
 #include "logging.h"
 #include "mbedtls/platform.h"
 #include "esp_heap_caps.h"
@@ -18,6 +19,10 @@
 #define USER_AGENT_HEADER "BowiePhone/" FIRMWARE_VERSION
 #endif
 
+#ifndef HTTP_MAX_REDIRECTS
+#define HTTP_MAX_REDIRECTS 5   // Redirects followed in keep-alive mode
+#endif
+
 // Helper macros for SD vs SD_MMC abstraction
 #if SD_USE_MMC
   #define HTTP_SD_OPEN(path, mode) SD_MMC.open(path, mode)
@@ -43,6 +48,21 @@
 //   if (http.post(url, json)) { ... }       // uses persistent Content-Type
 //
 //   int bytes = http.getFile(url, "/audio/song.mp3");
+//
+//   HttpValidators v;                       // kept from the last fetch
+//   if (http.getIfChanged(url, v)) { ... }  // v now holds the new ETag etc.
+//   else if (http.notModified()) { ... }    // 304: what we have is current
+
+// ETag / Last-Modified of a fetched resource, sent back as If-None-Match /
+// If-Modified-Since so an unchanged resource costs a 304 and no body
+struct HttpValidators {
+    char etag[80];
+    char lastModified[40];
+
+    HttpValidators() { clear(); }
+    void clear() { etag[0] = lastModified[0] = '\0'; }
+    bool empty() const { return !etag[0] && !lastModified[0]; }
+};
 
 class HttpClient {
 public:
@@ -56,6 +76,7 @@ public:
     explicit HttpClient(int timeoutMs = HTTP_TIMEOUT_MS, const Header* headers = nullptr, size_t headerCount = 0)
         : _statusCode(0), _timeoutMs(timeoutMs), _headerCount(0) {
         _http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+        collectHeaders(nullptr, 0);
         if (headers) {
             for (size_t i = 0; i < headerCount && i < MAX_HEADERS; i++) {
                 setPersistentHeader(headers[i].name, headers[i].value);
@@ -85,6 +106,12 @@ public:
         setPersistentHeader(name, value.c_str());
     }
 
+    // Forget all persistent headers (a pooled instance changing hands)
+    void clearPersistentHeaders() {
+        for (int i = 0; i < _headerCount; i++) _headers[i] = StoredHeader();
+        _headerCount = 0;
+    }
+
     // Change the request timeout
     void setTimeout(int ms) { _timeoutMs = ms; }
 
@@ -105,10 +132,34 @@ public:
         }
     }
 
+    // Keep the TCP/TLS connection open between requests so the next request
+    // to the same scheme://host:port skips DNS, connect and the handshake.
+    // Redirects are then followed here rather than inside HTTPClient, so the
+    // instance always knows which host its open connection belongs to.
+    // Call before collectHeaders().
+    void setKeepAlive(bool on) {
+        _keepAlive = on;
+        _http.setReuse(on);
+        _http.setFollowRedirects(on ? HTTPC_DISABLE_FOLLOW_REDIRECTS : HTTPC_FORCE_FOLLOW_REDIRECTS);
+        collectHeaders(nullptr, 0);
+    }
+
     // Register response headers you want to read after the request.
-    // Persists across requests on the same instance.
+    // Persists across requests on the same instance.  ETag and
+    // Last-Modified are always collected (readValidators()).
     void collectHeaders(const char* headerKeys[], size_t count) {
-        _http.collectHeaders(headerKeys, count);
+        const char* keys[MAX_COLLECTED + 3];
+        size_t n = 0;
+        bool etag = false, lastModified = false;
+        for (size_t i = 0; i < count && n < MAX_COLLECTED; i++) {
+            keys[n++] = headerKeys[i];
+            etag         |= strcasecmp(headerKeys[i], "ETag") == 0;
+            lastModified |= strcasecmp(headerKeys[i], "Last-Modified") == 0;
+        }
+        if (!etag)         keys[n++] = "ETag";
+        if (!lastModified) keys[n++] = "Last-Modified";
+        if (_keepAlive)    keys[n++] = "Location";
+        _http.collectHeaders(keys, n);
     }
 
     // Read a collected response header (call after get/post)
@@ -123,6 +174,34 @@ public:
         return request(url, "GET", nullptr, headers, count);
     }
 
+    // Conditional GET with the validators of the copy we hold (none → plain
+    // GET).  On 2xx they are replaced by the response's; on 304 it returns
+    // false with notModified() set and leaves them alone.
+    bool getIfChanged(const char* url, HttpValidators& v) {
+        Header hdrs[2];
+        if (!get(url, hdrs, conditionalHeaders(v, hdrs))) return false;
+        readValidators(v);
+        return true;
+    }
+
+    // If-None-Match / If-Modified-Since for v into out[2]; returns the count
+    static size_t conditionalHeaders(const HttpValidators& v, Header* out) {
+        size_t n = 0;
+        if (v.etag[0])         out[n++] = {"If-None-Match", v.etag};
+        if (v.lastModified[0]) out[n++] = {"If-Modified-Since", v.lastModified};
+        return n;
+    }
+
+    // Validators of the last response (cleared if it sent none)
+    void readValidators(HttpValidators& v) {
+        String etag = _http.header("ETag");
+        String lastModified = _http.header("Last-Modified");
+        v.clear();
+        if (etag.length() < sizeof(v.etag)) strcpy(v.etag, etag.c_str());
+        if (lastModified.length() < sizeof(v.lastModified))
+            strcpy(v.lastModified, lastModified.c_str());
+    }
+
     // HTTP POST — returns true on 2xx.
     // If contentType is non-null it overrides the persistent Content-Type for
     // this request only.  Pass nullptr to use the persistent value.
@@ -148,10 +227,13 @@ public:
     int statusCode() const { return _statusCode; }
     const String& statusMessage() const { return _statusMsg; }
     bool ok() const { return _statusCode >= 200 && _statusCode < 300; }
+    bool notModified() const { return _statusCode == 304; }
 
     // Read the full response body as a String.  Calls end() internally.
     String getString() {
+        int size = _http.getSize();
         String s = _http.getString();
+        if (size >= 0 && (int)s.length() == size) _bodyRemaining = 0;  // reusable
         end();
         return s;
     }
@@ -169,8 +251,35 @@ public:
     bool connected() { return _http.connected(); }
 
     // Finish the request and release the TCP connection
+    // (keep-alive mode: the connection stays open if the server allows it)
     void end() { _http.end(); }
 
+    // Drop the connection, even in keep-alive mode
+    void close() {
+        _http.setReuse(false);
+        _http.end();
+        _http.setReuse(_keepAlive);
+        _origin = String();
+    }
+
+    // Keep-alive mode: the body was read to its Content-Length, so the
+    // connection is positioned for another request (call before end())
+    bool reusable() { return _keepAlive && _bodyRemaining == 0 && _http.connected(); }
+
+    // Keep-alive mode: true if the open connection is to url's origin
+    bool connectedTo(const char* url) {
+        return _origin.length() > 0 && _http.connected() && urlOrigin(url) == _origin;
+    }
+
+    // "scheme://host[:port]" part of a URL (empty if it has no scheme)
+    static String urlOrigin(const char* url) {
+        const char* host = url ? strstr(url, "://") : nullptr;
+        if (!host) return String();
+        const char* end = host + 3;
+        while (*end && *end != '/' && *end != '?' && *end != '#') end++;
+        return String(url).substring(0, end - url);
+    }
+
     // Stream the response body through a callback after a successful get/post.
     // Callback: bool cb(const uint8_t* buf, size_t len) — return false to stop.
     // Calls end() when done.  Returns total bytes passed to the callback.
@@ -316,126 +425,8 @@ public:
     // Access the underlying HTTPClient for edge cases (e.g. errorToString)
     HTTPClient& raw() { return _http; }
 
-    // -- async downloads ---------------------------------------------------
-    // Each method spawns a self-deleting FreeRTOS task.  The task creates its
-    // own WiFiClientSecure (via useOwnSecure) so it never touches the shared
-    // singleton.  SD access inside the callback is NOT automatically
-    // serialised — hold any SD mutex before queuing a write from the callback.
-
-    using AsyncFileCallback   = void(*)(int bytesWritten, void* userData);
-    using AsyncStringCallback = void(*)(bool success, const String& body, void* userData);
-    using AsyncPostCallback   = void(*)(bool success, int statusCode, void* userData);
-
-    // Async file download: saves response body to sdPath, calls cb when done.
-    static TaskHandle_t getFileAsync(
-            const char* url, const char* sdPath,
-            AsyncFileCallback cb = nullptr, void* userData = nullptr,
-            int timeoutMs = HTTP_TIMEOUT_DOWNLOAD_MS,
-            UBaseType_t priority = 1, BaseType_t core = 0)
-    {
-        struct State {
-            char url[300]; char sdPath[128];
-            int timeoutMs;
-            AsyncFileCallback cb; void* userData;
-        };
-        auto* s = new State();
-        strncpy(s->url,    url,    sizeof(s->url)    - 1); s->url[sizeof(s->url)-1]       = '\0';
-        strncpy(s->sdPath, sdPath, sizeof(s->sdPath) - 1); s->sdPath[sizeof(s->sdPath)-1] = '\0';
-        s->timeoutMs = timeoutMs; s->cb = cb; s->userData = userData;
-
-        TaskHandle_t handle = nullptr;
-        xTaskCreatePinnedToCore([](void* p) {
-            auto* s = static_cast<State*>(p);
-            HttpClient http(s->timeoutMs);
-            http.useOwnSecure();
-            int result = http.getFile(s->url, s->sdPath, s->timeoutMs);
-            if (s->cb) s->cb(result, s->userData);
-            delete s;
-            vTaskDelete(nullptr);
-        }, "HttpDL", 12288, s, priority, &handle, core);
-        return handle;
-    }
-
-    // Async GET: fetches response body as a String, calls cb when done.
-    static TaskHandle_t getStringAsync(
-            const char* url,
-            AsyncStringCallback cb, void* userData = nullptr,
-            int timeoutMs = HTTP_TIMEOUT_CATALOG_MS,
-            UBaseType_t priority = 1, BaseType_t core = 0)
-    {
-        struct State {
-            char url[300]; int timeoutMs;
-            AsyncStringCallback cb; void* userData;
-        };
-        auto* s = new State();
-        strncpy(s->url, url, sizeof(s->url) - 1); s->url[sizeof(s->url)-1] = '\0';
-        s->timeoutMs = timeoutMs; s->cb = cb; s->userData = userData;
-
-        TaskHandle_t handle = nullptr;
-        xTaskCreatePinnedToCore([](void* p) {
-            auto* s = static_cast<State*>(p);
-            HttpClient http(s->timeoutMs);
-            http.useOwnSecure();
-            bool ok = http.get(s->url);
-            String body = ok ? http.getString() : String();
-            if (s->cb) s->cb(ok, body, s->userData);
-            delete s;
-            vTaskDelete(nullptr);
-        }, "HttpGet", 16384, s, priority, &handle, core);
-        return handle;
-    }
-
-    // Async POST: sends body to url, calls cb with (success, statusCode).
-    // Spawns a self-deleting FreeRTOS task on the specified core.
-    // The body String is moved into the task state to avoid dangling refs.
-    // For HTTP targets only — HTTPS would need useOwnSecure() + more stack.
-    static TaskHandle_t postAsync(
-            const char* url, String body,
-            AsyncPostCallback cb = nullptr, void* userData = nullptr,
-            const char* contentType = "application/json",
-            const char* extraHeaderName = nullptr,
-            const char* extraHeaderValue = nullptr,
-            int timeoutMs = HTTP_TIMEOUT_SHORT_MS,
-            UBaseType_t priority = 0, BaseType_t core = 0)
-    {
-        struct State {
-            char url[256]; char contentType[48];
-            char extraName[32]; char extraValue[64];
-            String body;
-            int timeoutMs;
-            AsyncPostCallback cb; void* userData;
-        };
-        auto* s = new State();
-        strncpy(s->url, url, sizeof(s->url) - 1); s->url[sizeof(s->url)-1] = '\0';
-        strncpy(s->contentType, contentType ? contentType : "application/json",
-                sizeof(s->contentType) - 1); s->contentType[sizeof(s->contentType)-1] = '\0';
-        s->extraName[0] = '\0'; s->extraValue[0] = '\0';
-        if (extraHeaderName) {
-            strncpy(s->extraName, extraHeaderName, sizeof(s->extraName) - 1);
-            s->extraName[sizeof(s->extraName)-1] = '\0';
-        }
-        if (extraHeaderValue) {
-            strncpy(s->extraValue, extraHeaderValue, sizeof(s->extraValue) - 1);
-            s->extraValue[sizeof(s->extraValue)-1] = '\0';
-        }
-        s->body = std::move(body);
-        s->timeoutMs = timeoutMs; s->cb = cb; s->userData = userData;
-
-        TaskHandle_t handle = nullptr;
-        xTaskCreatePinnedToCore([](void* p) {
-            auto* s = static_cast<State*>(p);
-            HttpClient http(s->timeoutMs);
-            if (s->extraName[0])
-                http.setPersistentHeader(s->extraName, s->extraValue);
-            bool ok = http.post(s->url, s->body, s->contentType);
-            int code = http.statusCode();
-            s->body = String();  // free before callback
-            if (s->cb) s->cb(ok, code, s->userData);
-            delete s;
-            vTaskDelete(nullptr);
-        }, "HttpPost", 8192, s, priority, &handle, core);
-        return handle;
-    }
+    // Background requests (one persistent task, callbacks on core 1) are in
+    // net_worker.h
 
     // =========================================================================
     // Cooperative (tickable) requests — run on core 1, caller calls tick()
@@ -558,6 +549,7 @@ public:
     }
 
 private:
+    WiFiClient _plain;  // transport for http:// URLs (declared first: _http stops it on destruction)
     HTTPClient _http;
     int _statusCode;
     int _timeoutMs;
@@ -566,6 +558,10 @@ private:
 
     WiFiClientSecure* _ownSecure = nullptr;  // non-null when running off the main task
 
+    bool _keepAlive = false;
+    String _origin;                          // keep-alive: origin of the open connection
+    static constexpr size_t MAX_COLLECTED = 7;
+
     // -- persistent headers --------------------------------------------------
     static constexpr int MAX_HEADERS = 8;
     struct StoredHeader {
@@ -588,7 +584,7 @@ private:
         }
     }
 
-    // Begin a URL (HTTPS via shared WiFiClientSecure, HTTP via plain begin)
+    // Begin a URL (HTTPS via own or shared WiFiClientSecure, HTTP via _plain)
     bool beginUrl(const char* url) {
         _http.setTimeout(_timeoutMs);
         if (strncmp(url, "https", 5) == 0) {
@@ -598,9 +594,42 @@ private:
                 Logger.printf("⚠️ HTTPS low heap: free=%u max_block=%u\n",
                               (unsigned)freeHeap, (unsigned)maxBlock);
             }
-            return _http.begin(_ownSecure ? *_ownSecure : sharedSecure(), url);
+            if (!_ownSecure) return _http.begin(sharedSecure(), url);
+            connectCached(*_ownSecure, url, true);
+            return _http.begin(*_ownSecure, url);
+        }
+        connectCached(_plain, url, false);
+        return _http.begin(_plain, url);
+    }
+
+    // Open a new connection to the HttpDns address of url's host, so repeat
+    // connections skip the lookup. HTTPClient reuses a connected transport;
+    // on failure it's left closed and HTTPClient connects by name itself.
+    void connectCached(WiFiClient& client, const char* url, bool tls) {
+        if (client.connected()) return;
+        char name[64];
+        uint16_t port;
+        IPAddress ip;
+        if (!HttpDns::urlHost(url, name, sizeof(name), port) || !HttpDns::resolve(name, ip))
+            return;
+        bool ok = tls
+            // Host name still goes along for SNI
+            ? static_cast<WiFiClientSecure&>(client).connect(ip, port, name, nullptr, nullptr, nullptr)
+            : client.connect(ip, port, _timeoutMs);
+        if (!ok) {
+            client.stop();
+            HttpDns::forget(name);  // Maybe moved; the by-name connect looks again
         }
-        return _http.begin(url);
+    }
+
+    // Release a failed request; a kept-alive connection may hold an unread body
+    void endFailed() {
+        if (_keepAlive) close();
+        else end();
+    }
+
+    static bool isRedirect(int code) {
+        return code == 301 || code == 302 || code == 303 || code == 307 || code == 308;
     }
 
     // Core request implementation
@@ -608,27 +637,61 @@ private:
                  const char* body = nullptr,
                  const Header* headers = nullptr,
                  size_t headerCount = 0) {
-        if (!beginUrl(url)) {
-            setStatus(-1, "❌ HTTP begin failed for %s", url);
-            return false;
-        }
-        applyHeaders(headers, headerCount);
+        String redirect;   // Location being followed (keep-alive mode)
+        _bodyRemaining = -1;
+        for (int hop = 0; ; hop++) {
+            if (_keepAlive) {
+                String origin = urlOrigin(url);
+                if (origin != _origin) {
+                    close();           // Open connection is to another host
+                    _origin = origin;
+                }
+            }
+            if (!beginUrl(url)) {
+                setStatus(-1, "❌ HTTP begin failed for %s", url);
+                endFailed();
+                return false;
+            }
+            applyHeaders(headers, headerCount);
+
+            if (body) {
+                _statusCode = _http.sendRequest(method, body);
+            } else {
+                _statusCode = _http.sendRequest(method);
+            }
 
-        if (body) {
-            _statusCode = _http.sendRequest(method, body);
-        } else {
-            _statusCode = _http.sendRequest(method);
+            if (!_keepAlive || !isRedirect(_statusCode)) break;
+            String location = _http.header("Location");
+            if (location.startsWith("/")) location = _origin + location;
+            if (hop >= HTTP_MAX_REDIRECTS || urlOrigin(location.c_str()).length() == 0) {
+                setStatus(_statusCode, "❌ HTTP %d: cannot follow redirect for %s", _statusCode, url);
+                endFailed();
+                return false;
+            }
+            close();           // Redirect body is not read
+            redirect = location;
+            url = redirect.c_str();
+            if (_statusCode == 303) {
+                method = "GET";
+                body = nullptr;
+            }
         }
 
         if (_statusCode <= 0) {
             setStatus(_statusCode, "❌ HTTP error %d: %s", _statusCode,
                       _http.errorToString(_statusCode).c_str());
+            endFailed();
+            return false;
+        }
+        if (_statusCode == 304) {
+            _statusMsg = "Not Modified";    // Expected answer to a conditional GET
+            _bodyRemaining = 0;             // No body: the connection stays usable
             end();
             return false;
         }
         if (_statusCode >= 400) {
             setStatus(_statusCode, "❌ HTTP %d for %s", _statusCode, url);
-            end();
+            endFailed();
             return false;
         }
         _statusMsg = "";
@@ -3,8 +3,23 @@
 
 #include <Print.h>
 #include <WString.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <string.h>
+#include <type_traits>
 
-#define LOG_BUFFER_SIZE 50
+#ifndef LOG_RING_BYTES
+#define LOG_RING_BYTES 8192  // Recent lines kept for /logs (power of two)
+#endif
+#ifndef LOG_QUEUE_BYTES
+#define LOG_QUEUE_BYTES 4096  // Per-core lines waiting for the sink task (power of two)
+#endif
+#ifndef LOG_SINK_PRIORITY
+#define LOG_SINK_PRIORITY 1  // Below audio and DTMF: output is never urgent
+#endif
+#define LOG_CURSOR_OLDEST 0xFFFFFFFFu  // printLogsAsJson(): from the oldest line kept
+#define LOG_PRODUCER_CORES 2
 #define MAX_LOG_MESSAGE_LENGTH 256
 #define MAX_LOG_STREAMS 3  // Serial + Telnet + future expansion
 
@@ -27,19 +42,115 @@ enum LogLevel {
     #define DEFAULT_LOG_LEVEL LOG_NORMAL
 #endif
 
+// ============================================================================
+// BINARY LOG RECORDS
+// ============================================================================
+
+// With LOG_BINARY_RECORDS, LOG_PRINTF/LOG_DEBUGF don't format on the device:
+// the line is "~<format id>:<base64 args>", where the id is the FNV-1a hash
+// of the format string (computed at compile time, so the string itself isn't
+// in flash). tools/log_formats.py builds the id → format table from the
+// sources, and the log receiver decodes with it.
+#ifndef LOG_BINARY_RECORDS
+#define LOG_BINARY_RECORDS 0
+#endif
+
+#define LOG_RECORD_ARG_BYTES 96  // Packed arguments per record
+
+// Arguments packed in call order: integers as 4 bytes (8 for 64-bit),
+// floating point as a 4-byte float, strings as a length byte plus text
+struct LogArgs {
+    uint8_t bytes[LOG_RECORD_ARG_BYTES];
+    size_t len;
+
+    void put(const void* data, size_t n) {
+        if (len + n > sizeof(bytes)) n = sizeof(bytes) - len;
+        memcpy(bytes + len, data, n);
+        len += n;
+    }
+};
+
+constexpr uint32_t logFormatId(const char* s, uint32_t hash = 2166136261u) {
+    return *s ? logFormatId(s + 1, (hash ^ (uint8_t)*s) * 16777619u) : hash;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+logPackArg(LogArgs& a, T v) {
+    if (sizeof(T) > sizeof(uint32_t)) {
+        uint64_t wide = (uint64_t)v;
+        a.put(&wide, sizeof(wide));
+    } else {
+        uint32_t narrow = (uint32_t)v;
+        a.put(&narrow, sizeof(narrow));
+    }
+}
+
+inline void logPackArg(LogArgs& a, double v) {
+    float f = (float)v;
+    a.put(&f, sizeof(f));
+}
+
+inline void logPackArg(LogArgs& a, const char* s) {
+    size_t n = s ? strlen(s) : 0;
+    uint8_t len = n > 255 ? 255 : (uint8_t)n;
+    a.put(&len, 1);
+    a.put(s, len);
+}
+
+inline void logPackArg(LogArgs& a, const void* p) {
+    uint32_t addr = (uint32_t)(uintptr_t)p;
+    a.put(&addr, sizeof(addr));
+}
+
+inline void logPackArgs(LogArgs&) {}
+
+template <typename T, typename... Rest>
+inline void logPackArgs(LogArgs& a, T first, Rest... rest) {
+    logPackArg(a, first);
+    logPackArgs(a, rest...);
+}
+
+// Log calls only copy the line into their core's queue; a low-priority sink
+// task writes queued lines to the streams and the /logs ring, so a slow
+// telnet client or a full UART never stalls the task that logged.
 class LoggerClass : public Print {
 private:
+    // One per core. The core's own tasks append under `lock`, which the other
+    // core only touches if a task migrates mid-call; only the sink advances
+    // `tail`.
+    struct LineQueue {
+        portMUX_TYPE lock;
+        char line[MAX_LOG_MESSAGE_LENGTH];  // Line being assembled
+        int linePos;
+        uint8_t bytes[LOG_QUEUE_BYTES];     // [ms:4][len:2][text] records
+        volatile uint32_t head;             // Free-running byte offsets
+        volatile uint32_t tail;
+        volatile uint32_t drops;            // Lines lost to a full queue
+    };
+
     Print* streams[MAX_LOG_STREAMS];  // Multiple output streams (Serial, Telnet, etc.)
+    uint32_t streamDrops[MAX_LOG_STREAMS];  // Short writes per stream
     int streamCount;
-    String logBuffer[LOG_BUFFER_SIZE];
-    int logIndex;
+    LineQueue queues[LOG_PRODUCER_CORES];
+    char sinkLine[MAX_LOG_MESSAGE_LENGTH];
+    TaskHandle_t sinkTask;
+    SemaphoreHandle_t sinkLock;  // Held while writing to the streams
+    // Recent lines, preallocated: [ms:4][len:2][text][len:2] records.
+    // logHead/logTail are free-running byte offsets; the trailing length
+    // lets the ring be read newest first.
+    uint8_t logRing[LOG_RING_BYTES];
+    uint32_t logHead;
+    uint32_t logTail;
     int logCount;
-    char messageBuffer[MAX_LOG_MESSAGE_LENGTH];
-    int bufferPos;
     LogLevel currentLogLevel;
 
     bool shouldFilterLine(const char* line) const;
-    void flushBufferedLine();
+    bool queueLine(LineQueue& q);
+    bool startSink();
+    bool drainOne();
+    void emitLine(uint32_t ms, const char* text, size_t len);
+    static void sinkTaskMain(void* arg);
 
 public:
     LoggerClass();
@@ -57,31 +168,91 @@ public:
     // Print interface implementation
     size_t write(uint8_t byte) override;
     size_t write(const uint8_t* buffer, size_t size) override;
+
+    // Write out everything queued now, from the calling task (also run
+    // automatically before a restart)
+    void flush() override;
     
     // Debug-level logging (only outputs when logLevel >= LOG_DEBUG)
     void debug(const char* message);
     void debugln(const char* message);
     void debugln();
     void debugf(const char* format, ...);
+
+    // Binary record of a format id and its packed arguments (use LOG_PRINTF)
+    template <typename... Args>
+    void record(uint32_t formatId, Args... args) {
+        LogArgs a;
+        a.len = 0;
+        logPackArgs(a, args...);
+        writeRecord(formatId, a);
+    }
+    void writeRecord(uint32_t formatId, const LogArgs& args);
     
-    // Get log messages for web interface
-    String getLogsAsHtml();
-    String getLogsAsJson();
+    // Stream buffered log lines for the web interface: the page newest
+    // first; JSON oldest first from a cursor (LOG_CURSOR_OLDEST for all, or
+    // the "next" of an earlier reply for only the lines logged since)
+    void printLogsAsHtml(Print& out);
+    void printLogsAsJson(Print& out, uint32_t since = LOG_CURSOR_OLDEST);
     
     // Buffer management
     void clearLogs();
     int getLogCount() const { return logCount; }
+    void printStats();
     
     // Raw data dump - writes directly to streams, bypasses log buffer
     // Use for large data dumps that would overwhelm the circular log buffer
+    // or the line queues; queued lines are written out first
     void writeRaw(const char* data, size_t len);
     void writeRawLine(const char* line);
     
 private:
-    void addMessageToBuffer(const String& message);
+    void addMessageToBuffer(uint32_t ms, const char* text, size_t len);
+    bool readRecordBefore(uint32_t& end, uint32_t& ms, char* text, size_t& len);
+    bool readRecordAt(uint32_t& start, uint32_t& ms, char* text, size_t& len, bool& skipped);
 };
 
 // Global logger instance (declared in logging.cpp)  
 extern LoggerClass Logger;
 
+// ============================================================================
+// COMPILE-TIME LOG LEVELS
+// ============================================================================
+
+// LOG_PRINTF(MODULE, fmt, ...) and LOG_DEBUGF(MODULE, fmt, ...) compile to
+// nothing — format string included — when LOG_LEVEL_<MODULE> is below the
+// call's level; otherwise they behave like Logger.printf / Logger.debugf.
+// -DLOG_COMPILE_LEVEL=1 drops debug logging everywhere; -DLOG_LEVEL_DTMF=0
+// silences one module.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_DEBUG
+#endif
+#ifndef LOG_LEVEL_AUDIO
+#define LOG_LEVEL_AUDIO LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_LEVEL_DTMF
+#define LOG_LEVEL_DTMF LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_LEVEL_WEBQUEUE
+#define LOG_LEVEL_WEBQUEUE LOG_COMPILE_LEVEL
+#endif
+
+#if LOG_BINARY_RECORDS
+#define LOG_EMIT(fmt, ...) do { \
+        constexpr uint32_t logFormatId_ = logFormatId(fmt); \
+        Logger.record(logFormatId_, ##__VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_EMIT(fmt, ...) Logger.printf(fmt, ##__VA_ARGS__)
+#endif
+
+#define LOG_PRINTF(module, fmt, ...) do { \
+        if (LOG_LEVEL_##module >= LOG_NORMAL) LOG_EMIT(fmt, ##__VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUGF(module, fmt, ...) do { \
+        if (LOG_LEVEL_##module >= LOG_DEBUG && Logger.getLogLevel() >= LOG_DEBUG) \
+            LOG_EMIT(fmt, ##__VA_ARGS__); \
+    } while (0)
+
 #endif // LOGGING_H
@@ -0,0 +1,91 @@
+#pragma once
+/**
+ * @file loop_scheduler.h
+ * @brief Deadline scheduler for the maintenance work in loop()
+ *
+ * Each subsystem registers a tick with a period, a priority and a runtime
+ * budget in µs. loop() calls run() once per pass with the time it can spare
+ * before audioPlayer.copy() must run again: a short slice while audio plays
+ * from loop(), a long one otherwise.
+ *
+ * run() starts due jobs in priority order (0 first) while their expected
+ * runtime still fits in the slice. The expected runtime is the larger of
+ * the budget and a moving average of what the job actually took. A job that
+ * doesn't fit is deferred to a later pass. One deferred past
+ * LOOP_SCHED_MAX_DEFER_MS runs anyway, so nothing starves. Overruns and
+ * deferrals are counted per job. `sched` on the console shows them, and a
+ * summary is logged when a job overran in the last LOOP_SCHED_REPORT_MS.
+ * A preempt check (setPreempt) ends the pass early when something loop()
+ * must handle first is waiting, such as a hook change.
+ *
+ *   loopScheduler.add("network", handleNetworkLoop, 20, 1, 3000);
+ *   loopScheduler.run(audioPlayer.isActive() ? LOOP_AUDIO_SLICE_US : LOOP_IDLE_SLICE_US);
+ *
+ * loop() only; not thread-safe.
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#ifndef LOOP_SCHED_MAX_JOBS
+#define LOOP_SCHED_MAX_JOBS 12
+#endif
+#ifndef LOOP_AUDIO_SLICE_US
+#define LOOP_AUDIO_SLICE_US 6000        // Between copy() calls while loop() feeds I2S
+#endif
+#ifndef LOOP_IDLE_SLICE_US
+#define LOOP_IDLE_SLICE_US 50000        // Nothing waiting on loop()
+#endif
+#ifndef LOOP_SCHED_MAX_DEFER_MS
+#define LOOP_SCHED_MAX_DEFER_MS 1000    // Due this long → runs whatever the slice
+#endif
+#ifndef LOOP_SCHED_REPORT_MS
+#define LOOP_SCHED_REPORT_MS 60000      // Overrun summary at most this often (0 = never)
+#endif
+
+class LoopScheduler {
+public:
+    using Tick = void (*)();
+
+    /// Register @p tick (name must outlive the scheduler). Lower @p priority
+    /// runs first. Returns false if the table is full.
+    bool add(const char* name, Tick tick, uint32_t periodMs, uint8_t priority, uint32_t budgetUs);
+
+    /// Run due jobs that fit in @p sliceUs
+    void run(uint32_t sliceUs);
+
+    /// No further job starts in a pass once @p pending returns true
+    void setPreempt(bool (*pending)()) { _preempt = pending; }
+
+    /// Per-job runs, runtime, overruns and deferrals
+    void printStatus();
+    void resetStats();
+
+private:
+    struct Job {
+        const char* name;
+        Tick     tick;
+        uint32_t periodMs;
+        uint32_t budgetUs;
+        uint8_t  priority;
+        unsigned long lastRunMs;
+        unsigned long dueSinceMs;       // 0 = not deferred
+        uint32_t avgUs;                 // Moving average (1/8 weight)
+        uint32_t maxUs;
+        uint32_t runs;
+        uint32_t overruns;              // Ran longer than budgetUs
+        uint32_t deferred;              // Passes skipped for lack of slice
+        uint32_t forced;                // Ran past LOOP_SCHED_MAX_DEFER_MS
+        uint32_t reportedOverruns;      // overruns at the last report
+    };
+
+    Job _jobs[LOOP_SCHED_MAX_JOBS];     // Sorted by priority
+    int _count = 0;
+    unsigned long _lastReportMs = 0;
+    bool (*_preempt)() = nullptr;
+
+    void report(unsigned long now);
+};
+
+extern LoopScheduler loopScheduler;
@@ -0,0 +1,37 @@
+/**
+ * @file lz4_block.h
+ * @brief Small LZ4 block-format compressor/decompressor for log frames
+ *
+ * Log text compresses well (repeated prefixes, emoji and key names), and a
+ * greedy LZ4 pass over a couple of KB costs well under a millisecond. The
+ * output is a standard LZ4 block (no frame header), so any LZ4 block
+ * decoder reads it; tools/server's receiver has its own.
+ *
+ * Blocks are limited to 64 KB. The compressor keeps its hash table in a
+ * static buffer: one caller at a time.
+ *
+ * @date 2026
+ */
+
+#ifndef LZ4_BLOCK_H
+#define LZ4_BLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Worst-case compressed size of @p n bytes
+#define LZ4_BLOCK_BOUND(n) ((n) + (n) / 255 + 16)
+
+/**
+ * @brief Compress @p srcLen bytes into @p dst
+ * @return Compressed size, or 0 if it didn't fit in @p dstCap
+ */
+size_t lz4BlockCompress(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstCap);
+
+/**
+ * @brief Expand a block into @p dst
+ * @return Decompressed size, or -1 for a malformed block or too small a @p dst
+ */
+int lz4BlockDecompress(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstCap);
+
+#endif // LZ4_BLOCK_H
@@ -0,0 +1,100 @@
+#pragma once
+/**
+ * @file metrics.h
+ * @brief Periodic metrics snapshots shipped on the remote-log TCP stream
+ *
+ * Each subsystem is a source: a function that reports its counters (since
+ * boot), gauges (now) and fixed-bucket histograms into a MetricsWriter when
+ * a snapshot is taken. Sources read the statistics their module already
+ * keeps, so nothing is added to the audio or detection paths.
+ *
+ * Every METRICS_INTERVAL_MS, ship() encodes one snapshot as CBOR
+ *
+ *   { "v": 1, "up": <s>, "n": <snapshot #>,
+ *     "<source>": { "<name>": <uint counter> | <float gauge>
+ *                         | [first, log2, count0, count1, ...] } ... }
+ *
+ * and hands it to RemoteLogger.writeMetrics(). It is spooled with the log
+ * frames and goes out on the persistent TCP stream to servers that accept
+ * metrics frames. The server (tools/server/phone-receiver) keeps them per
+ * device and aggregates them by device or firmware version.
+ * A histogram's bucket i holds values below first * 2^i (log2 = 1) or
+ * first * (i + 1) (log2 = 0); the last bucket is open-ended.
+ *
+ *   metrics.begin();                 // registers the built-in sources
+ *   loopScheduler.add("metrics", []() { metrics.ship(); }, METRICS_INTERVAL_MS, 9, 1500);
+ *
+ * `metrics` on the console prints a snapshot as text. loop() only.
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#ifndef METRICS_INTERVAL_MS
+#define METRICS_INTERVAL_MS 60000       // Snapshot period (0 = no snapshots)
+#endif
+#ifndef METRICS_MAX_SOURCES
+#define METRICS_MAX_SOURCES 8
+#endif
+#ifndef METRICS_SNAPSHOT_BYTES
+#define METRICS_SNAPSHOT_BYTES 1536     // Encoded snapshot, at most REMOTE_LOG_FRAME_BYTES
+#endif
+
+/// Encodes one source's values as CBOR, or appends them as text
+class MetricsWriter {
+public:
+    MetricsWriter(uint8_t* buf, size_t cap) : _buf(buf), _cap(cap) {}
+    explicit MetricsWriter(String& text) : _text(&text) {}
+
+    void counter(const char* name, uint32_t value);
+    void gauge(const char* name, float value);
+    void histogram(const char* name, const uint32_t* counts, int buckets, uint32_t first, bool log2);
+
+    size_t length() const { return _len; }
+    bool overflowed() const { return _overflow; }
+
+private:
+    friend class MetricsRegistry;
+
+    uint8_t* _buf = nullptr;
+    size_t   _cap = 0;
+    size_t   _len = 0;
+    bool     _overflow = false;
+    String*  _text = nullptr;       // Text mode: " name=value" appended
+
+    void put(uint8_t b);
+    void head(uint8_t major, uint32_t value);
+    void str(const char* s);
+    void beginMap() { put(0xbf); }      // Indefinite length
+    void endMap() { put(0xff); }
+};
+
+class MetricsRegistry {
+public:
+    using Source = void (*)(MetricsWriter& w);
+
+    /// Register the built-in sources (Goertzel, player, WebQueue, network, heap)
+    void begin();
+
+    /// Add a source; @p name must outlive the registry
+    bool add(const char* name, Source source);
+
+    /// Take a snapshot and spool it for the log server
+    void ship();
+
+    /// Current values, one line per source
+    void print();
+
+private:
+    struct Entry {
+        const char* name;
+        Source source;
+    };
+    Entry _sources[METRICS_MAX_SOURCES];
+    int _count = 0;
+    uint32_t _shipped = 0;
+    uint32_t _failed = 0;
+};
+
+extern MetricsRegistry metrics;
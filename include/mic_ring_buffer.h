@@ -0,0 +1,217 @@
+/**
+ * @file mic_ring_buffer.h
+ * @brief Single-producer, multi-reader PCM ring for the mic input
+ *
+ * One capture task reads the codec (kit) one DMA frame at a time and appends
+ * mono int16 samples to a PSRAM ring. Every consumer — the Goertzel task,
+ * audio capture, and later a level meter or VAD — owns a MicRingReader
+ * cursor and reads the same samples on its own schedule. Nobody has to stop
+ * the I2S reader, and nothing is copied twice.
+ *
+ * Lock-free: the producer writes samples, then publishes a monotonically
+ * increasing 32-bit sample index (release store). Readers load it (acquire)
+ * and never write shared state. A reader that falls more than the usable
+ * capacity behind is moved to the oldest valid sample and the gap is
+ * counted in lostSamples().
+ *
+ * The same ring type also carries the loopback reference: RingTapStream
+ * sits in front of the codec output and copies what the player writes into
+ * getLoopbackReferenceRing() for the Goertzel loopback canceller.
+ *
+ * @author Bowie Phone Project
+ * @date 2026
+ */
+
+#ifndef MIC_RING_BUFFER_H
+#define MIC_RING_BUFFER_H
+
+#include <Arduino.h>
+#include "AudioTools/CoreAudio/BaseStream.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Ring length in samples (power of two). 65536 = ~1.5s @ 44.1kHz, 128 KB PSRAM
+#ifndef MIC_RING_SAMPLES
+#define MIC_RING_SAMPLES 65536
+#endif
+
+/// Fallback length when PSRAM is unavailable (internal RAM)
+#ifndef MIC_RING_FALLBACK_SAMPLES
+#define MIC_RING_FALLBACK_SAMPLES 8192
+#endif
+
+/// Samples kept between the producer and the oldest readable sample, so a
+/// reader copying out cannot race the frame being written
+#ifndef MIC_RING_GUARD_SAMPLES
+#define MIC_RING_GUARD_SAMPLES 2048
+#endif
+
+/// Loopback reference ring length (power of two). 16384 = ~370ms @ 44.1kHz
+#ifndef LOOPBACK_REF_RING_SAMPLES
+#define LOOPBACK_REF_RING_SAMPLES 16384
+#endif
+
+/// Tasks that can be woken when a frame is published
+#ifndef MIC_RING_MAX_SUBSCRIBERS
+#define MIC_RING_MAX_SUBSCRIBERS 4
+#endif
+
+// ============================================================================
+// RING BUFFER
+// ============================================================================
+
+/**
+ * @brief Lock-free ring: one writer, any number of independent readers
+ */
+class MicRingBuffer
+{
+public:
+    MicRingBuffer() = default;
+    ~MicRingBuffer() { end(); }
+
+    /**
+     * @brief Allocate the ring (PSRAM preferred)
+     * @param capacitySamples Requested length, rounded down to a power of two
+     * @return true on success
+     */
+    bool begin(size_t capacitySamples = MIC_RING_SAMPLES);
+    void end();
+    bool isActive() const { return _buffer != nullptr; }
+
+    /// Append samples and publish them (producer task only)
+    void write(const int16_t* samples, size_t count);
+
+    /// Total samples ever written (acquire load)
+    uint32_t writeIndex() const { return __atomic_load_n(&_writeIndex, __ATOMIC_ACQUIRE); }
+
+    size_t capacity() const { return _mask + 1; }
+
+    /// Samples a reader may lag before it loses data
+    size_t usableCapacity() const { return capacity() - MIC_RING_GUARD_SAMPLES; }
+
+    /**
+     * @brief Copy samples from a reader cursor
+     * @param cursor Reader position (sample index); advanced past what was read
+     * @param dest Destination buffer
+     * @param maxSamples Capacity of @p dest
+     * @param lost Incremented by samples skipped because the reader was lapped
+     * @return Samples copied
+     */
+    size_t read(uint32_t& cursor, int16_t* dest, size_t maxSamples, uint32_t& lost) const;
+
+    /// Register a task to receive xTaskNotifyGive() after each published frame
+    bool subscribe(TaskHandle_t task);
+    void unsubscribe(TaskHandle_t task);
+
+    /// Wake subscribers (producer task only)
+    void notifySubscribers();
+
+private:
+    int16_t* _buffer = nullptr;
+    uint32_t _mask = 0;
+    uint32_t _writeIndex = 0;
+    TaskHandle_t _subscribers[MIC_RING_MAX_SUBSCRIBERS] = {};
+    portMUX_TYPE _subscriberLock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+/**
+ * @brief One consumer's cursor into a MicRingBuffer, usable as a StreamCopy source
+ *
+ * readBytes() never blocks: it returns what is buffered. Each reader is
+ * used from a single task.
+ */
+class MicRingReader : public AudioStream
+{
+public:
+    explicit MicRingReader(MicRingBuffer& ring) : _ring(ring) {}
+
+    /// Skip everything buffered so the next read starts at live audio
+    void seekToLive() { _cursor = _ring.writeIndex(); _hasPendingByte = false; }
+
+    /// Absolute sample index of the next read
+    uint32_t position() const { return _cursor; }
+    /// Move the cursor (e.g. to hold a fixed delay behind writeIndex())
+    void seek(uint32_t position) { _cursor = position; _hasPendingByte = false; }
+
+    /// Read whole samples
+    size_t readSamples(int16_t* dest, size_t maxSamples);
+
+    size_t readBytes(uint8_t* data, size_t len) override;
+    size_t write(const uint8_t* data, size_t len) override { return 0; }
+    int available() override;
+    int availableForWrite() override { return 0; }
+
+    /// Samples this reader missed because it fell behind
+    uint32_t lostSamples() const { return _lost; }
+    /// Times this reader was lapped
+    uint32_t overruns() const { return _overruns; }
+
+private:
+    MicRingBuffer& _ring;
+    uint32_t _cursor = 0;
+    uint32_t _lost = 0;
+    uint32_t _overruns = 0;
+    uint8_t _pendingByte = 0;      ///< High byte of a sample split across reads
+    bool _hasPendingByte = false;
+};
+
+/**
+ * @brief Pass-through output stage that copies played PCM into a ring
+ *
+ * Place between the player (its mixer) and the codec. write() forwards
+ * everything and appends the first channel of each frame to the ring. The
+ * player is the ring's single producer.
+ */
+class RingTapStream : public AudioStream
+{
+public:
+    explicit RingTapStream(MicRingBuffer& ring) : _ring(ring) {}
+
+    void setOutput(AudioStream& output) { _output = &output; }
+    /// Interleaved channel count of the PCM passing through
+    void setChannels(int channels) { _channels = channels > 0 ? channels : 1; }
+
+    size_t write(const uint8_t* data, size_t len) override;
+    size_t readBytes(uint8_t* data, size_t len) override { return 0; }
+    int availableForWrite() override { return _output ? _output->availableForWrite() : 0; }
+    void setAudioInfo(AudioInfo info) override;
+
+private:
+    MicRingBuffer& _ring;
+    AudioStream* _output = nullptr;
+    int _channels = 1;
+    int _channelIndex = 0;         ///< Position within the current interleaved frame
+    uint8_t _pendingByte = 0;      ///< Low byte of a sample split across writes
+    bool _hasPendingByte = false;
+};
+
+/// Process-wide mic ring fed by the capture task
+MicRingBuffer& getMicRing();
+
+/// Ring of PCM sent to the codec (fed by RingTapStream in the player)
+MicRingBuffer& getLoopbackReferenceRing();
+
+// ============================================================================
+// CAPTURE (PRODUCER) TASK
+// ============================================================================
+
+/// Capture task counters (reset when the task starts)
+struct MicCaptureStats {
+    uint32_t frames;          // DMA frames published to the ring
+    uint32_t overruns;        // Times the task fell behind by more than the DMA ring
+    uint32_t missedFrames;    // DMA frames lost to those overruns, plus empty reads
+};
+
+/**
+ * @brief Allocate the ring (if needed) and start reading @p source on core 0
+ * @param source Codec stream; readBytes() is expected to block per DMA frame
+ * @return true if the task is running
+ */
+bool startMicCapture(Stream& source);
+void stopMicCapture();
+bool isMicCaptureRunning();
+MicCaptureStats getMicCaptureStats();
+
+#endif // MIC_RING_BUFFER_H
@@ -0,0 +1,124 @@
+#pragma once
+/**
+ * @file net_worker.h
+ * @brief One persistent task for background HTTP requests
+ *
+ * Requests wait in a fixed table of NET_WORKER_QUEUE_DEPTH slots; the NetIO
+ * task (core 0, below Goertzel) runs them one at a time on pooled
+ * connections (http_pool.h). Callbacks don't run on core 0: finished
+ * requests queue up until poll(), which handleNetworkLoop() calls on core 1.
+ *
+ * A full table rejects the request (the call returns false) instead of
+ * allocating more: a burst costs nothing beyond the table and one stack.
+ *
+ *   netWorker.getString(url, [](bool ok, int code, const String& body, void*) {
+ *       ...  // core 1
+ *   });
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "config.h"
+
+struct HttpValidators;
+
+#ifndef NET_WORKER_QUEUE_DEPTH
+#define NET_WORKER_QUEUE_DEPTH 6        // Requests waiting or running
+#endif
+#ifndef NET_WORKER_STACK
+#define NET_WORKER_STACK 12288          // TLS handshake is the deep part
+#endif
+#ifndef NET_WORKER_PRIORITY
+#define NET_WORKER_PRIORITY 0           // Below GoertzelTask (1) on core 0
+#endif
+
+class NetWorker {
+public:
+    using FileCallback   = void(*)(int bytesWritten, void* userData);
+    using StringCallback = void(*)(bool success, int statusCode, const String& body, void* userData);
+    using PostCallback   = void(*)(bool success, int statusCode, void* userData);
+
+    // Each returns false if the request table is full (the callback won't run)
+
+    /// GET url into an SD file; cb gets bytes written, or -1
+    bool getFile(const char* url, const char* sdPath,
+                 FileCallback cb = nullptr, void* userData = nullptr,
+                 int timeoutMs = HTTP_TIMEOUT_DOWNLOAD_MS);
+
+    /// GET url as a String. With validators the GET is conditional: a 304
+    /// calls back success with statusCode 304 and no body, a 200 overwrites
+    /// them. They're written on the NetIO task — leave them alone until the
+    /// callback.
+    bool getString(const char* url, StringCallback cb, void* userData = nullptr,
+                   int timeoutMs = HTTP_TIMEOUT_CATALOG_MS,
+                   HttpValidators* validators = nullptr);
+
+    /// POST body (moved in) to url
+    bool post(const char* url, String body,
+              PostCallback cb = nullptr, void* userData = nullptr,
+              const char* contentType = "application/json",
+              const char* extraHeaderName = nullptr,
+              const char* extraHeaderValue = nullptr,
+              int timeoutMs = HTTP_TIMEOUT_SHORT_MS);
+
+    /// Run callbacks of finished requests (core 1, from handleNetworkLoop)
+    void poll();
+
+    /// Requests not yet called back
+    int pending() const;
+
+    void printStatus();
+
+private:
+    enum class Kind  : uint8_t { GET_FILE, GET_STRING, POST };
+    enum class State : uint8_t { FREE, QUEUED, RUNNING, DONE };
+
+    struct Request {
+        State         state = State::FREE;
+        Kind          kind  = Kind::GET_STRING;
+        char          url[256];
+        char          sdPath[128];
+        char          contentType[48];
+        char          extraName[32];
+        char          extraValue[64];
+        String        body;            // POST body in, GET_STRING body out
+        HttpValidators* validators = nullptr;  // Conditional GET_STRING
+        int           timeoutMs = 0;
+        void*         cb        = nullptr;
+        void*         userData  = nullptr;
+        bool          ok        = false;
+        int           result    = 0;   // Status code, or bytes for GET_FILE
+        unsigned long queuedAt  = 0;
+        unsigned long doneAt    = 0;
+    };
+
+    Request       _reqs[NET_WORKER_QUEUE_DEPTH];
+    QueueHandle_t _todo = nullptr;     // Slot indices, FIFO
+    QueueHandle_t _done = nullptr;
+    TaskHandle_t  _task = nullptr;
+    portMUX_TYPE  _mux  = portMUX_INITIALIZER_UNLOCKED;
+    volatile bool _starting = false;
+
+    // Stats (written under _mux or by poll())
+    uint32_t      _queued    = 0;
+    uint32_t      _completed = 0;
+    uint32_t      _failed    = 0;
+    uint32_t      _rejected  = 0;      // Table full
+    int           _depth     = 0;
+    int           _maxDepth  = 0;
+    unsigned long _lastLatencyMs = 0;  // Queued → done
+    unsigned long _maxLatencyMs  = 0;
+    unsigned long _totalLatencyMs = 0;
+
+    bool     start();
+    Request* claim(Kind kind, const char* url, void* cb, void* userData, int timeoutMs);
+    bool     submit(Request* r);
+    void     run(Request& r);
+    static void taskMain(void* arg);
+};
+
+extern NetWorker netWorker;
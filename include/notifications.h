@@ -16,6 +16,35 @@ enum class NotificationType {
     ReadingSequence,    // Boolean payload: true=reading, false=done
 };
 
+// ============================================================================
+// LED PATTERN ENGINE
+// ============================================================================
+// Each LED has a base level (notify(type, bool)) and a short queue of
+// patterns overlaid on it, ordered by priority. An esp_timer steps the
+// pattern at the head of the queue, so notify() only queues and returns.
+// When the queue empties the LED goes back to its base level. A higher
+// priority pattern pre-empts the running one, which restarts afterwards.
+
+#ifndef LED_PATTERN_QUEUE
+#define LED_PATTERN_QUEUE 4    // Patterns waiting per LED (lowest priority dropped)
+#endif
+
+enum class LedPriority : uint8_t {
+    Background,    // Status blinks that run until cleared
+    Normal,        // Transient feedback (DTMF pulses)
+    Alert          // Pre-empts everything else
+};
+
+// Dark for leadMs, then count × (onMs lit, offMs dark), the last gap being
+// tailMs. count = 0 repeats on/off until cleared.
+struct LedPattern {
+    uint16_t onMs;
+    uint16_t offMs;
+    uint8_t  count;
+    uint16_t leadMs;
+    uint16_t tailMs;
+};
+
 // Pulse timing configuration (milliseconds)
 struct PulseConfig {
     uint16_t onDuration;   // How long LED stays on during pulse
@@ -44,6 +73,7 @@ void initNotifications();
 
 /**
  * Send a notification with a boolean payload
+ * Sets the LED's base level, shown whenever no pattern is playing
  * @param type The notification type
  * @param value true to turn LED on, false to turn off
  */
@@ -51,12 +81,28 @@ void notify(NotificationType type, bool value);
 
 /**
  * Send a notification with an integer payload
- * Pulses the LED the specified number of times
+ * Queues a pulse pattern of the specified number of pulses and returns
  * @param type The notification type
  * @param value Number of pulses (typically DTMF key value)
  */
 void notify(NotificationType type, int value);
 
+/**
+ * Queue a pattern on the LED for a notification type
+ * @param type The notification type (selects the LED)
+ * @param pattern Blink timing
+ * @param priority Higher pre-empts lower; equal priorities play in order
+ */
+void notifyPattern(NotificationType type, const LedPattern& pattern,
+                   LedPriority priority = LedPriority::Normal);
+
+/**
+ * Remove queued and running patterns of a priority from the LED
+ * @param type The notification type (selects the LED)
+ * @param priority Patterns at this priority are dropped
+ */
+void clearPattern(NotificationType type, LedPriority priority);
+
 /**
  * Configure pulse timing
  * @param config Pulse timing configuration
@@ -0,0 +1,124 @@
+#pragma once
+/**
+ * @file ota_updater.h
+ * @brief Pull OTA in the background while the phone stays in service
+ *
+ * The OtaFetch task (core 0, below Goertzel) downloads a firmware image into
+ * the inactive app partition through Update, a block at a time. Nothing is
+ * shut down first: audio, SD and DTMF keep running.
+ *
+ * Images are either a plain firmware.bin or a compressed firmware.ota from
+ * tools/release.py, told apart by their first bytes:
+ *
+ *   OtaImageHeader (48 bytes: "BOTA", block size, image size, SHA-256)
+ *   { uint32_t word; payload[word & 0x7FFFFFFF] } ...
+ *
+ * Each payload is an LZ4 block (lz4_block.h) expanding to blockSize bytes
+ * (the last may be shorter), or stored as is when bit 31 is set.
+ *
+ * Flash writes stall both cores' cache, so the task holds off while the
+ * busy check (setBusyCheck) says the phone is in use. It drops the
+ * connection at a block boundary and resumes with an HTTP Range request
+ * when the phone is idle again. The SHA-256 of the written image must match
+ * before the boot partition is switched. The reboot then waits for the
+ * phone to be idle too.
+ *
+ *   otaUpdater.setBusyCheck([]() { return Phone.isOffHook(); });
+ *   otaUpdater.start(url);         // core 1; handleNetworkLoop() polls
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#ifndef OTA_UPDATER_STACK
+#define OTA_UPDATER_STACK 8192          // TLS reads + SHA-256 context
+#endif
+#ifndef OTA_UPDATER_PRIORITY
+#define OTA_UPDATER_PRIORITY 0          // Below GoertzelTask (1) on core 0
+#endif
+#ifndef OTA_RAW_CHUNK_BYTES
+#define OTA_RAW_CHUNK_BYTES 4096        // Plain images: bytes per write (one flash sector)
+#endif
+#ifndef OTA_MAX_BLOCK_BYTES
+#define OTA_MAX_BLOCK_BYTES 32768       // Largest compressed block size accepted
+#endif
+#ifndef OTA_READ_TIMEOUT_MS
+#define OTA_READ_TIMEOUT_MS 15000       // Stalled body → reconnect with Range
+#endif
+#ifndef OTA_MAX_RETRIES
+#define OTA_MAX_RETRIES 8               // Failed connects/reads in a row before giving up
+#endif
+#ifndef OTA_RETRY_MS
+#define OTA_RETRY_MS 5000               // First retry delay (doubles)
+#endif
+#ifndef OTA_HOLD_POLL_MS
+#define OTA_HOLD_POLL_MS 500            // Recheck while the phone is in use
+#endif
+
+#define OTA_IMAGE_MAGIC "BOTA"
+#define OTA_BLOCK_STORED 0x80000000u    // Block word: payload is not compressed
+
+/// Compressed image header, little-endian as written by tools/release.py
+struct OtaImageHeader {
+    char     magic[4];                  // OTA_IMAGE_MAGIC
+    uint8_t  version;                   // 1
+    uint8_t  reserved[3];
+    uint32_t blockSize;                 // Bytes each block expands to
+    uint32_t imageSize;                 // firmware.bin size
+    uint8_t  sha256[32];                // Of firmware.bin
+};
+static_assert(sizeof(OtaImageHeader) == 48, "OtaImageHeader is 48 bytes on the wire");
+
+class OtaUpdater {
+public:
+    enum class State : uint8_t {
+        IDLE,
+        FETCHING,       // Downloading and writing
+        HELD,           // Phone in use; resumes with Range when idle
+        READY,          // Verified, boot partition set; reboots when idle
+        FAILED
+    };
+
+    /// Begin downloading @p url (core 1). @p sha256Hex checks a plain image
+    /// (compressed images carry their own). True if started, or already
+    /// fetching the same URL.
+    bool start(const char* url, const char* sha256Hex = nullptr);
+
+    /// Phone-in-use predicate, evaluated on core 1 by poll()
+    void setBusyCheck(bool (*busy)()) { _busy = busy; }
+
+    /// Hold/release the task from the busy check; reboot once READY and idle
+    /// (core 1, from handleNetworkLoop)
+    void poll();
+
+    State state() const { return _state.load(); }
+    const char* stateName() const;
+
+    /// Update is in use (fetching, held or waiting to reboot)
+    bool active() const;
+
+    void printStatus();
+
+private:
+    char         _url[256];
+    uint8_t      _sha256[32];
+    bool         _haveSha = false;
+    bool       (*_busy)() = nullptr;
+
+    std::atomic<State>    _state{State::IDLE};
+    std::atomic<bool>     _hold{false};
+    std::atomic<uint32_t> _written{0};   // Image bytes flashed
+    std::atomic<uint32_t> _imageSize{0};
+    std::atomic<uint32_t> _fetched{0};   // Bytes of the download consumed
+    std::atomic<uint32_t> _resumes{0};   // Range requests after a hold or drop
+    unsigned long _startedAt = 0;
+
+    bool run();
+    static void taskMain(void* arg);
+};
+
+extern OtaUpdater otaUpdater;
@@ -32,17 +32,22 @@ struct PhoneConfig {
     float freqScale;
 
     // Goertzel-specific timing
-    int goertzelBlockSize;   // Goertzel block size (samples)
-    int requiredConsecutive; // Required consecutive detections to confirm
-    int releaseBlockCount;
+    float goertzelWindowMs;  // Goertzel analysis window (ms, independent of detector rate)
+    float goertzelHopMs;     // Time between evaluations (ms, 0 = non-overlapping; window rounds to whole hops)
+    int requiredConsecutive; // Required consecutive detections (evaluations) to confirm
+    int releaseBlockCount;   // Consecutive silent evaluations before key release
     // Maximum twist ratio (high/low magnitude) to accept as valid DTMF
     // Bowie Phone has asymmetric band magnitudes: high band 2-9x stronger than low
     float maxTwistRatio;
-    int goertzelCopierBufferSize; // StreamCopy buffer size
+    int goertzelCopierBufferSize; // StreamCopy buffer size (polling task / replay; DMA-driven task reads one DMA frame)
 
     // Detection thresholds
-    float fundamentalMagnitudeThreshold;  // Threshold for detecting row/col fundamentals (GoertzelStream callback)
+    float fundamentalMagnitudeThreshold;  // Per-bin presence threshold for row/col fundamentals
     float minDetectionMagnitude;          // Floor for evaluateBlock() — reject loopback artifacts below this
+    float presenceSnrDb;                  // Per-bin presence: dB over that bin's running noise floor
+    float detectionSnrDb;                 // Chosen row and col: dB over their noise floors
+    float maxHarmonicRatio;               // Max 2nd-harmonic / fundamental amplitude of the pair (0 = off)
+    float minToneEnergyRatio;             // Min share of block energy in the tone pair (0 = off)
     float summedMagnitudeThreshold;       // Threshold for detecting summed frequencies
     float freqTolerance;                  // Hz tolerance for frequency matching
     float summedFreqTolerance;            // Hz tolerance for summed frequency matching
@@ -73,6 +78,10 @@ struct PhoneConfig {
 // This is defined in the phone-specific implementation file
 extern const PhoneConfig& getPhoneConfig();
 
+// Writable view of the same configuration, for the runtime tunables
+// (tunables.cpp) only; everything else reads getPhoneConfig()
+extern PhoneConfig& getTunablePhoneConfig();
+
 // Standard DTMF keypad (same for all phones)
 extern const char DTMF_KEYPAD[4][4];
 
@@ -4,9 +4,13 @@
 #include <Arduino.h>
 
 // Phone Home - periodic check-in with server for remote management
-// Returns true if an OTA update was triggered
+// Returns true if an OTA update was triggered (blocks for the request)
 bool checkForRemoteUpdates(const char* serverUrl = nullptr);
 
+// Periodic check from handleNetworkLoop(): the request runs on the NetIO
+// task (net_worker.h) and the reply is acted on from netWorker.poll()
+void pollRemoteUpdates();
+
 // Set the phone home interval (default: 1 hour)
 void setPhoneHomeInterval(unsigned long intervalMs);
 
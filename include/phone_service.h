@@ -3,10 +3,29 @@
 
 #include <Arduino.h>
 #include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/timers.h>
 #include "config.h"
 
+/*
+ * Hook sensing is edge driven. A GPIO interrupt timestamps each SHK edge
+ * (esp_timer µs) into a small ring and restarts the settle timer. Once the
+ * line has been quiet for HOOK_DEBOUNCE_MS, the timer callback (FreeRTOS
+ * timer task) reads the settled level and queues a hook event. loop()
+ * applies queued events at its next Phone.loop(), so the callbacks still
+ * run on the main task. The latency from the edge no longer depends on how
+ * long the rest of loop() took.
+ *
+ * With HOOK_PULSE_DIAL the timer also decodes rotary dial pulses: on-hook
+ * breaks shorter than HOOK_PULSE_BREAK_MAX_MS are counted, and a pause of
+ * HOOK_PULSE_DIGIT_GAP_MS ends the digit (10 pulses = '0'). A hang-up is
+ * then reported once the line stays on-hook past the pulse limit.
+ */
+
 // Define callback types
 typedef std::function<void(bool)> HookStateCallback;
+typedef std::function<void(char)> PulseDigitCallback;
 class PhoneService {
 public:
     PhoneService();
@@ -25,6 +44,17 @@ public:
     // Hook state
     bool isOffHook() const { return _isOffHook; }
     void setHookCallback(HookStateCallback callback);
+    // Rotary digits decoded from the hook line (HOOK_PULSE_DIAL)
+    void setPulseDigitCallback(PulseDigitCallback callback) { _pulseDigitCallback = callback; }
+    // A settled hook change or pulse digit is waiting for loop()
+    bool hookEventPending() const;
+    // Edge-to-loop() latency of hook changes and bounce counts
+    void printHookStats() const;
+    // Block the caller until a hook event is pending, up to @p timeoutMs
+    bool waitHookEvent(uint32_t timeoutMs) const;
+    // Light sleep: let an off-hook level on SHK wake the chip. The ISR
+    // disarms it on the first edge and goes back to both-edge interrupts.
+    void armHookWake(bool armed);
     
     // Debug/simulation methods
     void setOffHook(bool offHook, bool fromDebug = true, unsigned long overrideForMs = 60000);  // Simulate hook state change
@@ -44,18 +74,54 @@ private:
     
     // State variables
     bool _isOffHook;
-    bool _lastShkReading;
     bool _debugOverride;          // When true, ignore physical hook pin
     unsigned long _debugOverrideExpiry;  // millis() time when override expires (0 = indefinite)
     
-    unsigned long _lastDebounceTime;
-    unsigned long _debounceDelay;
-    
+    // Settled hook changes and pulse digits, settle timer → loop()
+    enum class HookEventType : uint8_t { OFF_HOOK, ON_HOOK, DIGIT };
+    struct HookEvent {
+        HookEventType type;
+        char digit;
+        uint32_t edgeUs;              // esp_timer time of the edge that caused it
+    };
+    static constexpr int kEdgeRing = 16;  // Power of two
+
+    QueueHandle_t _hookEvents = nullptr;
+    TimerHandle_t _settleTimer = nullptr;
+
+    // Written by the ISR only
+    volatile uint32_t _edgeUs[kEdgeRing] = {};
+    volatile uint32_t _edgeHead = 0;
+    volatile bool _wakeArmed = false;       // SHK is a level wake source
+    portMUX_TYPE _wakeMux = portMUX_INITIALIZER_UNLOCKED;
+
+    // Settle timer only
+    uint32_t _edgeTail = 0;
+    uint32_t _lastEdgeUs = 0;
+    bool _lineOffHook = false;        // Settled level
+    bool _reportedOffHook = false;    // Last hook state queued
+    uint32_t _breakStartUs = 0;       // Pulse dial: on-hook break in progress
+    uint8_t _pulses = 0;
+    uint32_t _deadlineUs = 0;         // Pulse dial: hang-up or digit-gap deadline (0 = none)
+
+    // Stats (loop() writes latency, the timer writes bounces)
+    uint32_t _hookChanges = 0;
+    uint32_t _lastLatencyUs = 0;
+    uint32_t _maxLatencyUs = 0;
+    uint32_t _bounces = 0;            // Extra edges inside a settle window
+    uint32_t _pulseDigits = 0;
+
     // Callbacks
     HookStateCallback _hookCallback;
+    PulseDigitCallback _pulseDigitCallback;
     
     // Internal helpers
     void checkHookState();
+    void startHookInterrupt();
+    void settle();
+    void queueHookEvent(HookEventType type, char digit, uint32_t edgeUs);
+    static void IRAM_ATTR onHookEdge(void* arg);
+    static void onSettleTimer(TimerHandle_t timer);
 };
 
 extern PhoneService Phone;
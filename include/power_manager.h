@@ -0,0 +1,117 @@
+#pragma once
+/**
+ * @file power_manager.h
+ * @brief Low-power state while the phone sits on-hook
+ *
+ * After POWER_IDLE_MS on-hook with nothing playing, enter() winds down
+ * everything that only matters to a caller:
+ *
+ *   - Goertzel task paused, MicCapture stopped (no I2S reads)
+ *   - Codec muted, PA off, I2S stopped; ES8388 ADC, DAC and chip powered
+ *     down over I2C (POWER_CODEC_SHUTDOWN)
+ *   - WiFi to POWER_WIFI_PS modem sleep. The radio wakes for DTIM beacons,
+ *     so the VPN keepalive and the web UI still work
+ *   - PM locks released: the CPU drops to POWER_MIN_FREQ_MHZ and, when the
+ *     sdkconfig has tickless idle, the chip light-sleeps between ticks
+ *   - An off-hook level on SHK armed as a light-sleep wake source
+ *
+ * loop() then waits on the hook event queue between passes instead of
+ * spinning. wake() undoes it in a few ms. The hook callback calls it before
+ * the dial tone, so playAudioKeyFast() starts on a live codec.
+ *
+ *   powerManager.setIdleCheck([]() { return !Phone.isOffHook() && ...; });
+ *   powerManager.begin(kit);
+ *   loopScheduler.add("power", []() { powerManager.tick(); }, 250, 7, 1000);
+ *
+ * loop() only.
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <esp_pm.h>
+#include <esp_wifi.h>
+
+namespace audio_tools { class AudioBoardStream; }
+
+#ifndef POWER_SAVE_ENABLED
+#define POWER_SAVE_ENABLED 1
+#endif
+#ifndef POWER_IDLE_MS
+#define POWER_IDLE_MS 60000             // On-hook and idle this long → low power
+#endif
+#ifndef POWER_LOOP_SLEEP_MS
+#define POWER_LOOP_SLEEP_MS 20          // loop() waits this long for a hook event per pass
+#endif
+#ifndef POWER_MAX_FREQ_MHZ
+#define POWER_MAX_FREQ_MHZ 240
+#endif
+#ifndef POWER_MIN_FREQ_MHZ
+#define POWER_MIN_FREQ_MHZ 80           // Lowest that keeps WiFi up
+#endif
+#ifndef POWER_LIGHT_SLEEP
+#define POWER_LIGHT_SLEEP 1             // Needs CONFIG_FREERTOS_USE_TICKLESS_IDLE
+#endif
+#ifndef POWER_WIFI_PS
+#define POWER_WIFI_PS WIFI_PS_MAX_MODEM // Wake every listen interval (DTIM multiple)
+#endif
+#ifndef POWER_I2S_PORT
+#define POWER_I2S_PORT I2S_NUM_0        // The codec's port (AudioBoardStream default)
+#endif
+#ifndef POWER_CODEC_SHUTDOWN
+#define POWER_CODEC_SHUTDOWN 1          // Power the ES8388 down, not just mute it
+#endif
+#ifndef POWER_CODEC_I2C_ADDR
+#define POWER_CODEC_I2C_ADDR 0x10       // ES8388 (CE low), on the driver's Wire bus
+#endif
+
+class PowerManager {
+public:
+    /// Create the PM locks and wake sources; starts ACTIVE
+    void begin(audio_tools::AudioBoardStream& kit);
+
+    /// "Nothing needs the audio path" predicate, checked by tick()
+    void setIdleCheck(bool (*idle)()) { _idle = idle; }
+
+    /// Enter low power after POWER_IDLE_MS of idle; wake when no longer idle
+    void tick();
+
+    /// Restore the audio path and full CPU speed (no-op when active)
+    void wake();
+
+    bool lowPower() const { return _lowPower; }
+
+    /// Runtime switch (console `power on|off`); off wakes first
+    void setEnabled(bool enabled);
+    bool enabled() const { return _enabled; }
+
+    void printStatus();
+
+private:
+    audio_tools::AudioBoardStream* _kit = nullptr;
+    bool (*_idle)() = nullptr;
+    bool _enabled = POWER_SAVE_ENABLED;
+    bool _lowPower = false;
+    bool _lightSleep = false;           // esp_pm accepted light_sleep_enable
+    esp_pm_lock_handle_t _cpuLock = nullptr;
+    esp_pm_lock_handle_t _sleepLock = nullptr;
+    wifi_ps_type_t _activePs = WIFI_PS_MIN_MODEM;
+    unsigned long _idleSince = 0;       // 0 = not idle
+
+    // Stats
+    uint32_t _enters = 0;
+    uint32_t _lastWakeUs = 0;           // wake() duration
+    uint32_t _maxWakeUs = 0;
+    unsigned long _enteredAt = 0;
+    unsigned long _lowPowerMs = 0;      // Total time spent in low power
+
+    // ES8388 ChipPower, ADCPower, DACPower as they were before enter()
+    uint8_t _codecPower[3] = {};
+    bool _codecDown = false;
+
+    void enter();
+    void codecPowerDown();
+    void codecPowerRestore();
+};
+
+extern PowerManager powerManager;
@@ -0,0 +1,139 @@
+/**
+ * @file psram_alloc.h
+ * @brief PSRAM placement helpers, a bump arena, and heap statistics
+ *
+ * Placement rules (tools/check_alloc_placement.py enforces the checkable ones):
+ * - Catalog-derived data goes to PSRAM: std containers through
+ *   PsramAllocator / PsramVector, objects through PSRAM_OBJECT_ALLOC,
+ *   structures rebuilt wholesale from the catalog through a PsramArena.
+ * - JSON documents use psramJson() (psram_json.h).
+ * - Internal RAM stays for DMA buffers, task stacks, and what the audio
+ *   and WiFi paths touch per sample or per packet.
+ *
+ * Every helper falls back to internal RAM when PSRAM is missing or full.
+ *
+ * @date 2026
+ */
+
+#ifndef PSRAM_ALLOC_H
+#define PSRAM_ALLOC_H
+
+#include <Arduino.h>
+#include <new>
+#include <vector>
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Smallest chunk a PsramArena takes from the heap
+#ifndef PSRAM_ARENA_CHUNK_BYTES
+#define PSRAM_ARENA_CHUNK_BYTES 4096
+#endif
+
+// ============================================================================
+// ALLOCATION
+// ============================================================================
+
+/// malloc() in PSRAM, else internal RAM
+void* psramAlloc(size_t bytes);
+/// realloc() that prefers PSRAM for the new block
+void* psramRealloc(void* ptr, size_t bytes);
+void  psramFree(void* ptr);
+
+/// std allocator over psramAlloc()
+template <class T>
+struct PsramAllocator {
+    using value_type = T;
+
+    PsramAllocator() = default;
+    template <class U> PsramAllocator(const PsramAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        void* p = psramAlloc(n * sizeof(T));
+        if (!p) abort();                 // No exceptions on this target
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { psramFree(p); }
+
+    template <class U> bool operator==(const PsramAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const PsramAllocator<U>&) const { return false; }
+};
+
+template <class T>
+using PsramVector = std::vector<T, PsramAllocator<T>>;
+
+/// Class-scope operator new/delete placing instances in PSRAM
+#define PSRAM_OBJECT_ALLOC \
+    static void* operator new(size_t size) { \
+        void* p = psramAlloc(size); \
+        if (!p) abort(); \
+        return p; \
+    } \
+    static void operator delete(void* p) { psramFree(p); }
+
+// ============================================================================
+// ARENA
+// ============================================================================
+
+/**
+ * @brief Bump allocator over PSRAM chunks, freed only all at once
+ *
+ * For data rebuilt as a whole (e.g. the dial trie after a catalog load):
+ * allocate with alloc()/allocArray(), then reset() before the next build.
+ * Nothing is freed individually and nothing is constructed or destroyed —
+ * keep to trivially destructible types.
+ */
+class PsramArena {
+public:
+    explicit PsramArena(size_t chunkBytes = PSRAM_ARENA_CHUNK_BYTES) : chunkBytes(chunkBytes) {}
+    ~PsramArena() { reset(); }
+    PsramArena(const PsramArena&) = delete;
+    PsramArena& operator=(const PsramArena&) = delete;
+
+    /// Uninitialized bytes, or nullptr when out of memory
+    void* alloc(size_t bytes, size_t align = alignof(uint32_t));
+
+    template <class T>
+    T* allocArray(size_t count) {
+        return static_cast<T*>(alloc(count * sizeof(T), alignof(T)));
+    }
+
+    /// Free every chunk
+    void reset();
+
+    size_t used() const { return usedBytes; }          ///< Bytes handed out
+    size_t reserved() const { return reservedBytes; }  ///< Bytes held in chunks
+
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t size;                    // Usable bytes after the header
+        size_t used;
+    };
+
+    Chunk* chunks = nullptr;            // Newest first
+    size_t chunkBytes;
+    size_t usedBytes = 0;
+    size_t reservedBytes = 0;
+};
+
+// ============================================================================
+// HEAP STATISTICS
+// ============================================================================
+
+struct HeapStats {
+    uint32_t internalFree;
+    uint32_t internalLargest;           // Largest free block
+    uint32_t internalMinFree;           // Low-water mark since boot
+    uint32_t psramFree;
+    uint32_t psramLargest;
+    uint8_t  internalFragPct;           // 100 - largest / free
+};
+
+HeapStats sampleHeap();
+
+/// One line, e.g. "int 81234 free / 65524 largest (19% frag), min 60112; psram ..."
+int formatHeapStats(const HeapStats& s, char* out, size_t cap);
+
+#endif // PSRAM_ALLOC_H
@@ -0,0 +1,31 @@
+/**
+ * @file psram_json.h
+ * @brief ArduinoJson allocator that keeps JsonDocument pools in PSRAM
+ *
+ *   JsonDocument doc(psramJson());
+ *
+ * Separate from psram_alloc.h so code without ArduinoJson needn't pull it in.
+ *
+ * @date 2026
+ */
+
+#ifndef PSRAM_JSON_H
+#define PSRAM_JSON_H
+
+#include <ArduinoJson.h>
+#include "psram_alloc.h"
+
+class PsramJsonAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override { return psramAlloc(size); }
+    void deallocate(void* ptr) override { psramFree(ptr); }
+    void* reallocate(void* ptr, size_t newSize) override { return psramRealloc(ptr, newSize); }
+};
+
+/// Shared, stateless instance for JsonDocument constructors
+inline ArduinoJson::Allocator* psramJson() {
+    static PsramJsonAllocator allocator;
+    return &allocator;
+}
+
+#endif // PSRAM_JSON_H
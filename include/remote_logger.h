@@ -3,12 +3,24 @@
 #include <Arduino.h>
 #include <Print.h>
 #include <WiFiClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "lz4_block.h"
 
 /**
  * Remote Logger for ESP32
  * 
- * Sends logs via HTTP to a remote server over WireGuard/Tailscale VPN.
+ * Sends logs to a remote server over WireGuard/Tailscale VPN.
  * Each phone is identified by a configurable device ID.
+ *
+ * Lines are collected into frames of up to REMOTE_LOG_FRAME_BYTES, LZ4
+ * compressed and numbered, and kept in a PSRAM spool until the server
+ * acknowledges them. One long-lived sender task ships the spool: as binary
+ * frames over the persistent TCP stream when it's up, otherwise as JSON
+ * POSTs. A spool that fills while the server is unreachable drops its
+ * oldest frames; the server sees the gap in the sequence numbers.
+ * Metrics snapshots (metrics.h) share the spool and its numbering.
  * 
  * Usage:
  *   1. Configure REMOTE_LOG_SERVER and REMOTE_LOG_DEVICE_ID in platformio.ini
@@ -33,64 +45,133 @@
 #define REMOTE_LOG_FLUSH_INTERVAL_MS 5000  // Force flush every 5 seconds
 #endif
 
-#ifndef REMOTE_LOG_BUFFER_SIZE
-#define REMOTE_LOG_BUFFER_SIZE 4096  // Max buffer size before forced flush
+#ifndef REMOTE_LOG_FRAME_BYTES
+#define REMOTE_LOG_FRAME_BYTES 2048  // Text per frame (compression unit)
 #endif
 
+#ifndef REMOTE_LOG_SPOOL_BYTES
+#define REMOTE_LOG_SPOOL_BYTES 65536  // Unacknowledged frames, PSRAM (power of two)
+#endif
+
+#ifndef REMOTE_LOG_SPOOL_FALLBACK_BYTES
+#define REMOTE_LOG_SPOOL_FALLBACK_BYTES 8192  // Internal RAM spool without PSRAM
+#endif
+
+#ifndef REMOTE_LOG_POST_FRAMES
+#define REMOTE_LOG_POST_FRAMES 4  // Frames per HTTP POST
+#endif
+
+#ifndef REMOTE_LOG_TASK_PRIORITY
+#define REMOTE_LOG_TASK_PRIORITY 0  // Sender, core 0: below Goertzel
+#endif
+
+#ifndef REMOTE_LOG_HEAP_STATS_MS
+#define REMOTE_LOG_HEAP_STATS_MS 60000  // Heap/fragmentation line every minute (0 = off)
+#endif
+
+#define REMOTE_LOG_FRAME_LZ4 0x01  // Frame flag: payload is an LZ4 block
+#define REMOTE_LOG_FRAME_METRICS 0x02  // Frame flag: CBOR metrics snapshot (metrics.h), not log text
+
 /**
  * Remote Logger Print class
  * Add this to the Logger system to send logs remotely
  */
 class RemoteLoggerClass : public Print {
 private:
-    String logBuffer;
-    String preConnectBuffer;  // Logs captured before VPN is ready
-    String lineAssembleBuffer; // Partial line buffer for per-line filtering
-    int lineCount;
-    unsigned long lastFlushTime;
+    // Closed frame in the spool: header, then `len` bytes of payload
+    struct SpoolFrame {
+        uint32_t seq;
+        uint16_t rawLen;   // Text length
+        uint16_t len;      // Payload length (== rawLen when stored raw)
+        uint8_t flags;     // REMOTE_LOG_FRAME_LZ4
+        uint8_t reserved[3];
+    };
+
+    // One allocation, made on first write
+    struct Buffers {
+        char frame[REMOTE_LOG_FRAME_BYTES];                     // Frame being filled
+        uint8_t packed[LZ4_BLOCK_BOUND(REMOTE_LOG_FRAME_BYTES)];  // Compressor output
+        uint8_t wire[16 + LZ4_BLOCK_BOUND(REMOTE_LOG_FRAME_BYTES)];  // Sender's copy of a frame
+        char text[REMOTE_LOG_FRAME_BYTES];                      // Sender's decompressed text
+        uint8_t spool[1];                                       // _spoolBytes follow
+    };
+
+    Buffers* _buf;
+    uint32_t _spoolBytes;
+    SemaphoreHandle_t _lock;      // Frame, spool and their offsets
+    TaskHandle_t _shipTask;
+    size_t _frameLen;
+    size_t _lineStart;            // Start of the line being assembled in frame
+    unsigned long _frameStarted;  // millis() of the frame's first byte
+    uint32_t _nextSeq;            // Seq of the frame being filled
+    uint32_t _spoolHead;          // Free-running byte offsets into the spool
+    uint32_t _spoolTail;          // Oldest unacknowledged frame
+    uint32_t _sendOffset;         // Next frame to put on the TCP stream
+
+    // Counters for printStatus()
+    uint32_t _framesDropped;
+    uint32_t _framesAcked;
+    uint32_t _rawBytes;
+    uint32_t _packedBytes;
+    unsigned long _lastHeapStats;    // Sender task's last logHeapStats()
+
+    String _postBody;             // Sender task's JSON, reused
     char serverUrl[128];
     char deviceId[32];
     char bootId[16];     // Random hex per boot, used as session key
-    bool enabled;
+    volatile bool enabled;
     bool vpnRequired;  // Only send when VPN is connected
     bool bootSent;     // True after boot notification delivered
-    bool _streamingEnabled; // Runtime toggle for log streaming (debug_commands)
-    bool _postPending;      // True while an async POST is in flight
+    volatile bool _streamingEnabled; // Runtime toggle for log streaming (debug_commands)
     int _consecutiveFailures;        // POST failure counter (for backoff)
     unsigned long _backoffUntil;     // millis() timestamp before which we skip POSTs
 
-    // Persistent TCP log stream to server
+    // Persistent TCP log stream to server (sender task only)
     WiFiClient _serverSocket;
-    bool _serverTcpEnabled;          // Feature flag (NVS-stored)
-    bool _serverConnected;           // Outbound TCP to server is live
-    bool _serverIsTelnetClient;      // Server connected inbound to phone:23
+    volatile bool _serverTcpEnabled; // Feature flag (NVS-stored)
+    volatile bool _serverConnected;  // Outbound TCP to server is live
+    bool _serverMetrics;             // Server's ack offered metrics=1
+    volatile bool _serverIsTelnetClient; // Server connected inbound to phone:23
     char _serverHost[64];            // Extracted from serverUrl
     int _serverTcpPort;
     int _tcpConsecutiveFailures;
     unsigned long _tcpBackoffUntil;
 
-    static bool isDroppedRemoteLogLine(const String& line);
-    void trimLogBuffer();
-    void appendFilteredTo(String& targetBuffer, const uint8_t* buffer, size_t size, bool countLines);
+    static bool isDroppedRemoteLogLine(const char* line, size_t len);
+    bool allocateBuffers();
+    void spoolPayload(const uint8_t* data, size_t len, uint8_t flags);
+    void closeFrame(size_t len);
+    bool readFrame(uint32_t& offset, SpoolFrame& hdr, uint8_t* payload);
+    int decodeFrame(const SpoolFrame& hdr, const uint8_t* payload, char* text);
+    void ackThrough(uint32_t seq);
+    uint32_t closeDueFrame();
+    void logHeapStats();
     
-    bool buildLogsJson(String& out, const String& logs);
+    bool buildLogsJson(String& out, uint32_t& lastSeq);
     bool buildBootJson(String& out);
-
-    static void onLogPostDone(bool success, int statusCode, void* userData);
-    static void onBootPostDone(bool success, int statusCode, void* userData);
+    bool postJson(const String& body);
+    void postFailed();
 
     void parseServerHost();
     void maintainServerConnection();
     bool sendTcpHandshake();
+    void dropServerConnection();
+    void readServerAcks();
+    void sendFrames();
+    void postFrames();
+    void shipPending();
+    void startShipTask();
+    static void shipTaskMain(void* arg);
     
 public:
+    // Close the frame in progress and wake the sender
     void flush();
     RemoteLoggerClass();
     
     void begin(const char* server = nullptr, const char* deviceId = nullptr, bool requireVpn = true);
     void setServer(const char* server);
     void setDeviceId(const char* id);
-    void setEnabled(bool enable) { enabled = enable; }
+    void setEnabled(bool enable);
     bool isEnabled() const { return enabled; }
 
     void setStreamingEnabled(bool enable) { _streamingEnabled = enable; }
@@ -104,6 +185,13 @@ public:
     
     size_t write(uint8_t byte) override;
     size_t write(const uint8_t* buffer, size_t size) override;
+
+    /// Spool a binary metrics snapshot (≤ REMOTE_LOG_FRAME_BYTES) in sequence
+    /// with the log frames. Only the TCP stream carries it, and only to a
+    /// server that accepts metrics; HTTP batches skip it.
+    bool writeMetrics(const uint8_t* data, size_t len);
+
+    void printStatus();
     
     const char* getDeviceId() const { return deviceId; }
     const char* getServerUrl() const { return serverUrl; }
@@ -28,6 +28,22 @@
  */
 #define MAX_SPECIAL_COMMANDS 16    ///< Maximum number of configurable special commands
 
+/**
+ * @brief How long a complete sequence that longer ones extend ("91" when
+ * "911" exists) waits for another digit before it is taken as dialed
+ */
+#ifndef DTMF_AMBIGUOUS_MATCH_MS
+#define DTMF_AMBIGUOUS_MATCH_MS 1500
+#endif
+
+/**
+ * @brief Most keys a partial dial may still reach for their files to be
+ * fetched ahead (a prefix matching more than this predicts nothing useful)
+ */
+#ifndef DIAL_PREDICT_MAX_CANDIDATES
+#define DIAL_PREDICT_MAX_CANDIDATES 8
+#endif
+
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
@@ -80,6 +96,20 @@ void setMaxSequenceLength(int maxLength);
  */
 int getMaxSequenceLength();
 
+/**
+ * @brief Rebuild the dial index from the audio keys and special commands
+ *
+ * The index is also rebuilt on the next digit whenever either set has
+ * changed, so calling this after a catalog load only moves the work out
+ * of the first keypress.
+ */
+void rebuildDialIndex();
+
+/**
+ * @brief Print dial index size and the live match cursors
+ */
+void printDialIndexStatus();
+
 /**
  * @brief Simulate a DTMF digit for debug/testing purposes
  * @param digit The DTMF digit to simulate (0-9, *, #)
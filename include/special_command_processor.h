@@ -111,6 +111,18 @@ bool addSpecialCommand(const char *sequence, const char *description, void (*han
  */
 int getSpecialCommandCount();
 
+/**
+ * @brief Get the DTMF sequence of a special command
+ * @param index 0 .. getSpecialCommandCount() - 1
+ * @return The sequence, or nullptr if @p index is out of range
+ */
+const char* getSpecialCommandSequence(int index);
+
+/**
+ * @brief Changes whenever the command table is cleared or added to
+ */
+uint32_t getSpecialCommandsGeneration();
+
 /**
  * @brief Clear all special commands
  */
@@ -136,6 +148,27 @@ void processSpecialCommand(const char *sequence);
  */
 void performSDCardDebug();
 
+/**
+ * @brief Start rewriting fragmented cached clips as contiguous files
+ *
+ * Checks every clip under AUDIO_FILES_DIR and rewrites those whose FAT
+ * chain is in more than @p minFragments pieces. Runs from tickSDDefrag(),
+ * only while the phone is on-hook and nothing plays.
+ *
+ * @param minFragments Threshold; <= 0 uses SD_DEFRAG_MIN_FRAGMENTS
+ */
+void startSDDefrag(int minFragments);
+
+/**
+ * @brief Stop a running defragment, discarding the copy in progress
+ */
+void stopSDDefrag();
+
+/**
+ * @brief Advance a running defragment by one step (call from loop())
+ */
+void tickSDDefrag();
+
 // ============================================================================
 // DEFAULT COMMAND HANDLERS
 // ============================================================================
@@ -205,6 +238,11 @@ void executeEraseEEPROM();
  */
 void executeTailscaleStatus();
 
+/**
+ * @brief Sweep the keypad to recalibrate DTMF thresholds (saved to NVS)
+ */
+void executeCalibrateDtmf();
+
 // ============================================================================
 // EEPROM PERSISTENCE FUNCTIONS
 // ============================================================================
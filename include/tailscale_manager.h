@@ -20,6 +20,12 @@
  * 
  * For Tailscale users:
  *   Use the Tailscale admin panel to add a subnet router or get peer keys
+ *
+ * The tunnel is brought up and kept up by the VpnLink task (core 0, below
+ * Goertzel): wait for WiFi → NTP → resolve the peer → wg.begin() → probe
+ * through the tunnel until the handshake completes. A failed attempt or a
+ * tunnel that stops answering probes retries with exponential backoff, so
+ * recovery runs during calls without touching loop().
  */
 
 // Configuration defaults (override in platformio.ini build_flags)
@@ -31,15 +37,62 @@
 #define WIREGUARD_PEER_PORT 51820 // Default Tailscale WireGuard port
 #endif
 
+#ifndef TAILSCALE_TASK_STACK
+#define TAILSCALE_TASK_STACK 6144         // wg.begin() + DNS + probe connect
+#endif
+
+#ifndef TAILSCALE_TASK_PRIORITY
+#define TAILSCALE_TASK_PRIORITY 0         // VpnLink, core 0: below Goertzel
+#endif
+
+#ifndef TAILSCALE_NTP_TIMEOUT_MS
+#define TAILSCALE_NTP_TIMEOUT_MS 10000    // Then try the handshake anyway
+#endif
+
+#ifndef TAILSCALE_HANDSHAKE_TIMEOUT_MS
+#define TAILSCALE_HANDSHAKE_TIMEOUT_MS 15000
+#endif
+
+#ifndef TAILSCALE_BACKOFF_MIN_MS
+#define TAILSCALE_BACKOFF_MIN_MS 5000     // Doubles per failed attempt...
+#endif
+
+#ifndef TAILSCALE_BACKOFF_MAX_MS
+#define TAILSCALE_BACKOFF_MAX_MS 600000   // ...up to 10 minutes
+#endif
+
+// Handshake/health probe: a TCP connect through the tunnel (port 0 = off,
+// the tunnel counts as up once wg.begin() succeeds)
+#ifndef TAILSCALE_PROBE_IP
+#define TAILSCALE_PROBE_IP "10.253.0.1"   // WireGuard server's dnsmasq
+#endif
+
+#ifndef TAILSCALE_PROBE_PORT
+#define TAILSCALE_PROBE_PORT 53
+#endif
+
+#ifndef TAILSCALE_PROBE_TIMEOUT_MS
+#define TAILSCALE_PROBE_TIMEOUT_MS 1000
+#endif
+
+#ifndef TAILSCALE_PROBE_INTERVAL_MS
+#define TAILSCALE_PROBE_INTERVAL_MS 60000
+#endif
+
+#ifndef TAILSCALE_PROBE_FAILURES
+#define TAILSCALE_PROBE_FAILURES 3        // Consecutive misses before reconnecting
+#endif
+
 /**
- * Initialize the Tailscale/WireGuard VPN connection
+ * Start (or restart with new settings) the Tailscale/WireGuard VPN connection.
+ * Returns at once; the VpnLink task connects in the background.
  * 
  * @param localIp The local IP address for this device on the tailnet (e.g., "100.64.0.100")
  * @param privateKey The WireGuard private key for this device (base64)
  * @param peerEndpoint The endpoint address of the Tailscale peer (e.g., "relay.tailscale.com")
  * @param peerPublicKey The WireGuard public key of the peer (base64)
  * @param peerPort The WireGuard port (default: 41641)
- * @return true if connection initiated successfully
+ * @return true if the background connection was started
  */
 bool initTailscale(const char* localIp, 
                    const char* privateKey,
@@ -95,19 +148,16 @@ bool isTailscaleConnected();
 const char* getTailscaleIP();
 
 /**
- * Disconnect the WireGuard VPN
+ * Disconnect the WireGuard VPN (the VpnLink task closes the tunnel)
  */
 void disconnectTailscale();
 
 /**
- * Handle Tailscale connection maintenance (call in loop())
- * Handles reconnection, keepalives, etc.
+ * Report VpnLink connect/disconnect edges on core 1 (call in loop()):
+ * LED, connect/disconnect callbacks, periodic diagnostic line
  */
 void handleTailscaleLoop();
 
-// Set callback to check if reconnection should be skipped (e.g., during active call)
-void setTailscaleSkipCallback(bool (*callback)());
-
 // Type definition for Tailscale connection state callbacks
 typedef void (*TailscaleStateCallback)();
 
@@ -3,6 +3,8 @@
  * @brief Audio tone generators for synthesizing dial tones, ringback, etc.
  * 
  * This file contains:
+ * - Quarter-wave sine table and DDS lookup shared by all tone generators
+ * - BlockSoundGenerator: fillBlock() contract, readBytes() built on it
  * - ToneGenerator<N>: Generates N simultaneous sine waves (N = 1–4, compile-time)
  * - DualToneGenerator: Convenience alias for ToneGenerator<2> with two-arg constructor
  * - MultiToneGenerator: Type alias for ToneGenerator<4>
@@ -15,11 +17,110 @@
 
 #include <array>
 #include <memory>
+#include <math.h>
+#include <string.h>
 #include <config.h>
 #include "AudioTools/CoreAudio/AudioEffects/SoundGenerator.h"
 
 using namespace audio_tools;
 
+// ============================================================================
+// SINE TABLE (direct digital synthesis)
+// ============================================================================
+
+/// Quarter-wave table resolution: 2^9 steps per quarter, 2048 per cycle
+static constexpr int TONE_LUT_BITS = 9;
+static constexpr int TONE_LUT_SIZE = 1 << TONE_LUT_BITS;
+
+/**
+ * @brief Quarter sine wave in Q15, built once and shared by every generator
+ *
+ * Entry TONE_LUT_SIZE is sin(π/2); one extra entry lets the interpolation
+ * read idx + 1 without a bounds check.
+ */
+inline const int16_t* toneSineTable() {
+    static int16_t table[TONE_LUT_SIZE + 2];
+    static bool built = false;
+    if (!built) {
+        for (int i = 0; i <= TONE_LUT_SIZE; i++) {
+            table[i] = (int16_t)lrintf(32767.0f * sinf((float)M_PI_2 * i / TONE_LUT_SIZE));
+        }
+        table[TONE_LUT_SIZE + 1] = table[TONE_LUT_SIZE];
+        built = true;
+    }
+    return table;
+}
+
+/**
+ * @brief sin(2π · phase / 2^32) in Q15 from the quarter-wave table
+ *
+ * The top two phase bits pick the quadrant, the next 24 bits the position
+ * within it (9 table bits + 15 interpolation bits). Linear interpolation
+ * keeps spurs well below what the Goertzel detector can see.
+ */
+static inline int32_t toneSineQ15(const int16_t* lut, uint32_t phase) {
+    uint32_t quadrant = phase >> 30;
+    uint32_t pos = (phase >> 6) & 0xFFFFFF;
+    if (quadrant & 1) {
+        pos = 0x1000000 - pos;  // Falling half of each lobe: read the table backwards
+    }
+    uint32_t idx = pos >> 15;
+    int32_t frac = (int32_t)(pos & 0x7FFF);
+    int32_t a = lut[idx];
+    int32_t value = a + (((lut[idx + 1] - a) * frac) >> 15);
+    return (quadrant & 2) ? -value : value;
+}
+
+/// Phase increment per sample for @p freq Hz at @p sampleRate
+static inline uint32_t tonePhaseIncrement(float freq, int sampleRate) {
+    if (sampleRate <= 0) return 0;
+    return (uint32_t)((double)freq * 4294967296.0 / (double)sampleRate);
+}
+
+// ============================================================================
+// BLOCK GENERATOR
+// ============================================================================
+
+/**
+ * @brief SoundGenerator that renders whole blocks of mono samples
+ *
+ * Subclasses implement fillBlock(). readBytes() — what GeneratedSoundStream
+ * calls — is built on it, so a buffer costs one virtual call instead of one
+ * per sample. Multi-channel output is fanned out from the mono block.
+ */
+class BlockSoundGenerator : public SoundGenerator<int16_t> {
+public:
+    /**
+     * @brief Render @p samples mono samples into @p out
+     * @return Samples written (== samples for the generators in this file)
+     */
+    virtual size_t fillBlock(int16_t* out, size_t samples) = 0;
+
+    int16_t readSample() override {
+        int16_t sample = 0;
+        fillBlock(&sample, 1);
+        return sample;
+    }
+
+    size_t readBytes(uint8_t* data, size_t len) override {
+        int channels = audioInfo().channels > 0 ? audioInfo().channels : 1;
+        size_t frames = len / (sizeof(int16_t) * channels);
+        int16_t* out = reinterpret_cast<int16_t*>(data);
+        if (channels == 1) {
+            return fillBlock(out, frames) * sizeof(int16_t);
+        }
+        // Render mono into the tail of the buffer, then fan out front to back
+        // (each frame's writes stay below the mono samples still to be read)
+        int16_t* mono = out + frames * (channels - 1);
+        size_t n = fillBlock(mono, frames);
+        for (size_t f = 0; f < n; f++) {
+            int16_t sample = mono[f];
+            for (int ch = 0; ch < channels; ch++) *out++ = sample;
+        }
+        return n * sizeof(int16_t) * channels;
+    }
+};
+
 // ============================================================================
 // TONE GENERATOR (template — 1 to 4 simultaneous tones)
 // ============================================================================
@@ -31,13 +132,17 @@ using namespace audio_tools;
  * unroll the inner loops, giving the same performance as hand-written code
  * while sharing a single implementation.
  *
+ * Each tone is a 32-bit phase accumulator into the shared sine table, so a
+ * sample costs N table lookups and integer adds instead of N sinf() calls.
+ * fillBlock() renders the whole buffer in one loop.
+ *
  * Amplitude is automatically divided by N so the combined output never clips.
  *
  * Usage:
  *   ToneGenerator<3> gen(std::array<float, 3>{350.0f, 440.0f, 480.0f});
  */
 template<int N>
-class ToneGenerator : public SoundGenerator<int16_t> {
+class ToneGenerator : public BlockSoundGenerator {
     static_assert(N >= 1 && N <= 4, "ToneGenerator: N must be 1–4");
 public:
     /**
@@ -46,8 +151,9 @@ public:
      * @param amplitude Peak amplitude (default: 16000)
      */
     ToneGenerator(std::array<float, N> freqs, float amplitude = 16000.0f)
-        : m_amplitude(amplitude), m_sampleRate(AUDIO_SAMPLE_RATE) {
+        : m_lut(toneSineTable()), m_sampleRate(AUDIO_SAMPLE_RATE) {
         for (int i = 0; i < N; i++) m_freq[i] = freqs[i];
+        m_gain = (int32_t)lrintf(amplitude / N);
         recalcPhaseIncrements();
     }
 
@@ -55,31 +161,40 @@ public:
         SoundGenerator<int16_t>::begin(info);
         m_sampleRate = info.sample_rate;
         recalcPhaseIncrements();
-        for (int i = 0; i < N; i++) m_phase[i] = 0.0f;
+        for (int i = 0; i < N; i++) m_phase[i] = 0;
         return true;
     }
 
     void recalcPhaseIncrements() {
         for (int i = 0; i < N; i++)
-            m_phaseInc[i] = 2.0f * PI * m_freq[i] / (float)m_sampleRate;
+            m_phaseInc[i] = tonePhaseIncrement(m_freq[i], m_sampleRate);
     }
 
     int16_t readSample() override {
-        float sum = 0.0f;
+        return nextSample();
+    }
+
+    size_t fillBlock(int16_t* out, size_t samples) override {
+        for (size_t i = 0; i < samples; i++) out[i] = nextSample();
+        return samples;
+    }
+
+private:
+    inline int16_t nextSample() {
+        int32_t sum = 0;
         for (int i = 0; i < N; i++) {
-            sum += sinf(m_phase[i]);
-            m_phase[i] += m_phaseInc[i];
-            if (m_phase[i] >= 2.0f * PI) m_phase[i] -= 2.0f * PI;
+            sum += toneSineQ15(m_lut, m_phase[i]);
+            m_phase[i] += m_phaseInc[i];  // Wraps naturally at 2^32
         }
-        return (int16_t)(sum * (m_amplitude / N));
+        return (int16_t)((sum * m_gain) >> 15);
     }
 
-private:
-    float m_freq[N];         ///< Tone frequencies
-    float m_phaseInc[N] {};  ///< Phase increments per sample
-    float m_phase[N] {};     ///< Current phase accumulators
-    float m_amplitude;       ///< Peak amplitude
-    int m_sampleRate;        ///< Current sample rate
+    const int16_t* m_lut;       ///< Shared quarter-wave sine table
+    float m_freq[N];            ///< Tone frequencies
+    uint32_t m_phaseInc[N] {};  ///< Phase increments per sample (2^32 = one cycle)
+    uint32_t m_phase[N] {};     ///< Current phase accumulators
+    int32_t m_gain;             ///< Per-tone peak amplitude (amplitude / N)
+    int m_sampleRate;           ///< Current sample rate
 };
 
 // ============================================================================
@@ -120,12 +235,16 @@ using MultiToneGenerator = ToneGenerator<4>;
  * Wraps another tone generator and adds silence periods to create
  * repeating cadences. Useful for ringback tones, busy signals, etc.
  * 
+ * fillBlock() works a period at a time: silence is a memset, and a tone
+ * stretch is one readBytes() on the wrapped generator (begun as mono), which
+ * is itself a block fill for ToneGenerator. Cadence is kept in samples.
+ * 
  * Two construction modes:
  * - Non-owning (reference): for static generators (dialtone, ringback)
  * - Owning (unique_ptr): for dynamically-built generators from JSON
  */
 template<typename T>
-class RepeatingToneGenerator : public SoundGenerator<int16_t> {
+class RepeatingToneGenerator : public BlockSoundGenerator {
 public:
     /**
      * @brief Construct non-owning — wraps an externally-managed generator
@@ -150,7 +269,10 @@ public:
     bool begin(AudioInfo info) override {
         SoundGenerator<int16_t>::begin(info);
         m_sampleRate = info.sample_rate;
-        m_generator->begin(info);
+        // The wrapped generator renders mono blocks; readBytes() fans out channels
+        AudioInfo mono = info;
+        mono.channels = 1;
+        m_generator->begin(mono);
         recalcSampleCounts();
         reset();
         return true;
@@ -166,31 +288,44 @@ public:
         m_silenceSamples = (m_silenceDurationMs * m_sampleRate) / 1000;
     }
     
-    int16_t readSample() override {
-        int16_t sample = 0;
+    size_t fillBlock(int16_t* out, size_t samples) override {
+        if (m_toneSamples == 0 && m_silenceSamples == 0) {
+            return readTone(out, samples);  // No cadence — plain tone
+        }
         
-        if (m_inTonePeriod) {
-            sample = m_generator->readSample();
-            m_sampleCounter++;
-            
-            if (m_sampleCounter >= m_toneSamples) {
-                m_inTonePeriod = false;
+        size_t done = 0;
+        while (done < samples) {
+            unsigned long period = m_inTonePeriod ? m_toneSamples : m_silenceSamples;
+            if (m_sampleCounter >= period) {
+                m_inTonePeriod = !m_inTonePeriod;
                 m_sampleCounter = 0;
+                continue;
             }
-        } else {
-            sample = 0;
-            m_sampleCounter++;
             
-            if (m_sampleCounter >= m_silenceSamples) {
-                m_inTonePeriod = true;
-                m_sampleCounter = 0;
+            size_t n = samples - done;
+            if (n > period - m_sampleCounter) n = period - m_sampleCounter;
+            if (m_inTonePeriod) {
+                readTone(out + done, n);
+            } else {
+                memset(out + done, 0, n * sizeof(int16_t));
             }
+            done += n;
+            m_sampleCounter += n;
         }
-        
-        return sample;
+        return samples;
     }
     
 private:
+    // Tone stretch from the wrapped generator; pads a short read with silence
+    size_t readTone(int16_t* out, size_t samples) {
+        size_t got = m_generator->readBytes(reinterpret_cast<uint8_t*>(out),
+                                            samples * sizeof(int16_t)) / sizeof(int16_t);
+        if (got < samples) {
+            memset(out + got, 0, (samples - got) * sizeof(int16_t));
+        }
+        return samples;
+    }
+    
     std::unique_ptr<SoundGenerator<T>> m_ownedGenerator; ///< Owns the generator (if constructed with unique_ptr)
     SoundGenerator<T>* m_generator;       ///< Always valid — points to owned or external generator
     unsigned long m_toneDurationMs;       ///< Tone duration in milliseconds
@@ -198,6 +333,6 @@ private:
     int m_sampleRate;                     ///< Current sample rate
     unsigned long m_toneSamples;          ///< Number of samples for tone period
     unsigned long m_silenceSamples;       ///< Number of samples for silence period
-    unsigned long m_sampleCounter;        ///< Current sample position in period
-    bool m_inTonePeriod;                  ///< True if in tone period, false if in silence
+    unsigned long m_sampleCounter = 0;    ///< Current sample position in period
+    bool m_inTonePeriod = true;           ///< True if in tone period, false if in silence
 };
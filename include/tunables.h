@@ -0,0 +1,143 @@
+#pragma once
+/**
+ * @file tunables.h
+ * @brief Detector and pipeline parameters changed at runtime, kept in NVS
+ *
+ * Each tunable is a typed value with a range: a PhoneConfig field or a
+ * runtime cap below a compile-time buffer (audioCopyMaxBytes, WebQueue read
+ * sizes). set() changes the live value at once. Values read at each use take
+ * effect immediately. Others name an apply function that tick() runs on
+ * loop(): a threshold reload, or a Goertzel re-init for the window, hop and
+ * copier buffer. A re-init restarts the detector task, so it waits while the
+ * busy check (setBusyCheck) says the phone is in use.
+ *
+ * With save, set() also writes the value to NVS ("tunables" namespace, one
+ * key per tunable), and begin() loads it at the next boot before the
+ * subsystems start. reset() returns to the compiled default and erases it.
+ *
+ * A/B: startAb() alternates a tunable between two values every period,
+ * switching only while the phone is idle, and totals detector counters per
+ * value. When the rounds are done the previous value comes back and the
+ * comparison is logged. A/B values are never saved.
+ *
+ *   tunables.begin();                      // setup(), before initGoertzelDecoder()
+ *   tunables.set("g.detSnr", "9.5", true);
+ *   loopScheduler.add("tune", []() { tunables.tick(); }, 250, 8, 500);
+ *
+ * Console: `tune`; web: GET/POST /api/tune. loop() only.
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+
+#ifndef TUNE_PREFS_NAMESPACE
+#define TUNE_PREFS_NAMESPACE "tunables"
+#endif
+#ifndef TUNE_AB_PERIOD_MS
+#define TUNE_AB_PERIOD_MS 600000        // Default time on each value per A/B round
+#endif
+#ifndef TUNE_AB_ROUNDS
+#define TUNE_AB_ROUNDS 6                // Default A/B rounds (one period on each value)
+#endif
+
+enum class TuneType : uint8_t { INT, U32, FLOAT, BOOL };
+
+struct Tunable {
+    const char* key;        // Console/web name and NVS key (≤ 15 chars)
+    TuneType    type;
+    void*       value;      // Live storage, read by its subsystem
+    float       min;
+    float       max;
+    void      (*apply)();   // Runs after a change; nullptr = read at each use
+    bool        restart;    // apply() restarts a task: held while busy
+    const char* help;
+    float       def;        // Compiled default (captured by begin())
+    bool        stored;     // An NVS value is in effect
+};
+
+class TunableRegistry {
+public:
+    /// Capture defaults and apply stored values
+    void begin();
+
+    /// Phone-in-use predicate; restarts and A/B switches wait while it holds
+    void setBusyCheck(bool (*busy)()) { _busy = busy; }
+
+    /// Parse @p text for @p key, apply it and optionally save it.
+    /// False (and a log line) on an unknown key or a bad/out-of-range value.
+    bool set(const char* key, const char* text, bool save);
+
+    /// Back to the compiled default and out of NVS (nullptr = all)
+    bool reset(const char* key);
+
+    const Tunable* find(const char* key) const;
+    float get(const Tunable& t) const;
+
+    /// Pending apply functions and A/B switching (loop())
+    void tick();
+
+    /// Alternate @p key between @p a and @p b
+    bool startAb(const char* key, const char* a, const char* b,
+                 uint32_t periodMs = TUNE_AB_PERIOD_MS, int rounds = TUNE_AB_ROUNDS);
+    void stopAb();
+    bool abActive() const { return _ab.tunable != nullptr; }
+
+    void printStatus();
+    void printAb();
+    /// All tunables (and the A/B in progress) as JSON, for /api/tune
+    String json();
+
+private:
+    static constexpr int MAX_TUNABLES = 24;
+    static constexpr int MAX_PENDING = 4;
+
+    /// Detector counters an A/B arm is judged on
+    struct AbCounters {
+        uint32_t evaluations;
+        uint32_t detections;
+        uint32_t rejects;
+        uint32_t gated;
+        uint32_t overruns;
+    };
+    struct AbArm {
+        float value;
+        uint32_t ms;
+        AbCounters totals;
+    };
+    struct AbState {
+        Tunable* tunable = nullptr;
+        float original = 0;
+        AbArm arms[2];
+        int current = 0;
+        int periodsLeft = 0;
+        uint32_t periodMs = 0;
+        unsigned long armStartMs = 0;
+        AbCounters armStart = {};
+    };
+
+    Tunable _table[MAX_TUNABLES];
+    int _count = 0;
+    void (*_pending[MAX_PENDING])() = {};
+    bool _pendingRestart = false;
+    Tunable* _saveAfterRestart = nullptr;  // Saved by tick() if the restart took it
+    float _saveAfterRestartValue = 0;
+    bool (*_busy)() = nullptr;
+    AbState _ab;
+
+    Tunable* lookup(const char* key);
+    void add(const char* key, TuneType type, void* value, float min, float max,
+             void (*apply)(), bool restart, const char* help);
+    bool parse(const Tunable& t, const char* text, float& out) const;
+    void store(Tunable& t, float v);
+    bool saveValue(Tunable& t, float v);
+    void schedule(const Tunable& t);
+    void abSwitch(unsigned long now);
+    static AbCounters abSnapshot();
+    static void formatValue(const Tunable& t, float v, char* buf, size_t len);
+};
+
+extern TunableRegistry tunables;
+
+/// GET/POST /api/tune (WebServer*)
+void initTunableRoutes(void* server);
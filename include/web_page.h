@@ -0,0 +1,56 @@
+#pragma once
+/**
+ * @file web_page.h
+ * @brief Chunked WebServer responses and streamed page templates
+ *
+ * Pages are written to the client in 512-byte chunks instead of being built
+ * in one String, so a large page needs no large allocation on a fragmented
+ * heap. Templates live in flash; each %NAME% (capitals, digits, '_') is
+ * filled by a callback as the page streams out:
+ *
+ *   static void fill(const char* name, Print& out, void*) {
+ *       if (!strcmp(name, "IP")) out.print(WiFi.localIP());
+ *   }
+ *   sendPage(server, PAGE, fill);
+ *
+ * A '%' not followed by NAME% (e.g. CSS "width:100%") is copied as is.
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+#ifndef WEB_PAGE_CHUNK_BYTES
+#define WEB_PAGE_CHUNK_BYTES 512
+#endif
+
+/// Print adaptor that sends what it's given as HTTP chunks. The constructor
+/// sends the status line and headers; the destructor ends the response.
+class ChunkedResponse : public Print
+{
+public:
+    ChunkedResponse(WebServer& web, int code, const char* contentType);
+    ~ChunkedResponse();
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t len) override;
+    void flush() override;
+
+private:
+    WebServer& web;
+    char chunk[WEB_PAGE_CHUNK_BYTES];
+    size_t used = 0;
+};
+
+/// Prints the value of template field @p name
+typedef void (*PageFieldFn)(const char* name, Print& out, void* ctx);
+
+/// Stream template @p tmpl (flash), filling each %NAME% through @p fill
+void printPage(Print& out, const char* tmpl, PageFieldFn fill, void* ctx = nullptr);
+
+/// Send @p tmpl as a chunked text/html 200 response
+void sendPage(WebServer& web, const char* tmpl, PageFieldFn fill, void* ctx = nullptr);
+
+/// @p text escaped for an HTML body or a quoted attribute
+void printHtmlEscaped(Print& out, const char* text);
@@ -3,20 +3,42 @@
  * @file web_queue.h
  * @brief Cooperative chunked web request queue — runs entirely on core 1
  *
- * WebQueue processes HTTP GETs and POSTs one at a time using a cooperative
- * state machine.  Each call to tick() does at most one chunk of I/O
- * (~4 KB, ~2-4 ms) so the main loop can service audio playback, hook-switch
- * polling, and DTMF dispatch between chunks.
+ * WebQueue processes HTTP GETs and POSTs using a cooperative state machine
+ * with up to WEB_QUEUE_SLOTS requests in flight.  Each call to tick() reads
+ * at most WEB_QUEUE_TICK_BYTES across all slots (~4 KB, ~2-4 ms) so the
+ * main loop can service audio playback, hook-switch polling, and DTMF
+ * dispatch between chunks.
  *
- * There is NO FreeRTOS task — all work happens in the caller's context
- * (core 1), which eliminates SD card contention, registry races, and
- * Goertzel starvation.
+ * Slots lease their HttpClient from the shared pool (http_pool.h), which
+ * keeps the TCP/TLS connection open after an item finishes; a pending file
+ * on the same host is started on that warm connection, skipping DNS, TCP
+ * connect and the TLS handshake.
+ *
+ * All queue work happens in the caller's context (core 1), which
+ * eliminates registry races and Goertzel starvation.  The one exception is
+ * committing FILE_DL bodies to SD: each slot fills one half of a PSRAM
+ * double buffer from the network while a small writer task, also on
+ * core 1, writes the other half.  The SD_MMC driver waits for its DMA
+ * transfers, so loop() keeps running while a write is in flight.
  *
  * Three item types:
- *   FILE_DL    — GET a URL → write body to an SD card path (audio files)
- *   CATALOG_DL — GET a URL → accumulate body into a String → callback
+ *   FILE_DL    — GET a URL → write body to an SD card path (audio files).
+ *                The body goes to "<path>.tmp"; the server's ETag or
+ *                Last-Modified is kept beside it in "<path>.rng" so a
+ *                broken download resumes with Range/If-Range.  With a
+ *                Content-Length the file is preallocated to its full size
+ *                (contiguous clusters, so playback doesn't seek across
+ *                the card) and the finished file is checked against it.
+ *   CATALOG_DL — GET a URL → hand each chunk to a callback (or accumulate
+ *                the body into a String) → completion callback
  *   POST       — POST a body to a URL → callback with response status
  *
+ * Items are scheduled by Priority (INTERACTIVE > PREDICTED > CATALOG > LOG >
+ * PREFETCH).  A higher class starts first, gets the tick's read budget first,
+ * and when every slot is busy pauses a lower FILE_DL (kept as a partial and
+ * resumed later).  setSuspended(true) — used while the handset is off-hook —
+ * holds everything below PREDICTED so downloads don't compete with the call.
+ *
  * Usage:
  *   // in loop():
  *   webQueue.tick();   // ~0-4 ms per call
@@ -26,11 +48,13 @@
 #include <SD.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
+#include <freertos/task.h>
 #include "config.h"
 #include "logging.h"
 
 // Forward declaration
 class HttpClient;
+struct HttpValidators;
 
 #ifndef MAX_WEB_QUEUE
 #define MAX_WEB_QUEUE 8
@@ -41,23 +65,67 @@ class HttpClient;
 #ifndef WEB_QUEUE_CHUNK_SIZE
 #define WEB_QUEUE_CHUNK_SIZE 4096
 #endif
+#ifndef WEB_QUEUE_SLOTS
+#define WEB_QUEUE_SLOTS 2                              // Concurrent requests
+#endif
+#ifndef WEB_QUEUE_TICK_BYTES
+#define WEB_QUEUE_TICK_BYTES WEB_QUEUE_CHUNK_SIZE      // Read budget per tick(), all slots together
+#endif
+#ifndef WEB_QUEUE_WRITE_BUF_SIZE
+#define WEB_QUEUE_WRITE_BUF_SIZE 16384                 // Per half; a multiple of the FAT cluster size
+#endif
+#ifndef WEB_QUEUE_SD_WRITER
+#define WEB_QUEUE_SD_WRITER 1                          // 0 = write full halves inline in tick()
+#endif
+#ifndef WEB_QUEUE_WRITER_PRIORITY
+#define WEB_QUEUE_WRITER_PRIORITY 2                    // Above loopTask, below audio decode/output
+#endif
+#ifndef WEB_QUEUE_RESUME_RETRIES
+#define WEB_QUEUE_RESUME_RETRIES 3                     // Range retries of a broken FILE_DL before it fails
+#endif
+#ifndef WEB_QUEUE_PREALLOCATE
+#define WEB_QUEUE_PREALLOCATE 1                        // Allocate a FILE_DL's clusters from its Content-Length
+#endif
+
+// Read sizes in effect (runtime tunables "n.chunk", "n.tick"); a chunk
+// can't exceed the WEB_QUEUE_CHUNK_SIZE buffer
+extern int32_t webQueueChunkBytes;
+extern int32_t webQueueTickBytes;
+
+// Since boot (metrics.h reads them)
+struct WebQueueStats {
+    uint32_t completed;       // Downloads finished
+    uint32_t failed;          // Items given up on
+    uint32_t resumed;         // Broken downloads queued again from their partial
+    uint32_t bytes;           // Body bytes read
+};
 
 class WebQueue {
 public:
     // Completion callback for FILE_DL items.
-    // bytesWritten > 0 on success, <= 0 on failure.
+    // bytesWritten > 0 on success, <= 0 on failure; also called when the
+    // file turns out to be on SD already.
     // detectedExt may differ from the enqueued ext (Content-Type correction).
+    // checksum is the CRC-32 of the file, 0 if unknown (resumed after a reboot).
     using FileCallback = void(*)(
         const char* audioKey,
         const char* localPath,
         const char* detectedExt,
         int         bytesWritten,
+        uint32_t    checksum,
         void*       userData
     );
 
     // Completion callback for CATALOG_DL items.
-    // Called with the full accumulated response body on success.
-    using CatalogCallback = void(*)(bool success, const String& body, void* userData);
+    // Called with the full accumulated response body on success (empty
+    // when the body was streamed through a CatalogChunkCallback).  A 304 to
+    // a conditional request reports success with statusCode 304, no body
+    // and no chunks.
+    using CatalogCallback = void(*)(bool success, int statusCode, const String& body, void* userData);
+
+    // Per-chunk callback for streamed CATALOG_DL items.
+    // Return false to abort the download (completion reports failure).
+    using CatalogChunkCallback = bool(*)(const uint8_t* data, size_t len, void* userData);
 
     // Completion callback for POST items.
     // Called with success flag and HTTP status code.
@@ -65,29 +133,47 @@ public:
 
     enum class EnqueueResult { OK, ALREADY_QUEUED, QUEUE_FULL, BAD_INPUT };
 
+    // Scheduling class, lowest first
+    enum class Priority : uint8_t {
+        PREFETCH,      // background fill of files nobody is waiting for
+        LOG,           // POSTs
+        CATALOG,       // catalog refreshes
+        PREDICTED,     // a file the dial in progress may reach; runs while suspended
+        INTERACTIVE    // a file the caller is waiting for; runs while suspended
+    };
+
     WebQueue();
     ~WebQueue();
 
     // -- configuration (call before first tick) ------------------------------
     void setFileCallback(FileCallback cb, void* userData = nullptr);
-    void setRegistryMutex(SemaphoreHandle_t mutex);
 
     // -- queue operations ----------------------------------------------------
 
     // Enqueue a file download (audio file → SD card).
+    // Re-enqueueing a queued URL at a higher priority raises the item's
+    // priority; at INTERACTIVE a failed item is also re-armed.  From
+    // PREDICTED up, a full queue gives up its lowest pending file to make room.
     EnqueueResult enqueueFile(const char* audioKey,
                               const char* url,
                               const char* localPath,
-                              const char* ext = nullptr);
+                              const char* ext = nullptr,
+                              Priority priority = Priority::PREFETCH);
 
     // Enqueue a catalog download (URL → String → callback).
-    // Catalog items are processed before file items.
+    // With chunkCb the body is not accumulated: each chunk goes to chunkCb
+    // as it arrives, then cb reports success with an empty body.
+    // Catalog items run at Priority::CATALOG.
+    // With validators the GET is conditional on them, and a 200 overwrites
+    // them with the response's before the first chunk; the caller keeps
+    // them alive until cb and decides whether to keep the new ones.
     EnqueueResult enqueueCatalog(const char* url,
                                  CatalogCallback cb,
-                                 void* userData = nullptr);
+                                 void* userData = nullptr,
+                                 CatalogChunkCallback chunkCb = nullptr,
+                                 HttpValidators* validators = nullptr);
 
-    // Enqueue an HTTP POST.
-    // POST items have the same priority as catalogs (before file downloads).
+    // Enqueue an HTTP POST (Priority::LOG unless given).
     // extraHeaderName/Value: one optional custom header (e.g. X-Device-ID).
     EnqueueResult enqueuePost(const char* url,
                               const String& body,
@@ -95,30 +181,43 @@ public:
                               void* userData = nullptr,
                               const char* contentType = "application/json",
                               const char* extraHeaderName = nullptr,
-                              const char* extraHeaderValue = nullptr);
+                              const char* extraHeaderValue = nullptr,
+                              Priority priority = Priority::LOG);
 
     // Backwards-compatible alias for enqueueFile.
     EnqueueResult enqueue(const char* audioKey,
                           const char* url,
                           const char* localPath,
-                          const char* ext = nullptr) {
-        return enqueueFile(audioKey, url, localPath, ext);
+                          const char* ext = nullptr,
+                          Priority priority = Priority::PREFETCH) {
+        return enqueueFile(audioKey, url, localPath, ext, priority);
     }
 
     void clear();   // cancel all PENDING items
     void reset();   // cancel everything including active request
     void compact(); // reclaim DONE/FAILED/EMPTY slots, shift PENDING to front
 
+    // Hold items below PREDICTED: none start, and active ones stop
+    // reading (the server waits on TCP flow control) until resumed
+    void setSuspended(bool suspended);
+    bool isSuspended()   const { return _suspended; }
+
+    // Move every queued or active item at `from` to `to` (e.g. predictions
+    // the dial has ruled out back to PREFETCH); returns the number moved
+    int  demote(Priority from, Priority to);
+
     // -- status --------------------------------------------------------------
     int  pendingCount()  const;
     int  totalCount()    const;
     bool isEmpty()       const;
-    bool isActive()      const { return _activeIdx >= 0; }
+    bool isActive()      const { return _activeCount() > 0; }
     void listItems()     const;
+    WebQueueStats stats() const { return _stats; }
 
     // -- cooperative tick — call every loop() iteration ----------------------
-    // When idle: rate-limited to WEB_QUEUE_IDLE_INTERVAL_MS.
-    // When streaming: reads one chunk (~4 KB) and returns immediately.
+    // Starting items: rate-limited to WEB_QUEUE_IDLE_INTERVAL_MS, except right
+    // after an item completes.
+    // When streaming: reads up to WEB_QUEUE_TICK_BYTES and returns immediately.
     bool tick();
 
 private:
@@ -130,11 +229,18 @@ private:
         char            url[256];
         char            localPath[128];
         char            ext[8];
+        char            tmpPath[132];     // FILE_DL partial download, fixed at first start
         ItemType        type;
         ItemState       state;
+        Priority        priority;
+        uint8_t         resumeAttempts;   // FILE_DL retries from the partial
+        uint32_t        crc;              // CRC-32 of the partial's first crcBytes
+        long            crcBytes;         // (set when a partial is kept; 0 = unknown)
         // CATALOG_DL callback
         CatalogCallback catalogCb;
+        CatalogChunkCallback catalogChunkCb;
         void*           catalogUserData;
+        HttpValidators* catalogValidators;   // caller-owned, may be nullptr
         // POST fields
         String          postBody;
         PostCallback    postCb;
@@ -147,34 +253,89 @@ private:
     // -- queue ---------------------------------------------------------------
     Item              _items[MAX_WEB_QUEUE];
     int               _count     = 0;
-    SemaphoreHandle_t _regMutex  = nullptr;
 
     FileCallback      _fileCb         = nullptr;
     void*             _fileCbUserData = nullptr;
 
-    // -- active request state (persists across tick() calls) -----------------
-    HttpClient*       _http       = nullptr;   // heap-allocated, owned
-    File              _sdFile;                  // open SD file handle (.tmp path during download)
-    char              _tmpPath[132];            // .tmp download path (FILE_DL only)
-    int               _activeIdx  = -1;        // slot in _items[], or -1
-    int               _totalBytes = 0;
-    uint8_t           _headerBuf[12];          // first 12 bytes for magic detection
-    int               _headerLen  = 0;
-    String            _bodyAccum;              // accumulated body (CATALOG_DL / POST response)
+    // -- request slots (persist across tick() calls) -------------------------
+    struct Slot {
+        HttpClient*   http       = nullptr;   // leased from httpPool while a request is active
+        File          sdFile;                  // open SD file handle (item's .tmp path during download)
+        int           itemIdx    = -1;        // index in _items[], or -1 when idle
+        int           totalBytes = 0;
+        int           statusCode = 0;         // of the active response
+        uint8_t       headerBuf[12] = {0};    // first 12 bytes for magic detection
+        int           headerLen  = 0;
+        String        bodyAccum;              // accumulated body (CATALOG_DL without a chunk callback)
+        unsigned long idleSince  = 0;
+        bool          resumable  = false;      // FILE_DL has a validator: pausing keeps its progress
+        uint32_t      crc        = 0;          // FILE_DL CRC-32 of the bytes written so far...
+        bool          crcKnown   = false;      // ...unless resumed from a partial of unknown content
+        long          expectedBytes = -1;      // FILE_DL size from Content-Length, -1 if unknown
+        bool          preallocated  = false;   // .tmp already expectedBytes long (trim before resuming)
+        // FILE_DL write buffer: two halves of WEB_QUEUE_WRITE_BUF_SIZE in
+        // PSRAM, kept for HTTP_POOL_IDLE_MS after the slot goes idle
+        // (nullptr → write chunks directly)
+        uint8_t*      writeBuf   = nullptr;
+        int           writeHalf  = 0;          // half being filled from the network
+        int           writeFill  = 0;          // bytes in it
+        long          writeBase  = 0;          // file offset where that half starts
+        volatile bool writeBusy   = false;     // other half is with the writer task
+        volatile bool writeFailed = false;     // a write came up short
+    };
+    Slot              _slots[WEB_QUEUE_SLOTS];
+    int               _nextSlot = 0;           // round-robin start for streaming
+
+    // -- SD writer task ------------------------------------------------------
+    struct WriteJob {
+        Slot*          slot;
+        const uint8_t* data;
+        size_t         len;
+    };
+    QueueHandle_t     _writeJobs    = nullptr;
+    TaskHandle_t      _writerHandle = nullptr;
 
     // -- backoff -------------------------------------------------------------
     int               _consecutiveFailures = 0;
     unsigned long     _backoffUntil        = 0;
     unsigned long     _lastIdleTick        = 0;
+    bool              _startNow            = false;   // an item just completed
+    bool              _suspended           = false;
+    WebQueueStats     _stats               = {};
 
     // -- internal helpers ----------------------------------------------------
     void  _compact();
     bool  _startNext();
-    bool  _streamChunk();
-    void  _finishCurrent(bool ok);
-    void  _failCurrent();
-    void  _cleanupActive();
+    bool  _streamChunks();
+    int   _streamChunk(Slot& slot, uint8_t* buf, size_t maxBytes);
+    void  _finishSlot(Slot& slot, bool ok);
+    void  _failSlot(Slot& slot, bool keepPartial = false);
+    void  _releaseSlot(Slot& slot, bool keepConnection);
+    void  _closeIdleSlots(unsigned long now);
+    void  _freeWriteBuf(Slot& slot);
+    void  _returnClient(Slot& slot, bool keepConnection);
+    int   _activeCount() const;
+    int   _freeSlot();
     Item* _findNextPending();
+    bool  _held(Priority priority) const { return _suspended && priority < Priority::PREDICTED; }
+    bool  _topPending(Priority& top) const;
+    bool  _evictFor(Priority priority);
+    bool  _preemptFor(Priority priority);
+    void  _pauseSlot(Slot& slot);
+
+    // -- resumable FILE_DL partials ------------------------------------------
+    long  _partialSize(const Item& item, String& validator);
+    bool  _writeResumeMeta(const Item& item, HttpClient& http, bool preallocated);
+    bool  _trimPartial(const Item& item, long validBytes);
+    bool  _verifySize(Slot& slot);
+    void  _dropPartial(const Item& item);
+
+    // -- double-buffered SD writes -------------------------------------------
+    int   _writeRoom(const Slot& slot) const;
+    bool  _submitWrite(Slot& slot);
+    void  _drainWrites(Slot& slot, bool flush);
+    bool  _startWriter();
+    static void _writerTask(void* arg);
 };
 
 // Global singleton — defined in web_queue.cpp
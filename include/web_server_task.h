@@ -0,0 +1,84 @@
+#pragma once
+/**
+ * @file web_server_task.h
+ * @brief Serve the WebServer from its own task instead of loop()
+ *
+ * With WEB_SERVER_TASK (default) the "WebHttp" task (core 0, below Goertzel)
+ * runs handleClient(), so request parsing, uploads and slow clients never
+ * hold up loop() and a request is answered within a few ms rather than at
+ * the next maintenance tick. Handlers run on that task.
+ *
+ * Handlers that touch state loop() owns (SD card, audio, WiFi mode, logger
+ * streams, restart paths that must shut audio down first) are registered
+ * through onLoop(): from the web task they are queued to core 1, run from
+ * poll() in handleNetworkLoop(), and the web task waits for them.
+ *
+ *   server.on("/delete", HTTP_DELETE, webServerTask.onLoop(handleDelete));
+ *
+ * A handler with a slow response or an upload stream runs on the web task
+ * and hands only its loop-owned steps over with runOnLoop().
+ *
+ * With WEB_SERVER_TASK 0, or before start(), everything runs in place and
+ * handleNetworkLoop() polls handleClient() as before.
+ *
+ * @date 2026
+ */
+
+#include <Arduino.h>
+#include <WebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#ifndef WEB_SERVER_TASK
+#define WEB_SERVER_TASK 1               // 0 = poll handleClient() from loop()
+#endif
+#ifndef WEB_SERVER_TASK_STACK
+#define WEB_SERVER_TASK_STACK 8192      // Page streaming + upload handlers
+#endif
+#ifndef WEB_SERVER_TASK_PRIORITY
+#define WEB_SERVER_TASK_PRIORITY 0      // Below GoertzelTask (1) on core 0
+#endif
+#ifndef WEB_SERVER_IDLE_MS
+#define WEB_SERVER_IDLE_MS 5            // Sleep between handleClient() polls
+#endif
+
+class WebServerTask {
+public:
+    /// Start serving @p web from the task (routes registered and begin()
+    /// called first). No-op when already running or WEB_SERVER_TASK is 0.
+    bool start(WebServer& web);
+
+    bool running() const { return _task != nullptr; }
+
+    /// Wrap @p fn so that, on the web task, it runs on core 1
+    WebServer::THandlerFunction onLoop(WebServer::THandlerFunction fn);
+
+    /// Run just @p fn on core 1 and wait for it (in place off the web task).
+    /// For handlers whose response or upload stays on the web task.
+    void runOnLoop(const WebServer::THandlerFunction& fn);
+
+    /// Run handlers queued by onLoop() (core 1, from handleNetworkLoop)
+    void poll();
+
+    /// Held while the server is reconfigured (on(), begin()) from loop();
+    /// lock() keeps running poll() so a waiting handler can't deadlock it
+    void lock();
+    void unlock();
+
+private:
+    struct LoopCall {
+        const WebServer::THandlerFunction* fn;
+        TaskHandle_t waiter;
+    };
+
+    WebServer*        _web   = nullptr;
+    TaskHandle_t      _task  = nullptr;
+    QueueHandle_t     _calls = nullptr;
+    SemaphoreHandle_t _lock  = nullptr;
+
+    static void taskMain(void* arg);
+};
+
+extern WebServerTask webServerTask;
@@ -30,6 +30,24 @@ void setWiFiDisconnectCallback(WiFiDisconnectedCallback callback);
 #define WIFI_PORTAL_TIMEOUT 180
 #endif
 
+// Fast reconnect: reuse the last good BSSID/channel (skips the scan) and,
+// when WIFI_FAST_CONNECT_STATIC_IP is set, the last DHCP lease as a static
+// address - only after a soft reset (OTA, panic, brownout), from RTC memory.
+// After a power cycle the lease may have gone to another host, so the fast
+// connect uses DHCP. Falls back to a normal connect after
+// WIFI_FAST_CONNECT_TIMEOUT_MS.
+#ifndef WIFI_FAST_CONNECT
+#define WIFI_FAST_CONNECT 1
+#endif
+
+#ifndef WIFI_FAST_CONNECT_STATIC_IP
+#define WIFI_FAST_CONNECT_STATIC_IP 1
+#endif
+
+#ifndef WIFI_FAST_CONNECT_TIMEOUT_MS
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 3000
+#endif
+
 // OTA configuration - Use build flags or defaults
 #ifndef OTA_HOSTNAME
 #define OTA_HOSTNAME "bowie-phone"
@@ -65,7 +83,9 @@ String getSavedSSID();
 void setOtaPrepareTimeout();
 
 // Pull-based OTA - download and install firmware from URL (works over VPN)
-bool performPullOTA(const char* firmwareUrl);
+// in the background (ota_updater.h); the phone reboots into it when idle.
+// sha256Hex checks a plain firmware.bin; a compressed .ota carries its own.
+bool performPullOTA(const char* firmwareUrl, const char* sha256Hex = nullptr);
 
 // Global variables
 extern WebServer server;
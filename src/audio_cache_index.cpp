@@ -0,0 +1,332 @@
+#include "audio_cache_index.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+
+AudioCacheIndex& getAudioCacheIndex()
+{
+    static AudioCacheIndex index;
+    return index;
+}
+
+// ============================================================================
+// FILE LAYOUT
+// ============================================================================
+
+struct CacheIndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entrySize;          // sizeof(Entry), catches layout changes
+    uint32_t entryCount;
+    uint32_t clock;
+    uint32_t checksum;           // FNV-1a of the records
+};
+
+static uint32_t fnv1a(const uint8_t* data, size_t len, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t AudioCacheIndex::hashUrl(const char* url)
+{
+    return url ? fnv1a((const uint8_t*)url, strlen(url)) : 0;
+}
+
+// ============================================================================
+// STORAGE
+// ============================================================================
+
+AudioCacheIndex::~AudioCacheIndex()
+{
+    heap_caps_free(entries);
+}
+
+bool AudioCacheIndex::reserve(size_t capacity)
+{
+    if (capacity <= entryCapacity) {
+        return true;
+    }
+    size_t grown = entryCapacity ? entryCapacity * 2 : 64;
+    if (grown < capacity) grown = capacity;
+    Entry* moved = (Entry*)heap_caps_realloc(entries, grown * sizeof(Entry), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!moved) {
+        // No PSRAM: small caches fit internal RAM
+        moved = (Entry*)heap_caps_realloc(entries, grown * sizeof(Entry), MALLOC_CAP_8BIT);
+    }
+    if (!moved) {
+        Logger.printf("❌ Cache index: cannot grow to %u entries\n", (unsigned)grown);
+        return false;
+    }
+    entries = moved;
+    entryCapacity = grown;
+    return true;
+}
+
+int AudioCacheIndex::position(uint32_t hash) const
+{
+    size_t lo = 0, hi = entryCount;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (entries[mid].urlHash < hash) lo = mid + 1;
+        else hi = mid;
+    }
+    return (int)lo;
+}
+
+void AudioCacheIndex::removeAt(size_t i)
+{
+    total -= entries[i].size;
+    memmove(&entries[i], &entries[i + 1], (entryCount - i - 1) * sizeof(Entry));
+    entryCount--;
+    changed();
+}
+
+void AudioCacheIndex::changed()
+{
+    indexDirty = true;
+    lastChange = millis();
+}
+
+void AudioCacheIndex::clear()
+{
+    entryCount = 0;
+    total = 0;
+    clock = 0;
+    indexComplete = false;
+    changed();
+}
+
+void AudioCacheIndex::markComplete()
+{
+    if (indexComplete) return;
+    indexComplete = true;
+    changed();
+    Logger.printf("🗂️ Cache index built: %u file(s), %llu bytes\n",
+                  (unsigned)entryCount, (unsigned long long)total);
+}
+
+// ============================================================================
+// LOOKUP AND UPDATE
+// ============================================================================
+
+const AudioCacheIndex::Entry* AudioCacheIndex::find(const char* url) const
+{
+    uint32_t hash = hashUrl(url);
+    int i = position(hash);
+    return (size_t)i < entryCount && entries[i].urlHash == hash ? &entries[i] : nullptr;
+}
+
+bool AudioCacheIndex::add(const char* url, const char* path, uint32_t size, uint32_t checksum)
+{
+    if (!url || !path || strlen(path) >= AUDIO_CACHE_PATH_LENGTH) {
+        return false;
+    }
+    uint32_t hash = hashUrl(url);
+    // A catalog that moved a key to a new URL with the same filename
+    for (size_t j = 0; j < entryCount; j++) {
+        if (entries[j].urlHash != hash && strcmp(entries[j].path, path) == 0) {
+            removeAt(j);
+            break;
+        }
+    }
+    size_t i = position(hash);
+    if (i >= entryCount || entries[i].urlHash != hash) {
+        if (!reserve(entryCount + 1)) {
+            return false;
+        }
+        memmove(&entries[i + 1], &entries[i], (entryCount - i) * sizeof(Entry));
+        entryCount++;
+    } else {
+        total -= entries[i].size;
+    }
+    Entry& e = entries[i];
+    memset(&e, 0, sizeof(e));
+    e.urlHash = hash;
+    e.size = size;
+    e.lastPlayed = ++clock;
+    e.checksum = checksum;
+    strncpy(e.path, path, sizeof(e.path) - 1);
+    total += size;
+    changed();
+    return true;
+}
+
+bool AudioCacheIndex::touch(const char* url)
+{
+    Entry* e = const_cast<Entry*>(find(url));
+    if (!e) {
+        return false;
+    }
+    e->lastPlayed = ++clock;
+    changed();
+    return true;
+}
+
+bool AudioCacheIndex::forget(const char* url)
+{
+    const Entry* e = find(url);
+    if (!e) {
+        return false;
+    }
+    removeAt(e - entries);
+    return true;
+}
+
+// ============================================================================
+// EVICTION AND VERIFICATION
+// ============================================================================
+
+int AudioCacheIndex::evict(fs::FS& fs, uint64_t budget)
+{
+    int evicted = 0;
+    while (total > budget && entryCount > 0) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < entryCount; i++) {
+            if (entries[i].lastPlayed < entries[oldest].lastPlayed) oldest = i;
+        }
+        Logger.printf("🧹 Evicting %s (%u bytes, cache %llu/%llu)\n", entries[oldest].path,
+                      (unsigned)entries[oldest].size, (unsigned long long)total, (unsigned long long)budget);
+        fs.remove(entries[oldest].path);
+        removeAt(oldest);
+        evicted++;
+    }
+    return evicted;
+}
+
+int AudioCacheIndex::verify(fs::FS& fs)
+{
+    uint8_t buf[2048];
+    int dropped = 0;
+    for (size_t i = 0; i < entryCount; ) {
+        Entry& e = entries[i];
+        File f = fs.open(e.path, FILE_READ);
+        bool opened = (bool)f;
+        bool ok = opened && f.size() == e.size;
+        if (ok && e.checksum != 0) {
+            uint32_t crc = 0;
+            int n;
+            while ((n = f.read(buf, sizeof(buf))) > 0) {
+                crc = esp_rom_crc32_le(crc, buf, n);
+            }
+            ok = crc == e.checksum;
+        }
+        if (opened) f.close();
+        if (ok) {
+            i++;
+            continue;
+        }
+        Logger.printf("⚠️ Cache index: %s is %s — dropping\n", e.path, opened ? "corrupt" : "missing");
+        fs.remove(e.path);
+        removeAt(i);
+        dropped++;
+    }
+    return dropped;
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+bool AudioCacheIndex::load(fs::FS& fs, const char* path)
+{
+    entryCount = 0;
+    total = 0;
+    clock = 0;
+    indexComplete = false;
+    indexDirty = false;
+
+    File f = fs.open(path, FILE_READ);
+    if (!f) {
+        return false;
+    }
+    CacheIndexHeader header = {};
+    bool ok = f.read((uint8_t*)&header, sizeof(header)) == sizeof(header)
+           && header.magic == AUDIO_CACHE_INDEX_MAGIC
+           && header.version == AUDIO_CACHE_INDEX_VERSION
+           && header.entrySize == sizeof(Entry)
+           && f.size() == sizeof(header) + (size_t)header.entryCount * sizeof(Entry)
+           && reserve(header.entryCount);
+    if (ok) {
+        size_t bytes = (size_t)header.entryCount * sizeof(Entry);
+        ok = f.read((uint8_t*)entries, bytes) == bytes
+          && fnv1a((const uint8_t*)entries, bytes) == header.checksum;
+    }
+    f.close();
+    if (!ok) {
+        Logger.printf("⚠️ Cache index %s unusable — rebuilding\n", path);
+        return false;
+    }
+
+    entryCount = header.entryCount;
+    clock = header.clock;
+    for (size_t i = 0; i < entryCount; i++) {
+        entries[i].path[AUDIO_CACHE_PATH_LENGTH - 1] = '\0';
+        total += entries[i].size;
+    }
+    indexComplete = true;
+    Logger.printf("🗂️ Cache index: %u file(s), %llu bytes\n", (unsigned)entryCount, (unsigned long long)total);
+    return true;
+}
+
+bool AudioCacheIndex::save(fs::FS& fs, const char* path)
+{
+    // Written only once complete: a partial index would read as complete next boot
+    if (!indexComplete) {
+        return false;
+    }
+    CacheIndexHeader header = {};
+    header.magic = AUDIO_CACHE_INDEX_MAGIC;
+    header.version = AUDIO_CACHE_INDEX_VERSION;
+    header.entrySize = sizeof(Entry);
+    header.entryCount = entryCount;
+    header.clock = clock;
+    header.checksum = fnv1a((const uint8_t*)entries, entryCount * sizeof(Entry));
+
+    char tmpPath[72];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    File f = fs.open(tmpPath, FILE_WRITE);
+    if (!f) {
+        Logger.printf("⚠️ Cannot create %s\n", tmpPath);
+        return false;
+    }
+    size_t expected = sizeof(header) + entryCount * sizeof(Entry);
+    size_t written = f.write((const uint8_t*)&header, sizeof(header));
+    if (entryCount > 0) {
+        written += f.write((const uint8_t*)entries, entryCount * sizeof(Entry));
+    }
+    f.close();
+
+    if (written != expected) {
+        fs.remove(tmpPath);
+        Logger.printf("⚠️ Cache index write failed (%u/%u bytes)\n", (unsigned)written, (unsigned)expected);
+        return false;
+    }
+    if (fs.exists(path)) fs.remove(path);
+    if (!fs.rename(tmpPath, path)) {
+        fs.remove(tmpPath);
+        Logger.printf("⚠️ Cannot rename %s\n", tmpPath);
+        return false;
+    }
+    indexDirty = false;
+    Logger.debugf("💾 Cache index: %u file(s) → %s\n", (unsigned)entryCount, path);
+    return true;
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+void AudioCacheIndex::printStatus(uint64_t budget) const
+{
+    Logger.printf("🗂️ Cache index: %u file(s), %llu/%llu bytes%s%s\n", (unsigned)entryCount,
+                  (unsigned long long)total, (unsigned long long)budget,
+                  indexComplete ? "" : ", rebuilding", indexDirty ? ", unsaved" : "");
+    for (size_t i = 0; i < entryCount; i++) {
+        const Entry& e = entries[i];
+        Logger.printf("   %08lx %-40s %8u bytes, played %lu ago, crc %08lx\n", (unsigned long)e.urlHash, e.path,
+                      (unsigned)e.size, (unsigned long)(clock - e.lastPlayed), (unsigned long)e.checksum);
+    }
+}
@@ -0,0 +1,132 @@
+#include "audio_copy_meter.h"
+#include "logging.h"
+
+int32_t audioCopyMaxBytes = AUDIO_COPY_BUFFER_SIZE;
+
+// ============================================================================
+// OUTPUT STAGE
+// ============================================================================
+
+size_t AudioWriteMeter::write(const uint8_t* data, size_t len)
+{
+    if (!_output) {
+        return 0;
+    }
+    uint32_t start = micros();
+    size_t written = _output->write(data, len);
+    _blockedUs += micros() - start;
+    _bytes += written;
+    return written;
+}
+
+void AudioWriteMeter::setAudioInfo(AudioInfo info)
+{
+    AudioStream::setAudioInfo(info);
+    _format = info;
+    if (_output) {
+        _output->setAudioInfo(info);
+    }
+}
+
+// ============================================================================
+// METER
+// ============================================================================
+
+void AudioCopyMeter::beginStream(const char* key)
+{
+    streamStats = {};
+    strncpy(streamKey, key ? key : "", sizeof(streamKey) - 1);
+    streamKey[sizeof(streamKey) - 1] = '\0';
+}
+
+void AudioCopyMeter::startCopy()
+{
+    if (resetRequested) {
+        totalStats = {};
+        streamStats = {};
+        resetRequested = false;
+    }
+    startPcm = stage.bytes();
+    startBlockedUs = stage.blockedUs();
+    startUs = micros();
+}
+
+void AudioCopyMeter::endCopy(size_t bytesIn)
+{
+    uint32_t us = micros() - startUs;
+    uint32_t pcm = stage.bytes() - startPcm;
+    uint32_t blocked = stage.blockedUs() - startBlockedUs;
+    add(streamStats, us, bytesIn, pcm, blocked);
+    add(totalStats, us, bytesIn, pcm, blocked);
+
+    // AIMD: back off hard when over budget, creep up while well under it
+    if (us > AUDIO_COPY_BUDGET_US) {
+        copyBytes = max((size_t)AUDIO_COPY_MIN_BYTES, copyBytes / 2);
+    } else if (us < AUDIO_COPY_BUDGET_US / 2 && bytesIn >= copyBytes) {
+        // Only grow when the whole chunk was used; a short read says nothing about cost
+        copyBytes = min((size_t)audioCopyMaxBytes, copyBytes + AUDIO_COPY_STEP_BYTES);
+    }
+}
+
+void AudioCopyMeter::add(AudioCopyStats& s, uint32_t us, size_t bytesIn, uint32_t pcm, uint32_t blocked)
+{
+    s.copies++;
+    if (bytesIn == 0) {
+        s.idleCopies++;
+    }
+    s.bytesIn += bytesIn;
+    s.pcmOut += pcm;
+    s.copyUs += us;
+    s.blockedUs += blocked;
+    if (us > s.copyMaxUs) {
+        s.copyMaxUs = us;
+    }
+    if (us > AUDIO_COPY_BUDGET_US) {
+        s.overBudget++;
+    }
+    int bucket = 0;
+    uint32_t limit = AUDIO_COPY_HISTOGRAM_FIRST_US;
+    while (us >= limit && bucket < AUDIO_COPY_HISTOGRAM_BUCKETS - 1) {
+        limit <<= 1;
+        bucket++;
+    }
+    s.duration[bucket]++;
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+void AudioCopyMeter::printLine(const char* label, const AudioCopyStats& s, const AudioInfo& info)
+{
+    uint32_t bytesPerMs = info.sample_rate * info.channels * (info.bits_per_sample / 8) / 1000;
+    uint32_t audioMs = bytesPerMs ? s.pcmOut / bytesPerMs : 0;
+    uint64_t decodeUs = s.copyUs > s.blockedUs ? s.copyUs - s.blockedUs : 0;
+
+    Logger.printf("   %s: %u copies (%u idle), %u bytes in, %u bytes PCM out (%u ms of audio)\n",
+                  label, s.copies, s.idleCopies, s.bytesIn, s.pcmOut, audioMs);
+    Logger.printf("     Decode %u µs per 10 ms of audio (%u%% of real time), write blocked %u ms total\n",
+                  audioMs ? (unsigned)(decodeUs * 10 / audioMs) : 0,
+                  audioMs ? (unsigned)(decodeUs / 10 / audioMs) : 0,
+                  (unsigned)(s.blockedUs / 1000));
+    Logger.printf("     copy() mean/max=%u/%u µs, %u over %u µs budget\n",
+                  s.copies ? (unsigned)(s.copyUs / s.copies) : 0, s.copyMaxUs,
+                  s.overBudget, (unsigned)AUDIO_COPY_BUDGET_US);
+    Logger.printf("     Duration (<%uµs, doubling):", (unsigned)AUDIO_COPY_HISTOGRAM_FIRST_US);
+    for (int i = 0; i < AUDIO_COPY_HISTOGRAM_BUCKETS; i++) Logger.printf(" %u", s.duration[i]);
+    Logger.println();
+}
+
+void AudioCopyMeter::printStats() const
+{
+    AudioInfo info = stage.format();
+    Logger.printf("⏱️ Audio copy: chunk %u bytes (%u–%u), %dHz/%dch\n", (unsigned)copyBytes,
+                  (unsigned)AUDIO_COPY_MIN_BYTES, (unsigned)AUDIO_COPY_BUFFER_SIZE,
+                  (int)info.sample_rate, (int)info.channels);
+    AudioCopyStats stream = streamStats;
+    AudioCopyStats total = totalStats;
+    char label[80];
+    snprintf(label, sizeof(label), "Stream '%s'", streamKey[0] ? streamKey : "(none)");
+    printLine(label, stream, info);
+    printLine("Since reset", total, info);
+}
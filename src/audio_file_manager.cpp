@@ -16,17 +16,24 @@
 #if ENABLE_PLAYLIST_FEATURES
 #include "audio_playlist_registry.h"
 #endif
+#include "sequence_processor.h"
 #include "tone_generators.h"
 #include "file_utils.h"
 #include "logging.h"
 #include <WiFi.h>
-#include "http_utils.h"
-#include <ArduinoJson.h>
+#include "http_pool.h"
+#include "catalog_stream_parser.h"
+#include "catalog_snapshot.h"
+#include "audio_cache_index.h"
+#include "psram_json.h"
 #include <SD.h>
 #include <SD_MMC.h>
 #include <FS.h>
 #include <SPI.h>
-#include <set>
+#include <Preferences.h>
+#include <vector>
+#include <map>
+#include <algorithm>
 #if SD_USE_MMC
   #include "AudioTools/Disk/AudioSourceSDMMC.h"
 #else
@@ -41,12 +48,18 @@
   #define SD_OPEN(path, mode)   SD_MMC.open(path, mode)
   #define SD_MKDIR(path)        SD_MMC.mkdir(path)
   #define SD_REMOVE(path)       SD_MMC.remove(path)
+  #define SD_RENAME(from, to)   SD_MMC.rename(from, to)
+  #define SD_TOTAL_BYTES()      SD_MMC.totalBytes()
+  #define SD_USED_BYTES()       SD_MMC.usedBytes()
 #else
   #define SD_CARD     ((fs::FS&)SD)
   #define SD_EXISTS(path)       SD.exists(path)
   #define SD_OPEN(path, mode)   SD.open(path, mode)
   #define SD_MKDIR(path)        SD.mkdir(path)
   #define SD_REMOVE(path)       SD.remove(path)
+  #define SD_RENAME(from, to)   SD.rename(from, to)
+  #define SD_TOTAL_BYTES()      SD.totalBytes()
+  #define SD_USED_BYTES()       SD.usedBytes()
 #endif
 
 // ============================================================================
@@ -64,21 +77,23 @@
 static unsigned long lastCacheTime = 0;
 static unsigned long lastCacheCheck = 0;  // Last lightweight cache check time
 static char cachedEtag[64] = {0};         // Cached ETag/lastModified for quick validation
+static HttpValidators catalogValidators;  // HTTP validators of the catalog we hold
+static HttpValidators fetchValidators;    // Sent with, and filled by, the catalog GET in flight
+static bool catalogForceFull = false;     // Next catalog GET ignores the validators
 static bool sdCardAvailable = false;  // True if SD card is mounted and accessible
 static bool sdCardInitFailed = false; // True if SD init was attempted and failed (don't retry)
 static bool spiInitialized = false;   // True after SPI.begin() has been called
 
-// DNS cache for use after WireGuard breaks public DNS
-static IPAddress cachedGitHubIP;
-static bool dnsPreCached = false;
-
-// Registry mutex — kept for download queue re-registration serialisation
-static SemaphoreHandle_t registryMutex = nullptr;
-
 // True while a catalog download is in flight (prevents duplicate enqueue)
 static bool catalogDownloadPending = false;
 
+// Published registry. Catalog loads and re-registrations build a draft
+// (beginUpdate()) and publish it whole, so playback never sees half a load.
 static AudioKeyRegistry &audioKeyRegistry = AudioKeyRegistry::instance;
+
+// Which URLs are on SD: existence checks are lookups here, not FAT walks
+static AudioCacheIndex &cacheIndex = getAudioCacheIndex();
+static uint64_t cacheBudget = AUDIO_CACHE_BUDGET_BYTES;  // Set by updateCacheBudget()
 #if ENABLE_PLAYLIST_FEATURES
     // Registry references (initialized on first use)
 static AudioPlaylistRegistry &playlistRegistry = getAudioPlaylistRegistry();
@@ -177,28 +192,6 @@ static bool initializeSDCard()
 #endif
 }
 
-/**
- * @brief Check if audio file exists locally on SD card
- * @param url Original URL
- * @param ext File extension (e.g., "wav", "mp3") - can be NULL
- * @return true if file exists locally, false otherwise
- */
-static bool audioFileExists(const char* url, const char* ext = nullptr)
-{
-    if (!initializeSDCard())
-    {
-        return false;
-    }
-    
-    char localPath[128];
-    if (!getLocalPathForUrl(url, localPath, ext))
-    {
-        return false;
-    }
-    
-    return SD_EXISTS(localPath);
-}
-
 /**
  * @brief Ensure the AUDIO_FILES_DIR exists, creating intermediate dirs if needed
  */
@@ -261,22 +254,204 @@ static bool ensureAudioDirExists()
  * @param url URL to download
  * @param audioKey Registry key for this file (used for logging and re-registration)
  * @param ext File extension hint (e.g., "wav", "mp3") — may be corrected by Content-Type
+ * @param priority Scheduling class (background prefetch unless someone is waiting)
  * @return true if added successfully, false otherwise
  */
-static bool addToDownloadQueue(const char* url, const char* audioKey, const char* ext = nullptr)
+static bool addToDownloadQueue(const char* url, const char* audioKey, const char* ext = nullptr,
+                               WebQueue::Priority priority = WebQueue::Priority::PREFETCH)
 {
     char localPath[128];
     if (!getLocalPathForUrl(url, localPath, ext)) {
         Logger.printf("❌ Failed to generate local path for: %s\n", url);
         return false;
     }
-    auto result = webQueue.enqueue(audioKey, url, localPath, ext);
+    auto result = webQueue.enqueue(audioKey, url, localPath, ext, priority);
     return result == WebQueue::EnqueueResult::OK ||
            result == WebQueue::EnqueueResult::ALREADY_QUEUED;
 }
 
+/**
+ * @brief Re-register a key under the extension its cached file really has
+ *
+ * Its own one-key update: callers are walking the published registry.
+ */
+static void reregisterCachedKey(const char* audioKey, const char* url, const char* ext)
+{
+    AudioKeyRegistry* draft = audioKeyRegistry.beginUpdate();
+    if (!draft) return;
+    draft->registerKey(audioKey, url, ext);
+    audioKeyRegistry.commitUpdate(draft);
+}
+
+/**
+ * @brief WebQueue file callback: index each file that lands on SD
+ *
+ * Covers downloads and files found already there (such as those the URL
+ * stream wrote through while playing).
+ */
+static void onAudioFileStored(const char* audioKey, const char* localPath, const char* detectedExt,
+                              int bytesWritten, uint32_t checksum, void* userData)
+{
+    (void)detectedExt;
+    (void)userData;
+    if (bytesWritten <= 0 || !audioKey || !localPath)
+    {
+        return;
+    }
+    const AudioEntry* entry = audioKeyRegistry.getEntry(audioKey);
+    FileData* f = entry ? entry->getFile() : nullptr;
+    if (f && !f->alternatePath.empty())
+    {
+        cacheIndex.add(f->alternatePath.c_str(), localPath, (uint32_t)bytesWritten, checksum);
+    }
+}
+
+/**
+ * @brief Size the cache budget to the card
+ *
+ * AUDIO_CACHE_BUDGET_BYTES, less whatever would leave the card with under
+ * AUDIO_CACHE_MIN_FREE_BYTES free once everything that isn't cached audio
+ * is counted. Reading the card's usage can take a while, so this runs
+ * when the index is loaded or built, not per download.
+ */
+static void updateCacheBudget()
+{
+    uint64_t cardBytes = SD_TOTAL_BYTES();
+    if (cardBytes == 0)
+    {
+        return;  // Unknown: keep the configured budget
+    }
+    uint64_t usedBytes = SD_USED_BYTES();
+    uint64_t otherBytes = usedBytes > cacheIndex.totalBytes() ? usedBytes - cacheIndex.totalBytes() : 0;
+    uint64_t room = cardBytes > otherBytes + AUDIO_CACHE_MIN_FREE_BYTES
+                  ? cardBytes - otherBytes - AUDIO_CACHE_MIN_FREE_BYTES : 0;
+    cacheBudget = min((uint64_t)AUDIO_CACHE_BUDGET_BYTES, room);
+    Logger.printf("🗂️ Cache budget %llu MB (card %llu MB, %llu MB not audio)\n",
+                  (unsigned long long)(cacheBudget >> 20), (unsigned long long)(cardBytes >> 20),
+                  (unsigned long long)(otherBytes >> 20));
+}
+
+/**
+ * @brief Look for an entry's file on the card while the index is rebuilt
+ * @return true if found (and now indexed)
+ *
+ * Tries the registry's extension, then the others a download may have
+ * corrected it to (re-registering the key with the one found). A file
+ * cached by firmware from before sharding is moved into its shard.
+ */
+static bool adoptCachedFile(const AudioEntry& entry)
+{
+    FileData* f = entry.getFile();
+    const char* url = f->alternatePath.c_str();
+    const char* ext = f->ext.c_str();
+
+    static const char* knownExts[] = {"wav", "mp3", "m4a", "aac", "ogg", "flac"};
+    char firstPath[128] = {0};
+    for (int i = -1; i < 6; i++)
+    {
+        const char* tryExt = i < 0 ? ext : knownExts[i];
+        // Skip the extension we already checked first
+        if (i >= 0 && ext && strcmp(ext, tryExt) == 0) continue;
+
+        char path[128];
+        if (!getLocalPathForUrl(url, path, tryExt)) continue;
+        if (i < 0) strcpy(firstPath, path);
+        else if (strcmp(path, firstPath) == 0) continue;  // URL names the file; ext doesn't change it
+
+        if (!SD_EXISTS(path))
+        {
+            char flat[128];
+            if (!getUnshardedPathForUrl(url, flat, tryExt) || strcmp(flat, path) == 0 || !SD_EXISTS(flat))
+            {
+                continue;
+            }
+            char dir[128];
+            strcpy(dir, path);
+            *strrchr(dir, '/') = '\0';
+            if (!SD_EXISTS(dir)) SD_MKDIR(dir);
+            if (!SD_RENAME(flat, path))
+            {
+                Logger.printf("⚠️ Cannot move %s into %s\n", flat, dir);
+                continue;
+            }
+            Logger.debugf("📁 Moved %s → %s\n", flat, path);
+        }
+
+        File file = SD_OPEN(path, FILE_READ);
+        uint32_t size = file ? (uint32_t)file.size() : 0;
+        if (file) file.close();
+        cacheIndex.add(url, path, size, 0);
+
+        if (i >= 0)
+        {
+            Logger.printf("🔄 Found cached file for '%s' with ext '%s' (registry had '%s'), re-registering\n",
+                          entry.audioKey.c_str(), tryExt, ext ? ext : "(none)");
+            reregisterCachedKey(entry.audioKey.c_str(), url, tryExt);
+        }
+        return true;
+    }
+
+    // The registry's own path, in case it was updated before its ext was
+    if (!f->path.empty() && SD_EXISTS(f->path.c_str()))
+    {
+        File file = SD_OPEN(f->path.c_str(), FILE_READ);
+        uint32_t size = file ? (uint32_t)file.size() : 0;
+        if (file) file.close();
+        cacheIndex.add(url, f->path.c_str(), size, 0);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether an entry's file is already on SD
+ * @return true if cached (or the entry has no URL source to download)
+ *
+ * An index lookup; only while the index is being rebuilt does a miss go to
+ * the card. A file the index has under a different extension (the catalog
+ * said .wav but the download detected audio/mp4 and saved .m4a) is
+ * re-registered with the actual extension so the player finds it.
+ */
+static bool isAudioEntryCached(const AudioEntry& entry)
+{
+    // Only entries that have a streaming URL (means original was a URL) download
+    FileData* f = entry.getFile();
+    if (!f || f->alternatePath.empty())
+    {
+        return true;
+    }
+    const char* url = f->alternatePath.c_str();
+
+    const AudioCacheIndex::Entry* cached = cacheIndex.find(url);
+    if (cached)
+    {
+        const char* dot = strrchr(cached->path, '.');
+        if (dot && f->ext != dot + 1)
+        {
+            Logger.printf("🔄 '%s' is cached as %s, re-registering\n", entry.audioKey.c_str(), cached->path);
+            reregisterCachedKey(entry.audioKey.c_str(), url, dot + 1);
+        }
+        return true;
+    }
+    if (cacheIndex.complete())
+    {
+        return false;  // The index covers the card
+    }
+    return adoptCachedFile(entry);
+}
+
+static uint32_t dialScore(const char* audioKey);
+
 /**
  * @brief Queue downloads for any missing HTTP/HTTPS audio files from the registry
+ *
+ * Most-dialed keys first, so the files callers actually reach for fill the
+ * queue's MAX_WEB_QUEUE places before the rest of the catalog. Background
+ * fill stops at AUDIO_CACHE_PREFETCH_PERCENT of the cache budget, so files
+ * evicted for space aren't fetched straight back.
+ *
+ * The first pass after the cache index was lost probes the card for every
+ * key and completes the index.
  */
 static void enqueueMissingAudioFilesFromRegistry()
 {
@@ -292,60 +467,34 @@ static void enqueueMissingAudioFilesFromRegistry()
         return;
     }
 
-    int queued = 0;
-
+    std::vector<std::pair<uint32_t, const AudioEntry*>> missing;
     for (const auto& pair : audioKeyRegistry)
     {
-        const AudioEntry& entry = pair.second;
-        
-        // Only queue entries that have a streaming URL (means original was a URL)
-        FileData* f = entry.getFile();
-        if (!f || f->alternatePath.empty())
+        if (!isAudioEntryCached(pair.second))
         {
-            continue;
-        }
-        
-        const char* downloadPath = f->alternatePath.c_str();
-        const char* ext = f->ext.c_str();
-        
-        // Check using ext from registry (set after Content-Type detection)
-        if (audioFileExists(downloadPath, ext))
-        {
-            continue; // Already cached
-        }
-        
-        // Also check if the primary local path already exists on disk
-        // (covers the case where Content-Type changed the extension and
-        //  the registry path was updated but ext field wasn't set yet)
-        if (!entry.file->path.empty() && SD_EXISTS(entry.file->path.c_str()))
-        {
-            continue; // Already cached under the corrected path
-        }
-
-        // Check if the file exists with a different extension (e.g., catalog says
-        // .wav but a previous download detected Content-Type audio/mp4 and saved
-        // as .m4a).  If found, re-register with the actual extension so the player
-        // finds it and we don't re-download every boot.
-        {
-            static const char* knownExts[] = {"wav", "mp3", "m4a", "aac", "ogg", "flac"};
-            bool found = false;
-            for (int i = 0; i < 6; i++)
-            {
-                // Skip the extension we already checked above
-                if (ext && strcmp(ext, knownExts[i]) == 0) continue;
-                if (audioFileExists(downloadPath, knownExts[i]))
-                {
-                    Logger.printf("🔄 Found cached file for '%s' with ext '%s' (registry had '%s'), re-registering\n",
-                                  entry.audioKey.c_str(), knownExts[i], ext ? ext : "(none)");
-                    audioKeyRegistry.registerKey(entry.audioKey.c_str(), downloadPath, knownExts[i]);
-                    found = true;
-                    break;
-                }
-            }
-            if (found) continue;
+            missing.emplace_back(dialScore(pair.first), &pair.second);
         }
+    }
+    if (!cacheIndex.complete())
+    {
+        cacheIndex.markComplete();
+        updateCacheBudget();
+    }
+    if (cacheIndex.totalBytes() >= cacheBudget / 100 * AUDIO_CACHE_PREFETCH_PERCENT)
+    {
+        return;  // Full enough: only files someone dials are fetched now
+    }
+    // Stable: equally cold keys keep catalog order
+    std::stable_sort(missing.begin(), missing.end(),
+        [](const std::pair<uint32_t, const AudioEntry*>& a, const std::pair<uint32_t, const AudioEntry*>& b) {
+            return a.first > b.first;
+        });
 
-        if (addToDownloadQueue(downloadPath, entry.audioKey.c_str(), ext)) {
+    int queued = 0;
+    for (const auto& m : missing)
+    {
+        FileData* f = m.second->getFile();
+        if (addToDownloadQueue(f->alternatePath.c_str(), m.second->audioKey.c_str(), f->ext.c_str())) {
             queued++;
         }
     }
@@ -460,7 +609,40 @@ static bool saveCachedEtag(const char* etag)
 }
 
 /**
- * @brief Perform lightweight cache validation check via HTTP HEAD or lastModified endpoint
+ * @brief Load the catalog's HTTP validators (ETag / Last-Modified lines)
+ *
+ * Only valid alongside the catalog JSON they were saved with.
+ */
+static void loadCatalogValidators()
+{
+    catalogValidators.clear();
+    File f = SD_OPEN(CACHE_VALIDATORS_FILE, FILE_READ);
+    if (!f) return;
+    String etag = f.readStringUntil('\n');
+    String lastModified = f.readStringUntil('\n');
+    f.close();
+    if (etag.length() < sizeof(catalogValidators.etag))
+        strcpy(catalogValidators.etag, etag.c_str());
+    if (lastModified.length() < sizeof(catalogValidators.lastModified))
+        strcpy(catalogValidators.lastModified, lastModified.c_str());
+}
+
+static void saveCatalogValidators()
+{
+    if (catalogValidators.empty()) {
+        if (SD_EXISTS(CACHE_VALIDATORS_FILE)) SD_REMOVE(CACHE_VALIDATORS_FILE);
+        return;
+    }
+    File f = SD_OPEN(CACHE_VALIDATORS_FILE, FILE_WRITE);
+    if (!f) return;
+    f.printf("%s\n%s\n", catalogValidators.etag, catalogValidators.lastModified);
+    f.close();
+}
+
+/**
+ * @brief Lightweight cache validation via the lastModified endpoint, for
+ * catalog servers that send no ETag / Last-Modified (otherwise the catalog
+ * GET itself is conditional and an unchanged catalog costs a 304)
  * @return true if remote data has changed (cache is stale), false if unchanged
  */
 static bool checkRemoteCacheValid()
@@ -494,18 +676,19 @@ static bool checkRemoteCacheValid()
         checkUrl += "?action=getLastModified";
     }
     
-    HttpClient http(HTTP_TIMEOUT_CATALOG_MS);
-    
-    if (!http.get(checkUrl))
+    String response;
     {
-        Logger.printf("⚠️ Cache check failed (HTTP %d) - assuming valid\n", http.statusCode());
-        return false; // Can't verify, assume valid
+        HttpLease http(checkUrl.c_str(), HTTP_TIMEOUT_CATALOG_MS);
+        if (!http->get(checkUrl))
+        {
+            Logger.printf("⚠️ Cache check failed (HTTP %d) - assuming valid\n", http->statusCode());
+            return false; // Can't verify, assume valid
+        }
+        response = http->getString();
     }
     
-    String response = http.getString();
-    
     // Parse the lastModified from response
-    JsonDocument doc;
+    JsonDocument doc(psramJson());
     DeserializationError error = deserializeJson(doc, response);
     
     if (error)
@@ -552,6 +735,9 @@ static bool checkRemoteCacheValid()
  *   "toneMs": 2000                      (optional — if set, wraps in RepeatingToneGenerator)
  *   "silenceMs": 3000                   (optional — required if toneMs is set)
  * 
+ * Every generator built here is a BlockSoundGenerator, so playback renders
+ * whole buffers through fillBlock().
+ * 
  * @param entryData JSON object containing generator parameters
  * @return Heap-allocated SoundGenerator (caller must manage ownership), or nullptr on error
  */
@@ -577,7 +763,7 @@ static SoundGenerator<int16_t>* buildGeneratorFromJson(JsonObject& entryData) {
     if (n > 4) n = 4;
 
     float amplitude = entryData["amplitude"] | 16000.0f;
-    SoundGenerator<int16_t>* baseGen = nullptr;
+    BlockSoundGenerator* baseGen = nullptr;
 
     switch (n) {
         case 1: {
@@ -663,144 +849,255 @@ static bool jsonTypeEquals(const char* value, const char* target) {
 }
 
 /**
- * @brief FNV-1a hash of a serialized JSON object for change detection
+ * @brief FNV-1a hash of an entry's raw catalog JSON for change detection
+ *
+ * Hashing the text as received lets an unchanged entry be recognized
+ * before it is deserialized.
  */
-static uint32_t hashJsonObject(JsonObject obj) {
+static uint32_t hashCatalogJson(const char* json, size_t len) {
     uint32_t h = 2166136261u;
-    String s;
-    serializeJson(obj, s);
-    for (size_t i = 0; i < s.length(); i++) {
-        h ^= (uint8_t)s[i];
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)json[i];
         h *= 16777619u;
     }
     return h;
 }
 
+/// Source JSON of each catalog generator, kept for the binary snapshot
+static std::map<std::string, std::string> generatorSources;
+
+static const char* generatorSource(const char* audioKey, void* /*userData*/)
+{
+    auto it = generatorSources.find(audioKey);
+    return it != generatorSources.end() ? it->second.c_str() : nullptr;
+}
+
+static SoundGenerator<int16_t>* generatorFromSnapshot(const char* audioKey, const char* json, void* /*userData*/)
+{
+    JsonDocument doc(psramJson());
+    if (deserializeJson(doc, json) || !doc.is<JsonObject>()) {
+        return nullptr;
+    }
+    JsonObject entryData = doc.as<JsonObject>();
+    SoundGenerator<int16_t>* gen = buildGeneratorFromJson(entryData);
+    if (gen) {
+        generatorSources[audioKey] = json;
+    }
+    return gen;
+}
+
 /**
  * @brief Callback type for processing audio entries during JSON parsing
  * @param entry The audio entry to process
+ * @param changed false if the entry was already registered with the same JSON
  * @param userData Optional user data pointer for context
  */
-typedef void (*AudioEntryProcessCallback)(const AudioEntry* entry, void* userData);
+typedef void (*AudioEntryProcessCallback)(const AudioEntry* entry, bool changed, void* userData);
 
 /**
- * @brief Parse JSON string and process audio entries with a callback
- * @param jsonString JSON string containing audio file entries
- * @param callback Function to call for each audio entry
- * @param userData Optional user data to pass to callback
- * @return Number of entries successfully processed, -1 on parse error
+ * @brief Build and register one new or changed catalog entry
+ * @param registry The load's draft registry
+ * @param hash hashCatalogJson() of @p json
+ * @param json The entry's raw JSON (kept as the source of generators)
+ * @return true if the entry is now registered
  */
-static int parseAndRegisterAudioFiles(const String& jsonString, AudioEntryProcessCallback callback=nullptr, void* userData = nullptr)
+static bool registerCatalogEntry(AudioKeyRegistry& registry, const char* key, JsonObject entryData,
+                                 uint32_t hash, const char* json,
+                                 AudioEntryProcessCallback callback, void* userData)
 {
-    // Parse JSON response
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, jsonString);
-    
-    if (error)
-    {
-        Logger.printf("❌ JSON parse error: %s\n", error.c_str());
-        return -1;
-    }
-    
-    // Extract lastModified for cache validation (if present at root level)
-    const char* lastModified = doc["lastModified"] | "";
-    if (strlen(lastModified) > 0)
-    {
-        saveCachedEtag(lastModified);
-        Logger.printf("📋 Cached lastModified: %s\n", lastModified);
-    }
-    else
-    {
-        // Generate a timestamp-based etag if server doesn't provide one
-        char timestampEtag[32];
-        snprintf(timestampEtag, sizeof(timestampEtag), "ts-%lu", millis());
-        saveCachedEtag(timestampEtag);
-    }
-    
-    JsonObject root = doc.as<JsonObject>();
-    int processedCount = 0;
-
-    for (JsonPair kv : root)
-    {
-        if (processedCount >= MAX_AUDIO_FILES)
+    const char* typeStr = entryData["type"] | "audio";
+
+    // Case-insensitive type detection
+    AudioStreamType streamType = AudioStreamType::FILE_STREAM;
+    if (jsonTypeEquals(typeStr, "generator")) {
+        streamType = AudioStreamType::GENERATOR;
+    } else if (jsonTypeEquals(typeStr, "url")) {
+        streamType = AudioStreamType::URL_STREAM;
+    }
+
+    // Build a complete AudioEntry, then register once
+    AudioEntry entry;
+    entry.audioKey = key;
+    entry.type = streamType;
+    entry.contentHash = hash;
+
+    // Type-specific payload
+    if (streamType == AudioStreamType::GENERATOR) {
+        entry.generator = buildGeneratorFromJson(entryData);
+        if (!entry.generator)
         {
-            Logger.println("⚠️ Maximum audio files limit reached");
-            break;
-        }
-
-        // Skip metadata keys (lastModified, etag, etc.) - only process object entries
-        if (!kv.value().is<JsonObject>()) {
-            continue;
+            Logger.printf("⚠️ Failed to build generator for '%s'\n", key);
+            return false;
         }
-        
-        JsonObject entryData = kv.value().as<JsonObject>();
-        const char* key = kv.key().c_str();
-
-        // Hash the JSON for change detection — skip reconstruction if unchanged
-        uint32_t hash = hashJsonObject(entryData);
-        const AudioEntry* existing = audioKeyRegistry.getEntry(key);
-        if (existing && existing->contentHash == hash) {
-            processedCount++;
-            if (callback) callback(existing, userData);
-            continue;
+        generatorSources[key] = json;
+    } else {
+        entry.file = new FileData();
+        entry.file->path = entryData["path"] | entryData["data"] | entryData["url"] | "";
+        entry.file->ext = entryData["ext"] | entryData["codec"] | entryData["extension"] | "";
+        if (entry.file->path.empty()) {
+            Logger.printf("⚠️ No path for: %s\n", key);
+            return false;
         }
+    }
 
-        const char* typeStr = entryData["type"] | "audio";
+    // Timing metadata
+    entry.timing = parseAudioTiming(entryData);
 
-        // Case-insensitive type detection
-        AudioStreamType streamType = AudioStreamType::FILE_STREAM;
-        if (jsonTypeEquals(typeStr, "generator")) {
-            streamType = AudioStreamType::GENERATOR;
-        } else if (jsonTypeEquals(typeStr, "url")) {
-            streamType = AudioStreamType::URL_STREAM;
-        }
+    // AudioLinks
+    if (!entryData["previous"].isNull())
+        entry.previous = parseAudioLink(entryData["previous"]);
+    if (!entryData["next"].isNull())
+        entry.next = parseAudioLink(entryData["next"]);
 
-        // Build a complete AudioEntry, then register once
-        AudioEntry entry;
-        entry.audioKey = key;
-        entry.type = streamType;
-        entry.contentHash = hash;
+    // Single registration point — moves entry into registry
+    registry.registerEntry(std::move(entry));
 
-        // Type-specific payload
-        if (streamType == AudioStreamType::GENERATOR) {
-            entry.generator = buildGeneratorFromJson(entryData);
-            if (!entry.generator)
-            {
-                Logger.printf("⚠️ Failed to build generator for '%s'\n", key);
-                continue;
-            }
-        } else {
-            entry.file = new FileData();
-            entry.file->path = entryData["path"] | entryData["data"] | entryData["url"] | "";
-            entry.file->ext = entryData["ext"] | entryData["codec"] | entryData["extension"] | "";
-            if (entry.file->path.empty()) {
-                Logger.printf("⚠️ No path for: %s\n", key);
-                continue;
+    // Re-fetch pointer for callback (entry was moved)
+    const AudioEntry* registered = registry.getEntry(key);
+    if (callback && registered)
+        callback(registered, true, userData);
+    return true;
+}
+
+/**
+ * @brief State for one catalog parse, fed in chunks from HTTP or the SD card
+ *
+ * Entries register as their JSON completes, into a draft of the registry
+ * that commitCatalogLoad() publishes; only the entry being read is held in
+ * memory (see CatalogStreamParser). A load dropped before its commit
+ * leaves the published registry untouched.
+ */
+struct CatalogLoad {
+    CatalogStreamParser parser;
+    AudioKeyRegistry* draft = nullptr;   // From beginUpdate(), until committed
+    ~CatalogLoad() { audioKeyRegistry.abortUpdate(draft); }
+    AudioEntryProcessCallback callback = nullptr;
+    void* userData = nullptr;
+    int processedCount = 0;
+    int changedCount = 0;            // New or changed entries (rebuilt)
+    bool limitReached = false;
+    char lastModified[64] = {0};
+};
+
+static void onCatalogMember(const char* key, const char* json, size_t len, void* ud)
+{
+    CatalogLoad* load = static_cast<CatalogLoad*>(ud);
+
+    // lastModified for cache validation; saved once the whole catalog is in
+    if (strcmp(key, "lastModified") == 0)
+    {
+        JsonDocument doc(psramJson());
+        if (!deserializeJson(doc, json, len)) {
+            const char* value = doc.as<const char*>();
+            if (value) {
+                strncpy(load->lastModified, value, sizeof(load->lastModified) - 1);
             }
         }
+        return;
+    }
+
+    // Skip metadata keys (etag, etc.) - only process object entries
+    if (json[0] != '{') {
+        return;
+    }
 
-        // Timing metadata
-        entry.timing = parseAudioTiming(entryData);
+    if (load->processedCount >= MAX_AUDIO_FILES)
+    {
+        if (!load->limitReached) {
+            Logger.println("⚠️ Maximum audio files limit reached");
+            load->limitReached = true;
+        }
+        return;
+    }
 
-        // AudioLinks
-        if (!entryData["previous"].isNull())
-            entry.previous = parseAudioLink(entryData["previous"]);
-        if (!entryData["next"].isNull())
-            entry.next = parseAudioLink(entryData["next"]);
+    // Same JSON as the registered entry: nothing to parse or rebuild
+    uint32_t hash = hashCatalogJson(json, len);
+    const AudioEntry* existing = load->draft->getEntry(key);
+    if (existing && existing->contentHash == hash)
+    {
+        if (load->callback) load->callback(existing, false, load->userData);
+        load->processedCount++;
+        return;
+    }
 
-        // Single registration point — moves entry into registry
-        audioKeyRegistry.registerEntry(std::move(entry));
+    JsonDocument doc(psramJson());
+    DeserializationError error = deserializeJson(doc, json, len);
+    if (error || !doc.is<JsonObject>())
+    {
+        Logger.printf("⚠️ JSON parse error in '%s': %s\n", key, error ? error.c_str() : "not an object");
+        return;
+    }
 
-        // Re-fetch pointer for callback (entry was moved)
-        const AudioEntry* registered = audioKeyRegistry.getEntry(key);
-        processedCount++;
+    if (registerCatalogEntry(*load->draft, key, doc.as<JsonObject>(), hash, json,
+                             load->callback, load->userData))
+    {
+        load->processedCount++;
+        load->changedCount++;
+    }
+}
 
-        // Invoke callback if provided
-        if (callback && registered)
-            callback(registered, userData);
+static bool beginCatalogLoad(CatalogLoad& load, AudioEntryProcessCallback callback, void* userData)
+{
+    load.callback = callback;
+    load.userData = userData;
+    load.draft = audioKeyRegistry.beginUpdate();
+    if (!load.draft)
+    {
+        return false;
+    }
+    if (!load.parser.begin(onCatalogMember, &load))
+    {
+        Logger.println("❌ No memory for catalog parser");
+        return false;
     }
+    return true;
+}
 
-    return processedCount;
+/**
+ * @brief Publish everything a finished load registered, in one swap
+ */
+static void commitCatalogLoad(CatalogLoad& load)
+{
+    audioKeyRegistry.commitUpdate(load.draft);
+    load.draft = nullptr;
+}
+
+/**
+ * @brief Finish a catalog parse and save its lastModified etag
+ * @return Number of entries registered, -1 if the JSON was malformed or cut off
+ */
+static int finishCatalogLoad(CatalogLoad& load)
+{
+    bool complete = load.parser.finish();
+    if (!complete)
+    {
+        Logger.printf("❌ JSON parse error: %s (%u bytes read)\n",
+                      load.parser.error() ? load.parser.error() : "catalog incomplete",
+                      (unsigned)load.parser.bytesRead());
+    }
+    if (load.parser.membersSkipped() > 0)
+    {
+        Logger.printf("⚠️ Skipped %u catalog entries over %d bytes\n",
+                      (unsigned)load.parser.membersSkipped(), AUDIO_CATALOG_ENTRY_MAX_BYTES);
+    }
+    load.parser.end();
+    if (!complete) {
+        return -1;
+    }
+
+    if (strlen(load.lastModified) > 0)
+    {
+        saveCachedEtag(load.lastModified);
+        Logger.printf("📋 Cached lastModified: %s\n", load.lastModified);
+    }
+    else
+    {
+        // Generate a timestamp-based etag if server doesn't provide one
+        char timestampEtag[32];
+        snprintf(timestampEtag, sizeof(timestampEtag), "ts-%lu", millis());
+        saveCachedEtag(timestampEtag);
+    }
+    return load.processedCount;
 }
 
 /**
@@ -867,6 +1164,7 @@ static bool isCacheStale(int audioFileCount = -1, bool allowRemoteValidation = t
     if (cacheAge > maxAge)
     {
         Logger.printf("⏰ Cache expired (age: %lu ms > max: %lu ms)\n", cacheAge, maxAge);
+        catalogForceFull = true;
         return true;
     }
     
@@ -877,6 +1175,15 @@ static bool isCacheStale(int audioFileCount = -1, bool allowRemoteValidation = t
     if (allowRemoteValidation && (firstCheckAfterBoot || timeSinceLastCheck > CACHE_CHECK_INTERVAL_MS) && WiFi.status() == WL_CONNECTED)
     {
         lastCacheCheck = currentTime;
+
+        // With validators the refresh is a conditional GET: a 304 ends it
+        // before any body or parsing
+        if (!catalogValidators.empty())
+        {
+            Logger.println("🔍 Revalidating catalog (conditional GET)...");
+            return true;
+        }
+
         Logger.println("🔍 Performing lightweight cache validation...");
         
         if (checkRemoteCacheValid())
@@ -917,15 +1224,7 @@ static int loadAudioFilesFromSDCard()
         return 0;
     }
     
-    // Read file content
-    String jsonString = audioJsonFile.readString();
-    audioJsonFile.close();
-    
-    if (jsonString.length() == 0)
-    {
-        Logger.println("❌ Empty audio files JSON on SD card");
-        return 0;
-    }
+    uint32_t jsonSize = audioJsonFile.size();
     
     // Load cache timestamp
     File timestampFile = SD_OPEN(CACHE_TIMESTAMP_FILE, FILE_READ);
@@ -941,17 +1240,64 @@ static int loadAudioFilesFromSDCard()
         Logger.println("⚠️ No cache timestamp found");
     }
     
-    // Parse and register audio files from JSON
-    int registeredCount = parseAndRegisterAudioFiles(jsonString);
-    
-    if (registeredCount < 0) {
-        return 0; // Parse error
+    // Fast path: the binary snapshot written from this same JSON
+    unsigned long loadStart = millis();
+    AudioKeyRegistry* draft = audioKeyRegistry.beginUpdate();
+    if (!draft)
+    {
+        audioJsonFile.close();
+        return 0;
+    }
+    int registeredCount = loadCatalogSnapshot(SD_CARD, AUDIO_SNAPSHOT_FILE, audioJsonFile,
+                                              *draft, generatorFromSnapshot, nullptr);
+    if (registeredCount >= 0)
+    {
+        audioJsonFile.close();
+        audioKeyRegistry.commitUpdate(draft);
+        Logger.printf("⚡ Catalog snapshot: %d entries in %lu ms\n", registeredCount, millis() - loadStart);
+    }
+    else
+    {
+        // Parse straight from the file, one chunk at a time
+        audioKeyRegistry.abortUpdate(draft);
+        CatalogLoad load;
+        if (!beginCatalogLoad(load, nullptr, nullptr))
+        {
+            audioJsonFile.close();
+            return 0;
+        }
+        uint8_t chunk[1024];
+        uint32_t jsonHash = CATALOG_SOURCE_HASH_SEED;
+        int n;
+        while ((n = audioJsonFile.read(chunk, sizeof(chunk))) > 0)
+        {
+            jsonHash = catalogSourceHash(chunk, n, jsonHash);
+            if (!load.parser.feed(chunk, n)) break;
+        }
+        audioJsonFile.close();
+        
+        if (load.parser.bytesRead() == 0)
+        {
+            Logger.println("❌ Empty audio files JSON on SD card");
+            load.parser.end();
+            return 0;
+        }
+        
+        registeredCount = finishCatalogLoad(load);
+        if (registeredCount < 0) {
+            return 0; // Parse error
+        }
+        commitCatalogLoad(load);
+        Logger.printf("📖 Catalog JSON: %d entries in %lu ms\n", registeredCount, millis() - loadStart);
+        writeCatalogSnapshot(SD_CARD, AUDIO_SNAPSHOT_FILE, audioKeyRegistry, jsonSize, jsonHash,
+                             generatorSource, nullptr);
     }
     
     // Resolve all playlists after registration
 #if ENABLE_PLAYLIST_FEATURES
     playlistRegistry.resolveAllPlaylists();
 #endif
+    rebuildDialIndex();
     
     Logger.printf("✅ Loaded and registered %d audio files from SD card\n", registeredCount);
     return registeredCount;
@@ -961,7 +1307,7 @@ static int loadAudioFilesFromSDCard()
 // PUBLIC FUNCTIONS
 // ============================================================================
 
-AudioSource *initializeAudioFileManager()
+AudioSource *mountAudioStorage()
 {
     Logger.println("🔧 Initializing Audio File Manager...");
     
@@ -984,23 +1330,31 @@ AudioSource *initializeAudioFileManager()
         source = new AudioSourceSD(SD_AUDIO_PATH, "wav", SD_CS_PIN, SPI);
         Logger.println("✅ AudioSourceSD created");
 #endif
-        // Create registry mutex and wire it into the download queue so that
-        // re-registrations from the download task are safe.
-        if (!registryMutex) registryMutex = xSemaphoreCreateMutex();
-        webQueue.setRegistryMutex(registryMutex);
+        webQueue.setFileCallback(onAudioFileStored);
+
+        if (cacheIndex.load(SD_CARD, AUDIO_CACHE_INDEX_FILE))
+        {
+            updateCacheBudget();
+        }
     }
     else
     {
         Logger.println("⚠️ SD card not available - running in memory-only mode");
         Logger.println("ℹ️ Audio catalog will be downloaded when WiFi is available");
-        return source;
     }
+    return source;
+}
+
+int loadAudioCatalog()
+{
+    if (!sdCardAvailable) return 0;
 
     // Try to load from SD card first - registers directly with AudioKeyRegistry
     int audioFileCount = loadAudioFilesFromSDCard();
     if (audioFileCount > 0)
     {
         Logger.println("✅ Audio files loaded from SD card cache");
+        loadCatalogValidators();
         
         // Check if cache is stale
         // Keep boot fast: skip remote validation here and defer it to maintenance loop.
@@ -1027,7 +1381,13 @@ AudioSource *initializeAudioFileManager()
     {
         Logger.println("ℹ️ No cached audio files found, will download when WiFi is available");
     }
-    
+    return audioFileCount;
+}
+
+AudioSource *initializeAudioFileManager()
+{
+    AudioSource* source = mountAudioStorage();
+    loadAudioCatalog();
     return source;
 }
 
@@ -1036,30 +1396,16 @@ AudioSource *initializeAudioFileManager()
 // ============================================================================
 
 /**
- * @brief Build the catalog URL with streaming parameter and optional DNS cache IP.
+ * @brief Build the catalog URL with streaming parameter.
+ *
+ * The host is resolved through HttpDns when connecting, so the URL keeps
+ * its name (needed for TLS SNI and for the server's validators to match).
  * @return Fully-qualified catalog URL ready for HTTP GET.
  */
 static String buildCatalogUrl()
 {
     String catalogUrl = KNOWN_SEQUENCES_URL;
 
-    // If DNS is pre-cached, try to use the IP instead of hostname
-    if (dnsPreCached && cachedGitHubIP != IPAddress(0,0,0,0))
-    {
-        int protoEnd = catalogUrl.indexOf("://");
-        if (protoEnd > 0)
-        {
-            String protocol = catalogUrl.substring(0, protoEnd + 3);
-            int hostStart = protoEnd + 3;
-            int hostEnd = catalogUrl.indexOf('/', hostStart);
-            if (hostEnd > hostStart)
-            {
-                String path = catalogUrl.substring(hostEnd);
-                catalogUrl = protocol + cachedGitHubIP.toString() + path;
-            }
-        }
-    }
-
     // Append streaming parameter
     catalogUrl += (catalogUrl.indexOf('?') >= 0) ? "&streaming=" : "?streaming=";
     catalogUrl += sdCardAvailable ? "false" : "true";
@@ -1067,89 +1413,213 @@ static String buildCatalogUrl()
 }
 
 // ============================================================================
-// CATALOG COMPLETION CALLBACK
+// CATALOG DOWNLOAD CALLBACKS
 // ============================================================================
 
+#define AUDIO_JSON_TMP_FILE AUDIO_JSON_FILE ".tmp"
+
+/**
+ * @brief A catalog download in progress: parser, per-key-ID marks for the
+ * sweep, and the SD file the raw body is teed into
+ */
+struct CatalogDownload {
+    enum : uint8_t { KEY_SEEN = 1, KEY_CHANGED = 2 };
+
+    CatalogLoad load;
+    std::vector<uint8_t> keyState;          // Indexed by AudioKeyId
+    std::vector<std::string> removedKeys;   // Filled by the sweep
+    File tmpFile;
+    size_t bytes = 0;
+    uint32_t hash = CATALOG_SOURCE_HASH_SEED;   // Of the bytes so far, for the snapshot
+
+    bool changed(const char* audioKey) const {
+        AudioKeyId id = audioKeyRegistry.findKeyId(audioKey);
+        if (id != AUDIO_KEY_NONE)
+            return id < keyState.size() && (keyState[id] & KEY_CHANGED);
+        for (const auto& key : removedKeys)
+            if (key == audioKey) return true;
+        return false;
+    }
+};
+static CatalogDownload* catalogDownload = nullptr;
+
+static void discardCatalogDownload()
+{
+    if (!catalogDownload) return;
+    if (catalogDownload->tmpFile) {
+        catalogDownload->tmpFile.close();
+        SD_REMOVE(AUDIO_JSON_TMP_FILE);
+    }
+    catalogDownload->load.parser.end();
+    delete catalogDownload;
+    catalogDownload = nullptr;
+}
+
+/**
+ * @brief Called by the download queue for each chunk of the catalog body.
+ *
+ * Runs on core 1 (from tick()). Entries register into the load's draft
+ * as soon as their JSON completes, and go live only when the whole
+ * catalog has parsed and onCatalogDownloaded() commits it; the raw bytes are
+ * written to AUDIO_JSON_TMP_FILE, which replaces the SD cache only once
+ * the whole catalog has parsed.
+ */
+static bool onCatalogChunk(const uint8_t* data, size_t len, void* /*userData*/)
+{
+    if (!catalogDownload) {
+        catalogDownload = new CatalogDownload();
+        catalogDownload->keyState.reserve(audioKeyRegistry.size() + 16);
+
+        // Mark each key the catalog lists; unmarked keys are swept at the end
+        if (!beginCatalogLoad(catalogDownload->load,
+                [](const AudioEntry* entry, bool changed, void* ud) {
+                    auto* dl = static_cast<CatalogDownload*>(ud);
+                    AudioKeyId id = dl->load.draft->findKeyId(entry->audioKey.c_str());
+                    if (id == AUDIO_KEY_NONE) return;
+                    if (id >= dl->keyState.size()) dl->keyState.resize(id + 1, 0);
+                    dl->keyState[id] |= CatalogDownload::KEY_SEEN;
+                    if (changed) dl->keyState[id] |= CatalogDownload::KEY_CHANGED;
+                }, catalogDownload)) {
+            discardCatalogDownload();
+            return false;
+        }
+
+        if (sdCardAvailable) {
+            catalogDownload->tmpFile = SD_OPEN(AUDIO_JSON_TMP_FILE, FILE_WRITE);
+            if (!catalogDownload->tmpFile)
+                Logger.println("⚠️ Cannot create " AUDIO_JSON_TMP_FILE " — catalog won't be cached");
+        }
+        Logger.println("📥 Catalog arriving, registering entries into a draft as they parse...");
+    }
+
+    catalogDownload->bytes += len;
+    catalogDownload->hash = catalogSourceHash(data, len, catalogDownload->hash);
+    File& tmp = catalogDownload->tmpFile;
+    if (tmp && tmp.write(data, len) != len) {
+        Logger.println("⚠️ SD write failed — catalog won't be cached");
+        tmp.close();
+        SD_REMOVE(AUDIO_JSON_TMP_FILE);
+    }
+
+    if (!catalogDownload->load.parser.feed(data, len)) {
+        Logger.printf("❌ JSON parse error: %s\n", catalogDownload->load.parser.error());
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Called by the download queue when a catalog fetch completes.
  *
- * Runs on core 1 (from tick()), so registry access is safe.
- * Parses JSON, registers entries, prunes orphans, saves to SD, and
- * enqueues missing audio files for download.
+ * Prunes keys the new catalog no longer lists, publishes the draft, moves
+ * the teed copy into place on SD, and enqueues missing audio files for
+ * download. A failed or malformed download changes nothing: the draft is
+ * dropped and the old SD cache left alone.
  */
-static void onCatalogDownloaded(bool success, const String& payload, void* /*userData*/)
+static void onCatalogDownloaded(bool success, int statusCode, const String& /*payload*/, void* /*userData*/)
 {
     catalogDownloadPending = false;
 
-    if (!success || payload.length() == 0) {
+    if (success && statusCode == 304) {
+        discardCatalogDownload();
+        Logger.println("✅ Catalog unchanged (304) — cache kept");
+        if (sdCardAvailable) {
+            File timestampFile = SD_OPEN(CACHE_TIMESTAMP_FILE, FILE_WRITE);
+            if (timestampFile) {
+                timestampFile.print(millis());
+                timestampFile.close();
+            }
+        }
+        lastCacheTime = millis();
+        return;
+    }
+
+    if (!success || !catalogDownload) {
         Logger.println("❌ Catalog download failed");
+        discardCatalogDownload();
         return;
     }
 
-    Logger.printf("✅ Catalog received (%d bytes), parsing...\n", payload.length());
+    Logger.printf("✅ Catalog received (%u bytes)\n", (unsigned)catalogDownload->bytes);
 
-    if (payload.length() > MAX_HTTP_RESPONSE_SIZE) {
-        Logger.println("❌ Catalog response too large");
+    int registeredCount = finishCatalogLoad(catalogDownload->load);
+    if (registeredCount < 0) {
+        discardCatalogDownload();
         return;
     }
 
-    // Mark-and-sweep: collect existing non-generator keys
-    std::set<std::string> existingKeys;
-    for (const auto& pair : audioKeyRegistry) {
-        if (pair.second.type != AudioStreamType::GENERATOR)
-            existingKeys.insert(pair.first);
+    // Sweep non-generator keys the catalog no longer lists
+    AudioKeyRegistry& draft = *catalogDownload->load.draft;
+    const std::vector<uint8_t>& keyState = catalogDownload->keyState;
+    std::vector<std::string>& removedKeys = catalogDownload->removedKeys;
+    for (const auto& pair : draft) {
+        if (pair.second.type == AudioStreamType::GENERATOR) continue;
+        AudioKeyId id = draft.findKeyId(pair.first);
+        if (id >= keyState.size() || !(keyState[id] & CatalogDownload::KEY_SEEN))
+            removedKeys.emplace_back(pair.first);
     }
-
-    std::set<std::string> seenKeys;
-
-    int registeredCount = parseAndRegisterAudioFiles(payload,
-        [](const AudioEntry* entry, void* ud) {
-            auto* seen = static_cast<std::set<std::string>*>(ud);
-            if (seen) seen->insert(entry->audioKey);
-        }, &seenKeys);
-
-    if (registeredCount < 0) return;
-
-    // Prune orphaned keys
-    int prunedCount = 0;
-    for (const auto& key : existingKeys) {
-        if (seenKeys.find(key) == seenKeys.end()) {
-            Logger.printf("🗑️ Pruning orphaned key: %s\n", key.c_str());
-            audioKeyRegistry.unregisterKey(key.c_str());
-            prunedCount++;
-        }
+    for (const auto& key : removedKeys) {
+        Logger.printf("🗑️ Pruning orphaned key: %s\n", key.c_str());
+        draft.unregisterKey(key.c_str());
     }
-    if (prunedCount > 0)
-        Logger.printf("✅ Pruned %d orphaned audio keys\n", prunedCount);
+    int prunedCount = removedKeys.size();
+    int changedCount = catalogDownload->load.changedCount;
 
+    // Registrations and prunes reach the player together
+    commitCatalogLoad(catalogDownload->load);
+
+    // Only playlists that reference an added, changed or removed key
+    if (changedCount > 0 || prunedCount > 0) {
 #if ENABLE_PLAYLIST_FEATURES
-    playlistRegistry.resolveAllPlaylists();
+        playlistRegistry.resolvePlaylistsReferencing(
+            [](const char* audioKey, void* ud) {
+                return static_cast<CatalogDownload*>(ud)->changed(audioKey);
+            }, catalogDownload);
 #endif
+        rebuildDialIndex();
+    }
 
-    Logger.printf("✅ Registered %d audio files%s\n",
-                  registeredCount, prunedCount > 0 ? " (pruned orphans)" : "");
+    Logger.printf("✅ Catalog applied: %d entries, %d new or changed, %d pruned\n",
+                  registeredCount, changedCount, prunedCount);
+    catalogValidators = fetchValidators;
 
     // Save to SD card
     if (sdCardAvailable) {
-        File audioJsonFile = SD_OPEN(AUDIO_JSON_FILE, FILE_WRITE);
-        if (audioJsonFile) {
-            audioJsonFile.print(payload);
-            audioJsonFile.close();
-
-            File timestampFile = SD_OPEN(CACHE_TIMESTAMP_FILE, FILE_WRITE);
-            if (timestampFile) {
-                timestampFile.print(millis());
-                timestampFile.close();
-                lastCacheTime = millis();
+        File& tmp = catalogDownload->tmpFile;
+        if (tmp) {
+            tmp.close();
+            if (SD_EXISTS(AUDIO_JSON_FILE))
+                SD_REMOVE(AUDIO_JSON_FILE);
+            if (SD_RENAME(AUDIO_JSON_TMP_FILE, AUDIO_JSON_FILE)) {
+                writeCatalogSnapshot(SD_CARD, AUDIO_SNAPSHOT_FILE, audioKeyRegistry,
+                                     catalogDownload->bytes, catalogDownload->hash,
+                                     generatorSource, nullptr);
+                saveCatalogValidators();
+                File timestampFile = SD_OPEN(CACHE_TIMESTAMP_FILE, FILE_WRITE);
+                if (timestampFile) {
+                    timestampFile.print(millis());
+                    timestampFile.close();
+                    lastCacheTime = millis();
+                }
+                Logger.println("💾 Audio catalog cached to SD card");
+            } else {
+                SD_REMOVE(AUDIO_JSON_TMP_FILE);
+                SD_REMOVE(AUDIO_SNAPSHOT_FILE);
+                SD_REMOVE(CACHE_VALIDATORS_FILE);
+                Logger.println("⚠️ Failed to cache audio catalog to SD card");
             }
-            Logger.println("💾 Audio catalog cached to SD card");
         } else {
+            // The SD copy is older than the validators: don't let them vouch for it
+            SD_REMOVE(CACHE_VALIDATORS_FILE);
             Logger.println("⚠️ Failed to cache audio catalog to SD card");
         }
 
         // Queue missing audio file downloads
         enqueueMissingAudioFilesFromRegistry();
     }
+
+    delete catalogDownload;
+    catalogDownload = nullptr;
 }
 
 // ============================================================================
@@ -1171,8 +1641,13 @@ bool downloadAudio(int /*maxRetries*/, unsigned long /*retryDelayMs*/)
     String url = buildCatalogUrl();
     Logger.printf("📡 Enqueueing catalog download: %s\n", url.c_str());
 
-    auto result = webQueue.enqueueCatalog(url.c_str(), onCatalogDownloaded);
+    // Conditional on the catalog we hold, unless a full refresh is due
+    fetchValidators = catalogForceFull ? HttpValidators() : catalogValidators;
+    catalogForceFull = false;
+    auto result = webQueue.enqueueCatalog(url.c_str(), onCatalogDownloaded, nullptr, onCatalogChunk,
+                                          &fetchValidators);
     if (result == WebQueue::EnqueueResult::OK) {
+        discardCatalogDownload();  // Leftover from a download the queue dropped
         catalogDownloadPending = true;
         return true;
     }
@@ -1191,6 +1666,8 @@ void invalidateAudioCache()
     lastCacheTime = 0;  // Force cache to be considered stale
     lastCacheCheck = 0;
     cachedEtag[0] = '\0';
+    catalogValidators.clear();
+    catalogForceFull = true;
 
     // Do NOT delete SD cache files — they're our fallback if the catalog
     // download fails (no WiFi, server down, power loss during refresh).
@@ -1200,6 +1677,136 @@ void invalidateAudioCache()
     Logger.println("✅ Cache invalidated - next maintenance loop will refresh");
 }
 
+// ============================================================================
+// DIAL STATISTICS
+// ============================================================================
+// Recency is counted in dials, not time: millis() restarts at every boot
+// and the wall clock may never be set.
+
+#define DIAL_STATS_NAMESPACE "dialstats"
+
+struct DialStat {
+    char     key[MAX_SEQUENCE_LENGTH + 1];
+    uint16_t count;
+    uint32_t lastDial;              // dialClock at the key's latest dial
+};
+
+static DialStat dialStats[DIAL_STATS_MAX];
+static int dialStatCount = 0;
+static uint32_t dialClock = 0;      // Dials ever recorded
+static bool dialStatsLoaded = false;
+static bool dialStatsDirty = false;
+static unsigned long dialStatsChangedAt = 0;
+
+/// Dial count, weighing half once DIAL_STATS_HALF_LIFE other dials have passed
+static uint32_t statScore(const DialStat& stat)
+{
+    uint32_t age = dialClock - stat.lastDial;
+    return ((uint32_t)stat.count * 256 * DIAL_STATS_HALF_LIFE) / (DIAL_STATS_HALF_LIFE + age);
+}
+
+static void loadDialStats()
+{
+    dialStatsLoaded = true;
+    Preferences prefs;
+    if (!prefs.begin(DIAL_STATS_NAMESPACE, true)) {  // Read-only; absent until first save
+        return;
+    }
+    size_t len = prefs.getBytesLength("stats");
+    if (prefs.getUChar("recSize", 0) == sizeof(DialStat) &&
+        len % sizeof(DialStat) == 0 && len <= sizeof(dialStats))
+    {
+        dialStatCount = prefs.getBytes("stats", dialStats, len) / sizeof(DialStat);
+        dialClock = prefs.getUInt("clock", 0);
+        for (int i = 0; i < dialStatCount; i++) {
+            dialStats[i].key[MAX_SEQUENCE_LENGTH] = '\0';
+        }
+    }
+    prefs.end();
+    Logger.debugf("📊 Loaded dial stats for %d key(s)\n", dialStatCount);
+}
+
+static void saveDialStats()
+{
+    Preferences prefs;
+    if (!prefs.begin(DIAL_STATS_NAMESPACE, false)) {  // Read-write
+        Logger.println("⚠️ Failed to open dial stats storage");
+        dialStatsChangedAt = millis();  // Retry after another delay
+        return;
+    }
+    prefs.putUChar("recSize", sizeof(DialStat));
+    prefs.putUInt("clock", dialClock);
+    prefs.putBytes("stats", dialStats, dialStatCount * sizeof(DialStat));
+    prefs.end();
+    dialStatsDirty = false;
+    Logger.debugf("💾 Saved dial stats for %d key(s)\n", dialStatCount);
+}
+
+static DialStat* findDialStat(const char* audioKey)
+{
+    if (!dialStatsLoaded) loadDialStats();
+    for (int i = 0; i < dialStatCount; i++) {
+        if (strcmp(dialStats[i].key, audioKey) == 0) return &dialStats[i];
+    }
+    return nullptr;
+}
+
+/// Prefetch rank of a key (0 if never dialed)
+static uint32_t dialScore(const char* audioKey)
+{
+    const DialStat* stat = audioKey ? findDialStat(audioKey) : nullptr;
+    return stat ? statScore(*stat) : 0;
+}
+
+void recordAudioKeyDialed(const char* audioKey)
+{
+    if (!audioKey || !audioKey[0] || strlen(audioKey) > MAX_SEQUENCE_LENGTH) {
+        return;
+    }
+    DialStat* stat = findDialStat(audioKey);
+    dialClock++;
+    if (!stat) {
+        if (dialStatCount < DIAL_STATS_MAX) {
+            stat = &dialStats[dialStatCount++];
+        } else {
+            // Full: the coldest key makes way
+            stat = &dialStats[0];
+            for (int i = 1; i < dialStatCount; i++) {
+                if (statScore(dialStats[i]) < statScore(*stat)) stat = &dialStats[i];
+            }
+        }
+        memset(stat, 0, sizeof(*stat));
+        strncpy(stat->key, audioKey, MAX_SEQUENCE_LENGTH);
+    }
+    if (stat->count == UINT16_MAX) {
+        // Halve everyone so the ranking survives saturation
+        for (int i = 0; i < dialStatCount; i++) {
+            dialStats[i].count = (dialStats[i].count + 1) / 2;
+        }
+    }
+    stat->count++;
+    stat->lastDial = dialClock;
+    dialStatsDirty = true;
+    dialStatsChangedAt = millis();
+}
+
+void printDialStats()
+{
+    if (!dialStatsLoaded) loadDialStats();
+    std::vector<const DialStat*> order;
+    for (int i = 0; i < dialStatCount; i++) order.push_back(&dialStats[i]);
+    std::sort(order.begin(), order.end(), [](const DialStat* a, const DialStat* b) {
+        return statScore(*a) > statScore(*b);
+    });
+    Logger.printf("📊 Dial stats: %d/%d key(s), %lu dial(s)%s\n", dialStatCount, DIAL_STATS_MAX,
+                  (unsigned long)dialClock, dialStatsDirty ? ", unsaved" : "");
+    for (const DialStat* stat : order) {
+        Logger.printf("   %-*s %5u dial(s), last %lu dial(s) ago, score %lu\n", MAX_SEQUENCE_LENGTH, stat->key,
+                      (unsigned)stat->count, (unsigned long)(dialClock - stat->lastDial),
+                      (unsigned long)statScore(*stat));
+    }
+}
+
 // ============================================================================
 // AUDIO MAINTENANCE LOOP
 // ============================================================================
@@ -1234,6 +1841,22 @@ void audioMaintenanceLoop()
     //    so slots are freed automatically before we try to enqueue here.
     if (!catalogDownloadPending && webQueue.pendingCount() == 0 && !webQueue.isActive())
         enqueueMissingAudioFilesFromRegistry();
+
+    // 4. Persist dial stats once they've settled and nothing is playing
+    //    (an NVS write stalls flash access)
+    if (dialStatsDirty && millis() - dialStatsChangedAt >= DIAL_STATS_SAVE_DELAY_MS &&
+        !getExtendedAudioPlayer().isActive())
+        saveDialStats();
+
+    // 5. Cache index upkeep while nothing is playing: evict least recently
+    //    played files down to the budget, then write the index back
+    if (cacheIndex.complete() && !getExtendedAudioPlayer().isActive())
+    {
+        if (cacheIndex.totalBytes() > cacheBudget)
+            cacheIndex.evict(SD_CARD, cacheBudget);
+        if (cacheIndex.dirty() && millis() - cacheIndex.changedAt() >= AUDIO_CACHE_INDEX_SAVE_DELAY_MS)
+            cacheIndex.save(SD_CARD, AUDIO_CACHE_INDEX_FILE);
+    }
 }
 
 // ============================================================================
@@ -1251,6 +1874,98 @@ int getDownloadQueueCount()     { return webQueue.pendingCount(); }
 // void listDownloadQueue()        { webQueue.listItems(); }
 // void clearDownloadQueue()       { webQueue.reset(); }
 bool isDownloadQueueEmpty()     { return webQueue.isEmpty(); }
+void setAudioDownloadsSuspended(bool suspended) { webQueue.setSuspended(suspended); }
+
+bool requestAudioFileNow(const char* audioKey)
+{
+    const AudioEntry* entry = audioKey ? audioKeyRegistry.getEntry(audioKey) : nullptr;
+    FileData* f = entry ? entry->getFile() : nullptr;
+    if (!f || f->alternatePath.empty() || !initializeSDCard())
+    {
+        return false;
+    }
+    // Also the player's missing-file path: an index entry whose file is gone is stale
+    const AudioCacheIndex::Entry* cached = cacheIndex.find(f->alternatePath.c_str());
+    if (cached && !SD_EXISTS(cached->path))
+    {
+        Logger.printf("⚠️ %s vanished from SD — dropping it from the cache index\n", cached->path);
+        cacheIndex.forget(f->alternatePath.c_str());
+    }
+    if (isAudioEntryCached(*entry))
+    {
+        return false;
+    }
+    return addToDownloadQueue(f->alternatePath.c_str(), audioKey, f->ext.c_str(),
+                              WebQueue::Priority::INTERACTIVE);
+}
+
+void noteAudioFilePlayed(const char* audioKey)
+{
+    const AudioEntry* entry = audioKey ? audioKeyRegistry.getEntry(audioKey) : nullptr;
+    FileData* f = entry ? entry->getFile() : nullptr;
+    if (f && !f->alternatePath.empty())
+    {
+        cacheIndex.touch(f->alternatePath.c_str());
+    }
+}
+
+void printAudioCacheStatus()
+{
+    cacheIndex.printStatus(cacheBudget);
+}
+
+int verifyAudioCache()
+{
+    if (!initializeSDCard())
+    {
+        return 0;
+    }
+    int dropped = cacheIndex.verify(SD_CARD);
+    Logger.printf("🔍 Cache verify: %d file(s) dropped, %u left\n", dropped, (unsigned)cacheIndex.count());
+    return dropped;
+}
+
+int predictAudioKeys(const char* const* audioKeys, int count)
+{
+    clearAudioPrediction();
+    if (!audioKeys || count <= 0 || !initializeSDCard())
+    {
+        return 0;
+    }
+
+    std::vector<std::pair<uint32_t, const AudioEntry*>> ranked;
+    for (int i = 0; i < count; i++)
+    {
+        const AudioEntry* entry = audioKeys[i] ? audioKeyRegistry.getEntry(audioKeys[i]) : nullptr;
+        if (entry) ranked.emplace_back(dialScore(audioKeys[i]), entry);
+    }
+    std::stable_sort(ranked.begin(), ranked.end(),
+        [](const std::pair<uint32_t, const AudioEntry*>& a, const std::pair<uint32_t, const AudioEntry*>& b) {
+            return a.first > b.first;
+        });
+
+    int promoted = 0;
+    for (const auto& r : ranked)
+    {
+        if (promoted >= DIAL_PREDICT_FILES) break;
+        if (isAudioEntryCached(*r.second)) continue;
+        FileData* f = r.second->getFile();
+        if (addToDownloadQueue(f->alternatePath.c_str(), r.second->audioKey.c_str(), f->ext.c_str(),
+                               WebQueue::Priority::PREDICTED)) {
+            promoted++;
+        }
+    }
+    if (promoted > 0)
+    {
+        Logger.debugf("🔮 Fetching %d file(s) ahead of the dial (%d candidate(s))\n", promoted, count);
+    }
+    return promoted;
+}
+
+void clearAudioPrediction()
+{
+    webQueue.demote(WebQueue::Priority::PREDICTED, WebQueue::Priority::PREFETCH);
+}
 
 // ============================================================================
 // REGISTRY INTEGRATION
@@ -0,0 +1,227 @@
+#include "audio_file_stream.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+
+FileReadaheadStream::~FileReadaheadStream()
+{
+    close();
+    if (_reader) {
+        vTaskDelete(_reader);
+        _reader = nullptr;
+    }
+    if (_blocks) {
+        heap_caps_free(_blocks);
+        _blocks = nullptr;
+    }
+}
+
+// ============================================================================
+// OPEN / CLOSE
+// ============================================================================
+
+bool FileReadaheadStream::start()
+{
+    if (_reader) {
+        return true;
+    }
+    if (_unavailable) {
+        return false;
+    }
+    _unavailable = true;  // Until everything below succeeds
+    if (!_blocks) {
+        _blocks = (uint8_t*)heap_caps_malloc(AUDIO_FILE_READAHEAD_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!_blocks) {
+        Logger.println("⚠️ File read-ahead: no PSRAM — files play straight from SD");
+        return false;
+    }
+    if (!_lock) _lock = xSemaphoreCreateMutex();
+    if (!_dataReady) _dataReady = xSemaphoreCreateBinary();
+    if (!_lock || !_dataReady) {
+        return false;
+    }
+    // Core 1 with the rest of the SD I/O; the task sleeps in the SD driver
+    // for most of each read
+    if (xTaskCreatePinnedToCore(readerTask, "FileReader", 4096, this,
+                                AUDIO_FILE_READER_PRIORITY, &_reader, 1) != pdPASS) {
+        _reader = nullptr;
+        Logger.println("⚠️ File read-ahead: reader task failed — files play straight from SD");
+        return false;
+    }
+    _unavailable = false;
+    return true;
+}
+
+bool FileReadaheadStream::open(File& file)
+{
+    close();
+    if (!file || !start()) {
+        return false;
+    }
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _file = file;
+    file = File();
+    _size = _file.size();
+    _position = _file.position();
+    _fileOffset = _position;
+    _filled = 0;
+    _consumed = 0;
+    _blockOffset = 0;
+    _eof = _position >= _size;
+    _starved = false;
+    _open = true;
+    xSemaphoreGive(_lock);
+    stats.files++;
+
+    // First block now, so the decoder's first read doesn't wait for the task
+    fillBlock();
+    xTaskNotifyGive(_reader);
+    return true;
+}
+
+void FileReadaheadStream::close()
+{
+    if (!_open) {
+        return;
+    }
+    // Waits out a read in flight
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _open = false;
+    _file.close();
+    _file = File();
+    _filled = 0;
+    _consumed = 0;
+    xSemaphoreGive(_lock);
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+bool FileReadaheadStream::fillBlock()
+{
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (!_open || _eof || _filled - _consumed >= AUDIO_FILE_READ_BLOCKS) {
+        xSemaphoreGive(_lock);
+        return false;
+    }
+    uint32_t slot = _filled % AUDIO_FILE_READ_BLOCKS;
+    // A file opened mid-block reads up to the boundary first; every later
+    // read is a whole aligned block
+    size_t want = AUDIO_FILE_READ_BLOCK - _fileOffset % AUDIO_FILE_READ_BLOCK;
+    uint32_t startUs = micros();
+    int n = _file.read(_blocks + slot * AUDIO_FILE_READ_BLOCK, want);
+    uint32_t us = micros() - startUs;
+
+    stats.reads++;
+    if (us > stats.maxReadUs) stats.maxReadUs = us;
+    if (n > 0) {
+        _blockLen[slot] = n;
+        _fileOffset += n;
+        stats.bytesRead += n;
+        _filled++;
+    }
+    if (n <= 0 || _fileOffset >= _size) {
+        _eof = true;  // A failed read ends the clip early rather than stalling it
+    }
+    xSemaphoreGive(_lock);
+    xSemaphoreGive(_dataReady);
+    return n > 0;
+}
+
+void FileReadaheadStream::readerTask(void* arg)
+{
+    FileReadaheadStream* self = (FileReadaheadStream*)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (self->fillBlock()) {
+        }
+    }
+}
+
+// ============================================================================
+// READ
+// ============================================================================
+
+size_t FileReadaheadStream::readBytes(uint8_t* data, size_t len)
+{
+    if (!_open) {
+        return 0;
+    }
+    size_t copied = 0;
+    while (copied < len) {
+        if (_consumed == _filled) {
+            // The reader sets _eof after its last _filled++: re-check once seen
+            if (copied > 0 || (_eof && _consumed == _filled)) {
+                break;  // End of file, or hand over what there is
+            }
+            if (_consumed != _filled) {
+                continue;
+            }
+            // Reader fell behind: wait for it rather than report a false end
+            if (!_starved) {
+                _starved = true;
+                stats.underruns++;
+            }
+            unsigned long start = millis();
+            while (_consumed == _filled && !_eof && millis() - start < AUDIO_FILE_WAIT_MS) {
+                xSemaphoreTake(_dataReady, pdMS_TO_TICKS(AUDIO_FILE_WAIT_MS));
+            }
+            stats.waitMs += millis() - start;
+            if (_consumed == _filled) {
+                break;
+            }
+            continue;
+        }
+        _starved = false;
+
+        uint32_t slot = _consumed % AUDIO_FILE_READ_BLOCKS;
+        size_t n = min(len - copied, (size_t)_blockLen[slot] - _blockOffset);
+        memcpy(data + copied, _blocks + slot * AUDIO_FILE_READ_BLOCK + _blockOffset, n);
+        copied += n;
+        _blockOffset += n;
+        _position += n;
+        if (_blockOffset == _blockLen[slot]) {
+            // Block done: the reader can refill it
+            _blockOffset = 0;
+            _consumed++;
+            xTaskNotifyGive(_reader);
+        }
+    }
+    return copied;
+}
+
+int FileReadaheadStream::available()
+{
+    if (!_open || _position >= _size) {
+        return 0;
+    }
+    return (int)min(_size - _position, (size_t)INT32_MAX);
+}
+
+size_t FileReadaheadStream::level() const
+{
+    size_t bytes = 0;
+    for (uint32_t b = _consumed; b != _filled; b++) {
+        bytes += _blockLen[b % AUDIO_FILE_READ_BLOCKS];
+    }
+    return bytes > _blockOffset ? bytes - _blockOffset : 0;
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+void FileReadaheadStream::printStatus() const
+{
+    Logger.printf("📀 File read-ahead: %u/%u bytes buffered (%u x %u-byte reads)%s\n",
+                  (unsigned)level(), (unsigned)AUDIO_FILE_READAHEAD_BYTES, (unsigned)AUDIO_FILE_READ_BLOCKS,
+                  (unsigned)AUDIO_FILE_READ_BLOCK, _open ? "" : ", idle");
+    if (_open) {
+        Logger.printf("   Position %u/%u\n", (unsigned)_position, (unsigned)_size);
+    }
+    Logger.printf("   Files: %u, SD reads: %u (%u bytes), slowest read: %u us\n",
+                  stats.files, stats.reads, stats.bytesRead, stats.maxReadUs);
+    Logger.printf("   Underruns: %u, waited %u ms\n", stats.underruns, stats.waitMs);
+}
@@ -2,7 +2,8 @@
  * @file audio_key_registry.cpp
  * @brief Audio Key Registry Implementation
  * 
- * Implements the unified audio key registry using a single map structure.
+ * Implements the unified audio key registry: entries held by key ID behind
+ * an open-addressing hash index.
  * 
  * @date 2025
  */
@@ -11,12 +12,18 @@
 #include "tone_generators.h"
 #include "file_utils.h"
 #include "logging.h"
+#include "esp_heap_caps.h"
 #include <cstring>
 
+// Index slot markers (key IDs stop short of these)
+static constexpr AudioKeyId INDEX_EMPTY = AUDIO_KEY_NONE;
+static constexpr AudioKeyId INDEX_TOMBSTONE = AUDIO_KEY_NONE - 1;
+
 // ============================================================================
 // STATIC MEMBER DEFINITION
 // ============================================================================
 AudioKeyRegistry AudioKeyRegistry::instance;
+std::atomic<int> AudioKeyRegistry::readers{0};
 
 // ============================================================================
 // KEY REGISTRATION
@@ -26,18 +33,315 @@ AudioKeyRegistry &getAudioKeyRegistry()
     return AudioKeyRegistry::instance;
 }
 
+AudioKeyRegistry::~AudioKeyRegistry() {
+    delete keys.load();
+    for (KeySet* k : retired) {
+        delete k;
+    }
+}
+
+// ============================================================================
+// VERSIONS
+// ============================================================================
+
+const AudioKeyRegistry::KeySet& AudioKeyRegistry::current() const {
+    static const KeySet empty;
+    const KeySet* k = keys.load();
+    return k ? *k : empty;
+}
+
+AudioKeyRegistry::KeySet& AudioKeyRegistry::writable() {
+    KeySet* k = keys.load();
+    if (!k) {
+        k = new KeySet();
+        keys.store(k);
+    }
+    return *k;
+}
+
+void AudioKeyRegistry::release(AudioEntry* e) {
+    if (e && --e->versions == 0) {
+        delete e;
+    }
+}
+
+AudioKeyRegistry* AudioKeyRegistry::beginUpdate() const {
+    const KeySet* k = keys.load();
+    KeySet* copy = k ? k->clone() : new KeySet();
+    if (!copy) {
+        Logger.println("❌ Key registry: no memory for an update");
+        return nullptr;
+    }
+    AudioKeyRegistry* draft = new AudioKeyRegistry();
+    draft->keyResolver = keyResolver;
+    draft->keyExistsCallback = keyExistsCallback;
+    draft->keys.store(copy);
+    return draft;
+}
+
+void AudioKeyRegistry::commitUpdate(AudioKeyRegistry* draft) {
+    if (!draft) return;
+    KeySet* next = draft->keys.exchange(nullptr);
+    delete draft;
+    KeySet* old = keys.exchange(next);
+    if (old) {
+        retired.push_back(old);
+    }
+}
+
+// A reader takes its guard before loading the published pointer, so once the
+// swap is done and the count reads zero, nobody can still reach an old version
+size_t AudioKeyRegistry::reclaimRetired(bool (*playerIdle)()) {
+    if (retired.empty() || readers.load() != 0) return 0;
+    if (playerIdle && !playerIdle()) return 0;
+    size_t freed = retired.size();
+    for (KeySet* k : retired) {
+        delete k;
+    }
+    retired.clear();
+    return freed;
+}
+
+// ============================================================================
+// KEY SET
+// ============================================================================
+
+AudioKeyRegistry::KeySet::~KeySet() {
+    for (AudioEntry* e : entries) {
+        release(e);
+    }
+    heap_caps_free(indexIds);
+    heap_caps_free(indexHashes);
+}
+
+AudioKeyRegistry::KeySet* AudioKeyRegistry::KeySet::clone() const {
+    KeySet* copy = new KeySet();
+    if (indexSlots > 0) {
+        copy->indexIds = (AudioKeyId*)psramAlloc(indexSlots * sizeof(AudioKeyId));
+        copy->indexHashes = (uint32_t*)psramAlloc(indexSlots * sizeof(uint32_t));
+        if (!copy->indexIds || !copy->indexHashes) {
+            delete copy;
+            return nullptr;
+        }
+        memcpy(copy->indexIds, indexIds, indexSlots * sizeof(AudioKeyId));
+        memcpy(copy->indexHashes, indexHashes, indexSlots * sizeof(uint32_t));
+    }
+    copy->indexSlots = indexSlots;
+    copy->indexUsed = indexUsed;
+    copy->entries = entries;
+    for (AudioEntry* e : copy->entries) {
+        if (e) e->versions++;
+    }
+    copy->freeIds = freeIds;
+    copy->liveCount = liveCount;
+    copy->generation = generation;
+    copy->ownedGenerators = ownedGenerators;
+    return copy;
+}
+
+void AudioKeyRegistry::KeySet::clear() {
+    for (AudioEntry* e : entries) {
+        release(e);
+    }
+    entries.clear();
+    freeIds.clear();
+    liveCount = 0;
+    for (size_t i = 0; i < indexSlots; i++) indexIds[i] = INDEX_EMPTY;
+    indexUsed = 0;
+    generation++;
+    ownedGenerators.clear();
+}
+
+// ============================================================================
+// KEY INDEX
+// ============================================================================
+
+uint32_t AudioKeyRegistry::hashKey(const char* key, size_t len) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int AudioKeyRegistry::KeySet::findSlot(const char* key, size_t len, uint32_t hash) const {
+    if (indexSlots == 0) return -1;
+    size_t mask = indexSlots - 1;
+    for (size_t probe = 0, i = hash & mask; probe < indexSlots; probe++, i = (i + 1) & mask) {
+        AudioKeyId id = indexIds[i];
+        if (id == INDEX_EMPTY) return -1;
+        if (id == INDEX_TOMBSTONE || indexHashes[i] != hash) continue;
+        const std::string& stored = entries[id]->audioKey;
+        if (stored.length() == len && memcmp(stored.data(), key, len) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool AudioKeyRegistry::KeySet::growIndex() {
+    size_t slots = indexSlots ? indexSlots * 2 : AUDIO_KEY_INDEX_INITIAL_SLOTS;
+    const uint32_t caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+    AudioKeyId* ids = (AudioKeyId*)heap_caps_malloc(slots * sizeof(AudioKeyId), caps);
+    uint32_t* hashes = (uint32_t*)heap_caps_malloc(slots * sizeof(uint32_t), caps);
+    if (!ids || !hashes) {
+        // No PSRAM: the index is small enough for internal RAM
+        heap_caps_free(ids);
+        heap_caps_free(hashes);
+        ids = (AudioKeyId*)heap_caps_malloc(slots * sizeof(AudioKeyId), MALLOC_CAP_8BIT);
+        hashes = (uint32_t*)heap_caps_malloc(slots * sizeof(uint32_t), MALLOC_CAP_8BIT);
+    }
+    if (!ids || !hashes) {
+        heap_caps_free(ids);
+        heap_caps_free(hashes);
+        Logger.printf("❌ Key index: cannot grow to %u slots\n", (unsigned)slots);
+        return false;
+    }
+    for (size_t i = 0; i < slots; i++) ids[i] = INDEX_EMPTY;
+
+    // Re-insert live keys (drops tombstones)
+    size_t mask = slots - 1;
+    for (size_t i = 0; i < indexSlots; i++) {
+        AudioKeyId id = indexIds[i];
+        if (id == INDEX_EMPTY || id == INDEX_TOMBSTONE) continue;
+        size_t j = indexHashes[i] & mask;
+        while (ids[j] != INDEX_EMPTY) j = (j + 1) & mask;
+        ids[j] = id;
+        hashes[j] = indexHashes[i];
+    }
+    heap_caps_free(indexIds);
+    heap_caps_free(indexHashes);
+    indexIds = ids;
+    indexHashes = hashes;
+    indexSlots = slots;
+    indexUsed = liveCount;
+    return true;
+}
+
+AudioKeyId AudioKeyRegistry::KeySet::findKeyId(const char* key, size_t len) const {
+    int slot = findSlot(key, len, hashKey(key, len));
+    return slot >= 0 ? indexIds[slot] : AUDIO_KEY_NONE;
+}
+
+AudioEntry* AudioKeyRegistry::KeySet::lookup(const char* audioKey) const {
+    if (!audioKey) return nullptr;
+    AudioKeyId id = findKeyId(audioKey, strlen(audioKey));
+    return id != AUDIO_KEY_NONE ? entries[id] : nullptr;
+}
+
+AudioEntry* AudioKeyRegistry::KeySet::own(AudioKeyId id) {
+    AudioEntry* e = entries[id];
+    if (e->versions > 1) {
+        // Another version still reads this one: change a copy
+        AudioEntry* copy = new AudioEntry(*e);
+        e->versions--;
+        entries[id] = copy;
+        return copy;
+    }
+    return e;
+}
+
+AudioEntry* AudioKeyRegistry::KeySet::ownByKey(const char* audioKey) {
+    if (!audioKey) return nullptr;
+    AudioKeyId id = findKeyId(audioKey, strlen(audioKey));
+    return id != AUDIO_KEY_NONE ? own(id) : nullptr;
+}
+
+AudioEntry* AudioKeyRegistry::KeySet::entryFor(const char* audioKey) {
+    size_t len = strlen(audioKey);
+    uint32_t hash = hashKey(audioKey, len);
+    int slot = findSlot(audioKey, len, hash);
+    if (slot >= 0) {
+        return own(indexIds[slot]);
+    }
+
+    // Keep the load under 3/4 so probes stay short; a failed grow still
+    // leaves room until the table is actually full
+    if ((indexUsed + 1) * 4 > indexSlots * 3 && !growIndex() && indexUsed + 1 >= indexSlots) {
+        return nullptr;
+    }
+    if (entries.size() >= INDEX_TOMBSTONE && freeIds.empty()) {
+        Logger.printf("❌ Key index: out of key IDs for %s\n", audioKey);
+        return nullptr;
+    }
+
+    AudioKeyId id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = (AudioKeyId)entries.size();
+        entries.push_back(nullptr);
+    }
+    entries[id] = new AudioEntry();
+    entries[id]->audioKey = audioKey;
+    liveCount++;
+    generation++;
+
+    // Probe for an empty slot or a tombstone to reuse
+    size_t mask = indexSlots - 1;
+    size_t i = hash & mask;
+    while (indexIds[i] != INDEX_EMPTY && indexIds[i] != INDEX_TOMBSTONE) i = (i + 1) & mask;
+    if (indexIds[i] == INDEX_EMPTY) indexUsed++;
+    indexIds[i] = id;
+    indexHashes[i] = hash;
+    return entries[id];
+}
+
+void AudioKeyRegistry::KeySet::store(const char* audioKey, AudioEntry&& entry) {
+    AudioEntry* e = entryFor(audioKey);
+    if (!e) return;
+    // Assign in place so the key keeps its ID
+    *e = std::move(entry);
+    e->audioKey = audioKey;
+}
+
+void AudioKeyRegistry::KeySet::removeKey(const char* audioKey) {
+    size_t len = strlen(audioKey);
+    int slot = findSlot(audioKey, len, hashKey(audioKey, len));
+    if (slot < 0) return;
+    AudioKeyId id = indexIds[slot];
+    indexIds[slot] = INDEX_TOMBSTONE;
+    release(entries[id]);
+    entries[id] = nullptr;
+    freeIds.push_back(id);
+    liveCount--;
+    generation++;
+}
+
+AudioKeyId AudioKeyRegistry::findKeyId(const char* audioKey) const {
+    return audioKey ? findKeyId(audioKey, strlen(audioKey)) : AUDIO_KEY_NONE;
+}
+
+AudioKeyId AudioKeyRegistry::findKeyId(const char* audioKey, size_t len) const {
+    if (!audioKey) return AUDIO_KEY_NONE;
+    return current().findKeyId(audioKey, len);
+}
+
+const AudioEntry* AudioKeyRegistry::getEntry(AudioKeyId id) const {
+    const KeySet& k = current();
+    return id < k.entries.size() ? k.entries[id] : nullptr;
+}
+
+const char* AudioKeyRegistry::getKeyName(AudioKeyId id) const {
+    const AudioEntry* e = getEntry(id);
+    return e ? e->audioKey.c_str() : nullptr;
+}
+
 void AudioKeyRegistry::registerKey(const char* audioKey, const char* path, AudioStreamType type, const char* alternatePath) {
     if (!audioKey || !path) return;
     
     // Never overwrite a generator registration with a file/URL entry
-    auto it = registry.find(std::string(audioKey));
-    if (it != registry.end() && it->second.type == AudioStreamType::GENERATOR) {
+    KeySet& k = writable();
+    const AudioEntry* existing = k.lookup(audioKey);
+    if (existing && existing->type == AudioStreamType::GENERATOR) {
         Logger.printf("⏭️ Skipping registerKey for '%s' — already registered as generator\n", audioKey);
         return;
     }
     
     AudioEntry entry(audioKey, path, type, alternatePath);
-    registry[std::string(audioKey)] = entry;
+    k.store(audioKey, std::move(entry));
     
     if (alternatePath && strlen(alternatePath) > 0) {
         Logger.printf("🔑 Registered audioKey: %s -> %s (streaming: %s)\n", 
@@ -72,9 +376,9 @@ void AudioKeyRegistry::registerKey(const char* audioKey, const char* primaryPath
     // Store the extension so enqueueMissingAudioFilesFromRegistry() can check
     // the correct filename (e.g. .m4a detected from Content-Type, not default .wav)
     if (ext && strlen(ext) > 0) {
-        auto it = registry.find(std::string(audioKey));
-        if (it != registry.end()) {
-            it->second.file->ext = ext;
+        AudioEntry* e = writable().ownByKey(audioKey);
+        if (e && e->getFile()) {
+            e->file->ext = ext;
         }
     }
 }
@@ -101,20 +405,22 @@ void AudioKeyRegistry::registerEntry(AudioEntry&& entry) {
     std::string key = entry.audioKey;
 
     // If replacing an existing owned generator, remove it from ownedGenerators
-    // so we don't accumulate dead generators until clearKeys().
-    auto existing = registry.find(key);
-    if (existing != registry.end()
-        && existing->second.type == AudioStreamType::GENERATOR
-        && existing->second.generator) {
-        auto* old = existing->second.generator;
-        ownedGenerators.erase(
-            std::remove_if(ownedGenerators.begin(), ownedGenerators.end(),
-                [old](const std::unique_ptr<SoundGenerator<int16_t>>& p) { return p.get() == old; }),
-            ownedGenerators.end());
+    // so we don't accumulate dead generators until clearKeys(). Older
+    // versions keep their own reference until they are reclaimed.
+    KeySet& k = writable();
+    const AudioEntry* existing = k.lookup(key.c_str());
+    if (existing
+        && existing->type == AudioStreamType::GENERATOR
+        && existing->generator) {
+        auto* old = existing->generator;
+        k.ownedGenerators.erase(
+            std::remove_if(k.ownedGenerators.begin(), k.ownedGenerators.end(),
+                [old](const std::shared_ptr<SoundGenerator<int16_t>>& p) { return p.get() == old; }),
+            k.ownedGenerators.end());
     }
 
     if (entry.type == AudioStreamType::GENERATOR && entry.generator) {
-        ownedGenerators.emplace_back(entry.generator);
+        k.ownedGenerators.emplace_back(entry.generator);
     } else if (entry.type != AudioStreamType::GENERATOR && entry.file) {
         // URL detection: convert URL primary path to local path + streaming fallback
         if (isUrl(entry.file->path.c_str())) {
@@ -127,25 +433,23 @@ void AudioKeyRegistry::registerEntry(AudioEntry&& entry) {
         }
     }
 
-    registry[key] = std::move(entry);
+    k.store(key.c_str(), std::move(entry));
 }
 
 void AudioKeyRegistry::unregisterKey(const char* audioKey) {
     if (!audioKey) return;
-    registry.erase(std::string(audioKey));
+    writable().removeKey(audioKey);
     Logger.printf("🔑 Unregistered audioKey: %s\n", audioKey);
 }
 
 void AudioKeyRegistry::clearKeys() {
-    registry.clear();
-    ownedGenerators.clear();
+    writable().clear();
     Logger.println("🔑 Cleared all audioKeys");
 }
 
 AudioEntry* AudioKeyRegistry::getEntryMutable(const char* audioKey) {
     if (!audioKey) return nullptr;
-    auto it = registry.find(std::string(audioKey));
-    return (it != registry.end()) ? &it->second : nullptr;
+    return writable().ownByKey(audioKey);
 }
 
 // ============================================================================
@@ -156,7 +460,7 @@ bool AudioKeyRegistry::hasKey(const char* audioKey) const {
     if (!audioKey) return false;
     
     // Check unified registry
-    if (registry.find(std::string(audioKey)) != registry.end()) {
+    if (findKeyId(audioKey) != AUDIO_KEY_NONE) {
         return true;
     }
     
@@ -178,9 +482,9 @@ bool AudioKeyRegistry::hasKeyWithPrefix(const char* prefix) const {
     
     size_t prefixLen = strlen(prefix);
     
-    for (const auto& pair : registry) {
-        if (pair.first.length() >= prefixLen && 
-            pair.first.compare(0, prefixLen, prefix) == 0) {
+    for (const AudioEntry* e : current().entries) {
+        if (e && e->audioKey.length() >= prefixLen &&
+            e->audioKey.compare(0, prefixLen, prefix) == 0) {
             return true;
         }
     }
@@ -191,31 +495,22 @@ bool AudioKeyRegistry::hasKeyWithPrefix(const char* prefix) const {
 const AudioEntry* AudioKeyRegistry::getEntry(const char* audioKey) const {
     if (!audioKey) return nullptr;
     
-    auto it = registry.find(std::string(audioKey));
-    if (it != registry.end()) {
-        return &it->second;
-    }
-    
-    return nullptr;
+    return current().lookup(audioKey);
 }
 
 bool AudioKeyRegistry::hasGenerator(const char* audioKey) const {
     if (!audioKey) return false;
     
-    auto it = registry.find(std::string(audioKey));
-    if (it != registry.end()) {
-        return it->second.isGenerator();
-    }
-    
-    return false;
+    const AudioEntry* e = current().lookup(audioKey);
+    return e && e->isGenerator();
 }
 
 SoundGenerator<int16_t>* AudioKeyRegistry::getGenerator(const char* audioKey) const {
     if (!audioKey) return nullptr;
     
-    auto it = registry.find(std::string(audioKey));
-    if (it != registry.end() && it->second.isGenerator()) {
-        return it->second.generator;
+    const AudioEntry* e = current().lookup(audioKey);
+    if (e && e->isGenerator()) {
+        return e->generator;
     }
     
     return nullptr;
@@ -225,13 +520,13 @@ const char* AudioKeyRegistry::resolveKey(const char* audioKey) const {
     if (!audioKey) return nullptr;
     
     // Check unified registry
-    auto it = registry.find(std::string(audioKey));
-    if (it != registry.end()) {
+    const AudioEntry* e = current().lookup(audioKey);
+    if (e) {
         // Generators don't have paths - return nullptr
-        if (it->second.isGenerator()) {
+        if (e->isGenerator()) {
             return nullptr;
         }
-        return it->second.file->path.c_str();
+        return e->file->path.c_str();
     }
     
     // Try dynamic resolver as fallback
@@ -246,9 +541,9 @@ AudioStreamType AudioKeyRegistry::getKeyType(const char* audioKey) const {
     if (!audioKey) return AudioStreamType::NONE;
     
     // Check unified registry
-    auto it = registry.find(std::string(audioKey));
-    if (it != registry.end()) {
-        return it->second.type;
+    const AudioEntry* e = current().lookup(audioKey);
+    if (e) {
+        return e->type;
     }
     
     // Check for URLs (inline detection)
@@ -266,7 +561,8 @@ AudioStreamType AudioKeyRegistry::getKeyType(const char* audioKey) const {
 }
 
 void AudioKeyRegistry::listKeys() const {
-    int count = registry.size();
+    const KeySet& k = current();
+    int count = (int)k.liveCount;
     
     Logger.printf("📋 Audio Keys (%d total):\n", count);
     Logger.println("============================================================");
@@ -277,8 +573,9 @@ void AudioKeyRegistry::listKeys() const {
     }
     
     int index = 1;
-    for (auto it = registry.begin(); it != registry.end(); ++it) {
-        const KeyEntry& entry = it->second;
+    for (const AudioEntry* e : k.entries) {
+        if (!e) continue;
+        const KeyEntry& entry = *e;
         Logger.printf("%2d. %s\n", index++, entry.audioKey.c_str());
         
         const char* typeStr = "unknown";
@@ -0,0 +1,309 @@
+#include "audio_mixer.h"
+#include "logging.h"
+
+// ============================================================================
+// CHANNELS
+// ============================================================================
+
+int AudioOverlayMixer::claim(const char* key, float gain, unsigned long durationMs)
+{
+    for (int i = 0; i < AUDIO_MIXER_CHANNELS; i++) {
+        Channel& ch = _channels[i];
+        if (ch.active) {
+            continue;
+        }
+        ch = {};
+        strncpy(ch.key, key ? key : "", sizeof(ch.key) - 1);
+        if (gain < 0.0f) gain = 0.0f;
+        if (gain > 1.0f) gain = 1.0f;
+        ch.gainQ15 = (int32_t)(gain * 32767.0f);
+        ch.remainingSamples = (uint32_t)((uint64_t)durationMs * AUDIO_SAMPLE_RATE / 1000) * AUDIO_CHANNELS;
+        return i;
+    }
+    Logger.printf("⚠️ Mixer: no free channel for overlay '%s'\n", key ? key : "");
+    return -1;
+}
+
+int AudioOverlayMixer::start(const char* key, SoundGenerator<int16_t>* generator, float gain,
+                             unsigned long durationMs)
+{
+    if (!generator) {
+        return -1;
+    }
+    int i = claim(key, gain, durationMs);
+    if (i < 0) {
+        return -1;
+    }
+    generator->begin(AUDIO_INFO_DEFAULT());
+    _channels[i].generator = generator;
+    _channels[i].active = true;
+    Logger.printf("🎚️ Overlay %d: generator '%s' (gain %.2f)\n", i, _channels[i].key, gain);
+    return i;
+}
+
+int AudioOverlayMixer::start(const char* key, const PcmCacheEntry* clip, float gain,
+                             unsigned long durationMs)
+{
+    if (!clip || !clip->data) {
+        return -1;
+    }
+    if (clip->info.sample_rate != AUDIO_SAMPLE_RATE || clip->info.channels != AUDIO_CHANNELS) {
+        Logger.printf("⚠️ Mixer: clip '%s' is %dHz/%dch — can't overlay\n", key ? key : "",
+                      (int)clip->info.sample_rate, (int)clip->info.channels);
+        return -1;
+    }
+    int i = claim(key, gain, durationMs);
+    if (i < 0) {
+        return -1;
+    }
+    getAudioPcmCache().pin(clip);
+    _channels[i].clip = clip;
+    _channels[i].active = true;
+    Logger.printf("🎚️ Overlay %d: clip '%s' (%u bytes, gain %.2f)\n", i, _channels[i].key,
+                  (unsigned)clip->length, gain);
+    return i;
+}
+
+void AudioOverlayMixer::release(Channel& ch)
+{
+    if (ch.clip) {
+        getAudioPcmCache().unpin(ch.clip);
+    }
+    ch = {};
+}
+
+void AudioOverlayMixer::stop(const char* key)
+{
+    if (!key) {
+        return;
+    }
+    for (int i = 0; i < AUDIO_MIXER_CHANNELS; i++) {
+        if (_channels[i].active && strcmp(_channels[i].key, key) == 0) {
+            release(_channels[i]);
+        }
+    }
+}
+
+void AudioOverlayMixer::stopAll()
+{
+    for (int i = 0; i < AUDIO_MIXER_CHANNELS; i++) {
+        if (_channels[i].active) {
+            release(_channels[i]);
+        }
+    }
+}
+
+bool AudioOverlayMixer::isActive() const
+{
+    for (int i = 0; i < AUDIO_MIXER_CHANNELS; i++) {
+        if (_channels[i].active) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AudioOverlayMixer::isPlaying(const char* key) const
+{
+    if (!key) {
+        return false;
+    }
+    for (int i = 0; i < AUDIO_MIXER_CHANNELS; i++) {
+        if (_channels[i].active && strcmp(_channels[i].key, key) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// MIXING
+// ============================================================================
+
+void AudioOverlayMixer::setMainGain(float gain)
+{
+    if (gain < 0.0f) gain = 0.0f;
+    if (gain > 1.0f) gain = 1.0f;
+    _mainGainQ15 = (int32_t)(gain * 32768.0f + 0.5f);
+}
+
+// Mixed sample → int16. Below the knee it's unchanged; above, the excess d
+// is mapped to room·d/(d + room), which approaches full scale without
+// reaching it, so overlapping overlays flatten instead of clipping.
+static inline int16_t limitSample(int32_t v)
+{
+#if AUDIO_MIXER_SOFT_LIMIT
+    const uint32_t knee = AUDIO_MIXER_LIMIT_KNEE;
+    const uint32_t room = 32767 - knee;
+    if (v > (int32_t)knee) {
+        uint32_t d = v - knee;
+        return (int16_t)(knee + d * room / (d + room));
+    }
+    if (v < -(int32_t)knee) {
+        uint32_t d = -v - knee;
+        return (int16_t)-(int32_t)(knee + d * room / (d + room));
+    }
+    return (int16_t)v;
+#else
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+#endif
+}
+
+void AudioOverlayMixer::mixInto(size_t samples)
+{
+    if (_format.sample_rate != AUDIO_SAMPLE_RATE || _format.channels != AUDIO_CHANNELS) {
+        return;  // Main stream runs at another format; overlays wait
+    }
+
+    for (int i = 0; i < AUDIO_MIXER_CHANNELS; i++) {
+        Channel& ch = _channels[i];
+        if (!ch.active) {
+            continue;
+        }
+
+        size_t n = samples;
+        if (ch.remainingSamples > 0 && n > ch.remainingSamples) {
+            n = ch.remainingSamples;
+        }
+        const int16_t* source;
+        if (ch.clip) {
+            size_t left = (ch.clip->length - ch.clipPos) / sizeof(int16_t);
+            if (n > left) n = left;
+            source = reinterpret_cast<const int16_t*>(ch.clip->data + ch.clipPos);
+        } else {
+            // Top up what an earlier partial write left unplayed
+            if (ch.heldSamples < n) {
+                size_t got = ch.generator->readBytes(reinterpret_cast<uint8_t*>(ch.held + ch.heldSamples),
+                                                     (n - ch.heldSamples) * sizeof(int16_t));
+                ch.heldSamples += got / sizeof(int16_t);
+            }
+            if (n > ch.heldSamples) n = ch.heldSamples;
+            source = ch.held;
+        }
+
+        // Q15 accumulate; limitSample() brings the sum back into range
+        const int32_t gain = ch.gainQ15;
+        for (size_t s = 0; s < n; s++) {
+            _acc[s] += (source[s] * gain) >> 15;
+        }
+        ch.mixed = n;
+    }
+}
+
+void AudioOverlayMixer::commit(size_t samples)
+{
+    for (int i = 0; i < AUDIO_MIXER_CHANNELS; i++) {
+        Channel& ch = _channels[i];
+        if (!ch.active) {
+            continue;
+        }
+        size_t n = min(samples, ch.mixed);
+        ch.mixed = 0;
+
+        bool finished = false;
+        if (ch.clip) {
+            ch.clipPos += n * sizeof(int16_t);
+            finished = ch.clip->length - ch.clipPos < sizeof(int16_t);
+        } else {
+            ch.heldSamples -= n;
+            memmove(ch.held, ch.held + n, ch.heldSamples * sizeof(int16_t));
+        }
+        if (ch.remainingSamples > 0) {
+            ch.remainingSamples -= n;
+            if (ch.remainingSamples == 0) {
+                finished = true;
+            }
+        }
+        if (finished) {
+            Logger.printf("🎚️ Overlay %d ('%s') finished\n", i, ch.key);
+            release(ch);
+        }
+    }
+}
+
+void AudioOverlayMixer::render(const int16_t* main, int16_t* out, size_t samples)
+{
+    const int32_t gain = _mainGainQ15;
+    if (main && !isActive()) {
+        // Gain alone (≤ unity) can't leave full scale
+        for (size_t s = 0; s < samples; s++) {
+            out[s] = (int16_t)((main[s] * gain) >> 15);
+        }
+        return;
+    }
+
+    if (main) {
+        for (size_t s = 0; s < samples; s++) {
+            _acc[s] = (main[s] * gain) >> 15;
+        }
+    } else {
+        memset(_acc, 0, samples * sizeof(int32_t));
+    }
+    mixInto(samples);
+    for (size_t s = 0; s < samples; s++) {
+        out[s] = limitSample(_acc[s]);
+    }
+}
+
+size_t AudioOverlayMixer::write(const uint8_t* data, size_t len)
+{
+    if (!_output) {
+        return 0;
+    }
+    if (!isActive() && _mainGainQ15 >= 32768) {
+        return _output->write(data, len);
+    }
+
+    // A block at a time; the caller's buffer is const
+    int16_t block[AUDIO_MIXER_BLOCK_SAMPLES];
+    size_t done = 0;
+    while (len - done >= sizeof(int16_t)) {
+        size_t bytes = min(len - done, sizeof(block));
+        bytes -= bytes % sizeof(int16_t);
+        memcpy(block, data + done, bytes);
+        render(block, block, bytes / sizeof(int16_t));
+        size_t written = _output->write(reinterpret_cast<uint8_t*>(block), bytes);
+        commit(written / sizeof(int16_t));
+        done += written;
+        if (written < bytes) {
+            return done;
+        }
+    }
+    if (done < len) {
+        done += _output->write(data + done, len - done);  // Trailing odd byte
+    }
+    return done;
+}
+
+size_t AudioOverlayMixer::pump(size_t bytes)
+{
+    if (!_output || !isActive()) {
+        return 0;
+    }
+    int16_t block[AUDIO_MIXER_BLOCK_SAMPLES];
+    size_t done = 0;
+    while (done < bytes && isActive()) {
+        size_t chunk = min(bytes - done, sizeof(block));
+        chunk -= chunk % (sizeof(int16_t) * AUDIO_CHANNELS);
+        if (chunk == 0) {
+            break;
+        }
+        render(nullptr, block, chunk / sizeof(int16_t));
+        size_t written = _output->write(reinterpret_cast<uint8_t*>(block), chunk);
+        commit(written / sizeof(int16_t));
+        done += written;
+        if (written < chunk) {
+            break;
+        }
+    }
+    return done;
+}
+
+void AudioOverlayMixer::setAudioInfo(AudioInfo info)
+{
+    AudioStream::setAudioInfo(info);
+    _format = info;
+    if (_output) {
+        _output->setAudioInfo(info);
+    }
+}
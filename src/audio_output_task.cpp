@@ -0,0 +1,466 @@
+#include "audio_output_task.h"
+#include "extended_audio_player.h"
+#include "audio_key_registry.h"
+#include "logging.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+
+// ============================================================================
+// PCM RING
+// ============================================================================
+
+bool AudioPcmRing::begin(size_t capacityBytes)
+{
+    end();
+    size_t capacity = 1;
+    while (capacity * 2 <= capacityBytes) {
+        capacity *= 2;
+    }
+    if (capacity <= AUDIO_OUTPUT_HEADROOM_BYTES) {
+        return false;
+    }
+
+    _buffer = (uint8_t*)heap_caps_malloc(capacity, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!_buffer) {
+        // No PSRAM: a quarter-size ring in internal RAM still covers a slow loop()
+        capacity /= 4;
+        if (capacity <= AUDIO_OUTPUT_HEADROOM_BYTES) {
+            return false;
+        }
+        _buffer = (uint8_t*)heap_caps_malloc(capacity, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (!_buffer) {
+        return false;
+    }
+    _mask = capacity - 1;
+    _head = 0;
+    _tail = 0;
+    _flushRequested = false;
+    return true;
+}
+
+void AudioPcmRing::end()
+{
+    if (_buffer) {
+        heap_caps_free(_buffer);
+        _buffer = nullptr;
+    }
+    _mask = 0;
+}
+
+size_t AudioPcmRing::level() const
+{
+    uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    return head - tail;
+}
+
+// Producer (decode task). Waits for room rather than dropping audio. A
+// pending flush stops it short (back-pressure, nothing discarded) so a stop
+// never waits on a full ring; the caller retries once the flush is applied.
+size_t AudioPcmRing::write(const uint8_t* data, size_t len)
+{
+    if (!_buffer) {
+        return 0;
+    }
+
+    size_t done = 0;
+    while (done < len) {
+        if (flushPending()) {
+            return done;
+        }
+        uint32_t head = _head;
+        uint32_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+        size_t space = capacity() - (head - tail);
+        if (space == 0) {
+            vTaskDelay(1);
+            continue;
+        }
+
+        size_t n = min(space, len - done);
+        size_t offset = head & _mask;
+        size_t first = min(n, capacity() - offset);
+        memcpy(_buffer + offset, data + done, first);
+        memcpy(_buffer, data + done + first, n - first);
+        __atomic_store_n(&_head, head + (uint32_t)n, __ATOMIC_RELEASE);
+        done += n;
+    }
+    return len;
+}
+
+// Consumer (output task). Never blocks.
+size_t AudioPcmRing::readBytes(uint8_t* data, size_t len)
+{
+    if (!_buffer) {
+        return 0;
+    }
+    uint32_t tail = _tail;
+    uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    size_t n = min((size_t)(head - tail), len);
+    if (n == 0) {
+        return 0;
+    }
+
+    size_t offset = tail & _mask;
+    size_t first = min(n, capacity() - offset);
+    memcpy(data, _buffer + offset, first);
+    memcpy(data + first, _buffer, n - first);
+    __atomic_store_n(&_tail, tail + (uint32_t)n, __ATOMIC_RELEASE);
+    return n;
+}
+
+void AudioPcmRing::serviceFlush()
+{
+    if (!__atomic_load_n(&_flushRequested, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    __atomic_store_n(&_tail, __atomic_load_n(&_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    __atomic_store_n(&_flushRequested, false, __ATOMIC_RELEASE);
+}
+
+AudioPcmRing& getAudioOutputRing()
+{
+    static AudioPcmRing ring;
+    return ring;
+}
+
+// ============================================================================
+// TASK STATE
+// ============================================================================
+
+static TaskHandle_t decodeTaskHandle = nullptr;
+static TaskHandle_t outputTaskHandle = nullptr;
+static volatile bool audioTasksShouldRun = false;
+static volatile bool playbackActive = false;     // Decode task's view of player->isActive()
+static volatile bool statsResetRequested = false;
+static QueueHandle_t commandQueue = nullptr;
+static AudioStream* outputSink = nullptr;
+static uint32_t nextCommandSequence = 0;
+
+// Counters — each field has a single writer task, except commandTimeouts
+// (any caller of postAudioCommand(), so updated atomically)
+static AudioOutputStats stats = {};
+
+static void resetStatsNow()
+{
+    stats = {};
+    stats.ringLowWater = getAudioOutputRing().capacity();
+}
+
+// ============================================================================
+// OUTPUT TASK — ring → codec
+// ============================================================================
+
+static void audioOutputTaskFunction(void* parameter)
+{
+    AudioPcmRing& ring = getAudioOutputRing();
+    static uint8_t chunk[AUDIO_OUTPUT_CHUNK_BYTES];
+    bool streaming = false;      // Data has flowed since playback (re)started
+    bool inUnderrun = false;
+
+    Logger.printf("🔊 Audio output task started on core %d\n", xPortGetCoreID());
+
+    while (audioTasksShouldRun) {
+        if (statsResetRequested) {
+            resetStatsNow();
+            statsResetRequested = false;
+        }
+        ring.serviceFlush();
+
+        size_t n = ring.readBytes(chunk, sizeof(chunk));
+        if (n > 0) {
+            // Blocks in the I2S driver until DMA has room — this is the pacing
+            outputSink->write(chunk, n);
+            stats.bytesOut += n;
+            streaming = true;
+            inUnderrun = false;
+            if (playbackActive) {
+                uint32_t level = ring.level();
+                if (level < stats.ringLowWater) {
+                    stats.ringLowWater = level;
+                }
+            }
+            continue;
+        }
+
+        if (playbackActive && streaming) {
+            // Dry mid-stream: feed silence so the DAC doesn't replay stale DMA
+            if (!inUnderrun) {
+                stats.underruns++;
+                inUnderrun = true;
+            }
+            memset(chunk, 0, sizeof(chunk));
+            outputSink->write(chunk, sizeof(chunk));
+            stats.underrunBytes += sizeof(chunk);
+            continue;
+        }
+
+        streaming = false;
+        inUnderrun = false;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));   // Woken by the decode task
+    }
+
+    Logger.println("🔊 Audio output task stopped");
+    outputTaskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+// ============================================================================
+// DECODE TASK — commands + player → ring
+// ============================================================================
+
+static void runCommand(ExtendedAudioPlayer& player, const AudioCommand& cmd)
+{
+    bool result = false;
+    switch (cmd.type) {
+        case AudioCommandType::PLAY_KEY:
+            result = player.playAudioKey(cmd.audioKey, cmd.durationMs);
+            break;
+        case AudioCommandType::QUEUE_KEY:
+            result = player.queueAudioKey(cmd.audioKey, cmd.durationMs);
+            break;
+        case AudioCommandType::PLAY_PLAYLIST:
+#if ENABLE_PLAYLIST_FEATURES
+            result = player.playPlaylist(cmd.audioKey);
+#endif
+            break;
+        case AudioCommandType::STOP:
+            player.stop();
+            result = true;
+            break;
+        case AudioCommandType::EMERGENCY_STOP:
+            player.emergencyStop();
+            result = true;
+            break;
+    }
+
+    // Anything but a queue cuts what was playing; stale PCM must not play on
+    if (cmd.type != AudioCommandType::QUEUE_KEY) {
+        getAudioOutputRing().requestFlush();
+    }
+    playbackActive = player.isActive();
+    stats.commands++;
+
+    if (cmd.replyTo != nullptr) {
+        // Low bit is the result, the rest echoes the caller's sequence number
+        xTaskNotify(cmd.replyTo, (cmd.sequence << 1) | (result ? 1 : 0), eSetValueWithOverwrite);
+    }
+}
+
+static void audioDecodeTaskFunction(void* parameter)
+{
+    ExtendedAudioPlayer* player = (ExtendedAudioPlayer*)parameter;
+    AudioPcmRing& ring = getAudioOutputRing();
+    AudioCommand cmd;
+
+    Logger.printf("🔊 Audio decode task started on core %d\n", xPortGetCoreID());
+
+    while (audioTasksShouldRun) {
+        // Pins the registry version this pass resolves keys against
+        AudioKeyRegistry::ReadGuard guard;
+
+        while (xQueueReceive(commandQueue, &cmd, 0) == pdTRUE) {
+            runCommand(*player, cmd);
+        }
+
+        bool active = player->isActive();
+        playbackActive = active;
+        if (!active) {
+            // Idle: sleep until a command arrives
+            xQueuePeek(commandQueue, &cmd, pdMS_TO_TICKS(20));
+            continue;
+        }
+
+        if (ring.availableForWrite() < AUDIO_OUTPUT_HEADROOM_BYTES) {
+            stats.decodeWaits++;
+            xQueuePeek(commandQueue, &cmd, 1);   // Ring is full enough; let it drain
+            continue;
+        }
+
+        if (ring.flushPending()) {
+            // New PCM would be refused until the output task drops the old
+            if (outputTaskHandle != nullptr) {
+                xTaskNotifyGive(outputTaskHandle);
+            }
+            xQueuePeek(commandQueue, &cmd, 1);
+            continue;
+        }
+
+        player->copy();
+        if (outputTaskHandle != nullptr) {
+            xTaskNotifyGive(outputTaskHandle);
+        }
+    }
+
+    Logger.println("🔊 Audio decode task stopped");
+    decodeTaskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+// ============================================================================
+// COMMANDS
+// ============================================================================
+
+bool postAudioCommand(AudioCommandType type, const char* audioKey, unsigned long durationMs)
+{
+    if (commandQueue == nullptr) {
+        return false;
+    }
+
+    AudioCommand cmd = {};
+    cmd.type = type;
+    if (audioKey) {
+        strncpy(cmd.audioKey, audioKey, sizeof(cmd.audioKey) - 1);
+    }
+    cmd.durationMs = durationMs;
+    cmd.replyTo = xTaskGetCurrentTaskHandle();
+    cmd.sequence = __atomic_add_fetch(&nextCommandSequence, 1, __ATOMIC_RELAXED) & 0x7FFFFFFF;
+
+    // Release a decoder blocked on a full ring so the command runs promptly
+    if (type != AudioCommandType::QUEUE_KEY) {
+        getAudioOutputRing().requestFlush();
+    }
+
+    if (xQueueSend(commandQueue, &cmd, pdMS_TO_TICKS(AUDIO_COMMAND_TIMEOUT_MS)) != pdTRUE) {
+        Logger.println("⚠️ Audio command queue full — command dropped");
+        return false;
+    }
+
+    // Skip late replies to earlier commands that timed out
+    const TickType_t timeout = pdMS_TO_TICKS(AUDIO_COMMAND_TIMEOUT_MS);
+    const TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        uint32_t reply = 0;
+        if (elapsed >= timeout ||
+            xTaskNotifyWait(0, 0xFFFFFFFF, &reply, timeout - elapsed) != pdTRUE) {
+            __atomic_add_fetch(&stats.commandTimeouts, 1, __ATOMIC_RELAXED);
+            return true;   // Still queued; assume it will start
+        }
+        if ((reply >> 1) == cmd.sequence) {
+            return (reply & 1) != 0;
+        }
+    }
+}
+
+// ============================================================================
+// START / STOP
+// ============================================================================
+
+bool startAudioOutputTask(ExtendedAudioPlayer& player, AudioStream& sink)
+{
+    if (decodeTaskHandle != nullptr) {
+        return true;
+    }
+
+    AudioPcmRing& ring = getAudioOutputRing();
+    if (!ring.isActive() && !ring.begin(AUDIO_OUTPUT_RING_BYTES)) {
+        Logger.println("❌ Audio output ring allocation failed");
+        return false;
+    }
+    if (commandQueue == nullptr) {
+        commandQueue = xQueueCreate(AUDIO_COMMAND_QUEUE_SIZE, sizeof(AudioCommand));
+        if (commandQueue == nullptr) {
+            Logger.println("❌ Audio command queue allocation failed");
+            return false;
+        }
+    }
+
+    outputSink = &sink;
+    resetStatsNow();
+    audioTasksShouldRun = true;
+
+    // Both on core 1 (Goertzel owns core 0), above loopTask (priority 1):
+    // output preempts decode, decode preempts loop()
+    BaseType_t ok = xTaskCreatePinnedToCore(
+        audioOutputTaskFunction, "AudioOut", 4096, nullptr,
+        AUDIO_OUTPUT_TASK_PRIORITY, &outputTaskHandle, 1);
+    if (ok == pdPASS) {
+        ok = xTaskCreatePinnedToCore(
+            audioDecodeTaskFunction, "AudioDecode", 8192, &player,
+            AUDIO_DECODE_TASK_PRIORITY, &decodeTaskHandle, 1);
+    }
+    if (ok != pdPASS) {
+        Logger.println("❌ Audio task creation failed");
+        stopAudioOutputTask();
+        return false;
+    }
+
+    Logger.printf("🔊 Audio output ring: %u bytes (%.0fms)\n", (unsigned)ring.capacity(),
+                  ring.capacity() * 1000.0f /
+                  (AUDIO_SAMPLE_RATE * AUDIO_CHANNELS * (AUDIO_BITS_PER_SAMPLE / 8)));
+    return true;
+}
+
+void stopAudioOutputTask()
+{
+    audioTasksShouldRun = false;
+    getAudioOutputRing().requestFlush();   // Unblock a waiting writer
+
+    int timeout = 500;
+    while ((decodeTaskHandle != nullptr || outputTaskHandle != nullptr) && timeout > 0) {
+        if (outputTaskHandle != nullptr) {
+            xTaskNotifyGive(outputTaskHandle);
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+        timeout -= 10;
+    }
+    if (decodeTaskHandle != nullptr) {
+        vTaskDelete(decodeTaskHandle);
+        decodeTaskHandle = nullptr;
+    }
+    if (outputTaskHandle != nullptr) {
+        vTaskDelete(outputTaskHandle);
+        outputTaskHandle = nullptr;
+    }
+    playbackActive = false;
+}
+
+bool isAudioOutputTaskRunning()
+{
+    return decodeTaskHandle != nullptr && audioTasksShouldRun;
+}
+
+bool isAudioDecodeTaskContext()
+{
+    return decodeTaskHandle != nullptr && xTaskGetCurrentTaskHandle() == decodeTaskHandle;
+}
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+AudioOutputStats getAudioOutputStats()
+{
+    AudioOutputStats s = stats;
+    AudioPcmRing& ring = getAudioOutputRing();
+    s.ringLevel = ring.level();
+    s.ringCapacity = ring.capacity();
+    return s;
+}
+
+void resetAudioOutputStats()
+{
+    if (outputTaskHandle != nullptr) {
+        statsResetRequested = true;   // Applied by the output task
+    } else {
+        resetStatsNow();
+    }
+}
+
+void printAudioOutputStats()
+{
+    if (!isAudioOutputTaskRunning()) {
+        Logger.println("🔊 Audio output task not running (AUDIO_OUTPUT_TASK_ENABLED=0 or start failed)");
+        return;
+    }
+    AudioOutputStats s = getAudioOutputStats();
+    const float bytesPerMs = AUDIO_SAMPLE_RATE * AUDIO_CHANNELS * (AUDIO_BITS_PER_SAMPLE / 8) / 1000.0f;
+    Logger.println("🔊 Audio output task stats:");
+    Logger.printf("   Ring: %u/%u bytes (%.0fms), low water %u (%.0fms)\n",
+                  s.ringLevel, s.ringCapacity, s.ringLevel / bytesPerMs,
+                  s.ringLowWater, s.ringLowWater / bytesPerMs);
+    Logger.printf("   Underruns: %u (%.0fms of silence)\n", s.underruns, s.underrunBytes / bytesPerMs);
+    Logger.printf("   Output: %u bytes, decoder waits %u\n", s.bytesOut, s.decodeWaits);
+    Logger.printf("   Commands: %u (%u timed out)\n", s.commands, s.commandTimeouts);
+}
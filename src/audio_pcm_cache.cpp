@@ -0,0 +1,298 @@
+#include "audio_pcm_cache.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+
+// ============================================================================
+// LOOKUP
+// ============================================================================
+
+AudioPcmCache& getAudioPcmCache()
+{
+    static AudioPcmCache cache;
+    return cache;
+}
+
+const PcmCacheEntry* AudioPcmCache::lookup(const char* path, size_t fileSize, time_t mtime)
+{
+    if (!path) {
+        return nullptr;
+    }
+    for (int i = 0; i < AUDIO_PCM_CACHE_MAX_ENTRIES; i++) {
+        PcmCacheEntry& e = entries[i];
+        if (!e.data || strcmp(e.path, path) != 0) {
+            continue;
+        }
+        if (e.fileSize == fileSize && e.mtime == mtime) {
+            e.lastUsed = ++useTick;
+            stats.hits++;
+            return &e;
+        }
+        // Same path, different file: the clip was replaced on SD
+        if (e.pins == 0) {
+            Logger.printf("🗃️ PCM cache: %s changed on SD — dropping stale entry\n", path);
+            freeEntry(i);
+        }
+        break;
+    }
+    stats.misses++;
+    return nullptr;
+}
+
+const PcmCacheEntry* AudioPcmCache::peek(const char* path)
+{
+    if (!path) {
+        return nullptr;
+    }
+    for (int i = 0; i < AUDIO_PCM_CACHE_MAX_ENTRIES; i++) {
+        PcmCacheEntry& e = entries[i];
+        if (e.data && strcmp(e.path, path) == 0) {
+            e.lastUsed = ++useTick;
+            stats.hits++;
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+int AudioPcmCache::indexOf(const PcmCacheEntry* entry) const
+{
+    for (int i = 0; i < AUDIO_PCM_CACHE_MAX_ENTRIES; i++) {
+        if (&entries[i] == entry) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void AudioPcmCache::pin(const PcmCacheEntry* entry)
+{
+    int i = indexOf(entry);
+    if (i >= 0 && entries[i].pins < 255) {
+        entries[i].pins++;
+    }
+}
+
+void AudioPcmCache::unpin(const PcmCacheEntry* entry)
+{
+    int i = indexOf(entry);
+    if (i >= 0 && entries[i].pins > 0) {
+        entries[i].pins--;
+    }
+}
+
+int AudioPcmCache::entryCount() const
+{
+    int count = 0;
+    for (int i = 0; i < AUDIO_PCM_CACHE_MAX_ENTRIES; i++) {
+        if (entries[i].data) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// CAPTURE
+// ============================================================================
+
+bool AudioPcmCache::beginCapture(const char* path, size_t fileSize, time_t mtime)
+{
+    abortCapture();
+    if (!path || strlen(path) >= sizeof(pending.path)) {
+        return false;
+    }
+    strncpy(pending.path, path, sizeof(pending.path) - 1);
+    pending.path[sizeof(pending.path) - 1] = '\0';
+    pending.fileSize = fileSize;
+    pending.mtime = mtime;
+    pending.length = 0;
+    capturing = true;
+    return true;
+}
+
+void AudioPcmCache::append(const uint8_t* data, size_t len)
+{
+    if (!capturing || len == 0) {
+        return;
+    }
+    size_t needed = pending.length + len;
+    if (needed > AUDIO_PCM_CACHE_MAX_CLIP_BYTES) {
+        Logger.printf("🗃️ PCM cache: %s decodes past %u bytes — not cached\n",
+                      pending.path, (unsigned)AUDIO_PCM_CACHE_MAX_CLIP_BYTES);
+        abortCapture();
+        stats.abandoned++;
+        return;
+    }
+    if (needed > pendingCapacity) {
+        size_t capacity = pendingCapacity + AUDIO_PCM_CACHE_GROW_BYTES;
+        while (capacity < needed) {
+            capacity += AUDIO_PCM_CACHE_GROW_BYTES;
+        }
+        if (capacity > AUDIO_PCM_CACHE_MAX_CLIP_BYTES) {
+            capacity = AUDIO_PCM_CACHE_MAX_CLIP_BYTES;
+        }
+        uint8_t* grown = (uint8_t*)heap_caps_realloc(pending.data, capacity,
+                                                     MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!grown) {
+            abortCapture();   // No PSRAM (or full) — the cache simply stays cold
+            stats.abandoned++;
+            return;
+        }
+        pending.data = grown;
+        pendingCapacity = capacity;
+    }
+    memcpy(pending.data + pending.length, data, len);
+    pending.length = needed;
+}
+
+bool AudioPcmCache::commitCapture()
+{
+    if (!capturing) {
+        return false;
+    }
+    if (pending.length == 0) {
+        abortCapture();
+        return false;
+    }
+
+    // Make room: budget first, then a free slot
+    while (used + pending.length > AUDIO_PCM_CACHE_BUDGET_BYTES) {
+        if (!evictLeastRecent()) {
+            abortCapture();
+            stats.abandoned++;
+            return false;
+        }
+    }
+    int slot = findFreeSlot();
+    if (slot < 0) {
+        if (!evictLeastRecent()) {
+            abortCapture();
+            stats.abandoned++;
+            return false;
+        }
+        slot = findFreeSlot();
+    }
+
+    // Trim the growth slack before keeping it
+    uint8_t* exact = (uint8_t*)heap_caps_realloc(pending.data, pending.length,
+                                                 MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (exact) {
+        pending.data = exact;
+    }
+    pending.info = lastInfo;
+    pending.lastUsed = ++useTick;
+    entries[slot] = pending;
+    used += pending.length;
+    stats.captures++;
+
+    Logger.printf("🗃️ PCM cache: stored %s (%u bytes, %dHz/%dch) — %u/%u bytes used\n",
+                  pending.path, (unsigned)pending.length, (int)pending.info.sample_rate,
+                  (int)pending.info.channels, (unsigned)used,
+                  (unsigned)AUDIO_PCM_CACHE_BUDGET_BYTES);
+
+    pending = {};
+    pendingCapacity = 0;
+    capturing = false;
+    return true;
+}
+
+void AudioPcmCache::abortCapture()
+{
+    if (pending.data) {
+        heap_caps_free(pending.data);
+    }
+    pending = {};
+    pendingCapacity = 0;
+    capturing = false;
+}
+
+// ============================================================================
+// EVICTION
+// ============================================================================
+
+void AudioPcmCache::freeEntry(int index)
+{
+    PcmCacheEntry& e = entries[index];
+    if (e.data) {
+        heap_caps_free(e.data);
+        used -= e.length;
+    }
+    e = {};
+}
+
+int AudioPcmCache::findFreeSlot()
+{
+    for (int i = 0; i < AUDIO_PCM_CACHE_MAX_ENTRIES; i++) {
+        if (!entries[i].data) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool AudioPcmCache::evictLeastRecent()
+{
+    int victim = -1;
+    for (int i = 0; i < AUDIO_PCM_CACHE_MAX_ENTRIES; i++) {
+        if (!entries[i].data || entries[i].pins > 0) {
+            continue;
+        }
+        if (victim < 0 || entries[i].lastUsed < entries[victim].lastUsed) {
+            victim = i;
+        }
+    }
+    if (victim < 0) {
+        return false;
+    }
+    Logger.printf("🗃️ PCM cache: evicting %s (%u bytes)\n",
+                  entries[victim].path, (unsigned)entries[victim].length);
+    freeEntry(victim);
+    stats.evictions++;
+    return true;
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+void AudioPcmCache::printStatus() const
+{
+    Logger.printf("🗃️ PCM cache: %d entries, %u/%u bytes\n", entryCount(),
+                  (unsigned)used, (unsigned)AUDIO_PCM_CACHE_BUDGET_BYTES);
+    Logger.printf("   Hits: %u, misses: %u, stored: %u, abandoned: %u, evicted: %u\n",
+                  stats.hits, stats.misses, stats.captures, stats.abandoned, stats.evictions);
+    for (int i = 0; i < AUDIO_PCM_CACHE_MAX_ENTRIES; i++) {
+        const PcmCacheEntry& e = entries[i];
+        if (!e.data) {
+            continue;
+        }
+        Logger.printf("   %s%s: %u bytes, %dHz/%dch\n", e.path, e.pins > 0 ? " (playing)" : "",
+                      (unsigned)e.length, (int)e.info.sample_rate, (int)e.info.channels);
+    }
+}
+
+// ============================================================================
+// CAPTURE STAGE
+// ============================================================================
+
+void PcmCaptureStream::setAudioInfo(AudioInfo info)
+{
+    AudioStream::setAudioInfo(info);
+    getAudioPcmCache().noteAudioInfo(info);
+    if (_output) {
+        _output->setAudioInfo(info);
+    }
+}
+
+size_t PcmCaptureStream::write(const uint8_t* data, size_t len)
+{
+    if (!_output) {
+        return 0;
+    }
+    size_t written = _output->write(data, len);
+    AudioPcmCache& cache = getAudioPcmCache();
+    if (cache.isCapturing()) {
+        cache.append(data, written);
+    }
+    return written;
+}
@@ -203,11 +203,124 @@ size_t AudioPlaylistRegistry::resolveAllPlaylists() {
     for (auto& kv : playlists) {
         total += resolvePlaylist(kv.first.c_str());
     }
+    rebuildCompiled();
     
     Logger.printf("📋 Resolved all playlists: %d total nodes\n", (int)total);
     return total;
 }
 
+size_t AudioPlaylistRegistry::resolvePlaylistsReferencing(PlaylistKeyFilter filter, void* userData) {
+    if (!filter) return 0;
+    
+    size_t total = 0;
+    size_t resolved = 0;
+    for (auto& kv : playlists) {
+        for (const auto& node : kv.second.nodes) {
+            if (filter(node.audioKey.c_str(), userData)) {
+                total += resolvePlaylist(kv.first.c_str());
+                resolved++;
+                break;
+            }
+        }
+    }
+    
+    if (resolved > 0) {
+        rebuildCompiled();
+    }
+    
+    Logger.printf("📋 Re-resolved %d/%d playlists: %d total nodes\n",
+                  (int)resolved, (int)playlists.size(), (int)total);
+    return total;
+}
+
+// ============================================================================
+// COMPILED PLAYLISTS
+// ============================================================================
+
+static uint16_t packGap(unsigned long gapMs) {
+    unsigned long cs = (gapMs + 5) / 10;
+    return cs > UINT16_MAX ? UINT16_MAX : (uint16_t)cs;
+}
+
+// One pass over the map (already in name order) into the idle arena:
+//   CompiledTable | CompiledPlaylist[n] | per playlist: name, node array
+// Nodes whose key is not registered are dropped; playback skipped them anyway.
+size_t AudioPlaylistRegistry::rebuildCompiled() {
+    PsramArena& arena = arenas[idleArena];
+    arena.reset();
+    
+    CompiledTable* table = arena.allocArray<CompiledTable>(1);
+    CompiledPlaylist* items = playlists.empty() ? nullptr
+        : arena.allocArray<CompiledPlaylist>(playlists.size());
+    if (!table || (!items && !playlists.empty())) {
+        Logger.println("❌ Out of memory compiling playlists");
+        return 0;
+    }
+    
+    size_t count = 0;
+    size_t nodeTotal = 0;
+    for (const auto& kv : playlists) {
+        const Playlist& playlist = kv.second;
+        
+        size_t nameLen = kv.first.length() + 1;
+        char* name = static_cast<char*>(arena.alloc(nameLen, 1));
+        PackedPlaylistNode* nodes = playlist.nodes.empty() ? nullptr
+            : arena.allocArray<PackedPlaylistNode>(playlist.nodes.size());
+        if (!name || (!nodes && !playlist.nodes.empty())) {
+            Logger.println("❌ Out of memory compiling playlists");
+            return 0;
+        }
+        memcpy(name, kv.first.c_str(), nameLen);
+        
+        uint32_t n = 0;
+        for (const auto& node : playlist.nodes) {
+            AudioKeyId id = keyRegistry ? keyRegistry->findKeyId(node.getAudioKey()) : AUDIO_KEY_NONE;
+            if (id == AUDIO_KEY_NONE) continue;
+            nodes[n++] = { id, packGap(node.gap), (uint32_t)node.durationMs };
+        }
+        items[count++] = { name, nodes, n };
+        nodeTotal += n;
+    }
+    table->playlists = items;
+    table->count = count;
+    
+    compiled.store(table, std::memory_order_release);
+    idleArena ^= 1;
+    
+    LOG_PRINTF(AUDIO, "📋 Compiled %d playlists, %d nodes, %u bytes\n",
+               (int)count, (int)nodeTotal, (unsigned)arena.used());
+    return nodeTotal;
+}
+
+const AudioPlaylistRegistry::CompiledPlaylist* AudioPlaylistRegistry::findCompiled(const char* name) const {
+    const CompiledTable* table = compiled.load(std::memory_order_acquire);
+    if (!name || !table) return nullptr;
+    
+    size_t lo = 0, hi = table->count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int cmp = strcmp(table->playlists[mid].name, name);
+        if (cmp == 0) return &table->playlists[mid];
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return nullptr;
+}
+
+PlaylistSpan AudioPlaylistRegistry::getPlaylistSpan(const char* name) const {
+    PlaylistSpan span;
+    const CompiledPlaylist* playlist = findCompiled(name);
+    if (playlist) {
+        span.nodes = playlist->nodes;
+        span.count = playlist->count;
+    }
+    return span;
+}
+
+bool AudioPlaylistRegistry::hasCompiledPlaylist(const char* name) const {
+    return findCompiled(name) != nullptr;
+}
+
 // ============================================================================
 // PLAYLIST MEMBER FUNCTIONS
 // ============================================================================
@@ -0,0 +1,122 @@
+#include "audio_queue.h"
+
+static_assert(AUDIO_QUEUE_CAPACITY <= 255, "QueueKeyId is 8-bit");
+
+// ============================================================================
+// KEY TABLE
+// ============================================================================
+
+uint32_t AudioQueue::hashKey(const char* key)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*key) {
+        hash = (hash ^ (uint8_t)*key++) * 16777619u;
+    }
+    return hash;
+}
+
+int AudioQueue::intern(const char* key, uint32_t hash)
+{
+    int unused = -1;
+    for (int i = 0; i < AUDIO_QUEUE_CAPACITY; i++) {
+        KeySlot& slot = _keys[i];
+        if (slot.key[0] != '\0' && slot.hash == hash && strcmp(slot.key, key) == 0) {
+            return i;
+        }
+        // Prefer a never-used slot over evicting a remembered key
+        if (slot.refs == 0 && (unused < 0 || slot.key[0] == '\0')) {
+            unused = i;
+        }
+    }
+    if (unused >= 0) {
+        KeySlot& slot = _keys[unused];
+        strncpy(slot.key, key, sizeof(slot.key) - 1);
+        slot.key[sizeof(slot.key) - 1] = '\0';
+        slot.hash = hash;
+    }
+    return unused;
+}
+
+void AudioQueue::copyKey(QueueKeyId id, char* key, size_t keySize) const
+{
+    if (key && keySize > 0) {
+        strncpy(key, _keys[id].key, keySize - 1);
+        key[keySize - 1] = '\0';
+    }
+}
+
+// ============================================================================
+// QUEUE
+// ============================================================================
+
+bool AudioQueue::push(AudioStreamType type, const char* audioKey, unsigned long durationMs)
+{
+    if (!audioKey || audioKey[0] == '\0' || strlen(audioKey) >= AUDIO_QUEUE_KEY_LENGTH) {
+        return false;
+    }
+    uint32_t hash = hashKey(audioKey);
+
+    bool pushed = false;
+    portENTER_CRITICAL(&_lock);
+    if (_head - _tail < AUDIO_QUEUE_CAPACITY) {
+        int id = intern(audioKey, hash);
+        if (id >= 0) {
+            _keys[id].refs++;
+            QueuedAudioItem& item = _items[_head % AUDIO_QUEUE_CAPACITY];
+            item.type = type;
+            item.keyId = (QueueKeyId)id;
+            item.durationMs = durationMs;
+            _head++;
+            pushed = true;
+        }
+    }
+    portEXIT_CRITICAL(&_lock);
+    return pushed;
+}
+
+bool AudioQueue::pop(QueuedAudioItem& item, char* key, size_t keySize)
+{
+    bool popped = false;
+    portENTER_CRITICAL(&_lock);
+    if (_head != _tail) {
+        item = _items[_tail % AUDIO_QUEUE_CAPACITY];
+        copyKey(item.keyId, key, keySize);
+        _keys[item.keyId].refs--;
+        _tail++;
+        popped = true;
+    }
+    portEXIT_CRITICAL(&_lock);
+    return popped;
+}
+
+bool AudioQueue::peek(QueuedAudioItem& item, char* key, size_t keySize) const
+{
+    bool found = false;
+    portENTER_CRITICAL(&_lock);
+    if (_head != _tail) {
+        item = _items[_tail % AUDIO_QUEUE_CAPACITY];
+        copyKey(item.keyId, key, keySize);
+        found = true;
+    }
+    portEXIT_CRITICAL(&_lock);
+    return found;
+}
+
+void AudioQueue::clear()
+{
+    portENTER_CRITICAL(&_lock);
+    for (int i = 0; i < AUDIO_QUEUE_CAPACITY; i++) {
+        _keys[i].refs = 0;
+    }
+    _tail = _head;
+    portEXIT_CRITICAL(&_lock);
+}
+
+size_t AudioQueue::size() const
+{
+    portENTER_CRITICAL(&_lock);
+    size_t count = _head - _tail;
+    portEXIT_CRITICAL(&_lock);
+    return count;
+}
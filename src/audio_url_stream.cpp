@@ -0,0 +1,263 @@
+#include "audio_url_stream.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+
+// SD card abstraction: use SD_MMC or SPI SD based on compile-time config
+#if SD_USE_MMC
+  #define SD_FS        SD_MMC
+#else
+  #define SD_FS        SD
+#endif
+
+UrlJitterStream::~UrlJitterStream()
+{
+    close();
+    if (_buffer) {
+        heap_caps_free(_buffer);
+        _buffer = nullptr;
+    }
+}
+
+// ============================================================================
+// OPEN / CLOSE
+// ============================================================================
+
+bool UrlJitterStream::allocate()
+{
+    if (_buffer) {
+        return true;
+    }
+    size_t capacity = (size_t)AUDIO_URL_JITTER_MS * AUDIO_URL_BYTES_PER_MS;
+    _buffer = (uint8_t*)heap_caps_malloc(capacity, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!_buffer) {
+        // No PSRAM: pass reads straight through, as plain URLStream did
+        Logger.println("⚠️ URL jitter buffer: no PSRAM — streaming unbuffered");
+        return false;
+    }
+    _capacity = capacity;
+    return true;
+}
+
+bool UrlJitterStream::open(URLStream& source, const char* cachePath)
+{
+    close();
+    _source = &source;
+    _head = 0;
+    _tail = 0;
+    _starved = false;
+    _received = 0;
+    _contentLength = source.httpRequest().contentLength();
+    stats.streams++;
+
+    openCache(cachePath);
+
+    if (!allocate()) {
+        return true;
+    }
+
+    // Pre-buffer so the decoder starts with a cushion instead of the first packet
+    size_t target = min(_capacity, (size_t)AUDIO_URL_PREBUFFER_MS * AUDIO_URL_BYTES_PER_MS);
+    if (_contentLength > 0) {
+        target = min(target, (size_t)_contentLength);
+    }
+    unsigned long start = millis();
+    while (level() < target && millis() - start < AUDIO_URL_PREBUFFER_TIMEOUT_MS) {
+        if (fill(target - level()) == 0) {
+            delay(2);
+        }
+    }
+    stats.lastPrebufferMs = millis() - start;
+
+    if (level() == 0) {
+        Logger.printf("❌ URL stream: nothing received in %lu ms\n", (unsigned long)stats.lastPrebufferMs);
+        close();
+        return false;
+    }
+    Logger.printf("🌐 Pre-buffered %u bytes in %lu ms%s\n", (unsigned)level(),
+                  (unsigned long)stats.lastPrebufferMs, _cacheFile ? " (caching to SD)" : "");
+    return true;
+}
+
+void UrlJitterStream::close()
+{
+    if (_cacheFile) {
+        discardCache("stream stopped early");
+    }
+    _source = nullptr;
+    _head = 0;
+    _tail = 0;
+}
+
+// ============================================================================
+// READ
+// ============================================================================
+
+size_t UrlJitterStream::fill(size_t maxBytes)
+{
+    if (!_source || !_buffer) {
+        return 0;
+    }
+    size_t total = 0;
+    while (total < maxBytes) {
+        size_t room = _capacity - level();
+        int ready = _source->available();
+        if (room == 0 || ready <= 0) {
+            break;
+        }
+        // Contiguous space up to the end of the ring
+        size_t offset = _head % _capacity;
+        size_t n = min(min(room, _capacity - offset), min((size_t)ready, maxBytes - total));
+        n = _source->readBytes(_buffer + offset, n);
+        if (n == 0) {
+            break;
+        }
+        teeToCache(_buffer + offset, n);
+        _head += n;
+        total += n;
+    }
+    stats.bytesIn += total;
+    return total;
+}
+
+size_t UrlJitterStream::readBytes(uint8_t* data, size_t len)
+{
+    if (!_source) {
+        return 0;
+    }
+    if (!_buffer) {
+        size_t n = _source->readBytes(data, len);
+        stats.bytesIn += n;
+        teeToCache(data, n);
+        return n;
+    }
+
+    fill(AUDIO_URL_FILL_BYTES);
+
+    size_t n = min(len, level());
+    size_t offset = _tail % _capacity;
+    size_t first = min(n, _capacity - offset);
+    memcpy(data, _buffer + offset, first);
+    memcpy(data + first, _buffer, n - first);
+    _tail += n;
+
+    // Still expecting bytes but none buffered: the network fell behind
+    bool expecting = _contentLength <= 0 || _received < _contentLength;
+    if (n == 0 && expecting && !_starved) {
+        _starved = true;
+        stats.underruns++;
+    } else if (n > 0) {
+        _starved = false;
+    }
+    return n;
+}
+
+int UrlJitterStream::available()
+{
+    if (!_source) {
+        return 0;
+    }
+    if (!_buffer) {
+        return _source->available();
+    }
+    fill(AUDIO_URL_FILL_BYTES);
+    return (int)level();
+}
+
+// ============================================================================
+// SD WRITE-THROUGH
+// ============================================================================
+
+void UrlJitterStream::openCache(const char* cachePath)
+{
+    _cachePath[0] = '\0';
+    if (!cachePath || cachePath[0] == '\0') {
+        return;
+    }
+    if (strlen(cachePath) >= sizeof(_cachePath)) {
+        return;
+    }
+    if (_contentLength <= 0) {
+        // Without a length a dropped connection can't be told from the end of the file
+        Logger.printf("🌐 No Content-Length — not caching %s\n", cachePath);
+        return;
+    }
+    strncpy(_cachePath, cachePath, sizeof(_cachePath) - 1);
+    snprintf(_partPath, sizeof(_partPath), "%s.part", _cachePath);
+    // The file's shard directory may not exist yet
+    char dir[sizeof(_cachePath)];
+    strncpy(dir, _cachePath, sizeof(dir));
+    char* slash = strrchr(dir, '/');
+    if (slash && slash != dir) {
+        *slash = '\0';
+        if (!SD_FS.exists(dir)) SD_FS.mkdir(dir);
+    }
+    _cacheFile = SD_FS.open(_partPath, FILE_WRITE);
+    if (!_cacheFile) {
+        Logger.printf("⚠️ Cannot create %s — streaming without cache\n", _partPath);
+        _cachePath[0] = '\0';
+    }
+}
+
+void UrlJitterStream::teeToCache(const uint8_t* data, size_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    _received += len;
+    if (!_cacheFile) {
+        return;
+    }
+    if (_cacheFile.write(data, len) != len) {
+        discardCache("SD write failed");
+        return;
+    }
+    if (_received >= _contentLength) {
+        commitCache();
+    }
+}
+
+void UrlJitterStream::commitCache()
+{
+    _cacheFile.close();
+    if (_received != _contentLength) {
+        SD_FS.remove(_partPath);
+        Logger.printf("⚠️ %s: got %d bytes, expected %d — not cached\n",
+                      _cachePath, _received, _contentLength);
+        stats.cacheDiscarded++;
+        return;
+    }
+    if (SD_FS.exists(_cachePath)) {
+        SD_FS.remove(_cachePath);
+    }
+    if (!SD_FS.rename(_partPath, _cachePath)) {
+        SD_FS.remove(_partPath);
+        Logger.printf("⚠️ Cannot rename %s — not cached\n", _partPath);
+        stats.cacheDiscarded++;
+        return;
+    }
+    Logger.printf("💾 Streamed %d bytes → %s\n", _received, _cachePath);
+    stats.cached++;
+}
+
+void UrlJitterStream::discardCache(const char* reason)
+{
+    _cacheFile.close();
+    SD_FS.remove(_partPath);
+    Logger.printf("🗑️ %s not cached (%s, %d/%d bytes)\n", _cachePath, reason,
+                  _received, _contentLength);
+    stats.cacheDiscarded++;
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+void UrlJitterStream::printStatus() const
+{
+    Logger.printf("🌐 URL jitter buffer: %u/%u bytes (%d ms @ %d kbps)%s\n",
+                  (unsigned)level(), (unsigned)_capacity, AUDIO_URL_JITTER_MS,
+                  AUDIO_URL_ASSUMED_KBPS, _source ? "" : ", idle");
+    Logger.printf("   Streams: %u, bytes in: %u, underruns: %u, last pre-buffer: %u ms\n",
+                  stats.streams, stats.bytesIn, stats.underruns, stats.lastPrebufferMs);
+    Logger.printf("   Written through to SD: %u, discarded: %u\n", stats.cached, stats.cacheDiscarded);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file boot_pipeline.cpp
+ * @brief Boot stages with dependencies, each timed in µs since reset
+ *
+ * @date 2026
+ */
+
+#include "boot_pipeline.h"
+#include "logging.h"
+#include "esp_timer.h"
+
+BootPipeline bootPipeline;
+
+static const char* const STAGE_NAMES[(int)BootStage::COUNT] = {
+    "audio_kit", "player", "dtmf", "phone", "storage", "catalog", "wifi", "vpn",
+};
+
+const char* BootPipeline::name(BootStage s) {
+    return s < BootStage::COUNT ? STAGE_NAMES[(int)s] : "?";
+}
+
+// The event group is created by the first call, which setup() makes
+bool BootPipeline::start() {
+    if (!_ended) _ended = xEventGroupCreate();
+    return _ended != nullptr;
+}
+
+// ============================================================================
+// Stages
+// ============================================================================
+
+void BootPipeline::begin(BootStage s) {
+    if (s >= BootStage::COUNT) return;
+    start();
+    Record& r = _rec[(int)s];
+    portENTER_CRITICAL(&_mux);
+    if (r.startUs == 0) {
+        r.startUs = esp_timer_get_time();
+        r.core = (int8_t)xPortGetCoreID();
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void BootPipeline::end(BootStage s, bool ok) {
+    if (s >= BootStage::COUNT) return;
+    begin(s);                           // A stage marked only at its end took no time
+    Record& r = _rec[(int)s];
+    portENTER_CRITICAL(&_mux);
+    bool first = r.endUs == 0;
+    if (first) {
+        r.endUs = esp_timer_get_time();
+        r.ok = ok;
+    }
+    portEXIT_CRITICAL(&_mux);
+    if (!first) return;
+    if (_ended) xEventGroupSetBits(_ended, BOOT_BIT(s));
+    Logger.printf("⏱️ [BOOT] %s %s at %lu ms (%lu ms)\n", name(s), ok ? "done" : "failed",
+                  (unsigned long)(r.endUs / 1000), (unsigned long)((r.endUs - r.startUs) / 1000));
+}
+
+bool BootPipeline::done(BootStage s) const {
+    return _ended && s < BootStage::COUNT && (xEventGroupGetBits(_ended) & BOOT_BIT(s));
+}
+
+bool BootPipeline::run(BootStage s, StageFn fn) {
+    begin(s);
+    bool ok = fn();
+    end(s, ok);
+    return ok;
+}
+
+bool BootPipeline::runAsync(BootStage s, StageFn fn, uint32_t after) {
+    if (s >= BootStage::COUNT || !fn) return false;
+    Job& job = _jobs[(int)s];
+    if (job.fn || !start()) return false;   // Already started
+    job.self  = this;
+    job.stage = s;
+    job.fn    = fn;
+    job.after = after;
+
+    char taskName[16];
+    snprintf(taskName, sizeof(taskName), "Boot:%.10s", name(s));
+    if (xTaskCreatePinnedToCore(taskMain, taskName, BOOT_TASK_STACK, &job,
+                                BOOT_TASK_PRIORITY, nullptr, BOOT_TASK_CORE) != pdPASS) {
+        Logger.printf("❌ [BOOT] Failed to start %s task\n", name(s));
+        end(s, false);
+        return false;
+    }
+    return true;
+}
+
+// Boot task: wait for the dependencies, run the stage, exit
+void BootPipeline::taskMain(void* arg) {
+    Job& job = *static_cast<Job*>(arg);
+    if (job.after) {
+        xEventGroupWaitBits(job.self->_ended, job.after, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    job.self->run(job.stage, job.fn);
+    vTaskDelete(nullptr);
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+void BootPipeline::printStatus() const {
+    Logger.println("⏱️ Boot stages (ms since reset):");
+    for (int i = 0; i < (int)BootStage::COUNT; i++) {
+        const Record& r = _rec[i];
+        const char* stageName = name((BootStage)i);
+        if (r.startUs == 0) {
+            Logger.printf("   %-10s not started\n", stageName);
+        } else if (r.endUs == 0) {
+            Logger.printf("   %-10s %8.1f → running (core %d)\n", stageName, r.startUs / 1000.0f, r.core);
+        } else {
+            Logger.printf("   %-10s %8.1f → %8.1f  %8.1f ms  core %d%s\n", stageName,
+                          r.startUs / 1000.0f, r.endUs / 1000.0f, (r.endUs - r.startUs) / 1000.0f,
+                          r.core, r.ok ? "" : "  FAILED");
+        }
+    }
+}
+
+void BootPipeline::appendJson(String& out) const {
+    out += "\"boot_stages\":{";
+    char item[64];
+    for (int i = 0; i < (int)BootStage::COUNT; i++) {
+        const Record& r = _rec[i];
+        snprintf(item, sizeof(item), "%s\"%s\":[%lld,%lld,%d]", i ? "," : "",
+                 name((BootStage)i), (long long)r.startUs, (long long)r.endUs, r.ok ? 1 : 0);
+        out += item;
+    }
+    out += "},";
+}
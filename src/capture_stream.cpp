@@ -0,0 +1,378 @@
+/**
+ * @file capture_stream.cpp
+ * @brief Live mic capture as binary frames over a TCP socket
+ *
+ * @date 2026
+ */
+
+#include "capture_stream.h"
+#include "logging.h"
+#include "mic_ring_buffer.h"
+#include "dtmf_goertzel.h"
+#include "psram_alloc.h"
+
+CaptureStream captureStream;
+
+static_assert(CAPTURE_STREAM_FRAME_SAMPLES % 2 == 0, "ADPCM frames pack two samples per byte");
+
+// ============================================================================
+// IMA ADPCM
+// ============================================================================
+
+static const int16_t kImaStep[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+static const int8_t kImaIndex[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static uint8_t imaEncode(int16_t sample, int32_t& predictor, int& index)
+{
+    int step = kImaStep[index];
+    int diff = sample - predictor;
+    uint8_t code = 0;
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    int delta = step >> 3;
+    if (diff >= step) { code |= 4; diff -= step; delta += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; delta += step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; delta += step; }
+
+    predictor += (code & 8) ? -delta : delta;
+    if (predictor > 32767) predictor = 32767;
+    if (predictor < -32768) predictor = -32768;
+    index += kImaIndex[code];
+    if (index < 0) index = 0;
+    if (index > 88) index = 88;
+    return code;
+}
+
+// ============================================================================
+// CONTROL (loop())
+// ============================================================================
+
+bool CaptureStream::start(CaptureCodec codec, bool trigger)
+{
+    if (_task) {
+        Logger.println("⚠️ [CAPSTREAM] Already running");
+        return false;
+    }
+    if (!isMicCaptureRunning()) {
+        Logger.println("❌ [CAPSTREAM] Mic capture task not running");
+        return false;
+    }
+    if (trigger) {
+        _prerollLen = (size_t)STREAM_RATE * CAPTURE_PREROLL_MS / 1000;
+        _preroll = static_cast<int16_t*>(psramAlloc(_prerollLen * sizeof(int16_t)));
+        if (!_preroll) {
+            Logger.printf("❌ [CAPSTREAM] No room for %u KB pre-roll\n",
+                          (unsigned)(_prerollLen * sizeof(int16_t) / 1024));
+            return false;
+        }
+    }
+
+    _codec = codec;
+    _trigger = trigger;
+    _stopRequested = false;
+    _markRequested = false;
+    _clients = 0;
+    _bytes = 0;
+    _lostSamples = 0;
+    _triggers = 0;
+
+    _server.begin();
+    _server.setNoDelay(true);
+    if (xTaskCreatePinnedToCore(taskMain, "CapStream", CAPTURE_STREAM_STACK, this,
+                                CAPTURE_STREAM_PRIORITY, &_task, 0) != pdPASS) {
+        Logger.println("❌ [CAPSTREAM] Task create failed");
+        _task = nullptr;
+        _server.end();
+        psramFree(_preroll);
+        _preroll = nullptr;
+        return false;
+    }
+
+    Logger.printf("🎙️ [CAPSTREAM] Listening on %s:%d (%s, %d Hz%s)\n",
+                  WiFi.localIP().toString().c_str(), CAPTURE_STREAM_PORT,
+                  codec == CaptureCodec::ADPCM ? "ADPCM" : "PCM16", STREAM_RATE,
+                  trigger ? ", on detection reject" : "");
+    return true;
+}
+
+void CaptureStream::stop()
+{
+    if (!_task) return;
+    _stopRequested = true;
+    // A blocked write gives up after the client's 1 s timeout
+    unsigned long t0 = millis();
+    while (_task && millis() - t0 < 3000) {
+        delay(10);
+    }
+    if (_task) {
+        Logger.println("⚠️ [CAPSTREAM] Task did not exit");
+        return;
+    }
+    _server.end();
+    psramFree(_preroll);
+    _preroll = nullptr;
+    Logger.printf("🎙️ [CAPSTREAM] Stopped (%lu KB sent, %lu samples lost, %lu triggers)\n",
+                  (unsigned long)(_bytes / 1024), (unsigned long)_lostSamples,
+                  (unsigned long)_triggers);
+}
+
+void CaptureStream::printStatus()
+{
+    if (!_task) {
+        Logger.printf("🎙️ Capture stream: stopped (port %d)\n", CAPTURE_STREAM_PORT);
+        return;
+    }
+    Logger.printf("🎙️ Capture stream: %s on port %d, %s, %d Hz%s\n",
+                  _connected ? "streaming" : "waiting for a client", CAPTURE_STREAM_PORT,
+                  _codec == CaptureCodec::ADPCM ? "ADPCM" : "PCM16", STREAM_RATE,
+                  _trigger ? ", trigger mode" : "");
+    Logger.printf("   Clients: %lu  Sent: %lu KB  Lost: %lu samples  Triggers: %lu\n",
+                  (unsigned long)_clients, (unsigned long)(_bytes / 1024),
+                  (unsigned long)_lostSamples, (unsigned long)_triggers);
+}
+
+// ============================================================================
+// CAPSTREAM TASK
+// ============================================================================
+
+void CaptureStream::taskMain(void* arg)
+{
+    static_cast<CaptureStream*>(arg)->run();
+}
+
+void CaptureStream::run()
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    MicRingBuffer& ring = getMicRing();
+    MicRingReader reader(ring);
+    ring.subscribe(self);
+
+    int16_t in[256];
+    uint32_t lostBase = 0;
+
+    while (!_stopRequested) {
+        if (!_connected) {
+            if (!accept()) {
+                vTaskDelay(pdMS_TO_TICKS(100));
+                continue;
+            }
+            reader.seekToLive();
+            lostBase = reader.lostSamples();
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+
+        size_t n;
+        while (_connected && (n = reader.readSamples(in, sizeof(in) / sizeof(in[0]))) > 0) {
+            for (size_t i = 0; i < n; i++) pushSample(in[i]);
+        }
+
+        // Lapped by the capture task (the link was too slow): say how much
+        uint32_t lost = reader.lostSamples() - lostBase;
+        if (_connected && lost > 0) {
+            lostBase += lost;
+            _lostSamples += lost;
+            if (!_trigger || _postrollLeft > 0) {
+                uint32_t gap = lost / CAPTURE_STREAM_DOWNSAMPLE;
+                if (gap > 0xFFFF) gap = 0xFFFF;
+                flushFrame();
+                sendFrame('G', gap, _index, nullptr, 0);
+                _index += gap;
+            }
+        }
+
+        uint32_t rejects = rejectCount();
+        bool rejected = rejects > _lastRejects;
+        _lastRejects = rejects;
+        if (!_connected) continue;
+
+        // Between triggers nothing is written, so a failed write can't
+        // notice a client that went away: ask the socket instead
+        if (_trigger && _postrollLeft == 0 && millis() - _lastProbeMs >= CAPTURE_IDLE_PROBE_MS) {
+            _lastProbeMs = millis();
+            if (!_client.connected()) {
+                Logger.println("🎙️ [CAPSTREAM] Client gone");
+                _client.stop();
+                _connected = false;
+                continue;
+            }
+        }
+
+        if (!_trigger) {
+            if (_markRequested) {
+                _markRequested = false;
+                flushFrame();
+                sendTrigger("mark");
+            }
+        } else if (_postrollLeft == 0 && (rejected || _markRequested)) {
+            const char* reason = _markRequested ? "mark" : "reject";
+            _markRequested = false;
+            sendTrigger(reason);
+            // Pre-roll, oldest first, then live audio for the post-roll
+            size_t at = (_prerollHead + _prerollLen - _prerollFill) % _prerollLen;
+            uint32_t index = _index - _prerollFill;
+            for (size_t i = 0; i < _prerollFill && _connected; i++) {
+                if (_frameFill == 0) _frameStart = index + i;
+                _frame[_frameFill++] = _preroll[at];
+                at = (at + 1) % _prerollLen;
+                if (_frameFill == CAPTURE_STREAM_FRAME_SAMPLES) flushFrame();
+            }
+            flushFrame();
+            _prerollFill = 0;
+            _postrollLeft = (uint32_t)STREAM_RATE * CAPTURE_POSTROLL_MS / 1000;
+            _triggers++;
+        }
+    }
+
+    ring.unsubscribe(self);
+    _client.stop();
+    _connected = false;
+    _task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+bool CaptureStream::accept()
+{
+    WiFiClient client = _server.available();
+    if (!client) return false;
+
+    _client = client;
+    _client.setNoDelay(true);
+    _client.setTimeout(1);
+
+    _index = 0;
+    _frameFill = 0;
+    _carry = 0;
+    _carryCount = 0;
+    _prerollHead = 0;
+    _prerollFill = 0;
+    _postrollLeft = 0;
+    _adpcmPredictor = 0;
+    _adpcmStep = 0;
+    _lastRejects = rejectCount();
+    _lastProbeMs = millis();
+
+    uint8_t header[16] = { 'B', 'P', 'C', 'M', 1, (uint8_t)_codec, 0, 0 };
+    uint32_t rate = STREAM_RATE;
+    memcpy(header + 8, &rate, sizeof(rate));
+    header[12] = _trigger ? 1 : 0;
+    if (_client.write(header, sizeof(header)) != sizeof(header)) {
+        _client.stop();
+        return false;
+    }
+    _bytes += sizeof(header);
+    _clients++;
+    _connected = true;
+    Logger.printf("🎙️ [CAPSTREAM] Client %s connected\n", _client.remoteIP().toString().c_str());
+    return true;
+}
+
+// Pair average: a cheap low-pass ahead of the 2:1 decimation
+void CaptureStream::pushSample(int16_t s)
+{
+    _carry += s;
+    if (++_carryCount < CAPTURE_STREAM_DOWNSAMPLE) return;
+    int16_t out = (int16_t)(_carry / CAPTURE_STREAM_DOWNSAMPLE);
+    _carry = 0;
+    _carryCount = 0;
+    emit(out);
+}
+
+void CaptureStream::emit(int16_t s)
+{
+    if (_trigger) {
+        _preroll[_prerollHead] = s;
+        _prerollHead = (_prerollHead + 1) % _prerollLen;
+        if (_prerollFill < _prerollLen) _prerollFill++;
+        if (_postrollLeft == 0) {
+            _index++;
+            return;
+        }
+        _prerollFill = 0;           // Sent live; not part of the next pre-roll
+    }
+
+    if (_frameFill == 0) _frameStart = _index;
+    _frame[_frameFill++] = s;
+    _index++;
+    if (_frameFill == CAPTURE_STREAM_FRAME_SAMPLES) flushFrame();
+
+    if (_trigger && --_postrollLeft == 0) {
+        flushFrame();
+    }
+}
+
+bool CaptureStream::flushFrame()
+{
+    if (_frameFill == 0) return true;
+    size_t n = _frameFill;
+    _frameFill = 0;
+
+    uint8_t* payload = _packet + FRAME_HEADER;
+    size_t len;
+    if (_codec == CaptureCodec::ADPCM) {
+        int16_t pred = (int16_t)_adpcmPredictor;
+        memcpy(payload, &pred, sizeof(pred));
+        payload[2] = (uint8_t)_adpcmStep;
+        payload[3] = 0;
+        uint8_t* out = payload + 4;
+        for (size_t i = 0; i < n; i += 2) {
+            uint8_t lo = imaEncode(_frame[i], _adpcmPredictor, _adpcmStep);
+            uint8_t hi = i + 1 < n ? imaEncode(_frame[i + 1], _adpcmPredictor, _adpcmStep) : 0;
+            *out++ = lo | (hi << 4);
+        }
+        len = out - payload;
+    } else {
+        memcpy(payload, _frame, n * sizeof(int16_t));
+        len = n * sizeof(int16_t);
+    }
+    return sendFrame('A', n, _frameStart, nullptr, len);
+}
+
+// payload == nullptr: it is already in place after the header
+bool CaptureStream::sendFrame(char type, uint16_t samples, uint32_t index,
+                              const uint8_t* payload, size_t len)
+{
+    if (!_connected) return false;
+    if (len > MAX_PAYLOAD) len = MAX_PAYLOAD;
+    _packet[0] = (uint8_t)type;
+    _packet[1] = 0;
+    memcpy(_packet + 2, &samples, sizeof(samples));
+    memcpy(_packet + 4, &index, sizeof(index));
+    uint16_t plen = len;
+    memcpy(_packet + 8, &plen, sizeof(plen));
+    if (payload && len > 0) memcpy(_packet + FRAME_HEADER, payload, len);
+
+    size_t total = FRAME_HEADER + len;
+    if (_client.write(_packet, total) != total) {
+        Logger.println("🎙️ [CAPSTREAM] Client gone");
+        _client.stop();
+        _connected = false;
+        return false;
+    }
+    _bytes += total;
+    return true;
+}
+
+bool CaptureStream::sendTrigger(const char* reason)
+{
+    Logger.printf("🎙️ [CAPSTREAM] Trigger: %s\n", reason);
+    return sendFrame('T', 0, _index, reinterpret_cast<const uint8_t*>(reason), strlen(reason));
+}
+
+uint32_t CaptureStream::rejectCount()
+{
+    GoertzelDetectorStats s = getGoertzelDetectorStats();
+    return s.rejectPartial + s.rejectFloor + s.rejectTwist + s.rejectHarmonic + s.rejectEnergy;
+}
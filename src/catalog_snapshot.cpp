@@ -0,0 +1,281 @@
+#include "catalog_snapshot.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+#include <string>
+#include <vector>
+
+// ============================================================================
+// FILE LAYOUT
+// ============================================================================
+
+static constexpr uint16_t NO_LINK = 0xFFFF;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entrySize;          // sizeof(SnapshotEntry), catches layout changes
+    uint16_t linkSize;
+    uint16_t reserved;
+    uint32_t entryCount;
+    uint32_t linkCount;
+    uint32_t poolBytes;
+    uint32_t sourceSize;         // Size of the JSON the snapshot was written from
+    uint32_t sourceHash;         // catalogSourceHash() of that JSON
+    uint32_t checksum;           // FNV-1a of everything after the header
+};
+
+struct SnapshotTiming {
+    uint32_t durationMs;
+    uint32_t gapBefore;
+    uint32_t gapAfter;
+    uint32_t loop;
+};
+
+struct SnapshotEntry {
+    uint32_t key;                // Pool offsets
+    uint32_t path;               // Generator: its source JSON
+    uint32_t alternatePath;
+    uint32_t ext;
+    uint32_t contentHash;
+    SnapshotTiming timing;
+    uint16_t previous;           // Link index or NO_LINK
+    uint16_t next;
+    uint8_t type;                // AudioStreamType
+    uint8_t reserved[3];
+};
+
+struct SnapshotLink {
+    uint32_t key;
+    SnapshotTiming timing;
+};
+
+static uint32_t fnv1a(const uint8_t* data, size_t len, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t catalogSourceHash(const uint8_t* data, size_t len, uint32_t hash)
+{
+    return fnv1a(data, len, hash);
+}
+
+// FNV-1a of the whole file; leaves it rewound
+static uint32_t hashSource(File& source)
+{
+    uint32_t hash = CATALOG_SOURCE_HASH_SEED;
+    uint8_t chunk[512];
+    source.seek(0);
+    int n;
+    while ((n = source.read(chunk, sizeof(chunk))) > 0) {
+        hash = fnv1a(chunk, n, hash);
+    }
+    source.seek(0);
+    return hash;
+}
+
+static SnapshotTiming packTiming(const AudioTiming& t)
+{
+    return { (uint32_t)t.durationMs, (uint32_t)t.gapBefore, (uint32_t)t.gapAfter, (uint32_t)t.loop };
+}
+
+static AudioTiming unpackTiming(const SnapshotTiming& t)
+{
+    AudioTiming timing;
+    timing.durationMs = t.durationMs;
+    timing.gapBefore = t.gapBefore;
+    timing.gapAfter = t.gapAfter;
+    timing.loop = t.loop;
+    return timing;
+}
+
+// ============================================================================
+// WRITE
+// ============================================================================
+
+static uint32_t poolAdd(std::string& pool, const std::string& s)
+{
+    if (s.empty()) return 0;
+    uint32_t offset = pool.size();
+    pool.append(s);
+    pool.push_back('\0');
+    return offset;
+}
+
+static uint16_t linkAdd(std::vector<SnapshotLink>& links, std::string& pool, const AudioLink* link)
+{
+    if (!link || links.size() >= NO_LINK) return NO_LINK;
+    links.push_back({ poolAdd(pool, link->audioKey), packTiming(link->timing) });
+    return (uint16_t)(links.size() - 1);
+}
+
+bool writeCatalogSnapshot(fs::FS& fs, const char* path, const AudioKeyRegistry& registry,
+                          uint32_t sourceSize, uint32_t sourceHash,
+                          CatalogGeneratorSource generatorSource, void* userData)
+{
+    std::vector<SnapshotEntry> entries;
+    std::vector<SnapshotLink> links;
+    std::string pool(1, '\0');
+    entries.reserve(registry.size());
+
+    for (const auto& pair : registry) {
+        const AudioEntry& e = pair.second;
+        if (e.contentHash == 0) continue;    // Registered by code, not by the catalog
+
+        SnapshotEntry rec = {};
+        rec.key = poolAdd(pool, e.audioKey);
+        rec.type = (uint8_t)e.type;
+        rec.contentHash = e.contentHash;
+        rec.timing = packTiming(e.timing);
+        if (e.type == AudioStreamType::GENERATOR) {
+            const char* json = generatorSource ? generatorSource(pair.first, userData) : nullptr;
+            if (!json) continue;
+            rec.path = poolAdd(pool, json);
+        } else if (FileData* f = e.getFile()) {
+            rec.path = poolAdd(pool, f->path);
+            rec.alternatePath = poolAdd(pool, f->alternatePath);
+            rec.ext = poolAdd(pool, f->ext);
+        } else {
+            continue;
+        }
+        rec.previous = linkAdd(links, pool, e.previous);
+        rec.next = linkAdd(links, pool, e.next);
+        entries.push_back(rec);
+    }
+
+    SnapshotHeader header = {};
+    header.magic = CATALOG_SNAPSHOT_MAGIC;
+    header.version = CATALOG_SNAPSHOT_VERSION;
+    header.entrySize = sizeof(SnapshotEntry);
+    header.linkSize = sizeof(SnapshotLink);
+    header.entryCount = entries.size();
+    header.linkCount = links.size();
+    header.poolBytes = pool.size();
+    header.sourceSize = sourceSize;
+    header.sourceHash = sourceHash;
+    uint32_t sum = fnv1a((const uint8_t*)entries.data(), entries.size() * sizeof(SnapshotEntry));
+    sum = fnv1a((const uint8_t*)links.data(), links.size() * sizeof(SnapshotLink), sum);
+    header.checksum = fnv1a((const uint8_t*)pool.data(), pool.size(), sum);
+
+    char tmpPath[72];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    File f = fs.open(tmpPath, FILE_WRITE);
+    if (!f) {
+        Logger.printf("⚠️ Cannot create %s\n", tmpPath);
+        return false;
+    }
+    size_t expected = sizeof(header) + entries.size() * sizeof(SnapshotEntry)
+                    + links.size() * sizeof(SnapshotLink) + pool.size();
+    size_t written = f.write((const uint8_t*)&header, sizeof(header));
+    written += f.write((const uint8_t*)entries.data(), entries.size() * sizeof(SnapshotEntry));
+    written += f.write((const uint8_t*)links.data(), links.size() * sizeof(SnapshotLink));
+    written += f.write((const uint8_t*)pool.data(), pool.size());
+    f.close();
+
+    if (written != expected) {
+        fs.remove(tmpPath);
+        fs.remove(path);
+        Logger.printf("⚠️ Catalog snapshot write failed (%u/%u bytes)\n", (unsigned)written, (unsigned)expected);
+        return false;
+    }
+    if (fs.exists(path)) fs.remove(path);
+    if (!fs.rename(tmpPath, path)) {
+        fs.remove(tmpPath);
+        Logger.printf("⚠️ Cannot rename %s\n", tmpPath);
+        return false;
+    }
+    Logger.printf("💾 Catalog snapshot: %u entries, %u bytes → %s\n",
+                  (unsigned)entries.size(), (unsigned)expected, path);
+    return true;
+}
+
+// ============================================================================
+// LOAD
+// ============================================================================
+
+int loadCatalogSnapshot(fs::FS& fs, const char* path, File& source, AudioKeyRegistry& registry,
+                        CatalogGeneratorBuilder generatorBuilder, void* userData)
+{
+    if (!fs.exists(path)) {
+        return -1;
+    }
+    File f = fs.open(path, FILE_READ);
+    if (!f) {
+        return -1;
+    }
+    size_t size = f.size();
+    if (size < sizeof(SnapshotHeader)) {
+        f.close();
+        return -1;
+    }
+
+    // One sequential read into a single blob
+    uint8_t* blob = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!blob) blob = (uint8_t*)malloc(size);
+    if (!blob) {
+        f.close();
+        return -1;
+    }
+    size_t got = f.read(blob, size);
+    f.close();
+
+    SnapshotHeader header;
+    memcpy(&header, blob, sizeof(header));
+    size_t bodySize = (size_t)header.entryCount * sizeof(SnapshotEntry)
+                    + (size_t)header.linkCount * sizeof(SnapshotLink) + header.poolBytes;
+    const char* reject = nullptr;
+    if (got != size) reject = "short read";
+    else if (header.magic != CATALOG_SNAPSHOT_MAGIC || header.version != CATALOG_SNAPSHOT_VERSION
+             || header.entrySize != sizeof(SnapshotEntry) || header.linkSize != sizeof(SnapshotLink))
+        reject = "other format";
+    else if (header.sourceSize != source.size()) reject = "stale";
+    else if (sizeof(header) + bodySize != size || header.poolBytes == 0) reject = "bad size";
+    else if (fnv1a(blob + sizeof(header), bodySize) != header.checksum) reject = "checksum";
+    else if (hashSource(source) != header.sourceHash) reject = "stale";
+    if (reject) {
+        Logger.printf("ℹ️ Catalog snapshot not used (%s)\n", reject);
+        heap_caps_free(blob);
+        return -1;
+    }
+
+    const SnapshotEntry* entries = (const SnapshotEntry*)(blob + sizeof(header));
+    const SnapshotLink* links = (const SnapshotLink*)(entries + header.entryCount);
+    const char* pool = (const char*)(links + header.linkCount);
+    uint32_t poolBytes = header.poolBytes;
+    bool poolTerminated = pool[poolBytes - 1] == '\0';
+    auto str = [&](uint32_t offset) -> const char* {
+        return poolTerminated && offset < poolBytes ? pool + offset : "";
+    };
+    auto link = [&](uint16_t index) -> AudioLink* {
+        if (index >= header.linkCount) return nullptr;
+        return new AudioLink(str(links[index].key), unpackTiming(links[index].timing));
+    };
+
+    int count = 0;
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        const SnapshotEntry& rec = entries[i];
+        const char* key = str(rec.key);
+        if (!key[0]) continue;
+
+        AudioEntry entry;
+        entry.audioKey = key;
+        entry.type = (AudioStreamType)rec.type;
+        if (entry.type == AudioStreamType::GENERATOR) {
+            entry.generator = generatorBuilder ? generatorBuilder(key, str(rec.path), userData) : nullptr;
+            if (!entry.generator) continue;
+        } else {
+            entry.file = new FileData{ str(rec.path), str(rec.alternatePath), str(rec.ext) };
+        }
+        entry.contentHash = rec.contentHash;
+        entry.timing = unpackTiming(rec.timing);
+        entry.previous = link(rec.previous);
+        entry.next = link(rec.next);
+        registry.registerEntry(std::move(entry));
+        count++;
+    }
+
+    heap_caps_free(blob);
+    return count;
+}
@@ -0,0 +1,182 @@
+#include "catalog_stream_parser.h"
+#include "esp_heap_caps.h"
+
+static bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool CatalogStreamParser::begin(MemberCallback cb, void* ud)
+{
+    if (!value) {
+        value = (char*)heap_caps_malloc(AUDIO_CATALOG_ENTRY_MAX_BYTES + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!value) {
+            value = (char*)malloc(AUDIO_CATALOG_ENTRY_MAX_BYTES + 1);
+        }
+        if (!value) {
+            return false;
+        }
+    }
+    callback = cb;
+    userData = ud;
+    state = State::EXPECT_OBJECT;
+    keyLen = 0;
+    valueLen = 0;
+    members = 0;
+    skipped = 0;
+    bytes = 0;
+    errorText = nullptr;
+    return true;
+}
+
+void CatalogStreamParser::end()
+{
+    if (value) {
+        heap_caps_free(value);
+        value = nullptr;
+    }
+}
+
+void CatalogStreamParser::fail(const char* why)
+{
+    state = State::FAILED;
+    errorText = why;
+}
+
+void CatalogStreamParser::append(char c)
+{
+    if (valueLen < AUDIO_CATALOG_ENTRY_MAX_BYTES) {
+        value[valueLen++] = c;
+    } else {
+        valueOverflow = true;
+    }
+}
+
+void CatalogStreamParser::emit()
+{
+    state = State::EXPECT_NEXT;
+    if (valueOverflow) {
+        skipped++;
+        return;
+    }
+    value[valueLen] = '\0';
+    members++;
+    if (callback) {
+        callback(key, value, valueLen, userData);
+    }
+}
+
+// ============================================================================
+// TOKENIZER
+// ============================================================================
+
+bool CatalogStreamParser::feed(const uint8_t* data, size_t len)
+{
+    if (state == State::FAILED) {
+        return false;
+    }
+    bytes += len;
+
+    size_t i = 0;
+    while (i < len && state != State::FAILED) {
+        char c = (char)data[i];
+        switch (state) {
+        case State::EXPECT_OBJECT:
+            if (c == '{') state = State::EXPECT_KEY;
+            else if (!isJsonSpace(c)) fail("catalog is not a JSON object");
+            break;
+
+        case State::EXPECT_KEY:
+            if (c == '"') {
+                state = State::IN_KEY;
+                keyLen = 0;
+                keyEscape = false;
+            } else if (c == '}' && members + skipped == 0) {
+                state = State::DONE;            // Empty object
+            } else if (!isJsonSpace(c)) {
+                fail("expected a member name");
+            }
+            break;
+
+        case State::IN_KEY:
+            if (keyEscape) {
+                keyEscape = false;              // \" \\ \/ kept as the character itself
+            } else if (c == '\\') {
+                keyEscape = true;
+                break;
+            } else if (c == '"') {
+                key[keyLen] = '\0';
+                state = State::EXPECT_COLON;
+                break;
+            }
+            if (keyLen + 1 >= sizeof(key)) {
+                fail("member name too long");
+                break;
+            }
+            key[keyLen++] = c;
+            break;
+
+        case State::EXPECT_COLON:
+            if (c == ':') state = State::EXPECT_VALUE;
+            else if (!isJsonSpace(c)) fail("expected ':'");
+            break;
+
+        case State::EXPECT_VALUE:
+            if (isJsonSpace(c)) break;
+            state = State::IN_VALUE;
+            valueLen = 0;
+            valueOverflow = false;
+            depth = 0;
+            inString = false;
+            escape = false;
+            scalar = false;
+            if (c == '{' || c == '[') depth = 1;
+            else if (c == '"') inString = true;
+            else if (c == ',' || c == '}' || c == ']' || c == ':') { fail("missing value"); break; }
+            else scalar = true;
+            append(c);
+            break;
+
+        case State::IN_VALUE:
+            if (scalar) {
+                if (c == ',' || c == '}' || isJsonSpace(c)) {
+                    emit();
+                    continue;                   // Delimiter belongs to EXPECT_NEXT
+                }
+                append(c);
+                break;
+            }
+            append(c);
+            if (inString) {
+                if (escape) escape = false;
+                else if (c == '\\') escape = true;
+                else if (c == '"') {
+                    inString = false;
+                    if (depth == 0) emit();     // Top-level string value
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) emit();
+            }
+            break;
+
+        case State::EXPECT_NEXT:
+            if (c == ',') state = State::EXPECT_KEY;
+            else if (c == '}') state = State::DONE;
+            else if (!isJsonSpace(c)) fail("expected ',' or '}'");
+            break;
+
+        case State::DONE:
+            if (!isJsonSpace(c)) fail("data after the catalog object");
+            break;
+
+        case State::FAILED:
+            break;
+        }
+        i++;
+    }
+    return state != State::FAILED;
+}
@@ -2,11 +2,15 @@
 
 // ============================================================================
 // AUDIO CAPTURE — Record ADC input to PSRAM, dump as CSV over serial/log
+//
+// Reads its own cursor on the shared mic ring, so the Goertzel task keeps
+// detecting while we record — captures show what the detector actually heard.
+//
+// Capped at 20 s and slow to dump; `capstream` (capture_stream.h) streams
+// binary frames live over TCP instead, with no cap and no logger changes.
 // ============================================================================
 
 void performAudioCapture(int durationSec) {
-    extern AudioBoardStream kit;
-
     if (durationSec < 1)  durationSec = 1;
     if (durationSec > 20) durationSec = 20;
 
@@ -26,6 +30,11 @@ void performAudioCapture(int durationSec) {
     Logger.printf("   Free PSRAM: %u KB\n", ESP.getFreePsram() / 1024);
     Logger.printf("   Free heap: %u KB\n", ESP.getFreeHeap() / 1024);
 
+    if (!isMicCaptureRunning()) {
+        Logger.println("   ❌ Mic capture task not running (AudioKit init failed?)");
+        return;
+    }
+
     if (BUFFER_BYTES > ESP.getFreePsram()) {
         Logger.println("   ❌ Not enough PSRAM! Reduce duration.");
         return;
@@ -37,30 +46,23 @@ void performAudioCapture(int durationSec) {
         return;
     }
 
-    Logger.println("   Stopping Goertzel task...");
-    stopGoertzelTask();
+    // Playback still stops: this loop blocks core 1, so the player would underrun
+    Logger.println("   Goertzel detection stays live during capture");
     getExtendedAudioPlayer().stop();
 
     Logger.println("   Disabling remote logger...");
     bool wasRemoteEnabled = RemoteLogger.isEnabled();
     RemoteLogger.setEnabled(false);
 
-    delay(50);
-
-    // Drain stale I2S input data
-    {
-        uint8_t drain[1024];
-        unsigned long drainStart = millis();
-        while (kit.available() > 0 && (millis() - drainStart) < 200) {
-            kit.readBytes(drain, min((int)sizeof(drain), kit.available()));
-        }
-    }
-
     Logger.println("   🔴 RECORDING...");
     Logger.flush();
 
-    const size_t READ_CHUNK = 1024;
-    uint8_t readBuf[READ_CHUNK];
+    // Start at live audio; anything older in the ring is from before the command
+    MicRingReader reader(getMicRing());
+    reader.seekToLive();
+
+    const size_t READ_CHUNK = 512;
+    int16_t samples[READ_CHUNK];
     size_t capturedSamples   = 0;
     size_t totalSourceSamples = 0;
     size_t sourceSkipCounter  = 0;
@@ -69,26 +71,19 @@ void performAudioCapture(int durationSec) {
     size_t readFailCount       = 0;
 
     while (capturedSamples < SAMPLES_NEEDED) {
-        int avail = kit.available();
-        if (avail <= 0) {
-            delayMicroseconds(100);
+        size_t samplesRead = reader.readSamples(samples, READ_CHUNK);
+        if (samplesRead == 0) {
+            // A DMA frame is ~6ms; wait for the capture task to publish
+            delay(1);
             readFailCount++;
-            if (readFailCount > 100000) {
-                Logger.printf("\n   ⚠️ I2S read stalled at %u samples\n", capturedSamples);
+            if (readFailCount > 2000) {
+                Logger.printf("\n   ⚠️ Mic ring stalled at %u samples\n", capturedSamples);
                 break;
             }
             continue;
         }
         readFailCount = 0;
 
-        size_t toRead = min((size_t)avail, READ_CHUNK);
-        toRead &= ~1;   // ensure even (16-bit samples)
-        if (toRead == 0) continue;
-
-        size_t bytesRead   = kit.readBytes(readBuf, toRead);
-        size_t samplesRead = bytesRead / sizeof(int16_t);
-        int16_t* samples   = (int16_t*)readBuf;
-
         for (size_t i = 0; i < samplesRead && capturedSamples < SAMPLES_NEEDED; i++) {
             totalSourceSamples++;
             if (sourceSkipCounter == 0) {
@@ -116,6 +111,10 @@ void performAudioCapture(int durationSec) {
     Logger.printf("   ✅ Captured %u samples in %lu ms\n", capturedSamples, captureTime);
     Logger.printf("   Source samples read: %u (expected ~%u)\n",
                   totalSourceSamples, (unsigned)(AUDIO_SAMPLE_RATE * durationSec));
+    if (reader.lostSamples() > 0) {
+        Logger.printf("   ⚠️ Lost %u samples (%u overruns) — capture has gaps\n",
+                      (unsigned)reader.lostSamples(), (unsigned)reader.overruns());
+    }
 
     // Signal statistics
     int32_t minVal = 32767, maxVal = -32768;
@@ -179,10 +178,5 @@ void performAudioCapture(int durationSec) {
     heap_caps_free(captureBuf);
     Logger.printf("   💾 Buffer freed. Free PSRAM: %u KB\n", ESP.getFreePsram() / 1024);
 
-    Logger.println("   Restarting Goertzel task...");
-    extern StreamCopy goertzelCopier;
-    resetGoertzelState();
-    startGoertzelTask(goertzelCopier);
-
     Logger.println("============================================");
 }
@@ -19,6 +19,8 @@
 #include "audio_file_manager.h"
 #include "audio_key_registry.h"
 #include "extended_audio_player.h"
+#include "audio_output_task.h"
+#include "audio_pcm_cache.h"
 #include "wifi_manager.h"
 #include "phone_home.h"
 #include "phone_service.h"
@@ -31,7 +33,6 @@
 #include <SD.h>
 #include <SD_MMC.h>
 #include <SPI.h>
-#include "AudioTools/CoreAudio/GoerzelStream.h"
 #include "AudioTools/CoreAudio/StreamCopy.h"
 #include "AudioTools/AudioLibs/AudioBoardStream.h"
 #include "dtmf_goertzel.h"
@@ -54,6 +55,9 @@
 
 // audio_capture.cpp — called by processDebugCommand and checkAndExecuteOffHookCapture
 void performAudioCapture(int durationSec);
+
+// perf_suite.cpp — called by processDebugCommand
+void performPerfSuite(bool post);
 #ifdef TEST_MODE
 
 // audio_output_test.cpp — called by processDebugCommand
@@ -5,7 +5,7 @@
 // ============================================================================
 
 void performGoertzelCPULoadTest() {
-    extern GoertzelStream goertzel;
+    extern DtmfGoertzelStream goertzel;
     extern StreamCopy goertzelCopier;
     extern AudioBoardStream kit;
 
@@ -1,4 +1,15 @@
 #include "commands_internal.h"
+#include "http_pool.h"
+#include "net_worker.h"
+#include "boot_pipeline.h"
+#include "ota_updater.h"
+#include "loop_scheduler.h"
+#include "power_manager.h"
+#include "decoder_pool.h"
+#include "psram_alloc.h"
+#include "tunables.h"
+#include "capture_stream.h"
+#include "metrics.h"
 
 // ============================================================================
 // MODULE-PRIVATE STATE
@@ -214,24 +225,53 @@ static void processDebugCommand(const String& cmd) {
           || cmd.equalsIgnoreCase("cpuload-goertzel") || cmd.equalsIgnoreCase("perftest-goertzel")) {
         performGoertzelCPULoadTest();
     }
+    else if (cmd.equalsIgnoreCase("perfsuite") || cmd.equalsIgnoreCase("perfsuite post")) {
+        performPerfSuite(cmd.length() > 9);
+    }
     else if (cmd.equalsIgnoreCase("help") || cmd.equals("?")) {
         Logger.println("🔧 [DEBUG] Serial/Telnet Commands:");
         Logger.println("   hook          - Toggle hook state");
         Logger.println("   hook auto     - Reset to automatic hook detection");
         Logger.println("   cpuload       - Test CPU load (Goertzel DTMF + audio)");
+        Logger.println("   perfsuite [post] - Benchmark suite as PERF_JSON; post sends it to the log server");
+        Logger.println("   tune [<key> <value> [save]] - Runtime tunables; reset <key|all>, ab <key> <a> <b> [min] [rounds]");
+        Logger.println("   capstream [start [raw|adpcm] [trigger] | stop | mark] - Live mic stream on TCP port " + String(CAPTURE_STREAM_PORT));
+        Logger.println("   metrics       - Current metrics snapshot values (sent every " + String(METRICS_INTERVAL_MS / 1000) + " s)");
+        Logger.println("   dtmfstats [reset] - DTMF detector counters, histograms, latency");
+        Logger.println("   audiostats [reset] - Audio output ring level, underruns, commands");
+        Logger.println("   copystats [reset] - Audio copy() timing, throughput, adaptive chunk size");
+        Logger.println("   pcmcache      - Decoded-PCM clip cache entries and hit rate");
+        Logger.println("   decoders      - Decoders allocated on demand, size and placement");
+        Logger.println("   heap          - Internal/PSRAM free, largest block, fragmentation");
+        Logger.println("   dialindex     - Dial trie size and live match cursors");
+        Logger.println("   dialstats     - Per-key dial counts that order prefetch");
+        Logger.println("   audiocache [verify] - SD cache index and budget; verify re-checks files");
+        Logger.println("   urlstream     - URL jitter buffer level, underruns, SD write-through");
+        Logger.println("   filestream    - File read-ahead level, SD read timing, underruns");
+        Logger.println("   overlay <key> - Mix a generator/cached clip over current audio");
+        Logger.println("   overlay stop <key> - Stop an overlay");
         Logger.println("   level <0-2>   - Set log level (0=quiet, 1=normal, 2=debug)");
         Logger.println("   state         - Show current state");
         Logger.println("   debugaudio [s] - Arm audio capture on next off-hook (1-60s, default 20)");
         Logger.println("   debuginput [f] - Full E2E test: hook→dialtone→Goertzel→sequence→timeout→reset");
         Logger.println("   audiotest      - Test audio output (verify I2S data flow)");
+        Logger.println("   sddefrag [n|stop] - Rewrite clips in more than n pieces (on-hook, in background)");
         Logger.println("   sddebug       - Test SD card initialization methods");
         Logger.println("   scan          - Scan for WiFi networks");
         Logger.println("   dns           - Test DNS resolution");
         Logger.println("   tailscale     - Toggle Tailscale VPN on/off");
-        Logger.println("   pullota <url> - Pull firmware from URL");
+        Logger.println("   pullota <url> - Pull firmware from URL (in background, reboots when idle)");
+        Logger.println("   ota           - Background OTA progress");
         Logger.println("   update        - Enter firmware bootloader mode");
         Logger.println("   refresh-audio - Refresh audio catalog from server");
         Logger.println("   logstream     - Toggle remote log streaming on/off");
+        Logger.println("   logstats      - Log queue levels, dropped lines, remote log spool");
+        Logger.println("   http          - Pooled HTTP connections and DNS cache");
+        Logger.println("   netio         - Background request queue depth, latency, failures");
+        Logger.println("   boot          - Boot stage start/end times");
+        Logger.println("   sched [reset] - loop() jobs: runtime, overruns, deferrals");
+        Logger.println("   hook          - Hook state, edge-to-loop latency, bounces");
+        Logger.println("   power [on|off] - On-hook low-power state, wake time");
         Logger.println("   reboot        - Reboot Device");
         Logger.println("   <digits>      - Simulate DTMF sequence");
         Logger.println();
@@ -275,6 +315,64 @@ static void processDebugCommand(const String& cmd) {
             Logger.println("FAILED");
         }
     }
+    else if (cmd.equalsIgnoreCase("dtmfstats") || cmd.equalsIgnoreCase("goertzelstats")) {
+        printGoertzelStats();
+    }
+    else if (cmd.equalsIgnoreCase("dtmfstats reset")) {
+        resetGoertzelDetectorStats();
+        Logger.println("🎵 DTMF detector stats reset");
+    }
+    else if (cmd.equalsIgnoreCase("audiostats")) {
+        printAudioOutputStats();
+    }
+    else if (cmd.equalsIgnoreCase("audiostats reset")) {
+        resetAudioOutputStats();
+        Logger.println("🔊 Audio output stats reset");
+    }
+    else if (cmd.equalsIgnoreCase("copystats")) {
+        getExtendedAudioPlayer().getCopyMeter().printStats();
+    }
+    else if (cmd.equalsIgnoreCase("copystats reset")) {
+        getExtendedAudioPlayer().resetCopyStats();
+        Logger.println("⏱️ Audio copy stats reset");
+    }
+    else if (cmd.equalsIgnoreCase("decoders")) {
+        decoderPool.printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("heap")) {
+        char line[160];
+        formatHeapStats(sampleHeap(), line, sizeof(line));
+        Logger.printf("📊 HEAP %s\n", line);
+    }
+    else if (cmd.equalsIgnoreCase("pcmcache")) {
+        getAudioPcmCache().printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("dialindex")) {
+        printDialIndexStatus();
+    }
+    else if (cmd.equalsIgnoreCase("dialstats")) {
+        printDialStats();
+    }
+    else if (cmd.equalsIgnoreCase("audiocache")) {
+        printAudioCacheStatus();
+    }
+    else if (cmd.equalsIgnoreCase("audiocache verify")) {
+        verifyAudioCache();
+    }
+    else if (cmd.equalsIgnoreCase("urlstream")) {
+#if AUDIO_URL_JITTER_ENABLED
+        getExtendedAudioPlayer().printUrlStreamStatus();
+#else
+        Logger.println("⚠️ URL jitter buffer disabled (AUDIO_URL_JITTER_ENABLED=0)");
+#endif
+    }
+    else if (cmd.equalsIgnoreCase("filestream")) {
+#if AUDIO_FILE_READAHEAD_ENABLED
+        getExtendedAudioPlayer().printFileStreamStatus();
+#else
+        Logger.println("⚠️ File read-ahead disabled (AUDIO_FILE_READAHEAD_ENABLED=0)");
+#endif
+    }
     else if (cmd.equalsIgnoreCase("state")) {
         Logger.printf("🔧 [DEBUG] State: Hook=%s, Audio=%s\n",
             Phone.isOffHook() ? "OFF_HOOK" : "ON_HOOK",
@@ -297,11 +395,91 @@ static void processDebugCommand(const String& cmd) {
         setFFTDebugEnabled(newState);
         Logger.printf("🎵 FFT debug output: %s\n", newState ? "ENABLED" : "DISABLED");
     }
+    else if (cmd.equalsIgnoreCase("logstats")) {
+        Logger.printStats();
+        RemoteLogger.printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("http")) {
+        httpPool.printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("netio")) {
+        netWorker.printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("boot")) {
+        bootPipeline.printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("power")) {
+        powerManager.printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("power on") || cmd.equalsIgnoreCase("power off")) {
+        powerManager.setEnabled(cmd.equalsIgnoreCase("power on"));
+        Logger.printf("🔋 Low-power state %s\n", powerManager.enabled() ? "enabled" : "disabled");
+    }
+    else if (cmd.equalsIgnoreCase("hook")) {
+        Phone.printHookStats();
+    }
+    else if (cmd.equalsIgnoreCase("sched")) {
+        loopScheduler.printStatus();
+    }
+    else if (cmd.equalsIgnoreCase("sched reset")) {
+        loopScheduler.resetStats();
+        Logger.println("⏱️ Loop scheduler stats reset");
+    }
+    else if (cmd.equalsIgnoreCase("tune") || cmd.startsWith("tune ")) {
+        // tune | tune <key> <value> [save] | tune reset <key|all>
+        // tune ab [stop] | tune ab <key> <a> <b> [minutes] [rounds]
+        char line[64];
+        strncpy(line, cmd.c_str(), sizeof(line) - 1);
+        line[sizeof(line) - 1] = '\0';
+        char* argv[7] = {};
+        int argc = 0;
+        for (char* tok = strtok(line, " "); tok && argc < 7; tok = strtok(nullptr, " ")) {
+            argv[argc++] = tok;
+        }
+        if (argc == 1) {
+            tunables.printStatus();
+        } else if (!strcmp(argv[1], "reset") && argc == 3) {
+            tunables.reset(strcmp(argv[2], "all") ? argv[2] : nullptr);
+        } else if (!strcmp(argv[1], "ab") && argc == 2) {
+            tunables.printAb();
+        } else if (!strcmp(argv[1], "ab") && argc == 3 && !strcmp(argv[2], "stop")) {
+            tunables.stopAb();
+        } else if (!strcmp(argv[1], "ab") && argc >= 5) {
+            uint32_t periodMs = argc > 5 ? (uint32_t)atoi(argv[5]) * 60000UL : TUNE_AB_PERIOD_MS;
+            int rounds = argc > 6 ? atoi(argv[6]) : TUNE_AB_ROUNDS;
+            tunables.startAb(argv[2], argv[3], argv[4], periodMs, rounds);
+        } else if (argc == 3 || (argc == 4 && !strcmp(argv[3], "save"))) {
+            tunables.set(argv[1], argv[2], argc == 4);
+        } else {
+            Logger.println("❌ Usage: tune [<key> <value> [save] | reset <key|all> | ab [stop | <key> <a> <b> [min] [rounds]]]");
+        }
+    }
+    else if (cmd.equalsIgnoreCase("ota")) {
+        otaUpdater.printStatus();
+    }
     else if (cmd.equalsIgnoreCase("logstream")) {
         bool newState = !RemoteLogger.isStreamingEnabled();
         RemoteLogger.setStreamingEnabled(newState);
         Logger.printf("📡 Log streaming: %s\n", newState ? "ENABLED" : "DISABLED");
     }
+    else if (cmd.equalsIgnoreCase("capstream")) {
+        captureStream.printStatus();
+    }
+    else if (cmd.startsWith("capstream start")) {
+        // capstream start [raw|adpcm] [trigger]
+        bool raw = cmd.indexOf(" raw") > 0;
+        bool trigger = cmd.indexOf(" trigger") > 0;
+        captureStream.start(raw ? CaptureCodec::PCM16 : CaptureCodec::ADPCM, trigger);
+    }
+    else if (cmd.equalsIgnoreCase("capstream stop")) {
+        captureStream.stop();
+    }
+    else if (cmd.equalsIgnoreCase("capstream mark")) {
+        captureStream.mark();
+    }
+    else if (cmd.equalsIgnoreCase("metrics")) {
+        metrics.print();
+    }
     else if (cmd.startsWith("debugaudio") || cmd.startsWith("debugAudio") || cmd.equalsIgnoreCase("audiodebug")) {
         int durationSec = 20;
         int spaceIdx = cmd.indexOf(' ');
@@ -361,6 +539,12 @@ static void processDebugCommand(const String& cmd) {
         performSDCardDebug();
     }
     #endif
+    else if (cmd.equalsIgnoreCase("sddefrag stop")) {
+        stopSDDefrag();
+    }
+    else if (cmd.equalsIgnoreCase("sddefrag") || cmd.startsWith("sddefrag ")) {
+        startSDDefrag(cmd.length() > 9 ? cmd.substring(9).toInt() : 0);
+    }
     else if (cmd.startsWith("pullota ") || cmd.startsWith("otapull ")) {
         String url = cmd.substring(cmd.indexOf(' ') + 1);
         url.trim();
@@ -382,6 +566,14 @@ static void processDebugCommand(const String& cmd) {
     else if (cmd.equalsIgnoreCase("refresh-audio") || cmd.equalsIgnoreCase("refreshaudio")) {
         executeRefreshAudio();
     }
+    else if (cmd.startsWith("overlay stop ")) {
+        getExtendedAudioPlayer().stopOverlay(cmd.substring(13).c_str());
+    }
+    else if (cmd.startsWith("overlay ")) {
+        String key = cmd.substring(8);
+        bool ok = getExtendedAudioPlayer().playOverlay(key.c_str());
+        Logger.printf("🎚️ [DEBUG] Overlay '%s': %s\n", key.c_str(), ok ? "started" : "unavailable");
+    }
     else if (cmd.startsWith("level ")) {
         int level = cmd.substring(6).toInt();
         if (level >= 0 && level <= 2) {
@@ -87,13 +87,13 @@ static void resetPumpState() {
 
 // ============================================================================
 // GOERTZEL REPLAY HELPER (private)
-// Feed a raw int16 buffer through GoertzelStream. Returns detection count.
+// Feed a raw int16 buffer through DtmfGoertzelStream. Returns detection count.
 // Detected chars are appended to out[0..outSize-1].
 // ============================================================================
 
 static int replayAudioThroughGoertzel(
     uint8_t* buffer, size_t fileSize,
-    GoertzelStream& goertzel, const PhoneConfig& config,
+    DtmfGoertzelStream& goertzel, const PhoneConfig& config,
     char* out, int outSize, int* outPos)
 {
     MemoryStream memStream(buffer, fileSize, true, FLASH_RAM);
@@ -211,7 +211,7 @@ static bool downloadAndConvertCSV(const char* rawPath) {
 // ============================================================================
 
 void performDebugInput(const char* filename, const char* expectedDigits) {
-    extern GoertzelStream goertzel;
+    extern DtmfGoertzelStream goertzel;
     extern StreamCopy goertzelCopier;
     ExtendedAudioPlayer& ap = getExtendedAudioPlayer();
 
@@ -339,11 +339,15 @@ void performDebugInput(const char* filename, const char* expectedDigits) {
     resetGoertzelState();
     setGoertzelMuted(false);
 
-    Logger.printf("   Block: %d samples (%.1f ms), Threshold: %.1f, Floor: %.1f\n",
-                  config.goertzelBlockSize,
-                  config.goertzelBlockSize * 1000.0f / AUDIO_SAMPLE_RATE,
-                  config.fundamentalMagnitudeThreshold,
-                  config.minDetectionMagnitude);
+    GoertzelThresholds thresholds = getGoertzelThresholds();
+    Logger.printf("   Window: %.1f ms, hop: %.1f ms, Threshold: %.1fdB/%.1f, Floor: %.1fdB/%.1f%s\n",
+                  config.goertzelWindowMs,
+                  config.goertzelHopMs,
+                  thresholds.presenceSnrDb,
+                  thresholds.minPresenceMagnitude,
+                  thresholds.detectionSnrDb,
+                  thresholds.minDetectionMagnitude,
+                  thresholds.calibrated ? " (calibrated)" : "");
 
     char detectedDigits[32];
     int digitPos = 0;
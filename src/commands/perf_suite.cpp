@@ -0,0 +1,446 @@
+#include "commands_internal.h"
+#include "psram_json.h"
+#include "web_queue.h"
+#include "power_manager.h"
+#include "esp_task_wdt.h"
+#include "AudioTools/AudioCodecs/CodecMP3Helix.h"
+#include "AudioTools/AudioCodecs/CodecAACHelix.h"
+#include "AudioTools/AudioCodecs/CodecWAV.h"
+#include <memory>
+
+#if SD_USE_MMC
+  #define PERF_SD SD_MMC
+#else
+  #define PERF_SD SD
+#endif
+
+// ============================================================================
+// PERFORMANCE SUITE — benchmarks for catching regressions between builds
+// ============================================================================
+//
+// `perfsuite [post]` runs each phase in turn on loop() and prints one
+// `PERF_JSON {...}` line; with `post` the same document goes to the log
+// server's POST /perf, keyed by firmware version and device. Heap deltas
+// are taken after each phase has released what it allocated, so a nonzero
+// one is a leak or lasting fragmentation.
+
+struct HeapSnapshot {
+    uint32_t internalFree;
+    uint32_t internalLargest;
+    uint32_t psramFree;
+
+    static HeapSnapshot take() {
+        return { (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+                 (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL),
+                 (uint32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM) };
+    }
+};
+
+static void addHeapDelta(JsonObject heap, const char* phase, const HeapSnapshot& before)
+{
+    HeapSnapshot after = HeapSnapshot::take();
+    JsonObject d = heap[phase].to<JsonObject>();
+    d["free"]    = (int32_t)(after.internalFree - before.internalFree);
+    d["largest"] = (int32_t)(after.internalLargest - before.internalLargest);
+    d["psram"]   = (int32_t)(after.psramFree - before.psramFree);
+}
+
+// ----------------------------------------------------------------------------
+// Per-core CPU: FreeRTOS run-time stats over dial tone + live detector
+// ----------------------------------------------------------------------------
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+struct RunTimeSample {
+    std::unique_ptr<TaskStatus_t[]> tasks;
+    UBaseType_t count = 0;
+    uint32_t total = 0;
+
+    void take() {
+        UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;   // Room for tasks started meanwhile
+        tasks.reset(new TaskStatus_t[capacity]);
+        count = uxTaskGetSystemState(tasks.get(), capacity, &total);
+    }
+
+    uint32_t runtimeOf(TaskHandle_t handle) const {
+        for (UBaseType_t i = 0; i < count; i++)
+            if (tasks[i].xHandle == handle) return tasks[i].ulRunTimeCounter;
+        return 0;
+    }
+};
+#endif
+
+static void measureCpu(JsonObject out)
+{
+    ExtendedAudioPlayer& player = getExtendedAudioPlayer();
+    if (!player.playAudioKey("dialtone")) {
+        Logger.println("⚠️ [PERF] Dial tone didn't start; CPU phase skipped");
+        out["cpu"] = nullptr;
+        return;
+    }
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    RunTimeSample start;
+    start.take();
+#endif
+
+    unsigned long begin = millis();
+    uint32_t maxLoopUs = 0, loops = 0, restarts = 0;
+    while (millis() - begin < PERF_CPU_MS) {
+        uint32_t t0 = micros();
+        if (player.isActive()) {
+            player.copy();
+        } else {
+            restarts++;
+            player.playAudioKey("dialtone");
+        }
+        uint32_t us = micros() - t0;
+        if (us > maxLoopUs) maxLoopUs = us;
+        loops++;
+        esp_task_wdt_reset();
+        yield();
+    }
+    player.stop();
+
+    JsonObject cpu = out["cpu"].to<JsonObject>();
+    cpu["loop_max_us"] = maxLoopUs;
+    cpu["loops"] = loops;
+    cpu["underruns"] = restarts;
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    RunTimeSample end;
+    end.take();
+    uint32_t window = end.total - start.total;
+    if (window == 0) return;
+
+    // Each core's idle task absorbs whatever that core didn't spend elsewhere
+    JsonArray cores = cpu["core_busy_pct"].to<JsonArray>();
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(core);
+        uint32_t idleUs = end.runtimeOf(idle) - start.runtimeOf(idle);
+        cores.add(roundf(1000.0f * (1.0f - (float)idleUs / window)) / 10.0f);
+    }
+
+    JsonObject tasks = cpu["task_pct"].to<JsonObject>();
+    for (UBaseType_t i = 0; i < end.count; i++) {
+        const TaskStatus_t& t = end.tasks[i];
+        uint32_t ran = t.ulRunTimeCounter - start.runtimeOf(t.xHandle);
+        float pct = 100.0f * ran / window;
+        if (pct >= 0.5f) tasks[t.pcTaskName] = roundf(pct * 10.0f) / 10.0f;
+    }
+#else
+    // The sdkconfig doesn't keep per-task run time
+    cpu["core_busy_pct"] = nullptr;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// Goertzel: µs per hop through a private detector, tone and silence
+// ----------------------------------------------------------------------------
+
+static void measureGoertzel(JsonObject out)
+{
+    const PhoneConfig& config = getPhoneConfig();
+    AudioInfo info = AUDIO_INFO_DEFAULT();
+    info.channels = 1;
+
+    auto stream = std::unique_ptr<DtmfGoertzelStream>(new DtmfGoertzelStream());
+    if (!stream->begin(info, config.rowFreqs, config.colFreqs,
+                       config.goertzelWindowMs, config.goertzelHopMs)) {
+        Logger.println("⚠️ [PERF] Goertzel stream init failed");
+        out["goertzel"] = nullptr;
+        return;
+    }
+
+    int samples = stream->inputHopSamples();
+    std::unique_ptr<int16_t[]> hop(new int16_t[samples]);
+    DtmfBandMagnitudes mags;
+
+    // '1' (697 + 1209 Hz) with the gate open, then zeros the gate drops
+    auto timeHops = [&](bool tone) -> float {
+        if (tone) {
+            for (int i = 0; i < samples; i++) {
+                float t = (float)i / info.sample_rate;
+                hop[i] = (int16_t)(6000.0f * (sinf(2 * PI * 697 * t) + sinf(2 * PI * 1209 * t)));
+            }
+        } else {
+            memset(hop.get(), 0, samples * sizeof(int16_t));
+        }
+        stream->reset();
+        stream->setGateMagnitude(tone ? 0 : 1.0f);
+        uint32_t totalUs = 0;
+        for (int n = 0; n < PERF_GOERTZEL_HOPS; n++) {
+            uint32_t t0 = micros();
+            stream->write((const uint8_t*)hop.get(), samples * sizeof(int16_t));
+            totalUs += micros() - t0;
+            while (stream->readMagnitudes(mags)) {}
+        }
+        return (float)totalUs / PERF_GOERTZEL_HOPS;
+    };
+
+    JsonObject g = out["goertzel"].to<JsonObject>();
+    g["hop_samples"] = samples;
+    g["us_per_hop"] = timeHops(true);
+    g["us_per_gated_hop"] = timeHops(false);
+    g["budget_us"] = stream->hopSize() * 1000000.0f / stream->detectorSampleRate();
+    stream->end();
+}
+
+// ----------------------------------------------------------------------------
+// Decoders: µs per decoded frame, feeding a fixed clip from SD
+// ----------------------------------------------------------------------------
+
+/// Decoder sink that only counts what comes out
+class PerfCountingOutput : public AudioOutput {
+public:
+    size_t   bytes = 0;
+    uint32_t frames = 0;                // write() calls: one per codec frame for Helix
+    AudioInfo format;
+
+    size_t write(const uint8_t* data, size_t len) override {
+        bytes += len;
+        frames++;
+        return len;
+    }
+    void setAudioInfo(AudioInfo info) override { format = info; }
+};
+
+static void measureDecoder(JsonObject decode, const char* name, AudioDecoder& decoder, const char* path)
+{
+    File file = PERF_SD.open(path, FILE_READ);
+    if (!file) {
+        Logger.printf("⚠️ [PERF] %s: %s not found\n", name, path);
+        decode[name] = nullptr;
+        return;
+    }
+
+    PerfCountingOutput sink;
+    decoder.setOutput(sink);
+    decoder.begin();
+
+    uint8_t buf[1024];
+    uint32_t decodeUs = 0;
+    unsigned long start = millis();
+    while (decodeUs < PERF_DECODE_MS * 1000UL && millis() - start < PERF_DECODE_MS * 2) {
+        int n = file.read(buf, sizeof(buf));
+        if (n <= 0) break;
+        uint32_t t0 = micros();
+        decoder.write(buf, n);
+        decodeUs += micros() - t0;
+        esp_task_wdt_reset();
+    }
+    decoder.end();
+    file.close();
+
+    JsonObject d = decode[name].to<JsonObject>();
+    d["frames"] = sink.frames;
+    d["us_per_frame"] = sink.frames ? (float)decodeUs / sink.frames : 0;
+    uint32_t bytesPerSec = sink.format.sample_rate * sink.format.channels * (sink.format.bits_per_sample / 8);
+    float audioSec = bytesPerSec ? (float)sink.bytes / bytesPerSec : 0;
+    d["audio_s"] = audioSec;
+    d["realtime_x"] = decodeUs ? audioSec * 1e6f / decodeUs : 0;
+}
+
+static void measureDecoders(JsonObject out)
+{
+    JsonObject decode = out["decode"].to<JsonObject>();
+    std::unique_ptr<AudioDecoder> mp3(new MP3DecoderHelix());
+    measureDecoder(decode, "mp3", *mp3, PERF_MP3_FILE);
+    mp3.reset();
+    std::unique_ptr<AudioDecoder> aac(new AACDecoderHelix());
+    measureDecoder(decode, "aac", *aac, PERF_AAC_FILE);
+    aac.reset();
+    std::unique_ptr<AudioDecoder> wav(new WAVDecoder());
+    measureDecoder(decode, "wav", *wav, PERF_WAV_FILE);
+}
+
+// ----------------------------------------------------------------------------
+// SD: sequential write and read of a temp file
+// ----------------------------------------------------------------------------
+
+static void measureSd(JsonObject out)
+{
+    static const char* path = "/perf.tmp";
+    const size_t chunk = 4096;
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[chunk]);
+    for (size_t i = 0; i < chunk; i++) buf[i] = (uint8_t)i;
+
+    File file = PERF_SD.open(path, FILE_WRITE);
+    if (!file) {
+        Logger.println("⚠️ [PERF] SD not writable; SD phase skipped");
+        out["sd"] = nullptr;
+        return;
+    }
+    uint32_t t0 = micros();
+    size_t written = 0;
+    while (written < PERF_SD_BYTES) {
+        size_t n = file.write(buf.get(), chunk);
+        if (n == 0) break;
+        written += n;
+        esp_task_wdt_reset();
+    }
+    file.close();                       // Includes the final flush
+    uint32_t writeUs = micros() - t0;
+
+    file = PERF_SD.open(path, FILE_READ);
+    size_t readBytes = 0;
+    t0 = micros();
+    while (file) {
+        int n = file.read(buf.get(), chunk);
+        if (n <= 0) break;
+        readBytes += n;
+        esp_task_wdt_reset();
+    }
+    uint32_t readUs = micros() - t0;
+    if (file) file.close();
+    PERF_SD.remove(path);
+
+    JsonObject sd = out["sd"].to<JsonObject>();
+    sd["bytes"] = written;
+    sd["write_mbps"] = writeUs ? written / (float)writeUs : 0;    // bytes/µs = MB/s
+    sd["read_mbps"] = readUs ? readBytes / (float)readUs : 0;
+}
+
+// ----------------------------------------------------------------------------
+// WebQueue: a catalog-class GET of server test data, streamed and dropped
+// ----------------------------------------------------------------------------
+
+struct PerfDownload {
+    size_t bytes = 0;
+    uint32_t firstByteMs = 0;
+    uint32_t startMs = 0;
+    bool done = false;
+    bool ok = false;
+    int status = 0;
+};
+
+static bool perfServerBase(String& base)
+{
+    base = PERF_SERVER_URL;
+    if (base.isEmpty()) {
+        // The log server's URL ends in /logs
+        base = RemoteLogger.getServerUrl();
+        if (base.endsWith("/logs")) base.remove(base.length() - 5);
+    }
+    while (base.endsWith("/")) base.remove(base.length() - 1);
+    return !base.isEmpty();
+}
+
+static void measureDownload(JsonObject out)
+{
+    String base;
+    if (WiFi.status() != WL_CONNECTED || !perfServerBase(base)) {
+        Logger.println("⚠️ [PERF] No network or server URL; download phase skipped");
+        out["download"] = nullptr;
+        return;
+    }
+    String url = base + "/perf/blob?bytes=" + String((unsigned long)PERF_DOWNLOAD_BYTES);
+
+    // Static: a download that outlives the phase still has somewhere to land
+    static PerfDownload dl;
+    if (dl.startMs && !dl.done) {
+        Logger.println("⚠️ [PERF] Last run's download still queued; download phase skipped");
+        out["download"] = nullptr;
+        return;
+    }
+    dl = PerfDownload();
+    dl.startMs = millis();
+    auto chunk = [](const uint8_t*, size_t len, void* user) -> bool {
+        PerfDownload* d = (PerfDownload*)user;
+        if (d->bytes == 0) d->firstByteMs = millis() - d->startMs;
+        d->bytes += len;
+        return true;
+    };
+    auto done = [](bool success, int status, const String&, void* user) {
+        PerfDownload* d = (PerfDownload*)user;
+        d->ok = success;
+        d->status = status;
+        d->done = true;
+    };
+    if (webQueue.enqueueCatalog(url.c_str(), done, &dl, chunk) != WebQueue::EnqueueResult::OK) {
+        Logger.println("⚠️ [PERF] Download queue full; download phase skipped");
+        dl.done = true;
+        out["download"] = nullptr;
+        return;
+    }
+
+    // loop() is here, so pump the queue ourselves
+    while (!dl.done && millis() - dl.startMs < PERF_DOWNLOAD_TIMEOUT_MS) {
+        webQueue.tick();
+        esp_task_wdt_reset();
+        yield();
+    }
+    uint32_t totalMs = millis() - dl.startMs;
+
+    JsonObject d = out["download"].to<JsonObject>();
+    d["ok"] = dl.ok;
+    d["status"] = dl.status;
+    d["bytes"] = dl.bytes;
+    d["first_byte_ms"] = dl.firstByteMs;
+    d["kbps"] = totalMs ? dl.bytes / (float)totalMs : 0;          // bytes/ms = KB/s
+}
+
+// ----------------------------------------------------------------------------
+// Driver
+// ----------------------------------------------------------------------------
+
+static void onPerfPosted(bool success, int status, void*)
+{
+    if (success) Logger.println("✅ [PERF] Results posted");
+    else Logger.printf("❌ [PERF] Posting results failed (HTTP %d)\n", status);
+}
+
+void performPerfSuite(bool post)
+{
+    if (Phone.isOffHook()) {
+        Logger.println("❌ [PERF] Hang up first; the suite plays audio and blocks loop()");
+        return;
+    }
+    powerManager.wake();
+
+    Logger.println("🔬 [PERF] Performance suite");
+    JsonDocument doc(psramJson());
+    doc["device"] = RemoteLogger.getDeviceId();
+    doc["firmware"] = FIRMWARE_VERSION;
+    doc["uptime_s"] = millis() / 1000;
+    JsonObject heap = doc["heap_delta"].to<JsonObject>();
+    HeapSnapshot first = HeapSnapshot::take();
+    JsonObject start = doc["heap_start"].to<JsonObject>();
+    start["free"] = first.internalFree;
+    start["largest"] = first.internalLargest;
+    start["psram"] = first.psramFree;
+
+    struct Phase { const char* name; void (*run)(JsonObject); };
+    static const Phase phases[] = {
+        { "cpu",      measureCpu },
+        { "goertzel", measureGoertzel },
+        { "decode",   measureDecoders },
+        { "sd",       measureSd },
+        { "download", measureDownload },
+    };
+    for (const Phase& phase : phases) {
+        Logger.printf("   %s...\n", phase.name);
+        HeapSnapshot before = HeapSnapshot::take();
+        phase.run(doc.as<JsonObject>());
+        addHeapDelta(heap, phase.name, before);
+        esp_task_wdt_reset();
+    }
+    addHeapDelta(heap, "total", first);
+
+    String json;
+    serializeJson(doc, json);
+    Logger.print("PERF_JSON ");
+    Logger.println(json);
+
+    if (post) {
+        String base;
+        if (!perfServerBase(base)) {
+            Logger.println("❌ [PERF] No server URL to post to");
+            return;
+        }
+        String url = base + "/perf";
+        if (webQueue.enqueuePost(url.c_str(), json, onPerfPosted, nullptr, "application/json",
+                                 "X-Device-ID", RemoteLogger.getDeviceId()) != WebQueue::EnqueueResult::OK) {
+            Logger.println("❌ [PERF] Post queue full");
+        }
+    }
+}
@@ -1,4 +1,8 @@
 #include "commands_internal.h"
+#include "file_utils.h"
+#include "esp_rom_crc.h"
+#include "ff.h"
+#include <vector>
 #ifdef TEST_MODE
 // ============================================================================
 // SD CARD DEBUG — Test various initialization methods and pin configurations
@@ -207,6 +211,7 @@ void performSDCardDebug() {
 
     Logger.println("Test: AudioKit with cfg.sd_active = true");
     Logger.println("   Restarting AudioKit...");
+    stopMicCapture();
     kit.end();
     delay(500);
 
@@ -245,6 +250,7 @@ void performSDCardDebug() {
     delay(500);
     cfg.sd_active = false;
     kit.begin(cfg);
+    startMicCapture(kit);
     delay(500);
     SPI.end();
     delay(500);
@@ -306,4 +312,233 @@ void performSDCardDebug() {
     Logger.println("⚠️  Reboot required to restore normal SD operation");
 }
 
-#endif
\ No newline at end of file
+#endif
+
+// ============================================================================
+// SD DEFRAGMENT — rewrite fragmented cached clips as contiguous files
+// ============================================================================
+//
+// A clip downloaded a chunk at a time on a well-used card ends up in many
+// pieces, and playback pays a seek for each. The job walks AUDIO_FILES_DIR,
+// counts each clip's fragments from its FAT cluster chain, and copies any
+// in more than minFragments pieces into a preallocated (contiguous) file
+// that then replaces it. It advances a little per tickSDDefrag() and only
+// while the phone is on-hook and silent.
+
+#ifndef SD_DEFRAG_MIN_FRAGMENTS
+#define SD_DEFRAG_MIN_FRAGMENTS 4        ///< Clips in more pieces than this are rewritten
+#endif
+
+#ifndef SD_DEFRAG_TICK_BYTES
+#define SD_DEFRAG_TICK_BYTES 16384       ///< Copied (or verified) per tickSDDefrag()
+#endif
+
+#ifndef SD_DEFRAG_FATFS_DRIVE
+#define SD_DEFRAG_FATFS_DRIVE "0:"       ///< FatFs drive the card is mounted as
+#endif
+
+#if SD_USE_MMC
+  #define DEFRAG_FS SD_MMC
+#else
+  #define DEFRAG_FS SD
+#endif
+
+enum class DefragPhase { SCAN, COPY, VERIFY };
+
+static struct {
+    bool active = false;
+    DefragPhase phase = DefragPhase::SCAN;
+    int minFragments = SD_DEFRAG_MIN_FRAGMENTS;
+    std::vector<String> clips;           // Still to check
+    size_t next = 0;
+    String path;                         // Clip being rewritten...
+    String copyPath;                     // ...into this
+    File src, dst;
+    size_t size = 0, done = 0;
+    uint32_t crc = 0, copyCrc = 0;
+    int fragments = 0;
+    int rewritten = 0, failed = 0;
+} defrag;
+
+/// Pieces a file's cluster chain is in (-1 if FatFs can't open it)
+static int countFragments(const char* path)
+{
+    char ffPath[160];
+    snprintf(ffPath, sizeof(ffPath), "%s%s", SD_DEFRAG_FATFS_DRIVE, path);
+    FIL fil;
+    if (f_open(&fil, ffPath, FA_READ) != FR_OK) return -1;
+#if FF_MAX_SS == FF_MIN_SS
+    FSIZE_t clusterBytes = (FSIZE_t)fil.obj.fs->csize * FF_MAX_SS;
+#else
+    FSIZE_t clusterBytes = (FSIZE_t)fil.obj.fs->csize * fil.obj.fs->ssize;
+#endif
+    int fragments = fil.obj.sclust ? 1 : 0;
+    DWORD prev = fil.obj.sclust;
+    // Seeking one byte into each cluster follows the chain through the FAT
+    for (FSIZE_t ofs = clusterBytes + 1; ofs <= f_size(&fil); ofs += clusterBytes) {
+        if (f_lseek(&fil, ofs) != FR_OK) break;
+        if (fil.clust != prev + 1) fragments++;
+        prev = fil.clust;
+    }
+    f_close(&fil);
+    return fragments;
+}
+
+/// Clips in AUDIO_FILES_DIR and its shard directories
+static void collectClips(const char* dirPath, bool shards)
+{
+    File dir = DEFRAG_FS.open(dirPath);
+    if (!dir || !dir.isDirectory()) return;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        String path = f.path();
+        bool isDir = f.isDirectory();
+        f.close();
+        if (isDir) {
+            if (shards) collectClips(path.c_str(), false);
+        } else if (!path.endsWith(".tmp") && !path.endsWith(".rng") && !path.endsWith(".dfg")) {
+            defrag.clips.push_back(path);
+        }
+    }
+    dir.close();
+}
+
+static void finishDefrag()
+{
+    Logger.printf("🧩 Defrag done: %u clip(s) checked, %d rewritten, %d failed\n",
+                  (unsigned)defrag.next, defrag.rewritten, defrag.failed);
+    defrag.active = false;
+    defrag.clips.clear();
+    defrag.clips.shrink_to_fit();
+}
+
+/// Drop the copy in progress (the original is untouched)
+static void abandonRewrite(const char* why)
+{
+    Logger.printf("⚠️ Defrag: %s — %s kept as it is\n", why, defrag.path.c_str());
+    if (defrag.src) defrag.src.close();
+    if (defrag.dst) defrag.dst.close();
+    DEFRAG_FS.remove(defrag.copyPath.c_str());
+    defrag.failed++;
+    defrag.phase = DefragPhase::SCAN;
+}
+
+static void beginRewrite(const String& path, int fragments)
+{
+    defrag.path = path;
+    defrag.copyPath = path + ".dfg";
+    defrag.fragments = fragments;
+    defrag.src = DEFRAG_FS.open(path.c_str(), FILE_READ);
+    defrag.size = defrag.src ? defrag.src.size() : 0;
+    defrag.dst = DEFRAG_FS.open(defrag.copyPath.c_str(), FILE_WRITE);
+    defrag.done = 0;
+    defrag.crc = 0;
+    defrag.phase = DefragPhase::COPY;
+    if (!defrag.src || !defrag.dst || defrag.size == 0) {
+        abandonRewrite("cannot open");
+    } else if (!preallocateFile(defrag.dst, defrag.size)) {
+        abandonRewrite("no room for a copy");
+    } else {
+        Logger.printf("🧩 Defrag: %s is in %d pieces, rewriting %u bytes\n",
+                      path.c_str(), fragments, (unsigned)defrag.size);
+    }
+}
+
+/// Copy read back intact: swap it in for the original
+static void completeRewrite()
+{
+    File original = DEFRAG_FS.open(defrag.path.c_str(), FILE_READ);
+    bool unchanged = original && original.size() == defrag.size;
+    if (original) original.close();
+    if (!unchanged) {
+        abandonRewrite("clip changed during the copy");
+        return;
+    }
+    if (!DEFRAG_FS.remove(defrag.path.c_str()) ||
+        !DEFRAG_FS.rename(defrag.copyPath.c_str(), defrag.path.c_str())) {
+        abandonRewrite("cannot replace");
+        return;
+    }
+    defrag.rewritten++;
+    defrag.phase = DefragPhase::SCAN;
+    Logger.printf("✅ Defrag: %s %d → %d piece(s)\n", defrag.path.c_str(), defrag.fragments,
+                  countFragments(defrag.path.c_str()));
+}
+
+void startSDDefrag(int minFragments)
+{
+    if (defrag.active) {
+        Logger.printf("🧩 Defrag already running (%u/%u clips)\n",
+                      (unsigned)defrag.next, (unsigned)defrag.clips.size());
+        return;
+    }
+    defrag.clips.clear();
+    collectClips(AUDIO_FILES_DIR, true);
+    defrag.next = 0;
+    defrag.rewritten = defrag.failed = 0;
+    defrag.minFragments = minFragments > 0 ? minFragments : SD_DEFRAG_MIN_FRAGMENTS;
+    defrag.phase = DefragPhase::SCAN;
+    defrag.active = true;
+    Logger.printf("🧩 Defrag: %u clip(s) to check, rewriting those in more than %d pieces while on-hook\n",
+                  (unsigned)defrag.clips.size(), defrag.minFragments);
+}
+
+void stopSDDefrag()
+{
+    if (!defrag.active) return;
+    if (defrag.phase != DefragPhase::SCAN) abandonRewrite("stopped");
+    finishDefrag();
+}
+
+void tickSDDefrag()
+{
+    if (!defrag.active) return;
+    // The copy competes for the card: only while nobody could be listening
+    if (Phone.isOffHook() || getExtendedAudioPlayer().isActive()) return;
+
+    if (defrag.phase == DefragPhase::SCAN) {
+        if (defrag.next >= defrag.clips.size()) {
+            finishDefrag();
+            return;
+        }
+        const String& path = defrag.clips[defrag.next++];
+        int fragments = countFragments(path.c_str());
+        if (fragments > defrag.minFragments) beginRewrite(path, fragments);
+        return;
+    }
+
+    static uint8_t buf[4096];
+    File& in = defrag.phase == DefragPhase::COPY ? defrag.src : defrag.dst;
+    uint32_t& crc = defrag.phase == DefragPhase::COPY ? defrag.crc : defrag.copyCrc;
+    for (size_t budget = SD_DEFRAG_TICK_BYTES; budget > 0 && defrag.done < defrag.size; ) {
+        int n = in.read(buf, min(sizeof(buf), budget));
+        if (n <= 0 || (defrag.phase == DefragPhase::COPY && defrag.dst.write(buf, n) != (size_t)n)) {
+            abandonRewrite(defrag.phase == DefragPhase::COPY ? "copy failed" : "read-back failed");
+            return;
+        }
+        crc = esp_rom_crc32_le(crc, buf, n);
+        defrag.done += n;
+        budget -= n;
+    }
+    if (defrag.done < defrag.size) return;
+
+    if (defrag.phase == DefragPhase::COPY) {
+        // Read the copy back before trusting it
+        defrag.src.close();
+        defrag.dst.close();
+        defrag.dst = DEFRAG_FS.open(defrag.copyPath.c_str(), FILE_READ);
+        if (!defrag.dst || defrag.dst.size() != defrag.size) {
+            abandonRewrite("copy is the wrong size");
+            return;
+        }
+        defrag.phase = DefragPhase::VERIFY;
+        defrag.done = 0;
+        defrag.copyCrc = 0;
+        return;
+    }
+    defrag.dst.close();
+    if (defrag.copyCrc != defrag.crc) {
+        abandonRewrite("copy does not match");
+        return;
+    }
+    completeRewrite();
+}
@@ -27,6 +27,7 @@ struct EEPROMHeader {
 
 static SpecialCommand specialCommands[MAX_SPECIAL_COMMANDS];
 static int specialCommandCount = 0;
+static uint32_t specialCommandsGeneration = 0;
 
 static Preferences preferences;
 
@@ -49,6 +50,7 @@ static const SpecialCommand DEFAULT_SPECIAL_COMMANDS[] = {
     {"*#08#", "Prepare for OTA"},
     {"*#09#", "Phone Home Check-in"},
     {"*#88#", "Tailscale Status"},
+    {"*#225#", "Calibrate DTMF"},
 
     // ========== EEPROM MANAGEMENT ==========
     {"*#01#", "Save to EEPROM"},
@@ -120,6 +122,7 @@ bool addSpecialCommand(const char* sequence, const char* description, void (*han
     specialCommands[specialCommandCount].description = descCopy;
     specialCommands[specialCommandCount].handler     = handler;
     specialCommandCount++;
+    specialCommandsGeneration++;
 
     Logger.printf("✅ Added special command: %s - %s\n", sequence, description);
     saveSpecialCommandsToEEPROM();
@@ -130,12 +133,22 @@ int getSpecialCommandCount() {
     return specialCommandCount;
 }
 
+const char* getSpecialCommandSequence(int index) {
+    if (index < 0 || index >= specialCommandCount) return nullptr;
+    return specialCommands[index].sequence;
+}
+
+uint32_t getSpecialCommandsGeneration() {
+    return specialCommandsGeneration;
+}
+
 void clearSpecialCommands() {
     for (int i = 0; i < specialCommandCount; i++) {
         if (specialCommands[i].sequence)    free((void*)specialCommands[i].sequence);
         if (specialCommands[i].description) free((void*)specialCommands[i].description);
     }
     specialCommandCount = 0;
+    specialCommandsGeneration++;
     memset(specialCommands, 0, sizeof(specialCommands));
 }
 
@@ -280,6 +293,7 @@ void assignDefaultHandler(int index, const char* sequence) {
     else if (strcmp(sequence, "*#08#")      == 0) specialCommands[index].handler = executePrepareOTA;
     else if (strcmp(sequence, "*#09#")      == 0) specialCommands[index].handler = executePhoneHome;
     else if (strcmp(sequence, "*#88#")      == 0) specialCommands[index].handler = executeTailscaleStatus;
+    else if (strcmp(sequence, "*#225#")     == 0) specialCommands[index].handler = executeCalibrateDtmf;
     else if (strcmp(sequence, "*#01#")      == 0) specialCommands[index].handler = executeSaveEEPROM;
     else if (strcmp(sequence, "*#02#")      == 0) specialCommands[index].handler = executeLoadEEPROM;
     else if (strcmp(sequence, "*#99#")      == 0) specialCommands[index].handler = executeEraseEEPROM;
@@ -355,6 +369,7 @@ void executeFactoryReset() {
     Logger.printf("⚠️  FACTORY RESET initiated!\n");
     Logger.printf("🗑️  Clearing all settings...\n");
     eraseSpecialCommandsFromEEPROM();
+    clearGoertzelCalibration();
     Logger.printf("🔄 Restarting...\n");
     delay(2000);
     ESP.restart();
@@ -454,3 +469,13 @@ void executeTailscaleStatus() {
         Logger.printf("   Configure via WIREGUARD_* build flags\n");
     }
 }
+
+void executeCalibrateDtmf() {
+    if (isGoertzelCalibrating()) {
+        Logger.printf("🎯 DTMF calibration already running\n");
+        return;
+    }
+    Logger.printf("🎯 DTMF calibration: press every key 1-9, *, 0, # once within %d seconds\n",
+                  GOERTZEL_CALIBRATION_TIMEOUT_MS / 1000);
+    startGoertzelCalibration();
+}
@@ -0,0 +1,158 @@
+/**
+ * @file decoder_pool.cpp
+ * @brief Decoders created on first use and freed again when idle
+ *
+ * @date 2026
+ */
+
+#include "decoder_pool.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+
+DecoderPool decoderPool;
+
+// ============================================================================
+// LazyDecoder
+// ============================================================================
+
+LazyDecoder::LazyDecoder(Factory factory, size_t size, const char* name)
+    : _factory(factory), _size(size), _name(name) {
+    decoderPool.add(this);
+}
+
+LazyDecoder::~LazyDecoder() {
+    decoderPool.lock();
+    destroy();
+    decoderPool.unlock();
+}
+
+bool LazyDecoder::create() {
+    if (_decoder) return true;
+    _mem = heap_caps_malloc(_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    _inPsram = _mem != nullptr;
+    if (!_mem) _mem = heap_caps_malloc(_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!_mem) {
+        Logger.printf("❌ [DEC] No memory for %s decoder (%u bytes)\n", _name, (unsigned)_size);
+        return false;
+    }
+    _decoder = _factory(_mem);
+    _decoder->addNotifyAudioChange(*this);   // Forwarded on to our listeners
+    if (p_print) _decoder->setOutput(*p_print);
+    _creations++;
+    LOG_PRINTF(AUDIO, "🎵 [DEC] Created %s decoder (%u bytes, %s)\n",
+               _name, (unsigned)_size, _inPsram ? "PSRAM" : "internal");
+    return true;
+}
+
+void LazyDecoder::destroy() {
+    if (!_decoder) return;
+    if (_open) _decoder->end();
+    _decoder->~AudioDecoder();
+    heap_caps_free(_mem);
+    _decoder = nullptr;
+    _mem = nullptr;
+    _open = false;
+    LOG_PRINTF(AUDIO, "🎵 [DEC] Freed idle %s decoder\n", _name);
+}
+
+void LazyDecoder::setOutput(Print& out) {
+    p_print = &out;
+    decoderPool.lock();
+    if (_decoder) _decoder->setOutput(out);
+    decoderPool.unlock();
+}
+
+bool LazyDecoder::begin() {
+    decoderPool.lock();
+    bool ok = create() && _decoder->begin();
+    _open = ok;
+    _lastUsed = millis();
+    decoderPool.unlock();
+    return ok;
+}
+
+void LazyDecoder::end() {
+    decoderPool.lock();
+    if (_decoder && _open) _decoder->end();
+    _open = false;
+    _lastUsed = millis();
+    decoderPool.unlock();
+}
+
+size_t LazyDecoder::write(const uint8_t* data, size_t len) {
+    decoderPool.lock();
+    size_t written = 0;
+    // Freed while idle but written again without a begin(): start over
+    if (_decoder || (create() && (_open = _decoder->begin()))) {
+        written = _decoder->write(data, len);
+    }
+    _lastUsed = millis();
+    decoderPool.unlock();
+    return written;
+}
+
+AudioInfo LazyDecoder::audioInfo() {
+    return _decoder ? _decoder->audioInfo() : info;
+}
+
+bool LazyDecoder::isResultPCM() {
+    return _decoder ? _decoder->isResultPCM() : true;
+}
+
+LazyDecoder::operator bool() {
+    return _decoder && *_decoder;
+}
+
+// ============================================================================
+// DecoderPool
+// ============================================================================
+
+// Called from LazyDecoder constructors, i.e. during static initialization.
+// Recursive: the M4A container writes into the lazy AAC decoder.
+void DecoderPool::add(LazyDecoder* d) {
+    if (!_lock) _lock = xSemaphoreCreateRecursiveMutex();
+    if (_count < DECODER_POOL_MAX) _decoders[_count++] = d;
+}
+
+void DecoderPool::lock() {
+    if (_lock) xSemaphoreTakeRecursive(_lock, portMAX_DELAY);
+}
+
+void DecoderPool::unlock() {
+    if (_lock) xSemaphoreGiveRecursive(_lock);
+}
+
+void DecoderPool::tick(bool playerActive) {
+    unsigned long now = millis();
+    if (playerActive || now - _lastTick < 1000) return;
+    _lastTick = now;
+    lock();
+    for (int i = 0; i < _count; i++) {
+        LazyDecoder* d = _decoders[i];
+        if (d->_decoder && now - d->_lastUsed >= DECODER_IDLE_MS) d->destroy();
+    }
+    unlock();
+}
+
+void DecoderPool::printStatus() {
+    unsigned long now = millis();
+    size_t liveBytes = 0;
+    Logger.println("🎵 Decoders (created on first use):");
+    lock();
+    for (int i = 0; i < _count; i++) {
+        LazyDecoder* d = _decoders[i];
+        if (d->_decoder) {
+            liveBytes += d->_size;
+            Logger.printf("   %-6s live, %u bytes in %s, %s, idle %lu ms, created %lu×\n",
+                          d->_name, (unsigned)d->_size, d->_inPsram ? "PSRAM" : "internal",
+                          d->_open ? "open" : "closed", now - d->_lastUsed,
+                          (unsigned long)d->_creations);
+        } else {
+            Logger.printf("   %-6s not allocated (%u bytes), created %lu×\n",
+                          d->_name, (unsigned)d->_size, (unsigned long)d->_creations);
+        }
+    }
+    unlock();
+    Logger.printf("   %u bytes live, idle timeout %lu s\n",
+                  (unsigned)liveBytes, (unsigned long)(DECODER_IDLE_MS / 1000));
+}
@@ -2,6 +2,7 @@
 #include "logging.h"
 #include "config.h"
 #include "phone.h"
+#include <Preferences.h>
 #ifdef TEST_MODE
 #include "test_helpers/dtmf_goertzel_test_helpers.h"
 #endif
@@ -10,16 +11,33 @@
 // GOERTZEL DTMF DETECTOR — Block-accumulation with debounce
 //
 // Architecture:
-//   GoertzelStream fires a callback for each DTMF frequency above threshold
-//   within each block of audio. We accumulate the magnitudes, find the
-//   strongest row and column, apply twist+magnitude checks, and require
-//   multiple consecutive matching blocks before emitting a digit.
+//   StreamCopy frames mic PCM into DtmfGoertzelStream, which decimates it
+//   to ~8.8kHz and runs the fixed-point 8-bin engine
+//   (dtmf_goertzel_engine.h) once per block and
+//   hands back all row/col magnitudes in one struct. We zero bins below the
+//   presence threshold, find the strongest row and column, apply
+//   magnitude, twist, harmonic and energy checks, and require multiple consecutive matching blocks
+//   before emitting a digit.
 //
-// Key parameters (from PhoneConfig):
-//   - fundamentalMagnitudeThreshold: GoertzelStream callback threshold
-//   - goertzelBlockSize: samples per Goertzel block (~46ms at 2048/44100)
-//   - requiredConsecutive: blocks needed to confirm a digit (3 = ~139ms)
-//   - goertzelReleaseMs: silence duration to consider key released
+// Key parameters (from PhoneConfig, or a stored keypad calibration):
+//   - presenceSnrDb / fundamentalMagnitudeThreshold: per-bin presence,
+//     relative to that bin's noise floor with an absolute minimum
+//   - detectionSnrDb / minDetectionMagnitude: same for the chosen row/col
+//   - maxHarmonicRatio / minToneEnergyRatio: talk-off rejection from the
+//     2nd-harmonic bins and the window energy (0 = off)
+//   - goertzelWindowMs: Goertzel window length in ms
+//   - goertzelHopMs: time between evaluations in ms (0 = non-overlapping)
+//   - requiredConsecutive: evaluations needed to confirm a digit
+//   - releaseBlockCount: silent evaluations to consider key released
+//
+// The noise floor is a per-bin running minimum over windows classified as
+// silence (nothing above presence), so on a noisy line the thresholds rise
+// with the floor instead of needing a retuned build.
+//
+// With a hop, every evaluation sees the trailing full window, so debounce
+// runs on overlapping windows: the first hits come from partially filled
+// windows and requiredConsecutive > window/hop guarantees at least one
+// window fully inside the tone before a digit is emitted.
 //
 // Bowie Phone specifics:
 //   - High band (cols) is 2-9x stronger than low band (rows)
@@ -35,22 +53,12 @@ static const char GOERTZEL_DTMF_KEYPAD[4][4] = {
     {'*', '0', '#', 'D'}
 };
 
-
-// Reference structure for Goertzel DTMF frequencies
-struct GoertzelDTMFRef {
-    enum Type { Row, Col };
-    Type type;
-    int index;
-};
-
 // ============================================================================
 // DETECTION STATE
 // ============================================================================
 
-// Per-block magnitude accumulators (written in callback, read in evaluateBlock)
-static volatile float blockRowMags[4] = {0, 0, 0, 0};
-static volatile float blockColMags[4] = {0, 0, 0, 0};
-static volatile bool blockDataReady = false;
+// Block source (set by initGoertzelDecoder, read only from the Goertzel task)
+static DtmfGoertzelStream* goertzelStreamPtr = nullptr;
 
 // Consecutive detection state
 static char candidateDigit = 0;        // Current digit candidate being evaluated
@@ -62,106 +70,306 @@ static int consecutiveMisses = 0;      // How many consecutive blocks had no val
 static const int GOERTZEL_KEY_QUEUE_SIZE = 8;
 static QueueHandle_t goertzelKeyQueue = nullptr;
 static char emittedKey = 0;                   // Last emitted key (suppress repeat emission)
+static uint32_t candidateStartEval = 0;       // stats.evaluations at the candidate's first hit
+static float evaluationMs = 0;                // Time between evaluations (one hop)
+
+// Detector statistics (Goertzel task writes; see GoertzelDetectorStats)
+static GoertzelDetectorStats stats = {};
+static volatile bool statsResetRequested = false;
+// Thresholds from reloadGoertzelThresholds(), picked up by the Goertzel task
+static GoertzelThresholds pendingThresholds;
+static volatile bool thresholdsReloadRequested = false;
+
+static int magnitudeBucket(float mag) {
+    int bucket = 0;
+    for (float edge = 16.0f; bucket < GOERTZEL_HISTOGRAM_BUCKETS - 1 && mag >= edge; edge *= 2.0f) {
+        bucket++;
+    }
+    return bucket;
+}
+
+static void recordReject(uint32_t& counter, float rowMag, float colMag) {
+    counter++;
+    stats.rejectMagnitude[magnitudeBucket(rowMag < colMag ? rowMag : colMag)]++;
+}
+
+static void recordEmit(int row, int col, float rowMag, float colMag) {
+    stats.detections[row * 4 + col]++;
+    stats.emitMagnitude[magnitudeBucket(rowMag < colMag ? rowMag : colMag)]++;
+
+    uint32_t ms = (uint32_t)lrintf((stats.evaluations - candidateStartEval + 1) * evaluationMs);
+    int bucket = ms / GOERTZEL_LATENCY_BUCKET_MS;
+    stats.latency[bucket < GOERTZEL_HISTOGRAM_BUCKETS ? bucket : GOERTZEL_HISTOGRAM_BUCKETS - 1]++;
+    if (stats.latencyMinMs == 0 || ms < stats.latencyMinMs) stats.latencyMinMs = ms;
+    if (ms > stats.latencyMaxMs) stats.latencyMaxMs = ms;
+    stats.latencyTotalMs += ms;
+}
 
 // Mute flag — when true, evaluateBlock() skips detection entirely.
 // Used to suppress false DTMF from ES8388 DAC→ADC internal loopback during playback.
 static volatile bool goertzelMuted = false;
 
+// Loopback reference: the player's PCM through an identical stream, fed in
+// lockstep with the mic so each mic window has a matching reference window
+static DtmfGoertzelStream referenceStream;
+static DtmfLoopbackCanceller loopbackCanceller;
+static bool referenceActive = false;
+
 // ============================================================================
-// GOERTZEL CALLBACK
-//
-// Called by GoertzelStream for each registered frequency whose magnitude
-// exceeds the threshold. All callbacks for one block happen sequentially
-// within the same copy() call, so no threading concern here.
+// THRESHOLDS AND CALIBRATION
 // ============================================================================
 
-void onGoertzelFrequency(float frequency, float magnitude, void* ref) {
-    if (ref == nullptr) return;
-    
-    GoertzelDTMFRef* dtmfRef = (GoertzelDTMFRef*)ref;
-    
-    if (dtmfRef->type == GoertzelDTMFRef::Row) {
-        // Keep the strongest row magnitude per block
-        if (magnitude > blockRowMags[dtmfRef->index]) {
-            blockRowMags[dtmfRef->index] = magnitude;
-        }
-    } else {
-        // Keep the strongest col magnitude per block
-        if (magnitude > blockColMags[dtmfRef->index]) {
-            blockColMags[dtmfRef->index] = magnitude;
-        }
+#define GOERTZEL_PREFS_NAMESPACE "dtmf"
+
+// Keys a calibration sweep must see (A-D are not on the handset)
+static const char CALIBRATION_KEYS[] = "123456789*0#";
+static const int CALIBRATION_KEY_COUNT = sizeof(CALIBRATION_KEYS) - 1;
+
+// Active thresholds and their SNR gates as amplitude ratios
+// (written only by the Goertzel task once running)
+static GoertzelThresholds thresholds = {};
+static float presenceRatio = 1.0f;
+static float detectionRatio = 1.0f;
+static DtmfNoiseFloor noiseFloor;
+
+// Requests from other tasks, applied at the next evaluation
+static volatile bool calibrationStartRequested = false;
+static volatile bool calibrationClearRequested = false;
+
+// Sweep state (Goertzel task only)
+static volatile bool calibrating = false;
+static unsigned long calibrationStartMs = 0;
+static uint16_t calibrationSeen = 0;      // Bit per CALIBRATION_KEYS entry
+static float calibrationWeakest = 0;      // Weaker band of the weakest key
+static float calibrationMaxTwist = 0;
+
+static void applyThresholds(const GoertzelThresholds& t) {
+    thresholds = t;
+    presenceRatio = dtmfDbToRatio(t.presenceSnrDb);
+    detectionRatio = dtmfDbToRatio(t.detectionSnrDb);
+}
+
+static GoertzelThresholds defaultThresholds() {
+    const PhoneConfig& config = getPhoneConfig();
+    GoertzelThresholds t;
+    t.presenceSnrDb = config.presenceSnrDb;
+    t.detectionSnrDb = config.detectionSnrDb;
+    t.minPresenceMagnitude = config.fundamentalMagnitudeThreshold;
+    t.minDetectionMagnitude = config.minDetectionMagnitude;
+    t.maxTwistRatio = config.maxTwistRatio;
+    t.calibrated = false;
+    return t;
+}
+
+#ifndef TEST_MODE  // Host builds use the PhoneConfig thresholds
+static bool loadCalibration(GoertzelThresholds& t) {
+    Preferences prefs;
+    if (!prefs.begin(GOERTZEL_PREFS_NAMESPACE, true)) {
+        return false;
+    }
+    bool found = prefs.isKey("detSnr");
+    if (found) {
+        t.presenceSnrDb = prefs.getFloat("presSnr", t.presenceSnrDb);
+        t.detectionSnrDb = prefs.getFloat("detSnr", t.detectionSnrDb);
+        t.minPresenceMagnitude = prefs.getFloat("minPres", t.minPresenceMagnitude);
+        t.minDetectionMagnitude = prefs.getFloat("minDet", t.minDetectionMagnitude);
+        t.maxTwistRatio = prefs.getFloat("twist", t.maxTwistRatio);
+        t.calibrated = true;
     }
-    blockDataReady = true;
+    prefs.end();
+    return found;
+}
+#endif
+
+static void saveCalibration(const GoertzelThresholds& t) {
+    Preferences prefs;
+    if (!prefs.begin(GOERTZEL_PREFS_NAMESPACE, false)) {
+        Logger.println("❌ Failed to open DTMF preferences for writing");
+        return;
+    }
+    prefs.putFloat("presSnr", t.presenceSnrDb);
+    prefs.putFloat("detSnr", t.detectionSnrDb);
+    prefs.putFloat("minPres", t.minPresenceMagnitude);
+    prefs.putFloat("minDet", t.minDetectionMagnitude);
+    prefs.putFloat("twist", t.maxTwistRatio);
+    prefs.end();
+}
+
+static void eraseCalibration() {
+    Preferences prefs;
+    if (prefs.begin(GOERTZEL_PREFS_NAMESPACE, false)) {
+        prefs.clear();
+        prefs.end();
+    }
+}
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// Derive thresholds from the sweep: the weakest key must clear detection
+// by GOERTZEL_CALIBRATION_MARGIN_DB, presence sits the same margin lower,
+// and twist gets 50% headroom over the worst key seen.
+static void finishCalibration() {
+    GoertzelThresholds t;
+    float weakestSnrDb = dtmfRatioToDb(calibrationWeakest / noiseFloor.maxFloor());
+    t.detectionSnrDb = clampf(weakestSnrDb - GOERTZEL_CALIBRATION_MARGIN_DB,
+                              GOERTZEL_MIN_SNR_DB, GOERTZEL_MAX_SNR_DB);
+    t.presenceSnrDb = clampf(t.detectionSnrDb - GOERTZEL_CALIBRATION_MARGIN_DB,
+                             GOERTZEL_MIN_SNR_DB, t.detectionSnrDb);
+    t.minDetectionMagnitude = calibrationWeakest * 0.5f;
+    t.minPresenceMagnitude = t.minDetectionMagnitude * 0.25f;
+    t.maxTwistRatio = clampf(calibrationMaxTwist * 1.5f, 2.0f, GOERTZEL_CALIBRATION_MAX_TWIST);
+    t.calibrated = true;
+
+    calibrating = false;
+    applyThresholds(t);
+    saveCalibration(t);
+    LOG_PRINTF(DTMF, "✅ DTMF calibration saved: weakest=%.0f (%.1fdB over floor %.1f), worst twist=%.1f\n",
+                     calibrationWeakest, weakestSnrDb, noiseFloor.maxFloor(), calibrationMaxTwist);
+    LOG_PRINTF(DTMF, "   presence=%.1fdB/%.1f detection=%.1fdB/%.1f twist<%.1f\n",
+                     t.presenceSnrDb, t.minPresenceMagnitude,
+                     t.detectionSnrDb, t.minDetectionMagnitude, t.maxTwistRatio);
+}
+
+static void recordCalibrationKey(char digit, float rowMag, float colMag) {
+    const char* pos = strchr(CALIBRATION_KEYS, digit);
+    if (pos == nullptr) {
+        return;
+    }
+    int index = pos - CALIBRATION_KEYS;
+    float weaker = rowMag < colMag ? rowMag : colMag;
+    float twist = (rowMag > colMag ? rowMag : colMag) / weaker;
+
+    if (calibrationSeen == 0 || weaker < calibrationWeakest) calibrationWeakest = weaker;
+    if (twist > calibrationMaxTwist) calibrationMaxTwist = twist;
+    calibrationSeen |= (1 << index);
+
+    int seen = 0;
+    for (int i = 0; i < CALIBRATION_KEY_COUNT; i++) {
+        if (calibrationSeen & (1 << i)) seen++;
+    }
+    LOG_PRINTF(DTMF, "🎯 Calibration: '%c' row=%.0f col=%.0f twist=%.1f (%d/%d)\n",
+                     digit, rowMag, colMag, twist, seen, CALIBRATION_KEY_COUNT);
+    if (seen == CALIBRATION_KEY_COUNT) {
+        finishCalibration();
+    }
+}
+
+// Apply start/clear requests and the sweep timeout (Goertzel task context)
+static void serviceCalibration() {
+    if (calibrationClearRequested) {
+        calibrationClearRequested = false;
+        calibrating = false;
+        applyThresholds(defaultThresholds());
+    }
+    if (calibrationStartRequested) {
+        calibrationStartRequested = false;
+        calibrating = true;
+        calibrationStartMs = millis();
+        calibrationSeen = 0;
+        calibrationWeakest = 0;
+        calibrationMaxTwist = 0;
+        LOG_PRINTF(DTMF, "🎯 DTMF calibration: press 1-9, *, 0, # once each (noise floor %.1f)\n",
+                         noiseFloor.maxFloor());
+    }
+    if (calibrating && millis() - calibrationStartMs > GOERTZEL_CALIBRATION_TIMEOUT_MS) {
+        calibrating = false;
+        Logger.println("⚠️ DTMF calibration timed out — thresholds unchanged");
+    }
+}
+
+// Weakest magnitude any bin needs for presence: a hop without the energy
+// of a tone this strong can't contribute to a detection
+static float presenceGateMagnitude() {
+    float weakest = 0;
+    for (int bin = 0; bin < 8; bin++) {
+        float need = noiseFloor.floor(bin) * presenceRatio;
+        if (need < thresholds.minPresenceMagnitude) need = thresholds.minPresenceMagnitude;
+        if (bin == 0 || need < weakest) weakest = need;
+    }
+    return weakest;
 }
 
 // ============================================================================
 // BLOCK EVALUATION
 //
 // Called from the Goertzel task after each copy() cycle.
-// Looks at accumulated magnitudes and runs the detection state machine.
+// Runs the detection state machine once per window result the copy produced.
 // ============================================================================
 
-static void evaluateBlock() {
-    if (goertzelMuted) {
-        // Discard accumulated data — DAC→ADC loopback would cause false detections
-        for (int i = 0; i < 4; i++) {
-            blockRowMags[i] = 0;
-            blockColMags[i] = 0;
-        }
-        blockDataReady = false;
-        return;
-    }
-    
+static void evaluateMagnitudes(const DtmfBandMagnitudes& mags) {
     const PhoneConfig& config = getPhoneConfig();
-    
-    if (!blockDataReady) {
-        // No frequencies above threshold in this cycle — silence
+
+    if (mags.gated) {
+        // Too quiet to hold a tone: silence. There are no bin magnitudes, but
+        // the window's energy bounds them all; without this a floor left high
+        // by a noisy spell would keep the gate (set from it) shut for good
+        if (mags.total > 0) {
+            noiseFloor.limit(mags.total);
+        }
+        stats.gatedWindows++;
         consecutiveMisses++;
-        
         if (consecutiveMisses >= config.releaseBlockCount) {
-            // Key released — reset for next press
-            if (emittedKey != 0) {
-                Logger.printf("🎵 Goertzel: key '%c' released (silence)\n", emittedKey);
-                emittedKey = 0;
-            }
+            emittedKey = 0;
             candidateDigit = 0;
             consecutiveHits = 0;
         }
         return;
     }
+
+    // While sweeping, accept anything a few dB over the floor so a handset
+    // the current thresholds miss can still be measured
+    float presenceRatioNow = calibrating ? dtmfDbToRatio(GOERTZEL_CALIBRATION_SNR_DB) : presenceRatio;
+    float detectionRatioNow = calibrating ? presenceRatioNow : detectionRatio;
+    float minPresence = calibrating ? 0 : thresholds.minPresenceMagnitude;
+    float minDetection = calibrating ? 0 : thresholds.minDetectionMagnitude;
+    float maxTwist = calibrating ? GOERTZEL_CALIBRATION_MAX_TWIST : thresholds.maxTwistRatio;
     
-    // Find strongest row and strongest column
+    // Find strongest row and strongest column above the presence threshold
     int bestRow = -1;
     float bestRowMag = 0;
     int bestCol = -1;
     float bestColMag = 0;
     
     for (int i = 0; i < 4; i++) {
-        if (blockRowMags[i] > bestRowMag) {
-            bestRowMag = blockRowMags[i];
+        float rowThresh = noiseFloor.rowFloor(i) * presenceRatioNow;
+        float colThresh = noiseFloor.colFloor(i) * presenceRatioNow;
+        if (rowThresh < minPresence) rowThresh = minPresence;
+        if (colThresh < minPresence) colThresh = minPresence;
+        float rowMag = mags.row[i] > rowThresh ? mags.row[i] : 0;
+        float colMag = mags.col[i] > colThresh ? mags.col[i] : 0;
+        if (rowMag > bestRowMag) {
+            bestRowMag = rowMag;
             bestRow = i;
         }
-        if (blockColMags[i] > bestColMag) {
-            bestColMag = blockColMags[i];
+        if (colMag > bestColMag) {
+            bestColMag = colMag;
             bestCol = i;
         }
     }
     
-    // Reset accumulators for next block
-    for (int i = 0; i < 4; i++) {
-        blockRowMags[i] = 0;
-        blockColMags[i] = 0;
+    if (bestRow < 0 && bestCol < 0) {
+        // No frequencies above threshold in this block — silence
+        noiseFloor.update(mags);
+        stats.silentWindows++;
+        consecutiveMisses++;
+        
+        if (consecutiveMisses >= config.releaseBlockCount) {
+            // Key released — reset for next press
+            emittedKey = 0;
+            candidateDigit = 0;
+            consecutiveHits = 0;
+        }
+        return;
     }
-    blockDataReady = false;
     
     // Need BOTH a row and a column to be a valid DTMF tone
     if (bestRow < 0 || bestCol < 0) {
+        stats.rejectPartial++;
         consecutiveMisses++;
         if (consecutiveMisses >= config.releaseBlockCount) {
-            if (emittedKey != 0) {
-                Logger.printf("🎵 Goertzel: key '%c' released (partial)\n", emittedKey);
-                emittedKey = 0;
-            }
+            emittedKey = 0;
             candidateDigit = 0;
             consecutiveHits = 0;
         }
@@ -170,7 +378,12 @@ static void evaluateBlock() {
     
     // Magnitude floor — reject weak loopback artifacts from ES8388 DAC→ADC
     // Real DTMF presses produce magnitudes in the hundreds; loopback gives 12-24
-    if (bestRowMag < config.minDetectionMagnitude || bestColMag < config.minDetectionMagnitude) {
+    float rowFloor = noiseFloor.rowFloor(bestRow) * detectionRatioNow;
+    float colFloor = noiseFloor.colFloor(bestCol) * detectionRatioNow;
+    if (rowFloor < minDetection) rowFloor = minDetection;
+    if (colFloor < minDetection) colFloor = minDetection;
+    if (bestRowMag < rowFloor || bestColMag < colFloor) {
+        recordReject(stats.rejectFloor, bestRowMag, bestColMag);
         consecutiveMisses++;
         return;
     }
@@ -179,9 +392,40 @@ static void evaluateBlock() {
     float maxMag = (bestRowMag > bestColMag) ? bestRowMag : bestColMag;
     float minMag = (bestRowMag < bestColMag) ? bestRowMag : bestColMag;
     
-    if (minMag <= 0 || (maxMag / minMag) > config.maxTwistRatio) {
+    if (minMag <= 0 || (maxMag / minMag) > maxTwist) {
         // Too imbalanced — likely noise or single-band interference
+        recordReject(stats.rejectTwist, bestRowMag, bestColMag);
+        consecutiveMisses++;
+        return;
+    }
+
+    // Talk-off checks (skipped while calibrating, which only measures).
+    // Voice and music have strong 2nd harmonics; DTMF generators don't.
+    // Compared pair-to-pair: row harmonics sit 58-71Hz from a column
+    // frequency, so with high twist a per-band test would trip on leakage.
+    float pairEnergy = bestRowMag * bestRowMag + bestColMag * bestColMag;
+    float rowH = mags.rowHarmonic[bestRow];
+    float colH = mags.colHarmonic[bestCol];
+    if (!calibrating && config.maxHarmonicRatio > 0 &&
+        rowH * rowH + colH * colH >
+            config.maxHarmonicRatio * config.maxHarmonicRatio * pairEnergy) {
+        recordReject(stats.rejectHarmonic, bestRowMag, bestColMag);
         consecutiveMisses++;
+        // Break the streak: speech must not build a digit from windows
+        // either side of a rejected one
+        candidateDigit = 0;
+        consecutiveHits = 0;
+        return;
+    }
+
+    // The pair must carry most of the window's energy (total = 0 while
+    // playback makes it unmeasurable)
+    if (!calibrating && config.minToneEnergyRatio > 0 && mags.total > 0 &&
+        pairEnergy < config.minToneEnergyRatio * mags.total * mags.total) {
+        recordReject(stats.rejectEnergy, bestRowMag, bestColMag);
+        consecutiveMisses++;
+        candidateDigit = 0;
+        consecutiveHits = 0;
         return;
     }
     
@@ -196,91 +440,135 @@ static void evaluateBlock() {
         // Different digit — start new candidate
         candidateDigit = digit;
         consecutiveHits = 1;
+        candidateStartEval = stats.evaluations;
     }
     
     // Emit when we have enough consecutive matching blocks AND it's a new key
     if (consecutiveHits >= config.requiredConsecutive && digit != emittedKey) {
         emittedKey = digit;
-        if (goertzelKeyQueue != nullptr) {
-            xQueueSend(goertzelKeyQueue, &digit, 0);  // non-blocking
+        if (calibrating) {
+            // Measured, not dialled
+            recordCalibrationKey(digit, bestRowMag, bestColMag);
+            return;
         }
-        
-        Logger.printf("🎵 Goertzel DTMF: '%c' (row=%d/%.0f col=%d/%.0f twist=%.1f hits=%d)\n",
-                     digit, bestRow, bestRowMag, bestCol, bestColMag,
-                     maxMag / minMag, consecutiveHits);
+        if (goertzelKeyQueue != nullptr && xQueueSend(goertzelKeyQueue, &digit, 0) != pdTRUE) {
+            stats.queueDrops++;  // non-blocking; main loop fell behind
+        }
+        // No log here: this runs in the detection task (see printGoertzelStats)
+        recordEmit(bestRow, bestCol, bestRowMag, bestColMag);
     }
 }
 
-// ============================================================================
-// STATIC REFERENCES (must persist for GoertzelStream callbacks)
-// ============================================================================
-
-static GoertzelDTMFRef rowRefs[4] = {
-    {GoertzelDTMFRef::Row, 0},
-    {GoertzelDTMFRef::Row, 1},
-    {GoertzelDTMFRef::Row, 2},
-    {GoertzelDTMFRef::Row, 3}
-};
-static GoertzelDTMFRef colRefs[4] = {
-    {GoertzelDTMFRef::Col, 0},
-    {GoertzelDTMFRef::Col, 1},
-    {GoertzelDTMFRef::Col, 2},
-    {GoertzelDTMFRef::Col, 3}
-};
+static void evaluateBlock(DtmfGoertzelStream& stream) {
+    DtmfBandMagnitudes mags;
+    DtmfBandMagnitudes ref;
+    serviceCalibration();
+    if (statsResetRequested) {
+        statsResetRequested = false;
+        stats = {};
+    }
+    if (thresholdsReloadRequested) {
+        thresholdsReloadRequested = false;
+        applyThresholds(pendingThresholds);
+    }
+    while (stream.readMagnitudes(mags)) {
+        // Always pop the reference so the two queues stay in step. A gated
+        // window has no mic magnitudes to clean (or to learn coupling from).
+        bool haveRef = referenceActive && referenceStream.readMagnitudes(ref);
+        if (haveRef && !mags.gated) {
+            loopbackCanceller.process(mags, ref);
+        }
+        if (goertzelMuted) {
+            // Discard — DAC→ADC loopback would cause false detections
+            stats.mutedWindows++;
+            continue;
+        }
+        stats.evaluations++;
+        evaluateMagnitudes(mags);
+    }
+#if GOERTZEL_ENERGY_GATE
+    // Calibration measures whatever is there, so it sees every hop
+    stream.setGateMagnitude(calibrating ? 0 : presenceGateMagnitude());
+#endif
+}
 
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
 
-void initGoertzelDecoder(GoertzelStream &goertzel, StreamCopy &copier, bool startTask)
+bool goertzelGeometryValid(float windowMs, float hopMs)
+{
+    int hopSize, chunkCount;
+    return DtmfGoertzelStream::geometry(AUDIO_INFO_DEFAULT().sample_rate / (float)GOERTZEL_DECIMATION,
+                                        windowMs, hopMs, hopSize, chunkCount);
+}
+
+bool initGoertzelDecoder(DtmfGoertzelStream &goertzel, StreamCopy &copier, bool startTask)
 {
     const PhoneConfig& config = getPhoneConfig();
     
-    // Register all 4 DTMF row frequencies
-    goertzel.addFrequency(config.rowFreqs[0], &rowRefs[0]);
-    goertzel.addFrequency(config.rowFreqs[1], &rowRefs[1]);
-    goertzel.addFrequency(config.rowFreqs[2], &rowRefs[2]);
-    goertzel.addFrequency(config.rowFreqs[3], &rowRefs[3]);
-    
-    // Register all 4 DTMF column frequencies (including 1633 Hz for 'D' key)
-    goertzel.addFrequency(config.colFreqs[0], &colRefs[0]);
-    goertzel.addFrequency(config.colFreqs[1], &colRefs[1]);
-    goertzel.addFrequency(config.colFreqs[2], &colRefs[2]);
-    goertzel.addFrequency(config.colFreqs[3], &colRefs[3]);
-    
-    // Set detection callback
-    goertzel.setFrequencyDetectionCallback(onGoertzelFrequency);
+    // Precompute Q30 coefficients for all 4 rows and 4 cols (incl. 1633 Hz 'D')
+    // The mic ring (and replay/test input) is mono
+    AudioInfo info = AUDIO_INFO_DEFAULT();
+    info.channels = 1;
+    if (!goertzel.begin(info, config.rowFreqs, config.colFreqs,
+                        config.goertzelWindowMs, config.goertzelHopMs)) {
+        LOG_PRINTF(DTMF, "❌ Goertzel engine init failed (window=%.1fms hop=%.1fms)\n",
+                         config.goertzelWindowMs, config.goertzelHopMs);
+        return false;
+    }
+    goertzelStreamPtr = &goertzel;
+    evaluationMs = goertzel.hopSize() * 1000.0f / goertzel.detectorSampleRate();
+
+    // Thresholds: phone defaults unless a keypad calibration is stored.
+    // Test builds always use the phone defaults.
+    GoertzelThresholds t = defaultThresholds();
+#ifndef TEST_MODE
+    loadCalibration(t);
+#endif
+    applyThresholds(t);
+
+#if LOOPBACK_CANCEL_ENABLED
+    referenceActive = referenceStream.begin(info, config.rowFreqs, config.colFreqs,
+                                            config.goertzelWindowMs, config.goertzelHopMs);
+    loopbackCanceller.reset();
+    if (!referenceActive) {
+        Logger.println("⚠️ Loopback reference stream init failed — cancellation off");
+    }
+#endif
     
     // Create key queue (once) for thread-safe digit passing to main loop
     if (goertzelKeyQueue == nullptr) {
         goertzelKeyQueue = xQueueCreate(GOERTZEL_KEY_QUEUE_SIZE, sizeof(char));
     }
     
-    // Configure Goertzel parameters
-    auto cfg = goertzel.defaultConfig();
-    cfg.setAudioInfo(AUDIO_INFO_DEFAULT());
-    cfg.threshold = config.fundamentalMagnitudeThreshold;
-    cfg.block_size = config.goertzelBlockSize;
-    goertzel.begin(cfg);
-    
     // Size copier buffer to match block size for efficient transfer
     copier.resize(config.goertzelCopierBufferSize);
     
-    Logger.printf("🎵 Goertzel DTMF decoder initialized for %s\n", config.name);
-    Logger.printf("   Rows: %.0f, %.0f, %.0f, %.0f Hz\n", 
-                  config.rowFreqs[0], config.rowFreqs[1], config.rowFreqs[2], config.rowFreqs[3]);
-    Logger.printf("   Cols: %.0f, %.0f, %.0f, %.0f Hz\n",
-                  config.colFreqs[0], config.colFreqs[1], config.colFreqs[2], config.colFreqs[3]);
-    Logger.printf("   Block=%d samples (%.1fms), thresh=%.1f, floor=%.1f, consecutive=%d, twist<%.0f\n",
-                  config.goertzelBlockSize,
-                  config.goertzelBlockSize * 1000.0f / AUDIO_SAMPLE_RATE,
-                  config.fundamentalMagnitudeThreshold,
-                  config.minDetectionMagnitude,
-                  config.requiredConsecutive,
-                  config.maxTwistRatio);
+    LOG_PRINTF(DTMF, "🎵 Goertzel DTMF decoder initialized for %s\n", config.name);
+    LOG_PRINTF(DTMF, "   Rows: %.0f, %.0f, %.0f, %.0f Hz\n", 
+                     config.rowFreqs[0], config.rowFreqs[1], config.rowFreqs[2], config.rowFreqs[3]);
+    LOG_PRINTF(DTMF, "   Cols: %.0f, %.0f, %.0f, %.0f Hz\n",
+                     config.colFreqs[0], config.colFreqs[1], config.colFreqs[2], config.colFreqs[3]);
+    LOG_PRINTF(DTMF, "   Detector %.0fHz (÷%d): window=%d samples (%.1fms), hop=%d (%.1fms)\n",
+                     goertzel.detectorSampleRate(),
+                     goertzel.decimation(),
+                     goertzel.windowSize(),
+                     goertzel.windowSize() * 1000.0f / goertzel.detectorSampleRate(),
+                     goertzel.hopSize(),
+                     goertzel.hopSize() * 1000.0f / goertzel.detectorSampleRate());
+    LOG_PRINTF(DTMF, "   presence=%.1fdB/%.1f, detection=%.1fdB/%.1f, consecutive=%d, twist<%.1f%s\n",
+                     thresholds.presenceSnrDb,
+                     thresholds.minPresenceMagnitude,
+                     thresholds.detectionSnrDb,
+                     thresholds.minDetectionMagnitude,
+                     config.requiredConsecutive,
+                     thresholds.maxTwistRatio,
+                     thresholds.calibrated ? " (calibrated)" : "");
     if (startTask) {
         startGoertzelTask(copier);
     }
+    return true;
 }
 
 // ============================================================================
@@ -296,15 +584,17 @@ char getGoertzelKey() {
 }
 
 void processGoertzelBlock() {
-    evaluateBlock();
+    if (goertzelStreamPtr != nullptr) {
+        evaluateBlock(*goertzelStreamPtr);
+    }
 }
 
 void resetGoertzelState() {
-    for (int i = 0; i < 4; i++) {
-        blockRowMags[i] = 0;
-        blockColMags[i] = 0;
+    if (goertzelStreamPtr != nullptr) {
+        goertzelStreamPtr->reset();
     }
-    blockDataReady = false;
+    // Coupling is a property of the hardware, so it survives resets
+    referenceStream.reset();
     candidateDigit = 0;
     consecutiveHits = 0;
     consecutiveMisses = 0;
@@ -315,13 +605,13 @@ void resetGoertzelState() {
 }
 
 #ifdef TEST_MODE
-void processGoertzelSamplesForTest(GoertzelStream &goertzel, const int16_t* samples, size_t sampleCount) {
+void processGoertzelSamplesForTest(DtmfGoertzelStream &goertzel, const int16_t* samples, size_t sampleCount) {
     if (samples == nullptr || sampleCount == 0) {
         return;
     }
 
     goertzel.write(reinterpret_cast<const uint8_t*>(samples), sampleCount * sizeof(int16_t));
-    evaluateBlock();
+    evaluateBlock(goertzel);
 }
 #endif
 
@@ -333,31 +623,119 @@ static TaskHandle_t goertzelTaskHandle = nullptr;
 static StreamCopy* goertzelCopierPtr = nullptr;
 static volatile bool goertzelTaskShouldRun = false;
 static volatile bool goertzelTaskStarted = false;  // true once task loop begins
+static volatile bool goertzelPaused = false;
+
+// Task counters — written only by the Goertzel task, read from any core
+static GoertzelTaskStats taskStats = {};
+
+MicRingReader& getGoertzelMicReader() {
+    static MicRingReader reader(getMicRing());
+    return reader;
+}
+
+// Feed the reference stream as many samples as the mic copy just delivered,
+// taken LOOPBACK_REF_DELAY_MS behind the newest played sample. Missing
+// reference (player idle or not yet started) is fed as silence.
+static void feedLoopbackReference(size_t micBytes) {
+    if (!referenceActive) {
+        return;
+    }
+    static MicRingReader reader(getLoopbackReferenceRing());
+    static const uint32_t DELAY_SAMPLES = (uint32_t)LOOPBACK_REF_DELAY_MS * AUDIO_SAMPLE_RATE / 1000;
+    const int32_t tolerance = referenceStream.inputHopSamples();
+
+    uint32_t need = micBytes / sizeof(int16_t);
+    uint32_t target = getLoopbackReferenceRing().writeIndex() - DELAY_SAMPLES;
+
+    // Hold the cursor a fixed delay behind the writer; resync after idle
+    int32_t drift = (int32_t)(target - need - reader.position());
+    if (drift > tolerance || drift < -tolerance) {
+        reader.seek(target - need);
+    }
+
+    int16_t chunk[256];
+    while (need > 0) {
+        uint32_t n = need < 256 ? need : 256;
+        int32_t ready = (int32_t)(target - reader.position());
+        uint32_t got = 0;
+        if (ready > 0) {
+            got = reader.readSamples(chunk, n < (uint32_t)ready ? n : (uint32_t)ready);
+        }
+        if (got < n) {
+            memset(chunk + got, 0, (n - got) * sizeof(int16_t));
+        }
+        referenceStream.write(reinterpret_cast<const uint8_t*>(chunk), n * sizeof(int16_t));
+        need -= n;
+    }
+}
 
 // Goertzel task — runs on core 0 to avoid blocking audio on core 1
-// Each iteration: copy audio → GoertzelStream fires callbacks → evaluate
+// Each wake: drain the mic ring → engine runs on each full hop → evaluate
 void goertzelTaskFunction(void* parameter) {
     StreamCopy* copier = (StreamCopy*)parameter;
+    MicRingReader& reader = getGoertzelMicReader();
     
     // Wait for system to stabilize (WiFi init on core 0 uses significant
     // interrupt stack; launching Goertzel immediately causes stack canary trips)
     vTaskDelay(pdMS_TO_TICKS(3000));
     
+    // Start at live audio; the ring kept filling during the delay
+    reader.seekToLive();
+    const uint32_t lostBase = reader.lostSamples();
+    const uint32_t overrunBase = reader.overruns();
+    taskStats = {};
+#if GOERTZEL_EVENT_DRIVEN
+    getMicRing().subscribe(xTaskGetCurrentTaskHandle());
+#endif
     goertzelTaskStarted = true;
-    Logger.println("🎵 Goertzel task started on core 0");
+    LOG_PRINTF(DTMF, "🎵 Goertzel task started on core 0 (%s)\n",
+                     GOERTZEL_EVENT_DRIVEN ? "frame-driven" : "polling");
     
     while (goertzelTaskShouldRun) {
-        // Copy audio data from mic to Goertzel decoder
-        // This triggers Goertzel computation and callbacks when a block is ready
-        copier->copy();
+        if (goertzelPaused) {
+            // Nothing is captured while paused; setGoertzelPaused(false) wakes us
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+            if (!goertzelPaused) {
+                reader.seekToLive();
+                resetGoertzelState();
+            }
+            continue;
+        }
+#if GOERTZEL_EVENT_DRIVEN
+        // Sleep until the mic capture task publishes a DMA frame. The
+        // timeout only bounds how long a stop request waits.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+#endif
+        taskStats.wakeups++;
+
+        // Drain what was published (normally one frame). Checking available()
+        // first keeps copy() from taking its no-data delay.
+        while (reader.available() > 0) {
+            size_t bytes = copier->copy();
+            if (bytes == 0) break;
+            taskStats.frames++;
+            feedLoopbackReference(bytes);
+        }
         
-        // Evaluate accumulated block data (if a block completed during copy)
-        evaluateBlock();
+        // Evaluate the completed windows (if any completed during copy)
+        if (goertzelStreamPtr != nullptr) {
+            evaluateBlock(*goertzelStreamPtr);
+            taskStats.droppedResults = goertzelStreamPtr->droppedBlocks();
+            taskStats.analysedHops = goertzelStreamPtr->analysedHops();
+            taskStats.gatedHops = goertzelStreamPtr->gatedHops();
+        }
+        taskStats.overruns = reader.overruns() - overrunBase;
+        taskStats.missedFrames = (reader.lostSamples() - lostBase) / (MIC_DMA_FRAME_BYTES / sizeof(int16_t));
         
+#if !GOERTZEL_EVENT_DRIVEN
         // Small yield to prevent watchdog issues
         vTaskDelay(1);
+#endif
     }
     
+#if GOERTZEL_EVENT_DRIVEN
+    getMicRing().unsubscribe(xTaskGetCurrentTaskHandle());
+#endif
     Logger.println("🎵 Goertzel task stopped");
     goertzelTaskStarted = false;
     goertzelTaskHandle = nullptr;
@@ -410,10 +788,18 @@ bool isGoertzelTaskRunning() {
     return goertzelTaskHandle != nullptr && goertzelTaskShouldRun;
 }
 
+bool isGoertzelDetecting() {
+    return goertzelTaskStarted;
+}
+
+GoertzelTaskStats getGoertzelTaskStats() {
+    return taskStats;
+}
+
 void setGoertzelMuted(bool muted) {
     if (goertzelMuted != muted) {
         goertzelMuted = muted;
-        Logger.printf("🎵 Goertzel %s\n", muted ? "MUTED (playback active)" : "UNMUTED (listening)");
+        LOG_PRINTF(DTMF, "🎵 Goertzel %s\n", muted ? "MUTED (playback active)" : "UNMUTED (listening)");
         if (muted) {
             resetGoertzelState();
         }
@@ -423,3 +809,155 @@ void setGoertzelMuted(bool muted) {
 bool isGoertzelMuted() {
     return goertzelMuted;
 }
+
+void setGoertzelPaused(bool paused) {
+    if (goertzelPaused == paused) {
+        return;
+    }
+    goertzelPaused = paused;
+    LOG_PRINTF(DTMF, "🎵 Goertzel %s\n", paused ? "paused" : "resumed");
+    if (!paused && goertzelTaskHandle != nullptr) {
+        xTaskNotifyGive(goertzelTaskHandle);
+    }
+}
+
+bool isGoertzelPaused() {
+    return goertzelPaused;
+}
+
+GoertzelThresholds getGoertzelThresholds() {
+    return thresholds;
+}
+
+float getGoertzelNoiseFloor(int bin) {
+    return (bin >= 0 && bin < 8) ? noiseFloor.floor(bin) : 0;
+}
+
+GoertzelDetectorStats getGoertzelDetectorStats() {
+    return stats;
+}
+
+void resetGoertzelDetectorStats() {
+    statsResetRequested = true;
+}
+
+void reloadGoertzelThresholds() {
+    // NVS is read here, not on the Goertzel task
+    GoertzelThresholds t = defaultThresholds();
+#ifndef TEST_MODE
+    loadCalibration(t);
+#endif
+    pendingThresholds = t;
+    thresholdsReloadRequested = true;
+}
+
+static void appendJsonArray(String& json, const char* name, const uint32_t* values, int count) {
+    json += "\"";
+    json += name;
+    json += "\":[";
+    for (int i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += String(values[i]);
+    }
+    json += "]";
+}
+
+String getGoertzelStatsJson() {
+    GoertzelDetectorStats s = getGoertzelDetectorStats();
+    GoertzelTaskStats t = getGoertzelTaskStats();
+    uint32_t emitted = 0;
+    for (int i = 0; i < 16; i++) emitted += s.detections[i];
+
+    String json = "{";
+    json += "\"evaluations\":" + String(s.evaluations) + ",";
+    json += "\"muted\":" + String(s.mutedWindows) + ",";
+    json += "\"silent\":" + String(s.silentWindows) + ",";
+    json += "\"gated\":" + String(s.gatedWindows) + ",";
+    json += "\"emitted\":" + String(emitted) + ",";
+    json += "\"detections\":{";
+    bool first = true;
+    for (int i = 0; i < 16; i++) {
+        if (s.detections[i] == 0) continue;
+        if (!first) json += ",";
+        json += "\"" + String(GOERTZEL_DTMF_KEYPAD[i / 4][i % 4]) + "\":" + String(s.detections[i]);
+        first = false;
+    }
+    json += "},";
+    json += "\"rejects\":{";
+    json += "\"partial\":" + String(s.rejectPartial) + ",";
+    json += "\"floor\":" + String(s.rejectFloor) + ",";
+    json += "\"twist\":" + String(s.rejectTwist) + ",";
+    json += "\"harmonic\":" + String(s.rejectHarmonic) + ",";
+    json += "\"energy\":" + String(s.rejectEnergy);
+    json += "},";
+    json += "\"queue_drops\":" + String(s.queueDrops) + ",";
+    appendJsonArray(json, "emit_magnitude", s.emitMagnitude, GOERTZEL_HISTOGRAM_BUCKETS);
+    json += ",";
+    appendJsonArray(json, "reject_magnitude", s.rejectMagnitude, GOERTZEL_HISTOGRAM_BUCKETS);
+    json += ",";
+    appendJsonArray(json, "latency", s.latency, GOERTZEL_HISTOGRAM_BUCKETS);
+    json += ",";
+    json += "\"latency_bucket_ms\":" + String(GOERTZEL_LATENCY_BUCKET_MS) + ",";
+    json += "\"latency_min_ms\":" + String(s.latencyMinMs) + ",";
+    json += "\"latency_max_ms\":" + String(s.latencyMaxMs) + ",";
+    json += "\"latency_mean_ms\":" + String(emitted ? s.latencyTotalMs / emitted : 0) + ",";
+    json += "\"task\":{";
+    json += "\"wakeups\":" + String(t.wakeups) + ",";
+    json += "\"frames\":" + String(t.frames) + ",";
+    json += "\"overruns\":" + String(t.overruns) + ",";
+    json += "\"missed_frames\":" + String(t.missedFrames) + ",";
+    json += "\"dropped_results\":" + String(t.droppedResults) + ",";
+    json += "\"analysed_hops\":" + String(t.analysedHops) + ",";
+    json += "\"gated_hops\":" + String(t.gatedHops);
+    json += "}";
+    json += "}";
+    return json;
+}
+
+void printGoertzelStats() {
+    GoertzelDetectorStats s = getGoertzelDetectorStats();
+    GoertzelTaskStats t = getGoertzelTaskStats();
+    uint32_t emitted = 0;
+    for (int i = 0; i < 16; i++) emitted += s.detections[i];
+
+    Logger.println("🎵 Goertzel detector stats:");
+    Logger.printf("   Windows: %u evaluated, %u silent, %u gated, %u muted\n",
+                  s.evaluations, s.silentWindows, s.gatedWindows, s.mutedWindows);
+    Logger.printf("   Emitted: %u (queue drops %u)", emitted, s.queueDrops);
+    for (int i = 0; i < 16; i++) {
+        if (s.detections[i] > 0) {
+            Logger.printf(" %c=%u", GOERTZEL_DTMF_KEYPAD[i / 4][i % 4], s.detections[i]);
+        }
+    }
+    Logger.println();
+    Logger.printf("   Rejects: partial=%u floor=%u twist=%u harmonic=%u energy=%u\n",
+                  s.rejectPartial, s.rejectFloor, s.rejectTwist, s.rejectHarmonic, s.rejectEnergy);
+    Logger.print("   Magnitude (<16 ... >=1024) emit:");
+    for (int i = 0; i < GOERTZEL_HISTOGRAM_BUCKETS; i++) Logger.printf(" %u", s.emitMagnitude[i]);
+    Logger.print("  reject:");
+    for (int i = 0; i < GOERTZEL_HISTOGRAM_BUCKETS; i++) Logger.printf(" %u", s.rejectMagnitude[i]);
+    Logger.println();
+    Logger.printf("   Latency (%dms buckets):", GOERTZEL_LATENCY_BUCKET_MS);
+    for (int i = 0; i < GOERTZEL_HISTOGRAM_BUCKETS; i++) Logger.printf(" %u", s.latency[i]);
+    Logger.printf("  min/mean/max=%u/%u/%ums\n",
+                  s.latencyMinMs, emitted ? s.latencyTotalMs / emitted : 0, s.latencyMaxMs);
+    Logger.printf("   Task: %u wakeups, %u frames, %u overruns, %u missed frames, %u dropped results\n",
+                  t.wakeups, t.frames, t.overruns, t.missedFrames, t.droppedResults);
+    uint32_t hops = t.analysedHops + t.gatedHops;
+    Logger.printf("   Energy gate: bank ran on %u of %u hops (%u%% skipped)\n",
+                  t.analysedHops, hops, hops ? t.gatedHops * 100 / hops : 0);
+}
+
+void startGoertzelCalibration() {
+    calibrationStartRequested = true;
+}
+
+bool isGoertzelCalibrating() {
+    return calibrating || calibrationStartRequested;
+}
+
+void clearGoertzelCalibration() {
+    eraseCalibration();
+    calibrationClearRequested = true;
+    Logger.println("🗑️ DTMF calibration cleared — using phone defaults");
+}
@@ -0,0 +1,651 @@
+#include "dtmf_goertzel_engine.h"
+#include <math.h>
+#include "esp_heap_caps.h"
+#if GOERTZEL_USE_ESP_DSP
+  #if __has_include("esp_dsp.h")
+    #include "esp_dsp.h"
+  #else
+    #error "GOERTZEL_USE_ESP_DSP=1 requires the esp-dsp component (esp_dsp.h)"
+  #endif
+#endif
+
+// ============================================================================
+// DTMF GOERTZEL ENGINE
+//
+// Fixed-point kernel: one pass over the block, 8 (16 with harmonics) int32
+// state pairs, Q30 coefficients, plus Σx and an int64 Σx² for the block's
+// AC energy. The int64 product is needed because c ≈ 2.0 and on-bin
+// states reach ~1e8–1e9; Xtensa does this as a single mull/mulsh pair.
+//
+// Output (once per block per bin):
+//   y = s1 − e^(−iω)·s2 = e^(iω(N−1))·X(ω)
+// so |X| = |y| and X is recovered with one complex multiply by e^(−iω(N−1)).
+// ============================================================================
+
+static const float INT16_FULL_SCALE = 32768.0f;
+static const float TWO_PI_F = 6.28318530718f;
+
+bool DtmfGoertzelEngine::begin(const float rowFreqs[4], const float colFreqs[4],
+                               float sampleRate, int blockSize)
+{
+    end();
+    if (sampleRate <= 0 || blockSize <= 0 || blockSize > GOERTZEL_ENGINE_MAX_BLOCK) {
+        return false;
+    }
+
+    _sampleRate = sampleRate;
+    _blockSize = blockSize;
+
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        float freq = dtmfBinFrequency(rowFreqs, colFreqs, bin);
+        float omega = TWO_PI_F * freq / sampleRate;
+        _omega[bin] = omega;
+        _cos[bin] = cosf(omega);
+        _sin[bin] = sinf(omega);
+        _endRe[bin] = cosf(omega * (blockSize - 1));
+        _endIm[bin] = -sinf(omega * (blockSize - 1));
+        // 2·cos(ω) < 2.0 for any f > 0, so it fits Q30 in an int32
+        _coeffQ30[bin] = (int32_t)lrint(2.0 * cos((double)omega) * (double)(1 << 30));
+    }
+
+#if GOERTZEL_USE_ESP_DSP
+    // Correlation basis: for each bin a cos table then a sin table, N floats each
+    size_t basisCount = (size_t)(2 * GOERTZEL_BIN_COUNT) * blockSize;
+    _basis = (float*)heap_caps_malloc(basisCount * sizeof(float), MALLOC_CAP_SPIRAM);
+    _scratch = (float*)heap_caps_malloc(blockSize * sizeof(float), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!_basis || !_scratch) {
+        end();
+        return false;
+    }
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        float omega = _omega[bin];
+        float* cosTable = _basis + (size_t)(bin * 2) * blockSize;
+        float* sinTable = cosTable + blockSize;
+        for (int n = 0; n < blockSize; n++) {
+            cosTable[n] = cosf(omega * n);
+            sinTable[n] = sinf(omega * n);
+        }
+    }
+#endif
+    return true;
+}
+
+void DtmfGoertzelEngine::end()
+{
+#if GOERTZEL_USE_ESP_DSP
+    if (_basis) { heap_caps_free(_basis); _basis = nullptr; }
+    if (_scratch) { heap_caps_free(_scratch); _scratch = nullptr; }
+#endif
+    _blockSize = 0;
+}
+
+void DtmfGoertzelEngine::process(const int16_t* samples, DtmfBandMagnitudes& out)
+{
+    DtmfBinSpectrum spectrum;
+    analyze(samples, spectrum);
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        dtmfBinMagnitude(out, bin) = sqrtf(spectrum.re[bin] * spectrum.re[bin] +
+                                           spectrum.im[bin] * spectrum.im[bin]);
+    }
+    out.total = sqrtf(spectrum.energy * _blockSize / 2.0f);
+}
+
+#if GOERTZEL_USE_ESP_DSP
+
+void DtmfGoertzelEngine::analyze(const int16_t* samples, DtmfBinSpectrum& out)
+{
+    const int n = _blockSize;
+    for (int i = 0; i < n; i++) {
+        _scratch[i] = samples[i] / INT16_FULL_SCALE;
+    }
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        const float* cosTable = _basis + (size_t)(bin * 2) * n;
+        const float* sinTable = cosTable + n;
+        float c = 0, sn = 0;
+        dsps_dotprod_f32(_scratch, cosTable, &c, n);
+        dsps_dotprod_f32(_scratch, sinTable, &sn, n);
+        out.re[bin] = c;
+        out.im[bin] = -sn;
+    }
+    float energy = 0, sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += _scratch[i];
+    }
+    dsps_dotprod_f32(_scratch, _scratch, &energy, n);
+    // AC energy: a codec DC offset would otherwise count as out-of-band power
+    float ac = energy - sum * sum / n;
+    out.energy = ac > 0 ? ac : 0;
+}
+
+#else
+
+// One recurrence step for bin i. Kept as a macro so the bins unroll into
+// straight-line code with the states in registers.
+#define GOERTZEL_STEP(i) do { \
+        int32_t s0 = x + (int32_t)(((int64_t)c##i * s1_##i) >> 30) - s2_##i; \
+        s2_##i = s1_##i; \
+        s1_##i = s0; \
+    } while (0)
+
+void DtmfGoertzelEngine::analyze(const int16_t* samples, DtmfBinSpectrum& out)
+{
+    const int32_t c0 = _coeffQ30[0], c1 = _coeffQ30[1], c2 = _coeffQ30[2], c3 = _coeffQ30[3];
+    const int32_t c4 = _coeffQ30[4], c5 = _coeffQ30[5], c6 = _coeffQ30[6], c7 = _coeffQ30[7];
+    int32_t s1_0 = 0, s2_0 = 0, s1_1 = 0, s2_1 = 0, s1_2 = 0, s2_2 = 0, s1_3 = 0, s2_3 = 0;
+    int32_t s1_4 = 0, s2_4 = 0, s1_5 = 0, s2_5 = 0, s1_6 = 0, s2_6 = 0, s1_7 = 0, s2_7 = 0;
+#if GOERTZEL_HARMONIC_BINS
+    const int32_t c8 = _coeffQ30[8], c9 = _coeffQ30[9], c10 = _coeffQ30[10], c11 = _coeffQ30[11];
+    const int32_t c12 = _coeffQ30[12], c13 = _coeffQ30[13], c14 = _coeffQ30[14], c15 = _coeffQ30[15];
+    int32_t s1_8 = 0, s2_8 = 0, s1_9 = 0, s2_9 = 0, s1_10 = 0, s2_10 = 0, s1_11 = 0, s2_11 = 0;
+    int32_t s1_12 = 0, s2_12 = 0, s1_13 = 0, s2_13 = 0, s1_14 = 0, s2_14 = 0, s1_15 = 0, s2_15 = 0;
+#endif
+    int64_t energy = 0;
+    int32_t sum = 0;
+
+    const int n = _blockSize;
+    for (int k = 0; k < n; k++) {
+        const int32_t x = samples[k];
+        energy += x * x;
+        sum += x;
+        GOERTZEL_STEP(0); GOERTZEL_STEP(1); GOERTZEL_STEP(2); GOERTZEL_STEP(3);
+        GOERTZEL_STEP(4); GOERTZEL_STEP(5); GOERTZEL_STEP(6); GOERTZEL_STEP(7);
+#if GOERTZEL_HARMONIC_BINS
+        GOERTZEL_STEP(8); GOERTZEL_STEP(9); GOERTZEL_STEP(10); GOERTZEL_STEP(11);
+        GOERTZEL_STEP(12); GOERTZEL_STEP(13); GOERTZEL_STEP(14); GOERTZEL_STEP(15);
+#endif
+    }
+
+#if GOERTZEL_HARMONIC_BINS
+    const int32_t s1[GOERTZEL_BIN_COUNT] = {s1_0, s1_1, s1_2, s1_3, s1_4, s1_5, s1_6, s1_7,
+                                            s1_8, s1_9, s1_10, s1_11, s1_12, s1_13, s1_14, s1_15};
+    const int32_t s2[GOERTZEL_BIN_COUNT] = {s2_0, s2_1, s2_2, s2_3, s2_4, s2_5, s2_6, s2_7,
+                                            s2_8, s2_9, s2_10, s2_11, s2_12, s2_13, s2_14, s2_15};
+#else
+    const int32_t s1[GOERTZEL_BIN_COUNT] = {s1_0, s1_1, s1_2, s1_3, s1_4, s1_5, s1_6, s1_7};
+    const int32_t s2[GOERTZEL_BIN_COUNT] = {s2_0, s2_1, s2_2, s2_3, s2_4, s2_5, s2_6, s2_7};
+#endif
+    // AC energy: a codec DC offset would otherwise count as out-of-band power
+    float ac = (float)energy - (float)sum * (float)sum / n;
+    out.energy = (ac > 0 ? ac : 0) / (INT16_FULL_SCALE * INT16_FULL_SCALE);
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        float yRe = ((float)s1[bin] - (float)s2[bin] * _cos[bin]) / INT16_FULL_SCALE;
+        float yIm = ((float)s2[bin] * _sin[bin]) / INT16_FULL_SCALE;
+        out.re[bin] = yRe * _endRe[bin] - yIm * _endIm[bin];
+        out.im[bin] = yRe * _endIm[bin] + yIm * _endRe[bin];
+    }
+}
+
+#undef GOERTZEL_STEP
+
+#endif // GOERTZEL_USE_ESP_DSP
+
+// ============================================================================
+// DTMF DECIMATOR — anti-alias FIR, evaluated only on kept samples
+// ============================================================================
+
+bool DtmfDecimator::begin(int factor, int taps, float cutoffHz, float sampleRate)
+{
+    end();
+    if (factor < 1 || sampleRate <= 0) {
+        return false;
+    }
+    _factor = factor;
+    _sampleRate = sampleRate;
+    if (factor == 1) {
+        return true;    // Pass-through, no filter needed
+    }
+    if (taps < factor || cutoffHz <= 0 || cutoffHz >= sampleRate / (2.0f * factor)) {
+        return false;
+    }
+
+    _coeffs = (int16_t*)heap_caps_malloc(taps * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    _history = (int16_t*)heap_caps_malloc(2 * taps * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    float* design = (float*)malloc(taps * sizeof(float));
+    if (!_coeffs || !_history || !design) {
+        free(design);
+        end();
+        return false;
+    }
+    _taps = taps;
+
+    // Hamming-windowed sinc, then normalized to unity DC gain
+    const float fc = cutoffHz / sampleRate;
+    const float mid = (taps - 1) / 2.0f;
+    float sum = 0;
+    for (int k = 0; k < taps; k++) {
+        float t = k - mid;
+        float sinc = (t == 0) ? 2.0f * fc : sinf(TWO_PI_F * fc * t) / (3.14159265359f * t);
+        float window = 0.54f - 0.46f * cosf(TWO_PI_F * k / (taps - 1));
+        design[k] = sinc * window;
+        sum += design[k];
+    }
+    for (int k = 0; k < taps; k++) {
+        _coeffs[k] = (int16_t)lrintf(design[k] / sum * 32767.0f);
+    }
+    free(design);
+    reset();
+    return true;
+}
+
+void DtmfDecimator::end()
+{
+    if (_coeffs) { heap_caps_free(_coeffs); _coeffs = nullptr; }
+    if (_history) { heap_caps_free(_history); _history = nullptr; }
+    _taps = 0;
+    _factor = 1;
+}
+
+void DtmfDecimator::reset()
+{
+    if (_history) {
+        memset(_history, 0, 2 * _taps * sizeof(int16_t));
+    }
+    _pos = 0;
+    _phase = 0;
+}
+
+bool DtmfDecimator::push(int16_t x, int16_t& out)
+{
+    if (_factor == 1) {
+        out = x;
+        return true;
+    }
+
+    // Write twice so the newest _taps samples are always contiguous
+    _history[_pos] = x;
+    _history[_pos + _taps] = x;
+    if (++_pos >= _taps) _pos = 0;
+
+    if (++_phase < _factor) {
+        return false;
+    }
+    _phase = 0;
+
+    // Σ|h| stays just above 1.0 in Q15, so the int32 sum cannot overflow
+    const int16_t* h = _history + _pos;    // oldest → newest
+    int32_t acc = 0;
+    for (int k = 0; k < _taps; k++) {
+        acc += (int32_t)_coeffs[k] * h[k];
+    }
+    acc >>= 15;
+    if (acc > 32767) acc = 32767;
+    if (acc < -32768) acc = -32768;
+    out = (int16_t)acc;
+    return true;
+}
+
+float DtmfDecimator::gainAt(float freqHz) const
+{
+    if (_factor == 1 || _taps == 0) {
+        return 1.0f;
+    }
+    const float w = TWO_PI_F * freqHz / _sampleRate;
+    float re = 0, im = 0;
+    for (int k = 0; k < _taps; k++) {
+        float c = _coeffs[k] / 32767.0f;
+        re += c * cosf(w * k);
+        im -= c * sinf(w * k);
+    }
+    return sqrtf(re * re + im * im);
+}
+
+// ============================================================================
+// DTMF GOERTZEL STREAM — decimation and block framing for StreamCopy
+// ============================================================================
+
+bool DtmfGoertzelStream::geometry(float detectorRate, float windowMs, float hopMs,
+                                  int& hopSize, int& chunkCount)
+{
+    if (windowMs <= 0) return false;
+    // Hop in samples at the detector rate; the window is a whole number of hops
+    if (hopMs <= 0 || hopMs >= windowMs) {
+        hopMs = windowMs;
+    }
+    hopSize = (int)lrintf(hopMs * detectorRate / 1000.0f);
+    chunkCount = (int)lrintf(windowMs / hopMs);
+    return hopSize > 0 && chunkCount > 0 && chunkCount <= MAX_CHUNKS;
+}
+
+bool DtmfGoertzelStream::begin(AudioInfo info, const float rowFreqs[4],
+                               const float colFreqs[4], float windowMs, float hopMs)
+{
+    end();
+    setAudioInfo(info);
+    if (info.bits_per_sample != 16 || info.sample_rate <= 0 || windowMs <= 0) {
+        return false;
+    }
+    if (!_decimator.begin(GOERTZEL_DECIMATION, GOERTZEL_DECIMATOR_TAPS,
+                          GOERTZEL_DECIMATOR_CUTOFF_HZ, (float)info.sample_rate)) {
+        return false;
+    }
+    const float detectorRate = (float)info.sample_rate / _decimator.factor();
+
+    int hopSize, chunkCount;
+    if (!geometry(detectorRate, windowMs, hopMs, hopSize, chunkCount)) {
+        end();
+        return false;
+    }
+    if (!_engine.begin(rowFreqs, colFreqs, detectorRate, hopSize)) {
+        end();
+        return false;
+    }
+    _chunkCount = chunkCount;
+    _block = (int16_t*)heap_caps_malloc(hopSize * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    _prevBlock = (int16_t*)heap_caps_malloc(hopSize * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    _chunks = (DtmfBinSpectrum*)heap_caps_malloc(_chunkCount * sizeof(DtmfBinSpectrum),
+                                                 MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!_block || !_prevBlock || !_chunks) {
+        end();
+        return false;
+    }
+    _hopSize = hopSize;
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        float w = _engine.omega(bin);
+        _stepRe[bin] = cosf(w * hopSize);
+        _stepIm[bin] = -sinf(w * hopSize);
+        // |X| grows with N, and N shrank by the decimation factor. The upper
+        // harmonics sit in the FIR's transition band; cap the boost there.
+        float gain = _decimator.gainAt(dtmfBinFrequency(rowFreqs, colFreqs, bin));
+        if (gain < 0.1f) gain = 0.1f;
+        _binScale[bin] = _decimator.factor() / gain;
+    }
+    _channels = info.channels > 0 ? info.channels : 1;
+    reset();
+    _droppedBlocks = 0;
+    _analysedHops = 0;
+    _gatedHops = 0;
+    return AudioOutput::begin();
+}
+
+void DtmfGoertzelStream::end()
+{
+    if (_block) {
+        heap_caps_free(_block);
+        _block = nullptr;
+    }
+    if (_prevBlock) {
+        heap_caps_free(_prevBlock);
+        _prevBlock = nullptr;
+    }
+    if (_chunks) {
+        heap_caps_free(_chunks);
+        _chunks = nullptr;
+    }
+    _engine.end();
+    _decimator.end();
+    _hopSize = 0;
+    _chunkCount = 0;
+    AudioOutput::end();
+}
+
+size_t DtmfGoertzelStream::write(const uint8_t* data, size_t len)
+{
+    if (!_block || data == nullptr) {
+        return len;
+    }
+
+    size_t i = 0;
+    while (i < len) {
+        int16_t sample;
+        if (_hasPendingByte) {
+            sample = (int16_t)(_pendingByte | (data[i] << 8));
+            _hasPendingByte = false;
+            i++;
+        } else if (i + 1 < len) {
+            sample = (int16_t)(data[i] | (data[i + 1] << 8));
+            i += 2;
+        } else {
+            _pendingByte = data[i];
+            _hasPendingByte = true;
+            break;
+        }
+
+        // Only the first channel of each interleaved frame is analysed
+        bool take = (_channelIndex == 0);
+        if (++_channelIndex >= _channels) _channelIndex = 0;
+        if (!take) continue;
+
+        int16_t decimated;
+        if (!_decimator.push(sample, decimated)) continue;
+
+        _block[_fill++] = decimated;
+        if (_fill >= _hopSize) {
+            completeHop();
+            _fill = 0;
+        }
+    }
+    return len;
+}
+
+// Σ(x − mean)² of a block, normalized to ±1.0 like the engine's energy
+static float blockEnergy(const int16_t* samples, int count)
+{
+    int64_t sum = 0;
+    int64_t sumSq = 0;
+    for (int n = 0; n < count; n++) {
+        int32_t x = samples[n];
+        sum += x;
+        sumSq += x * x;
+    }
+    float centered = (float)sumSq - (float)sum * (float)sum / count;
+    return centered / (32768.0f * 32768.0f);
+}
+
+void DtmfGoertzelStream::setGateMagnitude(float magnitude)
+{
+    if (magnitude <= 0 || _chunkCount == 0) {
+        _gateEnergy = 0;
+        return;
+    }
+    // Amplitude A over the window reads |X| = A·W/2 at the detector rate,
+    // scaled by the decimation factor D, and fills a hop with A²/2·(W/C)
+    float perRate = magnitude / _decimator.factor();
+    _gateEnergy = GOERTZEL_GATE_MARGIN * 2.0f * perRate * perRate
+                / ((float)windowSize() * _chunkCount);
+}
+
+// Run the bank over one hop and store it at absolute phase in @p slot
+void DtmfGoertzelStream::analyzeInto(const int16_t* samples, const float* rotRe,
+                                     const float* rotIm, DtmfBinSpectrum& slot)
+{
+    DtmfBinSpectrum hop;
+    _engine.analyze(samples, hop);
+    slot.energy = hop.energy;
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        float re = hop.re[bin], im = hop.im[bin];
+        slot.re[bin] = re * rotRe[bin] - im * rotIm[bin];
+        slot.im[bin] = re * rotIm[bin] + im * rotRe[bin];
+    }
+    _analysedHops++;
+}
+
+// Analyse the finished hop (unless the energy gate skips it), rotate it to
+// absolute phase, and emit the magnitudes of the window formed by the last
+// _chunkCount hops.
+void DtmfGoertzelStream::completeHop()
+{
+    DtmfBinSpectrum& slot = _chunks[_chunkIndex];
+    const uint32_t bit = 1u << _chunkIndex;
+    const int prevIndex = (_chunkIndex == 0 ? _chunkCount : _chunkIndex) - 1;
+    const uint32_t prevBit = 1u << prevIndex;
+
+    float hopEnergy = 0;
+    bool open = true;
+    if (_gateEnergy > 0) {
+        hopEnergy = blockEnergy(_block, _hopSize);
+        open = hopEnergy >= _gateEnergy;
+    }
+    if (open) {
+        // Gate just opened: the onset may have begun in the hop before
+        if (_chunkCount > 1 && (_gatedMask & prevBit)) {
+            analyzeInto(_prevBlock, _prevRotRe, _prevRotIm, _chunks[prevIndex]);
+            _gatedMask &= ~prevBit;
+        }
+        analyzeInto(_block, _rotRe, _rotIm, slot);
+        _gatedMask &= ~bit;
+    } else {
+        memset(slot.re, 0, sizeof(slot.re));
+        memset(slot.im, 0, sizeof(slot.im));
+        slot.energy = hopEnergy;
+        _gatedMask |= bit;
+        _gatedHops++;
+    }
+
+    // Keep this hop and its phase for a late analysis, then advance
+    // e^(−iω·start) by one hop; renormalize to stop float drift
+    int16_t* done = _block;
+    _block = _prevBlock;
+    _prevBlock = done;
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        float rr = _rotRe[bin], ri = _rotIm[bin];
+        _prevRotRe[bin] = rr;
+        _prevRotIm[bin] = ri;
+        float nr = rr * _stepRe[bin] - ri * _stepIm[bin];
+        float ni = rr * _stepIm[bin] + ri * _stepRe[bin];
+        float scale = 1.0f / sqrtf(nr * nr + ni * ni);
+        _rotRe[bin] = nr * scale;
+        _rotIm[bin] = ni * scale;
+    }
+    if (++_chunkIndex >= _chunkCount) _chunkIndex = 0;
+
+    DtmfBandMagnitudes mags = {};
+    float energy = 0;
+    for (int c = 0; c < _chunkCount; c++) {
+        energy += _chunks[c].energy;
+    }
+    const uint32_t allChunks = _chunkCount == 32 ? 0xFFFFFFFFu : (1u << _chunkCount) - 1;
+    mags.gated = (_gatedMask & allChunks) == allChunks;
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT && !mags.gated; bin++) {
+        float re = 0, im = 0;
+        for (int c = 0; c < _chunkCount; c++) {
+            re += _chunks[c].re[bin];
+            im += _chunks[c].im[bin];
+        }
+        dtmfBinMagnitude(mags, bin) = sqrtf(re * re + im * im) * _binScale[bin];
+    }
+    // A tone of amplitude A over N samples has |X| = A·N/2 and Σx² = A²·N/2,
+    // so sqrt(N·Σx²/2) is the single-tone magnitude holding all the energy
+    mags.total = sqrtf(energy * windowSize() / 2.0f) * _decimator.factor();
+
+    if (_pendingCount == GOERTZEL_PENDING_RESULTS) {
+        // Consumer fell behind — drop the oldest result
+        _pendingHead = (_pendingHead + 1) % GOERTZEL_PENDING_RESULTS;
+        _pendingCount--;
+        _droppedBlocks++;
+    }
+    _pending[(_pendingHead + _pendingCount) % GOERTZEL_PENDING_RESULTS] = mags;
+    _pendingCount++;
+}
+
+bool DtmfGoertzelStream::readMagnitudes(DtmfBandMagnitudes& out)
+{
+    if (_pendingCount == 0) {
+        return false;
+    }
+    out = _pending[_pendingHead];
+    _pendingHead = (_pendingHead + 1) % GOERTZEL_PENDING_RESULTS;
+    _pendingCount--;
+    return true;
+}
+
+void DtmfGoertzelStream::reset()
+{
+    _decimator.reset();
+    _fill = 0;
+    _channelIndex = 0;
+    _hasPendingByte = false;
+    _pendingHead = 0;
+    _pendingCount = 0;
+    _chunkIndex = 0;
+    _gatedMask = 0;
+    if (_chunks) {
+        memset(_chunks, 0, _chunkCount * sizeof(DtmfBinSpectrum));
+    }
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        _rotRe[bin] = 1.0f;
+        _rotIm[bin] = 0.0f;
+    }
+}
+
+// ============================================================================
+// DTMF LOOPBACK CANCELLER — per-bin reference subtraction
+// ============================================================================
+
+void DtmfLoopbackCanceller::reset()
+{
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        _coupling[bin] = LOOPBACK_COUPLING_INITIAL;
+    }
+}
+
+void DtmfLoopbackCanceller::process(DtmfBandMagnitudes& mic, const DtmfBandMagnitudes& ref)
+{
+    for (int bin = 0; bin < GOERTZEL_BIN_COUNT; bin++) {
+        float& m = dtmfBinMagnitude(mic, bin);
+        float r = dtmfBinMagnitude(ref, bin);
+        if (r <= LOOPBACK_REF_MIN_MAGNITUDE) {
+            continue;
+        }
+
+        float ratio = m / r;
+        if (ratio > LOOPBACK_COUPLING_MAX) ratio = LOOPBACK_COUPLING_MAX;
+        float& g = _coupling[bin];
+        g += ((ratio < g) ? LOOPBACK_COUPLING_ATTACK : LOOPBACK_COUPLING_RELEASE) * (ratio - g);
+
+        float cleaned = m - LOOPBACK_OVERSUBTRACT * g * r;
+        m = cleaned > 0 ? cleaned : 0;
+    }
+
+    // Playback energy is broadband; without a per-bin estimate the block
+    // energy can't be cleaned, so leave it unmeasured
+    if (ref.total > LOOPBACK_REF_MIN_MAGNITUDE) {
+        mic.total = 0;
+    }
+}
+
+// ============================================================================
+// DTMF NOISE FLOOR — per-bin minimum-statistics estimate
+// ============================================================================
+
+void DtmfNoiseFloor::reset()
+{
+    for (int bin = 0; bin < 8; bin++) {
+        _floor[bin] = GOERTZEL_NOISE_FLOOR_INITIAL;
+    }
+}
+
+// Falls quickly to a quieter magnitude, rises slowly to a louder one
+static inline void trackNoiseFloor(float& f, float m)
+{
+    f += ((m < f) ? GOERTZEL_NOISE_FLOOR_FALL : GOERTZEL_NOISE_FLOOR_RISE) * (m - f);
+    if (f < GOERTZEL_NOISE_FLOOR_MIN) f = GOERTZEL_NOISE_FLOOR_MIN;
+}
+
+void DtmfNoiseFloor::update(const DtmfBandMagnitudes& mags)
+{
+    // Bins 0-3 are the rows, 4-7 the columns
+    for (int i = 0; i < 4; i++) {
+        trackNoiseFloor(_floor[i], mags.row[i]);
+    }
+    for (int i = 0; i < 4; i++) {
+        trackNoiseFloor(_floor[4 + i], mags.col[i]);
+    }
+}
+
+void DtmfNoiseFloor::limit(float ceiling)
+{
+    for (int bin = 0; bin < 8; bin++) {
+        if (_floor[bin] > ceiling) {
+            trackNoiseFloor(_floor[bin], ceiling);
+        }
+    }
+}
+
+float DtmfNoiseFloor::maxFloor() const
+{
+    float maxF = _floor[0];
+    for (int bin = 1; bin < 8; bin++) {
+        if (_floor[bin] > maxF) maxF = _floor[bin];
+    }
+    return maxF;
+}
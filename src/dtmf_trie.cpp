@@ -0,0 +1,173 @@
+#include "dtmf_trie.h"
+#include <algorithm>
+
+int DtmfTrie::digitIndex(char digit)
+{
+    if (digit >= '0' && digit <= '9') return digit - '0';
+    if (digit == '*') return 10;
+    if (digit == '#') return 11;
+    if (digit >= 'A' && digit <= 'D') return 12 + (digit - 'A');
+    return -1;
+}
+
+// ============================================================================
+// BUILD
+// ============================================================================
+
+bool DtmfTrie::add(const char* sequence, uint8_t flags)
+{
+    if (!sequence || sequence[0] == '\0') {
+        return false;
+    }
+    for (const char* p = sequence; *p; p++) {
+        if (digitIndex(*p) < 0) {
+            return false;
+        }
+    }
+    staged.emplace_back(sequence, flags);
+    return true;
+}
+
+void DtmfTrie::clear()
+{
+    arena.reset();
+    nodes = nullptr;
+    nodeTotal = 0;
+    staged.clear();
+    sequences = 0;
+}
+
+bool DtmfTrie::build()
+{
+    // Digit order, not ASCII order ('*' and '#' sort after '9'), so each
+    // node's children come out in mask-bit order
+    std::sort(staged.begin(), staged.end(),
+        [](const std::pair<std::string, uint8_t>& a, const std::pair<std::string, uint8_t>& b) {
+            return std::lexicographical_compare(a.first.begin(), a.first.end(),
+                                                b.first.begin(), b.first.end(),
+                [](char x, char y) { return digitIndex(x) < digitIndex(y); });
+        });
+
+    // Built in a scratch vector, then copied to the arena at its final size
+    std::vector<TrieNode> built;
+    built.push_back({0, 0, 0});
+    sequences = 0;
+
+    // Breadth-first, so all children of a node are appended together
+    struct Span { Node node; size_t lo; size_t hi; size_t depth; };
+    std::vector<Span> work;
+    work.push_back({ROOT, 0, staged.size(), 0});
+    for (size_t w = 0; w < work.size(); w++) {
+        Span span = work[w];
+        size_t i = span.lo;
+
+        // Sequences ending here sort first in their span
+        while (i < span.hi && staged[i].first.length() == span.depth) {
+            if (built[span.node].flags == 0) sequences++;
+            built[span.node].flags |= staged[i].second;
+            i++;
+        }
+
+        while (i < span.hi) {
+            char digit = staged[i].first[span.depth];
+            size_t j = i + 1;
+            while (j < span.hi && staged[j].first[span.depth] == digit) j++;
+
+            if (built.size() >= DEAD) {
+                clear();
+                return false;
+            }
+            Node child = (Node)built.size();
+            if (built[span.node].childMask == 0) {
+                built[span.node].firstChild = child;
+            }
+            built[span.node].childMask |= (uint16_t)(1u << digitIndex(digit));
+            built.push_back({0, 0, 0});
+            work.push_back({child, i, j, span.depth + 1});
+            i = j;
+        }
+    }
+
+    staged.clear();
+    staged.shrink_to_fit();
+
+    arena.reset();
+    nodes = arena.allocArray<TrieNode>(built.size());
+    if (!nodes) {
+        nodeTotal = 0;
+        sequences = 0;
+        return false;
+    }
+    memcpy(nodes, built.data(), built.size() * sizeof(TrieNode));
+    nodeTotal = built.size();
+    return true;
+}
+
+// ============================================================================
+// LOOKUP
+// ============================================================================
+
+DtmfTrie::Node DtmfTrie::step(Node node, char digit) const
+{
+    if (node >= nodeTotal) {
+        return DEAD;
+    }
+    int d = digitIndex(digit);
+    if (d < 0) {
+        return DEAD;
+    }
+    uint16_t bit = (uint16_t)(1u << d);
+    const TrieNode& n = nodes[node];
+    if (!(n.childMask & bit)) {
+        return DEAD;
+    }
+    return (Node)(n.firstChild + __builtin_popcount(n.childMask & (bit - 1)));
+}
+
+// ============================================================================
+// ENUMERATION
+// ============================================================================
+
+static const char kDigitChars[] = "0123456789*#ABCD";
+
+size_t DtmfTrie::forEachUnder(Node node, const char* prefix, uint8_t flags,
+                              SequenceVisitor visit, void* userData) const
+{
+    size_t visited = 0;
+    size_t length = prefix ? strlen(prefix) : 0;
+    if (node >= nodeTotal || !visit || length > MAX_VISIT_LENGTH) {
+        return 0;
+    }
+    char sequence[MAX_VISIT_LENGTH + 1];
+    memcpy(sequence, prefix, length);
+    sequence[length] = '\0';
+    visitFrom(node, sequence, length, flags, visit, userData, visited);
+    return visited;
+}
+
+/// Depth-first from @p node; false once the visitor has asked to stop
+bool DtmfTrie::visitFrom(Node node, char* sequence, size_t length, uint8_t flags,
+                         SequenceVisitor visit, void* userData, size_t& visited) const
+{
+    const TrieNode& n = nodes[node];
+    if (n.flags & flags) {
+        visited++;
+        if (!visit(sequence, n.flags, userData)) {
+            return false;
+        }
+    }
+    if (length >= MAX_VISIT_LENGTH) {
+        return true;                  // Longer than any dialable sequence
+    }
+    Node child = n.firstChild;
+    for (int d = 0; d < 16; d++) {
+        if (!(n.childMask & (1u << d))) continue;
+        sequence[length] = kDigitChars[d];
+        sequence[length + 1] = '\0';
+        if (!visitFrom(child++, sequence, length + 1, flags, visit, userData, visited)) {
+            return false;
+        }
+    }
+    sequence[length] = '\0';
+    return true;
+}
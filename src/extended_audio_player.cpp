@@ -13,8 +13,12 @@
 #include "audio_playlist_registry.h"
 #endif
 #include "logging.h"
+#if AUDIO_OUTPUT_TASK_ENABLED
+#include "audio_output_task.h"
+#endif
 #include <Preferences.h>
 #include <WiFi.h>
+#include "esp_heap_caps.h"
 
 // SD card abstraction: use SD_MMC or SPI SD based on compile-time config
 #if SD_USE_MMC
@@ -62,6 +66,7 @@ ExtendedAudioSource::ExtendedAudioSource() {
 
 ExtendedAudioSource::~ExtendedAudioSource() {
     end();
+    cancelPrefetch();
     if (urlStream) {
         delete urlStream;
         urlStream = nullptr;
@@ -83,6 +88,9 @@ static const char* extensionToMime(const char* path) {
 
 const char* ExtendedAudioSource::mime() {
     if (currentType == AudioStreamType::GENERATOR) return "audio/pcm";
+#if AUDIO_PCM_CACHE_ENABLED
+    if (cachedPcm) return "audio/pcm";
+#endif
     // For file streams, prefer magic-bytes detection over extension
     if (currentType == AudioStreamType::FILE_STREAM && detectedFileMime[0] != '\0') {
         return detectedFileMime;
@@ -107,11 +115,20 @@ void ExtendedAudioSource::closeCurrentStream() {
     detectedFileMime[0] = '\0';
     switch (currentType) {
         case AudioStreamType::URL_STREAM:
+#if AUDIO_URL_JITTER_ENABLED
+            urlJitter.close();
+#endif
             if (urlStream) {
                 urlStream->end();
             }
             break;
         case AudioStreamType::FILE_STREAM:
+#if AUDIO_PCM_CACHE_ENABLED
+            finishPcmCapture();
+#endif
+#if AUDIO_FILE_READAHEAD_ENABLED
+            fileReadahead.close();
+#endif
             if (currentFile) {
                 currentFile.close();
             }
@@ -151,7 +168,7 @@ Stream* ExtendedAudioSource::selectStream(int index) {
 Stream* ExtendedAudioSource::selectStream(const char* path) {
     if (!path) return nullptr;
     
-    Logger.printf("📂 ExtendedAudioSource::selectStream(%s)\n", path);
+    LOG_PRINTF(AUDIO, "📂 ExtendedAudioSource::selectStream(%s)\n", path);
     
     // Close any existing stream
     closeCurrentStream();
@@ -163,11 +180,31 @@ Stream* ExtendedAudioSource::selectStream(const char* path) {
     }
     else if (strncmp(path, "http://", 7) == 0 || strncmp(path, "https://", 8) == 0) {
         // URL stream
-        return setURLStream(path) ? urlStream : nullptr;
+        if (!setURLStream(path)) {
+            return nullptr;
+        }
+#if AUDIO_URL_JITTER_ENABLED
+        return &urlJitter;
+#else
+        return urlStream;
+#endif
     }
     else {
         // File stream
-        return setFileStream(path) ? &currentFile : nullptr;
+        if (!setFileStream(path)) {
+            return nullptr;
+        }
+#if AUDIO_PCM_CACHE_ENABLED
+        if (useCachedPcm(path)) {
+            return &cacheStream;
+        }
+#endif
+#if AUDIO_FILE_READAHEAD_ENABLED
+        if (fileReadahead.open(currentFile)) {
+            return &fileReadahead;
+        }
+#endif
+        return &currentFile;
     }
 }
 
@@ -196,17 +233,27 @@ bool ExtendedAudioSource::setURLStream(const char* url) {
         return false;
     }
     
-    Logger.printf("🌐 Opening URL stream: %s\n", url);
+    LOG_PRINTF(AUDIO, "🌐 Opening URL stream: %s\n", url);
     
     // Determine MIME type from URL extension
     const char* mimeType = extensionToMime(url);
     if (!mimeType) mimeType = "audio/mpeg";
     
     if (!urlStream->begin(url, mimeType)) {
-        Logger.printf("❌ Failed to open URL stream: %s\n", url);
+        LOG_PRINTF(AUDIO, "❌ Failed to open URL stream: %s\n", url);
+        streamCachePath[0] = '\0';
         return false;
     }
     
+#if AUDIO_URL_JITTER_ENABLED
+    bool buffered = urlJitter.open(*urlStream, streamCachePath[0] ? streamCachePath : nullptr);
+    streamCachePath[0] = '\0';
+    if (!buffered) {
+        urlStream->end();
+        return false;
+    }
+#endif
+    
     currentType = AudioStreamType::URL_STREAM;
     strncpy(currentKey, url, sizeof(currentKey) - 1);
     currentKey[sizeof(currentKey) - 1] = '\0';
@@ -215,6 +262,15 @@ bool ExtendedAudioSource::setURLStream(const char* url) {
     return true;
 }
 
+void ExtendedAudioSource::setStreamCachePath(const char* localPath) {
+    if (!localPath || isUrl(localPath) || strlen(localPath) >= sizeof(streamCachePath)) {
+        streamCachePath[0] = '\0';
+        return;
+    }
+    strncpy(streamCachePath, localPath, sizeof(streamCachePath) - 1);
+    streamCachePath[sizeof(streamCachePath) - 1] = '\0';
+}
+
 bool ExtendedAudioSource::setGeneratorStream(const char* generatorName) {
     if (!generatorName) {
         Logger.println("❌ Invalid generator name");
@@ -229,11 +285,11 @@ bool ExtendedAudioSource::setGeneratorStream(const char* generatorName) {
     // Look up the generator in the registry
     SoundGenerator<int16_t>* generator = registry->getGenerator(generatorName);
     if (!generator) {
-        Logger.printf("❌ Generator not registered: %s\n", generatorName);
+        LOG_PRINTF(AUDIO, "❌ Generator not registered: %s\n", generatorName);
         return false;
     }
     
-    Logger.printf("🎵 Setting up generator: %s\n", generatorName);
+    LOG_PRINTF(AUDIO, "🎵 Setting up generator: %s\n", generatorName);
     
     AudioInfo info = AUDIO_INFO_DEFAULT();
     generator->begin(info);
@@ -241,19 +297,32 @@ bool ExtendedAudioSource::setGeneratorStream(const char* generatorName) {
     generatorStream.setInput(*generator);
     generatorStream.begin(info);
     
-    // Verify generator can produce data
-    uint8_t testBuf[64];
-    size_t testBytes = generatorStream.readBytes(testBuf, sizeof(testBuf));
-    Logger.printf("🔬 Generator test read: %d bytes (first 4: %02x %02x %02x %02x)\n",
-                  (int)testBytes,
-                  testBytes > 0 ? testBuf[0] : 0, testBytes > 1 ? testBuf[1] : 0,
-                  testBytes > 2 ? testBuf[2] : 0, testBytes > 3 ? testBuf[3] : 0);
+    if (generatorSkipBytes > 0) {
+        // Fast start already played the opening; resume right after it
+        uint8_t skipBuf[256];
+        size_t remaining = generatorSkipBytes;
+        while (remaining > 0) {
+            size_t n = generatorStream.readBytes(skipBuf, min(remaining, sizeof(skipBuf)));
+            if (n == 0) break;
+            remaining -= n;
+        }
+        LOG_PRINTF(AUDIO, "⚡ Generator resumed after %u fast-start bytes\n", (unsigned)generatorSkipBytes);
+        generatorSkipBytes = 0;
+    } else {
+        // Verify generator can produce data
+        uint8_t testBuf[64];
+        size_t testBytes = generatorStream.readBytes(testBuf, sizeof(testBuf));
+        LOG_PRINTF(AUDIO, "🔬 Generator test read: %d bytes (first 4: %02x %02x %02x %02x)\n",
+                          (int)testBytes,
+                          testBytes > 0 ? testBuf[0] : 0, testBytes > 1 ? testBuf[1] : 0,
+                          testBytes > 2 ? testBuf[2] : 0, testBytes > 3 ? testBuf[3] : 0);
+    }
     
     currentType = AudioStreamType::GENERATOR;
     strncpy(currentKey, generatorName, sizeof(currentKey) - 1);
     currentKey[sizeof(currentKey) - 1] = '\0';
     
-    Logger.printf("✅ Generator started: %s\n", generatorName);
+    LOG_PRINTF(AUDIO, "✅ Generator started: %s\n", generatorName);
     return true;
 }
 
@@ -290,46 +359,158 @@ const char* ExtendedAudioSource::detectMimeFromFileContent(File& file) {
     return nullptr;
 }
 
-bool ExtendedAudioSource::setFileStream(const char* filePath) {
-    if (!filePath) {
-        Logger.println("❌ Invalid file path");
-        return false;
-    }
-    
+bool ExtendedAudioSource::openAudioFile(const char* filePath, File& file, char* mimeOut, size_t mimeSize) {
     if (!SD_FS.exists(filePath)) {
-        Logger.printf("❌ File not found: %s\n", filePath);
+        LOG_PRINTF(AUDIO, "❌ File not found: %s\n", filePath);
         return false;
     }
     
-    Logger.printf("📁 Opening file: %s\n", filePath);
+    LOG_PRINTF(AUDIO, "📁 Opening file: %s\n", filePath);
     
-    currentFile = SD_FS.open(filePath, FILE_READ);
-    if (!currentFile) {
-        Logger.printf("❌ Failed to open file: %s\n", filePath);
+    file = SD_FS.open(filePath, FILE_READ);
+    if (!file) {
+        LOG_PRINTF(AUDIO, "❌ Failed to open file: %s\n", filePath);
         return false;
     }
     
     // Detect actual format from magic bytes — don't trust the file extension
-    detectedFileMime[0] = '\0';
-    const char* detected = detectMimeFromFileContent(currentFile);
+    mimeOut[0] = '\0';
+    const char* detected = detectMimeFromFileContent(file);
     if (detected) {
-        strncpy(detectedFileMime, detected, sizeof(detectedFileMime) - 1);
-        detectedFileMime[sizeof(detectedFileMime) - 1] = '\0';
+        strncpy(mimeOut, detected, mimeSize - 1);
+        mimeOut[mimeSize - 1] = '\0';
         const char* extMime = extensionToMime(filePath);
         if (extMime && strcmp(extMime, detected) != 0) {
-            Logger.printf("⚠️ Format mismatch: file '%s' extension says %s but content is %s\n",
-                          filePath, extMime, detected);
+            LOG_PRINTF(AUDIO, "⚠️ Format mismatch: file '%s' extension says %s but content is %s\n",
+                              filePath, extMime, detected);
         }
     }
+    return true;
+}
+
+bool ExtendedAudioSource::setFileStream(const char* filePath) {
+    if (!filePath) {
+        Logger.println("❌ Invalid file path");
+        return false;
+    }
+    
+    if (prefetchedFile && strcmp(prefetchPath, filePath) == 0) {
+        // Take over the handle opened during the previous item
+        currentFile = prefetchedFile;
+        prefetchedFile = File();
+        strncpy(detectedFileMime, prefetchMime, sizeof(detectedFileMime) - 1);
+        detectedFileMime[sizeof(detectedFileMime) - 1] = '\0';
+        prefetchPath[0] = '\0';
+        prefetchMime[0] = '\0';
+        LOG_PRINTF(AUDIO, "⏩ Using prefetched file: %s\n", filePath);
+    } else if (!openAudioFile(filePath, currentFile, detectedFileMime, sizeof(detectedFileMime))) {
+        return false;
+    }
     
     currentType = AudioStreamType::FILE_STREAM;
     strncpy(currentKey, filePath, sizeof(currentKey) - 1);
     currentKey[sizeof(currentKey) - 1] = '\0';
     
-    Logger.printf("✅ File opened: %s (%d bytes)\n", filePath, currentFile.size());
+    LOG_PRINTF(AUDIO, "✅ File opened: %s (%d bytes)\n", filePath, currentFile.size());
+    return true;
+}
+
+bool ExtendedAudioSource::prefetchFile(const char* filePath) {
+    if (!filePath || filePath[0] == '\0' || strlen(filePath) >= sizeof(prefetchPath)) {
+        return false;
+    }
+    if (prefetchedFile && strcmp(prefetchPath, filePath) == 0) {
+        return true;  // Already staged
+    }
+    
+    cancelPrefetch();
+    if (!openAudioFile(filePath, prefetchedFile, prefetchMime, sizeof(prefetchMime))) {
+        return false;
+    }
+    strncpy(prefetchPath, filePath, sizeof(prefetchPath) - 1);
+    prefetchPath[sizeof(prefetchPath) - 1] = '\0';
+    LOG_PRINTF(AUDIO, "⏩ Prefetched next file: %s (%s)\n", filePath,
+                      prefetchMime[0] ? prefetchMime : "unknown format");
     return true;
 }
 
+void ExtendedAudioSource::cancelPrefetch() {
+    if (prefetchedFile) {
+        prefetchedFile.close();
+    }
+    prefetchedFile = File();
+    prefetchPath[0] = '\0';
+    prefetchMime[0] = '\0';
+}
+
+long ExtendedAudioSource::remainingFileBytes() {
+#if AUDIO_PCM_CACHE_ENABLED
+    if (cachedPcm) {
+        return cacheStream.available();  // Decoded bytes, but still a fair "nearly done"
+    }
+#endif
+#if AUDIO_FILE_READAHEAD_ENABLED
+    if (currentType == AudioStreamType::FILE_STREAM && fileReadahead.isOpen()) {
+        return fileReadahead.available();
+    }
+#endif
+    if (currentType != AudioStreamType::FILE_STREAM || !currentFile) {
+        return -1;
+    }
+    return (long)currentFile.size() - (long)currentFile.position();
+}
+
+#if AUDIO_PCM_CACHE_ENABLED
+bool ExtendedAudioSource::useCachedPcm(const char* filePath) {
+    size_t size = currentFile.size();
+    if (size == 0 || size > AUDIO_PCM_CACHE_MAX_FILE_BYTES) {
+        return false;  // Long clips and music are decoded as usual
+    }
+    
+    AudioPcmCache& cache = getAudioPcmCache();
+    time_t mtime = currentFile.getLastWrite();
+    const PcmCacheEntry* entry = cache.lookup(filePath, size, mtime);
+    if (!entry) {
+        // Record this decode; kept if the file plays through to EOF
+        cache.beginCapture(filePath, size, mtime);
+        return false;
+    }
+    
+    currentFile.close();
+    cache.pin(entry);
+    cachedPcm = entry;
+    cacheStream.setValue(entry->data, (int)entry->length, FLASH_RAM);  // Read-only view; the cache owns it
+    cacheStream.begin();
+    LOG_PRINTF(AUDIO, "🗃️ Playing %s from PCM cache (%u bytes)\n", filePath, (unsigned)entry->length);
+    return true;
+}
+
+void ExtendedAudioSource::finishPcmCapture() {
+    AudioPcmCache& cache = getAudioPcmCache();
+    if (cachedPcm) {
+        cache.unpin(cachedPcm);
+        cachedPcm = nullptr;
+        cacheStream.end();
+        return;
+    }
+    if (!cache.isCapturing()) {
+        return;
+    }
+    // Only a clip the decoder read to the end is complete
+    bool readToEnd = currentFile && currentFile.position() >= currentFile.size();
+#if AUDIO_FILE_READAHEAD_ENABLED
+    if (fileReadahead.isOpen()) {
+        readToEnd = fileReadahead.available() == 0;
+    }
+#endif
+    if (readToEnd) {
+        cache.commitCapture();
+    } else {
+        cache.abortCapture();
+    }
+}
+#endif
+
 // ============================================================================
 // EXTENDED AUDIO PLAYER IMPLEMENTATION
 // ============================================================================
@@ -363,25 +544,43 @@ ExtendedAudioPlayer::~ExtendedAudioPlayer() {
 }
 
 void ExtendedAudioPlayer::begin(AudioStream& outputStream, bool enableStreaming) {
-    Logger.printf("🔧 ExtendedAudioPlayer::begin() - %s mode\n", 
-                  enableStreaming ? "URL streaming" : "SD card");
+    LOG_PRINTF(AUDIO, "🔧 ExtendedAudioPlayer::begin() - %s mode\n", 
+                      enableStreaming ? "URL streaming" : "SD card");
     
     streamingEnabled = enableStreaming;
     output = &outputStream;
     
     // Set up volume stream
-    volumeStream.setOutput(outputStream);
+#if LOOPBACK_CANCEL_ENABLED
+    // Tap the final PCM so the Goertzel task can cancel DAC→ADC loopback
+    MicRingBuffer& referenceRing = getLoopbackReferenceRing();
+    if (!referenceRing.isActive() && !referenceRing.begin(LOOPBACK_REF_RING_SAMPLES)) {
+        Logger.println("⚠️ Loopback reference ring allocation failed — cancellation disabled");
+    }
+    referenceTap.setOutput(outputStream);
+    referenceTap.setChannels(AUDIO_CHANNELS);
+    AudioStream& sink = referenceTap;
+#else
+    AudioStream& sink = outputStream;
+#endif
+    copyMeter.getOutputStage().setOutput(sink);
+    mixer.setOutput(copyMeter.getOutputStage());
     loadVolumeFromStorage();
-    volumeStream.setVolume(currentVolume);
+    applyVolume();
     
     // Initialize URL streaming if enabled
     if (enableStreaming) {
         source->initURLStreaming(urlStreamBufferSize);
-        encodedStream = new EncodedAudioStream(&volumeStream, decoder);
+        encodedStream = new EncodedAudioStream(&mixer, decoder);
     }
     
     // Create the audio player with our extended source
-    player = new AudioPlayer(*source, volumeStream, *decoder);
+#if AUDIO_PCM_CACHE_ENABLED
+    pcmCaptureTap.setOutput(mixer);
+    player = new AudioPlayer(*source, pcmCaptureTap, *decoder);
+#else
+    player = new AudioPlayer(*source, mixer, *decoder);
+#endif
     
     // Register PCM passthrough decoder for generator streams
     // and set source as MimeSource so MultiDecoder skips auto-detection for generators
@@ -390,8 +589,8 @@ void ExtendedAudioPlayer::begin(AudioStream& outputStream, bool enableStreaming)
         ownedMultiDecoder->setMimeSource(*source);
         Logger.println("🔧 PCM decoder registered + MimeSource wired on MultiDecoder");
     } else {
-        Logger.printf("⚠️ MultiDecoder not active (isMulti=%d, owned=%p)\n", 
-                      isMultiDecoder, ownedMultiDecoder);
+        LOG_PRINTF(AUDIO, "⚠️ MultiDecoder not active (isMulti=%d, owned=%p)\n", 
+                          isMultiDecoder, ownedMultiDecoder);
     }
     
     // Configure player
@@ -404,7 +603,20 @@ void ExtendedAudioPlayer::begin(AudioStream& outputStream, bool enableStreaming)
     
     initialized = true;
     
-    Logger.printf("✅ ExtendedAudioPlayer initialized (volume: %.2f)\n", currentVolume);
+#if AUDIO_FAST_START_ENABLED
+    prepareFastStart();
+#endif
+    
+#if AUDIO_OUTPUT_TASK_ENABLED
+    // Decode into the PCM ring; the output task drains it into the sink
+    if (startAudioOutputTask(*this, sink)) {
+        copyMeter.getOutputStage().setOutput(getAudioOutputRing());
+    } else {
+        Logger.println("⚠️ Audio output task unavailable — playback driven from loop()");
+    }
+#endif
+    
+    LOG_PRINTF(AUDIO, "✅ ExtendedAudioPlayer initialized (volume: %.2f)\n", currentVolume);
 }
 
 void ExtendedAudioPlayer::onEOFCallback(AudioPlayer& p) {
@@ -421,7 +633,7 @@ void ExtendedAudioPlayer::onStreamEnd() {
     
     // Check if there are queued items
     if (!audioQueue.empty()) {
-        Logger.printf("📋 Queue has %d items, advancing...\n", audioQueue.size());
+        LOG_PRINTF(AUDIO, "📋 Queue has %d items, advancing...\n", (int)audioQueue.size());
         next();
     } else {
         // Play 'click' after real audio ends (not after click/dialtone/off_hook themselves)
@@ -438,7 +650,10 @@ void ExtendedAudioPlayer::onStreamEnd() {
         
         if (shouldClick && registry && registry->hasKey("click")) {
             Logger.println("🔊 Playing click sound");
-            playAudioKey("click");
+            // Cached click overlays without starting a decoder
+            if (!playOverlay("click")) {
+                playAudioKey("click");
+            }
         }
     }
 }
@@ -454,8 +669,8 @@ bool ExtendedAudioPlayer::playAudio(AudioStreamType type, const char* audioKey,
         return false;
     }
     
-    Logger.printf("▶️ playAudio(type=%d, key=%s, duration=%lu) - clearing queue\n", 
-                  static_cast<int>(type), audioKey, durationMs);
+    LOG_PRINTF(AUDIO, "▶️ playAudio(type=%d, key=%s, duration=%lu) - clearing queue\n", 
+                      static_cast<int>(type), audioKey, durationMs);
     
     // Clear queue and stop current playback
     clearQueue();
@@ -470,9 +685,15 @@ bool ExtendedAudioPlayer::playAudio(AudioStreamType type, const char* audioKey,
 bool ExtendedAudioPlayer::playAudioKey(const char* audioKey, unsigned long durationMs) {
     if (!audioKey) return false;
     
+#if AUDIO_OUTPUT_TASK_ENABLED
+    if (isAudioOutputTaskRunning() && !isAudioDecodeTaskContext()) {
+        return postAudioCommand(AudioCommandType::PLAY_KEY, audioKey, durationMs);
+    }
+#endif
+    
 #if ENABLE_PLAYLIST_FEATURES
     // Use playlist if one exists (includes ringback, click, previous/next)
-    if (playlistRegistry.hasPlaylist(audioKey)) {
+    if (playlistRegistry.hasCompiledPlaylist(audioKey)) {
         return playPlaylist(audioKey);
     }
 #endif
@@ -483,6 +704,127 @@ bool ExtendedAudioPlayer::playAudioKey(const char* audioKey, unsigned long durat
     return playAudio(type, audioKey, durationMs);
 }
 
+bool ExtendedAudioPlayer::playAudioKeyFast(const char* audioKey) {
+#if AUDIO_FAST_START_ENABLED
+    bool eligible = audioKey && fastStartBuffer && !isPlaying
+        && strcmp(audioKey, AUDIO_FAST_START_KEY) == 0
+        && detectStreamType(audioKey) == AudioStreamType::GENERATOR
+        && !fastStartStale();
+#if ENABLE_PLAYLIST_FEATURES
+    eligible = eligible && !playlistRegistry.hasCompiledPlaylist(audioKey);
+#endif
+#if AUDIO_OUTPUT_TASK_ENABLED
+    eligible = eligible && !isAudioOutputTaskRunning();  // Only the decode task may write
+#endif
+    if (eligible) {
+        // Only what the DMA ring takes without blocking
+        int room = mixer.availableForWrite();
+        size_t frameBytes = sizeof(int16_t) * AUDIO_CHANNELS;
+        size_t n = min(fastStartBytes, room > 0 ? (size_t)room : 0);
+        n -= n % frameBytes;
+        if (n > 0) {
+            unsigned long t0 = micros();
+            size_t written = mixer.write(reinterpret_cast<const uint8_t*>(fastStartBuffer), n);
+            source->skipNextGeneratorBytes(written);
+            
+            // The generator resumes at full level, so its fade-in would dip
+            player->setAutoFade(false);
+            bool ok = playAudioKey(audioKey);
+            player->setAutoFade(true);
+            if (!ok) {
+                source->skipNextGeneratorBytes(0);
+            }
+            LOG_PRINTF(AUDIO, "⚡ Fast start: %u bytes in %luus, pipeline %s\n",
+                              (unsigned)written, micros() - t0, ok ? "running" : "failed");
+            return ok;
+        }
+    }
+#endif
+    return playAudioKey(audioKey);
+}
+
+#if AUDIO_FAST_START_ENABLED
+void ExtendedAudioPlayer::prepareFastStart() {
+    SoundGenerator<int16_t>* generator = registry ? registry->getGenerator(AUDIO_FAST_START_KEY) : nullptr;
+    if (!generator) {
+        LOG_PRINTF(AUDIO, "⚠️ Fast start: no '%s' generator registered\n", AUDIO_FAST_START_KEY);
+        return;
+    }
+    
+    size_t frames = (size_t)AUDIO_SAMPLE_RATE * AUDIO_FAST_START_MS / 1000;
+    size_t bytes = frames * AUDIO_CHANNELS * sizeof(int16_t);
+    if (!fastStartBuffer) {
+        fastStartBuffer = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (!fastStartBuffer) {
+        Logger.println("⚠️ Fast start buffer allocation failed");
+        return;
+    }
+    
+    // Render exactly what setGeneratorStream() would produce from begin()
+    AudioInfo info = AUDIO_INFO_DEFAULT();
+    generator->begin(info);
+    fastStartBytes = generator->readBytes(reinterpret_cast<uint8_t*>(fastStartBuffer), bytes);
+    const AudioEntry* entry = registry->getEntry(AUDIO_FAST_START_KEY);
+    fastStartGenerator = generator;
+    fastStartHash = entry ? entry->contentHash : 0;
+    
+    // Short ramp so the tone doesn't click in from silence (the player's
+    // auto-fade is skipped for a fast start)
+    size_t rampFrames = min(frames, (size_t)(AUDIO_SAMPLE_RATE / 500));  // 2ms
+    for (size_t f = 0; f < rampFrames; f++) {
+        for (int ch = 0; ch < AUDIO_CHANNELS; ch++) {
+            int16_t& sample = fastStartBuffer[f * AUDIO_CHANNELS + ch];
+            sample = (int16_t)((int32_t)sample * (int32_t)f / (int32_t)rampFrames);
+        }
+    }
+    LOG_PRINTF(AUDIO, "⚡ Fast start ready: %u bytes of '%s'\n", (unsigned)fastStartBytes, AUDIO_FAST_START_KEY);
+}
+
+// True when the catalog has replaced the generator the opening was rendered
+// from: resuming the new one after the old opening would splice two tones
+bool ExtendedAudioPlayer::fastStartStale() const {
+    SoundGenerator<int16_t>* generator = registry ? registry->getGenerator(AUDIO_FAST_START_KEY) : nullptr;
+    if (!generator) return false;
+    const AudioEntry* entry = registry->getEntry(AUDIO_FAST_START_KEY);
+    return generator != fastStartGenerator || (entry ? entry->contentHash : 0) != fastStartHash;
+}
+#endif
+
+bool ExtendedAudioPlayer::playOverlay(const char* audioKey, float volume, unsigned long durationMs) {
+    if (!initialized || !audioKey) return false;
+#if AUDIO_OUTPUT_TASK_ENABLED
+    if (isAudioOutputTaskRunning() && !isAudioDecodeTaskContext()) {
+        return false;  // Overlays are driven by the task that owns the player
+    }
+#endif
+    
+    // Overlays skip the main stream's gain; the codec scales both when it holds the volume
+    float gain = hardwareVolumeActive ? volume : volume * currentVolume;
+    AudioStreamType type = detectStreamType(audioKey);
+    if (type == AudioStreamType::GENERATOR) {
+        if (isPlaying && currentType == AudioStreamType::GENERATOR && strcmp(currentKey, audioKey) == 0) {
+            return false;  // Same generator object as the main stream
+        }
+        SoundGenerator<int16_t>* generator = registry ? registry->getGenerator(audioKey) : nullptr;
+        return mixer.start(audioKey, generator, gain, durationMs) >= 0;
+    }
+#if AUDIO_PCM_CACHE_ENABLED
+    if (type == AudioStreamType::FILE_STREAM) {
+        const char* localPath = nullptr;
+        const char* streamingPath = nullptr;
+        resolveFileKey(audioKey, localPath, streamingPath);
+        const PcmCacheEntry* clip = getAudioPcmCache().peek(localPath);
+        return clip && mixer.start(audioKey, clip, gain, durationMs) >= 0;
+    }
+#endif
+    return false;
+}
+
+void ExtendedAudioPlayer::stopOverlay(const char* audioKey) {
+    mixer.stop(audioKey);
+}
+
 bool ExtendedAudioPlayer::playPath(const char* path) {
     if (!path) return false;
     
@@ -506,8 +848,8 @@ bool ExtendedAudioPlayer::queueAudio(AudioStreamType type, const char* audioKey,
         return false;
     }
     
-    Logger.printf("🎵 queueAudio(type=%d, key=%s, duration=%lu)\n", 
-                  static_cast<int>(type), audioKey, durationMs);
+    LOG_PRINTF(AUDIO, "🎵 queueAudio(type=%d, key=%s, duration=%lu)\n", 
+                      static_cast<int>(type), audioKey, durationMs);
     
     // If player is not active, start immediately
     if (!isPlaying) {
@@ -515,9 +857,12 @@ bool ExtendedAudioPlayer::queueAudio(AudioStreamType type, const char* audioKey,
     }
     
     // Player is active - queue this audio
-    Logger.printf("📋 Queuing audio: %s\n", audioKey);
-    audioQueue.emplace_back(type, audioKey, durationMs);
-    Logger.printf("📋 Queue size: %d\n", audioQueue.size());
+    LOG_PRINTF(AUDIO, "📋 Queuing audio: %s\n", audioKey);
+    if (!audioQueue.push(type, audioKey, durationMs)) {
+        LOG_PRINTF(AUDIO, "⚠️ Queue full (%d items) — dropping %s\n", (int)audioQueue.capacity(), audioKey);
+        return false;
+    }
+    LOG_PRINTF(AUDIO, "📋 Queue size: %d\n", (int)audioQueue.size());
     
     return true;
 }
@@ -525,6 +870,12 @@ bool ExtendedAudioPlayer::queueAudio(AudioStreamType type, const char* audioKey,
 bool ExtendedAudioPlayer::queueAudioKey(const char* audioKey, unsigned long durationMs) {
     if (!audioKey) return false;
     
+#if AUDIO_OUTPUT_TASK_ENABLED
+    if (isAudioOutputTaskRunning() && !isAudioDecodeTaskContext()) {
+        return postAudioCommand(AudioCommandType::QUEUE_KEY, audioKey, durationMs);
+    }
+#endif
+    
     // Detect stream type from audioKey
     AudioStreamType type = detectStreamType(audioKey);
     
@@ -535,14 +886,20 @@ bool ExtendedAudioPlayer::queueAudioKey(const char* audioKey, unsigned long dura
 bool ExtendedAudioPlayer::playPlaylist(const char* playlistName) {
     if (!playlistName) return false;
     
-    const Playlist* playlist = playlistRegistry.getPlaylist(playlistName);
+#if AUDIO_OUTPUT_TASK_ENABLED
+    if (isAudioOutputTaskRunning() && !isAudioDecodeTaskContext()) {
+        return postAudioCommand(AudioCommandType::PLAY_PLAYLIST, playlistName);
+    }
+#endif
     
-    if (!playlist || playlist->empty()) {
-        Logger.printf("❌ Playlist not found or empty: %s\n", playlistName);
+    PlaylistSpan playlist = playlistRegistry.getPlaylistSpan(playlistName);
+    
+    if (playlist.empty()) {
+        LOG_PRINTF(AUDIO, "❌ Playlist not found or empty: %s\n", playlistName);
         return false;
     }
     
-    Logger.printf("▶️ Playing playlist: %s (%d items)\n", playlistName, (int)playlist->size());
+    LOG_PRINTF(AUDIO, "▶️ Playing playlist: %s (%d items)\n", playlistName, (int)playlist.size());
     
     // Clear queue and stop current playback
     clearQueue();
@@ -552,13 +909,11 @@ bool ExtendedAudioPlayer::playPlaylist(const char* playlistName) {
     
     // Queue all items from the playlist
     bool first = true;
-    for (const auto& node : playlist->nodes) {
-        const char* key = node.getAudioKey();
-        if (!key || strlen(key) == 0) continue;
-        
-        // Skip missing keys (like "click" which may not exist)
-        if (!hasAudioKey(key)) {
-            Logger.printf("⏭️ Skipping missing key in playlist: %s\n", key);
+    for (const auto& node : playlist) {
+        // Unregistered since the playlist was compiled
+        const char* key = registry ? registry->getKeyName(node.key) : nullptr;
+        if (!key) {
+            LOG_PRINTF(AUDIO, "⏭️ Skipping missing key in playlist %s\n", playlistName);
             continue;
         }
         
@@ -571,7 +926,10 @@ bool ExtendedAudioPlayer::playPlaylist(const char* playlistName) {
             }
         } else {
             // Queue subsequent items
-            audioQueue.emplace_back(type, key, node.durationMs);
+            if (!audioQueue.push(type, key, node.durationMs)) {
+                LOG_PRINTF(AUDIO, "⚠️ Queue full — playlist %s truncated at %s\n", playlistName, key);
+                break;
+            }
         }
     }
     
@@ -581,24 +939,21 @@ bool ExtendedAudioPlayer::playPlaylist(const char* playlistName) {
 bool ExtendedAudioPlayer::queuePlaylist(const char* playlistName) {
     if (!playlistName) return false;
     
-    const Playlist* playlist = playlistRegistry.getPlaylist(playlistName);
-
+    PlaylistSpan playlist = playlistRegistry.getPlaylistSpan(playlistName);
     
-    if (!playlist || playlist->empty()) {
-        Logger.printf("❌ Playlist not found or empty: %s\n", playlistName);
+    if (playlist.empty()) {
+        LOG_PRINTF(AUDIO, "❌ Playlist not found or empty: %s\n", playlistName);
         return false;
     }
     
-    Logger.printf("📋 Queuing playlist: %s (%d items)\n", playlistName, (int)playlist->size());
+    LOG_PRINTF(AUDIO, "📋 Queuing playlist: %s (%d items)\n", playlistName, (int)playlist.size());
     
     // Queue all items from the playlist
-    for (const auto& node : playlist->nodes) {
-        const char* key = node.getAudioKey();
-        if (!key || strlen(key) == 0) continue;
-        
-        // Skip missing keys (like "click" which may not exist)
-        if (!hasAudioKey(key)) {
-            Logger.printf("⏭️ Skipping missing key in playlist: %s\n", key);
+    for (const auto& node : playlist) {
+        // Unregistered since the playlist was compiled
+        const char* key = registry ? registry->getKeyName(node.key) : nullptr;
+        if (!key) {
+            LOG_PRINTF(AUDIO, "⏭️ Skipping missing key in playlist %s\n", playlistName);
             continue;
         }
         
@@ -653,8 +1008,8 @@ const char* ExtendedAudioPlayer::resolveAudioKey(const char* audioKey) const {
 }
 
 bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey, unsigned long durationMs) {
-    Logger.printf("▶️ Starting stream: type=%d, key=%s, duration=%lu\n",
-                  static_cast<int>(type), audioKey, durationMs);
+    LOG_PRINTF(AUDIO, "▶️ Starting stream: type=%d, key=%s, duration=%lu\n",
+                      static_cast<int>(type), audioKey, durationMs);
     
     // Resolve audioKey to actual resource path
     const char* localPath = nullptr;
@@ -665,6 +1020,7 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
         case AudioStreamType::GENERATOR:
             // For generators, check if registered and create gen:// URL
             if (registry && registry->hasGenerator(audioKey)) {
+                mixer.stop(audioKey);  // One generator object can't feed two channels
 #ifdef DISABLE_DIAL_TONE
                 if (strcmp(audioKey, "dialtone") == 0) {
                     Logger.println("🎯 Dial tone DISABLED (DISABLE_DIAL_TONE defined)");
@@ -675,7 +1031,7 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
                 snprintf(genPath, sizeof(genPath), "gen://%s", audioKey);
                 localPath = genPath;
             } else {
-                Logger.printf("❌ Generator not registered: %s\n", audioKey);
+                LOG_PRINTF(AUDIO, "❌ Generator not registered: %s\n", audioKey);
                 return false;
             }
             break;
@@ -685,23 +1041,7 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
             break;
             
         case AudioStreamType::FILE_STREAM:
-            // Use registry for resolution
-            if (registry) {
-                // Get the entry to check for streaming URL
-                const KeyEntry* entry = registry->getEntry(audioKey);
-                if (entry) {
-                    localPath = entry->file->path.c_str();
-                    streamingPath = entry->file->alternatePath.c_str();  // May be null
-                } else {
-                    // Try to resolve via callback
-                    localPath = registry->resolveKey(audioKey);
-                }
-            }
-            
-            // Fall back to treating as direct path
-            if (!localPath) {
-                localPath = audioKey;
-            }
+            resolveFileKey(audioKey, localPath, streamingPath);
             break;
             
         default:
@@ -710,13 +1050,13 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
     }
     
     if (!localPath) {
-        Logger.printf("❌ Failed to resolve audioKey: %s\n", audioKey);
+        LOG_PRINTF(AUDIO, "❌ Failed to resolve audioKey: %s\n", audioKey);
         return false;
     }
     
-    Logger.printf("📂 Resolved resource path: %s\n", localPath);
+    LOG_PRINTF(AUDIO, "📂 Resolved resource path: %s\n", localPath);
     if (streamingPath) {
-        Logger.printf("🌐 Streaming fallback available: %s\n", streamingPath);
+        LOG_PRINTF(AUDIO, "🌐 Streaming fallback available: %s\n", streamingPath);
     }
     
     // Try to play from local path first
@@ -725,7 +1065,14 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
     // If local playback failed and streaming is enabled, try streaming URL
     if (!playbackStarted && streamingEnabled && streamingPath) {
         Logger.println("⚠️ Local playback failed, attempting streaming fallback...");
+#if AUDIO_URL_JITTER_ENABLED
+        // Fill the missing local file from the stream instead of downloading it again
+        source->setStreamCachePath(localPath);
+#endif
         playbackStarted = player->setPath(streamingPath);
+#if AUDIO_URL_JITTER_ENABLED
+        source->setStreamCachePath(nullptr);  // Unused if the URL never opened
+#endif
         if (playbackStarted) {
             Logger.println("✅ Streaming fallback successful");
             // Update type to reflect we're actually streaming
@@ -734,15 +1081,30 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
     }
     
     if (!playbackStarted) {
-        Logger.printf("❌ Failed to set path: %s\n", localPath);
+        LOG_PRINTF(AUDIO, "❌ Failed to set path: %s\n", localPath);
         if (streamingPath && !streamingEnabled) {
             Logger.println("💡 Tip: Enable streaming with setStreamingEnabled(true) to use URL fallback");
         }
+        if (type == AudioStreamType::FILE_STREAM && streamingPath && streamingPath[0] && missingFileCallback) {
+            missingFileCallback(audioKey);
+        }
         return false;
     }
+    if (type == AudioStreamType::FILE_STREAM && filePlayedCallback) {
+        filePlayedCallback(audioKey);
+    }
+    
+#if AUDIO_PCM_CACHE_ENABLED
+    // CopyDecoder passes cached PCM through without announcing its format
+    const PcmCacheEntry* cached = source->getCachedPcm();
+    if (cached) {
+        pcmCaptureTap.setAudioInfo(cached->info);
+    }
+#endif
     
     // Store current playback state
     currentType = type;
+    prefetchAttempted = false;  // Re-evaluate for the new queue front
     strncpy(currentKey, audioKey, sizeof(currentKey) - 1);
     currentKey[sizeof(currentKey) - 1] = '\0';
     currentDurationMs = durationMs;
@@ -752,9 +1114,10 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
     // Start playback
     player->play();
     
-    // Reset stall detector for the new stream
-    lastNonZeroCopyTime = millis();
-    zeroCopyCount = 0;
+    // Fresh per-stream counters; reset the stall detector
+    copyMeter.beginStream(audioKey);
+    lastPcmOutTime = millis();
+    lastPcmOutBytes = copyMeter.pcmOutTotal();
     
     // Notify callback
     if (eventCallback) {
@@ -765,21 +1128,108 @@ bool ExtendedAudioPlayer::startStream(AudioStreamType type, const char* audioKey
     return true;
 }
 
+bool ExtendedAudioPlayer::resolveFileKey(const char* audioKey, const char*& localPath,
+                                         const char*& streamingPath) const {
+    localPath = nullptr;
+    streamingPath = nullptr;
+    
+    // Use registry for resolution
+    if (registry) {
+        // Get the entry to check for streaming URL
+        const KeyEntry* entry = registry->getEntry(audioKey);
+        if (entry) {
+            localPath = entry->file->path.c_str();
+            streamingPath = entry->file->alternatePath.c_str();  // May be null
+        } else {
+            // Try to resolve via callback
+            localPath = registry->resolveKey(audioKey);
+        }
+    }
+    
+    // Fall back to treating as direct path
+    if (!localPath) {
+        localPath = audioKey;
+    }
+    return true;
+}
+
+bool ExtendedAudioPlayer::shouldPrefetch() {
+    if (audioQueue.empty() || prefetchAttempted || !isPlaying) {
+        return false;
+    }
+    QueuedAudioItem front;
+    if (!audioQueue.peek(front, nullptr, 0) || front.type != AudioStreamType::FILE_STREAM) {
+        return false;  // Generators open instantly; URLs have a single stream
+    }
+    
+    // Near a duration limit (ringback → clip)
+    if (currentDurationMs > 0) {
+        unsigned long elapsed = millis() - playbackStartTime;
+        if (elapsed + AUDIO_PREFETCH_LEAD_MS >= currentDurationMs) {
+            return true;
+        }
+    }
+    
+    switch (source->getCurrentStreamType()) {
+        case AudioStreamType::GENERATOR:
+        case AudioStreamType::URL_STREAM:
+            // No SD reads of our own to compete with
+            return true;
+        case AudioStreamType::FILE_STREAM: {
+            long remaining = source->remainingFileBytes();
+            return remaining >= 0 && remaining <= AUDIO_PREFETCH_LEAD_BYTES;
+        }
+        default:
+            return false;
+    }
+}
+
+void ExtendedAudioPlayer::prefetchNext() {
+    prefetchAttempted = true;
+    
+    QueuedAudioItem item;
+    char key[AUDIO_QUEUE_KEY_LENGTH];
+    if (!audioQueue.peek(item, key, sizeof(key))) {
+        return;
+    }
+    const char* localPath = nullptr;
+    const char* streamingPath = nullptr;
+    resolveFileKey(key, localPath, streamingPath);
+    
+    // A miss just means next() opens it the normal way
+    source->prefetchFile(localPath);
+}
+
 void ExtendedAudioPlayer::stop() {
+#if AUDIO_OUTPUT_TASK_ENABLED
+    if (isAudioOutputTaskRunning() && !isAudioDecodeTaskContext()) {
+        postAudioCommand(AudioCommandType::STOP);
+        return;
+    }
+#endif
     Logger.println("⏹️ stop() called");
     
     // Clear the queue
     clearQueue();
+    mixer.stopAll();
     
     // Stop playback
     stopInternal();
 }
 
 void ExtendedAudioPlayer::emergencyStop() {
+#if AUDIO_OUTPUT_TASK_ENABLED
+    if (isAudioOutputTaskRunning() && !isAudioDecodeTaskContext()) {
+        postAudioCommand(AudioCommandType::EMERGENCY_STOP);
+        return;
+    }
+#endif
     Logger.println("🚨 emergencyStop() — aborting all audio and resetting state");
     
     // Clear queue first so onStreamEnd() doesn't try to advance
     audioQueue.clear();
+    prefetchAttempted = false;
+    mixer.stopAll();
     
     // Force-stop the player (may be in a bad state)
     if (player) {
@@ -787,6 +1237,7 @@ void ExtendedAudioPlayer::emergencyStop() {
     }
     if (source) {
         source->end();
+        source->cancelPrefetch();
     }
     
     // Reset all playback state
@@ -795,8 +1246,7 @@ void ExtendedAudioPlayer::emergencyStop() {
     currentDurationMs = 0;
     isPlaying = false;
     lastCopyBytes = 0;
-    zeroCopyCount = 0;
-    lastNonZeroCopyTime = 0;
+    lastPcmOutTime = 0;
     
     // Notify callback
     if (eventCallback) {
@@ -827,12 +1277,16 @@ void ExtendedAudioPlayer::stopInternal() {
 }
 
 void ExtendedAudioPlayer::clearQueue() {
-    Logger.printf("🗑️ Clearing queue (%d items)\n", audioQueue.size());
+    LOG_PRINTF(AUDIO, "🗑️ Clearing queue (%d items)\n", (int)audioQueue.size());
     audioQueue.clear();
+    prefetchAttempted = false;
+    if (source) {
+        source->cancelPrefetch();
+    }
 }
 
 bool ExtendedAudioPlayer::isActive() const {
-    return isPlaying && player && player->isActive();
+    return (isPlaying && player && player->isActive()) || mixer.isActive();
 }
 
 void ExtendedAudioPlayer::setActive(bool active) {
@@ -850,52 +1304,57 @@ bool ExtendedAudioPlayer::copy() {
     if (!initialized || !player) {
         return false;
     }
+#if AUDIO_OUTPUT_TASK_ENABLED
+    // The decode task owns the player; loop()'s copy() is a no-op
+    if (isAudioOutputTaskRunning() && !isAudioDecodeTaskContext()) {
+        return isPlaying;
+    }
+#endif
     
     // Check duration limit
     if (currentDurationMs > 0 && isPlaying) {
         unsigned long elapsed = millis() - playbackStartTime;
         if (elapsed >= currentDurationMs) {
-            Logger.printf("⏱️ Duration limit reached (%lu ms)\n", currentDurationMs);
+            LOG_PRINTF(AUDIO, "⏱️ Duration limit reached (%lu ms)\n", currentDurationMs);
             onStreamEnd();
             return isPlaying;  // May have advanced to next in queue
         }
     }
     
+#if AUDIO_FAST_START_ENABLED
+    // Re-render while nothing can be reading the generator
+    if (!isPlaying && !mixer.isActive() && fastStartBuffer && fastStartStale()) {
+        prepareFastStart();
+    }
+#endif
+    
     // Process audio
     if (player->isActive()) {
-        size_t bytesCopied = player->copy();
+        // Chunk size adapts so one call stays within AUDIO_COPY_BUDGET_US
+        copyMeter.startCopy();
+        size_t bytesCopied = player->copy(copyMeter.nextCopyBytes());
+        copyMeter.endCopy(bytesCopied);
         lastCopyBytes = bytesCopied;
         
-        // Stall detection: if decoder is stuck (e.g. wrong format) it loops
-        // consuming input but producing 0 output.  Detect and abort.
-        if (bytesCopied > 0) {
-            lastNonZeroCopyTime = millis();
-            zeroCopyCount = 0;
-        } else {
-            zeroCopyCount++;
-            unsigned long stallMs = millis() - lastNonZeroCopyTime;
-            if (lastNonZeroCopyTime > 0 &&
-                (stallMs >= COPY_STALL_TIMEOUT_MS || zeroCopyCount >= COPY_STALL_MAX_ZERO)) {
-                Logger.printf("🛑 Audio stall detected: 0 bytes for %lu ms (%d calls) on '%s' — aborting\n",
-                              stallMs, zeroCopyCount, currentKey);
-                emergencyStop();
-                return false;
-            }
+        // Stall detection: a dead source or a decoder that eats input it
+        // can't decode both show up as no PCM reaching the codec
+        uint32_t pcmOut = copyMeter.pcmOutTotal();
+        unsigned long now = millis();
+        if (pcmOut != lastPcmOutBytes) {
+            lastPcmOutBytes = pcmOut;
+            lastPcmOutTime = now;
+        } else if (lastPcmOutTime > 0 && now - lastPcmOutTime >= COPY_STALL_TIMEOUT_MS) {
+            AudioCopyStats s = copyMeter.getStreamStats();
+            LOG_PRINTF(AUDIO, "🛑 Audio stall detected: no PCM out for %lu ms on '%s' (%u bytes in, %u out) — aborting\n",
+                              now - lastPcmOutTime, currentKey, s.bytesIn, s.pcmOut);
+            emergencyStop();
+            return false;
         }
-        // Periodic diagnostic for generator streams
-        if (source && source->getCurrentStreamType() == AudioStreamType::GENERATOR) {
-            static unsigned long lastDiag = 0;
-            static unsigned long copyCount = 0;
-            static size_t totalBytes = 0;
-            copyCount++;
-            totalBytes += bytesCopied;
-            unsigned long now = millis();
-            if (now - lastDiag >= 2000) {
-                copyCount = 0;
-                totalBytes = 0;
-                lastDiag = now;
-            }
+#if AUDIO_PREFETCH_ENABLED
+        if (shouldPrefetch()) {
+            prefetchNext();
         }
+#endif
         return true;
     }
     
@@ -905,6 +1364,12 @@ bool ExtendedAudioPlayer::copy() {
         onStreamEnd();
     }
     
+    // Overlays with no main stream under them
+    if (!isPlaying && mixer.isActive()) {
+        lastCopyBytes = mixer.pump(AUDIO_MIXER_PUMP_BYTES);
+        return true;
+    }
+    
     return isPlaying;
 }
 
@@ -922,8 +1387,10 @@ bool ExtendedAudioPlayer::next() {
     currentType = AudioStreamType::NONE;
     currentKey[0] = '\0';
     
-    // Check queue
-    if (audioQueue.empty()) {
+    // Get next item from queue
+    QueuedAudioItem item;
+    char key[AUDIO_QUEUE_KEY_LENGTH];
+    if (!audioQueue.pop(item, key, sizeof(key))) {
         Logger.println("📋 Queue empty, stopping");
         isPlaying = false;
         if (eventCallback) {
@@ -932,22 +1399,24 @@ bool ExtendedAudioPlayer::next() {
         return false;
     }
     
-    // Get next item from queue
-    QueuedAudioItem item = audioQueue.front();
-    audioQueue.erase(audioQueue.begin());
-    
-    Logger.printf("📋 Dequeued: %s (remaining: %d)\n", item.audioKey, audioQueue.size());
+    LOG_PRINTF(AUDIO, "📋 Dequeued: %s (remaining: %d)\n", key, (int)audioQueue.size());
     
     // Start the dequeued item
-    return startStream(item.type, item.audioKey, item.durationMs);
+    return startStream(item.type, key, item.durationMs);
 }
 
 bool ExtendedAudioPlayer::isAudioKeyPlaying(const char* audioKey) const {
-    if (!isPlaying || !audioKey) return false;
+    if (!audioKey) return false;
+    if (mixer.isPlaying(audioKey)) return true;
+    if (!isPlaying) return false;
     return strcmp(currentKey, audioKey) == 0;
 }
 
 void ExtendedAudioPlayer::stopAudioKey(const char* audioKey) {
+    if (mixer.isPlaying(audioKey)) {
+        mixer.stop(audioKey);
+        return;
+    }
     if (isAudioKeyPlaying(audioKey)) {
         // Don't clear queue - just advance to next
         onStreamEnd();
@@ -958,6 +1427,22 @@ const char* ExtendedAudioPlayer::getCurrentAudioKey() const {
     return currentKey[0] != '\0' ? currentKey : nullptr;
 }
 
+#if AUDIO_URL_JITTER_ENABLED
+void ExtendedAudioPlayer::printUrlStreamStatus() const {
+    if (source) {
+        source->getUrlJitter().printStatus();
+    }
+}
+#endif
+
+#if AUDIO_FILE_READAHEAD_ENABLED
+void ExtendedAudioPlayer::printFileStreamStatus() const {
+    if (source) {
+        source->getFileReadahead().printStatus();
+    }
+}
+#endif
+
 void ExtendedAudioPlayer::setVolume(float volume) {
     // Clamp to valid range
     if (volume < 0.0f) volume = 0.0f;
@@ -965,17 +1450,35 @@ void ExtendedAudioPlayer::setVolume(float volume) {
     
     currentVolume = volume;
     
-    if (player) {
-        player->setVolume(volume);
-    }
-    volumeStream.setVolume(volume);
+    // The AudioPlayer's own volume stage stays at full scale: setting it too
+    // applied the volume twice, in float
+    applyVolume();
     
-    Logger.printf("🔊 Volume set to %.2f\n", volume);
+    LOG_PRINTF(AUDIO, "🔊 Volume set to %.2f%s\n", volume, hardwareVolumeActive ? " (codec)" : "");
     
     // Persist to storage
     saveVolumeToStorage();
 }
 
+void ExtendedAudioPlayer::setHardwareVolume(bool (*apply)(float)) {
+    hardwareVolume = apply;
+    if (initialized) {
+        applyVolume();
+    }
+}
+
+void ExtendedAudioPlayer::applyVolume() {
+#if AUDIO_HW_VOLUME
+    if (hardwareVolume && hardwareVolume(currentVolume)) {
+        hardwareVolumeActive = true;
+        mixer.setMainGain(1.0f);  // Main stream passes the mixer untouched
+        return;
+    }
+#endif
+    hardwareVolumeActive = false;
+    mixer.setMainGain(currentVolume);
+}
+
 void ExtendedAudioPlayer::loadVolumeFromStorage() {
     Preferences prefs;
     if (!prefs.begin("audio", true)) {  // Read-only
@@ -989,11 +1492,11 @@ void ExtendedAudioPlayer::loadVolumeFromStorage() {
     
     // Validate
     if (currentVolume < 0.0f || currentVolume > 1.0f) {
-        Logger.printf("⚠️ Invalid stored volume: %.2f, using default\n", currentVolume);
+        LOG_PRINTF(AUDIO, "⚠️ Invalid stored volume: %.2f, using default\n", currentVolume);
         currentVolume = DEFAULT_AUDIO_VOLUME;
     }
     
-    Logger.printf("📖 Loaded volume: %.2f\n", currentVolume);
+    LOG_PRINTF(AUDIO, "📖 Loaded volume: %.2f\n", currentVolume);
 }
 
 void ExtendedAudioPlayer::saveVolumeToStorage() {
@@ -1006,7 +1509,7 @@ void ExtendedAudioPlayer::saveVolumeToStorage() {
     prefs.putFloat("volume", currentVolume);
     prefs.end();
     
-    Logger.printf("💾 Saved volume: %.2f\n", currentVolume);
+    LOG_PRINTF(AUDIO, "💾 Saved volume: %.2f\n", currentVolume);
 }
 
 // ============================================================================
@@ -1043,7 +1546,7 @@ void ExtendedAudioPlayer::addDecoder(AudioDecoder& newDecoder, const char* mime,
     // Now wire the custom detection function so this MIME is active
     if (isMultiDecoder && ownedMultiDecoder) {
         ownedMultiDecoder->mimeDetector().setCheck(mime, check);
-        Logger.printf("🎵 Activated custom MIME detection for %s\n", mime);
+        LOG_PRINTF(AUDIO, "🎵 Activated custom MIME detection for %s\n", mime);
     }
 }
 
@@ -1055,7 +1558,7 @@ void ExtendedAudioPlayer::addDecoder(AudioDecoder& newDecoder, const char* mime)
         // Store MIME type so we can re-add it when converting to MultiDecoder
         strncpy(firstDecoderMime, mime, sizeof(firstDecoderMime) - 1);
         firstDecoderMime[sizeof(firstDecoderMime) - 1] = '\0';
-        Logger.printf("🎵 Added decoder for %s (first decoder)\n", mime);
+        LOG_PRINTF(AUDIO, "🎵 Added decoder for %s (first decoder)\n", mime);
         return;
     }
     
@@ -1063,7 +1566,7 @@ void ExtendedAudioPlayer::addDecoder(AudioDecoder& newDecoder, const char* mime)
     if (isMultiDecoder && ownedMultiDecoder) {
         // Already a MultiDecoder - just add to it
         ownedMultiDecoder->addDecoder(newDecoder, mime);
-        Logger.printf("🎵 Added decoder for %s (to existing MultiDecoder)\n", mime);
+        LOG_PRINTF(AUDIO, "🎵 Added decoder for %s (to existing MultiDecoder)\n", mime);
         return;
     }
     
@@ -1074,7 +1577,7 @@ void ExtendedAudioPlayer::addDecoder(AudioDecoder& newDecoder, const char* mime)
     // Re-add the existing decoder with its stored MIME type
     if (firstDecoderMime[0] != '\0') {
         ownedMultiDecoder->addDecoder(*decoder, firstDecoderMime);
-        Logger.printf("🎵 Re-added first decoder for %s to MultiDecoder\n", firstDecoderMime);
+        LOG_PRINTF(AUDIO, "🎵 Re-added first decoder for %s to MultiDecoder\n", firstDecoderMime);
     }
     
     // Add the new decoder
@@ -1087,5 +1590,5 @@ void ExtendedAudioPlayer::addDecoder(AudioDecoder& newDecoder, const char* mime)
         player->setDecoder(*decoder);
     if(encodedStream)
         encodedStream->setDecoder(decoder);
-    Logger.printf("🎵 Created MultiDecoder and added decoder for %s\n", mime);
+    LOG_PRINTF(AUDIO, "🎵 Created MultiDecoder and added decoder for %s\n", mime);
 }
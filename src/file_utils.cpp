@@ -80,6 +80,24 @@ bool urlToBaseFilename(const char* url, char* filename, const char* ext)
     return true;
 }
 
+/// Shard subdirectory of a filename (extension ignored), -1 when flat
+static int shardOf(const char* filename)
+{
+#if AUDIO_CACHE_SHARDS > 1
+    const char* dot = strrchr(filename, '.');
+    size_t len = dot ? (size_t)(dot - filename) : strlen(filename);
+    unsigned long hash = 5381;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash = ((hash << 5) + hash) + filename[i];
+    }
+    return (int)(hash & (AUDIO_CACHE_SHARDS - 1));
+#else
+    (void)filename;
+    return -1;
+#endif
+}
+
 bool getLocalPathForUrl(const char* url, char* localPath, const char* ext, const char* baseDir)
 {
     if (!url || !localPath)
@@ -97,6 +115,30 @@ bool getLocalPathForUrl(const char* url, char* localPath, const char* ext, const
         return false;
     }
     
+    int shard = shardOf(filename);
+    if (shard < 0)
+    {
+        snprintf(localPath, 128, "%s/%s", dir, filename);
+    }
+    else
+    {
+        snprintf(localPath, 128, "%s/%02x/%s", dir, shard, filename);
+    }
+    return true;
+}
+
+bool getUnshardedPathForUrl(const char* url, char* localPath, const char* ext, const char* baseDir)
+{
+    if (!url || !localPath)
+    {
+        return false;
+    }
+    const char* dir = (baseDir && strlen(baseDir) > 0) ? baseDir : AUDIO_FILES_DIR;
+    char filename[MAX_FILENAME_LENGTH];
+    if (!urlToBaseFilename(url, filename, ext))
+    {
+        return false;
+    }
     snprintf(localPath, 128, "%s/%s", dir, filename);
     return true;
 }
@@ -122,3 +164,16 @@ const char* asLocalPath(const char* path, const char* ext, const char* baseDir)
     // Already a local path, return as-is
     return path;
 }
+
+bool preallocateFile(fs::File& file, size_t size)
+{
+    if (!file || size == 0)
+    {
+        return false;
+    }
+    // Seeking past the end of a file open for writing extends it (FatFs
+    // f_lseek allocates the chain); the byte written makes the size stick
+    bool ok = file.seek(size - 1) && file.write((uint8_t)0) == 1;
+    file.flush();
+    return file.seek(0) && ok;
+}
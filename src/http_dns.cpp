@@ -0,0 +1,123 @@
+/**
+ * @file http_dns.cpp
+ * @brief Host name cache for HttpClient connections
+ *
+ * @date 2026
+ */
+
+#include "http_dns.h"
+#include "config.h"
+#include "logging.h"
+#include <WiFi.h>
+
+struct DnsEntry {
+    char host[64];
+    IPAddress ip;
+    unsigned long resolvedAt;
+};
+
+static DnsEntry dnsEntries[HTTP_DNS_CACHE_SIZE];
+static portMUX_TYPE dnsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Under dnsMux
+static DnsEntry* findEntry(const char* host) {
+    for (DnsEntry& e : dnsEntries) {
+        if (e.host[0] && strcmp(e.host, host) == 0) return &e;
+    }
+    return nullptr;
+}
+
+bool HttpDns::resolve(const char* host, IPAddress& ip) {
+    if (!host || !host[0]) return false;
+    if (ip.fromString(host)) return true;
+    if (strlen(host) >= sizeof(dnsEntries[0].host)) {
+        return WiFi.hostByName(host, ip) == 1;
+    }
+
+    unsigned long now = millis();
+    bool cached = false;
+    bool fresh = false;
+    IPAddress cachedIp;
+    portENTER_CRITICAL(&dnsMux);
+    DnsEntry* e = findEntry(host);
+    if (e) {
+        cached = true;
+        cachedIp = e->ip;
+        fresh = now - e->resolvedAt < HTTP_DNS_TTL_MS;
+    }
+    portEXIT_CRITICAL(&dnsMux);
+
+    if (fresh) {
+        ip = cachedIp;
+        return true;
+    }
+
+    // Look up outside the lock: it can block for seconds
+    IPAddress looked;
+    if (WiFi.hostByName(host, looked) != 1 || looked == IPAddress((uint32_t)0)) {
+        if (!cached) return false;
+        ip = cachedIp;  // Stale beats nothing
+        return true;
+    }
+
+    portENTER_CRITICAL(&dnsMux);
+    e = findEntry(host);
+    if (!e) {
+        // Empty slot, else the one resolved longest ago
+        e = &dnsEntries[0];
+        for (DnsEntry& cand : dnsEntries) {
+            if (!cand.host[0]) { e = &cand; break; }
+            if (now - cand.resolvedAt > now - e->resolvedAt) e = &cand;
+        }
+        strcpy(e->host, host);
+    }
+    e->ip = looked;
+    e->resolvedAt = now;
+    portEXIT_CRITICAL(&dnsMux);
+
+    ip = looked;
+    return true;
+}
+
+void HttpDns::forget(const char* host) {
+    portENTER_CRITICAL(&dnsMux);
+    DnsEntry* e = host ? findEntry(host) : nullptr;
+    if (e) e->host[0] = '\0';
+    portEXIT_CRITICAL(&dnsMux);
+}
+
+bool HttpDns::prefetch(const char* url) {
+    char host[sizeof(dnsEntries[0].host)];
+    uint16_t port;
+    IPAddress ip;
+    return urlHost(url, host, sizeof(host), port) && resolve(host, ip);
+}
+
+bool HttpDns::urlHost(const char* url, char* host, size_t cap, uint16_t& port) {
+    const char* start = url ? strstr(url, "://") : nullptr;
+    if (!start) return false;
+    start += 3;
+    size_t len = strcspn(start, ":/?#");
+    if (len == 0 || len >= cap) return false;
+    memcpy(host, start, len);
+    host[len] = '\0';
+    port = strncmp(url, "https", 5) == 0 ? 443 : 80;
+    if (start[len] == ':') port = (uint16_t)atoi(start + len + 1);
+    return true;
+}
+
+void HttpDns::printStatus() {
+    DnsEntry copy[HTTP_DNS_CACHE_SIZE];
+    portENTER_CRITICAL(&dnsMux);
+    memcpy(copy, dnsEntries, sizeof(copy));
+    portEXIT_CRITICAL(&dnsMux);
+
+    unsigned long now = millis();
+    Logger.println("🌐 DNS cache:");
+    for (const DnsEntry& e : copy) {
+        if (!e.host[0]) continue;
+        unsigned long age = (now - e.resolvedAt) / 1000;
+        Logger.printf("   %s → %s (%lus ago%s)\n", e.host, e.ip.toString().c_str(), age,
+                      now - e.resolvedAt >= HTTP_DNS_TTL_MS ? ", stale" : "");
+    }
+}
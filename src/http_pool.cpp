@@ -0,0 +1,147 @@
+/**
+ * @file http_pool.cpp
+ * @brief Keep-alive HttpClient connections shared by every subsystem
+ *
+ * @date 2026
+ */
+
+#include "http_pool.h"
+
+HttpPool httpPool;
+
+static portMUX_TYPE poolInitMux = portMUX_INITIALIZER_UNLOCKED;
+
+bool HttpPool::lock() {
+    // Created on first use: the first caller may be any task
+    if (!_lock) {
+        SemaphoreHandle_t m = xSemaphoreCreateMutex();
+        portENTER_CRITICAL(&poolInitMux);
+        if (!_lock) {
+            _lock = m;
+            m = nullptr;
+        }
+        portEXIT_CRITICAL(&poolInitMux);
+        if (m) vSemaphoreDelete(m);
+        if (!_lock) return false;
+    }
+    return xSemaphoreTake(_lock, portMAX_DELAY) == pdTRUE;
+}
+
+HttpClient* HttpPool::acquire(const char* url, int timeoutMs) {
+    if (!lock()) return nullptr;
+    unsigned long now = millis();
+    closeIdleLocked(now);
+
+    Entry* pick = nullptr;
+    bool warm = false;
+    for (Entry& e : _entries) {
+        if (e.http && !e.leased && e.http->connectedTo(url)) {
+            pick = &e;
+            warm = true;
+            break;
+        }
+    }
+    if (!pick) {
+        for (Entry& e : _entries) {
+            if (!e.http) { pick = &e; break; }
+        }
+    }
+    if (!pick) {
+        // Least recently used idle client gives up its connection
+        for (Entry& e : _entries) {
+            if (e.leased) continue;
+            if (!pick || now - e.idleSince > now - pick->idleSince) pick = &e;
+        }
+        if (pick) pick->http->close();
+    }
+    if (!pick) {
+        unlock();
+        return nullptr;
+    }
+
+    if (!pick->http) {
+        HttpClient* http = new HttpClient(timeoutMs);
+        http->useOwnSecure();
+        http->setKeepAlive(true);
+        const char* wantHeaders[] = {"Content-Type", "Content-Range", "ETag", "Last-Modified"};
+        http->collectHeaders(wantHeaders, 4);
+        pick->http = http;
+    }
+    pick->leased = true;
+    _leases++;
+    if (warm) _reused++;
+    HttpClient* http = pick->http;
+    unlock();
+
+    http->setTimeout(timeoutMs);
+    http->clearPersistentHeaders();
+    return http;
+}
+
+void HttpPool::release(HttpClient* http, bool keepConnection) {
+    if (!http) return;
+    if (keepConnection && http->reusable())
+        http->end();
+    else
+        http->close();
+
+    if (!lock()) return;
+    for (Entry& e : _entries) {
+        if (e.http == http) {
+            e.leased = false;
+            e.idleSince = millis();
+            unlock();
+            return;
+        }
+    }
+    unlock();
+    delete http;  // Not one of ours
+}
+
+bool HttpPool::hasIdle(const char* url) {
+    if (!lock()) return false;
+    bool found = false;
+    for (Entry& e : _entries) {
+        if (e.http && !e.leased && e.http->connectedTo(url)) {
+            found = true;
+            break;
+        }
+    }
+    unlock();
+    return found;
+}
+
+void HttpPool::closeIdle() {
+    if (!lock()) return;
+    closeIdleLocked(millis());
+    unlock();
+}
+
+void HttpPool::closeIdleLocked(unsigned long now) {
+    for (Entry& e : _entries) {
+        if (e.http && !e.leased && now - e.idleSince >= HTTP_POOL_IDLE_MS) {
+            delete e.http;  // Closes the connection, frees its TLS session
+            e.http = nullptr;
+        }
+    }
+}
+
+void HttpPool::printStatus() {
+    if (!lock()) return;
+    unsigned long now = millis();
+    Logger.printf("🔗 HTTP pool: %lu lease(s), %lu on a warm connection\n",
+                  (unsigned long)_leases, (unsigned long)_reused);
+    for (int i = 0; i < HTTP_POOL_SIZE; i++) {
+        Entry& e = _entries[i];
+        if (!e.http) {
+            Logger.printf("   %d: free\n", i);
+        } else if (e.leased) {
+            Logger.printf("   %d: leased\n", i);
+        } else {
+            Logger.printf("   %d: idle %lus%s\n", i, (now - e.idleSince) / 1000,
+                          e.http->connected() ? " (connection kept)" : "");
+        }
+    }
+    unlock();
+    HttpDns::printStatus();
+}
@@ -1,14 +1,52 @@
 #include "logging.h"
 #include <Arduino.h>
 #include <stdarg.h>
+#include <esp_system.h>
+
+static_assert((LOG_RING_BYTES & (LOG_RING_BYTES - 1)) == 0, "LOG_RING_BYTES must be a power of two");
+static_assert((LOG_QUEUE_BYTES & (LOG_QUEUE_BYTES - 1)) == 0, "LOG_QUEUE_BYTES must be a power of two");
+
+// The sink task fills the /logs ring while web handlers read it; records are
+// copied in and out under this lock, never formatted under it
+static portMUX_TYPE logRingMux = portMUX_INITIALIZER_UNLOCKED;
+
+#define LOG_RECORD_OVERHEAD (sizeof(uint32_t) + 2 * sizeof(uint16_t))
+#define LOG_QUEUED_OVERHEAD (sizeof(uint32_t) + sizeof(uint16_t))
 
 // Global logger instance
 LoggerClass Logger;
 
-LoggerClass::LoggerClass() : streamCount(0), logIndex(0), logCount(0), bufferPos(0), currentLogLevel(DEFAULT_LOG_LEVEL) {
-    messageBuffer[0] = '\0';
+static void ringCopyIn(uint8_t* ring, uint32_t ringSize, uint32_t offset, const void* data, size_t len) {
+    size_t at = offset & (ringSize - 1);
+    size_t first = min(len, (size_t)(ringSize - at));
+    memcpy(ring + at, data, first);
+    memcpy(ring, (const uint8_t*)data + first, len - first);
+}
+
+static void ringCopyOut(const uint8_t* ring, uint32_t ringSize, uint32_t offset, void* data, size_t len) {
+    size_t at = offset & (ringSize - 1);
+    size_t first = min(len, (size_t)(ringSize - at));
+    memcpy(data, ring + at, first);
+    memcpy((uint8_t*)data + first, ring, len - first);
+}
+
+// Lines still queued when something calls ESP.restart()
+static void flushLogsOnRestart() {
+    Logger.flush();
+}
+
+LoggerClass::LoggerClass() : streamCount(0), sinkTask(nullptr), sinkLock(nullptr), logHead(0), logTail(0), logCount(0), currentLogLevel(DEFAULT_LOG_LEVEL) {
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    for (int i = 0; i < LOG_PRODUCER_CORES; i++) {
+        queues[i].lock = unlocked;
+        queues[i].linePos = 0;
+        queues[i].head = 0;
+        queues[i].tail = 0;
+        queues[i].drops = 0;
+    }
     for (int i = 0; i < MAX_LOG_STREAMS; i++) {
         streams[i] = nullptr;
+        streamDrops[i] = 0;
     }
 }
 
@@ -19,73 +57,147 @@ bool LoggerClass::shouldFilterLine(const char* line) const {
     return strstr(line, "StreamCopy::copy") != nullptr;
 }
 
-void LoggerClass::flushBufferedLine() {
-    if (bufferPos <= 0) {
-        return;
+// ============================================================================
+// SINK TASK
+// ============================================================================
+
+bool LoggerClass::startSink() {
+    if (sinkTask) {
+        return true;
+    }
+    if (!sinkLock) sinkLock = xSemaphoreCreateMutex();
+    if (!sinkLock) {
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(sinkTaskMain, "LogSink", 4096, this,
+                                LOG_SINK_PRIORITY, &sinkTask, 1) != pdPASS) {
+        sinkTask = nullptr;
+        return false;
     }
+    esp_register_shutdown_handler(flushLogsOnRestart);
+    return true;
+}
 
-    messageBuffer[bufferPos] = '\0';
-    if (shouldFilterLine(messageBuffer)) {
-        bufferPos = 0;
-        messageBuffer[0] = '\0';
-        return;
+void LoggerClass::sinkTaskMain(void* arg) {
+    LoggerClass* self = (LoggerClass*)arg;
+    for (;;) {
+        // Woken per queued line; the timeout catches lines queued before
+        // the task existed
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        xSemaphoreTake(self->sinkLock, portMAX_DELAY);
+        while (self->drainOne()) {
+        }
+        xSemaphoreGive(self->sinkLock);
+    }
+}
+
+// Write out the oldest queued line of either core. Caller holds sinkLock.
+bool LoggerClass::drainOne() {
+    LineQueue* oldest = nullptr;
+    uint32_t oldestMs = 0;
+    for (int i = 0; i < LOG_PRODUCER_CORES; i++) {
+        LineQueue& q = queues[i];
+        if (q.head == q.tail) {
+            continue;
+        }
+        uint32_t ms;
+        ringCopyOut(q.bytes, LOG_QUEUE_BYTES, q.tail, &ms, sizeof(ms));
+        if (!oldest || (int32_t)(ms - oldestMs) < 0) {
+            oldest = &q;
+            oldestMs = ms;
+        }
+    }
+    if (!oldest) {
+        return false;
     }
+    uint16_t len;
+    ringCopyOut(oldest->bytes, LOG_QUEUE_BYTES, oldest->tail + sizeof(uint32_t), &len, sizeof(len));
+    ringCopyOut(oldest->bytes, LOG_QUEUE_BYTES, oldest->tail + LOG_QUEUED_OVERHEAD, sinkLine, len);
+    oldest->tail += LOG_QUEUED_OVERHEAD + len;
+    emitLine(oldestMs, sinkLine, len);
+    return true;
+}
 
+void LoggerClass::emitLine(uint32_t ms, const char* text, size_t len) {
     for (int i = 0; i < streamCount; i++) {
         if (streams[i]) {
-            streams[i]->write((const uint8_t*)messageBuffer, bufferPos);
-            streams[i]->write('\n');
+            size_t n = streams[i]->write((const uint8_t*)text, len);
+            n += streams[i]->write('\n');
+            if (n < len + 1) streamDrops[i]++;
         }
     }
+    addMessageToBuffer(ms, text, len);
+}
 
-    String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-    addMessageToBuffer(timestampedMessage);
-
-    bufferPos = 0;
-    messageBuffer[0] = '\0';
+void LoggerClass::flush() {
+    if (!sinkLock || xSemaphoreTake(sinkLock, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return;
+    }
+    while (drainOne()) {
+    }
+    xSemaphoreGive(sinkLock);
 }
 
 void LoggerClass::addLogger(Print& print) {
+    startSink();
+    if (sinkLock) xSemaphoreTake(sinkLock, portMAX_DELAY);
     if (streamCount < MAX_LOG_STREAMS) {
+        streamDrops[streamCount] = 0;
         streams[streamCount++] = &print;
     }
+    if (sinkLock) xSemaphoreGive(sinkLock);
 }
 
 void LoggerClass::removeLogger(Print& print) {
+    // Not while the sink is part way through writing to it
+    if (sinkLock) xSemaphoreTake(sinkLock, portMAX_DELAY);
     for (int i = 0; i < streamCount; i++) {
         if (streams[i] == &print) {
             // Shift remaining streams down
             for (int j = i; j < streamCount - 1; j++) {
                 streams[j] = streams[j + 1];
+                streamDrops[j] = streamDrops[j + 1];
             }
             streams[streamCount - 1] = nullptr;
             streamCount--;
             break;
         }
     }
+    if (sinkLock) xSemaphoreGive(sinkLock);
 }
 
-size_t LoggerClass::write(uint8_t byte) {
-    // Don't write anything if log level is QUIET
-    if (currentLogLevel == LOG_QUIET) {
-        return 1; // Pretend we wrote it
-    }
+// ============================================================================
+// PRODUCERS
+// ============================================================================
 
-    if (byte == '\n' || byte == '\r') {
-        flushBufferedLine();
-        return 1;
+// Move the assembled line into the queue. Caller holds q.lock.
+bool LoggerClass::queueLine(LineQueue& q) {
+    if (q.linePos <= 0) {
+        return false;
+    }
+    size_t len = q.linePos;
+    q.linePos = 0;
+    q.line[len] = '\0';
+    if (shouldFilterLine(q.line)) {
+        return false;
     }
 
-    if (bufferPos < MAX_LOG_MESSAGE_LENGTH - 1) {
-        messageBuffer[bufferPos++] = (char)byte;
-    } else {
-        // Prevent overrun by flushing the current line fragment first.
-        flushBufferedLine();
-        messageBuffer[bufferPos++] = (char)byte;
+    uint32_t need = LOG_QUEUED_OVERHEAD + len;
+    if (LOG_QUEUE_BYTES - (q.head - q.tail) < need) {
+        q.drops++;  // The sink is behind; never wait for it here
+        return false;
     }
-    messageBuffer[bufferPos] = '\0';
+    uint32_t ms = millis();
+    uint16_t len16 = (uint16_t)len;
+    ringCopyIn(q.bytes, LOG_QUEUE_BYTES, q.head, &ms, sizeof(ms));
+    ringCopyIn(q.bytes, LOG_QUEUE_BYTES, q.head + sizeof(ms), &len16, sizeof(len16));
+    ringCopyIn(q.bytes, LOG_QUEUE_BYTES, q.head + LOG_QUEUED_OVERHEAD, q.line, len);
+    q.head += need;  // Publish after the bytes are in place
+    return true;
+}
 
-    return 1;
+size_t LoggerClass::write(uint8_t byte) {
+    return write(&byte, 1);
 }
 
 size_t LoggerClass::write(const uint8_t* buffer, size_t size) {
@@ -94,10 +206,26 @@ size_t LoggerClass::write(const uint8_t* buffer, size_t size) {
         return size; // Pretend we wrote it
     }
 
+    LineQueue& q = queues[xPortGetCoreID()];
+    bool queued = false;
+    portENTER_CRITICAL(&q.lock);
     for (size_t i = 0; i < size; i++) {
-        write(buffer[i]);
+        char c = (char)buffer[i];
+        if (c == '\n' || c == '\r') {
+            queued |= queueLine(q);
+            continue;
+        }
+        if (q.linePos >= MAX_LOG_MESSAGE_LENGTH - 1) {
+            // Prevent overrun by queueing the current line fragment first.
+            queued |= queueLine(q);
+        }
+        q.line[q.linePos++] = c;
     }
+    portEXIT_CRITICAL(&q.lock);
 
+    if (queued && sinkTask) {
+        xTaskNotifyGive(sinkTask);
+    }
     return size;
 }
 
@@ -134,20 +262,141 @@ void LoggerClass::debugf(const char* format, ...) {
     }
 }
 
-void LoggerClass::addMessageToBuffer(const String& message) {
-    logBuffer[logIndex] = message;
-    logIndex = (logIndex + 1) % LOG_BUFFER_SIZE;
-    
-    if (logCount < LOG_BUFFER_SIZE) {
-        logCount++;
+// ============================================================================
+// BINARY RECORDS
+// ============================================================================
+
+void LoggerClass::writeRecord(uint32_t formatId, const LogArgs& args) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char line[12 + (LOG_RECORD_ARG_BYTES + 2) / 3 * 4 + 2];
+    int n = snprintf(line, sizeof(line), "~%08lx:", (unsigned long)formatId);
+    for (size_t i = 0; i < args.len; i += 3) {
+        uint32_t v = (uint32_t)args.bytes[i] << 16;
+        if (i + 1 < args.len) v |= (uint32_t)args.bytes[i + 1] << 8;
+        if (i + 2 < args.len) v |= args.bytes[i + 2];
+        line[n++] = alphabet[(v >> 18) & 63];
+        line[n++] = alphabet[(v >> 12) & 63];
+        line[n++] = i + 1 < args.len ? alphabet[(v >> 6) & 63] : '=';
+        line[n++] = i + 2 < args.len ? alphabet[v & 63] : '=';
+    }
+    line[n++] = '\n';
+    write((const uint8_t*)line, n);
+}
+
+// ============================================================================
+// LOG RING
+// ============================================================================
+
+void LoggerClass::addMessageToBuffer(uint32_t ms, const char* text, size_t len) {
+    if (len > MAX_LOG_MESSAGE_LENGTH - 1) {
+        len = MAX_LOG_MESSAGE_LENGTH - 1;
+    }
+    uint16_t len16 = (uint16_t)len;
+    uint32_t need = LOG_RECORD_OVERHEAD + len;
+
+    portENTER_CRITICAL(&logRingMux);
+    // Drop the oldest lines until the new one fits
+    while (logHead - logTail + need > LOG_RING_BYTES) {
+        uint16_t oldLen;
+        ringCopyOut(logRing, LOG_RING_BYTES, logTail + sizeof(uint32_t), &oldLen, sizeof(oldLen));
+        logTail += LOG_RECORD_OVERHEAD + oldLen;
+        logCount--;
+    }
+    ringCopyIn(logRing, LOG_RING_BYTES, logHead, &ms, sizeof(ms));
+    ringCopyIn(logRing, LOG_RING_BYTES, logHead + sizeof(ms), &len16, sizeof(len16));
+    ringCopyIn(logRing, LOG_RING_BYTES, logHead + sizeof(ms) + sizeof(len16), text, len);
+    ringCopyIn(logRing, LOG_RING_BYTES, logHead + need - sizeof(len16), &len16, sizeof(len16));
+    logHead += need;
+    logCount++;
+    portEXIT_CRITICAL(&logRingMux);
+}
+
+// Copy out the record that ends at @p end and step @p end back to its start.
+// False once the walk reaches lines that were dropped (or there are none).
+bool LoggerClass::readRecordBefore(uint32_t& end, uint32_t& ms, char* text, size_t& len) {
+    bool ok = false;
+    portENTER_CRITICAL(&logRingMux);
+    if ((int32_t)(end - logTail) >= (int32_t)LOG_RECORD_OVERHEAD && (int32_t)(logHead - end) >= 0) {
+        uint16_t len16;
+        ringCopyOut(logRing, LOG_RING_BYTES, end - sizeof(len16), &len16, sizeof(len16));
+        uint32_t start = end - LOG_RECORD_OVERHEAD - len16;
+        if ((int32_t)(start - logTail) >= 0) {
+            ringCopyOut(logRing, LOG_RING_BYTES, start, &ms, sizeof(ms));
+            ringCopyOut(logRing, LOG_RING_BYTES, start + sizeof(ms) + sizeof(len16), text, len16);
+            len = len16;
+            end = start;
+            ok = true;
+        }
+    }
+    portEXIT_CRITICAL(&logRingMux);
+    return ok;
+}
+
+// Copy out the record that starts at @p start and step @p start past it.
+// A cursor that no longer points at a kept record (its lines were dropped,
+// the ring was cleared, or it's LOG_CURSOR_OLDEST) restarts at the oldest
+// line and sets @p skipped. False once @p start reaches the newest line.
+bool LoggerClass::readRecordAt(uint32_t& start, uint32_t& ms, char* text, size_t& len, bool& skipped) {
+    bool ok = false;
+    portENTER_CRITICAL(&logRingMux);
+    for (int attempt = 0; attempt < 2 && !ok; attempt++) {
+        if ((int32_t)(start - logTail) < 0 || (int32_t)(logHead - start) < 0) {
+            start = logTail;
+            skipped = true;
+        }
+        if (start == logHead) {
+            break;
+        }
+        uint16_t len16, trailer = 0;
+        ringCopyOut(logRing, LOG_RING_BYTES, start + sizeof(ms), &len16, sizeof(len16));
+        uint32_t end = start + LOG_RECORD_OVERHEAD + len16;
+        if ((int32_t)(logHead - end) >= 0) {
+            ringCopyOut(logRing, LOG_RING_BYTES, end - sizeof(trailer), &trailer, sizeof(trailer));
+        }
+        if ((int32_t)(logHead - end) < 0 || trailer != len16) {
+            start = logTail - 1;  // Not a record boundary: out of range, so retry from the oldest
+            continue;
+        }
+        ringCopyOut(logRing, LOG_RING_BYTES, start, &ms, sizeof(ms));
+        ringCopyOut(logRing, LOG_RING_BYTES, start + sizeof(ms) + sizeof(len16), text, len16);
+        len = len16;
+        start = end;
+        ok = true;
     }
+    portEXIT_CRITICAL(&logRingMux);
+    return ok;
 }
 
-String LoggerClass::getLogsAsHtml() {
-    String html = R"(
+// Text of a log line, escaped for an HTML body or a JSON string
+static void printEscaped(Print& out, const char* text, size_t len, bool json) {
+    size_t run = 0;  // Unescaped bytes waiting to be written in one go
+    for (size_t i = 0; i < len; i++) {
+        const char* esc = nullptr;
+        char c = text[i];
+        if (json) {
+            if (c == '"') esc = "\\\"";
+            else if (c == '\\') esc = "\\\\";
+            else if ((uint8_t)c < 0x20) esc = " ";  // Tabs and stray control bytes
+        } else {
+            if (c == '<') esc = "&lt;";
+            else if (c == '>') esc = "&gt;";
+            else if (c == '&') esc = "&amp;";
+        }
+        if (!esc) {
+            run++;
+            continue;
+        }
+        out.write((const uint8_t*)text + i - run, run);
+        run = 0;
+        out.print(esc);
+    }
+    out.write((const uint8_t*)text + len - run, run);
+}
+
+void LoggerClass::printLogsAsHtml(Print& out) {
+    out.print(R"(
 <!DOCTYPE html><html><head><title>System Logs</title>
 <meta name="viewport" content="width=device-width,initial-scale=1">
-<meta http-equiv="refresh" content="5">
 <style>
 body{font-family:monospace;margin:10px;background:#000;color:#0f0}
 .header{background:#333;color:#fff;padding:10px;margin-bottom:10px;border-radius:3px}
@@ -160,56 +409,98 @@ body{font-family:monospace;margin:10px;background:#000;color:#0f0}
 <div class="nav">
 <a href="/">🏠 Home</a> | <a href="/logs">🔄 Refresh</a>
 </div>
-<div class="stats">Total Messages: )";
-
-    html += String(logCount);
-    html += " | Buffer: " + String(LOG_BUFFER_SIZE) + " | Free RAM: " + String(ESP.getFreeHeap()) + " bytes</div>";
-    
-    // Add log messages (newest first)
-    if (logCount > 0) {
-        int start = logCount < LOG_BUFFER_SIZE ? 0 : logIndex;
-        for (int i = 0; i < logCount; i++) {
-            int idx = (start + logCount - 1 - i) % LOG_BUFFER_SIZE;
-            html += "<div class='log'>" + logBuffer[idx] + "</div>";
-        }
-    } else {
-        html += "<div class='log'>No log messages yet...</div>";
-    }
-    
-    html += "</body></html>";
-    return html;
-}
-
-String LoggerClass::getLogsAsJson() {
-    String json = "{\"logs\":[";
-    
-    if (logCount > 0) {
-        int start = logCount < LOG_BUFFER_SIZE ? 0 : logIndex;
-        for (int i = 0; i < logCount; i++) {
-            int idx = (start + logCount - 1 - i) % LOG_BUFFER_SIZE;
-            if (i > 0) json += ",";
-            json += "\"" + logBuffer[idx] + "\"";
-        }
+<div class="stats">Total Messages: )");
+    out.printf("%d | Buffer: %u bytes | Free RAM: %u bytes</div><div id='logs'>", logCount,
+               (unsigned)LOG_RING_BYTES, (unsigned)ESP.getFreeHeap());
+
+    // Newest first; the page then polls /api/logs from this cursor
+    char text[MAX_LOG_MESSAGE_LENGTH];
+    portENTER_CRITICAL(&logRingMux);
+    uint32_t cursor = logHead;
+    portEXIT_CRITICAL(&logRingMux);
+    uint32_t end = cursor;
+    uint32_t ms;
+    size_t len;
+    int shown = 0;
+    while (readRecordBefore(end, ms, text, len)) {
+        out.printf("<div class='log'>%lums: ", (unsigned long)ms);
+        printEscaped(out, text, len, false);
+        out.print("</div>");
+        shown++;
+    }
+    if (shown == 0) {
+        out.print("<div class='log'>No log messages yet...</div>");
     }
-    
-    json += "],\"count\":" + String(logCount) + ",\"freeRam\":" + String(ESP.getFreeHeap()) + "}";
-    return json;
+
+    out.printf(R"(</div><script>
+let next=%lu;
+setInterval(()=>fetch('/api/logs?since='+next).then(r=>r.json()).then(d=>{
+next=d.next;const box=document.getElementById('logs');
+d.logs.forEach(l=>{const e=document.createElement('div');e.className='log';e.textContent=l;box.prepend(e);});
+}).catch(()=>{}),2000);
+</script></body></html>)", (unsigned long)cursor);
+}
+
+void LoggerClass::printLogsAsJson(Print& out, uint32_t since) {
+    out.print("{\"logs\":[");
+
+    char text[MAX_LOG_MESSAGE_LENGTH];
+    uint32_t start = since;
+    uint32_t ms;
+    size_t len;
+    int shown = 0;
+    bool skipped = false;
+    while (readRecordAt(start, ms, text, len, skipped)) {
+        out.printf("%s\"%lums: ", shown > 0 ? "," : "", (unsigned long)ms);
+        printEscaped(out, text, len, true);
+        out.print("\"");
+        shown++;
+    }
+    if (since == LOG_CURSOR_OLDEST) {
+        skipped = false;
+    }
+
+    // "skipped": lines between the cursor and the first one shown were dropped
+    out.printf("],\"count\":%d,\"next\":%lu,\"skipped\":%s,\"freeRam\":%u}", shown,
+               (unsigned long)start, skipped ? "true" : "false", (unsigned)ESP.getFreeHeap());
 }
 
 void LoggerClass::clearLogs() {
-    logIndex = 0;
+    portENTER_CRITICAL(&logRingMux);
+    logHead = 0;
+    logTail = 0;
     logCount = 0;
-    bufferPos = 0;
-    messageBuffer[0] = '\0';
+    portEXIT_CRITICAL(&logRingMux);
+}
+
+void LoggerClass::printStats() {
+    uint32_t queued[LOG_PRODUCER_CORES], drops[LOG_PRODUCER_CORES];
+    for (int i = 0; i < LOG_PRODUCER_CORES; i++) {
+        queued[i] = queues[i].head - queues[i].tail;
+        drops[i] = queues[i].drops;
+    }
+    printf("📜 Log sink: %s, %d stream(s)\n", sinkTask ? "running" : "not started", streamCount);
+    for (int i = 0; i < LOG_PRODUCER_CORES; i++) {
+        printf("   Core %d queue: %u/%u bytes, %u line(s) dropped\n", i, (unsigned)queued[i],
+               (unsigned)LOG_QUEUE_BYTES, (unsigned)drops[i]);
+    }
+    for (int i = 0; i < streamCount; i++) {
+        printf("   Stream %d: %u short write(s)\n", i, (unsigned)streamDrops[i]);
+    }
 }
 
 void LoggerClass::writeRaw(const char* data, size_t len) {
-    // Write directly to all output streams, bypass log buffer entirely
+    // Write directly to all output streams, bypass log buffer entirely;
+    // queued lines go first so the dump isn't interleaved with them
+    if (sinkLock) xSemaphoreTake(sinkLock, portMAX_DELAY);
+    while (drainOne()) {
+    }
     for (int i = 0; i < streamCount; i++) {
         if (streams[i]) {
             streams[i]->write((const uint8_t*)data, len);
         }
     }
+    if (sinkLock) xSemaphoreGive(sinkLock);
 }
 
 void LoggerClass::writeRawLine(const char* line) {
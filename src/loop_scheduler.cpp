@@ -0,0 +1,123 @@
+/**
+ * @file loop_scheduler.cpp
+ * @brief Deadline scheduler for the maintenance work in loop()
+ *
+ * @date 2026
+ */
+
+#include "loop_scheduler.h"
+#include "logging.h"
+
+LoopScheduler loopScheduler;
+
+bool LoopScheduler::add(const char* name, Tick tick, uint32_t periodMs, uint8_t priority, uint32_t budgetUs)
+{
+    if (_count >= LOOP_SCHED_MAX_JOBS || !tick) {
+        Logger.printf("❌ [SCHED] Can't add job %s\n", name ? name : "?");
+        return false;
+    }
+    // Insertion keeps the table in priority order; equal priorities keep
+    // registration order
+    int at = _count;
+    while (at > 0 && _jobs[at - 1].priority > priority) {
+        _jobs[at] = _jobs[at - 1];
+        at--;
+    }
+    _jobs[at] = Job{};
+    _jobs[at].name = name;
+    _jobs[at].tick = tick;
+    _jobs[at].periodMs = periodMs;
+    _jobs[at].budgetUs = budgetUs;
+    _jobs[at].priority = priority;
+    _jobs[at].lastRunMs = millis();
+    _count++;
+    return true;
+}
+
+void LoopScheduler::run(uint32_t sliceUs)
+{
+    uint32_t startUs = micros();
+    unsigned long now = millis();
+
+    for (int i = 0; i < _count; i++) {
+        Job& job = _jobs[i];
+        if (now - job.lastRunMs < job.periodMs) {
+            continue;
+        }
+        if (_preempt && _preempt()) {
+            break;
+        }
+
+        uint32_t usedUs = micros() - startUs;
+        uint32_t leftUs = usedUs < sliceUs ? sliceUs - usedUs : 0;
+        uint32_t expectUs = max(job.budgetUs, job.avgUs);
+        bool forced = job.dueSinceMs != 0 && now - job.dueSinceMs >= LOOP_SCHED_MAX_DEFER_MS;
+        if (expectUs > leftUs && !forced) {
+            if (job.dueSinceMs == 0) job.dueSinceMs = now;
+            job.deferred++;
+            continue;
+        }
+
+        uint32_t t0 = micros();
+        job.tick();
+        uint32_t us = micros() - t0;
+
+        job.lastRunMs = now;
+        job.dueSinceMs = 0;
+        job.runs++;
+        if (forced) job.forced++;
+        job.avgUs = job.runs == 1 ? us : job.avgUs - job.avgUs / 8 + us / 8;
+        if (us > job.maxUs) job.maxUs = us;
+        if (us > job.budgetUs) job.overruns++;
+    }
+
+#if LOOP_SCHED_REPORT_MS > 0
+    if (now - _lastReportMs >= LOOP_SCHED_REPORT_MS) {
+        report(now);
+    }
+#endif
+}
+
+// One line per job that overran since the last report
+void LoopScheduler::report(unsigned long now)
+{
+    _lastReportMs = now;
+    for (int i = 0; i < _count; i++) {
+        Job& job = _jobs[i];
+        uint32_t fresh = job.overruns - job.reportedOverruns;
+        if (fresh == 0) continue;
+        job.reportedOverruns = job.overruns;
+        Logger.printf("⚠️ [SCHED] %s: %lu overruns of %lu us (avg %lu us, max %lu us)\n",
+                      job.name, (unsigned long)fresh, (unsigned long)job.budgetUs,
+                      (unsigned long)job.avgUs, (unsigned long)job.maxUs);
+    }
+}
+
+void LoopScheduler::printStatus()
+{
+    Logger.printf("⏱️ Loop scheduler: %d jobs, slice %u us (audio) / %u us (idle)\n",
+                  _count, (unsigned)LOOP_AUDIO_SLICE_US, (unsigned)LOOP_IDLE_SLICE_US);
+    Logger.println("   job          prio period budget    avg    max     runs  over defer forced");
+    for (int i = 0; i < _count; i++) {
+        const Job& job = _jobs[i];
+        Logger.printf("   %-12s %4u %5lums %5luus %5luus %5luus %8lu %5lu %5lu %6lu\n",
+                      job.name, job.priority, (unsigned long)job.periodMs,
+                      (unsigned long)job.budgetUs, (unsigned long)job.avgUs,
+                      (unsigned long)job.maxUs, (unsigned long)job.runs,
+                      (unsigned long)job.overruns, (unsigned long)job.deferred,
+                      (unsigned long)job.forced);
+    }
+}
+
+void LoopScheduler::resetStats()
+{
+    for (int i = 0; i < _count; i++) {
+        Job& job = _jobs[i];
+        job.maxUs = 0;
+        job.runs = 0;
+        job.overruns = 0;
+        job.reportedOverruns = 0;
+        job.deferred = 0;
+        job.forced = 0;
+    }
+}
@@ -0,0 +1,134 @@
+#include "lz4_block.h"
+#include <string.h>
+
+#define LZ4_HASH_BITS   11
+#define LZ4_MIN_MATCH   4
+#define LZ4_MF_LIMIT    12   // A match must start this far from the end
+#define LZ4_LAST_LITERALS 5  // ... and end this far from it
+
+static uint32_t read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Length beyond the 4-bit token field: 255s then the remainder
+static bool putLength(uint8_t* dst, size_t& op, size_t dstCap, size_t len)
+{
+    while (len >= 255) {
+        if (op >= dstCap) return false;
+        dst[op++] = 255;
+        len -= 255;
+    }
+    if (op >= dstCap) return false;
+    dst[op++] = (uint8_t)len;
+    return true;
+}
+
+static bool putSequence(uint8_t* dst, size_t& op, size_t dstCap,
+                        const uint8_t* literals, size_t litLen,
+                        size_t offset, size_t matchLen)
+{
+    if (op >= dstCap) return false;
+    size_t tokenAt = op++;
+    uint8_t token = (uint8_t)((litLen >= 15 ? 15 : litLen) << 4);
+    if (litLen >= 15 && !putLength(dst, op, dstCap, litLen - 15)) return false;
+    if (op + litLen > dstCap) return false;
+    memcpy(dst + op, literals, litLen);
+    op += litLen;
+
+    if (matchLen > 0) {
+        if (op + 2 > dstCap) return false;
+        dst[op++] = (uint8_t)offset;
+        dst[op++] = (uint8_t)(offset >> 8);
+        size_t extra = matchLen - LZ4_MIN_MATCH;
+        token |= (uint8_t)(extra >= 15 ? 15 : extra);
+        if (extra >= 15 && !putLength(dst, op, dstCap, extra - 15)) return false;
+    }
+    dst[tokenAt] = token;
+    return true;
+}
+
+size_t lz4BlockCompress(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstCap)
+{
+    static uint16_t table[1 << LZ4_HASH_BITS];
+
+    size_t op = 0;
+    size_t anchor = 0;
+    if (srcLen > 0xFFFF) {
+        return 0;
+    }
+    if (srcLen > LZ4_MF_LIMIT) {
+        memset(table, 0, sizeof(table));
+        size_t limit = srcLen - LZ4_MF_LIMIT;
+        size_t matchEnd = srcLen - LZ4_LAST_LITERALS;
+        size_t ip = 0;
+        while (ip < limit) {
+            uint32_t seq = read32(src + ip);
+            uint32_t h = (seq * 2654435761u) >> (32 - LZ4_HASH_BITS);
+            size_t ref = table[h];
+            table[h] = (uint16_t)ip;
+            if (ref >= ip || read32(src + ref) != seq) {
+                ip++;
+                continue;
+            }
+            size_t len = LZ4_MIN_MATCH;
+            while (ip + len < matchEnd && src[ref + len] == src[ip + len]) {
+                len++;
+            }
+            if (!putSequence(dst, op, dstCap, src + anchor, ip - anchor, ip - ref, len)) {
+                return 0;
+            }
+            ip += len;
+            anchor = ip;
+        }
+    }
+    if (!putSequence(dst, op, dstCap, src + anchor, srcLen - anchor, 0, 0)) {
+        return 0;
+    }
+    return op;
+}
+
+int lz4BlockDecompress(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstCap)
+{
+    size_t ip = 0, op = 0;
+    while (ip < srcLen) {
+        uint8_t token = src[ip++];
+        size_t litLen = token >> 4;
+        if (litLen == 15) {
+            uint8_t b;
+            do {
+                if (ip >= srcLen) return -1;
+                b = src[ip++];
+                litLen += b;
+            } while (b == 255);
+        }
+        if (ip + litLen > srcLen || op + litLen > dstCap) return -1;
+        memcpy(dst + op, src + ip, litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip >= srcLen) {
+            break;  // Last sequence is literals only
+        }
+
+        if (ip + 2 > srcLen) return -1;
+        size_t offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        size_t matchLen = (token & 15) + LZ4_MIN_MATCH;
+        if ((token & 15) == 15) {
+            uint8_t b;
+            do {
+                if (ip >= srcLen) return -1;
+                b = src[ip++];
+                matchLen += b;
+            } while (b == 255);
+        }
+        if (offset == 0 || offset > op || op + matchLen > dstCap) return -1;
+        // Byte by byte: the match may overlap what it's producing
+        for (size_t i = 0; i < matchLen; i++, op++) {
+            dst[op] = dst[op - offset];
+        }
+    }
+    return (int)op;
+}
@@ -31,20 +31,35 @@
 #include <SD.h>
 #include "tone_generators.h"
 #include "crash_counter.h"
+#include "boot_pipeline.h"
+#include "decoder_pool.h"
+#include "ota_updater.h"
+#include "loop_scheduler.h"
+#include "power_manager.h"
+#include "tunables.h"
+#include "capture_stream.h"
+#include "metrics.h"
+#include "audio_output_task.h"
 
 AudioBoardStream kit(AudioKitEs8388V1); // Audio source
 AudioSource *source = nullptr;          // to be initialized in setup()
-MultiDecoder multi_decoder;
-MP3DecoderHelix mp3_decoder;
-WAVDecoder wav_decoder;
-AACDecoderHelix aac_decoder;       // Decodes AAC frames extracted from M4A
+// Decoders are built on first use and freed when idle (decoder_pool.h)
+LazyDecoder mp3_decoder(LazyDecoder::make<MP3DecoderHelix>, sizeof(MP3DecoderHelix), "mp3");
+LazyDecoder wav_decoder(LazyDecoder::make<WAVDecoder>, sizeof(WAVDecoder), "wav");
+// Decodes AAC frames extracted from M4A
+LazyDecoder aac_decoder(LazyDecoder::make<AACDecoderHelix>, sizeof(AACDecoderHelix), "aac");
 MultiDecoder m4a_inner_decoder;    // Routes demuxed AAC frames to aac_decoder
-ContainerM4A m4a_decoder;          // Demuxes M4A/MP4 container
+// Demuxes M4A/MP4 container into m4a_inner_decoder
+LazyDecoder m4a_decoder([](void* mem) -> AudioDecoder* {
+    ContainerM4A* container = new (mem) ContainerM4A();
+    container->setDecoder(m4a_inner_decoder);
+    return container;
+}, sizeof(ContainerM4A), "m4a");
 ExtendedAudioPlayer& audioPlayer = getExtendedAudioPlayer();
 AudioKeyRegistry& audioKeyRegistry = getAudioKeyRegistry();
 // Goertzel-based DTMF detection (more efficient during dial tone)
-GoertzelStream goertzel;                // Goertzel detector
-StreamCopy goertzelCopier(goertzel, kit); // copy mic to Goertzel
+DtmfGoertzelStream goertzel;            // 8-bin fixed-point Goertzel detector
+StreamCopy goertzelCopier(goertzel, getGoertzelMicReader()); // mic ring → Goertzel
 
 // Key pins for AudioKit board (active LOW)
 // These may conflict with other functions depending on DIP switch settings
@@ -60,10 +75,173 @@ static bool audioKitInitialized = false;
 
 // DTMF sequence checking moved to sequence_processor.cpp
 
+// Set by the WiFi-connected callback while the SD catalog isn't loaded yet
+static bool catalogDownloadWanted = false;
+
+// Initialize AudioKit FIRST with sd_active=false
+// This prevents AudioKit from interfering with our SPI SD card pins
+static bool initAudioKit()
+{
+    Logger.println("🔧 Initializing AudioKit (RXTX_MODE)...");
+    auto cfg = kit.defaultConfig(RXTX_MODE);
+    cfg.setAudioInfo(AUDIO_INFO_DEFAULT());
+    // Configure input device - can be set via build flags
+#ifdef AUDIO_INPUT_DEVICE
+    cfg.input_device = AUDIO_INPUT_DEVICE;
+#else
+    cfg.input_device = ADC_INPUT_ALL; // Default: both microphone and line in
+#endif
+
+    cfg.sd_active = false; // SD card initialized manually in setup()
+    if (!kit.begin(cfg))
+    {
+        Logger.println("❌ Failed to initialize AudioKit");
+        audioKitInitialized = false;
+        return false;
+    }
+    Logger.println("✅ AudioKit initialized successfully");
+    audioKitInitialized = true;
+    
+    // Set input volume/gain for DTMF detection
+    // Volume range is 0-100 (percentage)
+    kit.setInputVolume(AUDIOKIT_INPUT_VOLUME);
+    Logger.printf("🔊 Input volume set to %d%%\n", AUDIOKIT_INPUT_VOLUME);
+
+    // Single reader of the codec RX path; Goertzel and capture read the ring
+    startMicCapture(kit);
+    return true;
+}
+
+// Initialize Phone Service and its hook handling
+static bool startPhone()
+{
+    Phone.begin();
+    // Background OTA writes flash and reboots only while nobody is using the phone
+    otaUpdater.setBusyCheck([]() {
+        return Phone.isOffHook() || Phone.isRinging() || audioPlayer.isActive();
+    });
+    // A tunable that restarts the Goertzel task waits for the handset to go down
+    tunables.setBusyCheck([]() { return Phone.isOffHook(); });
+    // On-hook and idle: codec, mic and I2S off, CPU scaled down
+    powerManager.setIdleCheck([]() {
+        return audioKitInitialized && bootPipeline.done(BootStage::CATALOG)
+            && !Phone.isOffHook() && !Phone.isRinging() && !audioPlayer.isActive()
+            && !isReadingSequence() && !otaUpdater.active()
+            && !captureStream.clientConnected();
+    });
+    powerManager.begin(kit);
+    // Rotary dial pulses on the hook line (HOOK_PULSE_DIAL) dial like DTMF
+    Phone.setPulseDigitCallback([](char digit) { addDtmfDigit(digit); });
+    Phone.setHookCallback([](bool isOffHook) {
+        if (isOffHook) {
+            // Handle off-hook event
+            Logger.println("📞 Phone picked up (OFF HOOK)");
+            powerManager.wake();                // Codec live before the dial tone
+            setAudioDownloadsSuspended(true);   // Keep the network and SD for the call
+            // Check if debugaudio command has armed a capture for this off-hook
+            if (checkAndExecuteOffHookCapture()) {
+                // Capture was triggered, skip normal dial tone for now
+                // (capture function will handle audio)
+                return;
+            }
+            Logger.println("⚡ Playing Dial Tone");
+            audioPlayer.playAudioKeyFast("dialtone");
+        } else {
+            // Handle on-hook event
+            Logger.println("📞 Phone hung up (ON HOOK)");
+            audioPlayer.stop();
+            resetDTMFSequence(); // Clear any partial DTMF sequence
+            setAudioDownloadsSuspended(false);
+        }
+    });
+    return true;
+}
+
+// WiFi-connected callback. Until the SD catalog is in the registry the
+// download waits for tickBootStages(), so the two don't race.
+static void requestCatalogDownload()
+{
+    if (!bootPipeline.done(BootStage::CATALOG)) {
+        Logger.println("🌐 Audio catalog download waits for the SD catalog");
+        catalogDownloadWanted = true;
+        return;
+    }
+    // Enqueue catalog download (non-blocking — tick() drives it)
+    Logger.println("🌐 Requesting audio catalog download...");
+    if (downloadAudio()) {
+        Logger.println("✅ Audio catalog download enqueued");
+    } else {
+        Logger.println("⚠️ Audio catalog download failed to enqueue - will retry later");
+    }
+}
+
+// Load the SD catalog once the storage task has mounted the card. The
+// registry isn't shared across tasks, so this runs here and not on the boot
+// task; while a tone or clip plays it waits, unless digits need the catalog.
+// The DTMF stage ends here too, once the Goertzel task is past its delay.
+static void tickBootStages()
+{
+    if (!bootPipeline.done(BootStage::DTMF) && isGoertzelDetecting()) {
+        bootPipeline.end(BootStage::DTMF);
+    }
+    if (bootPipeline.done(BootStage::CATALOG) || !bootPipeline.done(BootStage::STORAGE)) return;
+    if (audioPlayer.isActive() && !isReadingSequence()) return;
+
+    audioPlayer.setStreamingEnabled(source != nullptr);
+    bootPipeline.run(BootStage::CATALOG, []() {
+        loadAudioCatalog();
+        return true;
+    });
+    if (catalogDownloadWanted) {
+        catalogDownloadWanted = false;
+        requestCatalogDownload();
+    }
+}
+
+// Maintenance work for loop(), highest priority first. Budgets are what a
+// tick normally takes; loopScheduler defers a job that wouldn't fit before
+// the next audio copy() and counts the ones that run over.
+static void registerLoopJobs()
+{
+    // A settled hook change is applied before any further maintenance
+    loopScheduler.setPreempt([]() { return Phone.hookEventPending(); });
+
+    // WiFi, OTA, telnet, web handlers queued for this core, VPN edges
+    loopScheduler.add("network", handleNetworkLoop, 20, 0, 3000);
+    // Serial and telnet console; a slow command shows up as an overrun
+    loopScheduler.add("console", processDebugInput, 20, 1, 2000);
+    // SD catalog load, once the storage boot task has mounted the card
+    loopScheduler.add("boot", tickBootStages, 100, 2, 5000);
+    // Catalog refresh (if stale) + download queue, one WebQueue chunk a tick
+    loopScheduler.add("audio", []() {
+        if (bootPipeline.done(BootStage::CATALOG)) audioMaintenanceLoop();
+    }, 100, 3, 4000);
+    // Free decoders no file has needed for a while, and registry versions
+    // replaced by a catalog refresh
+    loopScheduler.add("decoders", []() {
+        if (!bootPipeline.done(BootStage::CATALOG)) return;
+        decoderPool.tick(audioPlayer.isActive());
+        audioKeyRegistry.reclaimRetired([]() { return !audioPlayer.isActive(); });
+    }, 100, 4, 1000);
+    // Background SD defragment, when one was started from the console
+    loopScheduler.add("defrag", []() {
+        if (bootPipeline.done(BootStage::CATALOG)) tickSDDefrag();
+    }, 100, 5, 4000);
+    loopScheduler.add("crash", tickCrashStabilityCheck, 100, 6, 200);
+    // Low-power state after POWER_IDLE_MS on-hook; wakes when anything needs audio
+    loopScheduler.add("power", []() { powerManager.tick(); }, 250, 7, 1000);
+    // Deferred tunable applies and A/B switches (tunables.h)
+    loopScheduler.add("tune", []() { tunables.tick(); }, 250, 8, 500);
+#if METRICS_INTERVAL_MS > 0
+    // Metrics snapshot onto the remote-log stream (metrics.h)
+    loopScheduler.add("metrics", []() { metrics.ship(); }, METRICS_INTERVAL_MS, 9, 1500);
+#endif
+}
+
 void setup()
 {
     Serial.begin(115200);
-    delay(2000); // Give serial time to initialize
+    delay(BOOT_SERIAL_WAIT_MS); // Give serial time to initialize
 
     // Initialize logging system first
     Logger.addLogger(Serial);
@@ -151,92 +329,56 @@ void setup()
     // Reduce AudioTools library logging to minimize noise
     AudioToolsLogger.begin(Logger, AUDIOTOOLS_LOG_LEVEL);
 
-    // Initialize AudioKit FIRST with sd_active=false
-    // This prevents AudioKit from interfering with our SPI SD card pins
-    Logger.println("🔧 Initializing AudioKit (RXTX_MODE)...");
-    auto cfg = kit.defaultConfig(RXTX_MODE);
-    cfg.setAudioInfo(AUDIO_INFO_DEFAULT());
-    // Configure input device - can be set via build flags
-#ifdef AUDIO_INPUT_DEVICE
-    cfg.input_device = AUDIO_INPUT_DEVICE;
-#else
-    cfg.input_device = ADC_INPUT_ALL; // Default: both microphone and line in
-#endif
-
-    cfg.sd_active = false; // SD card initialized manually in setup()
-    //    cfg.sd_active = false; // Don't let AudioKit touch SD pins - we'll handle SD ourselves
-    if (!kit.begin(cfg))
-    {
-        Logger.println("❌ Failed to initialize AudioKit");
-        audioKitInitialized = false;
-    }
-    else
-    {
-        Logger.println("✅ AudioKit initialized successfully");
-        audioKitInitialized = true;
-        
-        // Set input volume/gain for DTMF detection
-        // Volume range is 0-100 (percentage)
-        kit.setInputVolume(AUDIOKIT_INPUT_VOLUME);
-        Logger.printf("🔊 Input volume set to %d%%\n", AUDIOKIT_INPUT_VOLUME);
-    }
-
-    // Initialize audio file manager (handles SD card initialization internally)
-    // Returns AudioSourceSD pointer if SD card is available
-    source = initializeAudioFileManager();
-
-    // Initialize Audio Player with event callback
-    // Register MP3 decoder
-
-    setupAudioPlayer();
+    // Saved detector/pipeline tunables, before anything reads PhoneConfig
+    tunables.begin();
+    metrics.begin();
+
+    // === Boot pipeline ===
+    // Inline stages are what answering a pick-up needs. SD mount runs on a
+    // boot task meanwhile, WiFi connects in the driver's task, and the SD
+    // catalog loads from loop() once storage is up (tickBootStages()).
+    bootPipeline.run(BootStage::AUDIO_KIT, initAudioKit);
+
+    // Waits for AudioKit, which must be up before we touch the SPI SD pins
+    bootPipeline.runAsync(BootStage::STORAGE, []() {
+        source = mountAudioStorage();
+        return source != nullptr;
+    }, BOOT_BIT(BootStage::AUDIO_KIT));
+
+    bootPipeline.run(BootStage::PLAYER, []() {
+        setupAudioPlayer();
+        return true;
+    });
 
     // Initialize Goertzel-based DTMF decoder
     // Goertzel is O(n*k) for 8 DTMF frequencies — the only detector we need
-    initGoertzelDecoder(goertzel, goertzelCopier, true);
+    // The stage ends when the task starts detecting (tickBootStages()),
+    // after its start-up delay, not when the task is created
+    bootPipeline.begin(BootStage::DTMF);
+    if (!initGoertzelDecoder(goertzel, goertzelCopier, true)) {
+        bootPipeline.end(BootStage::DTMF, false);
+    }
 
-    // Initialize WiFi with careful error handling
-    Logger.println("🔧 Starting WiFi initialization...");
+    // Hook sensing — from here a pick-up gets dial tone
+    bootPipeline.run(BootStage::PHONE, startPhone);
 
+    // Check if phone is already off hook at boot - play dial tone
+    if (Phone.isOffHook())
+    {
+        Logger.println("📞 Phone is off hook at boot - playing dial tone");
+        setAudioDownloadsSuspended(true);
+        audioPlayer.playAudioKey("dialtone");
+    }
 
-    initWiFi([]() {
-        // Enqueue catalog download (non-blocking — tick() drives it)
-        Logger.println("🌐 Requesting audio catalog download...");
-        if (downloadAudio()) {
-            Logger.println("✅ Audio catalog download enqueued");
-        } else {
-            Logger.println("⚠️ Audio catalog download failed to enqueue - will retry later");
-        }
-    });
-    
-    // Skip Tailscale reconnection when phone is off hook (blocking call interrupts DTMF)
-    setTailscaleSkipCallback([]() -> bool {
-        return Phone.isOffHook();
-    });
+    // Initialize WiFi (non-blocking: the connection completes in handleNetworkLoop())
+    Logger.println("🔧 Starting WiFi initialization...");
+    bootPipeline.begin(BootStage::WIFI);
+    initWiFi(requestCatalogDownload);
 
     // Initialize special commands system
     initializeSpecialCommands();
 
-    // Initialize Phone Service
-    Phone.begin();
-    Phone.setHookCallback([](bool isOffHook) {
-        if (isOffHook) {
-            // Handle off-hook event
-            Logger.println("📞 Phone picked up (OFF HOOK)");
-            // Check if debugaudio command has armed a capture for this off-hook
-            if (checkAndExecuteOffHookCapture()) {
-                // Capture was triggered, skip normal dial tone for now
-                // (capture function will handle audio)
-                return;
-            }
-            Logger.println("⚡ Playing Dial Tone");
-            audioPlayer.playAudioKey("dialtone");
-        } else {
-            // Handle on-hook event
-            Logger.println("📞 Phone hung up (ON HOOK)");
-            audioPlayer.stop();
-            resetDTMFSequence(); // Clear any partial DTMF sequence
-        }
-    });
+    registerLoopJobs();
     
     Logger.println("✅ Bowie Phone Ready!");
     Logger.println("🔧 Serial Debug Mode ACTIVE - type 'help' for commands");
@@ -246,18 +388,15 @@ void setup()
     // or a bad pointer deref that doesn't trigger a normal panic.
     esp_task_wdt_init(TASK_WDT_TIMEOUT_S, true);
     esp_task_wdt_add(NULL);  // Add current (loopTask) to WDT
-    
-    // Check if phone is already off hook at boot - play dial tone
-    if (Phone.isOffHook())
-    {
-        Logger.println("📞 Phone is off hook at boot - playing dial tone");
-        audioPlayer.playAudioKey("dialtone");
-    }
 }
 
 void setupAudioPlayer()
 {
     audioPlayer.setRegistry(&audioKeyRegistry);
+    // A dialed clip that isn't on SD yet jumps the download queue
+    audioPlayer.setMissingFileCallback([](const char* audioKey) { requestAudioFileNow(audioKey); });
+    // Plays keep clips at the recent end of the SD cache's eviction order
+    audioPlayer.setFilePlayedCallback([](const char* audioKey) { noteAudioFilePlayed(audioKey); });
 
     // Dial tone: 350 Hz + 440 Hz (North American standard)
     audioKeyRegistry.registerGenerator("dialtone",new DualToneGenerator(350.0f, 440.0f, 16000.0f));
@@ -286,9 +425,12 @@ void setupAudioPlayer()
     // then m4a_inner_decoder routes the extracted AAC frames to aac_decoder.
     // checkM4A is inactive by default in MimeDetector — the 3-arg overload activates it.
     m4a_inner_decoder.addDecoder(aac_decoder, "audio/aac");
-    m4a_decoder.setDecoder(m4a_inner_decoder);
     audioPlayer.addDecoder(m4a_decoder, "audio/m4a", MimeDetector::checkM4A);
-    audioPlayer.begin(kit, source != nullptr);
+#if AUDIO_HW_VOLUME
+    audioPlayer.setHardwareVolume([](float v) { return kit.setVolume(v); });
+#endif
+    // Storage isn't mounted yet: tickBootStages() turns on streaming fallback
+    audioPlayer.begin(kit, false);
     Logger.println("✅ Default tone generators registered");
 }
 
@@ -310,7 +452,6 @@ void loop()
     esp_task_wdt_reset();
     
     // Process Phone Service
-    static unsigned long lastMaintenanceCheck = 0;
     Phone.loop();
     if (Phone.isOffHook())
     {
@@ -339,50 +480,58 @@ void loop()
         }
         
         // Handle audio playback FIRST - highest priority for smooth audio
+        bool dtmfLive = true;
         if (audioPlayer.isActive())
         {
             audioPlayer.copy();
             bool playingDialtone = audioPlayer.isAudioKeyPlaying("dialtone");
+#if LOOPBACK_CANCEL_ENABLED
+            // Loopback is cancelled per bin, so detection stays live over
+            // clips/ringback (barge-in); only a locked sequence mutes
+            setGoertzelMuted(isSequenceLocked());
+            if (!playingDialtone) {
+                char bargeKey = getGoertzelKey();
+                if (bargeKey != 0) {
+                    Logger.printf("📞 Barge-in digit '%c' — stopping playback\n", bargeKey);
+                    audioPlayer.stop();
+                    addDtmfDigit(bargeKey);
+                }
+                dtmfLive = false;
+            }
+#else
             // Mute Goertzel during non-dialtone playback to suppress
             // false DTMF from ES8388 DAC→ADC internal loopback
             setGoertzelMuted(!playingDialtone);
-            if (!playingDialtone) {
-                return;
-            }
+            dtmfLive = playingDialtone;
+#endif
         } else {
             // Mute Goertzel if sequence is locked (waiting for hangup)
             setGoertzelMuted(isSequenceLocked());
         }
         
-        // Goertzel runs on separate task - just check for detected keys
-        char goertzelKey = getGoertzelKey();
-        if (goertzelKey != 0) {
-            addDtmfDigit(goertzelKey);
-        }
-        
-        // Process ready sequences (from Goertzel, simulated input, or telnet)
-        if (isSequenceReady()) {
-            readDTMFSequence(true);
+        if (dtmfLive) {
+            // Goertzel runs on separate task - just check for detected keys
+            char goertzelKey = getGoertzelKey();
+            if (goertzelKey != 0) {
+                addDtmfDigit(goertzelKey);
+            }
+            
+            // Process ready sequences (from Goertzel, simulated input, or telnet);
+            // also lets an ambiguous match time out while digits are pending
+            if (isReadingSequence()) {
+                readDTMFSequence(true);
+            }
         }
-
     }
 
-    auto limit = isReadingSequence() ? 10 : 100;
-    unsigned long now = millis();
-        
-    // Rate limit maintenance operations to every 100ms while not reading sequence
-    if (now - lastMaintenanceCheck >= limit) {
-        lastMaintenanceCheck = now;
-        
-
-        // Handle WiFi management (config portal and OTA)
-        handleNetworkLoop();
-        // Audio maintenance: catalog refresh (if stale) + download queue processing
-        audioMaintenanceLoop();
-        // Process debug commands from Serial and Telnet
-        processDebugInput();
-        // Handle Tailscale VPN keepalive/reconnection and remote logging
+    // Maintenance jobs (registerLoopJobs()): while loop() feeds the codec
+    // only what fits before the next copy() runs
+    bool feedingAudio = audioPlayer.isActive() && !isAudioOutputTaskRunning();
+    loopScheduler.run(feedingAudio ? LOOP_AUDIO_SLICE_US : LOOP_IDLE_SLICE_US);
 
-        tickCrashStabilityCheck();
+    // Low power: block instead of spinning so the CPU can scale down and
+    // sleep; a hook event ends the wait at once
+    if (powerManager.lowPower()) {
+        Phone.waitHookEvent(POWER_LOOP_SLEEP_MS);
     }
 }
\ No newline at end of file
@@ -0,0 +1,261 @@
+/**
+ * @file metrics.cpp
+ * @brief Periodic metrics snapshots shipped on the remote-log TCP stream
+ *
+ * @date 2026
+ */
+
+#include "metrics.h"
+#include "logging.h"
+#include "remote_logger.h"
+#include "dtmf_goertzel.h"
+#include "audio_output_task.h"
+#include "audio_copy_meter.h"
+#include "audio_pcm_cache.h"
+#include "extended_audio_player.h"
+#include "web_queue.h"
+#include "tailscale_manager.h"
+#include "psram_alloc.h"
+#include <WiFi.h>
+
+static_assert(METRICS_SNAPSHOT_BYTES <= REMOTE_LOG_FRAME_BYTES, "A snapshot must fit one log frame");
+
+MetricsRegistry metrics;
+
+static uint8_t snapshotBuf[METRICS_SNAPSHOT_BYTES];
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+void MetricsWriter::put(uint8_t b) {
+    if (_len < _cap) {
+        _buf[_len++] = b;
+    } else {
+        _overflow = true;
+    }
+}
+
+// CBOR initial byte plus the shortest argument that holds `value`
+void MetricsWriter::head(uint8_t major, uint32_t value) {
+    major <<= 5;
+    if (value < 24) {
+        put(major | value);
+    } else if (value <= 0xff) {
+        put(major | 24);
+        put(value);
+    } else if (value <= 0xffff) {
+        put(major | 25);
+        put(value >> 8);
+        put(value);
+    } else {
+        put(major | 26);
+        put(value >> 24);
+        put(value >> 16);
+        put(value >> 8);
+        put(value);
+    }
+}
+
+void MetricsWriter::str(const char* s) {
+    size_t n = strlen(s);
+    head(3, n);
+    for (size_t i = 0; i < n; i++) put(s[i]);
+}
+
+void MetricsWriter::counter(const char* name, uint32_t value) {
+    if (_text) {
+        *_text += ' ';
+        *_text += name;
+        *_text += '=';
+        *_text += value;
+        return;
+    }
+    str(name);
+    head(0, value);
+}
+
+void MetricsWriter::gauge(const char* name, float value) {
+    if (_text) {
+        *_text += ' ';
+        *_text += name;
+        *_text += '=';
+        *_text += String(value, 1);
+        return;
+    }
+    str(name);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put(0xfa);                      // float32, big-endian
+    put(bits >> 24);
+    put(bits >> 16);
+    put(bits >> 8);
+    put(bits);
+}
+
+void MetricsWriter::histogram(const char* name, const uint32_t* counts, int buckets,
+                              uint32_t first, bool log2) {
+    if (_text) {
+        *_text += ' ';
+        *_text += name;
+        *_text += '=';
+        for (int i = 0; i < buckets; i++) {
+            if (i > 0) *_text += '/';
+            *_text += counts[i];
+        }
+        return;
+    }
+    str(name);
+    head(4, buckets + 2);
+    head(0, first);
+    head(0, log2 ? 1 : 0);
+    for (int i = 0; i < buckets; i++) head(0, counts[i]);
+}
+
+// ============================================================================
+// SOURCES
+// ============================================================================
+
+static void goertzelSource(MetricsWriter& w) {
+    GoertzelDetectorStats d = getGoertzelDetectorStats();
+    GoertzelTaskStats t = getGoertzelTaskStats();
+    uint32_t digits = 0;
+    for (int i = 0; i < 16; i++) digits += d.detections[i];
+
+    w.counter("evals", d.evaluations);
+    w.counter("muted", d.mutedWindows);
+    w.counter("silent", d.silentWindows);
+    w.counter("gated", d.gatedWindows);
+    w.counter("digits", digits);
+    w.counter("rej_partial", d.rejectPartial);
+    w.counter("rej_floor", d.rejectFloor);
+    w.counter("rej_twist", d.rejectTwist);
+    w.counter("rej_harmonic", d.rejectHarmonic);
+    w.counter("rej_energy", d.rejectEnergy);
+    w.counter("queue_drops", d.queueDrops);
+    w.counter("overruns", t.overruns);
+    w.counter("missed_frames", t.missedFrames);
+    w.counter("hops", t.analysedHops);
+    w.counter("gated_hops", t.gatedHops);
+    w.gauge("latency_max_ms", d.latencyMaxMs);
+    w.histogram("latency_ms", d.latency, GOERTZEL_HISTOGRAM_BUCKETS, GOERTZEL_LATENCY_BUCKET_MS, false);
+    w.histogram("emit_mag", d.emitMagnitude, GOERTZEL_HISTOGRAM_BUCKETS, 16, true);
+    w.histogram("reject_mag", d.rejectMagnitude, GOERTZEL_HISTOGRAM_BUCKETS, 16, true);
+}
+
+static void playerSource(MetricsWriter& w) {
+    AudioOutputStats o = getAudioOutputStats();
+    w.counter("underruns", o.underruns);
+    w.counter("underrun_bytes", o.underrunBytes);
+    w.counter("bytes_out", o.bytesOut);
+    w.counter("commands", o.commands);
+    w.counter("cmd_timeouts", o.commandTimeouts);
+    w.counter("decode_waits", o.decodeWaits);
+    w.gauge("ring_level", o.ringLevel);
+    w.gauge("ring_low_water", o.ringLowWater);
+
+    AudioCopyStats c = getExtendedAudioPlayer().getCopyMeter().getTotalStats();
+    w.counter("copies", c.copies);
+    w.counter("idle_copies", c.idleCopies);
+    w.counter("over_budget", c.overBudget);
+    w.counter("bytes_in", c.bytesIn);
+    w.counter("pcm_out", c.pcmOut);
+    w.gauge("copy_max_us", c.copyMaxUs);
+    w.histogram("copy_us", c.duration, AUDIO_COPY_HISTOGRAM_BUCKETS, AUDIO_COPY_HISTOGRAM_FIRST_US, true);
+
+    PcmCacheStats p = getAudioPcmCache().getStats();
+    w.counter("cache_hits", p.hits);
+    w.counter("cache_misses", p.misses);
+    w.counter("cache_evictions", p.evictions);
+}
+
+static void webQueueSource(MetricsWriter& w) {
+    WebQueueStats s = webQueue.stats();
+    w.counter("completed", s.completed);
+    w.counter("failed", s.failed);
+    w.counter("resumed", s.resumed);
+    w.counter("bytes", s.bytes);
+    w.gauge("pending", webQueue.pendingCount());
+}
+
+static void netSource(MetricsWriter& w) {
+    bool up = WiFi.status() == WL_CONNECTED;
+    w.gauge("wifi", up ? 1 : 0);
+    w.gauge("rssi", up ? WiFi.RSSI() : 0);
+    w.gauge("vpn", isTailscaleConnected() ? 1 : 0);
+}
+
+static void heapSource(MetricsWriter& w) {
+    HeapStats h = sampleHeap();
+    w.gauge("internal_free", h.internalFree);
+    w.gauge("internal_largest", h.internalLargest);
+    w.gauge("internal_min", h.internalMinFree);
+    w.gauge("psram_free", h.psramFree);
+    w.gauge("psram_largest", h.psramLargest);
+}
+
+// ============================================================================
+// REGISTRY
+// ============================================================================
+
+void MetricsRegistry::begin() {
+    if (_count > 0) return;
+    add("goertzel", goertzelSource);
+    add("player", playerSource);
+    add("webqueue", webQueueSource);
+    add("net", netSource);
+    add("heap", heapSource);
+}
+
+bool MetricsRegistry::add(const char* name, Source source) {
+    if (_count >= METRICS_MAX_SOURCES) {
+        Logger.printf("❌ [METRICS] Can't add source %s\n", name);
+        return false;
+    }
+    _sources[_count++] = {name, source};
+    return true;
+}
+
+void MetricsRegistry::ship() {
+    if (_count == 0 || !RemoteLogger.isEnabled()) return;
+
+    MetricsWriter w(snapshotBuf, sizeof(snapshotBuf));
+    w.head(5, 3 + _count);          // Top-level map, definite length
+    w.str("v");
+    w.head(0, 1);
+    w.str("up");
+    w.head(0, millis() / 1000);
+    w.str("n");
+    w.head(0, _shipped);
+    for (int i = 0; i < _count; i++) {
+        w.str(_sources[i].name);
+        w.beginMap();
+        _sources[i].source(w);
+        w.endMap();
+    }
+
+    if (w.overflowed()) {
+        if (_failed++ == 0) {
+            Logger.printf("⚠️ [METRICS] Snapshot over %u bytes, not sent\n", (unsigned)sizeof(snapshotBuf));
+        }
+        return;
+    }
+    if (RemoteLogger.writeMetrics(snapshotBuf, w.length())) {
+        _shipped++;
+    } else {
+        _failed++;
+    }
+}
+
+void MetricsRegistry::print() {
+    for (int i = 0; i < _count; i++) {
+        String line = "📈 [METRICS] ";
+        line += _sources[i].name;
+        line += ':';
+        MetricsWriter w(line);
+        _sources[i].source(w);
+        Logger.println(line);
+    }
+    Logger.printf("📈 [METRICS] %u snapshot(s) shipped, %u failed, every %u s\n",
+                  (unsigned)_shipped, (unsigned)_failed, (unsigned)(METRICS_INTERVAL_MS / 1000));
+}
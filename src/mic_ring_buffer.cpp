@@ -0,0 +1,395 @@
+#include "mic_ring_buffer.h"
+#include "logging.h"
+#include "config.h"
+#include "esp_heap_caps.h"
+
+// ============================================================================
+// MIC RING BUFFER
+// ============================================================================
+
+bool MicRingBuffer::begin(size_t capacitySamples)
+{
+    end();
+
+    // Round down to a power of two so positions wrap with a mask
+    size_t capacity = 1;
+    while (capacity * 2 <= capacitySamples) capacity *= 2;
+    if (capacity <= MIC_RING_GUARD_SAMPLES) {
+        return false;
+    }
+
+    _buffer = (int16_t*)heap_caps_malloc(capacity * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!_buffer) {
+        Logger.printf("⚠️ Mic ring: no PSRAM for %u samples, using %u in internal RAM\n",
+                      (unsigned)capacity, (unsigned)MIC_RING_FALLBACK_SAMPLES);
+        capacity = MIC_RING_FALLBACK_SAMPLES;
+        _buffer = (int16_t*)heap_caps_malloc(capacity * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (!_buffer) {
+            return false;
+        }
+    }
+    memset(_buffer, 0, capacity * sizeof(int16_t));
+    _mask = capacity - 1;
+    __atomic_store_n(&_writeIndex, 0, __ATOMIC_RELEASE);
+    return true;
+}
+
+void MicRingBuffer::end()
+{
+    if (_buffer) {
+        heap_caps_free(_buffer);
+        _buffer = nullptr;
+    }
+    _mask = 0;
+}
+
+void MicRingBuffer::write(const int16_t* samples, size_t count)
+{
+    if (!_buffer || count == 0) {
+        return;
+    }
+    uint32_t w = _writeIndex;   // Only this task writes it
+    size_t pos = w & _mask;
+    size_t first = capacity() - pos;
+    if (first > count) first = count;
+    memcpy(_buffer + pos, samples, first * sizeof(int16_t));
+    if (count > first) {
+        memcpy(_buffer, samples + first, (count - first) * sizeof(int16_t));
+    }
+    // Samples must be visible before the index that exposes them
+    __atomic_store_n(&_writeIndex, w + (uint32_t)count, __ATOMIC_RELEASE);
+}
+
+size_t MicRingBuffer::read(uint32_t& cursor, int16_t* dest, size_t maxSamples, uint32_t& lost) const
+{
+    if (!_buffer || maxSamples == 0) {
+        return 0;
+    }
+    uint32_t w = writeIndex();
+    uint32_t behind = w - cursor;     // Wraps correctly across 2^32
+    if (behind > usableCapacity()) {
+        uint32_t skip = behind - (uint32_t)usableCapacity();
+        cursor += skip;
+        lost += skip;
+        behind = (uint32_t)usableCapacity();
+    }
+    size_t count = behind < maxSamples ? behind : maxSamples;
+
+    size_t pos = cursor & _mask;
+    size_t first = capacity() - pos;
+    if (first > count) first = count;
+    memcpy(dest, _buffer + pos, first * sizeof(int16_t));
+    if (count > first) {
+        memcpy(dest + first, _buffer, (count - first) * sizeof(int16_t));
+    }
+    cursor += (uint32_t)count;
+    return count;
+}
+
+bool MicRingBuffer::subscribe(TaskHandle_t task)
+{
+    bool added = false;
+    portENTER_CRITICAL(&_subscriberLock);
+    for (int i = 0; i < MIC_RING_MAX_SUBSCRIBERS; i++) {
+        if (_subscribers[i] == task) {
+            added = true;
+            break;
+        }
+    }
+    for (int i = 0; !added && i < MIC_RING_MAX_SUBSCRIBERS; i++) {
+        if (_subscribers[i] == nullptr) {
+            _subscribers[i] = task;
+            added = true;
+        }
+    }
+    portEXIT_CRITICAL(&_subscriberLock);
+    return added;
+}
+
+void MicRingBuffer::unsubscribe(TaskHandle_t task)
+{
+    portENTER_CRITICAL(&_subscriberLock);
+    for (int i = 0; i < MIC_RING_MAX_SUBSCRIBERS; i++) {
+        if (_subscribers[i] == task) {
+            _subscribers[i] = nullptr;
+        }
+    }
+    portEXIT_CRITICAL(&_subscriberLock);
+}
+
+void MicRingBuffer::notifySubscribers()
+{
+    TaskHandle_t targets[MIC_RING_MAX_SUBSCRIBERS];
+    portENTER_CRITICAL(&_subscriberLock);
+    memcpy(targets, _subscribers, sizeof(targets));
+    portEXIT_CRITICAL(&_subscriberLock);
+    for (int i = 0; i < MIC_RING_MAX_SUBSCRIBERS; i++) {
+        if (targets[i] != nullptr) {
+            xTaskNotifyGive(targets[i]);
+        }
+    }
+}
+
+MicRingBuffer& getMicRing()
+{
+    static MicRingBuffer ring;
+    return ring;
+}
+
+// ============================================================================
+// MIC RING READER
+// ============================================================================
+
+size_t MicRingReader::readSamples(int16_t* dest, size_t maxSamples)
+{
+    uint32_t lostBefore = _lost;
+    size_t count = _ring.read(_cursor, dest, maxSamples, _lost);
+    if (_lost != lostBefore) {
+        _overruns++;
+    }
+    return count;
+}
+
+size_t MicRingReader::readBytes(uint8_t* data, size_t len)
+{
+    size_t written = 0;
+    if (_hasPendingByte && len > 0) {
+        data[written++] = _pendingByte;
+        _hasPendingByte = false;
+    }
+
+    // Whole samples straight into the caller's buffer (ring copies with memcpy,
+    // so an odd destination offset is fine)
+    size_t samples = (len - written) / sizeof(int16_t);
+    written += readSamples(reinterpret_cast<int16_t*>(data + written), samples) * sizeof(int16_t);
+
+    // One byte short: split the next sample across this read and the next
+    if (len - written == 1) {
+        int16_t sample;
+        if (readSamples(&sample, 1) == 1) {
+            data[written++] = (uint8_t)(sample & 0xFF);
+            _pendingByte = (uint8_t)((sample >> 8) & 0xFF);
+            _hasPendingByte = true;
+        }
+    }
+    return written;
+}
+
+int MicRingReader::available()
+{
+    uint32_t behind = _ring.writeIndex() - _cursor;
+    if (behind > _ring.usableCapacity()) {
+        behind = (uint32_t)_ring.usableCapacity();
+    }
+    return (int)(behind * sizeof(int16_t)) + (_hasPendingByte ? 1 : 0);
+}
+
+// ============================================================================
+// RING TAP — copies the player's output into the loopback reference ring
+// ============================================================================
+
+void RingTapStream::setAudioInfo(AudioInfo info)
+{
+    AudioStream::setAudioInfo(info);
+    setChannels(info.channels);
+    if (_output) {
+        _output->setAudioInfo(info);
+    }
+}
+
+size_t RingTapStream::write(const uint8_t* data, size_t len)
+{
+    if (!_output) {
+        return 0;
+    }
+    // Only what the codec accepted was actually played
+    size_t written = _output->write(data, len);
+    if (!_ring.isActive() || written == 0) {
+        return written;
+    }
+
+    int16_t mono[128];
+    size_t count = 0;
+    for (size_t i = 0; i < written; i++) {
+        if (!_hasPendingByte) {
+            _pendingByte = data[i];
+            _hasPendingByte = true;
+            continue;
+        }
+        int16_t sample = (int16_t)(_pendingByte | (data[i] << 8));
+        _hasPendingByte = false;
+
+        bool take = (_channelIndex == 0);
+        if (++_channelIndex >= _channels) _channelIndex = 0;
+        if (!take) continue;
+
+        mono[count++] = sample;
+        if (count == sizeof(mono) / sizeof(mono[0])) {
+            _ring.write(mono, count);
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        _ring.write(mono, count);
+    }
+    return written;
+}
+
+MicRingBuffer& getLoopbackReferenceRing()
+{
+    static MicRingBuffer ring;
+    return ring;
+}
+
+// ============================================================================
+// CAPTURE TASK — the only reader of the codec's RX path
+// ============================================================================
+
+static TaskHandle_t micTaskHandle = nullptr;
+static Stream* micSource = nullptr;
+static volatile bool micTaskShouldRun = false;
+static MicCaptureStats micStats = {};
+
+// Frame timing for overrun detection: wall-clock audio expected vs consumed
+static const uint32_t MIC_BYTES_PER_SEC = AUDIO_SAMPLE_RATE * AUDIO_CHANNELS * (AUDIO_BITS_PER_SAMPLE / 8);
+static const uint64_t DMA_RING_BYTES = (uint64_t)MIC_DMA_FRAME_BYTES * MIC_DMA_FRAME_COUNT;
+static unsigned long frameClockStartUs = 0;
+static uint64_t bytesConsumed = 0;
+
+// Account one read. The I2S driver keeps MIC_DMA_FRAME_COUNT buffers; if
+// more audio has elapsed than we consumed plus that whole ring, the DMA
+// wrapped and the difference was lost.
+static void trackFrame(size_t bytes)
+{
+    if (bytes == 0) {
+        micStats.missedFrames++;
+        return;
+    }
+    micStats.frames++;
+    bytesConsumed += bytes;
+
+    uint64_t elapsedUs = (uint32_t)(micros() - frameClockStartUs);
+    uint64_t expected = elapsedUs * MIC_BYTES_PER_SEC / 1000000ULL;
+    if (expected > bytesConsumed + DMA_RING_BYTES) {
+        uint64_t lost = expected - bytesConsumed - DMA_RING_BYTES;
+        micStats.overruns++;
+        micStats.missedFrames += (uint32_t)(lost / MIC_DMA_FRAME_BYTES);
+        // Resync so one stall is counted once
+        bytesConsumed = expected;
+    }
+
+    // Re-base before micros() wraps (~71 min) so elapsed stays monotonic
+    if (elapsedUs > 600000000ULL) {
+        frameClockStartUs += (unsigned long)elapsedUs;
+        bytesConsumed -= (bytesConsumed < expected) ? bytesConsumed : expected;
+    }
+}
+
+static void micTaskFunction(void* parameter)
+{
+    Stream* source = (Stream*)parameter;
+    MicRingBuffer& ring = getMicRing();
+
+    // One DMA frame of interleaved input, plus its first-channel samples
+    static uint8_t frame[MIC_DMA_FRAME_BYTES];
+    static int16_t mono[MIC_DMA_FRAME_BYTES / sizeof(int16_t)];
+    const int channels = AUDIO_CHANNELS > 0 ? AUDIO_CHANNELS : 1;
+    size_t carry = 0;   // Bytes of a partial frame (sample group) left from the last read
+
+    micStats = {};
+    bytesConsumed = 0;
+    frameClockStartUs = micros();
+    Logger.println("🎙️ Mic capture task started on core 0");
+
+    while (micTaskShouldRun) {
+        // readBytes() blocks in i2s_read until the RX DMA buffer completes
+        size_t bytes = source->readBytes(frame + carry, sizeof(frame) - carry);
+        trackFrame(bytes);
+        if (bytes == 0) {
+            vTaskDelay(1);   // Stopped or failed port — don't spin
+            continue;
+        }
+
+        size_t total = carry + bytes;
+        const size_t frameStride = channels * sizeof(int16_t);
+        size_t groups = total / frameStride;
+        const int16_t* pcm = reinterpret_cast<const int16_t*>(frame);
+        for (size_t i = 0; i < groups; i++) {
+            mono[i] = pcm[i * channels];
+        }
+        ring.write(mono, groups);
+
+        carry = total - groups * frameStride;
+        if (carry > 0) {
+            memmove(frame, frame + groups * frameStride, carry);
+        }
+        ring.notifySubscribers();
+    }
+
+    Logger.println("🎙️ Mic capture task stopped");
+    micTaskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+bool startMicCapture(Stream& source)
+{
+    if (micTaskHandle != nullptr) {
+        return true;
+    }
+    MicRingBuffer& ring = getMicRing();
+    if (!ring.isActive() && !ring.begin(MIC_RING_SAMPLES)) {
+        Logger.println("❌ Mic ring allocation failed");
+        return false;
+    }
+
+    micSource = &source;
+    micTaskShouldRun = true;
+    // Above the Goertzel task so DMA is always drained first
+    BaseType_t ok = xTaskCreatePinnedToCore(
+        micTaskFunction,
+        "MicCapture",
+        4096,
+        micSource,
+        2,
+        &micTaskHandle,
+        0  // Core 0
+    );
+    if (ok != pdPASS) {
+        micTaskShouldRun = false;
+        micTaskHandle = nullptr;
+        Logger.println("❌ Mic capture task creation failed");
+        return false;
+    }
+    Logger.printf("🎙️ Mic ring: %u samples (%.2fs)\n",
+                  (unsigned)ring.capacity(), (float)ring.capacity() / AUDIO_SAMPLE_RATE);
+    return true;
+}
+
+void stopMicCapture()
+{
+    if (micTaskHandle == nullptr) {
+        return;
+    }
+    micTaskShouldRun = false;
+
+    // The task exits after its current (blocking) frame read
+    int timeout = 500;
+    while (micTaskHandle != nullptr && timeout > 0) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        timeout -= 10;
+    }
+    if (micTaskHandle != nullptr) {
+        vTaskDelete(micTaskHandle);
+        micTaskHandle = nullptr;
+    }
+}
+
+bool isMicCaptureRunning()
+{
+    return micTaskHandle != nullptr && micTaskShouldRun;
+}
+
+MicCaptureStats getMicCaptureStats()
+{
+    return micStats;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file net_worker.cpp
+ * @brief One persistent task for background HTTP requests
+ *
+ * @date 2026
+ */
+
+#include "net_worker.h"
+#include "http_pool.h"
+#include "logging.h"
+
+NetWorker netWorker;
+
+// Fixed-size copy; false if it had to be cut
+static bool copyField(char* dst, size_t cap, const char* src) {
+    if (!src) src = "";
+    size_t n = strlen(src);
+    if (n >= cap) return false;
+    memcpy(dst, src, n + 1);
+    return true;
+}
+
+// ============================================================================
+// Submitting
+// ============================================================================
+
+bool NetWorker::getFile(const char* url, const char* sdPath,
+                        FileCallback cb, void* userData, int timeoutMs) {
+    Request* r = claim(Kind::GET_FILE, url, (void*)cb, userData, timeoutMs);
+    if (!r) return false;
+    if (!copyField(r->sdPath, sizeof(r->sdPath), sdPath)) {
+        Logger.printf("❌ [NET] Path too long: %s\n", sdPath);
+        r->url[0] = '\0';
+    }
+    return submit(r);
+}
+
+bool NetWorker::getString(const char* url, StringCallback cb, void* userData, int timeoutMs,
+                          HttpValidators* validators) {
+    Request* r = claim(Kind::GET_STRING, url, (void*)cb, userData, timeoutMs);
+    if (!r) return false;
+    r->validators = validators;
+    return submit(r);
+}
+
+bool NetWorker::post(const char* url, String body, PostCallback cb, void* userData,
+                     const char* contentType, const char* extraHeaderName,
+                     const char* extraHeaderValue, int timeoutMs) {
+    Request* r = claim(Kind::POST, url, (void*)cb, userData, timeoutMs);
+    if (!r) return false;
+    copyField(r->contentType, sizeof(r->contentType),
+              contentType ? contentType : "application/json");
+    if (!copyField(r->extraName, sizeof(r->extraName), extraHeaderName) ||
+        !copyField(r->extraValue, sizeof(r->extraValue), extraHeaderValue)) {
+        r->extraName[0] = '\0';
+    }
+    r->body = std::move(body);
+    return submit(r);
+}
+
+// Free slot for a request, or nullptr (table full, URL too long, no task)
+NetWorker::Request* NetWorker::claim(Kind kind, const char* url, void* cb,
+                                     void* userData, int timeoutMs) {
+    if (!start()) return nullptr;
+    if (!url || strlen(url) >= sizeof(_reqs[0].url)) {
+        Logger.printf("❌ [NET] URL too long: %.64s...\n", url ? url : "");
+        return nullptr;
+    }
+
+    Request* r = nullptr;
+    portENTER_CRITICAL(&_mux);
+    for (Request& cand : _reqs) {
+        if (cand.state == State::FREE) {
+            r = &cand;
+            r->state = State::QUEUED;
+            break;
+        }
+    }
+    if (!r) _rejected++;
+    portEXIT_CRITICAL(&_mux);
+
+    if (!r) {
+        Logger.printf("⚠️ [NET] Queue full, dropping request for %s\n", url);
+        return nullptr;
+    }
+    r->kind = kind;
+    copyField(r->url, sizeof(r->url), url);
+    r->sdPath[0] = r->contentType[0] = r->extraName[0] = r->extraValue[0] = '\0';
+    r->timeoutMs = timeoutMs;
+    r->cb = cb;
+    r->userData = userData;
+    r->validators = nullptr;
+    r->ok = false;
+    r->result = 0;
+    return r;
+}
+
+bool NetWorker::submit(Request* r) {
+    uint8_t idx = (uint8_t)(r - _reqs);
+    r->queuedAt = millis();
+    portENTER_CRITICAL(&_mux);
+    _queued++;
+    if (++_depth > _maxDepth) _maxDepth = _depth;
+    portEXIT_CRITICAL(&_mux);
+    // Never full: it holds as many entries as there are slots
+    xQueueSend(_todo, &idx, 0);
+    return true;
+}
+
+// Create the queues and the task on first use (from whichever task that is)
+bool NetWorker::start() {
+    if (_task) return true;
+    portENTER_CRITICAL(&_mux);
+    bool mine = !_starting;
+    _starting = true;
+    portEXIT_CRITICAL(&_mux);
+    if (!mine) {
+        while (_starting && !_task) vTaskDelay(1);
+        return _task != nullptr;
+    }
+
+    if (!_todo) _todo = xQueueCreate(NET_WORKER_QUEUE_DEPTH, sizeof(uint8_t));
+    if (!_done) _done = xQueueCreate(NET_WORKER_QUEUE_DEPTH, sizeof(uint8_t));
+    TaskHandle_t task = nullptr;
+    if (_todo && _done) {
+        xTaskCreatePinnedToCore(taskMain, "NetIO", NET_WORKER_STACK, this,
+                                NET_WORKER_PRIORITY, &task, 0);
+    }
+    if (!task) Logger.println("❌ [NET] Failed to start NetIO task");
+    _task = task;
+    _starting = false;
+    return task != nullptr;
+}
+
+// ============================================================================
+// NetIO task (core 0)
+// ============================================================================
+
+void NetWorker::taskMain(void* arg) {
+    NetWorker* self = static_cast<NetWorker*>(arg);
+    uint8_t idx;
+    for (;;) {
+        if (xQueueReceive(self->_todo, &idx, portMAX_DELAY) != pdTRUE) continue;
+        Request& r = self->_reqs[idx];
+        r.state = State::RUNNING;
+        if (r.url[0]) self->run(r);
+        r.doneAt = millis();
+        r.state = State::DONE;
+        xQueueSend(self->_done, &idx, portMAX_DELAY);
+    }
+}
+
+void NetWorker::run(Request& r) {
+    HttpLease http(r.url, r.timeoutMs);
+    switch (r.kind) {
+    case Kind::GET_FILE:
+        r.result = http->getFile(r.url, r.sdPath, r.timeoutMs);
+        r.ok = r.result >= 0;
+        break;
+    case Kind::GET_STRING:
+        r.ok = r.validators ? http->getIfChanged(r.url, *r.validators) : http->get(r.url);
+        r.result = http->statusCode();
+        if (r.ok) r.body = http->getString();
+        else if (http->notModified()) r.ok = true;   // 304: no body
+        break;
+    case Kind::POST:
+        if (r.extraName[0]) http->setPersistentHeader(r.extraName, r.extraValue);
+        r.ok = http->post(r.url, r.body, r.contentType);
+        r.result = http->statusCode();
+        r.body = String();              // Free before the callback
+        if (r.ok) http->getString();    // Read the reply so the connection stays usable
+        break;
+    }
+}
+
+// ============================================================================
+// Completions (core 1)
+// ============================================================================
+
+void NetWorker::poll() {
+    if (!_done) return;
+    uint8_t idx;
+    while (xQueueReceive(_done, &idx, 0) == pdTRUE) {
+        Request& r = _reqs[idx];
+        unsigned long latency = r.doneAt - r.queuedAt;
+        _lastLatencyMs = latency;
+        _totalLatencyMs += latency;
+        if (latency > _maxLatencyMs) _maxLatencyMs = latency;
+        _completed++;
+        if (!r.ok) _failed++;
+
+        switch (r.kind) {
+        case Kind::GET_FILE:
+            if (r.cb) ((FileCallback)r.cb)(r.ok ? r.result : -1, r.userData);
+            break;
+        case Kind::GET_STRING:
+            if (r.cb) ((StringCallback)r.cb)(r.ok, r.result, r.body, r.userData);
+            break;
+        case Kind::POST:
+            if (r.cb) ((PostCallback)r.cb)(r.ok, r.result, r.userData);
+            break;
+        }
+
+        r.body = String();
+        portENTER_CRITICAL(&_mux);
+        r.state = State::FREE;
+        _depth--;
+        portEXIT_CRITICAL(&_mux);
+    }
+}
+
+int NetWorker::pending() const {
+    return _depth;
+}
+
+void NetWorker::printStatus() {
+    Logger.printf("🌐 NetIO: %s, %d/%d queued (max %d)\n",
+                  _task ? "running" : "not started", _depth, NET_WORKER_QUEUE_DEPTH, _maxDepth);
+    Logger.printf("   %lu queued, %lu done, %lu failed, %lu rejected (table full)\n",
+                  (unsigned long)_queued, (unsigned long)_completed,
+                  (unsigned long)_failed, (unsigned long)_rejected);
+    if (_completed > 0) {
+        Logger.printf("   Latency: last %lu ms, avg %lu ms, max %lu ms\n",
+                      _lastLatencyMs, _totalLatencyMs / _completed, _maxLatencyMs);
+    }
+    if (_task) {
+        Logger.printf("   Stack headroom: %u bytes\n",
+                      (unsigned)uxTaskGetStackHighWaterMark(_task));
+    }
+}
@@ -1,14 +1,33 @@
 #include "notifications.h"
 #include "config.h"
 #include "logging.h"
+#include <esp_timer.h>
 
 // ============================================================================
 // NOTIFICATION SYSTEM IMPLEMENTATION
 // ============================================================================
 
-// LED state tracking
-static bool greenLedState = false;
-static bool redLedState = false;
+// One LED: base level plus the overlay queue the esp_timer steps through
+struct QueuedPattern {
+    LedPattern pattern;
+    LedPriority priority;
+};
+
+struct LedChannel {
+    int8_t pin;
+    bool base;                                  // Level with no pattern playing
+    QueuedPattern queue[LED_PATTERN_QUEUE];     // [0] is playing
+    uint8_t queued;
+    uint16_t phase;                             // 0 = lead, then odd on / even off
+    bool restart;                               // Head changed: start it from phase 0
+    esp_timer_handle_t timer;
+};
+
+static LedChannel channels[] = {
+    { GREEN_LED_GPIO },
+    { RED_LED_GPIO },
+};
+static portMUX_TYPE ledMux = portMUX_INITIALIZER_UNLOCKED;
 static bool initialized = false;
 
 // Pulse configuration
@@ -34,12 +53,11 @@ static int8_t getNotificationPin(NotificationType type) {
     }
 }
 
-// Get the state variable for a pin
-static bool* getLedState(int8_t pin) {
-    if (pin == GREEN_LED_GPIO) {
-        return &greenLedState;
-    } else if (pin == RED_LED_GPIO) {
-        return &redLedState;
+// Get the channel driving a pin
+static LedChannel* getChannel(int8_t pin) {
+    if (pin < 0) return nullptr;
+    for (LedChannel& ch : channels) {
+        if (ch.pin == pin) return &ch;
     }
     return nullptr;
 }
@@ -62,44 +80,94 @@ static void setLedRaw(int8_t pin, bool on) {
 #endif
 }
 
-// Set LED state and track it
-static void setLed(int8_t pin, bool on) {
-    if (!initialized || pin < 0) return;
-    
-    bool* state = getLedState(pin);
-    if (state) {
-        *state = on;
+// Drop the head of the queue (ledMux held)
+static void popPattern(LedChannel& ch) {
+    for (uint8_t i = 1; i < ch.queued; i++) {
+        ch.queue[i - 1] = ch.queue[i];
     }
-    setLedRaw(pin, on);
+    ch.queued--;
+    ch.phase = 0;
 }
 
-// Pulse LED a specified number of times, then restore original state
-static void pulseLed(int8_t pin, int pulseCount) {
-    if (!initialized || pin < 0 || pulseCount <= 0) return;
-    
-    // Save current state
-    bool* statePtr = getLedState(pin);
-    bool savedState = statePtr ? *statePtr : false;
-    
-    // Turn off before pulsing
-    setLedRaw(pin, false);
-    delay(pulseConfig.offDuration);
-    
-    // Pulse the specified number of times
-    for (int i = 0; i < pulseCount; i++) {
-        setLedRaw(pin, true);
-        delay(pulseConfig.onDuration);
-        setLedRaw(pin, false);
-        if (i < pulseCount - 1) {
-            delay(pulseConfig.offDuration);
+// Next level and how long to hold it in ms; 0 = back on the base level
+// (ledMux held)
+static uint32_t advance(LedChannel& ch, bool& level) {
+    while (ch.queued > 0) {
+        const LedPattern& p = ch.queue[0].pattern;
+        uint16_t ph = ch.phase++;
+        if (ph == 0) {
+            if (p.leadMs == 0) continue;
+            level = false;
+            return p.leadMs;
+        }
+        if (p.count != 0 && ph >= 2 * p.count) {
+            if (ph == 2 * p.count && p.tailMs != 0) {
+                level = false;
+                return p.tailMs;
+            }
+            popPattern(ch);
+            continue;
         }
+        if (p.count == 0 && ph == 2) {
+            ch.phase = 1;                       // Repeat: on next
+        }
+        level = ph & 1;
+        uint16_t ms = level ? p.onMs : p.offMs;
+        return ms ? ms : 1;
+    }
+    level = ch.base;
+    return 0;
+}
+
+// esp_timer task: show the next step of the playing pattern
+static void onLedTimer(void* arg) {
+    LedChannel& ch = *static_cast<LedChannel*>(arg);
+    bool level;
+    portENTER_CRITICAL(&ledMux);
+    if (ch.restart) {
+        ch.restart = false;
+        ch.phase = 0;
+    }
+    uint32_t ms = advance(ch, level);
+    setLedRaw(ch.pin, level);
+    portEXIT_CRITICAL(&ledMux);
+    if (ms) {
+        // Fails only if kick() re-armed it meanwhile; that run picks up
+        esp_timer_start_once(ch.timer, ms * 1000ULL);
     }
-    
-    // End delay before restoring
-    delay(pulseConfig.endDelay);
-    
-    // Restore original state
-    setLedRaw(pin, savedState);
+}
+
+// Restart stepping from the (new) head of the queue right away
+static void kick(LedChannel& ch) {
+    esp_timer_stop(ch.timer);
+    esp_timer_start_once(ch.timer, 100);
+}
+
+// Insert by priority (FIFO within one); false if the queue is full of
+// patterns at least as important
+static bool queuePattern(LedChannel& ch, const LedPattern& pattern, LedPriority priority) {
+    bool queued = false;
+    bool newHead = false;
+    portENTER_CRITICAL(&ledMux);
+    uint8_t at = ch.queued;
+    while (at > 0 && ch.queue[at - 1].priority < priority) {
+        at--;
+    }
+    if (at < LED_PATTERN_QUEUE) {
+        // When full the lowest priority pattern falls off the end
+        uint8_t last = ch.queued < LED_PATTERN_QUEUE ? ch.queued : LED_PATTERN_QUEUE - 1;
+        for (uint8_t i = last; i > at; i--) {
+            ch.queue[i] = ch.queue[i - 1];
+        }
+        ch.queue[at] = { pattern, priority };
+        if (ch.queued < LED_PATTERN_QUEUE) ch.queued++;
+        newHead = at == 0;
+        if (newHead) ch.restart = true;
+        queued = true;
+    }
+    portEXIT_CRITICAL(&ledMux);
+    if (newHead) kick(ch);
+    return queued;
 }
 
 // ============================================================================
@@ -132,6 +200,19 @@ void initNotifications() {
                   GREEN_LED_GPIO, RED_LED_GPIO);
 #endif
 
+    for (LedChannel& ch : channels) {
+        if (ch.pin < 0) continue;
+        esp_timer_create_args_t args = {};
+        args.callback = onLedTimer;
+        args.arg = &ch;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "led";
+        if (esp_timer_create(&args, &ch.timer) != ESP_OK) {
+            Logger.printf("❌ Notifications: no timer for GPIO%d - patterns disabled\n", ch.pin);
+            ch.pin = -1;
+        }
+    }
+
     initialized = true;
 }
 
@@ -159,7 +240,14 @@ void notify(NotificationType type, bool value) {
     }
     
     Logger.printf("💡 Notify: %s %s (GPIO%d)\n", typeName, value ? "ON" : "OFF", pin);
-    setLed(pin, value);
+    LedChannel* ch = getChannel(pin);
+    if (!ch) return;
+    portENTER_CRITICAL(&ledMux);
+    ch->base = value;
+    if (ch->queued == 0) {
+        setLedRaw(pin, value);      // Otherwise shown when the patterns finish
+    }
+    portEXIT_CRITICAL(&ledMux);
 }
 
 void notify(NotificationType type, int value) {
@@ -184,7 +272,46 @@ void notify(NotificationType type, int value) {
     }
     
     Logger.printf("💡 Notify: DTMF key %d -> %d pulses (GPIO%d)\n", value, pulseCount, pin);
-    pulseLed(pin, pulseCount);
+    if (pulseCount <= 0) return;
+    LedPattern pulses = {
+        pulseConfig.onDuration,
+        pulseConfig.offDuration,
+        (uint8_t)min(pulseCount, 255),
+        pulseConfig.offDuration,    // Dark before the first pulse
+        pulseConfig.endDelay
+    };
+    notifyPattern(type, pulses, LedPriority::Normal);
+}
+
+void notifyPattern(NotificationType type, const LedPattern& pattern, LedPriority priority) {
+    if (!initialized) return;
+
+    LedChannel* ch = getChannel(getNotificationPin(type));
+    if (!ch) return;
+    if (!queuePattern(*ch, pattern, priority)) {
+        Logger.printf("⚠️ Notify: GPIO%d pattern queue full, pattern dropped\n", ch->pin);
+    }
+}
+
+void clearPattern(NotificationType type, LedPriority priority) {
+    if (!initialized) return;
+
+    LedChannel* ch = getChannel(getNotificationPin(type));
+    if (!ch) return;
+    bool headRemoved = false;
+    portENTER_CRITICAL(&ledMux);
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < ch->queued; i++) {
+        if (ch->queue[i].priority == priority) {
+            if (i == 0) headRemoved = true;
+            continue;
+        }
+        ch->queue[kept++] = ch->queue[i];
+    }
+    ch->queued = kept;
+    if (headRemoved) ch->restart = true;
+    portEXIT_CRITICAL(&ledMux);
+    if (headRemoved) kick(*ch);
 }
 
 void setPulseConfig(const PulseConfig& config) {
@@ -0,0 +1,352 @@
+/**
+ * @file ota_updater.cpp
+ * @brief Pull OTA in the background while the phone stays in service
+ *
+ * @date 2026
+ */
+
+#include "ota_updater.h"
+#include <Update.h>
+#include <mbedtls/md.h>
+#include "http_utils.h"
+#include "logging.h"
+#include "lz4_block.h"
+#include "psram_alloc.h"
+
+OtaUpdater otaUpdater;
+
+// Two hex digits per byte; false on anything else
+static bool parseSha256Hex(const char* hex, uint8_t* out) {
+    if (!hex || strlen(hex) != 64) return false;
+    for (int i = 0; i < 32; i++) {
+        char pair[3] = { hex[2 * i], hex[2 * i + 1], '\0' };
+        char* end = nullptr;
+        out[i] = (uint8_t)strtoul(pair, &end, 16);
+        if (end != pair + 2) return false;
+    }
+    return true;
+}
+
+// Exactly len bytes of the body, or false on a closed or stalled connection
+static bool readExact(HttpClient& http, uint8_t* dst, size_t len) {
+    WiFiClient* s = http.getStream();
+    if (!s) return false;
+    size_t got = 0;
+    unsigned long lastData = millis();
+    while (got < len) {
+        int avail = s->available();
+        if (avail > 0) {
+            int n = s->read(dst + got, min((size_t)avail, len - got));
+            if (n > 0) {
+                got += n;
+                lastData = millis();
+                continue;
+            }
+        }
+        if (!http.connected()) return false;
+        if (millis() - lastData > OTA_READ_TIMEOUT_MS) return false;
+        vTaskDelay(pdMS_TO_TICKS(2));
+    }
+    return true;
+}
+
+// ============================================================================
+// Control (core 1)
+// ============================================================================
+
+bool OtaUpdater::start(const char* url, const char* sha256Hex) {
+    State s = _state.load();
+    if (s == State::FETCHING || s == State::HELD || s == State::READY) {
+        bool same = url && strcmp(url, _url) == 0;
+        if (!same) Logger.printf("⚠️ [OTA] Busy with %s (%s)\n", _url, stateName());
+        return same;
+    }
+    if (!url || strlen(url) >= sizeof(_url)) {
+        Logger.println("❌ [OTA] Missing or too long URL");
+        return false;
+    }
+    strcpy(_url, url);
+    _haveSha = parseSha256Hex(sha256Hex, _sha256);
+    _written = 0;
+    _imageSize = 0;
+    _fetched = 0;
+    _resumes = 0;
+    _startedAt = millis();
+    _state = State::FETCHING;
+
+    TaskHandle_t task = nullptr;
+    xTaskCreatePinnedToCore(taskMain, "OtaFetch", OTA_UPDATER_STACK, this,
+                            OTA_UPDATER_PRIORITY, &task, 0);
+    if (!task) {
+        Logger.println("❌ [OTA] Failed to start OtaFetch task");
+        _state = State::FAILED;
+        return false;
+    }
+    Logger.printf("📥 [OTA] Background download: %s\n", _url);
+    return true;
+}
+
+void OtaUpdater::poll() {
+    bool busy = _busy && _busy();
+    _hold.store(busy);
+    if (_state.load() == State::READY && !busy) {
+        Logger.println("🔄 [OTA] Phone idle - rebooting into the new firmware");
+        Logger.flush();
+        delay(500);
+        esp_restart();
+    }
+}
+
+bool OtaUpdater::active() const {
+    State s = _state.load();
+    return s == State::FETCHING || s == State::HELD || s == State::READY;
+}
+
+const char* OtaUpdater::stateName() const {
+    switch (_state.load()) {
+        case State::IDLE:     return "idle";
+        case State::FETCHING: return "fetching";
+        case State::HELD:     return "held (phone in use)";
+        case State::READY:    return "ready (reboots when idle)";
+        case State::FAILED:   return "failed";
+    }
+    return "?";
+}
+
+void OtaUpdater::printStatus() {
+    Logger.printf("📥 OTA: %s\n", stateName());
+    if (_state.load() == State::IDLE) return;
+    uint32_t size = _imageSize.load();
+    uint32_t written = _written.load();
+    Logger.printf("   %s\n", _url);
+    Logger.printf("   %lu / %lu bytes flashed (%u%%), %lu downloaded, %lu resumes, %lus\n",
+                  (unsigned long)written, (unsigned long)size,
+                  size ? (unsigned)((uint64_t)written * 100 / size) : 0,
+                  (unsigned long)_fetched.load(), (unsigned long)_resumes.load(),
+                  (millis() - _startedAt) / 1000);
+}
+
+// ============================================================================
+// OtaFetch task (core 0)
+// ============================================================================
+
+void OtaUpdater::taskMain(void* arg) {
+    OtaUpdater* self = static_cast<OtaUpdater*>(arg);
+    self->_state = self->run() ? State::READY : State::FAILED;
+    vTaskDelete(NULL);
+}
+
+bool OtaUpdater::run() {
+    HttpClient http(HTTP_TIMEOUT_OTA_MS);
+    http.useOwnSecure();              // Off the main task
+
+    mbedtls_md_context_t sha;
+    mbedtls_md_init(&sha);
+    mbedtls_md_setup(&sha, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 0);
+    mbedtls_md_starts(&sha);
+
+    OtaImageHeader hdr;
+    bool haveHeader = false;
+    bool compressed = false;
+    bool begun = false;               // Update.begin() done
+    bool open = false;
+    bool complete = false;
+    uint8_t* packed = nullptr;        // Compressed block as received
+    uint8_t* block = nullptr;         // Bytes for Update.write()
+    uint32_t offset = 0;              // Download consumed, at a unit boundary
+    uint32_t total = 0;               // Download size
+    uint32_t retryMs = OTA_RETRY_MS;
+    int failures = 0;
+    int lastPercent = -1;
+
+    for (;;) {
+        if (_hold.load()) {
+            if (_state.load() != State::HELD) {
+                if (open) http.close();
+                open = false;
+                _state = State::HELD;
+                Logger.printf("⏸️ [OTA] Phone in use - holding at %lu bytes\n", (unsigned long)offset);
+            }
+            vTaskDelay(pdMS_TO_TICKS(OTA_HOLD_POLL_MS));
+            continue;
+        }
+
+        if (!open) {
+            if (failures > OTA_MAX_RETRIES) {
+                Logger.printf("❌ [OTA] Giving up after %d failed attempts\n", failures);
+                break;
+            }
+            if (failures > 0) {
+                vTaskDelay(pdMS_TO_TICKS(retryMs));
+                retryMs = min<uint32_t>(retryMs * 2, 60000);
+            }
+            char range[32];
+            snprintf(range, sizeof(range), "bytes=%lu-", (unsigned long)offset);
+            HttpClient::Header h = { "Range", range };
+            if (!http.get(_url, &h, offset > 0 ? 1 : 0)) {
+                int code = http.statusCode();
+                if (code >= 400 && code < 500) {
+                    Logger.printf("❌ [OTA] HTTP %d\n", code);
+                    break;
+                }
+                failures++;
+                continue;
+            }
+            if (offset > 0 && http.statusCode() != 206) {
+                // No Range support: start over from this response
+                Logger.println("⚠️ [OTA] Server ignored Range - restarting the download");
+                if (begun) Update.abort();
+                begun = haveHeader = false;
+                offset = 0;
+                _written = 0;
+                mbedtls_md_starts(&sha);
+            }
+            if (offset == 0) {
+                int size = http.getSize();
+                total = size > 0 ? (uint32_t)size : 0;
+            } else {
+                _resumes++;
+                Logger.printf("▶️ [OTA] Resuming at %lu bytes\n", (unsigned long)offset);
+            }
+            open = true;
+            _state = State::FETCHING;
+        }
+
+        // One unit: the header, a compressed block, or a raw chunk
+        uint32_t consumed = 0;
+        const uint8_t* out = nullptr;
+        size_t outLen = 0;
+        bool readOk;
+        if (!haveHeader) {
+            readOk = readExact(http, (uint8_t*)&hdr, sizeof(hdr));
+            if (readOk) {
+                consumed = sizeof(hdr);
+                compressed = memcmp(hdr.magic, OTA_IMAGE_MAGIC, 4) == 0;
+                if (compressed) {
+                    if (hdr.version != 1 || hdr.blockSize == 0 || hdr.blockSize > OTA_MAX_BLOCK_BYTES) {
+                        Logger.printf("❌ [OTA] Unsupported image (version %u, block %lu)\n",
+                                      hdr.version, (unsigned long)hdr.blockSize);
+                        break;
+                    }
+                    _imageSize = hdr.imageSize;
+                } else if (((uint8_t*)&hdr)[0] == 0xE9 && total > 0) {
+                    _imageSize = total;
+                    out = (const uint8_t*)&hdr;   // First bytes of the image itself
+                    outLen = sizeof(hdr);
+                } else {
+                    Logger.println("❌ [OTA] Not a firmware image (or no Content-Length)");
+                    break;
+                }
+                if (!block) {
+                    size_t blockCap = compressed ? hdr.blockSize : OTA_RAW_CHUNK_BYTES;
+                    block = (uint8_t*)psramAlloc(blockCap);
+                    packed = compressed ? (uint8_t*)psramAlloc(LZ4_BLOCK_BOUND(hdr.blockSize)) : nullptr;
+                    if (!block || (compressed && !packed)) {
+                        Logger.println("❌ [OTA] Out of memory for block buffers");
+                        break;
+                    }
+                }
+                if (!begun) {
+                    if (!Update.begin(_imageSize.load())) {
+                        Logger.printf("❌ [OTA] Not enough space: %s\n", Update.errorString());
+                        break;
+                    }
+                    begun = true;
+                }
+                haveHeader = true;
+                Logger.printf("📦 [OTA] %s image, %lu bytes\n",
+                              compressed ? "Compressed" : "Plain", (unsigned long)_imageSize.load());
+            }
+        } else if (compressed) {
+            uint32_t word = 0;
+            readOk = readExact(http, (uint8_t*)&word, sizeof(word));
+            size_t len = word & ~OTA_BLOCK_STORED;
+            size_t expect = min<uint32_t>(hdr.blockSize, _imageSize.load() - _written.load());
+            bool stored = (word & OTA_BLOCK_STORED) != 0;
+            if (readOk && (len > LZ4_BLOCK_BOUND(hdr.blockSize) || (stored && len != expect))) {
+                Logger.printf("❌ [OTA] Corrupt block at %lu\n", (unsigned long)offset);
+                break;
+            }
+            if (readOk && stored) {
+                readOk = readExact(http, block, len);
+                outLen = len;
+            } else if (readOk) {
+                readOk = readExact(http, packed, len);
+                if (readOk) {
+                    int n = lz4BlockDecompress(packed, len, block, hdr.blockSize);
+                    if (n < 0 || (size_t)n != expect) {
+                        Logger.printf("❌ [OTA] Corrupt block at %lu\n", (unsigned long)offset);
+                        break;
+                    }
+                    outLen = n;
+                }
+            }
+            out = block;
+            consumed = sizeof(word) + len;
+        } else {
+            outLen = min<uint32_t>(OTA_RAW_CHUNK_BYTES, total - offset);
+            readOk = readExact(http, block, outLen);
+            out = block;
+            consumed = outLen;
+        }
+
+        if (!readOk) {
+            // Partial unit dropped; the Range request picks it up again
+            http.close();
+            open = false;
+            failures++;
+            continue;
+        }
+        failures = 0;
+        retryMs = OTA_RETRY_MS;
+
+        if (outLen > 0) {
+            if (Update.write(const_cast<uint8_t*>(out), outLen) != outLen) {
+                Logger.printf("❌ [OTA] Write failed: %s\n", Update.errorString());
+                break;
+            }
+            mbedtls_md_update(&sha, out, outLen);
+            _written += outLen;
+        }
+        offset += consumed;
+        _fetched = offset;
+
+        uint32_t size = _imageSize.load();
+        int percent = size ? (int)((uint64_t)_written.load() * 100 / size) : 0;
+        if (percent / 10 != lastPercent / 10) {
+            Logger.printf("📤 [OTA] %d%%\n", percent);
+            lastPercent = percent;
+        }
+        if (_written.load() >= size) {
+            complete = true;
+            break;
+        }
+        vTaskDelay(1);
+    }
+    http.close();
+    psramFree(packed);
+    psramFree(block);
+
+    uint8_t digest[32];
+    mbedtls_md_finish(&sha, digest);
+    mbedtls_md_free(&sha);
+
+    if (complete) {
+        const uint8_t* expected = compressed ? hdr.sha256 : (_haveSha ? _sha256 : nullptr);
+        if (expected && memcmp(digest, expected, sizeof(digest)) != 0) {
+            Logger.println("❌ [OTA] SHA-256 mismatch - image discarded");
+            complete = false;
+        }
+    }
+    if (!complete) {
+        if (begun) Update.abort();
+        return false;
+    }
+    if (!Update.end(true)) {
+        Logger.printf("❌ [OTA] End failed: %s\n", Update.errorString());
+        return false;
+    }
+    Logger.printf("✅ [OTA] %lu bytes verified in %lus - reboots when the phone is idle\n",
+                  (unsigned long)_written.load(), (millis() - _startedAt) / 1000);
+    return true;
+}
@@ -3,7 +3,8 @@
 #include "logging.h"
 #include "wifi_manager.h"
 #include <WiFi.h>
-#include "http_utils.h"
+#include "http_pool.h"
+#include "net_worker.h"
 
 #ifndef FIRMWARE_VERSION
 #define FIRMWARE_VERSION "0.0.0"
@@ -17,6 +18,11 @@ static unsigned long phoneHomeInterval = UPDATE_CHECK_INTERVAL_MS;
 static unsigned long lastPhoneHomeTime = 0;
 static char phoneHomeStatus[64] = "Not started";
 static bool phoneHomeEnabled = true;
+static bool updateCheckInFlight = false;
+// ETag / Last-Modified of the last releases.json that needed no update, so
+// an unchanged manifest costs a 304. fetchedValidators is the NetIO copy.
+static HttpValidators releaseValidators;
+static HttpValidators fetchedValidators;
 
 void setPhoneHomeInterval(unsigned long intervalMs) {
     phoneHomeInterval = intervalMs;
@@ -99,31 +105,7 @@ static String findDeviceBlock(const String& json, const char* deviceKey) {
 //   "default": { ... }
 // }
 // Falls back to "default" key if hostname not found.
-bool checkForRemoteUpdates(const char* serverUrl) {
-    unsigned long now = millis();
-    if (!phoneHomeEnabled || now - lastPhoneHomeTime < phoneHomeInterval)
-        return false;
-    lastPhoneHomeTime = now;
-
-    if (!WiFi.isConnected()) {
-        strcpy(phoneHomeStatus, "WiFi not connected");
-        return false;
-    }
-    
-    const char* url = serverUrl ? serverUrl : UPDATE_CHECK_URL;
-    
-    Logger.printf("📞 Checking for updates: %s\n", url);
-    strcpy(phoneHomeStatus, "Checking...");
-    
-    HttpClient http(UPDATE_CHECK_TIMEOUT_MS);
-    
-    if (!http.get(url)) {
-        snprintf(phoneHomeStatus, sizeof(phoneHomeStatus), "HTTP error: %d", http.statusCode());
-        return false;
-    }
-    
-    String response = http.getString();
-    
+static bool applyUpdateInfo(const String& response) {
     Logger.printf("📞 Update info: %s\n", response.c_str());
     
     // Look up this device's block by OTA_HOSTNAME, fall back to "default"
@@ -140,6 +122,8 @@ bool checkForRemoteUpdates(const char* serverUrl) {
 
     String serverVersion = findJsonStringValue(deviceBlock, "version");
     String firmwareUrl   = findJsonStringValue(deviceBlock, "firmware_url");
+    String otaUrl        = findJsonStringValue(deviceBlock, "ota_url");    // Compressed image
+    String firmwareSha   = findJsonStringValue(deviceBlock, "sha256");
     String action        = findJsonStringValue(deviceBlock, "action");
     String message       = findJsonStringValue(deviceBlock, "message");
     
@@ -171,7 +155,11 @@ bool checkForRemoteUpdates(const char* serverUrl) {
                 Logger.printf("📥 Forced OTA to version %s\n", serverVersion.c_str());
             }
             snprintf(phoneHomeStatus, sizeof(phoneHomeStatus), "Updating to %s", serverVersion.c_str());
-            otaTriggered = performPullOTA(firmwareUrl.c_str());
+            if (otaUrl.length() > 0) {
+                otaTriggered = performPullOTA(otaUrl.c_str());
+            } else {
+                otaTriggered = performPullOTA(firmwareUrl.c_str(), firmwareSha.c_str());
+            }
         } else if (cmp == 0) {
             Logger.printf("✅ Firmware up to date: %s\n", currentVersion);
             snprintf(phoneHomeStatus, sizeof(phoneHomeStatus), "Up to date: %s", currentVersion);
@@ -186,3 +174,75 @@ bool checkForRemoteUpdates(const char* serverUrl) {
     
     return otaTriggered;
 }
+
+// Interval, enable and WiFi checks; the URL to fetch, or nullptr if not due
+static const char* startUpdateCheck(const char* serverUrl) {
+    unsigned long now = millis();
+    if (!phoneHomeEnabled || now - lastPhoneHomeTime < phoneHomeInterval)
+        return nullptr;
+    lastPhoneHomeTime = now;
+
+    if (!WiFi.isConnected()) {
+        strcpy(phoneHomeStatus, "WiFi not connected");
+        return nullptr;
+    }
+
+    const char* url = serverUrl ? serverUrl : UPDATE_CHECK_URL;
+    Logger.printf("📞 Checking for updates: %s\n", url);
+    strcpy(phoneHomeStatus, "Checking...");
+    return url;
+}
+
+// Apply a fetched releases.json. Its validators are only kept when no OTA
+// started, so a failed update is retried with a full GET.
+static bool applyReleases(const String& response) {
+    bool otaTriggered = applyUpdateInfo(response);
+    if (otaTriggered) releaseValidators.clear();
+    else releaseValidators = fetchedValidators;
+    return otaTriggered;
+}
+
+bool checkForRemoteUpdates(const char* serverUrl) {
+    const char* url = startUpdateCheck(serverUrl);
+    if (!url) return false;
+
+    String response;
+    fetchedValidators = releaseValidators;
+    {
+        HttpLease http(url, UPDATE_CHECK_TIMEOUT_MS);
+        if (!http->getIfChanged(url, fetchedValidators)) {
+            if (http->notModified()) {
+                strcpy(phoneHomeStatus, "Up to date (unchanged)");
+            } else {
+                snprintf(phoneHomeStatus, sizeof(phoneHomeStatus), "HTTP error: %d", http->statusCode());
+            }
+            return false;
+        }
+        response = http->getString();
+    }
+    return applyReleases(response);
+}
+
+// NetIO completion, run on core 1 by netWorker.poll()
+static void onUpdateInfo(bool ok, int statusCode, const String& body, void*) {
+    updateCheckInFlight = false;
+    if (!ok) {
+        snprintf(phoneHomeStatus, sizeof(phoneHomeStatus), "HTTP error: %d", statusCode);
+        return;
+    }
+    if (statusCode == 304) {
+        strcpy(phoneHomeStatus, "Up to date (unchanged)");
+        return;
+    }
+    applyReleases(body);
+}
+
+void pollRemoteUpdates() {
+    if (updateCheckInFlight) return;
+    const char* url = startUpdateCheck(nullptr);
+    if (!url) return;
+    fetchedValidators = releaseValidators;
+    updateCheckInFlight = netWorker.getString(url, onUpdateInfo, nullptr, UPDATE_CHECK_TIMEOUT_MS,
+                                              &fetchedValidators);
+    if (!updateCheckInFlight) strcpy(phoneHomeStatus, "Request queue full");
+}
@@ -2,23 +2,25 @@
 #include "config.h"
 #include "logging.h"
 #include "tone_generators.h"
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
 
 PhoneService Phone;
 
 PhoneService::PhoneService() 
 #ifdef CAN_RING
     : _pinFR(F_R), _pinRM(RM), _pinSHK(SHK),
-      _isRinging(false), _isOffHook(false), _lastShkReading(false),
+      _isRinging(false), _isOffHook(false),
       _debugOverride(false), _debugOverrideExpiry(0),
       _lastRingToggleTime(0), _ringState(false),
-      _lastDebounceTime(0), _debounceDelay(50),
-      _hookCallback(nullptr) {
+      _hookCallback(nullptr), _pulseDigitCallback(nullptr) {
 #else
     : _pinSHK(SHK),
-      _isOffHook(false), _lastShkReading(false),
+      _isOffHook(false),
       _debugOverride(false), _debugOverrideExpiry(0),
-      _lastDebounceTime(0), _debounceDelay(50),
-      _hookCallback(nullptr) {
+      _hookCallback(nullptr), _pulseDigitCallback(nullptr) {
 #endif
 }
 
@@ -44,7 +46,10 @@ void PhoneService::begin() {
     #else
     _isOffHook = digitalRead(_pinSHK);
     #endif
-    _lastShkReading = _isOffHook;
+    _lineOffHook = _reportedOffHook = _isOffHook;
+    #ifndef ASSUME_HOOK
+    startHookInterrupt();
+    #endif
     
 #ifdef CAN_RING
     Logger.printf("📞 Phone Service Ready (ringing enabled). Initial State: %s\n", _isOffHook ? "OFF HOOK" : "ON HOOK");
@@ -140,34 +145,201 @@ void PhoneService::stopRinging() {}
 bool PhoneService::isRinging() const { return false; }
 #endif
 
-void PhoneService::checkHookState() {
-    // Skip physical hook checking when debug override is active
-    if (_debugOverride) {
+// ============================================================================
+// Hook sensing: GPIO edge ISR → settle timer → loop()
+// ============================================================================
+
+void PhoneService::startHookInterrupt() {
+    _hookEvents = xQueueCreate(8, sizeof(HookEvent));
+    _settleTimer = xTimerCreate("HookSettle", pdMS_TO_TICKS(HOOK_DEBOUNCE_MS), pdFALSE,
+                                this, onSettleTimer);
+    if (!_hookEvents || !_settleTimer) {
+        Logger.println("❌ Hook interrupt setup failed - hook changes won't be seen");
         return;
     }
-    
-#ifdef ASSUME_HOOK
-    bool reading = false;
+    attachInterruptArg(digitalPinToInterrupt(_pinSHK), onHookEdge, this, CHANGE);
+#if HOOK_PULSE_DIAL
+    Logger.printf("📞 Hook: edge interrupt, %d ms settle, pulse dial decoding on\n", HOOK_DEBOUNCE_MS);
 #else
-    bool reading = digitalRead(_pinSHK);
-#endif    
-    // If the switch changed, reset the debouncing timer
-    if (reading != _lastShkReading) {
-        _lastDebounceTime = millis();
-        _lastShkReading = reading; // Update last reading to track stability
+    Logger.printf("📞 Hook: edge interrupt, %d ms settle\n", HOOK_DEBOUNCE_MS);
+#endif
+}
+
+// Timestamp the edge and restart the settle window
+void IRAM_ATTR PhoneService::onHookEdge(void* arg) {
+    PhoneService* self = static_cast<PhoneService*>(arg);
+    if (self->_wakeArmed) {
+        // Woken from light sleep: the level interrupt would fire until the
+        // line drops again, so go back to edges now
+        portENTER_CRITICAL_ISR(&self->_wakeMux);
+        gpio_ll_wakeup_disable(&GPIO, (gpio_num_t)self->_pinSHK);
+        gpio_ll_set_intr_type(&GPIO, (gpio_num_t)self->_pinSHK, GPIO_INTR_ANYEDGE);
+        self->_wakeArmed = false;
+        portEXIT_CRITICAL_ISR(&self->_wakeMux);
     }
-    
-    if ((millis() - _lastDebounceTime) > _debounceDelay) {
-        // Whatever the reading is at, it's been there for longer than the debounce
-        // delay, so take it as the actual current state:
-        
-        if (reading != _isOffHook) {
+    uint32_t head = self->_edgeHead;
+    self->_edgeUs[head & (kEdgeRing - 1)] = (uint32_t)esp_timer_get_time();
+    self->_edgeHead = head + 1;
+
+    BaseType_t woken = pdFALSE;
+    xTimerChangePeriodFromISR(self->_settleTimer, pdMS_TO_TICKS(HOOK_DEBOUNCE_MS), &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+void PhoneService::onSettleTimer(TimerHandle_t timer) {
+    static_cast<PhoneService*>(pvTimerGetTimerID(timer))->settle();
+}
+
+void PhoneService::queueHookEvent(HookEventType type, char digit, uint32_t edgeUs) {
+    if (type != HookEventType::DIGIT) {
+        _reportedOffHook = type == HookEventType::OFF_HOOK;
+    }
+    HookEvent e = { type, digit, edgeUs };
+    xQueueSend(_hookEvents, &e, 0);
+}
+
+// Timer task: the line has been quiet for HOOK_DEBOUNCE_MS, or a pulse-dial
+// deadline is due
+void PhoneService::settle() {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+
+    // The first edge of the burst dates the change; the others were bounce
+    uint32_t head = _edgeHead;
+    uint32_t edges = head - _edgeTail;
+    uint32_t edgeUs = now;
+    if (edges > 0) {
+        uint32_t first = edges > kEdgeRing ? head - kEdgeRing : _edgeTail;
+        edgeUs = _edgeUs[first & (kEdgeRing - 1)];
+        _edgeTail = head;
+    }
+
+    bool level = digitalRead(_pinSHK);
+    if (level == _lineOffHook) {
+        _bounces += edges;                // Glitch: there and back
+    } else {
+        if (edges > 1) _bounces += edges - 1;
+        _lineOffHook = level;
+#if HOOK_PULSE_DIAL
+        if (!level && _reportedOffHook) {
+            // A dial pulse, or the start of a hang-up
+            _breakStartUs = edgeUs;
+            _deadlineUs = edgeUs + HOOK_PULSE_BREAK_MAX_MS * 1000UL;
+        } else if (level && _breakStartUs) {
+            if (edgeUs - _breakStartUs <= HOOK_PULSE_BREAK_MAX_MS * 1000UL) {
+                _pulses++;
+                _deadlineUs = edgeUs + HOOK_PULSE_DIGIT_GAP_MS * 1000UL;
+            } else {
+                // The deadline fell inside this settle window: hung up, picked up
+                queueHookEvent(HookEventType::ON_HOOK, 0, _breakStartUs);
+                queueHookEvent(HookEventType::OFF_HOOK, 0, edgeUs);
+                _pulses = 0;
+                _deadlineUs = 0;
+            }
+            _breakStartUs = 0;
+        } else
+#endif
+        if (level != _reportedOffHook) {
+            queueHookEvent(level ? HookEventType::OFF_HOOK : HookEventType::ON_HOOK, 0, edgeUs);
+        }
+    }
+
+#if HOOK_PULSE_DIAL
+    if (_deadlineUs != 0 && (int32_t)(now - _deadlineUs) >= 0) {
+        _deadlineUs = 0;
+        if (_breakStartUs) {
+            // Stayed on-hook past a pulse: hang-up
+            queueHookEvent(HookEventType::ON_HOOK, 0, _breakStartUs);
+            _breakStartUs = 0;
+        } else if (_pulses > 0 && _pulses <= 10) {
+            queueHookEvent(HookEventType::DIGIT, _pulses == 10 ? '0' : (char)('0' + _pulses), now);
+        }
+        _pulses = 0;
+    }
+    if (_deadlineUs != 0) {
+        uint32_t waitMs = (_deadlineUs - now + 999) / 1000;
+        xTimerChangePeriod(_settleTimer, max<TickType_t>(1, pdMS_TO_TICKS(waitMs)), 0);
+    }
+#endif
+}
+
+// loop(): apply what the settle timer queued
+void PhoneService::checkHookState() {
+    if (!_hookEvents) {
+        return;
+    }
+    HookEvent e;
+    while (xQueueReceive(_hookEvents, &e, 0) == pdTRUE) {
+        // Skip physical hook changes when debug override is active; its
+        // expiry syncs to the pin
+        if (_debugOverride) {
+            continue;
+        }
+        uint32_t latencyUs = (uint32_t)esp_timer_get_time() - e.edgeUs;
+        if (e.type == HookEventType::DIGIT) {
+            _pulseDigits++;
+            Logger.printf("☎️ Pulse digit '%c'\n", e.digit);
+            if (_pulseDigitCallback) {
+                _pulseDigitCallback(e.digit);
+            }
+            continue;
+        }
+        bool offHook = e.type == HookEventType::OFF_HOOK;
+        if (offHook != _isOffHook) {
+            _hookChanges++;
+            _lastLatencyUs = latencyUs;
+            if (latencyUs > _maxLatencyUs) _maxLatencyUs = latencyUs;
             // Use setOffHook to handle state change, ringing stop, and callback
-            setOffHook(reading, false); // false = not from debug
+            setOffHook(offHook, false); // false = not from debug
         }
     }
 }
 
+bool PhoneService::waitHookEvent(uint32_t timeoutMs) const {
+    if (!_hookEvents) {
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+        return false;
+    }
+    HookEvent e;
+    return xQueuePeek(_hookEvents, &e, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+void PhoneService::armHookWake(bool armed) {
+#ifndef ASSUME_HOOK
+    if (!_settleTimer) {
+        return;
+    }
+    gpio_num_t pin = (gpio_num_t)_pinSHK;
+    portENTER_CRITICAL(&_wakeMux);
+    if (armed && !_wakeArmed) {
+        // Wake on the off-hook level (SHK reads HIGH off hook)
+        _wakeArmed = true;
+        gpio_wakeup_enable(pin, GPIO_INTR_HIGH_LEVEL);
+    } else if (!armed && _wakeArmed) {
+        _wakeArmed = false;
+        gpio_wakeup_disable(pin);
+        gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+    }
+    portEXIT_CRITICAL(&_wakeMux);
+#endif
+}
+
+bool PhoneService::hookEventPending() const {
+    return _hookEvents && uxQueueMessagesWaiting(_hookEvents) > 0;
+}
+
+void PhoneService::printHookStats() const {
+    Logger.printf("📞 Hook: %s, line %s, %d ms settle%s\n",
+                  _isOffHook ? "OFF HOOK" : "ON HOOK",
+                  _lineOffHook ? "off-hook" : "on-hook", HOOK_DEBOUNCE_MS,
+                  _debugOverride ? " (debug override)" : "");
+    Logger.printf("   %lu changes, edge → loop() last %lu us, max %lu us; %lu bounce edges\n",
+                  (unsigned long)_hookChanges, (unsigned long)_lastLatencyUs,
+                  (unsigned long)_maxLatencyUs, (unsigned long)_bounces);
+#if HOOK_PULSE_DIAL
+    Logger.printf("   %lu pulse digits\n", (unsigned long)_pulseDigits);
+#endif
+}
+
 void PhoneService::setHookCallback(HookStateCallback callback) {
     _hookCallback = callback;
 }
@@ -17,8 +17,9 @@
  *   Standard Goertzel for all 8 DTMF frequencies with:
  *   1. Per-block magnitude accumulation (strongest row + strongest col)
  *   2. Twist ratio check (max 12:1 to accommodate asymmetric bands)  
- *   3. Consecutive-block debouncing (3 blocks = ~139ms at block_size=2048)
- *   4. Key release after 4 consecutive silent blocks (~185ms)
+ *   3. Sliding-window debouncing (46ms window, 11.6ms hop at the
+ *      decimated 8820Hz detector rate, 5 consecutive hits = ~58ms)
+ *   4. Key release after 4 consecutive silent hops (~46ms past the window)
  * 
  * Verified tones from signal analysis:
  *   '#' = 941 Hz + 1477 Hz (twist ~4-9x)
@@ -39,28 +40,40 @@ const char DTMF_KEYPAD[4][4] = {
 };
 
 // Bowie Phone configuration - standard DTMF (repaired hardware)
-static const PhoneConfig BOWIE_PHONE_CONFIG = {
+// Not const: runtime tunables (tunables.h) adjust it through getTunablePhoneConfig()
+static PhoneConfig BOWIE_PHONE_CONFIG = {
     // Identification
     .name = "Bowie Phone",
     .description = "ESP32-A1S AudioKit with SLIC - standard DTMF fundamentals (repaired)",
     // Frequency scaling
     .freqScale = 1.0f,
-    .goertzelBlockSize = 2048, // ~46ms blocks @ 44100Hz (good SNR, low overhead)
-    // Number of consecutive silent blocks before considering key released
-    .requiredConsecutive = 2, // 2 consecutive matching blocks to confirm
-    .releaseBlockCount = 2,   // 2 consecutive silent blocks to consider key released
+    .goertzelWindowMs = 46.4f, // Long window for SNR on the weak row band (408 samples @ 8820Hz)
+    // Sliding window: evaluate every ~11.6ms over the last 4 hops
+    .goertzelHopMs = 11.6f,
+    // Counts are in hops. 5 hits = one fully tone-filled window plus one more
+    // → digit confirmed ~58ms after onset (was 2 blocks = 93-139ms)
+    .requiredConsecutive = 5,
+    .releaseBlockCount = 4,   // One window's worth of silent hops to consider key released
     // Maximum twist ratio (high/low magnitude) to accept as valid DTMF
     // Bowie Phone has asymmetric band magnitudes: high band 2-9x stronger than low
     .maxTwistRatio = 12.0f,
     // Goertzel-specific timing
-    .goertzelCopierBufferSize = 2048, // Match block size for efficiency
+    .goertzelCopierBufferSize = 1024, // ~one hop of 44.1kHz mono input (was one 2048-sample block)
 
     // Detection thresholds
-    // GoertzelStream fires callback when magnitude > threshold
+    // Bins at or below threshold are treated as absent for the block
     // With normalized magnitudes: noise ~0.1-2.0, real tones ~50-500+
     // Set low enough to catch weak row frequencies, debouncing handles noise
     .fundamentalMagnitudeThreshold = 10.0f,
     .minDetectionMagnitude = 40.0f,   // Reject DAC→ADC loopback artifacts (typ. 12-24)
+    // Relative to the running noise floor (absolute values above stay as minimums);
+    // *#225# calibration replaces these from a keypad sweep
+    .presenceSnrDb = 12.0f,
+    .detectionSnrDb = 20.0f,
+    // Talk-off: speech/music carry strong 2nd harmonics and spread energy
+    // across the band; a key press puts most of it in two clean tones
+    .maxHarmonicRatio = 0.25f,  // -12dB; clean generators are < -20dB
+    .minToneEnergyRatio = 0.5f,
     .summedMagnitudeThreshold = 0.0f, // Not used - standard DTMF only
     .freqTolerance = 75.0f,           // Hz tolerance for freq matching
     .summedFreqTolerance = 0.0f,      // Not used
@@ -89,6 +102,10 @@ const PhoneConfig& getPhoneConfig() {
     return BOWIE_PHONE_CONFIG;
 }
 
+PhoneConfig& getTunablePhoneConfig() {
+    return BOWIE_PHONE_CONFIG;
+}
+
 // Helper: Decode COLUMN from summed frequency - NOT USED for repaired hardware
 static int getColumnFromSummedFreq(float freq) {
     (void)freq;
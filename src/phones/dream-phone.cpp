@@ -51,7 +51,8 @@ static const int DREAM_SUMMED_FREQ_TABLE_SIZE =
 
 // Dream Phone configuration
 // NOTE: Field order MUST match PhoneConfig struct in phone.h
-static const PhoneConfig DREAM_PHONE_CONFIG = {
+// Not const: runtime tunables (tunables.h) adjust it through getTunablePhoneConfig()
+static PhoneConfig DREAM_PHONE_CONFIG = {
     // Identification
     .name = "Dream Phone",
     .description = "ESP32-A1S AudioKit with SLIC - shifted frequencies, dial tone interference",
@@ -60,7 +61,8 @@ static const PhoneConfig DREAM_PHONE_CONFIG = {
     .freqScale = 1.0f,
 
     // Goertzel-specific timing (must come before detection thresholds per struct order)
-    .goertzelBlockSize = 512,                // ~11.6ms blocks @ 44100Hz
+    .goertzelWindowMs = 11.6f,               // Short blocks (102 samples @ 8820Hz)
+    .goertzelHopMs = 0,                      // Non-overlapping: 4 × 11.6ms already confirms in ~46ms
     .requiredConsecutive = 4,                // Increased from 3 - more samples for reliability
     .releaseBlockCount = 4,                  // Match requiredConsecutive for consistency
     .maxTwistRatio = 6.0f,                   // Tighter than Bowie — Dream Phone has more balanced bands
@@ -69,6 +71,10 @@ static const PhoneConfig DREAM_PHONE_CONFIG = {
     // Detection thresholds
     .fundamentalMagnitudeThreshold = 20.0f,  // Lower threshold for standard DTMF
     .minDetectionMagnitude = 40.0f,          // Reject DAC→ADC loopback artifacts
+    .presenceSnrDb = 12.0f,                  // dB over the running noise floor (absolute values are minimums)
+    .detectionSnrDb = 20.0f,
+    .maxHarmonicRatio = 0,                   // Off: intermodulation products land near the harmonics
+    .minToneEnergyRatio = 0,                 //   and take a share of the block energy
     .summedMagnitudeThreshold = 100.0f,      // Strong signals (200-500 observed)
     .freqTolerance = 50.0f,                  // Standard tolerance
     .summedFreqTolerance = 70.0f,            // Hz tolerance for summed frequency
@@ -102,6 +108,10 @@ const PhoneConfig& getPhoneConfig() {
     return DREAM_PHONE_CONFIG;
 }
 
+PhoneConfig& getTunablePhoneConfig() {
+    return DREAM_PHONE_CONFIG;
+}
+
 // Helper: Decode button from summed frequency
 char decodeFromSummedFreq(float freq) {
     const PhoneConfig& config = DREAM_PHONE_CONFIG;
@@ -0,0 +1,222 @@
+/**
+ * @file power_manager.cpp
+ * @brief Low-power state while the phone sits on-hook
+ *
+ * @date 2026
+ */
+
+#include "power_manager.h"
+#include "AudioTools.h"
+#include "AudioTools/AudioLibs/AudioBoardStream.h"
+#include "dtmf_goertzel.h"
+#include "logging.h"
+#include "mic_ring_buffer.h"
+#include "phone_service.h"
+#include <driver/i2s.h>
+#include <driver/uart.h>
+#include <esp_sleep.h>
+#include <Wire.h>
+
+PowerManager powerManager;
+
+// ES8388 power control registers
+static constexpr uint8_t ES8388_CHIPPOWER = 0x02;  // Vrefs, DLLs, state machines, digital
+static constexpr uint8_t ES8388_ADCPOWER  = 0x03;  // ADCs, PGAs, mic bias
+static constexpr uint8_t ES8388_DACPOWER  = 0x04;  // DACs and output drivers
+
+static bool codecWrite(uint8_t reg, uint8_t value)
+{
+    Wire.beginTransmission(POWER_CODEC_I2C_ADDR);
+    Wire.write(reg);
+    Wire.write(value);
+    return Wire.endTransmission() == 0;
+}
+
+static bool codecRead(uint8_t reg, uint8_t& value)
+{
+    Wire.beginTransmission(POWER_CODEC_I2C_ADDR);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom((uint8_t)POWER_CODEC_I2C_ADDR, (uint8_t)1) != 1) return false;
+    value = Wire.read();
+    return true;
+}
+
+void PowerManager::begin(audio_tools::AudioBoardStream& kit)
+{
+    _kit = &kit;
+    esp_wifi_get_ps(&_activePs);
+
+    esp_pm_config_esp32_t pm = {};
+    pm.max_freq_mhz = POWER_MAX_FREQ_MHZ;
+    pm.min_freq_mhz = POWER_MIN_FREQ_MHZ;
+    pm.light_sleep_enable = POWER_LIGHT_SLEEP;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK && pm.light_sleep_enable) {
+        // No tickless idle in this sdkconfig: frequency scaling only
+        pm.light_sleep_enable = false;
+        err = esp_pm_configure(&pm);
+    }
+    _lightSleep = err == ESP_OK && pm.light_sleep_enable;
+
+    // Held while active; released in low power
+    if (err == ESP_OK) {
+        esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "phone", &_cpuLock);
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "phone", &_sleepLock);
+        if (_cpuLock) esp_pm_lock_acquire(_cpuLock);
+        if (_sleepLock) esp_pm_lock_acquire(_sleepLock);
+    }
+
+    if (_lightSleep) {
+        esp_sleep_enable_gpio_wakeup();
+        // Serial console: the first few characters wake the chip (and are lost)
+        uart_set_wakeup_threshold(UART_NUM_0, 3);
+        esp_sleep_enable_uart_wakeup(UART_NUM_0);
+    }
+
+    if (err != ESP_OK) {
+        Logger.printf("⚠️ [POWER] esp_pm unavailable (%s) - low power keeps full CPU speed\n",
+                      esp_err_to_name(err));
+    } else {
+        Logger.printf("🔋 [POWER] %s, %d-%d MHz, low power after %lus idle on-hook\n",
+                      _lightSleep ? "light sleep" : "frequency scaling",
+                      POWER_MIN_FREQ_MHZ, POWER_MAX_FREQ_MHZ,
+                      (unsigned long)(POWER_IDLE_MS / 1000));
+    }
+}
+
+void PowerManager::tick()
+{
+    bool idle = _enabled && _kit && _idle && _idle();
+    if (_lowPower) {
+        if (!idle) wake();
+        return;
+    }
+    if (!idle) {
+        _idleSince = 0;
+        return;
+    }
+    unsigned long now = millis();
+    if (_idleSince == 0) {
+        _idleSince = now;
+    } else if (now - _idleSince >= POWER_IDLE_MS) {
+        enter();
+    }
+}
+
+void PowerManager::enter()
+{
+    // Audio in: park the Goertzel task, then stop reading I2S
+    setGoertzelPaused(true);
+    stopMicCapture();
+
+    // Audio out: codec quiet and the I2S clocks off
+    _kit->setMute(true);
+    _kit->setPAPower(false);
+    i2s_zero_dma_buffer(POWER_I2S_PORT);
+    i2s_stop(POWER_I2S_PORT);
+    codecPowerDown();
+
+    esp_wifi_get_ps(&_activePs);
+    esp_wifi_set_ps(POWER_WIFI_PS);
+
+    Phone.armHookWake(true);
+    if (_cpuLock) esp_pm_lock_release(_cpuLock);
+    if (_sleepLock) esp_pm_lock_release(_sleepLock);
+
+    _lowPower = true;
+    _enters++;
+    _enteredAt = millis();
+    Logger.println("🔋 [POWER] On-hook idle - low power");
+}
+
+void PowerManager::wake()
+{
+    if (!_lowPower) {
+        return;
+    }
+    uint32_t t0 = micros();
+
+    if (_cpuLock) esp_pm_lock_acquire(_cpuLock);
+    if (_sleepLock) esp_pm_lock_acquire(_sleepLock);
+    Phone.armHookWake(false);
+    esp_wifi_set_ps(_activePs);
+
+    // Codec powered before its clocks return; start from silence, not
+    // whatever was left in the DMA ring
+    codecPowerRestore();
+    i2s_zero_dma_buffer(POWER_I2S_PORT);
+    i2s_start(POWER_I2S_PORT);
+    _kit->setPAPower(true);
+    _kit->setMute(false);
+
+    startMicCapture(*_kit);
+    setGoertzelPaused(false);
+
+    _lowPower = false;
+    _idleSince = 0;
+    _lowPowerMs += millis() - _enteredAt;
+    _lastWakeUs = micros() - t0;
+    if (_lastWakeUs > _maxWakeUs) _maxWakeUs = _lastWakeUs;
+    Logger.printf("🔋 [POWER] Awake in %lu us\n", (unsigned long)_lastWakeUs);
+}
+
+// Save the three power registers, then switch off the analog paths before
+// the references and state machines they run on
+void PowerManager::codecPowerDown()
+{
+#if POWER_CODEC_SHUTDOWN
+    if (!codecRead(ES8388_CHIPPOWER, _codecPower[0]) ||
+        !codecRead(ES8388_ADCPOWER, _codecPower[1]) ||
+        !codecRead(ES8388_DACPOWER, _codecPower[2])) {
+        Logger.println("⚠️ [POWER] ES8388 not answering on I2C - codec left powered");
+        return;
+    }
+    _codecDown = codecWrite(ES8388_DACPOWER, 0xC0)     // DACs down, outputs off
+              && codecWrite(ES8388_ADCPOWER, 0xFF)     // ADCs, PGAs, mic bias down
+              && codecWrite(ES8388_CHIPPOWER, 0xFF);   // Vrefs, DLLs down, state machines reset
+    if (!_codecDown) {
+        // Part-way: put back what was written
+        _codecDown = true;
+        codecPowerRestore();
+        Logger.println("⚠️ [POWER] ES8388 power-down failed - codec left powered");
+    }
+#endif
+}
+
+// Reverse order: chip power (releases the state machine resets) first
+void PowerManager::codecPowerRestore()
+{
+    if (!_codecDown) return;
+    bool ok = codecWrite(ES8388_CHIPPOWER, _codecPower[0])
+           && codecWrite(ES8388_ADCPOWER, _codecPower[1])
+           && codecWrite(ES8388_DACPOWER, _codecPower[2]);
+    if (!ok) {
+        Logger.println("❌ [POWER] ES8388 power restore failed");
+    }
+    _codecDown = false;
+}
+
+void PowerManager::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+    _idleSince = 0;
+    if (!enabled) wake();
+}
+
+void PowerManager::printStatus()
+{
+    unsigned long lowMs = _lowPowerMs + (_lowPower ? millis() - _enteredAt : 0);
+    Logger.printf("🔋 Power: %s%s, %s, %d-%d MHz\n",
+                  _lowPower ? "LOW POWER" : "active",
+                  _enabled ? "" : " (disabled)",
+                  _lightSleep ? "light sleep" : (_cpuLock ? "frequency scaling" : "no esp_pm"),
+                  POWER_MIN_FREQ_MHZ, POWER_MAX_FREQ_MHZ);
+    Logger.printf("   %lu entries, %lus in low power, wake last %lu us, max %lu us\n",
+                  (unsigned long)_enters, lowMs / 1000,
+                  (unsigned long)_lastWakeUs, (unsigned long)_maxWakeUs);
+    if (!_lowPower && _idleSince != 0) {
+        Logger.printf("   Idle for %lus of %lus\n",
+                      (millis() - _idleSince) / 1000, (unsigned long)(POWER_IDLE_MS / 1000));
+    }
+}
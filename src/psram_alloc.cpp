@@ -0,0 +1,96 @@
+/**
+ * @file psram_alloc.cpp
+ * @brief PSRAM placement helpers, a bump arena, and heap statistics
+ *
+ * @date 2026
+ */
+
+#include "psram_alloc.h"
+#include "esp_heap_caps.h"
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+void* psramAlloc(size_t bytes) {
+    void* p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p) p = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    return p;
+}
+
+void* psramRealloc(void* ptr, size_t bytes) {
+    void* p = heap_caps_realloc(ptr, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p) p = heap_caps_realloc(ptr, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    return p;
+}
+
+void psramFree(void* ptr) {
+    heap_caps_free(ptr);
+}
+
+// ============================================================================
+// PsramArena
+// ============================================================================
+
+// Aligned bytes after the first `used` of a chunk's data, or nullptr if they don't fit
+static void* takeFrom(uint8_t* data, size_t size, size_t& used, size_t bytes, size_t align) {
+    uintptr_t next = reinterpret_cast<uintptr_t>(data) + used;
+    size_t pad = (align - next % align) % align;
+    if (used + pad + bytes > size) return nullptr;
+    used += pad + bytes;
+    return reinterpret_cast<void*>(next + pad);
+}
+
+void* PsramArena::alloc(size_t bytes, size_t align) {
+    void* p = chunks ? takeFrom(reinterpret_cast<uint8_t*>(chunks + 1), chunks->size,
+                                chunks->used, bytes, align)
+                     : nullptr;
+    if (!p) {
+        // New chunk; a large request gets one of its own size
+        size_t size = bytes + align > chunkBytes ? bytes + align : chunkBytes;
+        Chunk* c = static_cast<Chunk*>(psramAlloc(sizeof(Chunk) + size));
+        if (!c) return nullptr;
+        c->next = chunks;
+        c->size = size;
+        c->used = 0;
+        chunks = c;
+        reservedBytes += size;
+        p = takeFrom(reinterpret_cast<uint8_t*>(c + 1), c->size, c->used, bytes, align);
+    }
+    usedBytes += bytes;
+    return p;
+}
+
+void PsramArena::reset() {
+    while (chunks) {
+        Chunk* next = chunks->next;
+        psramFree(chunks);
+        chunks = next;
+    }
+    usedBytes = 0;
+    reservedBytes = 0;
+}
+
+// ============================================================================
+// Heap statistics
+// ============================================================================
+
+HeapStats sampleHeap() {
+    HeapStats s;
+    s.internalFree    = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    s.internalLargest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    s.internalMinFree = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    s.psramFree       = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    s.psramLargest    = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    s.internalFragPct = s.internalFree
+        ? (uint8_t)(100 - (uint64_t)s.internalLargest * 100 / s.internalFree) : 0;
+    return s;
+}
+
+int formatHeapStats(const HeapStats& s, char* out, size_t cap) {
+    return snprintf(out, cap,
+                    "int %lu free / %lu largest (%u%% frag), min %lu; psram %lu free / %lu largest",
+                    (unsigned long)s.internalFree, (unsigned long)s.internalLargest,
+                    (unsigned)s.internalFragPct, (unsigned long)s.internalMinFree,
+                    (unsigned long)s.psramFree, (unsigned long)s.psramLargest);
+}
@@ -3,9 +3,14 @@
 #include "tailscale_manager.h"
 #include "wifi_manager.h"
 #include <WiFi.h>
-#include "http_utils.h"
+#include "http_pool.h"
+#include "boot_pipeline.h"
+#include "psram_alloc.h"
+#include "web_page.h"
+#include "web_server_task.h"
 #include <Preferences.h>
 #include <WebServer.h>
+#include <esp_heap_caps.h>
 #include <esp_system.h>
 
 #ifndef FIRMWARE_VERSION
@@ -18,78 +23,205 @@ RemoteLoggerClass RemoteLogger;
 // NVS namespace for remote logger config
 #define REMOTE_LOG_NVS_NAMESPACE "remotelog"
 
+// TCP stream, after the handshake:
+//   phone → server  'F' flags:u8 seq:u32 rawLen:u16 len:u16 payload[len]
+//                   (flags: REMOTE_LOG_FRAME_LZ4, REMOTE_LOG_FRAME_METRICS)
+//   server → phone  'K' seq:u32    (every frame up to seq received)
+#define REMOTE_LOG_PROTO 2
+#define REMOTE_LOG_WIRE_HEADER 10
+#define REMOTE_LOG_ACK_BYTES 5
+
 static Preferences remoteLogPrefs;
 
+// Last heap sample, kept across panic/WDT resets so the boot notification can
+// show how the heap looked shortly before the crash
+#define HEAP_SAMPLE_MAGIC 0x48454150  // "HEAP"
+RTC_NOINIT_ATTR static uint32_t rtcHeapMagic;
+RTC_NOINIT_ATTR static uint32_t rtcHeapUptimeSec;
+RTC_NOINIT_ATTR static HeapStats rtcHeap;
+
 static const char* REMOTE_LOG_DROPPED_LINE =
     "[I] StreamCopy.h : 187 - StreamCopy::copy  2048 -> 2048 -> 2048 bytes - in 1 hops";
 
 RemoteLoggerClass::RemoteLoggerClass() 
-    : lineCount(0), lastFlushTime(0), enabled(false), vpnRequired(true),
-      bootSent(false), _streamingEnabled(true), _postPending(false),
+    : _buf(nullptr), _spoolBytes(0), _lock(nullptr), _shipTask(nullptr),
+      _frameLen(0), _lineStart(0), _frameStarted(0), _nextSeq(0),
+      _spoolHead(0), _spoolTail(0), _sendOffset(0),
+      _framesDropped(0), _framesAcked(0), _rawBytes(0), _packedBytes(0),
+      _lastHeapStats(0),
+      enabled(false), vpnRequired(true),
+      bootSent(false), _streamingEnabled(true),
       _consecutiveFailures(0), _backoffUntil(0),
-      _serverTcpEnabled(false), _serverConnected(false),
+      _serverTcpEnabled(false), _serverConnected(false), _serverMetrics(false),
       _serverIsTelnetClient(false), _serverTcpPort(REMOTE_LOG_TCP_PORT),
       _tcpConsecutiveFailures(0), _tcpBackoffUntil(0) {
     serverUrl[0] = '\0';
     deviceId[0] = '\0';
     bootId[0] = '\0';
     _serverHost[0] = '\0';
-    // NOTE: Do NOT call esp_random() or String::reserve() here.
+    // NOTE: Do NOT call esp_random() or allocate here.
     // Global constructors run before FreeRTOS starts — heap allocs and
     // hardware API calls at this stage can prevent the idle-task stack
-    // from being allocated, causing a boot crash.  Deferred to begin().
+    // from being allocated, causing a boot crash.  Buffers are allocated
+    // on first write, the sender task in begin().
 }
 
-bool RemoteLoggerClass::isDroppedRemoteLogLine(const String& line) {
-    return line == REMOTE_LOG_DROPPED_LINE;
+bool RemoteLoggerClass::isDroppedRemoteLogLine(const char* line, size_t len) {
+    return len == strlen(REMOTE_LOG_DROPPED_LINE) &&
+           memcmp(line, REMOTE_LOG_DROPPED_LINE, len) == 0;
 }
 
-void RemoteLoggerClass::trimLogBuffer() {
-    bool trimmed = false;
-    while (logBuffer.length() >= REMOTE_LOG_BUFFER_SIZE - 256) {
-        int nl = logBuffer.indexOf('\n');
-        if (nl < 0) {
-            // Keep recent bytes if we don't have a full line break yet.
-            if (logBuffer.length() > REMOTE_LOG_BUFFER_SIZE / 2) {
-                logBuffer.remove(0, logBuffer.length() - (REMOTE_LOG_BUFFER_SIZE / 2));
-            }
-            break;
-        }
-        logBuffer.remove(0, nl + 1);
-        if (lineCount > 0) {
-            lineCount--;
-        }
-        trimmed = true;
+// ============================================================================
+// Frame Spool
+// ============================================================================
+
+static void spoolCopyIn(uint8_t* spool, uint32_t size, uint32_t offset, const void* data, size_t len) {
+    uint32_t at = offset & (size - 1);
+    size_t first = len < size - at ? len : size - at;
+    memcpy(spool + at, data, first);
+    memcpy(spool, (const uint8_t*)data + first, len - first);
+}
+
+static void spoolCopyOut(const uint8_t* spool, uint32_t size, uint32_t offset, void* data, size_t len) {
+    uint32_t at = offset & (size - 1);
+    size_t first = len < size - at ? len : size - at;
+    memcpy(data, spool + at, first);
+    memcpy((uint8_t*)data + first, spool, len - first);
+}
+
+// Sequence numbers wrap; compare by difference
+static bool seqAfter(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) > 0;
+}
+
+bool RemoteLoggerClass::allocateBuffers() {
+    // First write comes from the log sink task; nothing else creates these
+    if (!_lock) {
+        _lock = xSemaphoreCreateMutex();
+        if (!_lock) return false;
     }
-    // Indicate that lines were dropped so the receiver knows the log is incomplete
-    if (trimmed && !logBuffer.startsWith("...\n")) {
-        logBuffer = "...\n" + logBuffer;
+    if (_buf) return true;
+
+    size_t base = offsetof(Buffers, spool);
+    Buffers* buf = (Buffers*)heap_caps_malloc(base + REMOTE_LOG_SPOOL_BYTES, MALLOC_CAP_SPIRAM);
+    uint32_t spoolBytes = REMOTE_LOG_SPOOL_BYTES;
+    if (!buf) {
+        buf = (Buffers*)malloc(base + REMOTE_LOG_SPOOL_FALLBACK_BYTES);
+        spoolBytes = REMOTE_LOG_SPOOL_FALLBACK_BYTES;
     }
+    if (!buf) return false;
+
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _spoolBytes = spoolBytes;
+    _buf = buf;
+    xSemaphoreGive(_lock);
+    return true;
 }
 
-void RemoteLoggerClass::appendFilteredTo(String& targetBuffer, const uint8_t* buffer, size_t size, bool countLines) {
-    for (size_t i = 0; i < size; i++) {
-        char c = (char)buffer[i];
-        if (c == '\r') {
-            continue;
-        }
+// Under _lock: compress `len` bytes into the spool as the next frame
+void RemoteLoggerClass::spoolPayload(const uint8_t* data, size_t len, uint8_t flags) {
+    SpoolFrame hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.seq = _nextSeq++;
+    hdr.rawLen = (uint16_t)len;
+    hdr.flags = flags;
+    const uint8_t* payload = data;
+    size_t packed = lz4BlockCompress(payload, len, _buf->packed, sizeof(_buf->packed));
+    if (packed > 0 && packed < len) {
+        hdr.flags |= REMOTE_LOG_FRAME_LZ4;
+        hdr.len = (uint16_t)packed;
+        payload = _buf->packed;
+    } else {
+        hdr.len = (uint16_t)len;
+    }
+
+    // Make room by dropping the oldest frames; the server sees the seq gap
+    uint32_t need = sizeof(hdr) + hdr.len;
+    while (_spoolBytes - (_spoolHead - _spoolTail) < need) {
+        SpoolFrame old;
+        spoolCopyOut(_buf->spool, _spoolBytes, _spoolTail, &old, sizeof(old));
+        _spoolTail += sizeof(old) + old.len;
+        _framesDropped++;
+    }
+    spoolCopyIn(_buf->spool, _spoolBytes, _spoolHead, &hdr, sizeof(hdr));
+    spoolCopyIn(_buf->spool, _spoolBytes, _spoolHead + sizeof(hdr), payload, hdr.len);
+    _spoolHead += need;
+    _rawBytes += hdr.rawLen;
+    _packedBytes += hdr.len;
+}
 
-        if (c == '\n') {
-            if (!isDroppedRemoteLogLine(lineAssembleBuffer)) {
-                targetBuffer += lineAssembleBuffer;
-                targetBuffer += '\n';
-                if (countLines) {
-                    lineCount++;
-                }
-            }
-            lineAssembleBuffer = "";
-            continue;
-        }
+// Under _lock: spool the first `len` bytes of the frame, then move whatever
+// follows them to the start of the frame
+void RemoteLoggerClass::closeFrame(size_t len) {
+    if (len == 0) return;
+    spoolPayload((const uint8_t*)_buf->frame, len, 0);
+
+    memmove(_buf->frame, _buf->frame + len, _frameLen - len);
+    _frameLen -= len;
+    _lineStart = _lineStart > len ? _lineStart - len : 0;
+    _frameStarted = millis();
+}
+
+// Copy the frame at `offset` out of the spool and advance `offset` past it.
+// An offset the spool has dropped restarts at the oldest frame.
+bool RemoteLoggerClass::readFrame(uint32_t& offset, SpoolFrame& hdr, uint8_t* payload) {
+    bool found = false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if ((int32_t)(offset - _spoolTail) < 0) {
+        offset = _spoolTail;
+    }
+    if (offset != _spoolHead) {
+        spoolCopyOut(_buf->spool, _spoolBytes, offset, &hdr, sizeof(hdr));
+        spoolCopyOut(_buf->spool, _spoolBytes, offset + sizeof(hdr), payload, hdr.len);
+        offset += sizeof(hdr) + hdr.len;
+        found = true;
+    }
+    xSemaphoreGive(_lock);
+    return found;
+}
+
+int RemoteLoggerClass::decodeFrame(const SpoolFrame& hdr, const uint8_t* payload, char* text) {
+    if (!(hdr.flags & REMOTE_LOG_FRAME_LZ4)) {
+        memcpy(text, payload, hdr.len);
+        return hdr.len;
+    }
+    return lz4BlockDecompress(payload, hdr.len, (uint8_t*)text, REMOTE_LOG_FRAME_BYTES);
+}
+
+// Free every spooled frame up to and including `seq`
+void RemoteLoggerClass::ackThrough(uint32_t seq) {
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    while (_spoolTail != _spoolHead) {
+        SpoolFrame hdr;
+        spoolCopyOut(_buf->spool, _spoolBytes, _spoolTail, &hdr, sizeof(hdr));
+        if (seqAfter(hdr.seq, seq)) break;
+        _spoolTail += sizeof(hdr) + hdr.len;
+        _framesAcked++;
+    }
+    xSemaphoreGive(_lock);
+}
 
-        lineAssembleBuffer += c;
+// Close the frame's complete lines once they've waited a flush interval.
+// Returns ms until the next frame could be due.
+uint32_t RemoteLoggerClass::closeDueFrame() {
+    uint32_t wait = REMOTE_LOG_FLUSH_INTERVAL_MS;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    if (_lineStart > 0) {
+        unsigned long age = millis() - _frameStarted;
+        if (age >= REMOTE_LOG_FLUSH_INTERVAL_MS) {
+            closeFrame(_lineStart);
+        } else {
+            wait = REMOTE_LOG_FLUSH_INTERVAL_MS - age;
+        }
     }
+    xSemaphoreGive(_lock);
+    return wait;
 }
 
+// ============================================================================
+// Setup and Print Interface
+// ============================================================================
+
 void RemoteLoggerClass::begin(const char* server, const char* devId, bool requireVpn) {
     vpnRequired = requireVpn;
 
@@ -98,8 +230,7 @@ void RemoteLoggerClass::begin(const char* server, const char* devId, bool requir
         uint32_t r1 = esp_random();
         uint32_t r2 = esp_random();
         snprintf(bootId, sizeof(bootId), "%08x%04x", r1, (uint16_t)(r2 & 0xFFFF));
-        logBuffer.reserve(REMOTE_LOG_BUFFER_SIZE);
-        preConnectBuffer.reserve(REMOTE_LOG_BUFFER_SIZE);
+        _postBody.reserve(256 + REMOTE_LOG_POST_FRAMES * REMOTE_LOG_FRAME_BYTES * 5 / 4);
     }
     
     // Set server URL
@@ -125,29 +256,32 @@ void RemoteLoggerClass::begin(const char* server, const char* devId, bool requir
     // Only enable if server is configured
     enabled = (strlen(serverUrl) > 0);
     
-    // Extract host from server URL for TCP connections
-    parseServerHost();
-    
     if (enabled) {
         Serial.printf("📡 Remote Logger: %s -> %s (boot %s)\n", deviceId, serverUrl, bootId);
-        // Move any pre-connect logs into the main buffer so they ship on first flush
-        if (preConnectBuffer.length() > 0) {
-            logBuffer = preConnectBuffer;
-            preConnectBuffer = "";
-            lineCount = 0;
-            for (size_t i = 0; i < logBuffer.length(); i++) {
-                if (logBuffer[i] == '\n') lineCount++;
-            }
-        }
+        // Lines logged before now are already spooled and ship first
+        startShipTask();
     }
-    
-    lastFlushTime = millis();
+}
+
+void RemoteLoggerClass::startShipTask() {
+    if (_shipTask) return;
+    if (xTaskCreatePinnedToCore(shipTaskMain, "LogShip", 8192, this,
+                                REMOTE_LOG_TASK_PRIORITY, &_shipTask, 0) != pdPASS) {
+        _shipTask = nullptr;
+        Serial.println("❌ Remote Logger: failed to start sender task");
+    }
+}
+
+void RemoteLoggerClass::setEnabled(bool enable) {
+    enabled = enable;
+    if (enable) startShipTask();
 }
 
 void RemoteLoggerClass::setServer(const char* server) {
     if (server) {
         strncpy(serverUrl, server, sizeof(serverUrl) - 1);
         serverUrl[sizeof(serverUrl) - 1] = '\0';
+        parseServerHost();
     }
 }
 
@@ -159,150 +293,251 @@ void RemoteLoggerClass::setDeviceId(const char* id) {
 }
 
 size_t RemoteLoggerClass::write(uint8_t byte) {
-    const uint8_t oneByte[] = {byte};
-
-    if (!enabled) {
-        // Capture early boot logs before begin() enables us
-        appendFilteredTo(preConnectBuffer, oneByte, 1, false);
-        if (preConnectBuffer.length() > REMOTE_LOG_BUFFER_SIZE) {
-            preConnectBuffer.remove(0, preConnectBuffer.length() - REMOTE_LOG_BUFFER_SIZE);
-        }
-        return 1;
-    }
-
-    appendFilteredTo(logBuffer, oneByte, 1, true);
-    trimLogBuffer();
-    
-    return 1;
+    return write(&byte, 1);
 }
 
+// Called from the log sink task. Lines are spooled whether or not shipping
+// is enabled, so early boot logs and logs written while the server is
+// unreachable go out later.
 size_t RemoteLoggerClass::write(const uint8_t* buffer, size_t size) {
-    if (!enabled) {
-        appendFilteredTo(preConnectBuffer, buffer, size, false);
-        if (preConnectBuffer.length() > REMOTE_LOG_BUFFER_SIZE) {
-            preConnectBuffer.remove(0, preConnectBuffer.length() - REMOTE_LOG_BUFFER_SIZE);
+    if (!allocateBuffers()) return size;
+
+    bool closed = false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    for (size_t i = 0; i < size; i++) {
+        char c = (char)buffer[i];
+        if (c == '\r') {
+            continue;
+        }
+        if (_frameLen == REMOTE_LOG_FRAME_BYTES) {
+            // Full: close at the last line break, or mid-line for a line
+            // longer than a frame
+            closeFrame(_lineStart > 0 ? _lineStart : _frameLen);
+            closed = true;
+        }
+        if (_frameLen == 0) {
+            _frameStarted = millis();
+        }
+        _buf->frame[_frameLen++] = c;
+        if (c == '\n') {
+            if (isDroppedRemoteLogLine(_buf->frame + _lineStart, _frameLen - _lineStart - 1)) {
+                _frameLen = _lineStart;
+            }
+            _lineStart = _frameLen;
         }
-        return size;
     }
+    xSemaphoreGive(_lock);
 
-    appendFilteredTo(logBuffer, buffer, size, true);
-    trimLogBuffer();
-    
+    if (closed && _shipTask) {
+        xTaskNotifyGive(_shipTask);
+    }
     return size;
 }
 
+bool RemoteLoggerClass::writeMetrics(const uint8_t* data, size_t len) {
+    if (len == 0 || len > REMOTE_LOG_FRAME_BYTES) return false;
+    if (!allocateBuffers()) return false;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    spoolPayload(data, len, REMOTE_LOG_FRAME_METRICS);
+    xSemaphoreGive(_lock);
+    return true;
+}
+
 void RemoteLoggerClass::flush() {
-    if (!enabled || !_streamingEnabled || logBuffer.length() == 0 ||
-        millis() - lastFlushTime < REMOTE_LOG_FLUSH_INTERVAL_MS)
+    if (!_lock || !_buf) return;
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    closeFrame(_lineStart);
+    xSemaphoreGive(_lock);
+    if (_shipTask) {
+        xTaskNotifyGive(_shipTask);
+    }
+}
+
+void RemoteLoggerClass::printStatus() {
+    if (!_lock || !_buf) {
+        Logger.println("📡 Remote log: nothing spooled yet");
         return;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    uint32_t spooled = _spoolHead - _spoolTail;
+    uint32_t nextSeq = _nextSeq;
+    uint32_t dropped = _framesDropped;
+    uint32_t acked = _framesAcked;
+    uint32_t raw = _rawBytes;
+    uint32_t packed = _packedBytes;
+    xSemaphoreGive(_lock);
+
+    const char* via = _serverConnected ? "TCP" : _serverIsTelnetClient ? "telnet" : "HTTP";
+    Logger.printf("📡 Remote log: %s, via %s, %u/%u bytes spooled\n",
+                  enabled ? "enabled" : "disabled", via,
+                  (unsigned)spooled, (unsigned)_spoolBytes);
+    Logger.printf("   Frames: %u closed, %u acknowledged, %u dropped; %u -> %u bytes (%u%%)\n",
+                  (unsigned)nextSeq, (unsigned)acked, (unsigned)dropped,
+                  (unsigned)raw, (unsigned)packed,
+                  raw ? (unsigned)(packed * 100ULL / raw) : 100u);
+}
 
-    // Try to establish / maintain TCP connection to server (runs on core 1, short timeout)
-    maintainServerConnection();
+// ============================================================================
+// Sender Task
+// ============================================================================
 
-    // ── Priority 1: Persistent TCP stream to server ──────────────────────────
-    // Plain text, no JSON, no core 0 task — lowest overhead.
-    if (_serverConnected && _serverSocket.connected()) {
-        size_t written = _serverSocket.print(logBuffer);
-        if (written > 0) {
-            logBuffer = "";
-            lineCount = 0;
-            lastFlushTime = millis();
-            return;
+void RemoteLoggerClass::shipTaskMain(void* arg) {
+    auto* self = static_cast<RemoteLoggerClass*>(arg);
+    uint32_t wait = REMOTE_LOG_FLUSH_INTERVAL_MS;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+        self->logHeapStats();
+        if (!self->_buf) {
+            wait = REMOTE_LOG_FLUSH_INTERVAL_MS;
+            continue;
         }
-        // Write failed — connection probably dead, will be caught by maintainServerConnection next time
-        _serverConnected = false;
+        wait = self->closeDueFrame();
+        self->shipPending();
+    }
+}
+
+// Largest free block falling while free space holds steady is fragmentation;
+// both falling is a leak. Logged like any other line, so it reaches the server.
+void RemoteLoggerClass::logHeapStats() {
+    if (REMOTE_LOG_HEAP_STATS_MS == 0) return;
+    unsigned long now = millis();
+    if (_lastHeapStats != 0 && now - _lastHeapStats < REMOTE_LOG_HEAP_STATS_MS) return;
+    _lastHeapStats = now;
+
+    HeapStats stats = sampleHeap();
+    rtcHeap = stats;
+    rtcHeapUptimeSec = now / 1000;
+    rtcHeapMagic = HEAP_SAMPLE_MAGIC;
+
+    char line[160];
+    formatHeapStats(stats, line, sizeof(line));
+    Logger.printf("📊 HEAP %s\n", line);
+}
+
+void RemoteLoggerClass::shipPending() {
+    if (!enabled || !_streamingEnabled) return;
+    if (!WiFi.isConnected()) return;
+    if (vpnRequired && !isTailscaleConnected()) return;
+
+    if (_serverTcpEnabled) {
+        maintainServerConnection();
+    } else if (_serverConnected) {
+        dropServerConnection();
+    }
+
+    // The boot notification is structured JSON, so it always goes by HTTP
+    if (!bootSent && serverUrl[0] &&
+        (_consecutiveFailures == 0 || (long)(millis() - _backoffUntil) >= 0)) {
+        if (buildBootJson(_postBody) && postJson(_postBody)) {
+            bootSent = true;
+            _consecutiveFailures = 0;
+        } else {
+            postFailed();
+        }
+    }
+
+    // ── Priority 1: Persistent TCP stream to server ──────────────────────────
+    if (_serverConnected) {
+        readServerAcks();
+        if (_serverConnected) sendFrames();
+        return;
     }
 
     // ── Priority 2: Server connected inbound to phone's telnet ───────────────
     // Logs are already flowing through Logger → telnet → server.
     if (_serverIsTelnetClient) {
-        // Still consume the buffer so it doesn't grow forever
-        logBuffer = "";
-        lineCount = 0;
-        lastFlushTime = millis();
+        ackThrough(_nextSeq - 1);
         return;
     }
 
     // ── Priority 3: HTTP POST with backoff (fallback) ────────────────────────
-    // Don't double-post
-    if (_postPending)
-        return;
+    postFrames();
+}
 
+void RemoteLoggerClass::postFrames() {
     // Exponential backoff: 30s, 60s, 120s, 240s … capped at 5 min
-    if (_consecutiveFailures > 0 && millis() < _backoffUntil) {
+    if (_consecutiveFailures > 0 && (long)(millis() - _backoffUntil) < 0) {
         return;
     }
+    if (serverUrl[0] == '\0') return;
 
-    // Check connectivity: WiFi must be up
-    if (!WiFi.isConnected()) return;
-
-    // Check VPN requirement
-    if (vpnRequired && !isTailscaleConnected()) {
-        // Don't flush, keep buffering (up to limit)
-        if (logBuffer.length() >= REMOTE_LOG_BUFFER_SIZE - 256) {
-            int newlinePos = logBuffer.indexOf('\n');
-            if (newlinePos > 0) {
-                logBuffer.remove(0, newlinePos + 1);
-                lineCount--;
-            }
+    uint32_t lastSeq;
+    while (buildLogsJson(_postBody, lastSeq)) {
+        if (_postBody.length() == 0) {
+            ackThrough(lastSeq);
+            continue;
         }
-        return;
+        if (!postJson(_postBody)) {
+            postFailed();
+            return;
+        }
+        _consecutiveFailures = 0;
+        ackThrough(lastSeq);
     }
+}
 
-    if (strlen(serverUrl) == 0) return;
+bool RemoteLoggerClass::postJson(const String& body) {
+    HttpLease http(serverUrl, HTTP_TIMEOUT_LOG_MS);
+    http->setPersistentHeader("X-Device-ID", deviceId);
+    if (!http->post(serverUrl, body, "application/json")) return false;
+    http->getString();  // Read the reply so the connection stays usable
+    return true;
+}
 
-    // Send boot notification on first flush (fire-and-forget async)
-    if (!bootSent) {
-        String bootJson;
-        if (buildBootJson(bootJson)) {
-            HttpClient::postAsync(serverUrl, std::move(bootJson),
-                                  onBootPostDone, this,
-                                  "application/json",
-                                  "X-Device-ID", deviceId);
-        }
-    }
+void RemoteLoggerClass::postFailed() {
+    _consecutiveFailures++;
+    // Dramatic backoff: 30s, 60s, 120s, 240s … capped at 5 min
+    unsigned long delay = 30000UL * (1UL << min(_consecutiveFailures - 1, 3));
+    if (delay > 300000UL) delay = 300000UL;
+    _backoffUntil = millis() + delay;
+}
 
-    // Snapshot the buffer and send via async POST on core 0
-    String json;
-    if (!buildLogsJson(json, logBuffer)) return;
-
-    _postPending = true;
-    logBuffer = "";
-    lineCount = 0;
-    lastFlushTime = millis();
-
-    HttpClient::postAsync(serverUrl, std::move(json),
-                          onLogPostDone, this,
-                          "application/json",
-                          "X-Device-ID", deviceId,
-                          HTTP_TIMEOUT_LOG_MS);
-}
-
-bool RemoteLoggerClass::buildLogsJson(String& out, const String& logs) {
-    out.reserve(200 + logs.length() * 2);
-
-    char header[160];
-    snprintf(header, sizeof(header),
-             "{\"device\":\"%s\",\"boot_id\":\"%s\",\"uptime_sec\":%lu,\"logs\":\"",
-             deviceId, bootId, millis() / 1000);
-    out += header;
-
-    // Escape log content
-    for (size_t i = 0; i < logs.length(); i++) {
-        char c = logs[i];
-        switch (c) {
-            case '"':  out += "\\\""; break;
-            case '\\': out += "\\\\"; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default:
-                if (c >= 32 && c < 127) {
-                    out += c;
-                }
+// Up to REMOTE_LOG_POST_FRAMES of the oldest frames as one JSON body.
+// The receiver uses the seq range to spot lost and repeated batches.
+bool RemoteLoggerClass::buildLogsJson(String& out, uint32_t& lastSeq) {
+    uint32_t offset = _spoolTail;
+    SpoolFrame hdr;
+    int frames = 0;
+    bool text = false;
+    while (frames < REMOTE_LOG_POST_FRAMES && readFrame(offset, hdr, _buf->wire)) {
+        if (frames == 0) {
+            char header[192];
+            snprintf(header, sizeof(header),
+                     "{\"device\":\"%s\",\"boot_id\":\"%s\",\"uptime_sec\":%lu,"
+                     "\"seq_first\":%u,\"logs\":\"",
+                     deviceId, bootId, millis() / 1000, (unsigned)hdr.seq);
+            out = header;
+        }
+        frames++;
+        lastSeq = hdr.seq;
+        if (hdr.flags & REMOTE_LOG_FRAME_METRICS) continue;   // TCP only
+        int textLen = decodeFrame(hdr, _buf->wire, _buf->text);
+        text = true;
+
+        // Escape log content
+        for (int i = 0; i < textLen; i++) {
+            char c = _buf->text[i];
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (c >= 32 && c < 127) {
+                        out += c;
+                    }
+            }
         }
     }
-    out += "\"}";
+    if (frames == 0) return false;
+    if (!text) {
+        out = "";   // Metrics only: nothing to post
+        return true;
+    }
+
+    char trailer[32];
+    snprintf(trailer, sizeof(trailer), "\",\"seq_last\":%u}", (unsigned)lastSeq);
+    out += trailer;
     return true;
 }
 
@@ -336,34 +571,21 @@ bool RemoteLoggerClass::buildBootJson(String& out) {
     if (tsIp) {
         out += "\"tailscale_ip\":\"" + String(tsIp) + "\",";
     }
+    bootPipeline.appendJson(out);
+    bool crashed = reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+                   reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT;
+    if (crashed && rtcHeapMagic == HEAP_SAMPLE_MAGIC) {
+        char line[160];
+        formatHeapStats(rtcHeap, line, sizeof(line));
+        out += "\"heap_before_reset\":\"" + String(line) + " at " +
+               String(rtcHeapUptimeSec) + "s\",";
+    }
     out += "\"logs\":\"BOOT firmware=" FIRMWARE_VERSION " reason=";
     out += String(reasonStr);
     out += "\"}";
     return true;
 }
 
-void RemoteLoggerClass::onLogPostDone(bool success, int statusCode, void* userData) {
-    auto* self = static_cast<RemoteLoggerClass*>(userData);
-    self->_postPending = false;
-    if (success) {
-        self->_consecutiveFailures = 0;
-    } else {
-        self->_consecutiveFailures++;
-        // Dramatic backoff: 30s, 60s, 120s, 240s … capped at 5 min
-        unsigned long delay = 30000UL * (1UL << min(self->_consecutiveFailures - 1, 3));
-        if (delay > 300000UL) delay = 300000UL;
-        self->_backoffUntil = millis() + delay;
-    }
-    // No logging here — callback runs on core 0, Logger writes are core-1 only
-}
-
-void RemoteLoggerClass::onBootPostDone(bool success, int statusCode, void* userData) {
-    auto* self = static_cast<RemoteLoggerClass*>(userData);
-    if (success) {
-        self->bootSent = true;
-    }
-}
-
 // ============================================================================
 // Persistent TCP Log Stream
 // ============================================================================
@@ -386,10 +608,10 @@ void RemoteLoggerClass::parseServerHost() {
 }
 
 void RemoteLoggerClass::setServerTcpEnabled(bool enable) {
+    // The sender task owns the socket and closes it on its next pass
     _serverTcpEnabled = enable;
-    if (!enable && _serverConnected) {
-        _serverSocket.stop();
-        _serverConnected = false;
+    if (_shipTask) {
+        xTaskNotifyGive(_shipTask);
     }
     // Persist to NVS
     if (remoteLogPrefs.begin(REMOTE_LOG_NVS_NAMESPACE, false)) {
@@ -399,40 +621,60 @@ void RemoteLoggerClass::setServerTcpEnabled(bool enable) {
 }
 
 bool RemoteLoggerClass::sendTcpHandshake() {
-    // Send: BOWIE-LOG device=<id> boot=<bootId> firmware=<ver>\n
+    // Send: BOWIE-LOG device=<id> boot=<bootId> firmware=<ver> proto=2\n
     char handshake[160];
     snprintf(handshake, sizeof(handshake),
-             "BOWIE-LOG device=%s boot=%s firmware=%s\n",
-             deviceId, bootId, FIRMWARE_VERSION);
+             "BOWIE-LOG device=%s boot=%s firmware=%s proto=%d\n",
+             deviceId, bootId, FIRMWARE_VERSION, REMOTE_LOG_PROTO);
 
     size_t written = _serverSocket.print(handshake);
     if (written == 0) return false;
 
-    // Wait for BOWIE-ACK\n (up to 2 seconds)
+    // Wait for "BOWIE-ACK proto=2 next=<seq> [metrics=1]\n" (up to 2
+    // seconds). A server without "proto=2" only takes plain text: fall back
+    // to HTTP.
     unsigned long start = millis();
-    String response;
-    while (millis() - start < 2000) {
+    char response[64];
+    size_t len = 0;
+    while (millis() - start < 2000 && len < sizeof(response) - 1) {
         if (_serverSocket.available()) {
             char c = _serverSocket.read();
-            response += c;
             if (c == '\n') break;
+            response[len++] = c;
+        } else {
+            delay(10);
         }
-        delay(10);
+    }
+    response[len] = '\0';
+
+    unsigned proto = 0;
+    unsigned long next = 0;
+    if (sscanf(response, "BOWIE-ACK proto=%u next=%lu", &proto, &next) != 2 ||
+        proto != REMOTE_LOG_PROTO) {
+        return false;
     }
 
-    return response.startsWith("BOWIE-ACK");
+    // Servers that store metrics frames say so; others only get log text
+    _serverMetrics = strstr(response, " metrics=1") != nullptr;
+
+    // The server has everything before `next`; resend the rest
+    if (next > 0) ackThrough((uint32_t)next - 1);
+    _sendOffset = _spoolTail;
+    return true;
+}
+
+void RemoteLoggerClass::dropServerConnection() {
+    _serverSocket.stop();
+    _serverConnected = false;
 }
 
 void RemoteLoggerClass::maintainServerConnection() {
-    if (!_serverTcpEnabled || !enabled) return;
-    if (!WiFi.isConnected()) return;
-    if (vpnRequired && !isTailscaleConnected()) return;
     if (_serverHost[0] == '\0') return;
 
     // Check existing connection health
     if (_serverConnected) {
         if (!_serverSocket.connected()) {
-            _serverConnected = false;
+            dropServerConnection();
             _tcpConsecutiveFailures++;
             unsigned long backoff = REMOTE_LOG_TCP_RECONNECT_MS * (1UL << min(_tcpConsecutiveFailures - 1, 4));
             if (backoff > 300000UL) backoff = 300000UL;  // cap 5 min
@@ -443,9 +685,9 @@ void RemoteLoggerClass::maintainServerConnection() {
     }
 
     // Apply backoff
-    if (_tcpConsecutiveFailures > 0 && millis() < _tcpBackoffUntil) return;
+    if (_tcpConsecutiveFailures > 0 && (long)(millis() - _tcpBackoffUntil) < 0) return;
 
-    // Attempt connection
+    // Attempt connection (blocks only this task)
     _serverSocket.setTimeout(REMOTE_LOG_TCP_CONNECT_TIMEOUT_MS);
     if (!_serverSocket.connect(_serverHost, _serverTcpPort)) {
         _tcpConsecutiveFailures++;
@@ -470,6 +712,42 @@ void RemoteLoggerClass::maintainServerConnection() {
     Serial.printf("📡 TCP log stream connected to %s:%d\n", _serverHost, _serverTcpPort);
 }
 
+void RemoteLoggerClass::readServerAcks() {
+    uint8_t ack[REMOTE_LOG_ACK_BYTES];
+    while (_serverSocket.available() >= REMOTE_LOG_ACK_BYTES) {
+        if (_serverSocket.read(ack, sizeof(ack)) != sizeof(ack) || ack[0] != 'K') {
+            Serial.println("📡 TCP log stream: bad ack, reconnecting");
+            dropServerConnection();
+            return;
+        }
+        uint32_t seq;
+        memcpy(&seq, ack + 1, sizeof(seq));
+        ackThrough(seq);
+    }
+}
+
+// Everything not yet on the wire. Frames stay spooled until acknowledged,
+// so a write that fails here is resent after the reconnect.
+void RemoteLoggerClass::sendFrames() {
+    SpoolFrame hdr;
+    uint8_t* wire = _buf->wire;
+    while (readFrame(_sendOffset, hdr, wire + REMOTE_LOG_WIRE_HEADER)) {
+        // Not sent: acknowledged along with the next log frame
+        if ((hdr.flags & REMOTE_LOG_FRAME_METRICS) && !_serverMetrics) continue;
+        wire[0] = 'F';
+        wire[1] = hdr.flags;
+        memcpy(wire + 2, &hdr.seq, sizeof(hdr.seq));
+        memcpy(wire + 6, &hdr.rawLen, sizeof(hdr.rawLen));
+        memcpy(wire + 8, &hdr.len, sizeof(hdr.len));
+        size_t total = REMOTE_LOG_WIRE_HEADER + hdr.len;
+        if (_serverSocket.write(wire, total) != total) {
+            Serial.println("📡 TCP log stream write failed, reconnecting");
+            dropServerConnection();
+            return;
+        }
+    }
+}
+
 // ============================================================================
 // Configuration Storage
 // ============================================================================
@@ -568,7 +846,7 @@ button:hover{background:#ff6b6b}
 .toggle{display:flex;align-items:center;gap:10px;margin:15px 0}
 .toggle input{width:auto}
 .back{display:block;text-align:center;margin-top:15px;color:#e94560}
-.test{background:#0f3460;margin-top:10px}=
+.test{background:#0f3460;margin-top:10px}
 </style>
 </head><body>
 <div class="c">
@@ -605,32 +883,37 @@ button:hover{background:#ff6b6b}
 
 static WebServer* remoteLogWebServer = nullptr;
 
-static void handleRemoteLogPage() {
-    if (!remoteLogWebServer) return;
-    
-    String html = FPSTR(REMOTE_LOG_CONFIG_PAGE);
-    
-    // Status
-    if (RemoteLogger.isEnabled()) {
-        html.replace("%STATUS_CLASS%", "enabled");
-        String statusMsg = String("✅ Enabled: ") + RemoteLogger.getDeviceId() + " → " + RemoteLogger.getServerUrl();
-        if (RemoteLogger.isServerTcpEnabled()) {
-            statusMsg += RemoteLogger.isServerConnected() ? "<br>🔌 TCP stream: connected" : "<br>🔌 TCP stream: waiting";
+static void remoteLogPageField(const char* name, Print& out, void*) {
+    if (!strcmp(name, "STATUS_CLASS")) {
+        out.print(RemoteLogger.isEnabled() ? "enabled" : "disabled");
+    } else if (!strcmp(name, "STATUS")) {
+        if (RemoteLogger.isEnabled()) {
+            out.print("✅ Enabled: ");
+            printHtmlEscaped(out, RemoteLogger.getDeviceId());
+            out.print(" → ");
+            printHtmlEscaped(out, RemoteLogger.getServerUrl());
+            if (RemoteLogger.isServerTcpEnabled()) {
+                out.print(RemoteLogger.isServerConnected() ? "<br>🔌 TCP stream: connected" : "<br>🔌 TCP stream: waiting");
+            }
+        } else {
+            out.print("❌ Disabled");
         }
-        html.replace("%STATUS%", statusMsg);
-    } else {
-        html.replace("%STATUS_CLASS%", "disabled");
-        html.replace("%STATUS%", "❌ Disabled");
+    } else if (!strcmp(name, "ENABLED_CHECKED")) {
+        if (RemoteLogger.isEnabled()) out.print("checked");
+    } else if (!strcmp(name, "TCP_ENABLED_CHECKED")) {
+        if (RemoteLogger.isServerTcpEnabled()) out.print("checked");
+    } else if (!strcmp(name, "TCP_PORT")) {
+        out.print(REMOTE_LOG_TCP_PORT);
+    } else if (!strcmp(name, "SERVER")) {
+        printHtmlEscaped(out, RemoteLogger.getServerUrl());
+    } else if (!strcmp(name, "DEVICE_ID")) {
+        printHtmlEscaped(out, RemoteLogger.getDeviceId());
     }
-    
-    // Form values
-    html.replace("%ENABLED_CHECKED%", RemoteLogger.isEnabled() ? "checked" : "");
-    html.replace("%TCP_ENABLED_CHECKED%", RemoteLogger.isServerTcpEnabled() ? "checked" : "");
-    html.replace("%TCP_PORT%", String(REMOTE_LOG_TCP_PORT));
-    html.replace("%SERVER%", RemoteLogger.getServerUrl());
-    html.replace("%DEVICE_ID%", RemoteLogger.getDeviceId());
-    
-    remoteLogWebServer->send(200, "text/html", html);
+}
+
+static void handleRemoteLogPage() {
+    if (!remoteLogWebServer) return;
+    sendPage(*remoteLogWebServer, REMOTE_LOG_CONFIG_PAGE, remoteLogPageField);
 }
 
 static void handleRemoteLogSave() {
@@ -672,6 +955,7 @@ static void handleRemoteLogTest() {
     
     if (RemoteLogger.isEnabled()) {
         Logger.println("🧪 Test log message from remote logger web interface");
+        Logger.flush();  // Through the sink, into the frame
         RemoteLogger.flush();
         remoteLogWebServer->send(200, "text/plain", "Test log sent!");
     } else {
@@ -684,8 +968,8 @@ void initRemoteLoggerRoutes(void* server) {
     if (!remoteLogWebServer) return;
     
     remoteLogWebServer->on("/remotelog", HTTP_GET, handleRemoteLogPage);
-    remoteLogWebServer->on("/remotelog/save", HTTP_POST, handleRemoteLogSave);
-    remoteLogWebServer->on("/remotelog/test", HTTP_POST, handleRemoteLogTest);
+    remoteLogWebServer->on("/remotelog/save", HTTP_POST, webServerTask.onLoop(handleRemoteLogSave));
+    remoteLogWebServer->on("/remotelog/test", HTTP_POST, webServerTask.onLoop(handleRemoteLogTest));
     
     Serial.println("📡 Remote log config routes registered (/remotelog)");
 }
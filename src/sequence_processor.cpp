@@ -1,6 +1,7 @@
 #include "sequence_processor.h"
 #include "audio_file_manager.h"
 #include "audio_key_registry.h"
+#include "dtmf_trie.h"
 #include "extended_audio_player.h"
 #include "notifications.h"
 #include "phone_service.h"
@@ -18,6 +19,24 @@ static bool sequenceReady = false;  // Flag set when sequence is ready to proces
 static bool sequenceLocked = false; // Lock input after a sequence plays until hang-up
 static int maxSequenceLength = MAX_SEQUENCE_LENGTH;  // Runtime configurable max length
 
+// ============================================================================
+// DIAL INDEX STATE
+// ============================================================================
+// One cursor per suffix of the sequence that is still a prefix of some key,
+// so "9911" finds "911" without rescanning the key set on every digit.
+struct DialCursor {
+    int start;                  // Index in dtmfSequence where this match begins
+    DtmfTrie::Node node;
+};
+static DtmfTrie dialIndex;
+static uint32_t dialIndexKeysGeneration = 0;
+static uint32_t dialIndexCommandsGeneration = 0;
+static bool dialIndexBuilt = false;
+static DialCursor dialCursors[MAX_SEQUENCE_LENGTH];
+static int dialCursorCount = 0;
+static int pendingMatchStart = -1;   // Complete match that longer keys extend
+static int pendingMatchLength = 0;
+
 // ============================================================================
 // CONFIGURATION FUNCTIONS
 // ============================================================================
@@ -42,6 +61,177 @@ int getMaxSequenceLength()
     return maxSequenceLength;
 }
 
+// ============================================================================
+// DIAL INDEX
+// ============================================================================
+
+void rebuildDialIndex()
+{
+    AudioKeyRegistry& registry = getAudioKeyRegistry();
+    dialIndexKeysGeneration = registry.getGeneration();
+    dialIndexCommandsGeneration = getSpecialCommandsGeneration();
+    dialIndexBuilt = true;
+
+    dialIndex.clear();
+    for (const auto& pair : registry) {
+        dialIndex.add(pair.first, DtmfTrie::TERMINAL_KEY);  // Skips named keys ("dialtone")
+    }
+    for (int i = 0; i < getSpecialCommandCount(); i++) {
+        dialIndex.add(getSpecialCommandSequence(i), DtmfTrie::TERMINAL_COMMAND);
+    }
+    if (!dialIndex.build()) {
+        Logger.println("⚠️ Dial index too large — falling back to key scans");
+        return;
+    }
+    Logger.debugf("🔢 Dial index: %u sequences, %u nodes\n",
+                  (unsigned)dialIndex.sequenceCount(), (unsigned)dialIndex.nodeCount());
+}
+
+void printDialIndexStatus()
+{
+    Logger.printf("🔢 Dial index: %u sequences, %u nodes (%u bytes)%s\n",
+                  (unsigned)dialIndex.sequenceCount(), (unsigned)dialIndex.nodeCount(),
+                  (unsigned)(dialIndex.nodeCount() * 6), dialIndex.ready() ? "" : ", not built");
+    Logger.printf("   Sequence '%s': %d live cursor(s)\n", dtmfSequence, dialCursorCount);
+    for (int i = 0; i < dialCursorCount; i++) {
+        DtmfTrie::Node node = dialCursors[i].node;
+        Logger.printf("     '%s'%s%s\n", &dtmfSequence[dialCursors[i].start],
+                      dialIndex.terminal(node) ? " complete" : "",
+                      dialIndex.canContinue(node) ? " (can continue)" : "");
+    }
+    if (pendingMatchStart >= 0) {
+        Logger.printf("   Pending '%.*s' (%lu ms since last digit, takes effect at %d)\n",
+                      pendingMatchLength, &dtmfSequence[pendingMatchStart],
+                      millis() - lastDigitTime, DTMF_AMBIGUOUS_MATCH_MS);
+    }
+}
+
+/// Rebuild if keys or commands changed since the last build
+static bool dialIndexReady()
+{
+    if (!dialIndexBuilt
+        || dialIndexKeysGeneration != getAudioKeyRegistry().getGeneration()
+        || dialIndexCommandsGeneration != getSpecialCommandsGeneration())
+    {
+        rebuildDialIndex();
+    }
+    return dialIndex.ready();
+}
+
+static void resetDialCursors()
+{
+    dialCursorCount = 0;
+    pendingMatchStart = -1;
+    pendingMatchLength = 0;
+}
+
+/// Trim the sequence to the match at [start, start + length)
+static void selectMatch(int start, int length)
+{
+    memmove(dtmfSequence, &dtmfSequence[start], length);
+    dtmfSequence[length] = '\0';
+    sequenceIndex = length;
+    resetDialCursors();
+}
+
+/**
+ * @brief Advance every live cursor by the digit just appended
+ * @return true if a match should be processed now
+ *
+ * A complete match is dispatched at once unless longer sequences extend it
+ * ("91" when "911" also exists). Then it waits: for a digit that kills the
+ * longer candidates, or DTMF_AMBIGUOUS_MATCH_MS of silence (readDTMFSequence).
+ */
+static bool advanceDialCursors(char digit)
+{
+    int pos = sequenceIndex - 1;
+    if (dialCursorCount < MAX_SEQUENCE_LENGTH) {
+        dialCursors[dialCursorCount++] = {pos, DtmfTrie::ROOT};
+    }
+
+    int kept = 0;
+    bool pendingAlive = false;
+    for (int i = 0; i < dialCursorCount; i++) {
+        DtmfTrie::Node next = dialIndex.step(dialCursors[i].node, digit);
+        if (next == DtmfTrie::DEAD) continue;
+        if (dialCursors[i].start == pendingMatchStart) pendingAlive = true;
+        dialCursors[i].node = next;
+        dialCursors[kept++] = dialCursors[i];
+    }
+    dialCursorCount = kept;
+
+    // Cursors stay in start order, so the first complete one is the longest suffix
+    for (int i = 0; i < dialCursorCount; i++) {
+        if (!dialIndex.terminal(dialCursors[i].node)) continue;
+        int start = dialCursors[i].start;
+        int length = sequenceIndex - start;
+        if (!dialIndex.canContinue(dialCursors[i].node)) {
+            Logger.debugf("✅ Found matching substring '%s' in sequence '%s'\n", &dtmfSequence[start], dtmfSequence);
+            selectMatch(start, length);
+            return true;
+        }
+        Logger.debugf("⏳ '%s' is complete but longer sequences continue it\n", &dtmfSequence[start]);
+        pendingMatchStart = start;
+        pendingMatchLength = length;
+        return false;
+    }
+
+    if (pendingMatchStart >= 0 && !pendingAlive) {
+        // This digit ruled out everything longer: the earlier match stands
+        Logger.debugf("✅ '%.*s' confirmed by next digit\n", pendingMatchLength, &dtmfSequence[pendingMatchStart]);
+        selectMatch(pendingMatchStart, pendingMatchLength);
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// DIAL PREDICTION
+// ============================================================================
+
+/// Keys the live cursors can still complete to
+struct CandidateScan {
+    const char* keys[DIAL_PREDICT_MAX_CANDIDATES];
+    int count;
+    bool overflow;              // The cursor being walked reaches too many
+};
+
+static bool collectCandidate(const char* sequence, uint8_t /*flags*/, void* userData)
+{
+    CandidateScan* scan = static_cast<CandidateScan*>(userData);
+    const AudioEntry* entry = getAudioKeyRegistry().getEntry(sequence);
+    if (!entry) return true;
+    const char* key = entry->audioKey.c_str();
+    for (int i = 0; i < scan->count; i++) {
+        if (scan->keys[i] == key) return true;   // Also reached from a longer suffix
+    }
+    if (scan->count >= DIAL_PREDICT_MAX_CANDIDATES) {
+        scan->overflow = true;
+        return false;
+    }
+    scan->keys[scan->count++] = key;
+    return true;
+}
+
+/**
+ * @brief Fetch ahead the files of the keys the digits so far can reach
+ *
+ * Cursors whose prefix still matches more than DIAL_PREDICT_MAX_CANDIDATES
+ * keys (the one-digit cursor, usually) are too open to predict from.
+ */
+static void predictFromDialCursors()
+{
+    CandidateScan scan = {};
+    for (int i = 0; i < dialCursorCount; i++) {
+        int before = scan.count;
+        scan.overflow = false;
+        dialIndex.forEachUnder(dialCursors[i].node, &dtmfSequence[dialCursors[i].start],
+                               DtmfTrie::TERMINAL_KEY, collectCandidate, &scan);
+        if (scan.overflow) scan.count = before;
+    }
+    predictAudioKeys(scan.keys, scan.count);
+}
+
 // ============================================================================
 // DTMF SEQUENCE READING
 // ============================================================================
@@ -86,26 +276,42 @@ static bool addDigitToSequence(char digit)
         lastDigitTime = millis();
         Logger.printf("📞 Current sequence: '%s'\n", dtmfSequence);
         
-        // Check all substrings of the current sequence for matches
-        // e.g., "9911" should find "911" (check suffixes: "9911", "911", "11", "1")
-        for (int start = 0; start < sequenceIndex; start++)
+        // Walk the dial index one node per digit
+        if (dialIndexReady())
         {
-            const char* substring = &dtmfSequence[start];
-            if (getAudioKeyRegistry().hasKey(substring))
+            if (advanceDialCursors(digit))
             {
-                Logger.debugf("✅ Found matching substring '%s' in sequence '%s'\n", substring, dtmfSequence);
-                // Move the matched portion to the beginning for processing
-                memmove(dtmfSequence, substring, strlen(substring) + 1);
-                sequenceIndex = strlen(dtmfSequence);
-                return true; // Process this match
+                return true;
+            }
+            predictFromDialCursors();
+        }
+        else
+        {
+            // No index: check all substrings of the current sequence for matches
+            // e.g., "9911" should find "911" (check suffixes: "9911", "911", "11", "1")
+            for (int start = 0; start < sequenceIndex; start++)
+            {
+                const char* substring = &dtmfSequence[start];
+                if (getAudioKeyRegistry().hasKey(substring))
+                {
+                    Logger.debugf("✅ Found matching substring '%s' in sequence '%s'\n", substring, dtmfSequence);
+                    // Move the matched portion to the beginning for processing
+                    memmove(dtmfSequence, substring, strlen(substring) + 1);
+                    sequenceIndex = strlen(dtmfSequence);
+                    return true; // Process this match
+                }
             }
         }
     }
 
-    // Only complete if buffer is full (no timeout - wait for hang up or match)
+    // Complete if buffer is full (otherwise wait for hang up, a match or the ambiguity timeout)
     if (sequenceIndex >= maxSequenceLength - 1)
     {
         Logger.debugln("Sequence complete: buffer full");
+        if (pendingMatchStart >= 0)
+        {
+            selectMatch(pendingMatchStart, pendingMatchLength);
+        }
         return true;
     }
 
@@ -129,6 +335,15 @@ static bool checkForDTMFSequence(bool skipFFT = false)
 
 bool readDTMFSequence(bool skipFFT)
 {
+    // An ambiguous match is taken once the caller stops dialing
+    if (pendingMatchStart >= 0 && !sequenceReady && millis() - lastDigitTime >= DTMF_AMBIGUOUS_MATCH_MS)
+    {
+        Logger.debugf("⏱️ No digit for %d ms - taking '%.*s'\n", DTMF_AMBIGUOUS_MATCH_MS,
+                      pendingMatchLength, &dtmfSequence[pendingMatchStart]);
+        selectMatch(pendingMatchStart, pendingMatchLength);
+        sequenceReady = true;
+    }
+
     // Check for complete DTMF sequences from real audio or simulated input
     bool ready = checkForDTMFSequence(skipFFT) || sequenceReady;
     
@@ -143,6 +358,7 @@ bool readDTMFSequence(bool skipFFT)
         // Reset sequence buffer for next sequence
         sequenceIndex = 0;
         dtmfSequence[0] = '\0';
+        resetDialCursors();
 
         // Lock input until hang-up if audio started
         if (audioStarted) {
@@ -161,6 +377,8 @@ void resetDTMFSequence()
     dtmfSequence[0] = '\0';
     sequenceReady = false;
     sequenceLocked = false;
+    resetDialCursors();
+    clearAudioPrediction();
     notify(NotificationType::ReadingSequence, false);  // Clear reading LED
     Logger.debugln("🔄 DTMF sequence reset");
 }
@@ -235,6 +453,7 @@ bool processNumberSequence(const char *sequence)
                   sequence, strlen(sequence));
 
     bool audioStarted = false;
+    clearAudioPrediction();   // The dial is decided
     
     if (isSpecialCommand(sequence))
     {
@@ -242,6 +461,9 @@ bool processNumberSequence(const char *sequence)
     }
     else if (getAudioKeyRegistry().hasKey(sequence))
     {
+        recordAudioKeyDialed(sequence);
+        requestAudioFileNow(sequence);   // Not on SD yet: fetch it during the ringback
+
 #if ENABLE_PLAYLIST_FEATURES
         // Play the playlist for this audio key (includes ringback, audio, click)
         audioStarted = audioPlayer.playPlaylist(sequence);
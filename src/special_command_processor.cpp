@@ -10,6 +10,7 @@
 //   special_commands.cpp  - initializeSpecialCommands, EEPROM, execute*() handlers,
 //                           isSpecialCommand, processSpecialCommand
 //   cpu_load_test.cpp     - performGoertzelCPULoadTest
+//   perf_suite.cpp        - performPerfSuite (perfsuite: PERF_JSON, POST /perf)
 //   audio_capture.cpp     - performAudioCapture
 //   audio_output_test.cpp - performAudioOutputTest
 //   debug_input.cpp       - performDebugInput + helpers (pumpMainLoop, etc.)
@@ -1,12 +1,16 @@
 #include "tailscale_manager.h"
 #include "logging.h"
 #include "config.h"
-#include "remote_logger.h"
+#include "http_dns.h"
 #include "notifications.h"
+#include "boot_pipeline.h"
+#include "web_page.h"
+#include "web_server_task.h"
 #include <WireGuard-ESP32.h>
 #include <Preferences.h>
 #include <WebServer.h>
 #include <time.h>
+#include <atomic>
 
 // Tailscale enable pin configuration
 // Can be overridden via build flags: -DTAILSCALE_ENABLE_PIN=xx
@@ -17,28 +21,45 @@
 // NVS namespace for VPN config
 #define VPN_NVS_NAMESPACE "vpn"
 
-// WireGuard instance
+// WireGuard instance (VpnLink task only)
 static WireGuard wg;
-static Preferences vpnPrefs;
-static bool vpnConnected = false;
-static bool vpnInitialized = false;
 static char tailscaleIp[20] = {0};
-static char statusBuffer[64] = "Not initialized";
-static unsigned long lastReconnectAttempt = 0;
-static const unsigned long RECONNECT_INTERVAL = 600000; // 10 minutes
-
-// Stored config for reconnection
-static char storedPrivateKey[64] = {0};
-static char storedPeerEndpoint[128] = {0};
-static char storedPeerPublicKey[64] = {0};
-static uint16_t storedPeerPort = 51820;
+
+enum class VpnState : uint8_t {
+    IDLE,           // Not wanted (never started, or disconnected)
+    WAIT_WIFI,      // Wanted, WiFi not up yet
+    SYNC_TIME,      // Waiting for NTP (WireGuard needs the time)
+    CONNECTING,     // Resolve the peer, wg.begin()
+    HANDSHAKE,      // Probing through the tunnel until the peer answers
+    UP,
+    BACKOFF         // Failed; waiting before the next attempt
+};
+
+// Shared with the VpnLink task
+static std::atomic<VpnState> vpnState{VpnState::IDLE};
+static std::atomic<bool> vpnWanted{false};
+static std::atomic<uint32_t> vpnConfigGen{0};   // Bumped by initTailscale()
+static VPNConfig vpnConfig;                     // Under vpnConfigMux
+static portMUX_TYPE vpnConfigMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t vpnTask = nullptr;
+
+// VpnLink task's own state
+struct VpnLinkState {
+    VPNConfig config = {};
+    IPAddress localAddr;
+    uint32_t gen = 0;               // vpnConfigGen this attempt was started from
+    bool tunnelOpen = false;        // wg.begin() succeeded, wg.end() not yet called
+    unsigned long since = 0;        // millis() of the last state change
+    unsigned long backoffMs = 0;
+    unsigned long lastProbe = 0;
+    int probeFailures = 0;
+};
+
 #ifdef TAILSCALE_ALWAYS_ENABLED
 static bool tailscaleEnabled = true;  // Set by shouldEnableTailscale()
 #else
 static bool tailscaleEnabled = false; // Set by shouldEnableTailscale()
 #endif
-// Callback to check if reconnection should be skipped (e.g., phone is off hook)
-static bool (*shouldSkipReconnect)() = nullptr;
 
 // Callbacks for Tailscale connection state changes
 static TailscaleStateCallback onTailscaleConnect = nullptr;
@@ -127,107 +148,240 @@ bool isTailscaleEnabled() {
     return tailscaleEnabled;
 }
 
+// ============================================================================
+// TUNNEL STATE MACHINE (VpnLink task, core 0)
+// ============================================================================
+
+static void setVpnState(VpnLinkState& link, VpnState state)
+{
+    link.since = millis();
+    vpnState = state;
+}
+
+static void kickVpnLink()
+{
+    if (vpnTask) {
+        xTaskNotifyGive(vpnTask);
+    }
+}
+
+// TCP connect to the probe address through the tunnel; the first one is
+// also what triggers the handshake
+static bool probeTunnel()
+{
+#if TAILSCALE_PROBE_PORT
+    IPAddress probeAddr;
+    probeAddr.fromString(TAILSCALE_PROBE_IP);
+    WiFiClient client;
+    bool ok = client.connect(probeAddr, TAILSCALE_PROBE_PORT, TAILSCALE_PROBE_TIMEOUT_MS);
+    client.stop();
+    return ok;
+#else
+    return true;
+#endif
+}
+
+static void closeTunnel(VpnLinkState& link)
+{
+    if (link.tunnelOpen) {
+        wg.end();
+        link.tunnelOpen = false;
+    }
+}
+
+static void failAttempt(VpnLinkState& link, const char* why)
+{
+    closeTunnel(link);
+    link.backoffMs = link.backoffMs ? min(link.backoffMs * 2, (unsigned long)TAILSCALE_BACKOFF_MAX_MS)
+                                    : (unsigned long)TAILSCALE_BACKOFF_MIN_MS;
+    Logger.printf("❌ Tailscale: %s - retrying in %lus\n", why, link.backoffMs / 1000);
+    setVpnState(link, VpnState::BACKOFF);
+}
+
+// One step of the tunnel state machine; returns how long to sleep before
+// the next. A kick (new config, disconnect) wakes the task early. NTP, DNS,
+// wg.begin() and the probe connects block only this task, never loop().
+static unsigned long vpnLinkDelay(VpnLinkState& link)
+{
+    uint32_t gen = vpnConfigGen;
+    if (!vpnWanted || gen != link.gen) {
+        closeTunnel(link);
+        link.gen = gen;
+        link.backoffMs = 0;
+        if (!vpnWanted) {
+            setVpnState(link, VpnState::IDLE);
+            return 60000;
+        }
+        portENTER_CRITICAL(&vpnConfigMux);
+        link.config = vpnConfig;
+        portEXIT_CRITICAL(&vpnConfigMux);
+        link.localAddr.fromString(link.config.localIp);
+        setVpnState(link, VpnState::WAIT_WIFI);
+    }
+
+    unsigned long elapsed = millis() - link.since;
+    switch (vpnState.load()) {
+        case VpnState::IDLE:
+            return 60000;
+
+        case VpnState::WAIT_WIFI:
+            if (!WiFi.isConnected()) {
+                return 500;
+            }
+            // WireGuard requires accurate time for handshake
+            Logger.println("🔐 Tailscale: Syncing time via NTP...");
+            configTime(0, 0, "pool.ntp.org", "time.nist.gov", "time.google.com");
+            setVpnState(link, VpnState::SYNC_TIME);
+            return 0;
+
+        case VpnState::SYNC_TIME: {
+            time_t now = 0;
+            time(&now);
+            if (now >= 1000000000) {
+                Logger.printf("✅ Tailscale: Time synced: %ld\n", now);
+            } else if (elapsed < TAILSCALE_NTP_TIMEOUT_MS) {
+                return 500;
+            } else {
+                Logger.println("⚠️ Tailscale: NTP sync timeout, continuing anyway");
+            }
+            setVpnState(link, VpnState::CONNECTING);
+            return 0;
+        }
+
+        case VpnState::CONNECTING: {
+            Logger.println("🔐 Tailscale: Starting WireGuard tunnel...");
+            Logger.printf("   Local IP: %s\n", link.config.localIp);
+            Logger.printf("   Peer: %s:%d\n", link.config.peerEndpoint, link.config.peerPort);
+
+            // Resolved here (HttpDns keeps the last address if DNS is down),
+            // so wg.begin() gets a literal and doesn't look it up itself
+            IPAddress peerAddr;
+            String endpoint = link.config.peerEndpoint;
+            if (HttpDns::resolve(link.config.peerEndpoint, peerAddr)) {
+                endpoint = peerAddr.toString();
+                Logger.printf("✅ Tailscale: Resolved %s -> %s\n", link.config.peerEndpoint, endpoint.c_str());
+            } else {
+                Logger.printf("⚠️ Tailscale: DNS lookup failed for %s\n", link.config.peerEndpoint);
+                Logger.println("   Will let WireGuard try anyway...");
+            }
+
+            // Public DNS may be unreachable through the tunnel; HttpDns keeps
+            // these addresses past their TTL if a later lookup fails
+            HttpDns::prefetch(UPDATE_CHECK_URL);
+            HttpDns::prefetch(KNOWN_SEQUENCES_URL);
+
+            // Start WireGuard (/32 point-to-point, all traffic tunneled)
+            if (!wg.begin(link.localAddr, link.config.privateKey, endpoint.c_str(),
+                          link.config.peerPublicKey, link.config.peerPort)) {
+                failAttempt(link, "Failed to establish tunnel");
+                return 0;
+            }
+            link.tunnelOpen = true;
+            setVpnState(link, VpnState::HANDSHAKE);
+            return 0;
+        }
+
+        case VpnState::HANDSHAKE:
+            if (probeTunnel()) {
+                link.backoffMs = 0;
+                link.probeFailures = 0;
+                link.lastProbe = millis();
+
+                // Use WireGuard server's DNS forwarder (10.253.0.1) as primary
+                // This ensures DNS works through the VPN tunnel
+                // Fallback to public DNS in case WireGuard server DNS is down
+                IPAddress vpnDns(10, 253, 0, 1);  // WireGuard server running dnsmasq
+                IPAddress fallbackDns = DNS_PRIMARY_IPADDRESS;  // Public DNS fallback
+                WiFi.config(WiFi.localIP(), WiFi.gatewayIP(), WiFi.subnetMask(), vpnDns, fallbackDns);
+                Logger.printf("✅ Tailscale: Connected! Local IP: %s (%lu ms handshake)\n",
+                              link.config.localIp, elapsed);
+                Logger.printf("🌐 DNS configured for VPN: %s (primary), %s (fallback)\n",
+                              vpnDns.toString().c_str(), fallbackDns.toString().c_str());
+                setVpnState(link, VpnState::UP);
+                return 1000;
+            }
+            if (elapsed >= TAILSCALE_HANDSHAKE_TIMEOUT_MS) {
+                failAttempt(link, "No handshake with peer");
+                return 0;
+            }
+            return 1000;
+
+        case VpnState::UP:
+            if (!WiFi.isConnected()) {
+                Logger.println("🔐 Tailscale: WiFi lost - closing tunnel");
+                closeTunnel(link);
+                setVpnState(link, VpnState::WAIT_WIFI);
+                return 500;
+            }
+            if (millis() - link.lastProbe >= TAILSCALE_PROBE_INTERVAL_MS) {
+                link.lastProbe = millis();
+                if (probeTunnel()) {
+                    link.probeFailures = 0;
+                } else if (++link.probeFailures >= TAILSCALE_PROBE_FAILURES) {
+                    failAttempt(link, "Tunnel stopped answering");
+                    return 0;
+                }
+            }
+            return 1000;
+
+        case VpnState::BACKOFF:
+            if (elapsed >= link.backoffMs) {
+                Logger.println("🔐 Tailscale: Attempting reconnection...");
+                setVpnState(link, VpnState::WAIT_WIFI);
+                return 0;
+            }
+            return link.backoffMs - elapsed;
+    }
+    return 1000;
+}
+
+static void vpnTaskMain(void* /*arg*/)
+{
+    VpnLinkState link;
+    for (;;) {
+        unsigned long waitMs = vpnLinkDelay(link);
+        if (waitMs > 0) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+        }
+    }
+}
+
 bool initTailscale(const char* localIp, 
                    const char* privateKey,
                    const char* peerEndpoint, 
                    const char* peerPublicKey,
                    uint16_t peerPort) {
     
-    if (!WiFi.isConnected()) {
-        Logger.println("❌ Tailscale: WiFi not connected");
-        strcpy(statusBuffer, "WiFi not connected");
-        return false;
-    }
-    
-    // Store config for potential reconnection
-    strncpy(tailscaleIp, localIp, sizeof(tailscaleIp) - 1);
-    strncpy(storedPrivateKey, privateKey, sizeof(storedPrivateKey) - 1);
-    strncpy(storedPeerEndpoint, peerEndpoint, sizeof(storedPeerEndpoint) - 1);
-    strncpy(storedPeerPublicKey, peerPublicKey, sizeof(storedPeerPublicKey) - 1);
-    storedPeerPort = peerPort;
-    
-    Logger.println("🔐 Tailscale: Syncing time via NTP...");
-    strcpy(statusBuffer, "Syncing NTP...");
-    
-    // WireGuard requires accurate time for handshake
-    configTime(0, 0, "pool.ntp.org", "time.nist.gov", "time.google.com");
-    
-    // Wait for time sync (max 10 seconds)
-    time_t now = 0;
-    int attempts = 0;
-    while (now < 1000000000 && attempts < 20) {
-        delay(500);
-        time(&now);
-        attempts++;
-    }
-    
-    if (now < 1000000000) {
-        Logger.println("⚠️ Tailscale: NTP sync timeout, continuing anyway");
-    } else {
-        Logger.printf("✅ Tailscale: Time synced: %ld\n", now);
-    }
-    
-    Logger.println("🔐 Tailscale: Starting WireGuard tunnel...");
-    Logger.printf("   Local IP: %s\n", localIp);
-    Logger.printf("   Peer: %s:%d\n", peerEndpoint, peerPort);
-    strcpy(statusBuffer, "Connecting...");
-    
-    // Parse local IP
     IPAddress localAddr;
     if (!localAddr.fromString(localIp)) {
         Logger.println("❌ Tailscale: Invalid local IP format");
-        strcpy(statusBuffer, "Invalid local IP");
         return false;
     }
-    
-    // Try to resolve the endpoint hostname first to check DNS
-    IPAddress peerAddr;
-    if (!WiFi.hostByName(peerEndpoint, peerAddr)) {
-        Logger.printf("⚠️ Tailscale: DNS lookup failed for %s\n", peerEndpoint);
-        Logger.println("   Will let WireGuard try anyway...");
-    } else {
-        Logger.printf("✅ Tailscale: Resolved %s -> %s\n", peerEndpoint, peerAddr.toString().c_str());
-    }
-    
-    // Start WireGuard (/32 point-to-point, all traffic tunneled)
-    bool result = wg.begin(
-        localAddr,
-        privateKey,
-        peerEndpoint,
-        peerPublicKey,
-        peerPort
-    );
-    
-    if (result) {
-        vpnConnected = true;
-        vpnInitialized = true;
-        Logger.printf("✅ Tailscale: Connected! Local IP: %s\n", localIp);
-        snprintf(statusBuffer, sizeof(statusBuffer), "Connected: %s", localIp);
-        
-        // Notify Tailscale connected (turns on red LED)
-        notify(NotificationType::TailscaleConnected, true);
-        
-        // Call connect callback if set
-        if (onTailscaleConnect) {
-            onTailscaleConnect();
-        }
-        
-        // Use WireGuard server's DNS forwarder (10.253.0.1) as primary
-        // This ensures DNS works through the VPN tunnel
-        // Fallback to public DNS in case WireGuard server DNS is down
-        IPAddress vpnDns(10, 253, 0, 1);  // WireGuard server running dnsmasq
-        IPAddress fallbackDns = DNS_PRIMARY_IPADDRESS;  // Public DNS fallback
-        WiFi.config(WiFi.localIP(), WiFi.gatewayIP(), WiFi.subnetMask(), vpnDns, fallbackDns);
-        Logger.printf("🌐 DNS configured for VPN: %s (primary), %s (fallback)\n", 
-                      vpnDns.toString().c_str(), fallbackDns.toString().c_str());
-    } else {
-        vpnInitialized = true;  // Mark as initialized so handleTailscaleLoop will retry
-        vpnConnected = false;
-        Logger.println("❌ Tailscale: Failed to establish tunnel - will retry");
-        strcpy(statusBuffer, "Connection failed - retrying");
+
+    // Picked up by the VpnLink task, which restarts the tunnel with it
+    portENTER_CRITICAL(&vpnConfigMux);
+    memset(&vpnConfig, 0, sizeof(vpnConfig));
+    strncpy(vpnConfig.localIp, localIp, sizeof(vpnConfig.localIp) - 1);
+    strncpy(vpnConfig.privateKey, privateKey, sizeof(vpnConfig.privateKey) - 1);
+    strncpy(vpnConfig.peerEndpoint, peerEndpoint, sizeof(vpnConfig.peerEndpoint) - 1);
+    strncpy(vpnConfig.peerPublicKey, peerPublicKey, sizeof(vpnConfig.peerPublicKey) - 1);
+    vpnConfig.peerPort = peerPort;
+    vpnConfig.configured = true;
+    portEXIT_CRITICAL(&vpnConfigMux);
+    strncpy(tailscaleIp, localIp, sizeof(tailscaleIp) - 1);
+
+    vpnConfigGen++;
+    vpnWanted = true;
+    if (!vpnTask &&
+        xTaskCreatePinnedToCore(vpnTaskMain, "VpnLink", TAILSCALE_TASK_STACK, nullptr,
+                                TAILSCALE_TASK_PRIORITY, &vpnTask, 0) != pdPASS) {
+        vpnTask = nullptr;
+        Logger.println("❌ Tailscale: failed to start VpnLink task");
+        return false;
     }
-    
-    return result;
+    kickVpnLink();
+    Logger.println("🔐 Tailscale: Tunnel bring-up started in background");
+    return true;
 }
 
 bool initTailscaleFromConfig() {
@@ -260,44 +414,29 @@ bool initTailscaleFromConfig() {
 #else
     Logger.println("⚠️ Tailscale: No WireGuard config in build flags or NVS");
     Logger.println("   Configure via /vpn web page or set WIREGUARD_* defines");
-    strcpy(statusBuffer, "Not configured");
     return false;
 #endif
 }
 
 bool isTailscaleConnected() {
-    return vpnConnected && vpnInitialized;
+    return vpnState == VpnState::UP;
 }
 
 const char* getTailscaleIP() {
-    if (vpnConnected && tailscaleIp[0] != '\0') {
+    if (isTailscaleConnected() && tailscaleIp[0] != '\0') {
         return tailscaleIp;
     }
     return nullptr;
 }
 
 void disconnectTailscale() {
-    if (vpnInitialized) {
+    if (vpnWanted) {
         Logger.println("🔐 Tailscale: Disconnecting...");
-        wg.end();
-        vpnConnected = false;
-        vpnInitialized = false;
-        strcpy(statusBuffer, "Disconnected");
-        
-        // Notify Tailscale disconnected (turns off red LED)
-        notify(NotificationType::TailscaleConnected, false);
-        
-        // Call disconnect callback if set
-        if (onTailscaleDisconnect) {
-            onTailscaleDisconnect();
-        }
+        vpnWanted = false;
+        kickVpnLink();
     }
 }
 
-void setTailscaleSkipCallback(bool (*callback)()) {
-    shouldSkipReconnect = callback;
-}
-
 void setTailscaleConnectCallback(TailscaleStateCallback callback) {
     onTailscaleConnect = callback;
 }
@@ -307,79 +446,62 @@ void setTailscaleDisconnectCallback(TailscaleStateCallback callback) {
 }
 
 void handleTailscaleLoop() {
+    // Connect/disconnect edges from the VpnLink task, reported on core 1
+    static bool reportedConnected = false;
+    bool connected = isTailscaleConnected();
+    if (connected != reportedConnected) {
+        reportedConnected = connected;
+        if (connected) {
+            bootPipeline.end(BootStage::VPN);
+        } else {
+            Logger.println("🔐 Tailscale: Disconnected");
+        }
+        // Red LED follows the tunnel
+        notify(NotificationType::TailscaleConnected, connected);
+        TailscaleStateCallback cb = connected ? onTailscaleConnect : onTailscaleDisconnect;
+        if (cb) {
+            cb();
+        }
+    }
+
     // Skip if Tailscale was not enabled at boot
     if (!tailscaleEnabled) {
         return;
     }
     
-    // Flush buffered remote logs periodically
-    RemoteLogger.flush();
-    
     // Periodic WireGuard diagnostic (every 60s when connected)
     static unsigned long lastWgDiag = 0;
     unsigned long diagNow = millis();
-    if (vpnConnected && (diagNow - lastWgDiag >= 60000)) {
+    if (connected && (diagNow - lastWgDiag >= 60000)) {
         lastWgDiag = diagNow;
         Logger.printf("🔐 WG: %s | uptime: %lus | WiFi RSSI: %d dBm\n",
             tailscaleIp, diagNow / 1000, WiFi.RSSI());
     }
-    
-    // Check if we need to reconnect
-    if (vpnInitialized && !vpnConnected) {
-        unsigned long now = millis();
-        if (now - lastReconnectAttempt > RECONNECT_INTERVAL) {
-            lastReconnectAttempt = now;
-            
-            // Skip reconnection if callback says so (e.g., phone is off hook for DTMF)
-            if (shouldSkipReconnect && shouldSkipReconnect()) {
-                Logger.println("🔐 Tailscale: Skipping reconnect (phone in use)");
-                return;
-            }
-            
-            if (WiFi.isConnected() && storedPrivateKey[0] != '\0') {
-                Logger.println("🔐 Tailscale: Attempting reconnection...");
-                strcpy(statusBuffer, "Reconnecting...");
-                
-                // Try to reconnect
-                IPAddress localAddr;
-                localAddr.fromString(tailscaleIp);
-                
-                bool result = wg.begin(
-                    localAddr,
-                    storedPrivateKey,
-                    storedPeerEndpoint,
-                    storedPeerPublicKey,
-                    storedPeerPort
-                );
-                
-                if (result) {
-                    vpnConnected = true;
-                    Logger.println("✅ Tailscale: Reconnected!");
-                    snprintf(statusBuffer, sizeof(statusBuffer), "Connected: %s", tailscaleIp);
-                    
-                    // Notify Tailscale connected (turns on red LED)
-                    notify(NotificationType::TailscaleConnected, true);
-                    
-                    // Call connect callback if set
-                    if (onTailscaleConnect) {
-                        onTailscaleConnect();
-                    }
-                }
-            }
-        }
-    }
 }
 
 const char* getTailscaleStatus() {
-    return statusBuffer;
+    switch (vpnState.load()) {
+        case VpnState::IDLE:
+            return vpnConfigGen ? "Disconnected" : "Not initialized";
+        case VpnState::WAIT_WIFI:  return "Waiting for WiFi";
+        case VpnState::SYNC_TIME:  return "Syncing NTP...";
+        case VpnState::CONNECTING: return "Connecting...";
+        case VpnState::HANDSHAKE:  return "Handshaking...";
+        case VpnState::UP:         return "Connected";
+        case VpnState::BACKOFF:    return "Connection failed - retrying";
+    }
+    return "Unknown";
 }
 
 // ============================================================================
 // VPN Configuration Storage (NVS)
 // ============================================================================
 
+// Each call opens its own Preferences: the pages read the config from the
+// web task while loop() may be loading it for a reconnect
 bool loadVPNConfig(VPNConfig* config) {
     if (!config) return false;
+    Preferences vpnPrefs;
     
     memset(config, 0, sizeof(VPNConfig));
     
@@ -411,6 +533,7 @@ bool loadVPNConfig(VPNConfig* config) {
 
 bool saveVPNConfig(const VPNConfig* config) {
     if (!config) return false;
+    Preferences vpnPrefs;
     
     if (!vpnPrefs.begin(VPN_NVS_NAMESPACE, false)) {  // Read-write
         Logger.println("❌ VPN: Failed to open NVS for writing");
@@ -431,6 +554,7 @@ bool saveVPNConfig(const VPNConfig* config) {
 }
 
 void clearVPNConfig() {
+    Preferences vpnPrefs;
     if (!vpnPrefs.begin(VPN_NVS_NAMESPACE, false)) {
         return;
     }
@@ -514,56 +638,50 @@ button:hover{background:#ff6b6b}
 // Web server pointer (set by initVPNConfigRoutes)
 static WebServer* vpnWebServer = nullptr;
 
-void handleVPNConfigPage() {
-    if (!vpnWebServer) return;
-    
-    String html = FPSTR(VPN_CONFIG_PAGE);
-    
-    // Get current config
-    VPNConfig config;
-    bool hasNvsConfig = loadVPNConfig(&config);
-    
-    // Status
-    if (isTailscaleConnected()) {
-        html.replace("%STATUS_CLASS%", "connected");
-        html.replace("%STATUS%", String("✅ Connected: ") + getTailscaleIP());
-    } else if (vpnInitialized) {
-        html.replace("%STATUS_CLASS%", "disconnected");
-        html.replace("%STATUS%", "⚠️ Connecting or failed...");
-    } else {
-        html.replace("%STATUS_CLASS%", "disconnected");
-        html.replace("%STATUS%", hasNvsConfig ? "🔧 Configured (not started)" : "❌ Not configured");
-    }
-    
-    // Fill form values
-    if (hasNvsConfig) {
-        html.replace("%LOCAL_IP%", config.localIp);
-        html.replace("%PRIVATE_KEY%", ""); // Don't show private key
-        html.replace("%PEER_ENDPOINT%", config.peerEndpoint);
-        html.replace("%PEER_PUBLIC_KEY%", config.peerPublicKey);
-        html.replace("%PEER_PORT%", String(config.peerPort));
+// Fields of VPN_CONFIG_PAGE; @p ctx is the NVS config, or nullptr when
+// there is none and the compile-time defaults are shown
+static void vpnPageField(const char* name, Print& out, void* ctx) {
+    const VPNConfig* config = static_cast<const VPNConfig*>(ctx);
+
+    if (!strcmp(name, "STATUS_CLASS")) {
+        out.print(isTailscaleConnected() ? "connected" : "disconnected");
+    } else if (!strcmp(name, "STATUS")) {
+        if (isTailscaleConnected()) {
+            out.printf("✅ Connected: %s", getTailscaleIP());
+        } else if (vpnState != VpnState::IDLE) {
+            out.print("⚠️ Connecting or failed...");
+        } else {
+            out.print(config ? "🔧 Configured (not started)" : "❌ Not configured");
+        }
+    } else if (!strcmp(name, "PRIVATE_KEY")) {
+        // Don't show private key
+    } else if (config) {
+        if (!strcmp(name, "LOCAL_IP")) printHtmlEscaped(out, config->localIp);
+        else if (!strcmp(name, "PEER_ENDPOINT")) printHtmlEscaped(out, config->peerEndpoint);
+        else if (!strcmp(name, "PEER_PUBLIC_KEY")) printHtmlEscaped(out, config->peerPublicKey);
+        else if (!strcmp(name, "PEER_PORT")) out.print((unsigned)config->peerPort);
     } else {
         // Use compile-time defaults if available
 #ifdef WIREGUARD_LOCAL_IP
-        html.replace("%LOCAL_IP%", WIREGUARD_LOCAL_IP);
-#else
-        html.replace("%LOCAL_IP%", "");
+        if (!strcmp(name, "LOCAL_IP")) out.print(WIREGUARD_LOCAL_IP);
 #endif
-        html.replace("%PRIVATE_KEY%", "");
 #ifdef WIREGUARD_PEER_ENDPOINT
-        html.replace("%PEER_ENDPOINT%", WIREGUARD_PEER_ENDPOINT);
-#else
-        html.replace("%PEER_ENDPOINT%", "");
+        if (!strcmp(name, "PEER_ENDPOINT")) out.print(WIREGUARD_PEER_ENDPOINT);
 #endif
 #ifdef WIREGUARD_PEER_PUBLIC_KEY
-        html.replace("%PEER_PUBLIC_KEY%", WIREGUARD_PEER_PUBLIC_KEY);
-#else
-        html.replace("%PEER_PUBLIC_KEY%", "");
+        if (!strcmp(name, "PEER_PUBLIC_KEY")) out.print(WIREGUARD_PEER_PUBLIC_KEY);
 #endif
-        html.replace("%PEER_PORT%", String(WIREGUARD_PEER_PORT));
+        if (!strcmp(name, "PEER_PORT")) out.print((unsigned)WIREGUARD_PEER_PORT);
     }
+}
+
+void handleVPNConfigPage() {
+    if (!vpnWebServer) return;
     
-    vpnWebServer->send(200, "text/html", html);
+    // Get current config
+    VPNConfig config;
+    bool hasNvsConfig = loadVPNConfig(&config);
+    sendPage(*vpnWebServer, VPN_CONFIG_PAGE, vpnPageField, hasNvsConfig ? &config : nullptr);
 }
 
 void handleVPNSave() {
@@ -599,16 +717,10 @@ void handleVPNSave() {
     }
     
     if (saveVPNConfig(&config)) {
-        // Disconnect existing VPN and reconnect with new config
-        if (vpnInitialized) {
-            disconnectTailscale();
-        }
-        
         vpnWebServer->sendHeader("Location", "/", true);
         vpnWebServer->send(302, "text/plain", "Saved! Reconnecting...");
         
-        // Try to connect with new config (after a short delay)
-        delay(500);
+        // Restarts the tunnel with the new config in the background
         initTailscaleFromConfig();
     } else {
         vpnWebServer->send(500, "text/plain", "Failed to save configuration");
@@ -620,9 +732,7 @@ void handleVPNClear() {
     
     clearVPNConfig();
     
-    if (vpnInitialized) {
-        disconnectTailscale();
-    }
+    disconnectTailscale();
     
     vpnWebServer->sendHeader("Location", "/", true);
     vpnWebServer->send(302, "text/plain", "Config cleared");
@@ -666,9 +776,9 @@ void initVPNConfigRoutes(void* server) {
     if (!vpnWebServer) return;
     
     vpnWebServer->on("/vpn", HTTP_GET, handleVPNConfigPage);
-    vpnWebServer->on("/vpn/save", HTTP_POST, handleVPNSave);
-    vpnWebServer->on("/vpn/clear", HTTP_POST, handleVPNClear);
-    vpnWebServer->on("/vpn/toggle", HTTP_GET, handleVPNToggle);
+    vpnWebServer->on("/vpn/save", HTTP_POST, webServerTask.onLoop(handleVPNSave));
+    vpnWebServer->on("/vpn/clear", HTTP_POST, webServerTask.onLoop(handleVPNClear));
+    vpnWebServer->on("/vpn/toggle", HTTP_GET, webServerTask.onLoop(handleVPNToggle));
     vpnWebServer->on("/vpn/status", HTTP_GET, handleVPNStatus);
     
     Logger.println("🔐 VPN config routes registered (/vpn, /vpn/toggle, /vpn/status)");
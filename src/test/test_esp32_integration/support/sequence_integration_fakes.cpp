@@ -129,4 +129,17 @@ void processSpecialCommand(const char* sequence) {
     (void)sequence;
 }
 
+int getSpecialCommandCount() {
+    return 0;
+}
+
+const char* getSpecialCommandSequence(int index) {
+    (void)index;
+    return nullptr;
+}
+
+uint32_t getSpecialCommandsGeneration() {
+    return 0;
+}
+
 #endif // TEST_MODE
@@ -20,7 +20,9 @@ extern ExtendedAudioPlayer audioPlayer;
 
 namespace {
 
-const int GOERTZEL_RELEASE_BLOCKS_FOR_TEST = 4;
+// Shared across tests: the decoder keeps a pointer to the stream it was
+// initialized with, so it must outlive each test body.
+DtmfGoertzelStream goertzel;
 
 bool mapDigitToRowCol(char digit, int& row, int& col) {
     switch (digit) {
@@ -40,7 +42,25 @@ bool mapDigitToRowCol(char digit, int& row, int& col) {
     }
 }
 
-void initGoertzelForTest(GoertzelStream& goertzel) {
+// Codec-rate samples between detector evaluations (one hop, pre-decimation)
+int evaluationStepSamples() {
+    return goertzel.inputHopSamples();
+}
+
+// Codec-rate samples in one full analysis window
+int windowInputSamples() {
+    return goertzel.windowSize() * goertzel.decimation();
+}
+
+// Silent evaluations until a key is released: the window has to clear of
+// tone (window/hop evaluations, plus one for the decimator's filter tail)
+// and then releaseBlockCount misses must pass.
+int releaseStepsForTest() {
+    const PhoneConfig& config = getPhoneConfig();
+    return config.releaseBlockCount + goertzel.windowSize() / goertzel.hopSize() + 1;
+}
+
+void initGoertzelForTest(DtmfGoertzelStream& goertzel) {
     StreamCopy dummyCopier;
     initGoertzelDecoder(goertzel, dummyCopier);
 }
@@ -53,22 +73,21 @@ void runMainLikeSequenceStep() {
     readDTMFSequence(true);
 }
 
-void feedSilenceBlocks(GoertzelStream& goertzel, int blocks, float& phaseOffset) {
-    const PhoneConfig& config = getPhoneConfig();
-    const int blockSize = config.goertzelBlockSize;
-    std::vector<int16_t> silenceBlock(blockSize);
+void feedSilenceBlocks(DtmfGoertzelStream& goertzel, int steps, float& phaseOffset) {
+    const int stepSize = evaluationStepSamples();
+    std::vector<int16_t> silenceBlock(stepSize);
 
     generateSilenceBlockForTest(silenceBlock.data(), silenceBlock.size());
-    for (int i = 0; i < blocks; i++) {
+    for (int i = 0; i < steps; i++) {
         processGoertzelSamplesForTest(goertzel, silenceBlock.data(), silenceBlock.size());
         runMainLikeSequenceStep();
-        phaseOffset += static_cast<float>(blockSize);
+        phaseOffset += static_cast<float>(stepSize);
     }
 }
 
-void feedDigitBlocks(GoertzelStream& goertzel,
+void feedDigitBlocks(DtmfGoertzelStream& goertzel,
                      char digit,
-                     int blocks,
+                     int steps,
                      float& phaseOffset,
                      float lowAmplitude = 12000.0f,
                      float highAmplitude = 12000.0f) {
@@ -77,31 +96,65 @@ void feedDigitBlocks(GoertzelStream& goertzel,
     TEST_ASSERT_TRUE_MESSAGE(mapDigitToRowCol(digit, row, col), "Digit not mapped to row/col");
 
     const PhoneConfig& config = getPhoneConfig();
-    const int blockSize = config.goertzelBlockSize;
-    std::vector<int16_t> toneBlock(blockSize);
+    const int stepSize = evaluationStepSamples();
+    std::vector<int16_t> toneBlock(stepSize);
 
-    generateDualToneBlockWithGainsForTest(
-        toneBlock.data(),
-        toneBlock.size(),
-        static_cast<float>(AUDIO_SAMPLE_RATE),
-        config.rowFreqs[row],
-        config.colFreqs[col],
-        lowAmplitude,
-        highAmplitude,
-        phaseOffset
-    );
-
-    for (int i = 0; i < blocks; i++) {
+    for (int i = 0; i < steps; i++) {
+        // Regenerate per step so the tone stays phase-continuous across hops
+        generateDualToneBlockWithGainsForTest(
+            toneBlock.data(),
+            toneBlock.size(),
+            static_cast<float>(AUDIO_SAMPLE_RATE),
+            config.rowFreqs[row],
+            config.colFreqs[col],
+            lowAmplitude,
+            highAmplitude,
+            phaseOffset
+        );
         processGoertzelSamplesForTest(goertzel, toneBlock.data(), toneBlock.size());
         runMainLikeSequenceStep();
-        phaseOffset += static_cast<float>(blockSize);
+        phaseOffset += static_cast<float>(stepSize);
     }
 }
 
-void emitDigitFromFrequencies(GoertzelStream& goertzel, char digit, float& phaseOffset) {
+// Feed a digit with an extra interfering tone mixed in
+void feedDigitWithToneBlocks(DtmfGoertzelStream& goertzel,
+                             char digit,
+                             int steps,
+                             float& phaseOffset,
+                             float toneAmplitude,
+                             float extraFreq,
+                             float extraAmplitude) {
+    int row = -1;
+    int col = -1;
+    TEST_ASSERT_TRUE_MESSAGE(mapDigitToRowCol(digit, row, col), "Digit not mapped to row/col");
+
+    const PhoneConfig& config = getPhoneConfig();
+    const int stepSize = evaluationStepSamples();
+    std::vector<int16_t> toneBlock(stepSize);
+    std::vector<int16_t> extraBlock(stepSize);
+
+    for (int i = 0; i < steps; i++) {
+        generateDualToneBlockWithGainsForTest(
+            toneBlock.data(), toneBlock.size(), static_cast<float>(AUDIO_SAMPLE_RATE),
+            config.rowFreqs[row], config.colFreqs[col],
+            toneAmplitude, toneAmplitude, phaseOffset);
+        generateSingleToneBlockForTest(
+            extraBlock.data(), extraBlock.size(), static_cast<float>(AUDIO_SAMPLE_RATE),
+            extraFreq, extraAmplitude, phaseOffset);
+        for (int k = 0; k < stepSize; k++) {
+            toneBlock[k] = static_cast<int16_t>(toneBlock[k] + extraBlock[k]);
+        }
+        processGoertzelSamplesForTest(goertzel, toneBlock.data(), toneBlock.size());
+        runMainLikeSequenceStep();
+        phaseOffset += static_cast<float>(stepSize);
+    }
+}
+
+void emitDigitFromFrequencies(DtmfGoertzelStream& goertzel, char digit, float& phaseOffset) {
     const PhoneConfig& config = getPhoneConfig();
     feedDigitBlocks(goertzel, digit, config.requiredConsecutive, phaseOffset);
-    feedSilenceBlocks(goertzel, GOERTZEL_RELEASE_BLOCKS_FOR_TEST + 2, phaseOffset);
+    feedSilenceBlocks(goertzel, releaseStepsForTest() + 2, phaseOffset);
 }
 
 void configureDefaultHookCallbacks() {
@@ -151,7 +204,6 @@ void test_offhook_and_frequency_sequence_triggers_registered_key() {
     AudioPlayerSpyState& spy = getAudioPlayerSpyState();
     TEST_ASSERT_EQUAL_STRING("dialtone", spy.lastAudioKey);
 
-    GoertzelStream goertzel;
     initGoertzelForTest(goertzel);
 
     float phaseOffset = 0.0f;
@@ -218,7 +270,6 @@ void test_invalid_digit_is_ignored() {
 }
 
 void test_goertzel_requires_requiredConsecutive_blocks() {
-    GoertzelStream goertzel;
     initGoertzelForTest(goertzel);
     float phaseOffset = 0.0f;
     const PhoneConfig& config = getPhoneConfig();
@@ -233,7 +284,6 @@ void test_goertzel_requires_requiredConsecutive_blocks() {
 }
 
 void test_goertzel_suppresses_repeat_until_release() {
-    GoertzelStream goertzel;
     initGoertzelForTest(goertzel);
     float phaseOffset = 0.0f;
     const PhoneConfig& config = getPhoneConfig();
@@ -244,7 +294,7 @@ void test_goertzel_suppresses_repeat_until_release() {
     feedDigitBlocks(goertzel, '8', 1, phaseOffset);
     TEST_ASSERT_EQUAL(0, getGoertzelKey());
 
-    feedSilenceBlocks(goertzel, GOERTZEL_RELEASE_BLOCKS_FOR_TEST, phaseOffset);
+    feedSilenceBlocks(goertzel, releaseStepsForTest(), phaseOffset);
     TEST_ASSERT_EQUAL(0, getGoertzelKey());
 
     feedDigitBlocks(goertzel, '8', config.requiredConsecutive, phaseOffset);
@@ -252,10 +302,9 @@ void test_goertzel_suppresses_repeat_until_release() {
 }
 
 void test_goertzel_rejects_single_tone_blocks() {
-    GoertzelStream goertzel;
     initGoertzelForTest(goertzel);
     const PhoneConfig& config = getPhoneConfig();
-    const int blockSize = config.goertzelBlockSize;
+    const int blockSize = windowInputSamples();
     std::vector<int16_t> singleTone(blockSize);
 
     float phaseOffset = 0.0f;
@@ -275,14 +324,13 @@ void test_goertzel_rejects_single_tone_blocks() {
 }
 
 void test_goertzel_rejects_excessive_twist_ratio() {
-    GoertzelStream goertzel;
     initGoertzelForTest(goertzel);
     int row = -1;
     int col = -1;
     TEST_ASSERT_TRUE(mapDigitToRowCol('6', row, col));
 
     const PhoneConfig& config = getPhoneConfig();
-    const int blockSize = config.goertzelBlockSize;
+    const int blockSize = windowInputSamples();
     std::vector<int16_t> toneBlock(blockSize);
 
     float phaseOffset = 0.0f;
@@ -303,6 +351,35 @@ void test_goertzel_rejects_excessive_twist_ratio() {
     }
 }
 
+void test_goertzel_rejects_strong_second_harmonic() {
+    initGoertzelForTest(goertzel);
+    const PhoneConfig& config = getPhoneConfig();
+    if (config.maxHarmonicRatio <= 0 || !GOERTZEL_HARMONIC_BINS) {
+        TEST_IGNORE_MESSAGE("Harmonic check disabled for this phone");
+    }
+
+    // '5' with a voice-like 2nd harmonic of the row tone as strong as the row
+    float phaseOffset = 0.0f;
+    feedDigitWithToneBlocks(goertzel, '5', config.requiredConsecutive + 2, phaseOffset,
+                            10000.0f, 2.0f * config.rowFreqs[1], 10000.0f);
+    TEST_ASSERT_EQUAL(0, getGoertzelKey());
+}
+
+void test_goertzel_rejects_tones_not_dominating_block_energy() {
+    initGoertzelForTest(goertzel);
+    const PhoneConfig& config = getPhoneConfig();
+    if (config.minToneEnergyRatio <= 0) {
+        TEST_IGNORE_MESSAGE("Energy ratio check disabled for this phone");
+    }
+
+    // '5' under a louder off-bin tone: the pair is the strongest DTMF bins
+    // but holds well under half the window energy
+    float phaseOffset = 0.0f;
+    feedDigitWithToneBlocks(goertzel, '5', config.requiredConsecutive + 2, phaseOffset,
+                            6000.0f, 400.0f, 14000.0f);
+    TEST_ASSERT_EQUAL(0, getGoertzelKey());
+}
+
 void test_onhook_callback_resets_sequence() {
     configureDefaultHookCallbacks();
 
@@ -347,7 +424,6 @@ void test_unknown_frequency_sequence_plays_wrong_number() {
 
     Phone.setOffHook(true, true);
 
-    GoertzelStream goertzel;
     initGoertzelForTest(goertzel);
 
     float phaseOffset = 0.0f;
@@ -373,6 +449,8 @@ void setup() {
     RUN_TEST(test_goertzel_suppresses_repeat_until_release);
     RUN_TEST(test_goertzel_rejects_single_tone_blocks);
     RUN_TEST(test_goertzel_rejects_excessive_twist_ratio);
+    RUN_TEST(test_goertzel_rejects_strong_second_harmonic);
+    RUN_TEST(test_goertzel_rejects_tones_not_dominating_block_energy);
     RUN_TEST(test_onhook_callback_resets_sequence);
     RUN_TEST(test_known_sequence_can_use_playlist_success_without_fallback);
     RUN_TEST(test_max_sequence_length_configuration_roundtrip);
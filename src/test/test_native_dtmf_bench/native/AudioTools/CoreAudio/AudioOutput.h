@@ -0,0 +1,31 @@
+#pragma once
+
+// Host AudioOutput/AudioInfo with the AudioTools member names
+
+#include <Arduino.h>
+
+struct AudioInfo {
+    int sample_rate = 44100;
+    int channels = 2;
+    int bits_per_sample = 16;
+};
+
+class AudioInfoSupport {
+public:
+    virtual ~AudioInfoSupport() {}
+    virtual void setAudioInfo(AudioInfo info) { _info = info; }
+    virtual AudioInfo audioInfo() { return _info; }
+protected:
+    AudioInfo _info;
+};
+
+class AudioOutput : public Print, public AudioInfoSupport {
+public:
+    virtual bool begin() { _active = true; return true; }
+    virtual void end() { _active = false; }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t len) override = 0;
+    operator bool() const { return _active; }
+protected:
+    bool _active = false;
+};
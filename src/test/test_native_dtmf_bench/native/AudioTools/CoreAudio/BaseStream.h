@@ -0,0 +1,14 @@
+#pragma once
+
+// Host AudioStream: a Stream that carries AudioInfo
+
+#include "AudioTools/CoreAudio/AudioOutput.h"
+
+class AudioStream : public Stream, public AudioInfoSupport {
+public:
+    virtual bool begin() { return true; }
+    virtual void end() {}
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t len) override = 0;
+    size_t readBytes(uint8_t* data, size_t len) override = 0;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+// Host StreamCopy: the bench feeds the detector directly, so copy() is inert
+
+#include "AudioTools/CoreAudio/BaseStream.h"
+
+class StreamCopy {
+public:
+    StreamCopy() {}
+    StreamCopy(Print& to, Stream& from, int bufferSize = 1024) {}
+    void begin(Print& to, Stream& from) {}
+    void resize(int bufferSize) {}
+    size_t copy() { return 0; }
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+// Host Preferences: namespaces never open, so stored calibration is absent
+// and the PhoneConfig defaults apply
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) { return false; }
+    void end() {}
+    bool clear() { return false; }
+    bool isKey(const char* key) { return false; }
+    float getFloat(const char* key, float defaultValue = 0) { return defaultValue; }
+    size_t putFloat(const char* key, float value) { return 0; }
+    bool getBool(const char* key, bool defaultValue = false) { return defaultValue; }
+    size_t putBool(const char* key, bool value) { return 0; }
+};
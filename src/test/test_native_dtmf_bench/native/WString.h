@@ -0,0 +1,45 @@
+#pragma once
+
+// Host String over std::string, covering the calls the detector sources make
+
+#include <string>
+#include <cstdio>
+#include "Print.h"
+
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(int v) : _s(std::to_string(v)) {}
+    explicit String(unsigned v) : _s(std::to_string(v)) {}
+    explicit String(long v) : _s(std::to_string(v)) {}
+    explicit String(unsigned long v) : _s(std::to_string(v)) {}
+    explicit String(float v, unsigned decimals = 2) : String((double)v, decimals) {}
+    explicit String(double v, unsigned decimals = 2) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        _s = buf;
+    }
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned length() const { return (unsigned)_s.size(); }
+    bool reserve(unsigned size) { _s.reserve(size); return true; }
+    char operator[](unsigned i) const { return i < _s.size() ? _s[i] : 0; }
+
+    String& operator+=(const String& rhs) { _s += rhs._s; return *this; }
+    String& operator+=(const char* rhs) { if (rhs) _s += rhs; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    bool operator==(const char* rhs) const { return rhs && _s == rhs; }
+    bool operator==(const String& rhs) const { return _s == rhs._s; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+
+private:
+    std::string _s;
+};
+
+inline size_t Print::print(const String& s) { return write(s.c_str()); }
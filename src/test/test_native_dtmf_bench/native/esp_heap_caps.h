@@ -0,0 +1,12 @@
+#pragma once
+
+// Host heap_caps: every capability is plain malloc
+
+#include <cstdlib>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+inline void* heap_caps_malloc(size_t size, unsigned caps) { return malloc(size); }
+inline void heap_caps_free(void* ptr) { free(ptr); }
@@ -0,0 +1,10 @@
+#pragma once
+
+// Host esp_system: nothing restarts, so shutdown handlers never run
+
+typedef int esp_err_t;
+typedef void (*shutdown_handler_t)(void);
+
+#define ESP_OK 0
+
+inline esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler) { return ESP_OK; }
@@ -0,0 +1,8 @@
+#pragma once
+
+// Host FreeRTOS: the types and task calls live with the Arduino stand-in.
+// The bench runs on one thread, always "core 0".
+
+#include <Arduino.h>
+
+inline BaseType_t xPortGetCoreID() { return 0; }
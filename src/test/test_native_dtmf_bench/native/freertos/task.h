@@ -0,0 +1,5 @@
+#pragma once
+
+// Host FreeRTOS task API (declared in Arduino.h, defined in host_stubs.cpp)
+
+#include "FreeRTOS.h"
@@ -0,0 +1,74 @@
+// Host implementations behind native/Arduino.h
+
+#include <Arduino.h>
+#include <vector>
+
+HostEspClass ESP;
+
+static unsigned long hostClockUs = 0;
+
+unsigned long millis() { return hostClockUs / 1000; }
+unsigned long micros() { return hostClockUs; }
+void delay(unsigned long ms) { hostClockUs += ms * 1000; }
+void yield() {}
+void advanceHostClockMs(unsigned long ms) { hostClockUs += ms * 1000; }
+
+// Fixed-size FIFO of fixed-size items, like a FreeRTOS queue
+struct HostQueue {
+    std::vector<uint8_t> storage;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue* queue = new HostQueue();
+    queue->storage.resize(length * itemSize);
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->head = 0;
+    queue->count = 0;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait) {
+    if (!queue || queue->count == queue->length) {
+        return pdFALSE;
+    }
+    UBaseType_t slot = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->storage[slot * queue->itemSize], item, queue->itemSize);
+    queue->count++;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait) {
+    if (!queue || queue->count == 0) {
+        return pdFALSE;
+    }
+    memcpy(item, &queue->storage[queue->head * queue->itemSize], queue->itemSize);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    if (queue) {
+        queue->head = 0;
+        queue->count = 0;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack,
+                                   void* param, UBaseType_t prio, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    if (handle) *handle = nullptr;
+    return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t task) {}
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+BaseType_t xTaskNotifyGive(TaskHandle_t task) { return pdPASS; }
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait) { return 0; }
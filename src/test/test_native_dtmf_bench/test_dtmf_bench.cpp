@@ -0,0 +1,521 @@
+// Host-native DTMF benchmark and accuracy suite.
+//
+// Runs the real detector (dtmf_goertzel.cpp + dtmf_goertzel_engine.cpp)
+// against the native/ Arduino stand-ins, hop by hop the way the Goertzel
+// task feeds it on the phone, and reports:
+//   - detection accuracy over a synthetic corpus swept across SNR, twist,
+//     tone duration and inter-digit gap
+//   - talk-off (false digits per minute) on speech-like, music-like, noise
+//     and dialtone signals with no DTMF in them
+//   - detections on recorded captures (tools/analyze_audio CSV format)
+//   - throughput in ns per codec-rate sample
+//
+//   pio test -e native-dtmf-bench -v
+//
+// Only in-spec conditions are asserted; everything else is reported so a
+// threshold change shows up as a table diff rather than a failure.
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "config.h"
+#include "dtmf_goertzel.h"
+#include "phone.h"
+#include "test_helpers/dtmf_goertzel_test_helpers.h"
+#include "test_helpers/dtmf_tone_test_helpers.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Recorded captures are looked up relative to this directory
+#ifndef DTMF_BENCH_CAPTURE_DIR
+#define DTMF_BENCH_CAPTURE_DIR "."
+#endif
+
+namespace {
+
+DtmfGoertzelStream goertzel;
+
+const char* DIAL_KEYS = "1234567890*#";
+const float TONE_AMPLITUDE = 6000.0f;   // Per tone at 0dB twist (~-15dBFS)
+
+// Samples run through the detector and the time spent in it
+uint64_t benchSamples = 0;
+double benchSeconds = 0.0;
+
+bool mapDigitToRowCol(char digit, int& row, int& col) {
+    static const char* KEYPAD = "123A456B789C*0#D";
+    const char* p = strchr(KEYPAD, digit);
+    if (!p || digit == 0) {
+        return false;
+    }
+    row = (int)(p - KEYPAD) / 4;
+    col = (int)(p - KEYPAD) % 4;
+    return true;
+}
+
+// Deterministic white Gaussian noise (Box-Muller over xorshift32), the same
+// on every host standard library
+class NoiseSource {
+public:
+    explicit NoiseSource(uint32_t seed) : _state(seed ? seed : 1) {}
+
+    float uniform() {
+        _state ^= _state << 13;
+        _state ^= _state >> 17;
+        _state ^= _state << 5;
+        return ((_state >> 8) + 0.5f) / 16777216.0f;
+    }
+
+    float gaussian() {
+        if (_hasSpare) {
+            _hasSpare = false;
+            return _spare;
+        }
+        float u1 = uniform();
+        float u2 = uniform();
+        float r = sqrtf(-2.0f * logf(u1));
+        _spare = r * sinf(6.28318530718f * u2);
+        _hasSpare = true;
+        return r * cosf(6.28318530718f * u2);
+    }
+
+private:
+    uint32_t _state;
+    float _spare = 0.0f;
+    bool _hasSpare = false;
+};
+
+int16_t clampSample(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lrintf(v);
+}
+
+int msToSamples(float ms) {
+    return (int)(ms * AUDIO_SAMPLE_RATE / 1000.0f);
+}
+
+// Mix white noise at @p snrDb below the power of a row+col pair at
+// TONE_AMPLITUDE into @p pcm (use a large SNR for "no noise")
+void addNoise(std::vector<float>& pcm, float snrDb, NoiseSource& noise) {
+    const float tonePower = TONE_AMPLITUDE * TONE_AMPLITUDE;   // Two tones, A²/2 each
+    const float sigma = sqrtf(tonePower / powf(10.0f, snrDb / 10.0f));
+    for (float& s : pcm) {
+        s += sigma * noise.gaussian();
+    }
+}
+
+// Append one key: row at TONE_AMPLITUDE, column @p twistDb above it
+void appendDigit(std::vector<float>& pcm, char digit, float durationMs, float twistDb) {
+    int row = -1;
+    int col = -1;
+    TEST_ASSERT_TRUE_MESSAGE(mapDigitToRowCol(digit, row, col), "Digit not mapped to row/col");
+
+    const PhoneConfig& config = getPhoneConfig();
+    const int n = msToSamples(durationMs);
+    const float rowAmp = TONE_AMPLITUDE;
+    const float colAmp = TONE_AMPLITUDE * powf(10.0f, twistDb / 20.0f);
+    const float twoPi = 6.28318530718f;
+    const float rate = (float)AUDIO_SAMPLE_RATE;
+    const size_t start = pcm.size();
+    pcm.resize(start + n);
+    for (int i = 0; i < n; i++) {
+        const float t = (float)i / rate;
+        pcm[start + i] = rowAmp * sinf(twoPi * config.rowFreqs[row] * t) +
+                         colAmp * sinf(twoPi * config.colFreqs[col] * t);
+    }
+}
+
+void appendSilence(std::vector<float>& pcm, float durationMs) {
+    pcm.resize(pcm.size() + msToSamples(durationMs), 0.0f);
+}
+
+std::vector<int16_t> toPcm(const std::vector<float>& pcm) {
+    std::vector<int16_t> out(pcm.size());
+    for (size_t i = 0; i < pcm.size(); i++) {
+        out[i] = clampSample(pcm[i]);
+    }
+    return out;
+}
+
+// Feed @p pcm one hop at a time (as the Goertzel task does) and return the
+// digits the decoder emitted, in order
+std::string runDetector(const std::vector<int16_t>& pcm) {
+    const int hop = goertzel.inputHopSamples();
+    const unsigned long hopMs = (unsigned long)lrintf(1000.0f * hop / AUDIO_SAMPLE_RATE);
+    std::string digits;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t pos = 0; pos + hop <= pcm.size(); pos += hop) {
+        processGoertzelSamplesForTest(goertzel, &pcm[pos], hop);
+        advanceHostClockMs(hopMs);
+        char key;
+        while ((key = getGoertzelKey()) != 0) {
+            digits += key;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    benchSamples += pcm.size() - pcm.size() % hop;
+    benchSeconds += std::chrono::duration<double>(end - start).count();
+    return digits;
+}
+
+// Levenshtein distance: insertions (talk-off splits), deletions (misses)
+// and substitutions all count as one error
+int editDistance(const std::string& a, const std::string& b) {
+    std::vector<int> prev(b.size() + 1);
+    std::vector<int> cur(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) prev[j] = (int)j;
+    for (size_t i = 1; i <= a.size(); i++) {
+        cur[0] = (int)i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            int sub = prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+            cur[j] = std::min(sub, std::min(prev[j], cur[j - 1]) + 1);
+        }
+        std::swap(prev, cur);
+    }
+    return prev[b.size()];
+}
+
+struct CorpusCase {
+    float snrDb;
+    float twistDb;      // Column relative to row
+    float durationMs;
+    float gapMs;
+};
+
+struct CorpusResult {
+    int keys;
+    int errors;
+    std::string detected;
+};
+
+CorpusResult runCorpusCase(const CorpusCase& c, uint32_t seed) {
+    std::vector<float> pcm;
+    appendSilence(pcm, 300.0f);   // Let the noise floor settle
+    for (const char* k = DIAL_KEYS; *k; k++) {
+        appendDigit(pcm, *k, c.durationMs, c.twistDb);
+        appendSilence(pcm, c.gapMs);
+    }
+    appendSilence(pcm, 300.0f);
+    NoiseSource noise(seed);
+    addNoise(pcm, c.snrDb, noise);
+
+    resetGoertzelState();
+    CorpusResult r;
+    r.detected = runDetector(toPcm(pcm));
+    r.keys = (int)strlen(DIAL_KEYS);
+    r.errors = std::min(r.keys, editDistance(DIAL_KEYS, r.detected));
+    return r;
+}
+
+// Within what the phone is tuned for: long presses from a real keypad
+bool isInSpec(const CorpusCase& c) {
+    return c.snrDb >= 20.0f && fabsf(c.twistDb) <= 6.0f &&
+           c.durationMs >= 120.0f && c.gapMs >= 120.0f;
+}
+
+// Read a tools/analyze_audio capture: '#' comment lines, a
+// "# rate=<hz>,..." header, then comma-separated int16 samples. Resampled
+// to AUDIO_SAMPLE_RATE by linear interpolation.
+bool loadCaptureCsv(const std::string& path, std::vector<int16_t>& out) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    int rate = 22050;
+    std::vector<float> raw;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] == '#') {
+            size_t p = line.find("rate=");
+            if (p != std::string::npos) {
+                rate = atoi(line.c_str() + p + 5);
+            }
+            continue;
+        }
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            if (!field.empty()) {
+                raw.push_back((float)atoi(field.c_str()));
+            }
+        }
+    }
+    if (raw.size() < 2 || rate <= 0) {
+        return false;
+    }
+
+    const double step = (double)rate / AUDIO_SAMPLE_RATE;
+    const size_t n = (size_t)((raw.size() - 1) / step);
+    out.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        double x = i * step;
+        size_t k = (size_t)x;
+        float frac = (float)(x - k);
+        out[i] = clampSample(raw[k] + frac * (raw[k + 1] - raw[k]));
+    }
+    return true;
+}
+
+}  // namespace
+
+void setUp() {
+    StreamCopy dummyCopier;
+    initGoertzelDecoder(goertzel, dummyCopier);
+    resetGoertzelState();
+}
+
+void tearDown() {}
+
+// ============================================================================
+// ACCURACY
+// ============================================================================
+
+void test_bench_accuracy_across_snr_twist_duration_gap() {
+    static const float SNRS[] = {40.0f, 20.0f, 10.0f, 0.0f};
+    static const float TWISTS[] = {0.0f, 4.0f, -6.0f, 10.0f};
+    static const float DURATIONS[] = {50.0f, 80.0f, 120.0f, 200.0f};
+    static const float GAPS[] = {60.0f, 120.0f};
+
+    int inSpecKeys = 0, inSpecErrors = 0;
+    int allKeys = 0, allErrors = 0;
+    uint32_t seed = 1;
+
+    printf("\n  DTMF accuracy (%d keys per row, '*' = in spec)\n", (int)strlen(DIAL_KEYS));
+    printf("  %6s %6s %6s %6s %9s  %s\n", "snr", "twist", "dur", "gap", "accuracy", "detected");
+    for (float snr : SNRS) {
+        for (float twist : TWISTS) {
+            for (float duration : DURATIONS) {
+                for (float gap : GAPS) {
+                    CorpusCase c = {snr, twist, duration, gap};
+                    CorpusResult r = runCorpusCase(c, seed++);
+                    bool inSpec = isInSpec(c);
+                    allKeys += r.keys;
+                    allErrors += r.errors;
+                    if (inSpec) {
+                        inSpecKeys += r.keys;
+                        inSpecErrors += r.errors;
+                    }
+                    printf("  %5.0fdB %5.0fdB %4.0fms %4.0fms %8.1f%%%s \"%s\"\n",
+                           snr, twist, duration, gap,
+                           100.0f * (r.keys - r.errors) / r.keys, inSpec ? "*" : " ",
+                           r.detected.c_str());
+                }
+            }
+        }
+    }
+
+    printf("  Overall: %.1f%% of %d keys; in spec: %.1f%% of %d keys\n",
+           100.0f * (allKeys - allErrors) / allKeys, allKeys,
+           100.0f * (inSpecKeys - inSpecErrors) / inSpecKeys, inSpecKeys);
+    TEST_ASSERT_EQUAL_MESSAGE(0, inSpecErrors, "In-spec keys missed or split");
+}
+
+// ============================================================================
+// TALK-OFF
+// ============================================================================
+
+// Voiced speech stand-in: glottal harmonic series with a drifting pitch and
+// three drifting formant peaks, syllable-rate amplitude modulation
+std::vector<int16_t> makeSpeechLike(float seconds, NoiseSource& rng) {
+    const int n = msToSamples(seconds * 1000.0f);
+    const float rate = (float)AUDIO_SAMPLE_RATE;
+    const float twoPi = 6.28318530718f;
+    std::vector<float> pcm(n, 0.0f);
+
+    float phase[40] = {};
+    float f0 = 120.0f, f0Target = 150.0f;
+    float formants[3] = {500.0f, 1500.0f, 2500.0f};
+    float targets[3] = {700.0f, 1200.0f, 2600.0f};
+    for (int i = 0; i < n; i++) {
+        if (i % msToSamples(150.0f) == 0) {
+            f0Target = 90.0f + 160.0f * rng.uniform();
+            targets[0] = 300.0f + 600.0f * rng.uniform();
+            targets[1] = 900.0f + 1300.0f * rng.uniform();
+            targets[2] = 2200.0f + 800.0f * rng.uniform();
+        }
+        f0 += (f0Target - f0) * 0.0005f;
+        for (int k = 0; k < 3; k++) {
+            formants[k] += (targets[k] - formants[k]) * 0.0005f;
+        }
+
+        const float envelope = 0.5f + 0.5f * sinf(twoPi * 4.0f * i / rate);
+        float s = 0.0f;
+        for (int h = 1; h <= 40 && h * f0 < 4000.0f; h++) {
+            const float f = h * f0;
+            float gain = 0.0f;
+            for (int k = 0; k < 3; k++) {
+                const float d = (f - formants[k]) / (80.0f + 0.1f * formants[k]);
+                gain += expf(-0.5f * d * d) / (k + 1);
+            }
+            phase[h - 1] += twoPi * f / rate;
+            if (phase[h - 1] > twoPi) phase[h - 1] -= twoPi;
+            s += gain * sinf(phase[h - 1]);
+        }
+        pcm[i] = 5000.0f * envelope * s;
+    }
+    return toPcm(pcm);
+}
+
+// Music stand-in: random three-note equal-tempered chords with harmonics,
+// changing every quarter second
+std::vector<int16_t> makeMusicLike(float seconds, NoiseSource& rng) {
+    const int n = msToSamples(seconds * 1000.0f);
+    const int noteLen = msToSamples(250.0f);
+    const float rate = (float)AUDIO_SAMPLE_RATE;
+    const float twoPi = 6.28318530718f;
+    std::vector<float> pcm(n, 0.0f);
+
+    float notes[3] = {};
+    for (int i = 0; i < n; i++) {
+        if (i % noteLen == 0) {
+            for (float& f : notes) {
+                int semitone = (int)(rng.uniform() * 36.0f) - 12;   // A3..A6
+                f = 440.0f * powf(2.0f, semitone / 12.0f);
+            }
+        }
+        const float t = (float)(i % noteLen) / rate;
+        const float decay = expf(-3.0f * t);
+        float s = 0.0f;
+        for (float f : notes) {
+            s += sinf(twoPi * f * t) + 0.5f * sinf(twoPi * 2.0f * f * t) +
+                 0.25f * sinf(twoPi * 3.0f * f * t);
+        }
+        pcm[i] = 4000.0f * decay * s;
+    }
+    return toPcm(pcm);
+}
+
+std::vector<int16_t> makeNoise(float seconds, float rms, NoiseSource& rng) {
+    std::vector<float> pcm(msToSamples(seconds * 1000.0f), 0.0f);
+    for (float& s : pcm) {
+        s = rms * rng.gaussian();
+    }
+    return toPcm(pcm);
+}
+
+// North American dialtone, which the phone plays into its own mic path
+std::vector<int16_t> makeDialtone(float seconds) {
+    std::vector<int16_t> pcm(msToSamples(seconds * 1000.0f));
+    generateDualToneBlockForTest(pcm.data(), pcm.size(), (float)AUDIO_SAMPLE_RATE,
+                                 350.0f, 440.0f, 16000.0f);
+    return pcm;
+}
+
+void test_bench_talk_off_rate() {
+    const float seconds = 60.0f;
+    NoiseSource rng(0x5eed);
+
+    struct {
+        const char* name;
+        std::vector<int16_t> pcm;
+        bool mustBeClean;
+    } signals[] = {
+        {"speech-like", makeSpeechLike(seconds, rng), false},
+        {"music-like", makeMusicLike(seconds, rng), false},
+        {"white noise", makeNoise(seconds, 3000.0f, rng), true},
+        {"dialtone", makeDialtone(seconds), true},
+    };
+
+    printf("\n  DTMF talk-off (%.0fs each)\n", seconds);
+    int mustBeCleanHits = 0;
+    for (auto& s : signals) {
+        resetGoertzelState();
+        std::string digits = runDetector(s.pcm);
+        printf("  %-12s %5.1f false digits/min  \"%s\"\n",
+               s.name, digits.size() * 60.0f / seconds, digits.c_str());
+        if (s.mustBeClean) {
+            mustBeCleanHits += (int)digits.size();
+        }
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(0, mustBeCleanHits, "Digits detected in noise or dialtone");
+}
+
+// ============================================================================
+// RECORDED CAPTURES
+// ============================================================================
+
+void test_bench_recorded_captures() {
+    // Captures from the "capture" debug command (see tools/analyze_audio).
+    // Expected digits are asserted only where they are known. bowie-phone.csv
+    // is '#' then one long '1' (the analyzer's energy gate splits the '1'
+    // at a dip and reports "#11").
+    struct {
+        const char* path;
+        const char* expected;
+    } captures[] = {
+        {"data/bowie-phone.csv", "#1"},
+        {"logs/dial_clean.csv", nullptr},
+    };
+
+    int found = 0;
+    printf("\n  DTMF recorded captures\n");
+    for (auto& c : captures) {
+        std::vector<int16_t> pcm;
+        std::string path = std::string(DTMF_BENCH_CAPTURE_DIR) + "/" + c.path;
+        if (!loadCaptureCsv(path, pcm)) {
+            printf("  %-24s (not found)\n", c.path);
+            continue;
+        }
+        found++;
+        resetGoertzelState();
+        std::string digits = runDetector(pcm);
+        printf("  %-24s %6.2fs  \"%s\"\n", c.path, (float)pcm.size() / AUDIO_SAMPLE_RATE, digits.c_str());
+        if (c.expected) {
+            TEST_ASSERT_EQUAL_STRING(c.expected, digits.c_str());
+        }
+    }
+    if (found == 0) {
+        TEST_IGNORE_MESSAGE("No captures found (run from the project root)");
+    }
+}
+
+// ============================================================================
+// THROUGHPUT
+// ============================================================================
+
+void test_bench_throughput() {
+    // Ten seconds of keys in noise, timed on its own
+    std::vector<float> pcm;
+    while (pcm.size() < (size_t)msToSamples(10000.0f)) {
+        for (const char* k = DIAL_KEYS; *k; k++) {
+            appendDigit(pcm, *k, 150.0f, 2.0f);
+            appendSilence(pcm, 150.0f);
+        }
+    }
+    NoiseSource noise(42);
+    addNoise(pcm, 20.0f, noise);
+    std::vector<int16_t> samples = toPcm(pcm);
+
+    benchSamples = 0;
+    benchSeconds = 0.0;
+    resetGoertzelState();
+    runDetector(samples);
+
+    const double nsPerSample = benchSeconds * 1e9 / benchSamples;
+    const double realtime = (double)benchSamples / AUDIO_SAMPLE_RATE / benchSeconds;
+    printf("\n  DTMF throughput: %.1f ns/sample (%.0fx realtime at %d Hz, %d-sample hops)\n",
+           nsPerSample, realtime, AUDIO_SAMPLE_RATE, goertzel.inputHopSamples());
+
+    // Loose bound: host timing is noisy, this only catches gross regressions
+    TEST_ASSERT_TRUE_MESSAGE(realtime > 10.0, "Detector slower than 10x realtime on the host");
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_accuracy_across_snr_twist_duration_gap);
+    RUN_TEST(test_bench_talk_off_rate);
+    RUN_TEST(test_bench_recorded_captures);
+    RUN_TEST(test_bench_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,582 @@
+/**
+ * @file tunables.cpp
+ * @brief Detector and pipeline parameters changed at runtime, kept in NVS
+ *
+ * @date 2026
+ */
+
+#include "tunables.h"
+#include "logging.h"
+#include "phone.h"
+#include "dtmf_goertzel.h"
+#include "audio_copy_meter.h"
+#include "web_queue.h"
+#include "power_manager.h"
+#include "web_server_task.h"
+#include <Preferences.h>
+#include <WebServer.h>
+
+static_assert(sizeof(int) == sizeof(int32_t), "INT tunables are stored as int32");
+static_assert(sizeof(unsigned long) == sizeof(uint32_t), "U32 tunables are stored as uint32");
+
+TunableRegistry tunables;
+
+static Preferences tunePrefs;
+
+extern DtmfGoertzelStream goertzel;
+extern StreamCopy goertzelCopier;
+
+// Geometry the detector last started with, to fall back to
+static float runningWindowMs;
+static float runningHopMs;
+static int runningCopierBufferSize;
+static bool restartFailed = false;
+
+static void rememberGeometry() {
+    const PhoneConfig& c = getTunablePhoneConfig();
+    runningWindowMs = c.goertzelWindowMs;
+    runningHopMs = c.goertzelHopMs;
+    runningCopierBufferSize = c.goertzelCopierBufferSize;
+}
+
+// Window, hop and copier buffer size the detector's buffers: rebuild it,
+// back on the previous geometry if the engine refuses the new one
+static void restartGoertzel() {
+    powerManager.wake();
+    stopGoertzelTask();
+    restartFailed = !initGoertzelDecoder(goertzel, goertzelCopier, true);
+    if (restartFailed) {
+        PhoneConfig& c = getTunablePhoneConfig();
+        Logger.printf("❌ [TUNE] Detector refused window=%gms hop=%gms, back to %gms/%gms\n",
+                      c.goertzelWindowMs, c.goertzelHopMs, runningWindowMs, runningHopMs);
+        c.goertzelWindowMs = runningWindowMs;
+        c.goertzelHopMs = runningHopMs;
+        c.goertzelCopierBufferSize = runningCopierBufferSize;
+        initGoertzelDecoder(goertzel, goertzelCopier, true);
+    }
+    rememberGeometry();
+}
+
+// Window and hop only fail as a pair: check @p t taking @p v against the other
+static bool geometryAllows(const Tunable& t, float v) {
+    const PhoneConfig& c = getTunablePhoneConfig();
+    float windowMs = c.goertzelWindowMs;
+    float hopMs = c.goertzelHopMs;
+    if (t.value == &c.goertzelWindowMs) {
+        windowMs = v;
+    } else if (t.value == &c.goertzelHopMs) {
+        hopMs = v;
+    } else {
+        return true;
+    }
+    return goertzelGeometryValid(windowMs, hopMs);
+}
+
+void TunableRegistry::begin()
+{
+    if (_count > 0) return;
+
+    PhoneConfig& c = getTunablePhoneConfig();
+    // Goertzel geometry: re-init
+    add("g.window",   TuneType::FLOAT, &c.goertzelWindowMs, 5, 100, restartGoertzel, true,
+        "Goertzel window (ms)");
+    add("g.hop",      TuneType::FLOAT, &c.goertzelHopMs, 0, 100, restartGoertzel, true,
+        "Time between evaluations (ms, 0 = window)");
+    add("g.copybuf",  TuneType::INT,   &c.goertzelCopierBufferSize, 64, 8192, restartGoertzel, true,
+        "Goertzel copier buffer (bytes)");
+    // Thresholds: reload (a stored keypad calibration still wins)
+    add("g.presSnr",  TuneType::FLOAT, &c.presenceSnrDb, 0, 40, reloadGoertzelThresholds, false,
+        "Per-bin presence over the noise floor (dB)");
+    add("g.detSnr",   TuneType::FLOAT, &c.detectionSnrDb, 0, 40, reloadGoertzelThresholds, false,
+        "Row/column detection over the noise floor (dB)");
+    add("g.minPres",  TuneType::FLOAT, &c.fundamentalMagnitudeThreshold, 0, 100000, reloadGoertzelThresholds, false,
+        "Absolute presence minimum");
+    add("g.minDet",   TuneType::FLOAT, &c.minDetectionMagnitude, 0, 100000, reloadGoertzelThresholds, false,
+        "Absolute detection minimum");
+    add("g.twist",    TuneType::FLOAT, &c.maxTwistRatio, 1, 50, reloadGoertzelThresholds, false,
+        "Max row/column magnitude ratio");
+    // Read at each evaluation
+    add("g.consec",   TuneType::INT,   &c.requiredConsecutive, 1, 20, nullptr, false,
+        "Consecutive hits to confirm a digit");
+    add("g.release",  TuneType::INT,   &c.releaseBlockCount, 1, 50, nullptr, false,
+        "Quiet evaluations before a key is released");
+    add("g.harmonic", TuneType::FLOAT, &c.maxHarmonicRatio, 0, 10, nullptr, false,
+        "Max 2nd harmonic / fundamental (0 = off)");
+    add("g.energy",   TuneType::FLOAT, &c.minToneEnergyRatio, 0, 1, nullptr, false,
+        "Min tone share of the window energy (0 = off)");
+    // Pipeline caps below the compiled buffers
+    add("a.copymax",  TuneType::INT,   &audioCopyMaxBytes, AUDIO_COPY_MIN_BYTES, AUDIO_COPY_BUFFER_SIZE, nullptr, false,
+        "Adaptive copy() chunk cap (bytes)");
+    add("n.chunk",    TuneType::INT,   &webQueueChunkBytes, 512, WEB_QUEUE_CHUNK_SIZE, nullptr, false,
+        "WebQueue read per download per pass (bytes)");
+    add("n.tick",     TuneType::INT,   &webQueueTickBytes, 512, 4 * WEB_QUEUE_CHUNK_SIZE, nullptr, false,
+        "WebQueue read budget per tick (bytes)");
+
+    // Stored values land before the subsystems start, so nothing to apply
+    int loaded = 0;
+    if (tunePrefs.begin(TUNE_PREFS_NAMESPACE, true)) {
+        for (int i = 0; i < _count; i++) {
+            Tunable& t = _table[i];
+            if (!tunePrefs.isKey(t.key)) continue;
+            float v;
+            switch (t.type) {
+            case TuneType::FLOAT: v = tunePrefs.getFloat(t.key, t.def); break;
+            case TuneType::BOOL:  v = tunePrefs.getBool(t.key, t.def != 0) ? 1.0f : 0.0f; break;
+            default:              v = (float)tunePrefs.getInt(t.key, (int32_t)t.def); break;
+            }
+            if (v < t.min || v > t.max) {
+                Logger.printf("⚠️ [TUNE] Stored %s out of range, ignored\n", t.key);
+                continue;
+            }
+            store(t, v);
+            t.stored = true;
+            loaded++;
+        }
+        tunePrefs.end();
+    }
+    // Each value passed its own range; a window over too many hops doesn't
+    if (!goertzelGeometryValid(c.goertzelWindowMs, c.goertzelHopMs)) {
+        Logger.printf("⚠️ [TUNE] Stored g.window/g.hop (%g/%g ms) rejected, using defaults\n",
+                      c.goertzelWindowMs, c.goertzelHopMs);
+        for (int i = 0; i < _count; i++) {
+            Tunable& t = _table[i];
+            if (t.value != &c.goertzelWindowMs && t.value != &c.goertzelHopMs) continue;
+            if (t.stored) loaded--;
+            store(t, t.def);
+            t.stored = false;
+        }
+    }
+    rememberGeometry();
+    if (loaded > 0) {
+        Logger.printf("🎛️ [TUNE] %d stored tunable(s) in effect\n", loaded);
+    }
+}
+
+void TunableRegistry::add(const char* key, TuneType type, void* value, float min, float max,
+                          void (*apply)(), bool restart, const char* help)
+{
+    if (_count >= MAX_TUNABLES) {
+        Logger.printf("❌ [TUNE] Can't add %s\n", key);
+        return;
+    }
+    Tunable& t = _table[_count++];
+    t = Tunable{key, type, value, min, max, apply, restart, help, 0, false};
+    t.def = get(t);
+}
+
+Tunable* TunableRegistry::lookup(const char* key)
+{
+    if (!key) return nullptr;
+    for (int i = 0; i < _count; i++) {
+        if (strcmp(_table[i].key, key) == 0) return &_table[i];
+    }
+    return nullptr;
+}
+
+const Tunable* TunableRegistry::find(const char* key) const
+{
+    return const_cast<TunableRegistry*>(this)->lookup(key);
+}
+
+float TunableRegistry::get(const Tunable& t) const
+{
+    switch (t.type) {
+    case TuneType::INT:   return (float)*static_cast<int*>(t.value);
+    case TuneType::U32:   return (float)*static_cast<unsigned long*>(t.value);
+    case TuneType::FLOAT: return *static_cast<float*>(t.value);
+    case TuneType::BOOL:  return *static_cast<bool*>(t.value) ? 1.0f : 0.0f;
+    }
+    return 0;
+}
+
+void TunableRegistry::store(Tunable& t, float v)
+{
+    switch (t.type) {
+    case TuneType::INT:   *static_cast<int*>(t.value) = (int)lroundf(v); break;
+    case TuneType::U32:   *static_cast<unsigned long*>(t.value) = (unsigned long)lroundf(v); break;
+    case TuneType::FLOAT: *static_cast<float*>(t.value) = v; break;
+    case TuneType::BOOL:  *static_cast<bool*>(t.value) = v != 0; break;
+    }
+}
+
+bool TunableRegistry::parse(const Tunable& t, const char* text, float& out) const
+{
+    if (!text || !*text) return false;
+    if (t.type == TuneType::BOOL) {
+        if (!strcasecmp(text, "1") || !strcasecmp(text, "on") || !strcasecmp(text, "true")) {
+            out = 1;
+            return true;
+        }
+        if (!strcasecmp(text, "0") || !strcasecmp(text, "off") || !strcasecmp(text, "false")) {
+            out = 0;
+            return true;
+        }
+        return false;
+    }
+    char* end = nullptr;
+    float v = strtof(text, &end);
+    if (end == text || *end != '\0') return false;
+    if (t.type != TuneType::FLOAT && v != floorf(v)) return false;
+    if (v < t.min || v > t.max) return false;
+    out = v;
+    return true;
+}
+
+void TunableRegistry::schedule(const Tunable& t)
+{
+    if (!t.apply) return;
+    if (t.restart) _pendingRestart = true;
+    for (auto& fn : _pending) {
+        if (fn == t.apply) return;
+        if (!fn) {
+            fn = t.apply;
+            return;
+        }
+    }
+    t.apply();   // Table full: can't happen with the distinct apply functions above
+}
+
+bool TunableRegistry::set(const char* key, const char* text, bool save)
+{
+    Tunable* t = lookup(key);
+    if (!t) {
+        Logger.printf("❌ [TUNE] Unknown tunable: %s\n", key ? key : "");
+        return false;
+    }
+    if (_ab.tunable == t) {
+        Logger.printf("❌ [TUNE] %s is under A/B, stop it first\n", t->key);
+        return false;
+    }
+    float v;
+    if (!parse(*t, text, v)) {
+        Logger.printf("❌ [TUNE] Bad value for %s: %s (range %g..%g)\n",
+                      t->key, text ? text : "", t->min, t->max);
+        return false;
+    }
+
+    if (!geometryAllows(*t, v)) {
+        Logger.printf("❌ [TUNE] %s = %s needs a hop of at least one sample and at most %d hops per window\n",
+                      t->key, text, DtmfGoertzelStream::MAX_CHUNKS);
+        return false;
+    }
+
+    store(*t, v);
+    schedule(*t);
+    // A geometry value is only saved once the detector has restarted on it
+    const char* saved = "";
+    if (save && t->restart) {
+        _saveAfterRestart = t;
+        _saveAfterRestartValue = v;
+        saved = " (saved once running)";
+    } else if (save) {
+        saved = saveValue(*t, v) ? " (saved)" : "";
+    } else if (_saveAfterRestart == t) {
+        _saveAfterRestart = nullptr;
+    }
+
+    char buf[24];
+    formatValue(*t, v, buf, sizeof(buf));
+    Logger.printf("🎛️ [TUNE] %s = %s%s%s\n", t->key, buf, saved,
+                  t->restart ? (_busy && _busy() ? " - detector restarts when idle" : " - detector restarting") : "");
+    return true;
+}
+
+bool TunableRegistry::saveValue(Tunable& t, float v)
+{
+    if (!tunePrefs.begin(TUNE_PREFS_NAMESPACE, false)) {
+        Logger.println("⚠️ [TUNE] NVS unavailable, not saved");
+        return false;
+    }
+    switch (t.type) {
+    case TuneType::FLOAT: tunePrefs.putFloat(t.key, v); break;
+    case TuneType::BOOL:  tunePrefs.putBool(t.key, v != 0); break;
+    default:              tunePrefs.putInt(t.key, (int32_t)lroundf(v)); break;
+    }
+    tunePrefs.end();
+    t.stored = true;
+    return true;
+}
+
+bool TunableRegistry::reset(const char* key)
+{
+    Tunable* only = nullptr;
+    if (key) {
+        only = lookup(key);
+        if (!only) {
+            Logger.printf("❌ [TUNE] Unknown tunable: %s\n", key);
+            return false;
+        }
+    }
+    if (_ab.tunable && (!only || _ab.tunable == only)) {
+        stopAb();
+    }
+    if (_saveAfterRestart && (!only || _saveAfterRestart == only)) {
+        _saveAfterRestart = nullptr;
+    }
+
+    bool nvs = tunePrefs.begin(TUNE_PREFS_NAMESPACE, false);
+    for (int i = 0; i < _count; i++) {
+        Tunable& t = _table[i];
+        if (only && &t != only) continue;
+        if (get(t) != t.def) {
+            store(t, t.def);
+            schedule(t);
+        }
+        if (nvs && t.stored) tunePrefs.remove(t.key);
+        t.stored = false;
+    }
+    if (nvs) tunePrefs.end();
+
+    Logger.printf("🎛️ [TUNE] %s back to compiled default\n", only ? only->key : "All tunables");
+    return true;
+}
+
+void TunableRegistry::tick()
+{
+    bool busy = _busy && _busy();
+    unsigned long now = millis();
+
+    if (_ab.tunable && _ab.armStartMs != 0 && now - _ab.armStartMs >= _ab.periodMs && !busy) {
+        abSwitch(now);
+    }
+
+    if (_pending[0] && !(_pendingRestart && busy)) {
+        for (auto& fn : _pending) {
+            if (!fn) break;
+            fn();
+            fn = nullptr;
+        }
+        _pendingRestart = false;
+
+        if (_saveAfterRestart) {
+            if (restartFailed) {
+                Logger.printf("⚠️ [TUNE] %s not saved: the detector didn't start on it\n",
+                              _saveAfterRestart->key);
+            } else if (saveValue(*_saveAfterRestart, _saveAfterRestartValue)) {
+                Logger.printf("🎛️ [TUNE] %s saved\n", _saveAfterRestart->key);
+            }
+            _saveAfterRestart = nullptr;
+        }
+    }
+
+    // An arm's counters start once its value is in effect
+    if (_ab.tunable && _ab.armStartMs == 0 && !_pending[0]) {
+        _ab.armStartMs = now ? now : 1;
+        _ab.armStart = abSnapshot();
+    }
+}
+
+TunableRegistry::AbCounters TunableRegistry::abSnapshot()
+{
+    GoertzelDetectorStats s = getGoertzelDetectorStats();
+    AbCounters c = {};
+    c.evaluations = s.evaluations;
+    for (int i = 0; i < 16; i++) c.detections += s.detections[i];
+    c.rejects = s.rejectPartial + s.rejectFloor + s.rejectTwist + s.rejectHarmonic + s.rejectEnergy;
+    c.gated = s.gatedWindows;
+    c.overruns = getGoertzelTaskStats().overruns;
+    return c;
+}
+
+bool TunableRegistry::startAb(const char* key, const char* a, const char* b,
+                              uint32_t periodMs, int rounds)
+{
+    Tunable* t = lookup(key);
+    if (!t) {
+        Logger.printf("❌ [TUNE] Unknown tunable: %s\n", key ? key : "");
+        return false;
+    }
+    float va, vb;
+    if (!parse(*t, a, va) || !parse(*t, b, vb)) {
+        Logger.printf("❌ [TUNE] Bad A/B values for %s (range %g..%g)\n", t->key, t->min, t->max);
+        return false;
+    }
+    if (!geometryAllows(*t, va) || !geometryAllows(*t, vb)) {
+        Logger.printf("❌ [TUNE] A/B values for %s need a hop of at least one sample and at most %d hops per window\n",
+                      t->key, DtmfGoertzelStream::MAX_CHUNKS);
+        return false;
+    }
+    if (periodMs < 1000 || rounds < 1) {
+        Logger.println("❌ [TUNE] A/B needs a period of at least 1 s and one round");
+        return false;
+    }
+    if (_ab.tunable) stopAb();
+
+    _ab = AbState{};
+    _ab.tunable = t;
+    _ab.original = get(*t);
+    _ab.arms[0].value = va;
+    _ab.arms[1].value = vb;
+    _ab.periodsLeft = rounds * 2;
+    _ab.periodMs = periodMs;
+    store(*t, va);
+    schedule(*t);
+
+    char sa[24], sb[24];
+    formatValue(*t, va, sa, sizeof(sa));
+    formatValue(*t, vb, sb, sizeof(sb));
+    Logger.printf("🎛️ [TUNE] A/B %s: %s vs %s, %lu s each, %d round(s)\n",
+                  t->key, sa, sb, (unsigned long)(periodMs / 1000), rounds);
+    return true;
+}
+
+void TunableRegistry::abSwitch(unsigned long now)
+{
+    AbArm& arm = _ab.arms[_ab.current];
+    AbCounters end = abSnapshot();
+    // A restart or stats reset zeroes the counters: count from zero then
+    auto delta = [](uint32_t e, uint32_t s) { return e >= s ? e - s : e; };
+    arm.ms += now - _ab.armStartMs;
+    arm.totals.evaluations += delta(end.evaluations, _ab.armStart.evaluations);
+    arm.totals.detections += delta(end.detections, _ab.armStart.detections);
+    arm.totals.rejects += delta(end.rejects, _ab.armStart.rejects);
+    arm.totals.gated += delta(end.gated, _ab.armStart.gated);
+    arm.totals.overruns += delta(end.overruns, _ab.armStart.overruns);
+
+    if (--_ab.periodsLeft <= 0) {
+        Logger.printf("🎛️ [TUNE] A/B %s finished\n", _ab.tunable->key);
+        stopAb();
+        return;
+    }
+    _ab.current ^= 1;
+    store(*_ab.tunable, _ab.arms[_ab.current].value);
+    schedule(*_ab.tunable);
+    _ab.armStartMs = 0;
+}
+
+void TunableRegistry::stopAb()
+{
+    if (!_ab.tunable) return;
+    printAb();
+    store(*_ab.tunable, _ab.original);
+    schedule(*_ab.tunable);
+    _ab = AbState{};
+}
+
+void TunableRegistry::formatValue(const Tunable& t, float v, char* buf, size_t len)
+{
+    switch (t.type) {
+    case TuneType::INT:   snprintf(buf, len, "%d", (int)lroundf(v)); break;
+    case TuneType::U32:   snprintf(buf, len, "%lu", (unsigned long)lroundf(v)); break;
+    case TuneType::FLOAT: snprintf(buf, len, "%g", v); break;
+    case TuneType::BOOL:  snprintf(buf, len, "%s", v != 0 ? "on" : "off"); break;
+    }
+}
+
+void TunableRegistry::printStatus()
+{
+    Logger.printf("🎛️ Tunables (%s%s)\n", _pending[0] ? "apply pending" : "all applied",
+                  _pendingRestart ? ", detector restart waits for idle" : "");
+    Logger.println("   key         value     default   range              help");
+    for (int i = 0; i < _count; i++) {
+        const Tunable& t = _table[i];
+        char val[24], def[24], range[32];
+        formatValue(t, get(t), val, sizeof(val));
+        formatValue(t, t.def, def, sizeof(def));
+        snprintf(range, sizeof(range), "%g..%g", t.min, t.max);
+        Logger.printf("   %-11s %-9s %-9s %-18s %s%s%s\n", t.key, val, def, range, t.help,
+                      t.stored ? " [nvs]" : "", _ab.tunable == &t ? " [a/b]" : "");
+    }
+    if (_ab.tunable) printAb();
+}
+
+void TunableRegistry::printAb()
+{
+    if (!_ab.tunable) {
+        Logger.println("🎛️ No A/B in progress");
+        return;
+    }
+    const Tunable& t = *_ab.tunable;
+    Logger.printf("🎛️ A/B %s: on %c, %d period(s) left\n", t.key, 'A' + _ab.current, _ab.periodsLeft);
+    for (int i = 0; i < 2; i++) {
+        const AbArm& arm = _ab.arms[i];
+        const AbCounters& c = arm.totals;
+        char val[24];
+        formatValue(t, arm.value, val, sizeof(val));
+        float hours = arm.ms / 3600000.0f;
+        float evals = c.evaluations + c.gated;
+        Logger.printf("   %c %-9s %6.1f min  %lu digits (%.1f/h)  %lu rejects (%.2f/1k evals)  gated %.0f%%  %lu overruns\n",
+                      'A' + i, val, arm.ms / 60000.0f,
+                      (unsigned long)c.detections, hours > 0 ? c.detections / hours : 0.0f,
+                      (unsigned long)c.rejects, c.evaluations ? c.rejects * 1000.0f / c.evaluations : 0.0f,
+                      evals > 0 ? c.gated * 100.0f / evals : 0.0f,
+                      (unsigned long)c.overruns);
+    }
+}
+
+String TunableRegistry::json()
+{
+    String out = "{\"tunables\":[";
+    for (int i = 0; i < _count; i++) {
+        const Tunable& t = _table[i];
+        char val[24], def[24];
+        formatValue(t, get(t), val, sizeof(val));
+        formatValue(t, t.def, def, sizeof(def));
+        bool quote = t.type == TuneType::BOOL;
+        if (i > 0) out += ",";
+        out += "{\"key\":\"" + String(t.key) + "\",";
+        out += "\"value\":" + String(quote ? "\"" : "") + val + (quote ? "\"" : "") + ",";
+        out += "\"default\":" + String(quote ? "\"" : "") + def + (quote ? "\"" : "") + ",";
+        out += "\"min\":" + String(t.min, 3) + ",\"max\":" + String(t.max, 3) + ",";
+        out += "\"stored\":" + String(t.stored ? "true" : "false") + ",";
+        out += "\"restart\":" + String(t.restart ? "true" : "false") + ",";
+        out += "\"help\":\"" + String(t.help) + "\"}";
+    }
+    out += "],\"pending\":" + String(_pending[0] ? "true" : "false") + ",\"ab\":";
+    if (!_ab.tunable) {
+        out += "null}";
+        return out;
+    }
+    out += "{\"key\":\"" + String(_ab.tunable->key) + "\",";
+    out += "\"current\":\"" + String((char)('A' + _ab.current)) + "\",";
+    out += "\"periodsLeft\":" + String(_ab.periodsLeft) + ",\"arms\":[";
+    for (int i = 0; i < 2; i++) {
+        const AbArm& arm = _ab.arms[i];
+        if (i > 0) out += ",";
+        out += "{\"value\":" + String(arm.value, 3) + ",\"ms\":" + String(arm.ms);
+        out += ",\"evaluations\":" + String(arm.totals.evaluations);
+        out += ",\"detections\":" + String(arm.totals.detections);
+        out += ",\"rejects\":" + String(arm.totals.rejects);
+        out += ",\"gated\":" + String(arm.totals.gated);
+        out += ",\"overruns\":" + String(arm.totals.overruns) + "}";
+    }
+    out += "]}}";
+    return out;
+}
+
+// ============================================================================
+// WEB ROUTES
+// ============================================================================
+
+static WebServer* tuneWebServer = nullptr;
+
+static void handleTuneGet() {
+    tuneWebServer->send(200, "application/json", tunables.json());
+}
+
+// POST key=<k>&value=<v>[&save=1] | reset=<k|all>
+static void handleTunePost() {
+    bool ok;
+    if (tuneWebServer->hasArg("reset")) {
+        String key = tuneWebServer->arg("reset");
+        ok = tunables.reset(key == "all" ? nullptr : key.c_str());
+    } else {
+        ok = tunables.set(tuneWebServer->arg("key").c_str(), tuneWebServer->arg("value").c_str(),
+                          tuneWebServer->arg("save") == "1");
+    }
+    if (!ok) {
+        tuneWebServer->send(400, "application/json", "{\"error\":\"unknown key or bad value\"}");
+        return;
+    }
+    tuneWebServer->send(200, "application/json", tunables.json());
+}
+
+void initTunableRoutes(void* server) {
+    tuneWebServer = static_cast<WebServer*>(server);
+    if (!tuneWebServer) return;
+
+    tuneWebServer->on("/api/tune", HTTP_GET, webServerTask.onLoop(handleTuneGet));
+    tuneWebServer->on("/api/tune", HTTP_POST, webServerTask.onLoop(handleTunePost));
+
+    Serial.println("🎛️ Tunable routes registered (/api/tune)");
+}
@@ -0,0 +1,100 @@
+#include "web_page.h"
+
+#define WEB_PAGE_FIELD_MAX 32   // Longest %NAME%
+
+// ============================================================================
+// CHUNKED RESPONSE
+// ============================================================================
+
+ChunkedResponse::ChunkedResponse(WebServer& web, int code, const char* contentType)
+    : web(web)
+{
+    web.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    web.send(code, contentType, "");
+}
+
+ChunkedResponse::~ChunkedResponse()
+{
+    flush();
+    web.sendContent("");  // Ends the chunked response
+}
+
+size_t ChunkedResponse::write(const uint8_t* data, size_t len)
+{
+    for (size_t done = 0; done < len; ) {
+        size_t n = min(len - done, sizeof(chunk) - used);
+        memcpy(chunk + used, data + done, n);
+        used += n;
+        done += n;
+        if (used == sizeof(chunk)) flush();
+    }
+    return len;
+}
+
+void ChunkedResponse::flush()
+{
+    if (used > 0) web.sendContent(chunk, used);
+    used = 0;
+}
+
+// ============================================================================
+// TEMPLATES
+// ============================================================================
+
+static bool isFieldChar(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+void printPage(Print& out, const char* tmpl, PageFieldFn fill, void* ctx)
+{
+    const char* run = tmpl;  // Literal text not yet written
+    const char* p = tmpl;
+    while (*p) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        const char* name = p + 1;
+        const char* q = name;
+        while (isFieldChar(*q) && q - name < WEB_PAGE_FIELD_MAX) q++;
+        if (*q != '%' || q == name) {
+            p++;  // Not a field: the '%' stays in the literal run
+            continue;
+        }
+
+        out.write((const uint8_t*)run, p - run);
+        char field[WEB_PAGE_FIELD_MAX + 1];
+        memcpy(field, name, q - name);
+        field[q - name] = '\0';
+        if (fill) fill(field, out, ctx);
+        p = run = q + 1;
+    }
+    out.write((const uint8_t*)run, p - run);
+}
+
+void sendPage(WebServer& web, const char* tmpl, PageFieldFn fill, void* ctx)
+{
+    ChunkedResponse out(web, 200, "text/html");
+    printPage(out, tmpl, fill, ctx);
+}
+
+void printHtmlEscaped(Print& out, const char* text)
+{
+    const char* run = text;
+    const char* p = text;
+    for (; *p; p++) {
+        const char* esc = nullptr;
+        switch (*p) {
+            case '<': esc = "&lt;"; break;
+            case '>': esc = "&gt;"; break;
+            case '&': esc = "&amp;"; break;
+            case '"': esc = "&quot;"; break;
+            default: continue;
+        }
+        out.write((const uint8_t*)run, p - run);
+        out.print(esc);
+        run = p + 1;
+    }
+    out.write((const uint8_t*)run, p - run);
+}
@@ -2,21 +2,27 @@
  * @file web_queue.cpp
  * @brief Cooperative chunked web request queue — state machine implementation
  *
- * All work runs on core 1 via tick().  Each tick() call does at most one
- * ~4 KB chunk of I/O so the main loop can service audio playback between
- * chunks.  See web_queue.h for the full design.
+ * All work runs on core 1 via tick().  Each tick() call reads at most
+ * WEB_QUEUE_TICK_BYTES across all request slots so the main loop can
+ * service audio playback between chunks.  See web_queue.h for the full
+ * design.
  */
 
 #include "web_queue.h"
-#include "http_utils.h"
+#include "http_pool.h"
 #include "file_utils.h"
 #include "audio_key_registry.h"
 #include "config.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
 #include <SD.h>
 #include <SD_MMC.h>
+#include <unistd.h>
 
 // Global singleton
 WebQueue webQueue;
+int32_t webQueueChunkBytes = WEB_QUEUE_CHUNK_SIZE;
+int32_t webQueueTickBytes = WEB_QUEUE_TICK_BYTES;
 
 // SD abstraction (mirrors audio_file_manager.cpp)
 #if SD_USE_MMC
@@ -24,11 +30,15 @@ WebQueue webQueue;
   #define DQ_SD_OPEN(p, m)     SD_MMC.open(p, m)
   #define DQ_SD_REMOVE(p)      SD_MMC.remove(p)
   #define DQ_SD_RENAME(a, b)   SD_MMC.rename(a, b)
+  #define DQ_SD_MKDIR(p)       SD_MMC.mkdir(p)
+  #define DQ_SD_MOUNT          "/sdcard"       // VFS prefix, for POSIX calls FS.h lacks
 #else
   #define DQ_SD_EXISTS(p)      SD.exists(p)
   #define DQ_SD_OPEN(p, m)     SD.open(p, m)
   #define DQ_SD_REMOVE(p)      SD.remove(p)
   #define DQ_SD_RENAME(a, b)   SD.rename(a, b)
+  #define DQ_SD_MKDIR(p)       SD.mkdir(p)
+  #define DQ_SD_MOUNT          "/sd"
 #endif
 
 // ============================================================================
@@ -66,18 +76,39 @@ static const char* detectExtFromBytes(const uint8_t* hdr, size_t len) {
     return nullptr;
 }
 
+// Log name of a WebQueue::Priority
+static const char* priorityName(uint8_t priority) {
+    static const char* names[] = {"prefetch", "log", "catalog", "predicted", "interactive"};
+    return priority < 5 ? names[priority] : "?";
+}
+
+// ============================================================================
+// Resume metadata — "<path>.tmp" is the partial, "<path>.rng" its validator
+// (a second line "prealloc" while the .tmp is longer than what arrived)
+// ============================================================================
+static void resumeMetaPath(const char* tmpPath, char* out, size_t outSize) {
+    size_t len = strlen(tmpPath);
+    if (len > 4) len -= 4;                      // strip ".tmp"
+    snprintf(out, outSize, "%.*s.rng", (int)len, tmpPath);
+}
+
+// "bytes <from>-<to>/<total>" must start where the partial ends
+static bool contentRangeStartsAt(const String& contentRange, long from) {
+    char expect[32];
+    snprintf(expect, sizeof(expect), "bytes %ld-", from);
+    return contentRange.startsWith(expect);
+}
+
 // ============================================================================
 // Construction / destruction
 // ============================================================================
 
 WebQueue::WebQueue() {
     memset(_items, 0, sizeof(_items));
-    memset(_headerBuf, 0, sizeof(_headerBuf));
-    memset(_tmpPath, 0, sizeof(_tmpPath));
 }
 
 WebQueue::~WebQueue() {
-    _cleanupActive();
+    reset();
 }
 
 // ============================================================================
@@ -89,30 +120,37 @@ void WebQueue::setFileCallback(FileCallback cb, void* userData) {
     _fileCbUserData = userData;
 }
 
-void WebQueue::setRegistryMutex(SemaphoreHandle_t mutex) {
-    _regMutex = mutex;
-}
-
 // ============================================================================
 // Queue operations
 // ============================================================================
 
 WebQueue::EnqueueResult WebQueue::enqueueFile(
         const char* audioKey, const char* url,
-        const char* localPath, const char* ext)
+        const char* localPath, const char* ext, Priority priority)
 {
     if (!url || !url[0] || !localPath || !localPath[0])
         return EnqueueResult::BAD_INPUT;
 
-    // Duplicate check
+    // Duplicate check — a more urgent request promotes the queued item
     for (int i = 0; i < _count; i++) {
-        if (_items[i].state != ItemState::EMPTY &&
-            strcmp(_items[i].url, url) == 0) {
-            return EnqueueResult::ALREADY_QUEUED;
+        Item& it = _items[i];
+        if (it.state == ItemState::EMPTY || strcmp(it.url, url) != 0)
+            continue;
+        bool rearm = it.state == ItemState::FAILED && priority == Priority::INTERACTIVE;
+        if ((it.state == ItemState::PENDING || it.state == ItemState::IN_PROGRESS || rearm) &&
+            priority > it.priority) {
+            LOG_PRINTF(WEBQUEUE, "⏫ [WQ] %s: %s → %s\n", it.audioKey,
+                                 priorityName((uint8_t)it.priority), priorityName((uint8_t)priority));
+            it.priority = priority;
         }
+        if (rearm) {
+            it.state = ItemState::PENDING;
+            it.resumeAttempts = 0;
+        }
+        return EnqueueResult::ALREADY_QUEUED;
     }
 
-    if (_count >= MAX_WEB_QUEUE)
+    if (_count >= MAX_WEB_QUEUE && !(priority >= Priority::PREDICTED && _evictFor(priority)))
         return EnqueueResult::QUEUE_FULL;
 
     Item& it = _items[_count];
@@ -123,16 +161,22 @@ WebQueue::EnqueueResult WebQueue::enqueueFile(
     strncpy(it.ext,       ext       ? ext       : "", sizeof(it.ext)       - 1);
     it.type  = ItemType::FILE_DL;
     it.state = ItemState::PENDING;
+    it.priority        = priority;
     it.catalogCb       = nullptr;
     it.catalogUserData = nullptr;
     _count++;
 
-    Logger.printf("📥 [WQ] Queued file: %s → %s\n", it.audioKey, it.localPath);
+    if (priority >= Priority::PREDICTED)
+        LOG_PRINTF(WEBQUEUE, "📥 [WQ] Queued file: %s → %s (%s)\n", it.audioKey, it.localPath,
+                             priorityName((uint8_t)priority));
+    else
+        LOG_PRINTF(WEBQUEUE, "📥 [WQ] Queued file: %s → %s\n", it.audioKey, it.localPath);
     return EnqueueResult::OK;
 }
 
 WebQueue::EnqueueResult WebQueue::enqueueCatalog(
-        const char* url, CatalogCallback cb, void* userData)
+        const char* url, CatalogCallback cb, void* userData,
+        CatalogChunkCallback chunkCb, HttpValidators* validators)
 {
     if (!url || !url[0] || !cb)
         return EnqueueResult::BAD_INPUT;
@@ -155,11 +199,14 @@ WebQueue::EnqueueResult WebQueue::enqueueCatalog(
     snprintf(it.audioKey, sizeof(it.audioKey), "(catalog)");
     it.type            = ItemType::CATALOG_DL;
     it.state           = ItemState::PENDING;
+    it.priority        = Priority::CATALOG;
     it.catalogCb       = cb;
+    it.catalogChunkCb  = chunkCb;
     it.catalogUserData = userData;
+    it.catalogValidators = validators;
     _count++;
 
-    Logger.printf("📥 [WQ] Queued catalog: %s\n", url);
+    LOG_PRINTF(WEBQUEUE, "📥 [WQ] Queued catalog: %s\n", url);
     return EnqueueResult::OK;
 }
 
@@ -167,7 +214,7 @@ WebQueue::EnqueueResult WebQueue::enqueuePost(
         const char* url, const String& body,
         PostCallback cb, void* userData,
         const char* contentType,
-        const char* extraHeaderName, const char* extraHeaderValue)
+        const char* extraHeaderName, const char* extraHeaderValue, Priority priority)
 {
     if (!url || !url[0] || !cb)
         return EnqueueResult::BAD_INPUT;
@@ -181,6 +228,7 @@ WebQueue::EnqueueResult WebQueue::enqueuePost(
     snprintf(it.audioKey, sizeof(it.audioKey), "(post)");
     it.type          = ItemType::POST;
     it.state         = ItemState::PENDING;
+    it.priority      = priority;
     it.postBody      = body;
     it.postCb        = cb;
     it.postUserData  = userData;
@@ -192,7 +240,7 @@ WebQueue::EnqueueResult WebQueue::enqueuePost(
         strncpy(it.postExtraHdrValue, extraHeaderValue, sizeof(it.postExtraHdrValue) - 1);
     _count++;
 
-    Logger.printf("📤 [WQ] Queued POST: %s (%d bytes)\n", url, body.length());
+    LOG_PRINTF(WEBQUEUE, "📤 [WQ] Queued POST: %s (%d bytes)\n", url, body.length());
     return EnqueueResult::OK;
 }
 
@@ -206,7 +254,10 @@ void WebQueue::clear() {
 }
 
 void WebQueue::reset() {
-    _cleanupActive();
+    for (Slot& slot : _slots) {
+        _releaseSlot(slot, false);
+        _freeWriteBuf(slot);
+    }
     for (int i = 0; i < _count; i++)
         _items[i].postBody = String();  // free heap before zeroing
     memset(_items, 0, sizeof(_items));
@@ -219,13 +270,63 @@ void WebQueue::compact() {
     _compact();
 }
 
+void WebQueue::setSuspended(bool suspended) {
+    if (suspended == _suspended) return;
+    _suspended = suspended;
+    if (suspended)
+        Logger.println("⏸️ [WQ] Suspended — only predicted and interactive downloads run");
+    else
+        Logger.println("▶️ [WQ] Resumed");
+}
+
+int WebQueue::demote(Priority from, Priority to) {
+    if (to >= from) return 0;
+    int moved = 0;
+    for (int i = 0; i < _count; i++) {
+        Item& it = _items[i];
+        if (it.priority != from ||
+            (it.state != ItemState::PENDING && it.state != ItemState::IN_PROGRESS))
+            continue;
+        it.priority = to;
+        moved++;
+    }
+    if (moved > 0)
+        LOG_DEBUGF(WEBQUEUE, "⏬ [WQ] %d item(s): %s → %s\n", moved,
+                             priorityName((uint8_t)from), priorityName((uint8_t)to));
+    return moved;
+}
+
+// Make room in a full queue: reclaim finished entries, else drop the last
+// pending FILE_DL below `priority` (its partial stays on SD for a re-queue)
+bool WebQueue::_evictFor(Priority priority) {
+    if (pendingCount() + _activeCount() < _count) {
+        _compact();
+        return _count < MAX_WEB_QUEUE;
+    }
+    for (int i = _count - 1; i >= 0; i--) {
+        Item& it = _items[i];
+        if (it.type != ItemType::FILE_DL || it.state != ItemState::PENDING || it.priority >= priority)
+            continue;
+        LOG_PRINTF(WEBQUEUE, "↩️ [WQ] Dropping queued %s for a %s file\n",
+                             it.audioKey, priorityName((uint8_t)priority));
+        it.state = ItemState::EMPTY;
+        _compact();
+        return true;
+    }
+    return false;
+}
+
 void WebQueue::_compact() {
-    if (_activeIdx >= 0) return;  // don't compact while a download is active
+    // Keep PENDING and IN_PROGRESS items; slots follow their item's new index
     int dst = 0;
     for (int src = 0; src < _count; src++) {
-        if (_items[src].state == ItemState::PENDING) {
-            if (dst != src)
+        ItemState st = _items[src].state;
+        if (st == ItemState::PENDING || st == ItemState::IN_PROGRESS) {
+            if (dst != src) {
                 _items[dst] = _items[src];
+                for (Slot& slot : _slots)
+                    if (slot.itemIdx == src) slot.itemIdx = dst;
+            }
             dst++;
         }
     }
@@ -255,12 +356,19 @@ int WebQueue::totalCount() const {
 }
 
 bool WebQueue::isEmpty() const {
-    return pendingCount() == 0 && _activeIdx < 0;
+    return pendingCount() == 0 && _activeCount() == 0;
+}
+
+int WebQueue::_activeCount() const {
+    int n = 0;
+    for (const Slot& slot : _slots)
+        if (slot.itemIdx >= 0) n++;
+    return n;
 }
 
 void WebQueue::listItems() const {
-    Logger.printf("📥 WebQueue (%d items, active=%d):\n",
-                  _count, _activeIdx);
+    Logger.printf("📥 WebQueue (%d items, %d/%d slots active%s):\n",
+                  _count, _activeCount(), WEB_QUEUE_SLOTS, _suspended ? ", suspended" : "");
     for (int i = 0; i < _count; i++) {
         const Item& it = _items[i];
         const char* st =
@@ -270,8 +378,15 @@ void WebQueue::listItems() const {
             it.state == ItemState::FAILED      ? "❌ failed"      : "   empty";
         const char* tp = it.type == ItemType::CATALOG_DL ? "CAT" :
                          it.type == ItemType::POST       ? "POST" : "FILE";
-        Logger.printf("  [%d] %s %s  %s → %s\n", i, tp, st, it.audioKey,
-                      it.type == ItemType::FILE_DL ? it.localPath : "(string)");
+        Logger.printf("  [%d] %s %s %s  %s → %s\n", i, tp, st, priorityName((uint8_t)it.priority),
+                      it.audioKey, it.type == ItemType::FILE_DL ? it.localPath : "(string)");
+    }
+    for (int i = 0; i < WEB_QUEUE_SLOTS; i++) {
+        const Slot& slot = _slots[i];
+        if (slot.itemIdx >= 0)
+            Logger.printf("  slot %d: item %d, %d bytes\n", i, slot.itemIdx, slot.totalBytes);
+        else
+            Logger.printf("  slot %d: idle\n", i);
     }
 }
 
@@ -280,48 +395,151 @@ void WebQueue::listItems() const {
 // ============================================================================
 
 bool WebQueue::tick() {
-    // Active request in progress → stream one chunk
-    if (_activeIdx >= 0) {
-        return _streamChunk();
-    }
-
-    // No active request — rate-limit idle checks
+    // Active requests → read up to WEB_QUEUE_TICK_BYTES across them
+    bool worked = _activeCount() > 0 && _streamChunks();
+
+    // Every slot busy and a more urgent item waiting → pause a lower file
+    Priority top = Priority::PREFETCH;
+    bool pending = _topPending(top);
+    if (pending && _activeCount() >= WEB_QUEUE_SLOTS && _preemptFor(top))
+        _startNow = true;
+
+    if (_activeCount() >= WEB_QUEUE_SLOTS)
+        return worked;
+
+    // A free slot — rate-limit starts, except straight after a completion
+    // so the next file can go out on the connection that just freed up.
+    // Predicted and interactive items skip the rate limit and the failure backoff.
+    bool urgent = pending && top >= Priority::PREDICTED;
     unsigned long now = millis();
-    if (now - _lastIdleTick < WEB_QUEUE_IDLE_INTERVAL_MS)
-        return false;
+    if (!_startNow && !urgent && now - _lastIdleTick < WEB_QUEUE_IDLE_INTERVAL_MS)
+        return worked;
+    _startNow = false;
     _lastIdleTick = now;
 
+    _closeIdleSlots(now);
+
     // Backoff after failures
-    if (_consecutiveFailures > 0 && now < _backoffUntil)
-        return false;
+    if (!urgent && _consecutiveFailures > 0 && now < _backoffUntil)
+        return worked;
 
     // Compact when >=50% of slots are consumed by done/failed/empty items
-    int nonPending = _count - pendingCount();
-    if (_count > 0 && nonPending >= MAX_WEB_QUEUE / 2)
+    int finished = _count - pendingCount() - _activeCount();
+    if (_count > 0 && finished >= MAX_WEB_QUEUE / 2)
         _compact();
 
     // Try to start the next pending item
-    return _startNext();
+    return _startNext() || worked;
 }
 
 // ============================================================================
-// _findNextPending — catalog items have priority over file items
+// _findNextPending — highest priority first, in queue order within a class
 // ============================================================================
 
 WebQueue::Item* WebQueue::_findNextPending() {
-    // First pass: find first CATALOG or POST PENDING (same priority)
+    Priority top;
+    if (!_topPending(top)) return nullptr;
+
+    // First of the class, preferring a file whose host has a warm
+    // connection waiting in the HTTP pool
+    Item* first = nullptr;
     for (int i = 0; i < _count; i++) {
-        if (_items[i].state == ItemState::PENDING &&
-            (_items[i].type == ItemType::CATALOG_DL || _items[i].type == ItemType::POST))
-            return &_items[i];
+        Item& it = _items[i];
+        if (it.state != ItemState::PENDING || it.priority != top)
+            continue;
+        if (!first) first = &it;
+        if (it.type == ItemType::FILE_DL && httpPool.hasIdle(it.url))
+            return &it;
     }
-    // Second pass: first FILE PENDING
+    return first;
+}
+
+// Highest priority among items that may start now (false if none)
+bool WebQueue::_topPending(Priority& top) const {
+    bool any = false;
     for (int i = 0; i < _count; i++) {
-        if (_items[i].state == ItemState::PENDING &&
-            _items[i].type == ItemType::FILE_DL)
-            return &_items[i];
+        const Item& it = _items[i];
+        if (it.state != ItemState::PENDING) continue;
+        if (_held(it.priority)) continue;
+        if (!any || it.priority > top) top = it.priority;
+        any = true;
     }
-    return nullptr;
+    return any;
+}
+
+// ============================================================================
+// _preemptFor — pause the lowest active FILE_DL below `priority`.  Files
+// without a validator would restart from zero, so only INTERACTIVE takes those.
+// ============================================================================
+
+bool WebQueue::_preemptFor(Priority priority) {
+    Slot* victim = nullptr;
+    for (Slot& slot : _slots) {
+        if (slot.itemIdx < 0) continue;
+        const Item& it = _items[slot.itemIdx];
+        if (it.type != ItemType::FILE_DL || it.priority >= priority) continue;
+        if (!slot.resumable && priority != Priority::INTERACTIVE) continue;
+        if (!victim || it.priority < _items[victim->itemIdx].priority) victim = &slot;
+    }
+    if (!victim) return false;
+
+    LOG_PRINTF(WEBQUEUE, "⏸️ [WQ] Pausing %s for a %s item\n",
+                         _items[victim->itemIdx].audioKey, priorityName((uint8_t)priority));
+    _pauseSlot(*victim);
+    return true;
+}
+
+// Stop a FILE_DL without failing it: commit what was read, keep the
+// partial (when resumable), and put the item back in line
+void WebQueue::_pauseSlot(Slot& slot) {
+    Item& item = _items[slot.itemIdx];
+    _drainWrites(slot, slot.resumable);
+    slot.sdFile.close();
+    if (!slot.resumable)
+        _dropPartial(item);
+    else if (slot.preallocated && !_trimPartial(item, slot.totalBytes))
+        slot.resumable = false;
+    item.crc      = slot.crc;
+    item.crcBytes = slot.resumable && slot.crcKnown ? slot.totalBytes : 0;
+    item.state = ItemState::PENDING;
+    _releaseSlot(slot, false);   // Body unread — the connection can't be reused
+}
+
+// ============================================================================
+// _freeSlot — an idle slot, preferring one that still has its write
+// buffer. -1 if all are busy.
+// ============================================================================
+
+int WebQueue::_freeSlot() {
+    int found = -1;
+    for (int i = 0; i < WEB_QUEUE_SLOTS; i++) {
+        const Slot& slot = _slots[i];
+        if (slot.itemIdx >= 0 || slot.http) continue;
+        if (slot.writeBuf) return i;
+        if (found < 0) found = i;
+    }
+    return found;
+}
+
+// Idle pooled connections and write buffers go after HTTP_POOL_IDLE_MS
+void WebQueue::_closeIdleSlots(unsigned long now) {
+    httpPool.closeIdle();
+    for (Slot& slot : _slots) {
+        if (slot.itemIdx < 0 && slot.writeBuf && now - slot.idleSince >= HTTP_POOL_IDLE_MS)
+            _freeWriteBuf(slot);
+    }
+}
+
+void WebQueue::_freeWriteBuf(Slot& slot) {
+    heap_caps_free(slot.writeBuf);
+    slot.writeBuf = nullptr;
+}
+
+// Give the slot's client back to the pool
+void WebQueue::_returnClient(Slot& slot, bool keepConnection) {
+    if (!slot.http) return;
+    httpPool.release(slot.http, keepConnection);
+    slot.http = nullptr;
 }
 
 // ============================================================================
@@ -334,15 +552,39 @@ bool WebQueue::_startNext() {
 
     int idx = (int)(item - _items);
 
-    const char* label = item->type == ItemType::CATALOG_DL ? "catalog" :
-                        item->type == ItemType::POST       ? "POST"    : item->audioKey;
-    Logger.printf("📥 [WQ] Starting %s: %s\n", label, item->url);
+    // A streamed play may have written the file through since it was queued
+    if (item->type == ItemType::FILE_DL && DQ_SD_EXISTS(item->localPath)) {
+        LOG_PRINTF(WEBQUEUE, "⏭️ [WQ] %s already on SD — skipping download\n", item->audioKey);
+        item->state = ItemState::DONE;
+        _startNow = true;
+        if (_fileCb) {
+            File existing = DQ_SD_OPEN(item->localPath, FILE_READ);
+            int size = existing ? (int)existing.size() : 0;
+            if (existing) existing.close();
+            _fileCb(item->audioKey, item->localPath, item->ext, size > 0 ? size : -1, 0, _fileCbUserData);
+        }
+        return false;
+    }
+
+    int slotIdx = _freeSlot();
+    if (slotIdx < 0) return false;
+    Slot& slot = _slots[slotIdx];
 
-    // Allocate HTTP client (on heap so it persists across tick calls)
     int timeout = item->type == ItemType::CATALOG_DL ? HTTP_TIMEOUT_CATALOG_MS
                 : item->type == ItemType::POST       ? HTTP_TIMEOUT_SHORT_MS
                 :                                      HTTP_TIMEOUT_DOWNLOAD_MS;
-    _http = new HttpClient(timeout);
+    bool warm = httpPool.hasIdle(item->url);
+
+    // Clients come from the shared pool (keep-alive, own TLS context), so a
+    // connection opened by any subsystem can carry this request
+    HttpClient* http = httpPool.acquire(item->url, timeout);
+    if (!http) return false;    // Every pooled client is busy — next tick
+    slot.http = http;
+
+    const char* label = item->type == ItemType::CATALOG_DL ? "catalog" :
+                        item->type == ItemType::POST       ? "POST"    : item->audioKey;
+    LOG_PRINTF(WEBQUEUE, "📥 [WQ] Starting %s on slot %d%s: %s\n", label, slotIdx,
+                         warm ? " (reused connection)" : "", item->url);
 
     if (item->type == ItemType::POST) {
         // --- POST: send body, then read response via chunked reader ---
@@ -355,71 +597,115 @@ bool WebQueue::_startNext() {
             hdrs[hdrCount++] = {item->postExtraHdrName, item->postExtraHdrValue};
         }
 
-        if (!_http->post(item->url, item->postBody, hdrs, hdrCount)) {
-            int code = _http->statusCode();
-            Logger.printf("❌ [WQ] POST HTTP %d for %s\n", code, item->url);
+        if (!http->post(item->url, item->postBody, hdrs, hdrCount)) {
+            int code = http->statusCode();
+            LOG_PRINTF(WEBQUEUE, "❌ [WQ] POST HTTP %d for %s\n", code, item->url);
             // Fire callback with failure
             if (item->postCb) item->postCb(false, code, item->postUserData);
-            delete _http; _http = nullptr;
             item->postBody = String(); // free memory
             item->state = ItemState::FAILED;
             _consecutiveFailures++;
             unsigned long backoff = min(300000UL, 10000UL << min(_consecutiveFailures - 1, 5));
             _backoffUntil = millis() + backoff;
-            Logger.printf("⏳ [WQ] Backoff %lus after %d failure(s)\n",
-                          backoff / 1000, _consecutiveFailures);
+            LOG_PRINTF(WEBQUEUE, "⏳ [WQ] Backoff %lus after %d failure(s)\n",
+                                 backoff / 1000, _consecutiveFailures);
+            _returnClient(slot, false);
+            slot.idleSince = millis();
             return false;
         }
 
-        // POST succeeded — fire callback immediately
-        int code = _http->statusCode();
-        _http->end();
-        delete _http; _http = nullptr;
+        // POST succeeded — fire callback immediately.  The response body is
+        // not read, so the connection can't be reused.
+        int code = http->statusCode();
+        _returnClient(slot, false);
+        slot.idleSince = millis();
 
         item->postBody = String(); // free memory
         item->state = ItemState::DONE;
         _consecutiveFailures = 0;
-        Logger.printf("✅ [WQ] POST %d → %s\n", code, item->url);
+        LOG_PRINTF(WEBQUEUE, "✅ [WQ] POST %d → %s\n", code, item->url);
         if (item->postCb) item->postCb(true, code, item->postUserData);
         return true;
     }
 
     // --- GET (FILE_DL or CATALOG_DL) ---
-    const char* wantHeaders[] = {"Content-Type"};
-    _http->collectHeaders(wantHeaders, 1);
+    // The partial is named from the path at first start; Content-Type
+    // correction may change localPath, but not where the bytes so far are.
+    long resumeFrom = 0;
+    String validator;
+    if (item->type == ItemType::FILE_DL) {
+        if (!item->tmpPath[0])
+            snprintf(item->tmpPath, sizeof(item->tmpPath), "%s.tmp", item->localPath);
+        resumeFrom = _partialSize(*item, validator);
+    }
+
+    bool ok;
+    if (resumeFrom > 0) {
+        // If-Range: the server sends 206 with the rest only if the file is
+        // still the one the partial came from, else 200 with all of it
+        char range[32];
+        snprintf(range, sizeof(range), "bytes=%ld-", resumeFrom);
+        HttpClient::Header hdrs[] = {{"Range", range}, {"If-Range", validator.c_str()}};
+        ok = http->get(item->url, hdrs, 2);
+    } else if (item->type == ItemType::CATALOG_DL && item->catalogValidators) {
+        HttpClient::Header hdrs[2];
+        ok = http->get(item->url, hdrs,
+                       HttpClient::conditionalHeaders(*item->catalogValidators, hdrs));
+    } else {
+        ok = http->get(item->url);
+    }
 
-    if (!_http->get(item->url)) {
-        Logger.printf("❌ [WQ] HTTP %d for %s\n", _http->statusCode(), item->audioKey);
-        delete _http; _http = nullptr;
+    if (!ok && item->type == ItemType::CATALOG_DL && http->notModified()) {
+        // Nothing to read or parse: what the caller has is current
+        LOG_PRINTF(WEBQUEUE, "✅ [WQ] Catalog not modified (304)\n");
+        item->state = ItemState::DONE;
+        _returnClient(slot, true);
+        slot.idleSince = millis();
+        _consecutiveFailures = 0;
+        _startNow = true;
+        if (item->catalogCb) item->catalogCb(true, 304, String(), item->catalogUserData);
+        return true;
+    }
+
+    if (!ok) {
+        int code = http->statusCode();
+        LOG_PRINTF(WEBQUEUE, "❌ [WQ] HTTP %d for %s\n", code, item->audioKey);
+        if (resumeFrom > 0 && code == 416)
+            _dropPartial(*item);    // Partial is longer than the file — start over
         item->state = ItemState::FAILED;
+        _returnClient(slot, false);
+        slot.idleSince = millis();
         _consecutiveFailures++;
         unsigned long backoff = min(300000UL, 10000UL << min(_consecutiveFailures - 1, 5));
         _backoffUntil = millis() + backoff;
-        Logger.printf("⏳ [WQ] Backoff %lus after %d failure(s)\n",
-                      backoff / 1000, _consecutiveFailures);
+        LOG_PRINTF(WEBQUEUE, "⏳ [WQ] Backoff %lus after %d failure(s)\n",
+                             backoff / 1000, _consecutiveFailures);
 
         if (item->type == ItemType::FILE_DL && _fileCb)
-            _fileCb(item->audioKey, item->localPath, item->ext, -1, _fileCbUserData);
+            _fileCb(item->audioKey, item->localPath, item->ext, -1, 0, _fileCbUserData);
         if (item->type == ItemType::CATALOG_DL && item->catalogCb)
-            item->catalogCb(false, String(), item->catalogUserData);
+            item->catalogCb(false, code, String(), item->catalogUserData);
         return false;
     }
 
     // Connection established — mark IN_PROGRESS
-    item->state = ItemState::IN_PROGRESS;
-    _activeIdx  = idx;
-    _totalBytes = 0;
-    _headerLen  = 0;
+    item->state     = ItemState::IN_PROGRESS;
+    slot.itemIdx    = idx;
+    slot.totalBytes = 0;
+    slot.statusCode = http->statusCode();
+    slot.headerLen  = 0;
 
-    _http->beginChunkedRead();
+    http->beginChunkedRead();
+    if (item->type == ItemType::CATALOG_DL && item->catalogValidators)
+        http->readValidators(*item->catalogValidators);
 
     if (item->type == ItemType::FILE_DL) {
         // --- Content-Type → corrected extension ---
-        String ct = _http->header("Content-Type");
+        String ct = http->header("Content-Type");
         const char* detectedExt = mimeToExt(ct.c_str());
         if (detectedExt && item->ext[0] && strcmp(detectedExt, item->ext) != 0) {
-            Logger.printf("🔍 [WQ] Content-Type '%s' → '%s' (was '%s')\n",
-                          ct.c_str(), detectedExt, item->ext);
+            LOG_PRINTF(WEBQUEUE, "🔍 [WQ] Content-Type '%s' → '%s' (was '%s')\n",
+                                 ct.c_str(), detectedExt, item->ext);
         }
         if (detectedExt) {
             char corrected[128];
@@ -431,105 +717,229 @@ bool WebQueue::_startNext() {
             }
         }
 
-        // --- Remove stale files with wrong extension ---
+        // --- Shard directory, created on its first file ---
+        char dir[128];
+        strncpy(dir, item->localPath, sizeof(dir) - 1);
+        dir[sizeof(dir) - 1] = '\0';
+        if (char* slash = strrchr(dir, '/')) *slash = '\0';
+        if (dir[0] && !DQ_SD_EXISTS(dir))
+            DQ_SD_MKDIR(dir);
+
+        // --- Remove stale files with wrong extension (same shard: it ignores the extension) ---
         char base[64]; urlToBaseFilename(item->url, base, nullptr);
         if (char* dot = strrchr(base, '.')) *dot = '\0';
         const char* allExts[] = {".mp3", ".wav", ".ogg", ".flac", ".aac", ".m4a"};
         for (int i = 0; i < 6; i++) {
             char old[128];
-            snprintf(old, sizeof(old), "%s/%s%s", AUDIO_FILES_DIR, base, allExts[i]);
+            snprintf(old, sizeof(old), "%s/%s%s", dir, base, allExts[i]);
             if (strcmp(old, item->localPath) != 0 && DQ_SD_EXISTS(old)) {
-                Logger.printf("🗑️ [WQ] Remove stale: %s\n", old);
+                LOG_PRINTF(WEBQUEUE, "🗑️ [WQ] Remove stale: %s\n", old);
                 DQ_SD_REMOVE(old);
             }
         }
 
-        // --- Open SD file for writing to temp path ---
-        snprintf(_tmpPath, sizeof(_tmpPath), "%s.tmp", item->localPath);
-        _sdFile = DQ_SD_OPEN(_tmpPath, FILE_WRITE);
-        if (!_sdFile) {
-            Logger.printf("❌ [WQ] Cannot create file: %s\n", _tmpPath);
-            _failCurrent();
+        // --- Append to the partial (206) or write the temp path afresh ---
+        bool resumed = resumeFrom > 0 && http->statusCode() == 206;
+        if (resumed && !contentRangeStartsAt(http->header("Content-Range"), resumeFrom)) {
+            LOG_PRINTF(WEBQUEUE, "❌ [WQ] Content-Range '%s' does not continue %s at %ld\n",
+                                 http->header("Content-Range").c_str(), item->tmpPath, resumeFrom);
+            _failSlot(slot);
             return false;
         }
-    } else {
+        if (resumed) {
+            // Magic-byte detection needs the start of the file, already on SD
+            File part = DQ_SD_OPEN(item->tmpPath, FILE_READ);
+            if (part) {
+                slot.headerLen = part.read(slot.headerBuf, sizeof(slot.headerBuf));
+                part.close();
+            }
+            slot.totalBytes = resumeFrom;
+            slot.crcKnown   = item->crcBytes == resumeFrom;
+            slot.crc        = slot.crcKnown ? item->crc : 0;
+            LOG_PRINTF(WEBQUEUE, "⏯️ [WQ] Resuming %s at %ld bytes\n", item->audioKey, resumeFrom);
+        } else if (resumeFrom > 0) {
+            LOG_PRINTF(WEBQUEUE, "🔁 [WQ] %s: server sent the whole file — restarting\n", item->audioKey);
+        }
+        if (!resumed) {
+            slot.crc      = 0;
+            slot.crcKnown = true;
+        }
+
+        slot.sdFile = DQ_SD_OPEN(item->tmpPath, resumed ? FILE_APPEND : FILE_WRITE);
+        if (!slot.sdFile) {
+            LOG_PRINTF(WEBQUEUE, "❌ [WQ] Cannot create file: %s\n", item->tmpPath);
+            _failSlot(slot);
+            return false;
+        }
+        long remaining = http->getSize();
+        slot.expectedBytes = remaining > 0 ? (resumed ? resumeFrom : 0) + remaining : -1;
+        // Whole file's clusters in one allocation; a resumed partial appends
+        // to the chain it already has
+        slot.preallocated = false;
+#if WEB_QUEUE_PREALLOCATE
+        if (!resumed && slot.expectedBytes > 0) {
+            slot.preallocated = preallocateFile(slot.sdFile, slot.expectedBytes);
+            if (!slot.preallocated)
+                LOG_PRINTF(WEBQUEUE, "⚠️ [WQ] Cannot preallocate %ld bytes for %s\n",
+                                     slot.expectedBytes, item->audioKey);
+        }
+#endif
+        slot.resumable = resumed || _writeResumeMeta(*item, *http, slot.preallocated);
+
+        // Double buffer for the SD writes; without one, chunks are written
+        // straight from the read buffer
+        if (!slot.writeBuf)
+            slot.writeBuf = (uint8_t*)heap_caps_malloc(2 * WEB_QUEUE_WRITE_BUF_SIZE,
+                                                       MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (slot.writeBuf)
+            _startWriter();
+        slot.writeHalf   = 0;
+        slot.writeFill   = 0;
+        slot.writeBase   = resumed ? resumeFrom : 0;
+        slot.writeFailed = false;
+    } else if (!item->catalogChunkCb) {
         // CATALOG: prepare String accumulator
-        _bodyAccum = String();
-        _bodyAccum.reserve(_http->getSize() > 0 ? _http->getSize() : 4096);
+        slot.bodyAccum = String();
+        slot.bodyAccum.reserve(http->getSize() > 0 ? http->getSize() : 4096);
     }
 
     return true;
 }
 
 // ============================================================================
-// _streamChunk — read one chunk (~4 KB) from HTTP → SD file or String
+// _streamChunks — share the per-tick read budget round-robin across slots
 // ============================================================================
 
-bool WebQueue::_streamChunk() {
-    if (_activeIdx < 0 || !_http) return false;
-    Item& item = _items[_activeIdx];
-
+bool WebQueue::_streamChunks() {
     uint8_t buf[WEB_QUEUE_CHUNK_SIZE];
-    int n = _http->readChunk(buf, sizeof(buf));
+    int budget = webQueueTickBytes;
+    bool worked = false;
+
+    // The highest active class reads first; the rest share what's left
+    Priority top = Priority::PREFETCH;
+    for (const Slot& slot : _slots)
+        if (slot.itemIdx >= 0 && _items[slot.itemIdx].priority > top)
+            top = _items[slot.itemIdx].priority;
+
+    for (int pass = 0; pass < 2 && budget > 0; pass++) {
+        for (int k = 0; k < WEB_QUEUE_SLOTS && budget > 0; k++) {
+            Slot& slot = _slots[(_nextSlot + k) % WEB_QUEUE_SLOTS];
+            if (slot.itemIdx < 0) continue;
+            Priority p = _items[slot.itemIdx].priority;
+            if ((p == top) != (pass == 0)) continue;
+            if (_held(p)) continue;   // Held while suspended
+
+            int n = _streamChunk(slot, buf, min(budget, (int)min((size_t)webQueueChunkBytes, sizeof(buf))));
+            if (n != 0) worked = true;
+            if (n > 0) budget -= n;
+        }
+    }
+    _nextSlot = (_nextSlot + 1) % WEB_QUEUE_SLOTS;
+    return worked;
+}
+
+// ============================================================================
+// _streamChunk — read one chunk from a slot's HTTP → SD file or String
+// Returns bytes read, 0 if nothing was available, -1 if the item ended.
+// ============================================================================
+
+int WebQueue::_streamChunk(Slot& slot, uint8_t* buf, size_t maxBytes) {
+    if (slot.itemIdx < 0 || !slot.http) return 0;
+    Item& item = _items[slot.itemIdx];
+    bool buffered = item.type == ItemType::FILE_DL && slot.writeBuf;
+
+    if (slot.writeFailed) {
+        LOG_PRINTF(WEBQUEUE, "❌ [WQ] SD write failed for %s at %d bytes\n", item.audioKey, slot.totalBytes);
+        _failSlot(slot);
+        return -1;
+    }
+
+    if (buffered) {
+        // Both halves full (one still being written) — leave the data in
+        // the socket until the writer catches up
+        if (_writeRoom(slot) == 0 && !_submitWrite(slot)) return 0;
+        buf = slot.writeBuf + slot.writeHalf * WEB_QUEUE_WRITE_BUF_SIZE + slot.writeFill;
+        maxBytes = min(maxBytes, (size_t)_writeRoom(slot));
+    }
+
+    // Body complete → don't read; the server may already have closed
+    int n = slot.http->bodyDone() ? 0 : slot.http->readChunk(buf, maxBytes);
 
     if (n > 0) {
         // Capture first 12 bytes for magic-byte detection (FILE_DL only)
-        if (item.type == ItemType::FILE_DL && _headerLen < (int)sizeof(_headerBuf)) {
-            int tocopy = min(n, (int)sizeof(_headerBuf) - _headerLen);
-            memcpy(_headerBuf + _headerLen, buf, tocopy);
-            _headerLen += tocopy;
+        if (item.type == ItemType::FILE_DL && slot.headerLen < (int)sizeof(slot.headerBuf)) {
+            int tocopy = min(n, (int)sizeof(slot.headerBuf) - slot.headerLen);
+            memcpy(slot.headerBuf + slot.headerLen, buf, tocopy);
+            slot.headerLen += tocopy;
         }
 
-        if (item.type == ItemType::FILE_DL) {
-            _sdFile.write(buf, n);
+        slot.totalBytes += n;
+        _stats.bytes += n;
+        if (buffered) {
+            slot.writeFill += n;
+            if (_writeRoom(slot) == 0) _submitWrite(slot);
+        } else if (item.type == ItemType::FILE_DL) {
+            if (slot.sdFile.write(buf, n) != (size_t)n) slot.writeFailed = true;
+            slot.crc = esp_rom_crc32_le(slot.crc, buf, n);
+        } else if (item.catalogChunkCb) {
+            if (!item.catalogChunkCb(buf, n, item.catalogUserData)) {
+                LOG_PRINTF(WEBQUEUE, "❌ [WQ] Catalog consumer rejected data at %d bytes\n", slot.totalBytes);
+                _failSlot(slot);
+            }
         } else {
-            _bodyAccum.concat((const char*)buf, n);
+            slot.bodyAccum.concat((const char*)buf, n);
         }
-        _totalBytes += n;
-        return true;
+        return n;
     }
 
     if (n < 0) {
-        // TCP error / connection lost — treat as failure even if partial data received
-        Logger.printf("❌ [WQ] Read error for %s (%d bytes so far)\n", item.audioKey, _totalBytes);
-        _failCurrent();
-        return true;
+        // TCP error / connection lost — a FILE_DL keeps its partial to resume
+        LOG_PRINTF(WEBQUEUE, "❌ [WQ] Read error for %s (%d bytes so far)\n", item.audioKey, slot.totalBytes);
+        _failSlot(slot, true);
+        return -1;
     }
 
-    if (_http->bodyDone()) {
-        // Body complete
-        bool ok = (_totalBytes > 0);
+    if (slot.http->bodyDone()) {
+        // Body complete — commit the buffered tail before closing the file
+        if (buffered && (slot.writeBusy || slot.writeFill > 0)) {
+            _submitWrite(slot);
+            return 0;
+        }
+        bool ok = (slot.totalBytes > 0);
         if (!ok) {
-            Logger.printf("❌ [WQ] Zero bytes for %s\n", item.audioKey);
-            _failCurrent();
+            LOG_PRINTF(WEBQUEUE, "❌ [WQ] Zero bytes for %s\n", item.audioKey);
+            _failSlot(slot);
+        } else if (item.type == ItemType::FILE_DL && !_verifySize(slot)) {
+            // Cut short: resume from what arrived
+            _failSlot(slot, slot.expectedBytes > slot.totalBytes);
         } else {
-            _finishCurrent(true);
+            _finishSlot(slot, true);
         }
-        return true;
+        return -1;
     }
 
     // n == 0 and body not done: nothing available yet, try next tick
-    return false;
+    return 0;
 }
 
 // ============================================================================
-// _finishCurrent — close file, magic-byte verify, re-register key, callback
+// _finishSlot — close file, magic-byte verify, re-register key, callback
 // ============================================================================
 
-void WebQueue::_finishCurrent(bool ok) {
-    if (_activeIdx < 0) return;
-    Item& item = _items[_activeIdx];
+void WebQueue::_finishSlot(Slot& slot, bool ok) {
+    if (slot.itemIdx < 0) return;
+    Item& item = _items[slot.itemIdx];
 
     if (item.type == ItemType::FILE_DL) {
-        _sdFile.close();
+        slot.sdFile.close();
 
         if (ok) {
             // Magic-byte validation: Google Drive may lie about Content-Type
-            if (_headerLen >= 12) {
-                const char* actualExt = detectExtFromBytes(_headerBuf, _headerLen);
+            if (slot.headerLen >= 12) {
+                const char* actualExt = detectExtFromBytes(slot.headerBuf, slot.headerLen);
                 if (actualExt && item.ext[0] && strcmp(actualExt, item.ext) != 0) {
-                    Logger.printf("⚠️ [WQ] '%s' content is %s not %s — correcting\n",
-                                  item.audioKey, actualExt, item.ext);
+                    LOG_PRINTF(WEBQUEUE, "⚠️ [WQ] '%s' content is %s not %s — correcting\n",
+                                         item.audioKey, actualExt, item.ext);
                     char newPath[128];
                     if (getLocalPathForUrl(item.url, newPath, actualExt)) {
                         strncpy(item.localPath, newPath, sizeof(item.localPath) - 1);
@@ -543,73 +953,285 @@ void WebQueue::_finishCurrent(bool ok) {
             // Atomic replace: remove any existing file, rename .tmp → final
             if (DQ_SD_EXISTS(item.localPath))
                 DQ_SD_REMOVE(item.localPath);
-            DQ_SD_RENAME(_tmpPath, item.localPath);
-            Logger.printf("✅ [WQ] %d bytes → %s\n", _totalBytes, item.localPath);
+            DQ_SD_RENAME(item.tmpPath, item.localPath);
+            _dropPartial(item);     // Resume metadata
+            LOG_PRINTF(WEBQUEUE, "✅ [WQ] %d bytes → %s\n", slot.totalBytes, item.localPath);
         }
 
         item.state = ok ? ItemState::DONE : ItemState::FAILED;
         if (_fileCb)
-            _fileCb(item.audioKey, item.localPath, item.ext,
-                    ok ? _totalBytes : -1, _fileCbUserData);
+            _fileCb(item.audioKey, item.localPath, item.ext, ok ? slot.totalBytes : -1,
+                    ok && slot.crcKnown ? slot.crc : 0, _fileCbUserData);
     } else {
         // CATALOG_DL
-        Logger.printf("✅ [WQ] Catalog received (%d bytes)\n", _totalBytes);
+        LOG_PRINTF(WEBQUEUE, "✅ [WQ] Catalog received (%d bytes)\n", slot.totalBytes);
         item.state = ok ? ItemState::DONE : ItemState::FAILED;
         if (item.catalogCb)
-            item.catalogCb(ok, _bodyAccum, item.catalogUserData);
-        _bodyAccum = String(); // release memory
+            item.catalogCb(ok, slot.statusCode, slot.bodyAccum, item.catalogUserData);
+        slot.bodyAccum = String(); // release memory
     }
 
+    if (ok) _stats.completed++;
+    else _stats.failed++;
     _consecutiveFailures = 0;
-    _cleanupActive();
+    _startNow = true;
+    _releaseSlot(slot, true);
 }
 
 // ============================================================================
-// _failCurrent — mark failed, apply backoff, fire callback
+// _failSlot — mark failed, apply backoff, fire callback
+// keepPartial: a FILE_DL broke mid-body; keep the .tmp so it can resume,
+// retrying it here up to WEB_QUEUE_RESUME_RETRIES times
 // ============================================================================
 
-void WebQueue::_failCurrent() {
-    if (_activeIdx < 0) return;
-    Item& item = _items[_activeIdx];
+void WebQueue::_failSlot(Slot& slot, bool keepPartial) {
+    if (slot.itemIdx < 0) return;
+    Item& item = _items[slot.itemIdx];
+    bool retry = false;
 
     if (item.type == ItemType::FILE_DL) {
-        _sdFile.close();
-        // Clean up .tmp partial file — never touch the real file
-        if (_tmpPath[0] && DQ_SD_EXISTS(_tmpPath))
-            DQ_SD_REMOVE(_tmpPath);
+        _drainWrites(slot, keepPartial);    // Buffered bytes are good partial data
+        slot.sdFile.close();
+        if (keepPartial && slot.preallocated && !slot.writeFailed)
+            _trimPartial(item, slot.totalBytes);
+        String validator;
+        if (!keepPartial || _partialSize(item, validator) <= 0) {
+            // Clean up .tmp partial file — never touch the real file
+            _dropPartial(item);
+        } else {
+            item.crc      = slot.crc;
+            item.crcBytes = slot.crcKnown ? slot.totalBytes : 0;
+            if (item.resumeAttempts < WEB_QUEUE_RESUME_RETRIES) {
+                item.resumeAttempts++;
+                retry = true;
+            }
+        }
     }
 
     item.postBody = String();  // free any POST body heap memory
-    item.state = ItemState::FAILED;
+    item.state = retry ? ItemState::PENDING : ItemState::FAILED;
+    if (retry) _stats.resumed++;
+    else _stats.failed++;
     _consecutiveFailures++;
     unsigned long backoff = min(300000UL, 10000UL << min(_consecutiveFailures - 1, 5));
     _backoffUntil = millis() + backoff;
-    Logger.printf("⏳ [WQ] Backoff %lus after %d failure(s)\n",
-                  backoff / 1000, _consecutiveFailures);
+    LOG_PRINTF(WEBQUEUE, "⏳ [WQ] Backoff %lus after %d failure(s)\n",
+                         backoff / 1000, _consecutiveFailures);
+
+    if (retry) {
+        LOG_PRINTF(WEBQUEUE, "⏯️ [WQ] %s will resume (attempt %d/%d)\n",
+                             item.audioKey, item.resumeAttempts, WEB_QUEUE_RESUME_RETRIES);
+        _releaseSlot(slot, false);
+        return;
+    }
 
     if (item.type == ItemType::FILE_DL && _fileCb)
-        _fileCb(item.audioKey, item.localPath, item.ext, -1, _fileCbUserData);
+        _fileCb(item.audioKey, item.localPath, item.ext, -1, 0, _fileCbUserData);
     if (item.type == ItemType::CATALOG_DL && item.catalogCb)
-        item.catalogCb(false, String(), item.catalogUserData);
+        item.catalogCb(false, slot.statusCode, String(), item.catalogUserData);
+
+    _releaseSlot(slot, false);
+}
+
+// ============================================================================
+// _releaseSlot — end the request (keeping the connection if it can be
+// reused), close the file handle, mark the slot idle
+// ============================================================================
 
-    _bodyAccum = String();
-    _cleanupActive();
+void WebQueue::_releaseSlot(Slot& slot, bool keepConnection) {
+    _returnClient(slot, keepConnection);
+    _drainWrites(slot, false);
+    if (slot.sdFile) slot.sdFile.close();
+    slot.bodyAccum  = String();
+    slot.itemIdx    = -1;
+    slot.resumable  = false;
+    slot.preallocated  = false;
+    slot.expectedBytes = -1;
+    slot.totalBytes = 0;
+    slot.headerLen  = 0;
+    slot.idleSince  = millis();
 }
 
 // ============================================================================
-// _cleanupActive — release HTTP client + file handle, reset active index
+// Resumable partials
 // ============================================================================
 
-void WebQueue::_cleanupActive() {
-    if (_http) {
-        _http->end();
-        delete _http;
-        _http = nullptr;
+// Bytes of the item's partial on SD, with the validator it was fetched
+// under.  0 when there is nothing to resume from.
+long WebQueue::_partialSize(const Item& item, String& validator) {
+    validator = String();
+    if (!item.tmpPath[0] || !DQ_SD_EXISTS(item.tmpPath)) return 0;
+
+    char metaPath[136];
+    resumeMetaPath(item.tmpPath, metaPath, sizeof(metaPath));
+    File meta = DQ_SD_OPEN(metaPath, FILE_READ);
+    if (!meta) return 0;
+    validator = meta.readStringUntil('\n');
+    String marker = meta.readStringUntil('\n');
+    meta.close();
+    validator.trim();
+    marker.trim();
+    if (validator.length() == 0) return 0;
+    // Still preallocated: cut off (reboot) before it was trimmed, so how
+    // much of it arrived is unknown
+    if (marker == "prealloc") return 0;
+
+    File part = DQ_SD_OPEN(item.tmpPath, FILE_READ);
+    if (!part) return 0;
+    long size = (long)part.size();
+    part.close();
+    return size;
+}
+
+// Record the response's validator beside the .tmp.  If-Range needs a strong
+// ETag or a Last-Modified date; without either the download can't resume.
+// Returns true if one was recorded.
+bool WebQueue::_writeResumeMeta(const Item& item, HttpClient& http, bool preallocated) {
+    char metaPath[136];
+    resumeMetaPath(item.tmpPath, metaPath, sizeof(metaPath));
+
+    String validator = http.header("ETag");
+    if (validator.length() == 0 || validator.startsWith("W/"))
+        validator = http.header("Last-Modified");
+    if (validator.length() == 0) {
+        if (DQ_SD_EXISTS(metaPath)) DQ_SD_REMOVE(metaPath);
+        return false;
+    }
+
+    File meta = DQ_SD_OPEN(metaPath, FILE_WRITE);
+    if (!meta) return false;
+    meta.print(validator);
+    meta.print('\n');
+    if (preallocated) meta.print("prealloc\n");
+    meta.close();
+    return true;
+}
+
+// A preallocated partial is as long as the whole file: cut it back to the
+// bytes that arrived and clear its marker so it can resume.  FS.h has no
+// truncate, so this goes through the VFS path.  False (partial dropped) if
+// the card won't truncate.
+bool WebQueue::_trimPartial(const Item& item, long validBytes) {
+    char metaPath[136];
+    resumeMetaPath(item.tmpPath, metaPath, sizeof(metaPath));
+    String validator;
+    File meta = DQ_SD_OPEN(metaPath, FILE_READ);
+    if (meta) {
+        validator = meta.readStringUntil('\n');
+        meta.close();
+        validator.trim();
+    }
+
+    char vfsPath[160];
+    snprintf(vfsPath, sizeof(vfsPath), "%s%s", DQ_SD_MOUNT, item.tmpPath);
+    if (validator.length() == 0 || truncate(vfsPath, validBytes) != 0) {
+        LOG_PRINTF(WEBQUEUE, "⚠️ [WQ] Cannot trim %s to %ld bytes — restarting it\n", item.tmpPath, validBytes);
+        _dropPartial(item);
+        return false;
+    }
+    meta = DQ_SD_OPEN(metaPath, FILE_WRITE);
+    if (!meta) {
+        _dropPartial(item);
+        return false;
+    }
+    meta.print(validator);
+    meta.print('\n');
+    meta.close();
+    return true;
+}
+
+// The body must match its Content-Length, and the .tmp the body: a
+// preallocated file is Content-Length long whatever actually arrived
+bool WebQueue::_verifySize(Slot& slot) {
+    const Item& item = _items[slot.itemIdx];
+    slot.sdFile.flush();
+    long onCard = (long)slot.sdFile.size();
+    if ((slot.expectedBytes < 0 || slot.totalBytes == slot.expectedBytes) && onCard == slot.totalBytes)
+        return true;
+    LOG_PRINTF(WEBQUEUE, "❌ [WQ] %s: %d bytes received, %ld expected, %ld on SD\n",
+                         item.audioKey, slot.totalBytes, slot.expectedBytes, onCard);
+    return false;
+}
+
+void WebQueue::_dropPartial(const Item& item) {
+    if (!item.tmpPath[0]) return;
+    char metaPath[136];
+    resumeMetaPath(item.tmpPath, metaPath, sizeof(metaPath));
+    if (DQ_SD_EXISTS(item.tmpPath)) DQ_SD_REMOVE(item.tmpPath);
+    if (DQ_SD_EXISTS(metaPath))     DQ_SD_REMOVE(metaPath);
+}
+
+// ============================================================================
+// Double-buffered SD writes
+// ============================================================================
+
+// Space left in the half being filled.  A resumed file's first half is cut
+// short so every later write starts on a WEB_QUEUE_WRITE_BUF_SIZE boundary.
+int WebQueue::_writeRoom(const Slot& slot) const {
+    return WEB_QUEUE_WRITE_BUF_SIZE - (int)(slot.writeBase % WEB_QUEUE_WRITE_BUF_SIZE) - slot.writeFill;
+}
+
+// Hand the filling half to the writer and switch to the other one.
+// Returns false (nothing changes) while the other half is still being written.
+bool WebQueue::_submitWrite(Slot& slot) {
+    if (slot.writeBusy) return false;
+    if (slot.writeFill == 0) return true;
+
+    const uint8_t* data = slot.writeBuf + slot.writeHalf * WEB_QUEUE_WRITE_BUF_SIZE;
+    size_t len = slot.writeFill;
+    slot.writeBase += slot.writeFill;
+    slot.writeHalf ^= 1;
+    slot.writeFill  = 0;
+
+    if (_writerHandle) {
+        WriteJob job = { &slot, data, len };
+        slot.writeBusy = true;
+        if (xQueueSend(_writeJobs, &job, 0) == pdTRUE) return true;
+        slot.writeBusy = false;   // Queue holds a job per slot, so unexpected
+    }
+    if (slot.sdFile.write(data, len) != len) slot.writeFailed = true;
+    slot.crc = esp_rom_crc32_le(slot.crc, data, len);
+    return true;
+}
+
+// Wait for the slot's write in flight; flush commits the filling half too
+void WebQueue::_drainWrites(Slot& slot, bool flush) {
+    while (slot.writeBusy) vTaskDelay(1);
+    if (flush && slot.writeFill > 0) {
+        _submitWrite(slot);
+        while (slot.writeBusy) vTaskDelay(1);
+    }
+    slot.writeFill = 0;
+}
+
+bool WebQueue::_startWriter() {
+#if WEB_QUEUE_SD_WRITER
+    if (_writerHandle) return true;
+    if (!_writeJobs) _writeJobs = xQueueCreate(WEB_QUEUE_SLOTS, sizeof(WriteJob));
+    if (!_writeJobs) return false;
+    // Core 1 with the rest of the SD I/O.  Above loopTask so a full half is
+    // picked up at once; the task then sleeps in the SD_MMC driver for most
+    // of the write, which is when loop() runs.
+    if (xTaskCreatePinnedToCore(_writerTask, "WQWriter", 4096, _writeJobs,
+                                WEB_QUEUE_WRITER_PRIORITY, &_writerHandle, 1) != pdPASS) {
+        _writerHandle = nullptr;
+        Logger.println("⚠️ [WQ] SD writer task failed — writing inline");
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void WebQueue::_writerTask(void* arg) {
+    QueueHandle_t jobs = (QueueHandle_t)arg;
+    WriteJob job;
+    for (;;) {
+        if (xQueueReceive(jobs, &job, portMAX_DELAY) != pdTRUE) continue;
+        if (job.slot->sdFile.write(job.data, job.len) != job.len)
+            job.slot->writeFailed = true;
+        job.slot->crc = esp_rom_crc32_le(job.slot->crc, job.data, job.len);
+        job.slot->writeBusy = false;
     }
-    if (_sdFile) _sdFile.close();
-    _bodyAccum = String();
-    _tmpPath[0] = '\0';
-    _activeIdx  = -1;
-    _totalBytes = 0;
-    _headerLen  = 0;
 }
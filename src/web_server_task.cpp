@@ -0,0 +1,84 @@
+#include "web_server_task.h"
+#include "logging.h"
+
+WebServerTask webServerTask;
+
+bool WebServerTask::start(WebServer& web)
+{
+#if WEB_SERVER_TASK
+    if (_task) return true;
+    _web = &web;
+    if (!_calls) _calls = xQueueCreate(1, sizeof(LoopCall));   // One web task, one call at a time
+    if (!_lock) _lock = xSemaphoreCreateMutex();
+    TaskHandle_t task = nullptr;
+    if (_calls && _lock) {
+        xTaskCreatePinnedToCore(taskMain, "WebHttp", WEB_SERVER_TASK_STACK, this,
+                                WEB_SERVER_TASK_PRIORITY, &task, 0);
+    }
+    if (!task) {
+        Logger.println("❌ [WEB] Failed to start WebHttp task - serving from loop()");
+        return false;
+    }
+    _task = task;
+    Logger.println("🌐 [WEB] Serving HTTP from the WebHttp task");
+    return true;
+#else
+    (void)web;
+    return false;
+#endif
+}
+
+WebServer::THandlerFunction WebServerTask::onLoop(WebServer::THandlerFunction fn)
+{
+    return [this, fn]() { runOnLoop(fn); };
+}
+
+void WebServerTask::runOnLoop(const WebServer::THandlerFunction& fn)
+{
+    if (!_task || xTaskGetCurrentTaskHandle() != _task) {
+        fn();
+        return;
+    }
+    // loop() polls at least every 100 ms, so this waits at most a tick
+    LoopCall call = { &fn, _task };
+    xQueueSend(_calls, &call, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void WebServerTask::poll()
+{
+    if (!_calls) return;
+    LoopCall call;
+    while (xQueueReceive(_calls, &call, 0) == pdTRUE) {
+        (*call.fn)();
+        xTaskNotifyGive(call.waiter);
+    }
+}
+
+void WebServerTask::lock()
+{
+    if (!_lock) return;
+    while (xSemaphoreTake(_lock, pdMS_TO_TICKS(10)) != pdTRUE) {
+        poll();
+    }
+}
+
+void WebServerTask::unlock()
+{
+    if (_lock) xSemaphoreGive(_lock);
+}
+
+// ============================================================================
+// WebHttp task (core 0)
+// ============================================================================
+
+void WebServerTask::taskMain(void* arg)
+{
+    WebServerTask* self = static_cast<WebServerTask*>(arg);
+    for (;;) {
+        xSemaphoreTake(self->_lock, portMAX_DELAY);
+        self->_web->handleClient();
+        xSemaphoreGive(self->_lock);
+        vTaskDelay(pdMS_TO_TICKS(WEB_SERVER_IDLE_MS));
+    }
+}
@@ -6,9 +6,13 @@
 #include "remote_logger.h"
 #include "notifications.h"
 #include "phone_home.h"
+#include "net_worker.h"
+#include "boot_pipeline.h"
 #include "nvs_flash.h"
 #ifndef DIAG_BUILD
 #include "extended_audio_player.h"
+#include "tunables.h"
+#include "dtmf_goertzel.h"                // For /api/dtmf/stats
 #endif
 #include "special_command_processor.h"  // For shutdownAudioForOTA
 #include <SD.h>
@@ -20,6 +24,9 @@
 #include "esp_ota_ops.h"  // For ESP-IDF OTA info
 #include <Update.h>       // For HTTP OTA
 #include "http_utils.h"
+#include "web_page.h"
+#include "web_server_task.h"
+#include "ota_updater.h"
 
 // Default OTA hostname if not specified in build flags
 #ifndef OTA_HOSTNAME
@@ -39,6 +46,23 @@ static bool otaPrepared = false;
 static unsigned long otaPrepareTime = 0;
 static const unsigned long OTA_PREPARE_TIMEOUT_MS = 300000; // 5 minutes
 
+// Last successful association and lease. Kept in RTC memory across soft
+// resets (brownout, OTA reboot, panic) and in NVS ("wifi"/"fast") across
+// power cycles; cleared with the credentials.
+#define WIFI_FAST_MAGIC 0x46415354  // "FAST"
+
+struct WiFiFastRecord {
+    uint32_t magic;
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+};
+
+RTC_NOINIT_ATTR static WiFiFastRecord rtcFastRecord;
+
 // Track one-time WiFi clear per build version
 static bool shouldClearWiFiForBuild()
 {
@@ -151,6 +175,7 @@ void clearWiFiCredentials()
     
     wifiPrefs.clear();
     wifiPrefs.end();
+    rtcFastRecord.magic = 0;
     
     Logger.println("🗑️ WiFi credentials cleared");
 }
@@ -164,20 +189,32 @@ String getSavedSSID()
         nvs_flash_init();
     }
     
-    if (!wifiPrefs.begin("wifi", true)) {
+    // Own Preferences: the config page calls this from the web task
+    Preferences prefs;
+    if (!prefs.begin("wifi", true)) {
         return "";
     }
     
-    String ssid = wifiPrefs.getString("ssid", "");
-    wifiPrefs.end();
+    String ssid = prefs.getString("ssid", "");
+    prefs.end();
     return ssid;
 }
 
 // Handle logs page request
 void handleLogs()
 {
-    String html = Logger.getLogsAsHtml();
-    server.send(200, "text/html", html);
+    ChunkedResponse out(server, 200, "text/html");
+    Logger.printLogsAsHtml(out);
+}
+
+// Log lines as JSON, oldest first; ?since=<next from the last reply> returns
+// only lines logged after it
+void handleLogsJson()
+{
+    uint32_t since = server.hasArg("since") ? (uint32_t)strtoul(server.arg("since").c_str(), nullptr, 10)
+                                            : LOG_CURSOR_OLDEST;
+    ChunkedResponse out(server, 200, "application/json");
+    Logger.printLogsAsJson(out, since);
 }
 
 // Handle WiFi credential reset
@@ -246,46 +283,8 @@ void handleWiFiTest()
     server.send(ok ? 200 : 500, "application/json", resp);
 }
 
-// Build the combined configuration page
-String buildConfigPage()
-{
-    // Get current status info
-    String currentIP = WiFi.status() == WL_CONNECTED ? WiFi.localIP().toString() : WiFi.softAPIP().toString();
-    String savedSSID = getSavedSSID();
-    String wifiMode = isConfigMode ? "AP Mode" : (WiFi.status() == WL_CONNECTED ? "Connected" : "Connecting...");
-    
-    // Get VPN status
-    bool vpnConnected = isTailscaleConnected();
-    const char* vpnIP = getTailscaleIP();
-    VPNConfig vpnConfig;
-    bool hasVpnConfig = loadVPNConfig(&vpnConfig);
-
-    // Compile-time defaults for VPN (used when NVS empty)
-#ifdef WIREGUARD_LOCAL_IP
-    const char* defaultLocalIp = WIREGUARD_LOCAL_IP;
-#else
-    const char* defaultLocalIp = "";
-#endif
-#ifdef WIREGUARD_PEER_ENDPOINT
-    const char* defaultPeerEndpoint = WIREGUARD_PEER_ENDPOINT;
-#else
-    const char* defaultPeerEndpoint = "";
-#endif
-#ifdef WIREGUARD_PEER_PUBLIC_KEY
-    const char* defaultPeerPublicKey = WIREGUARD_PEER_PUBLIC_KEY;
-#else
-    const char* defaultPeerPublicKey = "";
-#endif
-    uint16_t defaultPeerPort = WIREGUARD_PEER_PORT;
-
-    bool hasPrivateKey = (hasVpnConfig && strlen(vpnConfig.privateKey) > 0);
-#ifdef WIREGUARD_PRIVATE_KEY
-    if (!hasPrivateKey) {
-        hasPrivateKey = true; // compile-time private key available (not shown)
-    }
-#endif
-    
-    String html = R"(
+// Combined configuration page; fields are filled by configPageField()
+static const char CONFIG_PAGE[] PROGMEM = R"rawliteral(
 <!DOCTYPE html><html><head><title>Bowie Phone Config</title>
 <meta name="viewport" content="width=device-width,initial-scale=1">
 <style>
@@ -319,26 +318,9 @@ button:hover{background:#ff6b6b}
 <div class="card">
 <h3>📊 System Status</h3>
 <div class="status info">
-<strong>Current IP:</strong> )";
-    html += currentIP;
-    html += R"(<br>
-<strong>WiFi:</strong> )";
-    html += wifiMode;
-    if (savedSSID.length() > 0) {
-        html += " (";
-        html += savedSSID;
-        html += ")";
-    }
-    html += R"(<br>
-<strong>VPN:</strong> )";
-    if (vpnConnected) {
-        html += "Connected (";
-        html += vpnIP ? vpnIP : "?";
-        html += ")";
-    } else {
-        html += hasVpnConfig ? "Configured" : "Not configured";
-    }
-    html += R"(
+<strong>Current IP:</strong> %IP%<br>
+<strong>WiFi:</strong> %WIFI%<br>
+<strong>VPN:</strong> %VPN_SUMMARY%
 </div>
 </div>
 
@@ -349,9 +331,7 @@ button:hover{background:#ff6b6b}
 <div class="field">
 <label>WiFi SSID</label>
 <select id="ssid-select"></select>
-<input type="hidden" id="ssid-hidden" name="ssid" value=")";
-        html += savedSSID;
-        html += R"(">
+<input type="hidden" id="ssid-hidden" name="ssid" value="%SSID%">
 <input type="text" id="ssid-manual" placeholder="Enter SSID" style="display:none;margin-top:8px">
 </div>
 <div class="field">
@@ -375,55 +355,28 @@ button:hover{background:#ff6b6b}
 <!-- VPN Configuration -->
 <div class="card">
 <h3>🔐 VPN Configuration</h3>
-<div class="status )";
-    html += vpnConnected ? "connected" : "disconnected";
-    html += R"(">)";
-    if (vpnConnected) {
-        html += "✅ VPN Connected: ";
-        html += vpnIP ? vpnIP : "";
-    } else if (hasVpnConfig) {
-        html += "🔧 Configured (not connected)";
-    } else {
-        html += "❌ Not configured";
-    }
-    html += R"(</div>
+<div class="status %VPN_CLASS%">%VPN_STATUS%</div>
 <form action="/vpn/save" method="POST">
 <div class="field">
 <label>Local IP (your Tailscale IP)</label>
-<input type="text" name="localIp" placeholder="10.x.x.x" value=")";
-    html += hasVpnConfig ? vpnConfig.localIp : defaultLocalIp;
-    html += R"(" required>
+<input type="text" name="localIp" placeholder="10.x.x.x" value="%VPN_LOCAL_IP%" required>
 </div>
 <div class="field">
-<label>Private Key (base64)</label>)";
-    if (hasPrivateKey) {
-        html += R"(<span class="key-status">✓ Key is set</span>)";
-    }
-    html += R"(
-<input type="password" name="privateKey" placeholder=")";
-    html += hasPrivateKey ? "Enter new key to change" : "Your WireGuard private key";
-    html += R"(")";
-    html += hasPrivateKey ? "" : " required";
-    html += R"(>
+<label>Private Key (base64)</label>%KEY_STATUS%
+<input type="password" name="privateKey" placeholder="%KEY_PLACEHOLDER%"%KEY_REQUIRED%>
 <div class="help">Leave blank to keep existing key</div>
 </div>
 <div class="field">
 <label>Peer Endpoint</label>
-<input type="text" name="peerEndpoint" placeholder="relay.tailscale.com" value=")";
-    html += hasVpnConfig ? vpnConfig.peerEndpoint : defaultPeerEndpoint;
-    html += R"(" required>
+<input type="text" name="peerEndpoint" placeholder="relay.tailscale.com" value="%VPN_ENDPOINT%" required>
 </div>
 <div class="field">
 <label>Peer Public Key</label>
-<input type="text" name="peerPublicKey" placeholder="Peer's public key" value=")";
-    html += hasVpnConfig ? vpnConfig.peerPublicKey : defaultPeerPublicKey;
-    html += R"(" required>
+<input type="text" name="peerPublicKey" placeholder="Peer's public key" value="%VPN_PEER_KEY%" required>
 </div>
 <div class="field">
 <label>Peer Port</label>
-<input type="number" name="peerPort" placeholder="41641" value=")";
-    html += hasVpnConfig ? String(vpnConfig.peerPort) : String(defaultPeerPort);
-    html += R"(">
+<input type="number" name="peerPort" placeholder="41641" value="%VPN_PORT%">
 </div>
 <button type="submit">💾 Save VPN Config</button>
 </form>
@@ -439,9 +392,7 @@ button:hover{background:#ff6b6b}
 
 </div>
 <script>
-    const savedSSID = ")";
-        html += escapeJson(savedSSID);
-        html += R"(";
+    const savedSSID = "%SSID_JSON%";
     const ssidSelect = document.getElementById('ssid-select');
     const ssidHidden = document.getElementById('ssid-hidden');
     const ssidManual = document.getElementById('ssid-manual');
@@ -543,13 +494,111 @@ button:hover{background:#ff6b6b}
     loadSSIDs();
 </script>
 </body></html>
-")";
-    return html;
+)rawliteral";
+
+// Values shown on the configuration page, gathered once per request
+struct ConfigPageData {
+    String currentIP;
+    String savedSSID;
+    const char* wifiMode;
+    bool vpnConnected;
+    const char* vpnIP;
+    VPNConfig vpnConfig;
+    bool hasVpnConfig;
+    bool hasPrivateKey;
+};
+
+static void configPageField(const char* name, Print& out, void* ctx)
+{
+    const ConfigPageData& d = *static_cast<const ConfigPageData*>(ctx);
+
+    // Compile-time defaults for VPN (used when NVS empty)
+#ifdef WIREGUARD_LOCAL_IP
+    const char* defaultLocalIp = WIREGUARD_LOCAL_IP;
+#else
+    const char* defaultLocalIp = "";
+#endif
+#ifdef WIREGUARD_PEER_ENDPOINT
+    const char* defaultPeerEndpoint = WIREGUARD_PEER_ENDPOINT;
+#else
+    const char* defaultPeerEndpoint = "";
+#endif
+#ifdef WIREGUARD_PEER_PUBLIC_KEY
+    const char* defaultPeerPublicKey = WIREGUARD_PEER_PUBLIC_KEY;
+#else
+    const char* defaultPeerPublicKey = "";
+#endif
+
+    if (!strcmp(name, "IP")) {
+        out.print(d.currentIP);
+    } else if (!strcmp(name, "WIFI")) {
+        out.print(d.wifiMode);
+        if (d.savedSSID.length() > 0) {
+            out.print(" (");
+            printHtmlEscaped(out, d.savedSSID.c_str());
+            out.print(")");
+        }
+    } else if (!strcmp(name, "VPN_SUMMARY")) {
+        if (d.vpnConnected) {
+            out.printf("Connected (%s)", d.vpnIP ? d.vpnIP : "?");
+        } else {
+            out.print(d.hasVpnConfig ? "Configured" : "Not configured");
+        }
+    } else if (!strcmp(name, "SSID")) {
+        printHtmlEscaped(out, d.savedSSID.c_str());
+    } else if (!strcmp(name, "VPN_CLASS")) {
+        out.print(d.vpnConnected ? "connected" : "disconnected");
+    } else if (!strcmp(name, "VPN_STATUS")) {
+        if (d.vpnConnected) {
+            out.printf("✅ VPN Connected: %s", d.vpnIP ? d.vpnIP : "");
+        } else if (d.hasVpnConfig) {
+            out.print("🔧 Configured (not connected)");
+        } else {
+            out.print("❌ Not configured");
+        }
+    } else if (!strcmp(name, "VPN_LOCAL_IP")) {
+        printHtmlEscaped(out, d.hasVpnConfig ? d.vpnConfig.localIp : defaultLocalIp);
+    } else if (!strcmp(name, "KEY_STATUS")) {
+        if (d.hasPrivateKey) out.print(R"(<span class="key-status">✓ Key is set</span>)");
+    } else if (!strcmp(name, "KEY_PLACEHOLDER")) {
+        out.print(d.hasPrivateKey ? "Enter new key to change" : "Your WireGuard private key");
+    } else if (!strcmp(name, "KEY_REQUIRED")) {
+        if (!d.hasPrivateKey) out.print(" required");
+    } else if (!strcmp(name, "VPN_ENDPOINT")) {
+        printHtmlEscaped(out, d.hasVpnConfig ? d.vpnConfig.peerEndpoint : defaultPeerEndpoint);
+    } else if (!strcmp(name, "VPN_PEER_KEY")) {
+        printHtmlEscaped(out, d.hasVpnConfig ? d.vpnConfig.peerPublicKey : defaultPeerPublicKey);
+    } else if (!strcmp(name, "VPN_PORT")) {
+        out.print((unsigned)(d.hasVpnConfig ? d.vpnConfig.peerPort : WIREGUARD_PEER_PORT));
+    } else if (!strcmp(name, "SSID_JSON")) {
+        out.print(escapeJson(d.savedSSID));
+    }
+}
+
+// Stream the combined configuration page
+static void sendConfigPage()
+{
+    ConfigPageData d;
+    d.currentIP = WiFi.status() == WL_CONNECTED ? WiFi.localIP().toString() : WiFi.softAPIP().toString();
+    d.savedSSID = getSavedSSID();
+    d.wifiMode = isConfigMode ? "AP Mode" : (WiFi.status() == WL_CONNECTED ? "Connected" : "Connecting...");
+    
+    // Get VPN status
+    d.vpnConnected = isTailscaleConnected();
+    d.vpnIP = getTailscaleIP();
+    d.hasVpnConfig = loadVPNConfig(&d.vpnConfig);
+
+    d.hasPrivateKey = (d.hasVpnConfig && strlen(d.vpnConfig.privateKey) > 0);
+#ifdef WIREGUARD_PRIVATE_KEY
+    d.hasPrivateKey = true; // compile-time private key available (not shown)
+#endif
+
+    sendPage(server, CONFIG_PAGE, configPageField, &d);
 }
 // Web server handlers for WiFi configuration
 void handleRoot()
 {
-    server.send(200, "text/html", buildConfigPage());
+    sendConfigPage();
 }
 
 void handleSave()
@@ -602,6 +651,79 @@ static const WiFiCredential fallbackNetworks[] = {
 };
 static const int numFallbackNetworks = sizeof(fallbackNetworks) / sizeof(fallbackNetworks[0]);
 
+// ============================================================================
+// FAST RECONNECT
+// ============================================================================
+
+static bool fastConnectPending = false;   // Current attempt used the record
+static bool fastConnectStatic = false;    // ...and its lease as a static address
+static unsigned long fastConnectStarted = 0;
+
+// @p leaseHeld: the record came from RTC memory, so this chip held the lease
+// until a soft reset moments ago. The NVS copy is from before a power cycle,
+// long enough for the DHCP server to have handed the address to someone else.
+static bool loadFastRecord(WiFiFastRecord& rec, bool& leaseHeld)
+{
+    static bool rtcChecked = false;
+    leaseHeld = false;
+    if (!rtcChecked) {
+        rtcChecked = true;
+        if (esp_reset_reason() == ESP_RST_POWERON) {
+            rtcFastRecord.magic = 0;   // RTC_NOINIT holds noise after power-on
+        }
+    }
+    if (rtcFastRecord.magic == WIFI_FAST_MAGIC) {
+        rec = rtcFastRecord;
+        leaseHeld = true;
+        return true;
+    }
+    if (!wifiPrefs.begin("wifi", true)) {
+        return false;
+    }
+    size_t len = wifiPrefs.getBytes("fast", &rec, sizeof(rec));
+    wifiPrefs.end();
+    if (len != sizeof(rec) || rec.magic != WIFI_FAST_MAGIC) {
+        return false;
+    }
+    rtcFastRecord = rec;
+    return true;
+}
+
+// Records the current association; NVS is written only when it changed
+static void saveFastRecord()
+{
+    WiFiFastRecord rec = {};
+    rec.magic = WIFI_FAST_MAGIC;
+    strlcpy(rec.ssid, WiFi.SSID().c_str(), sizeof(rec.ssid));
+    const uint8_t* bssid = WiFi.BSSID();
+    if (!bssid) {
+        return;
+    }
+    memcpy(rec.bssid, bssid, sizeof(rec.bssid));
+    rec.channel = (uint8_t)WiFi.channel();
+    rec.ip = (uint32_t)WiFi.localIP();
+    rec.gateway = (uint32_t)WiFi.gatewayIP();
+    rec.subnet = (uint32_t)WiFi.subnetMask();
+
+    if (rtcFastRecord.magic == WIFI_FAST_MAGIC && memcmp(&rtcFastRecord, &rec, sizeof(rec)) == 0) {
+        return;
+    }
+    rtcFastRecord = rec;
+    if (wifiPrefs.begin("wifi", false)) {
+        wifiPrefs.putBytes("fast", &rec, sizeof(rec));
+        wifiPrefs.end();
+    }
+}
+
+static void clearFastRecord()
+{
+    rtcFastRecord.magic = 0;
+    if (wifiPrefs.begin("wifi", false)) {
+        wifiPrefs.remove("fast");
+        wifiPrefs.end();
+    }
+}
+
 // Track current network being tried (for fallback enumeration)
 static int currentNetworkIndex = -1;  // -1 = trying saved credentials
 static bool triedSavedCredentials = false;
@@ -652,6 +774,74 @@ bool hasMoreNetworksToTry() {
     return (currentNetworkIndex + 1) < numFallbackNetworks;
 }
 
+#if WIFI_FAST_CONNECT
+// Password for @p ssid from the saved or compile-time networks
+static bool findWiFiPassword(const char* ssid, String& password)
+{
+    if (wifiPrefs.begin("wifi", true)) {
+        String savedSsid = wifiPrefs.getString("ssid", "");
+        String savedPassword = wifiPrefs.getString("password", "");
+        wifiPrefs.end();
+        if (savedSsid.length() > 0 && savedSsid == ssid) {
+            password = savedPassword;
+            return true;
+        }
+    }
+    for (int i = 0; i < numFallbackNetworks; i++) {
+        if (strcmp(fallbackNetworks[i].ssid, ssid) == 0) {
+            password = fallbackNetworks[i].password;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Join the last good access point directly: no scan, and with
+ * WIFI_FAST_CONNECT_STATIC_IP after a soft reset no DHCP round trip either.
+ * The DNS servers go into the same config, so handleNetworkLoop() needn't
+ * set them again. After a power cycle the lease is never reused: DHCP.
+ * @return true if the attempt started
+ */
+static bool beginFastConnect()
+{
+    WiFiFastRecord rec;
+    bool leaseHeld;
+    String password;
+    if (!loadFastRecord(rec, leaseHeld) || !findWiFiPassword(rec.ssid, password)) {
+        return false;
+    }
+
+    Logger.printf("⚡ Fast WiFi connect: %s ch %u %02X:%02X:%02X:%02X:%02X:%02X\n",
+                  rec.ssid, rec.channel, rec.bssid[0], rec.bssid[1], rec.bssid[2],
+                  rec.bssid[3], rec.bssid[4], rec.bssid[5]);
+    WiFi.mode(WIFI_STA);
+    fastConnectStatic = false;
+#if WIFI_FAST_CONNECT_STATIC_IP
+    if (leaseHeld && rec.ip != 0) {
+        WiFi.config(IPAddress(rec.ip), IPAddress(rec.gateway), IPAddress(rec.subnet),
+                    DNS_PRIMARY_IPADDRESS, DNS_SECONDARY_IPADDRESS);
+        fastConnectStatic = true;
+    }
+#endif
+    WiFi.begin(rec.ssid, password.c_str(), rec.channel, rec.bssid);
+    fastConnectPending = true;
+    fastConnectStarted = millis();
+    return true;
+}
+
+// The fast attempt timed out: forget the record and connect normally
+static void abandonFastConnect()
+{
+    Logger.println("⚡ Fast WiFi connect failed - scanning normally");
+    fastConnectPending = false;
+    clearFastRecord();
+    WiFi.disconnect(true);
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);  // Back to DHCP
+    connectToWiFi();
+}
+#endif
+
 // Connect to WiFi using saved credentials or fallbacks
 bool connectToWiFi()
 {
@@ -668,6 +858,12 @@ bool connectToWiFi()
     
     // Reset fallback state for fresh attempt
     resetWiFiFallback();
+
+#if WIFI_FAST_CONNECT
+    if (beginFastConnect()) {
+        return true;
+    }
+#endif
     
     String ssid, password;
     if (!getNextWiFiCredentials(ssid, password)) {
@@ -687,18 +883,31 @@ bool connectToWiFi()
     return true;
 }
 
+// Stop audio and unmount the SD card before an HTTP OTA. Each step runs on
+// loop(), which owns them; the settle delays wait here, not on loop()
+static void prepareForHttpOta()
+{
+    webServerTask.runOnLoop([]() { shutdownAudioForOTA(); });
+    delay(100);
+    webServerTask.runOnLoop([]() { SD.end(); });  // Unmount SD card only - don't touch SPI or GPIO!
+    delay(500);
+}
+
 // Register all HTTP server routes - called by both config portal and normal OTA mode
 static void registerWebServerRoutes()
 {
-    // Config UI
+    // Config UI. Handlers run on the web task (web_server_task.h); the
+    // ones touching loop()'s state (WiFi, SD, audio, VPN) go through onLoop()
     server.on("/", HTTP_GET, handleRoot);
     server.on("/logs", HTTP_GET, handleLogs);
-    server.on("/save", HTTP_POST, handleSave);
-    server.on("/wifi/clear", HTTP_POST, handleWiFiClear);
+    server.on("/api/logs", HTTP_GET, handleLogsJson);
+    server.on("/save", HTTP_POST, webServerTask.onLoop(handleSave));
+    server.on("/wifi/clear", HTTP_POST, webServerTask.onLoop(handleWiFiClear));
     server.on("/wifi/scan", HTTP_GET, handleWiFiScan);
-    server.on("/wifi/test", HTTP_POST, handleWiFiTest);
+    server.on("/wifi/test", HTTP_POST, webServerTask.onLoop(handleWiFiTest));
 
-    // Deployment API
+    // Deployment API. The response and its flush delay stay on the web
+    // task; loop() only saves the credentials and restarts.
     server.on("/api/wifi", HTTP_POST, []() {
         String ssid = server.arg("ssid");
         String password = server.arg("password");
@@ -707,10 +916,10 @@ static void registerWebServerRoutes()
             return;
         }
         Logger.printf("📡 API: Saving WiFi credentials for: %s\n", ssid.c_str());
-        saveWiFiCredentials(ssid, password);
+        webServerTask.runOnLoop([&]() { saveWiFiCredentials(ssid, password); });
         server.send(200, "application/json", "{\"ok\":true,\"message\":\"Credentials saved, rebooting...\"}");
         delay(500);
-        ESP.restart();
+        webServerTask.runOnLoop([]() { ESP.restart(); });
     });
 
     server.on("/api/status", HTTP_GET, []() {
@@ -723,13 +932,20 @@ static void registerWebServerRoutes()
         server.send(200, "application/json", json);
     });
 
+#ifndef DIAG_BUILD
+    // DTMF detector statistics (?reset=1 zeroes them after reading)
+    server.on("/api/dtmf/stats", HTTP_GET, []() {
+        server.send(200, "application/json", getGoertzelStatsJson());
+        if (server.arg("reset") == "1") {
+            resetGoertzelDetectorStats();
+        }
+    });
+#endif
+
     // OTA preparation endpoint - call before OTA to release SD/SPI
     server.on("/prepareota", HTTP_GET, []() {
         Logger.println("🔄 HTTP: Preparing for OTA update...");
-        shutdownAudioForOTA();
-        delay(100);
-        SD.end();  // Unmount SD card only - don't touch SPI or GPIO!
-        delay(500);
+        prepareForHttpOta();
         otaPrepared = true;
         otaPrepareTime = millis();
         Logger.println("✅ HTTP: Ready for OTA (5 min timeout)");
@@ -738,7 +954,13 @@ static void registerWebServerRoutes()
 
     // HTTP OTA upload endpoint
     // Use: curl -F "firmware=@.pio/build/esp32dev/firmware.bin" http://DEVICE_IP/update
+    // The upload streams into Update on the web task; loop() keeps running
+    // and only does the audio and SD shutdown before the first chunk
     server.on("/update", HTTP_POST, []() {
+        if (otaUpdater.active()) {
+            server.send(409, "text/plain", "FAIL - Background OTA in progress");
+            return;
+        }
         if (Update.hasError()) {
             server.send(500, "text/plain", "FAIL - Update error");
             delay(1000);
@@ -751,16 +973,19 @@ static void registerWebServerRoutes()
     }, []() {
         HTTPUpload& upload = server.upload();
         static bool otaBeginOk = false;
+        if (otaUpdater.active()) {
+            // Update belongs to the OtaFetch task until it reboots
+            if (upload.status == UPLOAD_FILE_START) {
+                Logger.printf("⚠️ HTTP OTA: Rejected, background OTA %s\n", otaUpdater.stateName());
+            }
+            return;
+        }
         if (upload.status == UPLOAD_FILE_START) {
             Logger.printf("🔄 HTTP OTA: Receiving %s\n", upload.filename.c_str());
             // Flush remote logs before OTA overwrites firmware
-            Logger.flush();
-            esp_task_wdt_delete(NULL);
+            webServerTask.runOnLoop([]() { Logger.flush(); });
             if (!otaPrepared) {
-                shutdownAudioForOTA();
-                delay(100);
-                SD.end();  // Unmount SD card only - don't touch SPI or GPIO!
-                delay(500);
+                prepareForHttpOta();
             } else {
                 Logger.println("ℹ️ OTA already prepared, skipping shutdown");
             }
@@ -799,40 +1024,34 @@ static void registerWebServerRoutes()
                 }
             }
         } else if (upload.status == UPLOAD_FILE_END) {
-            if (!otaBeginOk) {
-                // Upload ended but never started successfully — restore WDT
-                esp_task_wdt_add(NULL);
-                return;
-            }
+            if (!otaBeginOk) return;
             if (Update.end(true)) {
                 Logger.printf("✅ HTTP OTA: Complete (%u bytes)\n", upload.totalSize);
             } else {
                 Logger.printf("❌ HTTP OTA: End failed: %s\n", Update.errorString());
-                // Flash failed — restore WDT so main loop stays protected
-                esp_task_wdt_add(NULL);
             }
         } else if (upload.status == UPLOAD_FILE_ABORTED) {
-            // Connection dropped mid-upload — restore WDT
             Logger.println("⚠️ HTTP OTA: Upload aborted");
-            esp_task_wdt_add(NULL);
+            if (otaBeginOk) Update.abort();
+            otaBeginOk = false;
         }
     });
 
     // VPN toggle endpoints
-    server.on("/vpn/on", HTTP_GET, []() {
+    server.on("/vpn/on", HTTP_GET, webServerTask.onLoop([]() {
         Logger.println("🔐 HTTP: Enabling WireGuard VPN...");
         if (initTailscaleFromConfig()) {
             server.send(200, "text/plain", "OK - VPN enabled");
         } else {
             server.send(500, "text/plain", "FAIL - VPN init failed");
         }
-    });
+    }));
 
-    server.on("/vpn/off", HTTP_GET, []() {
+    server.on("/vpn/off", HTTP_GET, webServerTask.onLoop([]() {
         Logger.println("🔓 HTTP: Disabling WireGuard VPN...");
         disconnectTailscale();
         server.send(200, "text/plain", "OK - VPN disabled");
-    });
+    }));
 
     server.on("/vpn/status", HTTP_GET, []() {
         bool connected = isTailscaleConnected();
@@ -870,17 +1089,17 @@ static void registerWebServerRoutes()
     });
 
     // Reboot endpoint
-    server.on("/reboot", HTTP_GET, []() {
+    server.on("/reboot", HTTP_GET, webServerTask.onLoop([]() {
         server.send(200, "text/plain", "OK - Rebooting...");
         delay(500);
         esp_restart();
-    });
+    }));
 
     // File upload endpoint — write raw data to SD card
     // Usage: curl -X POST --data-binary @debug_audio.raw http://DEVICE_IP/upload/debug_audio.raw
     server.on("/upload", HTTP_POST, []() {
         // Final response sent in upload handler
-    }, []() {
+    }, webServerTask.onLoop([]() {
         static File uploadFile;
         static size_t totalWritten;
         HTTPUpload& upload = server.upload();
@@ -910,11 +1129,11 @@ static void registerWebServerRoutes()
                     "{\"ok\":false,\"error\":\"Failed to open file on SD\"}");
             }
         }
-    });
+    }));
 
     // File delete endpoint — remove a file from the SD card
     // Usage: curl -X DELETE "http://DEVICE_IP/delete?path=/audio/audio_40a38a0f.m4a"
-    server.on("/delete", HTTP_DELETE, []() {
+    server.on("/delete", HTTP_DELETE, webServerTask.onLoop([]() {
         if (!server.hasArg("path")) {
             server.send(400, "application/json", "{\"ok\":false,\"error\":\"Missing 'path' parameter\"}");
             return;
@@ -934,10 +1153,13 @@ static void registerWebServerRoutes()
         } else {
             server.send(500, "application/json", "{\"ok\":false,\"error\":\"Failed to delete file\"}");
         }
-    });
+    }));
 
     initVPNConfigRoutes(&server);
     initRemoteLoggerRoutes(&server);
+#ifndef DIAG_BUILD
+    initTunableRoutes(&server);
+#endif
 }
 
 // Safer version of configuration portal startup
@@ -998,6 +1220,7 @@ bool startConfigPortalSafe()
     dnsServer.start(53, "*", apIP);
     
     // Register all web server routes
+    webServerTask.lock();
     registerWebServerRoutes();
     server.onNotFound([]() {
         server.sendHeader("Location", "/", true);
@@ -1005,6 +1228,8 @@ bool startConfigPortalSafe()
     });
     
     server.begin();
+    webServerTask.unlock();
+    webServerTask.start(server);
     Logger.println("📱 Configuration web server started");
     return true;
 }
@@ -1028,20 +1253,27 @@ void startConfigPortal()
     dnsServer.start(53, "*", apIP);
     
     // Setup web server routes
+    webServerTask.lock();
     server.on("/", handleRoot);
-    server.on("/save", HTTP_POST, handleSave);
-    server.on("/wifi/clear", HTTP_POST, handleWiFiClear);
+    server.on("/save", HTTP_POST, webServerTask.onLoop(handleSave));
+    server.on("/wifi/clear", HTTP_POST, webServerTask.onLoop(handleWiFiClear));
     server.on("/wifi/scan", HTTP_GET, handleWiFiScan);
-    server.on("/wifi/test", HTTP_POST, handleWiFiTest);
+    server.on("/wifi/test", HTTP_POST, webServerTask.onLoop(handleWiFiTest));
     server.on("/logs", handleLogs);
+    server.on("/api/logs", HTTP_GET, handleLogsJson);
     initVPNConfigRoutes(&server);
     initRemoteLoggerRoutes(&server);
+#ifndef DIAG_BUILD
+    initTunableRoutes(&server);
+#endif
     server.onNotFound([]() {
         server.sendHeader("Location", "/", true);
         server.send(302, "text/plain", "");
     });
     
     server.begin();
+    webServerTask.unlock();
+    webServerTask.start(server);
     Logger.println("📱 Configuration web server started");
 }
 
@@ -1160,9 +1392,12 @@ void startOTA()
     ArduinoOTA.begin();
     
     // Register all web server routes
+    webServerTask.lock();
     registerWebServerRoutes();
 
     server.begin();
+    webServerTask.unlock();
+    webServerTask.start(server);
     Logger.printf("✅ OTA Ready: %s:%d\n", WiFi.localIP().toString().c_str(), OTA_PORT);
     Logger.println("🌐 HTTP server started");
 }
@@ -1175,39 +1410,21 @@ void stopOTA()
 }
 
 // Pull-based OTA: Download and install firmware from a URL
-// This works over WireGuard VPN because it's an OUTBOUND connection
-bool performPullOTA(const char* firmwareUrl)
+// This works over WireGuard VPN because it's an OUTBOUND connection.
+// The OtaFetch task does the work with audio and SD still running.
+bool performPullOTA(const char* firmwareUrl, const char* sha256Hex)
 {
     Logger.printf("🔄 Pull OTA: Fetching firmware from %s\n", firmwareUrl);
     
-    // Prepare system for OTA - ONLY SD.end(), no SPI/GPIO manipulation
-    esp_task_wdt_delete(NULL);
-    shutdownAudioForOTA();
-    SD.end();
-    delay(500);  // Let SD card fully release
-    
     const esp_partition_t* otaPart = esp_ota_get_next_update_partition(NULL);
     if (otaPart) {
         Logger.printf("📋 OTA target partition: %s, size: %u bytes (%u KB)\n",
             otaPart->label, otaPart->size, otaPart->size / 1024);
     } else {
         Logger.println("⚠️ No OTA partition found!");
-    }
-    Logger.printf("📋 Free heap: %u bytes, largest block: %u bytes\n",
-        ESP.getFreeHeap(), ESP.getMaxAllocHeap());
-    
-    HttpClient http(HTTP_TIMEOUT_OTA_MS);
-    int written = http.getUpdate(firmwareUrl);
-    if (written < 0) {
-        // BUG-6 fix: restore WDT so the main loop is still protected
-        esp_task_wdt_add(NULL);
         return false;
     }
-    
-    Logger.println("🔄 Rebooting in 2 seconds...");
-    delay(2000);
-    esp_restart();
-    return true;  // Won't reach here
+    return otaUpdater.start(firmwareUrl, sha256Hex);
 }
 
 // Set OTA prepare timeout - call from serial command or HTTP endpoint
@@ -1230,7 +1447,9 @@ void handleNetworkLoop()
     {
         // Handle DNS and web server requests
         dnsServer.processNextRequest();
-        server.handleClient();
+        if (!webServerTask.running()) {
+            server.handleClient();
+        }
         
         // Start OTA in AP mode if not already started
         if (!otaStarted)
@@ -1251,6 +1470,7 @@ void handleNetworkLoop()
         if (WiFi.status() == WL_CONNECTED && !connectionLogged)
         {
             Logger.printf("✅ WiFi connected successfully!\n");
+            bootPipeline.end(BootStage::WIFI);
             Logger.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
             Logger.printf("Signal Strength: %d dBm\n", WiFi.RSSI());
             
@@ -1260,11 +1480,25 @@ void handleNetworkLoop()
             esp_ota_mark_app_valid_cancel_rollback();
             Logger.println("✅ OTA rollback protection: firmware marked valid");
             
-            // Configure public DNS servers (Google + Cloudflare) for reliable resolution
+            // Configure public DNS servers (Google + Cloudflare) for reliable resolution.
+            // A fast connect with a static lease set them with the address.
             IPAddress dns1 = DNS_PRIMARY_IPADDRESS;
             IPAddress dns2 = DNS_SECONDARY_IPADDRESS;
-            WiFi.config(WiFi.localIP(), WiFi.gatewayIP(), WiFi.subnetMask(), dns1, dns2);
+            bool dnsSet = false;
+#if WIFI_FAST_CONNECT
+            if (fastConnectPending) {
+                Logger.printf("⚡ Fast WiFi connect took %lu ms\n", millis() - fastConnectStarted);
+                dnsSet = fastConnectStatic && rtcFastRecord.ip == (uint32_t)WiFi.localIP();
+                fastConnectPending = false;
+            }
+#endif
+            if (!dnsSet) {
+                WiFi.config(WiFi.localIP(), WiFi.gatewayIP(), WiFi.subnetMask(), dns1, dns2);
+            }
             Logger.printf("🌐 DNS configured: %s, %s\n", dns1.toString().c_str(), dns2.toString().c_str());
+#if WIFI_FAST_CONNECT
+            saveFastRecord();
+#endif
             
             // Notify WiFi connected (turns on green LED)
             notify(NotificationType::WiFiConnected, true);
@@ -1273,8 +1507,11 @@ void handleNetworkLoop()
             // This ensures we can always reach the device via WireGuard for OTA updates
             if (isTailscaleEnabled()) {
                 Logger.println("🔐 WiFi connected - initializing Tailscale VPN...");
-                initTailscaleFromConfig();
-                Logger.println("✅ Tailscale VPN initialized - device should be reachable");
+                // The stage ends when the VpnLink task reports the handshake
+                bootPipeline.begin(BootStage::VPN);
+                if (!initTailscaleFromConfig()) {
+                    bootPipeline.end(BootStage::VPN, false);
+                }
                 
                 // Initialize remote logging (sends logs to server over VPN)
                 initRemoteLogger();
@@ -1311,6 +1548,14 @@ void handleNetworkLoop()
             }
             connectionStartTime = millis();
         }
+#if WIFI_FAST_CONNECT
+        else if (fastConnectPending && WiFi.status() != WL_CONNECTED &&
+                 (millis() - fastConnectStarted) > WIFI_FAST_CONNECT_TIMEOUT_MS)
+        {
+            abandonFastConnect();
+            connectionStartTime = millis();
+        }
+#endif
         else if (WiFi.status() != WL_CONNECTED && connectionStartTime > 0 && 
                  (millis() - connectionStartTime) > 15000) // 15 second timeout per network
         {
@@ -1348,9 +1593,18 @@ void handleNetworkLoop()
     }
     
     #if ENABLE_REMOTE_UPDATES
-    checkForRemoteUpdates();
+    pollRemoteUpdates();
     #endif
 
+    // Callbacks of finished background requests
+    netWorker.poll();
+
+    // Web handlers that must run on this core (web_server_task.h)
+    webServerTask.poll();
+
+    // Background OTA: hold while the phone is in use, reboot when done
+    otaUpdater.poll();
+
     // Handle OTA updates (only if started and WiFi is ready)
     if (otaStarted && (WiFi.status() == WL_CONNECTED || isConfigMode))
     {
@@ -1368,7 +1622,7 @@ void handleNetworkLoop()
         
         ArduinoOTA.handle();
         // Also handle HTTP server requests in STA mode (for OTA, VPN, status endpoints)
-        if (!isConfigMode) {
+        if (!isConfigMode && !webServerTask.running()) {
             server.handleClient();
         }
     }
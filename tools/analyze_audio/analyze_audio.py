@@ -11,6 +11,8 @@ Produces comprehensive DTMF analysis with:
 import argparse
 import os
 import glob
+import socket
+import struct
 from pathlib import Path
 from datetime import datetime
 from collections import Counter
@@ -51,6 +53,133 @@ def goertzel(samples, target_freq, sample_rate):
     return np.sqrt(real * real + imag * imag)
 
 
+# ========================================================================
+# BINARY CAPTURE STREAM (capture_stream.h)
+# ========================================================================
+BPCM_PORT = 2325
+IMA_STEP = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767,
+]
+IMA_INDEX = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def ima_decode(payload, count):
+    """Decode one self-contained IMA ADPCM frame"""
+    predictor, index = struct.unpack_from('<hB', payload, 0)
+    out = np.empty(count, dtype=np.int16)
+    for i in range(count):
+        code = (payload[4 + i // 2] >> (4 * (i & 1))) & 0x0F
+        step = IMA_STEP[index]
+        delta = step >> 3
+        if code & 4:
+            delta += step
+        if code & 2:
+            delta += step >> 1
+        if code & 1:
+            delta += step >> 2
+        predictor += -delta if code & 8 else delta
+        predictor = max(-32768, min(32767, predictor))
+        index = max(0, min(88, index + IMA_INDEX[code]))
+        out[i] = predictor
+    return out
+
+
+def read_exact(src, n):
+    """n bytes from a file or socket, or None at end of stream"""
+    buf = b''
+    while len(buf) < n:
+        chunk = src.recv(n - len(buf)) if isinstance(src, socket.socket) else src.read(n - len(buf))
+        if not chunk:
+            return None
+        buf += chunk
+    return buf
+
+
+def read_bpcm(src, max_seconds=None, save=None):
+    """Read a BPCM stream: returns (samples, rate, [(sample_offset, reason)])
+
+    Gap frames become silence, so times stay aligned with the phone's.
+    """
+    header = read_exact(src, 16)
+    if header is None or header[:4] != b'BPCM':
+        raise SystemExit("Not a BPCM capture stream")
+    codec = header[5]
+    rate = struct.unpack_from('<I', header, 8)[0]
+    trigger_mode = header[12] == 1
+    print(f"BPCM stream: {'ADPCM' if codec == 1 else 'PCM16'}, {rate} Hz"
+          f"{', trigger mode' if trigger_mode else ''}")
+    if save:
+        save.write(header)
+
+    parts, triggers, total = [], [], 0
+    limit = int(max_seconds * rate) if max_seconds else None
+    try:
+        while limit is None or total < limit:
+            head = read_exact(src, 10)
+            if head is None:
+                break
+            kind, count, _index, length = struct.unpack('<cxHIH', head)
+            payload = read_exact(src, length) if length else b''
+            if payload is None:
+                break
+            if save:
+                save.write(head + payload)
+            if kind == b'A':
+                block = ima_decode(payload, count) if codec == 1 else np.frombuffer(payload, dtype='<i2').copy()
+                parts.append(block)
+                total += len(block)
+            elif kind == b'G':
+                print(f"  gap: {count} samples lost at {total / rate:.2f}s")
+                parts.append(np.zeros(count, dtype=np.int16))
+                total += count
+            elif kind == b'T':
+                reason = payload.decode(errors='replace')
+                print(f"  trigger: {reason} at {total / rate:.2f}s")
+                triggers.append((total, reason))
+    except KeyboardInterrupt:
+        print("Stopped")
+    data = np.concatenate(parts) if parts else np.zeros(0, dtype=np.int16)
+    return data, rate, triggers
+
+
+def record_stream(target, max_seconds, save_path):
+    """Connect to a phone's capture stream (`capstream start` on the console)"""
+    host, _, port = target.partition(':')
+    port = int(port) if port else BPCM_PORT
+    print(f"Connecting to {host}:{port}... (Ctrl-C to stop)")
+    save = open(save_path, 'wb') if save_path else None
+    try:
+        with socket.create_connection((host, port), timeout=10) as sock:
+            sock.settimeout(None)
+            return read_bpcm(sock, max_seconds, save)
+    finally:
+        if save:
+            save.close()
+
+
+def load_csv(path):
+    """Samples and rate from a `debugaudio` CSV dump"""
+    rate = 22050
+    values = []
+    with open(path, 'r') as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('#'):
+                for field in line[1:].split(','):
+                    key, _, val = field.strip().partition('=')
+                    if key == 'rate' and val.isdigit():
+                        rate = int(val)
+            elif line:
+                values.extend(int(x) for x in line.split(','))
+    return np.array(values, dtype=np.int16), rate
+
+
 # ========================================================================
 # DTMF CONSTANTS
 # ========================================================================
@@ -69,11 +198,17 @@ DTMF_MAP = {
 parser = argparse.ArgumentParser(description='Analyze captured audio data from Bowie Phone')
 parser.add_argument('--input', type=str, help='Path to input CSV file')
 parser.add_argument('--output', type=str, help='Output directory for generated files')
+parser.add_argument('--stream', type=str, metavar='HOST[:PORT]',
+                    help=f'Read live from a phone running `capstream start` (port {BPCM_PORT})')
+parser.add_argument('--seconds', type=float, help='Stop a --stream after this much audio')
+parser.add_argument('--save', type=str, help='Also write the --stream to this .bpcm file')
 args = parser.parse_args()
 
 script_dir = Path(__file__).parent.absolute()
 
-if args.input:
+if args.stream:
+    input_csv = f"stream://{args.stream}"
+elif args.input:
     input_csv = args.input
 else:
     input_csv = find_most_recent_csv(str(script_dir))
@@ -96,16 +231,19 @@ template_data = {
 }
 
 print("Loading audio data...")
-data = []
-with open(input_csv, 'r') as f:
-    for line in f:
-        line = line.strip()
-        if line and not line.startswith('#'):
-            values = [int(x) for x in line.split(',')]
-            data.extend(values)
-data = np.array(data, dtype=np.int16)
-
-rate = 22050
+triggers = []
+if args.stream:
+    data, rate, triggers = record_stream(args.stream, args.seconds, args.save)
+elif input_csv.endswith('.bpcm'):
+    with open(input_csv, 'rb') as f:
+        data, rate, triggers = read_bpcm(f)
+else:
+    data, rate = load_csv(input_csv)
+if len(data) == 0:
+    print("No audio samples")
+    exit(1)
+template_data['triggers'] = [{'time': off / rate, 'reason': why} for off, why in triggers]
+
 duration_sec = len(data) / rate
 time_axis = np.arange(len(data)) / rate
 
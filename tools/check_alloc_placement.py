@@ -0,0 +1,80 @@
+"""
+Check the PSRAM placement rules from include/psram_alloc.h.
+
+  python tools/check_alloc_placement.py
+
+Rules:
+  - Every JsonDocument in src/ and include/ is constructed with psramJson().
+  - Catalog-derived headers (CATALOG_HEADERS) hold no std::vector / std::map /
+    std::unordered_map members; use PsramVector or a PsramArena instead.
+
+A line carrying "// alloc-ok" is exempt: a container already given
+PsramAllocator, or the rare case that really must stay in internal RAM. Exits non-zero with one line per violation.
+"""
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+CATALOG_HEADERS = [
+    "include/audio_key_registry.h",
+    "include/audio_playlist_registry.h",
+    "include/dtmf_trie.h",
+]
+
+JSON_DOC = re.compile(r'\bJsonDocument\s+\w+\s*(\(([^)]*)\))?\s*;')
+STD_CONTAINER = re.compile(r'\bstd::(vector|map|unordered_map)\s*<')
+EXEMPT = "// alloc-ok"
+
+
+def strip_comment(line):
+    return line.split("//", 1)[0]
+
+
+def sources():
+    for top in ("src", "include"):
+        for dirpath, _, files in os.walk(os.path.join(ROOT, top)):
+            for name in files:
+                if name.endswith((".cpp", ".h", ".ino")):
+                    yield os.path.join(dirpath, name)
+
+
+def check_json(path, lines, errors):
+    for n, line in enumerate(lines, 1):
+        if EXEMPT in line:
+            continue
+        m = JSON_DOC.search(strip_comment(line))
+        if m and "psramJson()" not in (m.group(2) or ""):
+            errors.append(f"{path}:{n}: JsonDocument without psramJson()")
+
+
+def check_catalog_header(path, lines, errors):
+    for n, line in enumerate(lines, 1):
+        if EXEMPT in line:
+            continue
+        m = STD_CONTAINER.search(strip_comment(line))
+        if m:
+            errors.append(f"{path}:{n}: std::{m.group(1)} in catalog data; use PsramVector or PsramArena")
+
+
+def main():
+    errors = []
+    for path in sources():
+        with open(path, encoding="utf-8", errors="replace") as f:
+            lines = f.read().splitlines()
+        rel = os.path.relpath(path, ROOT).replace(os.sep, "/")
+        check_json(rel, lines, errors)
+        if rel in CATALOG_HEADERS:
+            check_catalog_header(rel, lines, errors)
+    for e in errors:
+        print(e)
+    if errors:
+        print(f"{len(errors)} placement violation(s); see include/psram_alloc.h")
+        return 1
+    print("PSRAM placement rules OK")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,139 @@
+"""
+Format table and decoder for binary log records (LOG_BINARY_RECORDS=1).
+
+With binary records the firmware logs LOG_PRINTF / LOG_DEBUGF calls as
+"~<format id>:<base64 args>" instead of formatted text. The id is the FNV-1a
+hash of the format string, so the table can be rebuilt from the sources at
+any time.
+
+  python tools/log_formats.py table              Write the id -> format table
+  python tools/log_formats.py decode < log.txt   Decode records in a capture
+
+The table goes to tools/server/phone-receiver/log_formats.json by default,
+where the log receiver picks it up.
+"""
+import base64
+import json
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_TABLE = os.path.join(ROOT, "tools", "server", "phone-receiver", "log_formats.json")
+
+CALL = re.compile(rb'LOG_(?:PRINTF|DEBUGF)\(\s*\w+\s*,\s*((?:"(?:[^"\\]|\\.)*"\s*)+)')
+LITERAL = re.compile(rb'"((?:[^"\\]|\\.)*)"')
+ESCAPE = re.compile(rb'\\(x[0-9a-fA-F]{1,2}|[0-7]{1,3}|.)')
+SPEC = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diuxXcsfFeEgGp%])')
+RECORD = re.compile(r'~([0-9a-f]{8}):([A-Za-z0-9+/=]*)')
+
+SIMPLE_ESCAPES = {b'n': b'\n', b't': b'\t', b'r': b'\r', b'"': b'"', b'\\': b'\\', b"'": b"'", b'?': b'?'}
+
+
+def unescape(body):
+    def one(m):
+        e = m.group(1)
+        if e[:1] == b'x':
+            return bytes([int(e[1:], 16)])
+        if e[:1].isdigit():
+            return bytes([int(e, 8) & 0xFF])
+        return SIMPLE_ESCAPES.get(e, e)
+    return ESCAPE.sub(one, body)
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def build_table():
+    table = {}
+    for top in ("src", "include"):
+        for dirpath, _, files in os.walk(os.path.join(ROOT, top)):
+            for name in files:
+                if not name.endswith((".cpp", ".h", ".ino")):
+                    continue
+                with open(os.path.join(dirpath, name), "rb") as f:
+                    source = f.read()
+                for call in CALL.finditer(source):
+                    fmt = b"".join(unescape(m.group(1)) for m in LITERAL.finditer(call.group(1)))
+                    table["%08x" % fnv1a(fmt)] = fmt.decode("utf-8", "replace")
+    return table
+
+
+def format_record(fmt, args):
+    """printf-style formatting of the packed arguments (see LogArgs)"""
+    pos = 0
+
+    def take(n, code):
+        nonlocal pos
+        if pos + n > len(args):
+            raise ValueError("short record")
+        v = struct.unpack_from(code, args, pos)[0]
+        pos += n
+        return v
+
+    def one(m):
+        nonlocal pos
+        flags, width, prec, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(take(4, '<i'))
+        if prec == '*':
+            prec = str(take(4, '<i'))
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        wide = length == 'll'
+        if conv == 's':
+            n = take(1, '<B')
+            text = args[pos:pos + n].decode("utf-8", "replace")
+            pos += n
+            return (spec + 's') % text
+        if conv in 'fFeEgG':
+            return (spec + conv) % take(4, '<f')
+        if conv == 'p':
+            return '0x%08x' % take(4, '<I')
+        if conv == 'c':
+            return (spec + 'c') % chr(take(4, '<I') & 0xFF)
+        if conv in 'di':
+            return (spec + 'd') % take(8 if wide else 4, '<q' if wide else '<i')
+        return (spec + conv.replace('u', 'd')) % take(8 if wide else 4, '<Q' if wide else '<I')
+
+    try:
+        return SPEC.sub(one, fmt)
+    except (ValueError, struct.error):
+        return fmt + " <undecodable args>"
+
+
+def decode_line(line, table):
+    def one(m):
+        fmt = table.get(m.group(1))
+        if fmt is None:
+            return m.group(0) + " <unknown format>"
+        return format_record(fmt, base64.b64decode(m.group(2))).rstrip('\n')
+    return RECORD.sub(one, line)
+
+
+def main():
+    if len(sys.argv) < 2 or sys.argv[1] not in ("table", "decode"):
+        print(__doc__.strip())
+        return 1
+    path = sys.argv[2] if len(sys.argv) > 2 else DEFAULT_TABLE
+    if sys.argv[1] == "table":
+        table = build_table()
+        with open(path, "w", encoding="utf-8") as f:
+            json.dump(table, f, ensure_ascii=False, indent=1, sort_keys=True)
+        print("%d format(s) -> %s" % (len(table), path))
+        return 0
+    with open(path, encoding="utf-8") as f:
+        table = json.load(f)
+    for line in sys.stdin:
+        sys.stdout.write(decode_line(line, table))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
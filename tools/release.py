@@ -10,10 +10,12 @@ Custom targets:
 Set RELEASE_NOTES env var before running to attach notes:
   $env:RELEASE_NOTES = "Fixed OTA"; pio run -t release
 """
+import hashlib
 import json
 import os
 import re
 import shutil
+import struct
 import subprocess
 import sys
 
@@ -23,6 +25,8 @@ PROJECT_DIR = env.subst("$PROJECT_DIR")
 PLATFORMIO_INI = os.path.join(PROJECT_DIR, "platformio.ini")
 FIRMWARE_DIR = os.path.join(PROJECT_DIR, "docs", "firmware")
 RELEASES_JSON = os.path.join(FIRMWARE_DIR, "releases.json")
+OTA_BLOCK_SIZE = 16384          # Must not exceed OTA_MAX_BLOCK_BYTES (ota_updater.h)
+OTA_BLOCK_STORED = 0x80000000
 FRAMEWORK_DIR = os.path.join(
     os.path.expanduser("~"), ".platformio", "packages", "framework-arduinoespressif32"
 )
@@ -145,11 +149,86 @@ def _copy_firmware(env, hostname):
         print("  Copied boot_app0.bin from framework")
 
 
+# ---------------------------------------------------------------------------
+# Compressed OTA image (firmware.ota, read by src/ota_updater.cpp)
+# ---------------------------------------------------------------------------
+
+def _lz4_block(data):
+    """One LZ4 block, no frame. Uses the lz4 package when installed, else a
+    greedy pass like src/lz4_block.cpp."""
+    try:
+        import lz4.block
+        return lz4.block.compress(data, mode="high_compression", store_size=False)
+    except ImportError:
+        pass
+
+    out = bytearray()
+
+    def length(n):
+        while n >= 255:
+            out.append(255)
+            n -= 255
+        out.append(n)
+
+    def sequence(lit, offset, match):
+        token_at = len(out)
+        out.append(0)
+        token = min(len(lit), 15) << 4
+        if len(lit) >= 15:
+            length(len(lit) - 15)
+        out.extend(lit)
+        if match:
+            out.extend(struct.pack("<H", offset))
+            token |= min(match - 4, 15)
+            if match - 4 >= 15:
+                length(match - 4 - 15)
+        out[token_at] = token
+
+    table = {}
+    anchor = ip = 0
+    limit = len(data) - 12          # Match must start this far from the end
+    match_end = len(data) - 5       # ... and end this far from it
+    while ip < limit:
+        seq = data[ip:ip + 4]
+        ref = table.get(seq, -1)
+        table[seq] = ip
+        if ref < 0 or ip - ref > 0xFFFF:
+            ip += 1
+            continue
+        n = 4
+        while ip + n < match_end and data[ref + n] == data[ip + n]:
+            n += 1
+        sequence(data[anchor:ip], ip - ref, n)
+        ip += n
+        anchor = ip
+    sequence(data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def _write_ota_image(firmware_path, ota_path):
+    """firmware.bin -> header + LZ4 blocks; returns the image's SHA-256 hex."""
+    with open(firmware_path, "rb") as f:
+        image = f.read()
+    digest = hashlib.sha256(image).digest()
+    with open(ota_path, "wb") as f:
+        f.write(b"BOTA" + struct.pack("<B3xII", 1, OTA_BLOCK_SIZE, len(image)) + digest)
+        for pos in range(0, len(image), OTA_BLOCK_SIZE):
+            raw = image[pos:pos + OTA_BLOCK_SIZE]
+            packed = _lz4_block(raw)
+            if len(packed) < len(raw):
+                f.write(struct.pack("<I", len(packed)) + packed)
+            else:
+                f.write(struct.pack("<I", len(raw) | OTA_BLOCK_STORED) + raw)
+    size_kb = os.path.getsize(ota_path) / 1024
+    print(f"  Wrote firmware.ota ({size_kb:.1f} KB, {size_kb * 1024 * 100 / len(image):.0f}% of firmware.bin)")
+    return digest.hex()
+
+
 # ---------------------------------------------------------------------------
 # releases.json / manifest.json updates
 # ---------------------------------------------------------------------------
 
-def _update_releases_json(hostname, new_version, home_page, release_notes):
+def _update_releases_json(hostname, new_version, home_page, release_notes, sha256=None):
     """Update (or create) the device entry in releases.json."""
     releases = {}
     if os.path.exists(RELEASES_JSON):
@@ -157,10 +236,14 @@ def _update_releases_json(hostname, new_version, home_page, release_notes):
             releases = json.load(f)
 
     firmware_url = f"https://{home_page}/firmware/{hostname}/firmware.bin"
+    ota_url = f"https://{home_page}/firmware/{hostname}/firmware.ota"
 
     entry = releases.get(hostname, {})
     entry["version"] = new_version
     entry["firmware_url"] = firmware_url
+    if sha256:
+        entry["ota_url"] = ota_url
+        entry["sha256"] = sha256
     if release_notes:
         entry["release_notes"] = release_notes
     entry.setdefault("min_version", "0.0.0")
@@ -172,6 +255,9 @@ def _update_releases_json(hostname, new_version, home_page, release_notes):
     default_entry = releases.get("default", {})
     default_entry["version"] = new_version
     default_entry["firmware_url"] = firmware_url
+    if sha256:
+        default_entry["ota_url"] = ota_url
+        default_entry["sha256"] = sha256
     if release_notes:
         default_entry["release_notes"] = release_notes
     default_entry.setdefault("min_version", "0.0.0")
@@ -233,7 +319,8 @@ def _do_release(env, bump_part=None):
     Main release workflow:
     1. Optionally bump version
     2. Build firmware (already done by PlatformIO before custom target)
-    3. Copy firmware files to docs/firmware/<hostname>/
+    3. Copy firmware files to docs/firmware/<hostname>/, plus a compressed
+       firmware.ota for background pull OTA
     4. Update releases.json and manifest.json
     5. Git commit and push
     """
@@ -275,10 +362,14 @@ def _do_release(env, bump_part=None):
     # Copy firmware files
     print(f"\n  Copying firmware to docs/firmware/{hostname}/...")
     _copy_firmware(env, hostname)
+    firmware_path = os.path.join(FIRMWARE_DIR, hostname, "firmware.bin")
+    sha256 = None
+    if os.path.exists(firmware_path):
+        sha256 = _write_ota_image(firmware_path, os.path.join(FIRMWARE_DIR, hostname, "firmware.ota"))
 
     # Update JSON files
     print("\n  Updating release metadata...")
-    _update_releases_json(hostname, new_version, home_page, release_notes)
+    _update_releases_json(hostname, new_version, home_page, release_notes, sha256)
     _update_manifest_json(hostname, new_version)
 
     # Git
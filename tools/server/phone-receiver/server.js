@@ -9,6 +9,9 @@ const PORT = process.env.PORT || 3000;
 const LOG_DIR = process.env.LOG_DIR || './logs';
 const LOG_RETENTION_DAYS = parseInt(process.env.LOG_RETENTION_DAYS) || 30;
 const MAX_LOG_SIZE_MB = parseInt(process.env.MAX_LOG_SIZE_MB) || 100;
+const PERF_DIR = process.env.PERF_DIR || './perf';
+const PERF_REGRESSION_PCT = parseFloat(process.env.PERF_REGRESSION_PCT) || 10;
+const METRICS_DIR = process.env.METRICS_DIR || './metrics';
 
 // Ensure log directory exists
 if (!fs.existsSync(LOG_DIR)) {
@@ -21,6 +24,142 @@ app.use(express.json({ limit: '1mb' }));
 // Trust proxy for X-Forwarded-For headers
 app.set('trust proxy', true);
 
+// ── Binary log records ───────────────────────────────────────────────────────
+
+// Firmware built with LOG_BINARY_RECORDS sends "~<format id>:<base64 args>"
+// lines; tools/log_formats.py writes the id → format table this decodes with.
+const LOG_FORMATS_FILE = process.env.LOG_FORMATS || path.join(__dirname, 'log_formats.json');
+let logFormats = {};
+let logFormatsMtime = 0;
+
+function loadLogFormats() {
+    try {
+        const mtime = fs.statSync(LOG_FORMATS_FILE).mtimeMs;
+        if (mtime !== logFormatsMtime) {
+            logFormats = JSON.parse(fs.readFileSync(LOG_FORMATS_FILE, 'utf8'));
+            logFormatsMtime = mtime;
+            console.log(`Loaded ${Object.keys(logFormats).length} log formats`);
+        }
+    } catch (err) {
+        // No table: records are stored as received
+    }
+}
+
+// printf over the packed arguments: integers 4 bytes (8 with ll), floats
+// 4 bytes, strings a length byte plus text
+function formatLogRecord(fmt, args) {
+    let pos = 0;
+    const take = (n) => {
+        if (pos + n > args.length) throw new Error('short record');
+        const at = pos;
+        pos += n;
+        return at;
+    };
+    const pad = (text, flags, width) => {
+        width = parseInt(width) || 0;
+        if (text.length >= width) return text;
+        if (flags.includes('-')) return text.padEnd(width);
+        if (flags.includes('0') && /^-?[0-9a-fA-F.]+$/.test(text)) {
+            const neg = text.startsWith('-');
+            return (neg ? '-' : '') + text.slice(neg ? 1 : 0).padStart(width - (neg ? 1 : 0), '0');
+        }
+        return text.padStart(width);
+    };
+    return fmt.replace(/%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diuxXcsfFeEgGp%])/g,
+        (m, flags, width, prec, length, conv) => {
+            if (conv === '%') return '%';
+            if (width === '*') width = String(args.readInt32LE(take(4)));
+            if (prec === '*') prec = String(args.readInt32LE(take(4)));
+            const wide = length === 'll';
+            let text;
+            if (conv === 's') {
+                const n = args.readUInt8(take(1));
+                text = args.slice(pos, pos + n).toString('utf8');
+                take(n);
+                if (prec !== undefined) text = text.slice(0, parseInt(prec));
+            } else if ('fFeEgG'.includes(conv)) {
+                const v = args.readFloatLE(take(4));
+                const p = prec !== undefined ? parseInt(prec) : 6;
+                text = 'eE'.includes(conv) ? v.toExponential(p) : v.toFixed(p);
+            } else if (conv === 'p') {
+                text = '0x' + args.readUInt32LE(take(4)).toString(16).padStart(8, '0');
+            } else if (conv === 'c') {
+                text = String.fromCharCode(args.readUInt32LE(take(4)) & 0xff);
+            } else if (conv === 'd' || conv === 'i') {
+                text = String(wide ? args.readBigInt64LE(take(8)) : args.readInt32LE(take(4)));
+            } else {
+                const v = wide ? args.readBigUInt64LE(take(8)) : args.readUInt32LE(take(4));
+                text = conv === 'u' ? String(v) : v.toString(16);
+                if (conv === 'X') text = text.toUpperCase();
+            }
+            if (flags.includes('+') && 'dif'.includes(conv) && !text.startsWith('-')) text = '+' + text;
+            return pad(text, flags, width);
+        });
+}
+
+function decodeLogLine(line) {
+    return line.replace(/~([0-9a-f]{8}):([A-Za-z0-9+/=]*)/g, (m, id, b64) => {
+        const fmt = logFormats[id];
+        if (!fmt) return `${m} <unknown format>`;
+        try {
+            return formatLogRecord(fmt, Buffer.from(b64, 'base64')).replace(/\n$/, '');
+        } catch (err) {
+            return `${fmt.replace(/\n$/, '')} <undecodable args>`;
+        }
+    });
+}
+
+// ── Log frames ───────────────────────────────────────────────────────────────
+// Phones number their log frames per boot (TCP frames one at a time, HTTP
+// batches as seq_first..seq_last). The next expected seq per session lets
+// resent frames be skipped and lost ones be marked in the log. Kept in
+// memory: after a server restart the first frame is taken as it comes.
+const frameProgress = new Map();  // "<device>/<session>" -> next expected seq
+
+// Returns false when every frame in first..last was already written
+function acceptFrames(key, first, last, logFile) {
+    const next = frameProgress.get(key);
+    if (next !== undefined) {
+        if (last < next) return false;
+        if (first > next) {
+            fs.appendFileSync(logFile, `[${new Date().toISOString()}] > ... ${first - next} log frame(s) lost ...\n`);
+        }
+    }
+    frameProgress.set(key, last + 1);
+    return true;
+}
+
+// LZ4 block format (no frame header), as written by src/lz4_block.cpp
+function lz4BlockDecode(src, rawLen) {
+    const dst = Buffer.alloc(rawLen);
+    let ip = 0, op = 0;
+    while (ip < src.length) {
+        const token = src[ip++];
+        let litLen = token >> 4;
+        if (litLen === 15) {
+            let b;
+            do { b = src[ip++]; litLen += b; } while (b === 255 && ip < src.length);
+        }
+        if (ip + litLen > src.length || op + litLen > rawLen) throw new Error('bad literal run');
+        src.copy(dst, op, ip, ip + litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip >= src.length) break;
+
+        const offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        let matchLen = (token & 15) + 4;
+        if ((token & 15) === 15) {
+            let b;
+            do { b = src[ip++]; matchLen += b; } while (b === 255 && ip < src.length);
+        }
+        if (offset === 0 || offset > op || op + matchLen > rawLen) throw new Error('bad match');
+        for (let i = 0; i < matchLen; i++, op++) dst[op] = dst[op - offset];
+    }
+    if (op !== rawLen) throw new Error('short block');
+    return dst;
+}
+
 // ── Session helpers ──────────────────────────────────────────────────────────
 
 // Derive a short session id from the device's boot_id (random hex generated per boot).
@@ -205,6 +344,13 @@ app.post('/logs', (req, res) => {
         const dateStr = getDateString();
         const logFile = path.join(sessionDir, `${sessionId}_${dateStr}.log`);
 
+        // Batches carry their frame range; a repeat of one already written
+        // (the phone didn't see our reply) is acknowledged and dropped
+        if (req.body.seq_first != null && req.body.seq_last != null &&
+            !acceptFrames(`${deviceId}/${sessionId}`, req.body.seq_first, req.body.seq_last, logFile)) {
+            return res.json({ status: 'duplicate', device: deviceId, session: sessionId });
+        }
+
         // If this is a boot notification, write a compact boot marker
         if (boot) {
             const now = new Date().toISOString();
@@ -216,9 +362,10 @@ app.post('/logs', (req, res) => {
         const now = new Date().toISOString();
         const uptimeTag = uptime_sec != null ? `${uptime_sec}s` : '?';
         const rawLines = logs.replace(/\\n/g, '\n').replace(/\\r/g, '');
+        loadLogFormats();
         const formatted = rawLines.split('\n')
             .filter(l => l.trim())
-            .map(line => `[${now}] | uptime ${uptimeTag} > ${line}`)
+            .map(line => `[${now}] | uptime ${uptimeTag} > ${decodeLogLine(line)}`)
             .join('\n');
 
         if (formatted) {
@@ -243,6 +390,392 @@ app.post('/logs', (req, res) => {
     }
 });
 
+// ── Performance suite results ────────────────────────────────────────────────
+
+// `perfsuite post` on a phone sends one JSON document per run. Runs are kept
+// as JSON lines under PERF_DIR/<firmware>/<device>.jsonl.
+
+function sanitizeVersion(version) {
+    return String(version).replace(/[^a-zA-Z0-9._-]/g, '_').replace(/^\.+/, '').substring(0, 64);
+}
+
+// Numeric leaves as "decode.mp3.us_per_frame" → value
+function flattenMetrics(obj, prefix = '', out = {}) {
+    for (const [key, value] of Object.entries(obj || {})) {
+        const name = prefix ? `${prefix}.${key}` : key;
+        if (typeof value === 'number') out[name] = value;
+        else if (Array.isArray(value)) value.forEach((v, i) => {
+            if (typeof v === 'number') out[`${name}.${i}`] = v;
+        });
+        else if (value && typeof value === 'object') flattenMetrics(value, name, out);
+    }
+    return out;
+}
+
+// Throughput and heap left over are better higher; times and load lower.
+// Anything else (counts, sizes) isn't compared.
+function metricDirection(name) {
+    if (/(mbps|kbps|realtime_x)$/.test(name) || name.startsWith('heap_delta.')) return 1;
+    if (/(us_per_\w+|_us|_ms|busy_pct\.\d+|underruns)$/.test(name)) return -1;
+    return 0;
+}
+
+// Latest run per device for one firmware version
+function latestPerfRuns(firmware, device) {
+    const dir = path.join(PERF_DIR, sanitizeVersion(firmware));
+    if (!fs.existsSync(dir)) return [];
+    return fs.readdirSync(dir)
+        .filter(f => f.endsWith('.jsonl'))
+        .filter(f => !device || f === `${sanitizeDeviceId(device)}.jsonl`)
+        .map(f => {
+            const lines = fs.readFileSync(path.join(dir, f), 'utf8').split('\n').filter(l => l.trim());
+            return lines.length ? JSON.parse(lines[lines.length - 1]) : null;
+        })
+        .filter(Boolean);
+}
+
+function medianMetrics(runs) {
+    const values = {};
+    for (const run of runs) {
+        for (const [name, v] of Object.entries(flattenMetrics(run))) {
+            (values[name] = values[name] || []).push(v);
+        }
+    }
+    const out = {};
+    for (const [name, list] of Object.entries(values)) {
+        list.sort((a, b) => a - b);
+        out[name] = list[Math.floor(list.length / 2)];
+    }
+    return out;
+}
+
+// Test data for the download benchmark
+app.get('/perf/blob', (req, res) => {
+    const bytes = Math.min(parseInt(req.query.bytes) || 1048576, 16 * 1048576);
+    const chunk = crypto.randomBytes(16384);
+    res.set({ 'Content-Type': 'application/octet-stream', 'Content-Length': bytes, 'Cache-Control': 'no-store' });
+    let left = bytes;
+    const pump = () => {
+        while (left > 0) {
+            const n = Math.min(left, chunk.length);
+            left -= n;
+            if (!res.write(n === chunk.length ? chunk : chunk.subarray(0, n))) {
+                return res.once('drain', pump);
+            }
+        }
+        res.end();
+    };
+    pump();
+});
+
+app.post('/perf', (req, res) => {
+    const { device, firmware } = req.body;
+    if (!device || !firmware) {
+        return res.status(400).json({ error: 'Missing device or firmware' });
+    }
+    try {
+        const dir = path.join(PERF_DIR, sanitizeVersion(firmware));
+        fs.mkdirSync(dir, { recursive: true });
+        const run = { ...req.body, received_at: new Date().toISOString() };
+        fs.appendFileSync(path.join(dir, `${sanitizeDeviceId(device)}.jsonl`), JSON.stringify(run) + '\n');
+        console.log(`perf ${sanitizeDeviceId(device)} @ ${firmware}`);
+        res.json({ status: 'ok' });
+    } catch (err) {
+        res.status(500).json({ error: err.message });
+    }
+});
+
+// Compare the median of each device's latest run between two versions.
+// Metrics worse by more than PERF_REGRESSION_PCT are listed as regressions.
+app.get('/perf/compare', (req, res) => {
+    const { base, head, device } = req.query;
+    if (!base || !head) {
+        return res.status(400).json({ error: 'base and head firmware versions required' });
+    }
+    const baseRuns = latestPerfRuns(base, device);
+    const headRuns = latestPerfRuns(head, device);
+    if (!baseRuns.length || !headRuns.length) {
+        return res.status(404).json({ error: 'No results', base_runs: baseRuns.length, head_runs: headRuns.length });
+    }
+    const before = medianMetrics(baseRuns);
+    const after = medianMetrics(headRuns);
+    const metrics = {};
+    const regressions = [];
+    for (const [name, b] of Object.entries(before)) {
+        const direction = metricDirection(name);
+        if (!direction || !(name in after)) continue;
+        const a = after[name];
+        const change = b !== 0 ? (a - b) / Math.abs(b) * 100 : 0;
+        metrics[name] = { base: b, head: a, change_pct: Math.round(change * 10) / 10 };
+        if (-direction * change > PERF_REGRESSION_PCT) regressions.push(name);
+    }
+    res.json({
+        base, head,
+        base_runs: baseRuns.length,
+        head_runs: headRuns.length,
+        threshold_pct: PERF_REGRESSION_PCT,
+        regressions,
+        metrics
+    });
+});
+
+// Firmware versions with results
+app.get('/perf', (req, res) => {
+    if (!fs.existsSync(PERF_DIR)) return res.json({ versions: [] });
+    const versions = fs.readdirSync(PERF_DIR)
+        .filter(f => fs.statSync(path.join(PERF_DIR, f)).isDirectory())
+        .map(firmware => ({
+            firmware,
+            devices: fs.readdirSync(path.join(PERF_DIR, firmware))
+                .filter(f => f.endsWith('.jsonl'))
+                .map(f => f.replace(/\.jsonl$/, ''))
+        }));
+    res.json({ versions });
+});
+
+// All runs for one version
+app.get('/perf/:firmware', (req, res) => {
+    const dir = path.join(PERF_DIR, sanitizeVersion(req.params.firmware));
+    if (!fs.existsSync(dir)) return res.status(404).json({ error: 'No results for this firmware' });
+    const runs = fs.readdirSync(dir)
+        .filter(f => f.endsWith('.jsonl'))
+        .flatMap(f => fs.readFileSync(path.join(dir, f), 'utf8').split('\n')
+            .filter(l => l.trim()).map(l => JSON.parse(l)));
+    res.json({ firmware: req.params.firmware, runs });
+});
+
+// ── Metrics snapshots ────────────────────────────────────────────────────────
+
+// Phones send a CBOR snapshot (src/metrics.cpp) as a log frame with
+// FRAME_METRICS set, every METRICS_INTERVAL_MS. Each one is stored as a JSON
+// line under METRICS_DIR/<device>/<YYYY-MM-DD>.jsonl:
+//   { ts, device, session, firmware, up, n,
+//     counters: { "goertzel.evals": 12, ... },      since boot
+//     gauges: { "heap.internal_free": 81234, ... },
+//     histograms: { "player.copy_us": { first, log2, counts: [...] }, ... } }
+
+const latestMetrics = new Map();  // device -> last record
+
+class CborFloat {
+    constructor(value) { this.value = value; }
+}
+
+// Enough CBOR for src/metrics.cpp: ints, strings, arrays, maps (either
+// length form), floats and simple values. Floats come back as CborFloat.
+function decodeCbor(data) {
+    const BREAK = Symbol('break');
+    let pos = 0;
+    const need = (n) => {
+        if (pos + n > data.length) throw new Error('truncated CBOR');
+    };
+    const arg = (info) => {
+        if (info < 24) return info;
+        const n = { 24: 1, 25: 2, 26: 4, 27: 8 }[info];
+        if (!n) throw new Error(`unsupported CBOR length ${info}`);
+        need(n);
+        let v = 0;
+        for (let i = 0; i < n; i++) v = v * 256 + data[pos++];
+        return v;
+    };
+    const item = () => {
+        need(1);
+        const initial = data[pos++];
+        const major = initial >> 5;
+        const info = initial & 0x1f;
+        if (major === 7) {
+            if (info === 20) return false;
+            if (info === 21) return true;
+            if (info === 22 || info === 23) return null;
+            if (info === 26) { need(4); pos += 4; return new CborFloat(data.readFloatBE(pos - 4)); }
+            if (info === 27) { need(8); pos += 8; return new CborFloat(data.readDoubleBE(pos - 8)); }
+            if (info === 31) return BREAK;
+            throw new Error(`unsupported CBOR simple value ${info}`);
+        }
+        const indefinite = info === 31 && (major === 4 || major === 5);
+        const n = indefinite ? Infinity : arg(info);
+        switch (major) {
+            case 0: return n;
+            case 1: return -1 - n;
+            case 2: case 3: {
+                need(n);
+                const bytes = data.subarray(pos, pos + n);
+                pos += n;
+                return major === 3 ? bytes.toString('utf8') : bytes;
+            }
+            case 4: {
+                const out = [];
+                for (let i = 0; i < n; i++) {
+                    const v = item();
+                    if (v === BREAK) break;
+                    out.push(v);
+                }
+                return out;
+            }
+            case 5: {
+                const out = {};
+                for (let i = 0; i < n; i++) {
+                    const k = item();
+                    if (k === BREAK) break;
+                    out[k] = item();
+                }
+                return out;
+            }
+            default: throw new Error(`unsupported CBOR major type ${major}`);
+        }
+    };
+    return item();
+}
+
+// Decoded snapshot → stored record
+function metricsRecord(snapshot, meta) {
+    const record = {
+        ts: new Date().toISOString(), ...meta,
+        up: snapshot.up, n: snapshot.n,
+        counters: {}, gauges: {}, histograms: {}
+    };
+    for (const [source, values] of Object.entries(snapshot)) {
+        if (!values || typeof values !== 'object' || Array.isArray(values)) continue;
+        for (const [name, v] of Object.entries(values)) {
+            const key = `${source}.${name}`;
+            if (v instanceof CborFloat) record.gauges[key] = v.value;
+            else if (Array.isArray(v)) record.histograms[key] = { first: v[0], log2: v[1] === 1, counts: v.slice(2) };
+            else if (typeof v === 'number') record.counters[key] = v;
+        }
+    }
+    return record;
+}
+
+function storeMetrics(payload, meta) {
+    const record = metricsRecord(decodeCbor(payload), meta);
+    const dir = path.join(METRICS_DIR, meta.device);
+    fs.mkdirSync(dir, { recursive: true });
+    fs.appendFileSync(path.join(dir, `${getDateString()}.jsonl`), JSON.stringify(record) + '\n');
+    latestMetrics.set(meta.device, record);
+}
+
+// Records from the last `hours`, oldest first
+function readMetrics(hours) {
+    if (!fs.existsSync(METRICS_DIR)) return [];
+    const since = Date.now() - hours * 3600000;
+    const firstDate = new Date(since).toISOString().split('T')[0];
+    const records = [];
+    for (const device of fs.readdirSync(METRICS_DIR)) {
+        const dir = path.join(METRICS_DIR, device);
+        if (!fs.statSync(dir).isDirectory()) continue;
+        for (const f of fs.readdirSync(dir).filter(f => f.endsWith('.jsonl') && f >= `${firstDate}.jsonl`)) {
+            for (const line of fs.readFileSync(path.join(dir, f), 'utf8').split('\n')) {
+                if (!line.trim()) continue;
+                try {
+                    const r = JSON.parse(line);
+                    if (Date.parse(r.ts) >= since) records.push(r);
+                } catch (err) { /* partial line */ }
+            }
+        }
+    }
+    return records.sort((a, b) => a.ts.localeCompare(b.ts));
+}
+
+// Upper bound of the bucket holding quantile q (the last bucket's lower bound)
+function histogramQuantile(h, q) {
+    const total = h.counts.reduce((a, b) => a + b, 0);
+    if (!total) return null;
+    let seen = 0;
+    for (let i = 0; i < h.counts.length; i++) {
+        seen += h.counts[i];
+        if (seen >= q * total) {
+            const last = i === h.counts.length - 1;
+            const bound = last ? i - 1 : i;
+            return h.log2 ? h.first * 2 ** bound : h.first * (bound + 1);
+        }
+    }
+    return null;
+}
+
+// Counters and histograms are totals since boot: the change between
+// consecutive snapshots of a session is what happened in between. A value
+// that went down was reset (dtmfstats reset and the like), so the new value
+// is all there is since.
+function aggregateMetrics(records, by) {
+    const groups = new Map();
+    const previous = new Map();   // "<device>/<session>" -> record
+    for (const r of records) {
+        const name = by === 'device' ? r.device : r.firmware;
+        if (!groups.has(name)) {
+            groups.set(name, { devices: new Set(), snapshots: 0, seconds: 0, resets: 0,
+                               counters: {}, gauges: {}, histograms: {} });
+        }
+        const g = groups.get(name);
+        g.devices.add(r.device);
+        g.snapshots++;
+
+        for (const [k, v] of Object.entries(r.gauges || {})) {
+            const s = g.gauges[k] || (g.gauges[k] = { sum: 0, n: 0, min: v, max: v });
+            s.sum += v; s.n++;
+            s.min = Math.min(s.min, v);
+            s.max = Math.max(s.max, v);
+        }
+
+        const key = `${r.device}/${r.session}`;
+        const prev = previous.get(key);
+        previous.set(key, r);
+        if (!prev || prev.firmware !== r.firmware || r.up <= prev.up) continue;
+        g.seconds += r.up - prev.up;
+
+        for (const [k, v] of Object.entries(r.counters || {})) {
+            const before = prev.counters[k];
+            if (before === undefined) continue;
+            if (v < before) g.resets++;
+            g.counters[k] = (g.counters[k] || 0) + (v >= before ? v - before : v);
+        }
+        for (const [k, h] of Object.entries(r.histograms || {})) {
+            const before = prev.histograms[k];
+            if (!before || before.counts.length !== h.counts.length) continue;
+            const reset = h.counts.some((c, i) => c < before.counts[i]);
+            const acc = g.histograms[k] || (g.histograms[k] = { first: h.first, log2: h.log2, counts: h.counts.map(() => 0) });
+            h.counts.forEach((c, i) => { acc.counts[i] += reset ? c : c - before.counts[i]; });
+        }
+    }
+
+    const out = {};
+    for (const [name, g] of groups) {
+        const hours = g.seconds / 3600;
+        const counters = {};
+        for (const [k, total] of Object.entries(g.counters)) {
+            counters[k] = { total, per_hour: hours > 0 ? Math.round(total / hours * 10) / 10 : null };
+        }
+        const gauges = {};
+        for (const [k, s] of Object.entries(g.gauges)) {
+            gauges[k] = { mean: Math.round(s.sum / s.n * 10) / 10, min: s.min, max: s.max };
+        }
+        const histograms = {};
+        for (const [k, h] of Object.entries(g.histograms)) {
+            histograms[k] = { ...h, p50: histogramQuantile(h, 0.5), p95: histogramQuantile(h, 0.95) };
+        }
+        out[name] = {
+            devices: [...g.devices], snapshots: g.snapshots,
+            hours: Math.round(hours * 100) / 100, resets: g.resets,
+            counters, gauges, histograms
+        };
+    }
+    return out;
+}
+
+// Latest snapshot per device (since the server started)
+app.get('/metrics', (req, res) => {
+    res.json({ devices: Object.fromEntries(latestMetrics) });
+});
+
+// Rates, gauge ranges and merged histograms per firmware version (or device)
+app.get('/metrics/fleet', (req, res) => {
+    const by = req.query.by === 'device' ? 'device' : 'firmware';
+    const hours = Math.min(parseFloat(req.query.hours) || 24, 24 * LOG_RETENTION_DAYS);
+    try {
+        res.json({ by, hours, groups: aggregateMetrics(readMetrics(hours), by) });
+    } catch (err) {
+        res.status(500).json({ error: err.message });
+    }
+});
+
 // Simple web UI for viewing logs
 app.get('/', (req, res) => {
     res.send(`
@@ -370,11 +903,20 @@ function rotateLogsIfNeeded(deviceDir) {
 
 // ── Phone log intake ─────────────────────────────────────────────────────────
 // Persistent TCP server that accepts outbound connections FROM phones.
-// The phone sends a handshake: "BOWIE-LOG device=<id> boot=<bootId> firmware=<ver>\n"
-// Server replies "BOWIE-ACK\n".  All subsequent data is raw log text, appended to
-// the session log file.
+// The phone sends a handshake:
+//   "BOWIE-LOG device=<id> boot=<bootId> firmware=<ver> proto=2\n"
+// Server replies "BOWIE-ACK proto=2 next=<seq> metrics=1\n", where seq is
+// the first frame it hasn't written for this session. Then the phone sends
+//   'F' flags:u8 seq:u32 rawLen:u16 len:u16 payload[len]   (little-endian)
+// with flags bit 0 marking an LZ4 block and bit 1 a metrics snapshot (sent
+// only to servers that said metrics=1), and the server answers each with
+//   'K' seq:u32
+// Phones without "proto=" get "BOWIE-ACK\n" and send raw log text.
 
 const PHONE_INTAKE_PORT = parseInt(process.env.PHONE_INTAKE_PORT) || 2324;
+const FRAME_HEADER_BYTES = 10;
+const FRAME_LZ4 = 0x01;
+const FRAME_METRICS = 0x02;
 
 // Track active phone intake connections: deviceId -> { socket, sessionDir, logStream }
 const activePhoneConnections = new Map();
@@ -384,9 +926,12 @@ const phoneIntake = net.createServer((socket) => {
     console.log(`📡 Phone intake: connection from ${remoteAddr}`);
 
     let handshakeDone = false;
-    let buf = '';
+    let buf = Buffer.alloc(0);
     let deviceId = null;
     let logFilePath = null;
+    let framed = false;
+    let progressKey = null;
+    let metricsMeta = null;
 
     // Close if no handshake within 10 seconds
     const handshakeTimeout = setTimeout(() => {
@@ -396,18 +941,53 @@ const phoneIntake = net.createServer((socket) => {
         }
     }, 10000);
 
+    // Write out every complete frame in buf and acknowledge it
+    function drainFrames() {
+        while (buf.length >= FRAME_HEADER_BYTES) {
+            if (buf[0] !== 0x46 /* 'F' */) {
+                console.log(`📡 Phone intake: bad frame from ${deviceId}, closing`);
+                socket.destroy();
+                return;
+            }
+            const flags = buf[1];
+            const seq = buf.readUInt32LE(2);
+            const rawLen = buf.readUInt16LE(6);
+            const len = buf.readUInt16LE(8);
+            if (buf.length < FRAME_HEADER_BYTES + len) return;
+
+            const payload = buf.subarray(FRAME_HEADER_BYTES, FRAME_HEADER_BYTES + len);
+            buf = buf.subarray(FRAME_HEADER_BYTES + len);
+            if (acceptFrames(progressKey, seq, seq, logFilePath)) {
+                try {
+                    const data = (flags & FRAME_LZ4) ? lz4BlockDecode(payload, rawLen) : payload;
+                    if (flags & FRAME_METRICS) {
+                        storeMetrics(data, metricsMeta);
+                    } else {
+                        appendLogData(logFilePath, decodeLogLine(data.toString()));
+                    }
+                } catch (err) {
+                    console.log(`📡 Phone intake: undecodable frame ${seq} from ${deviceId}: ${err.message}`);
+                }
+            }
+            const ack = Buffer.alloc(5);
+            ack[0] = 0x4b;  // 'K'
+            ack.writeUInt32LE(seq, 1);
+            socket.write(ack);
+        }
+    }
+
     socket.on('data', (data) => {
+        buf = Buffer.concat([buf, data]);
         if (!handshakeDone) {
-            buf += data.toString();
-            const nl = buf.indexOf('\n');
+            const nl = buf.indexOf(0x0a);
             if (nl < 0) return;
 
             clearTimeout(handshakeTimeout);
-            const line = buf.substring(0, nl).trim();
-            const remainder = buf.substring(nl + 1);
+            const line = buf.subarray(0, nl).toString().trim();
+            buf = buf.subarray(nl + 1);
 
-            // Parse: BOWIE-LOG device=<id> boot=<bootId> firmware=<ver>
-            const match = line.match(/^BOWIE-LOG\s+device=(\S+)\s+boot=(\S+)(?:\s+firmware=(\S+))?$/);
+            // Parse: BOWIE-LOG device=<id> boot=<bootId> firmware=<ver> proto=<n>
+            const match = line.match(/^BOWIE-LOG\s+device=(\S+)\s+boot=(\S+)(?:\s+firmware=(\S+))?(?:\s+proto=(\d+))?$/);
             if (!match) {
                 console.log(`📡 Phone intake: bad handshake from ${remoteAddr}: ${line}`);
                 socket.write('ERROR bad handshake\n');
@@ -418,6 +998,7 @@ const phoneIntake = net.createServer((socket) => {
             deviceId = sanitizeDeviceId(match[1]);
             const bootId = match[2];
             const firmware = match[3] || 'unknown';
+            framed = match[4] === '2';
 
             // Create or reuse session
             const { sessionId, sessionDir } = resolveSession(deviceId, bootId, {
@@ -427,24 +1008,30 @@ const phoneIntake = net.createServer((socket) => {
 
             const dateStr = new Date().toISOString().split('T')[0];
             logFilePath = path.join(sessionDir, `${sessionId}_${dateStr}.log`);
-
-            socket.write('BOWIE-ACK\n');
+            progressKey = `${deviceId}/${sessionId}`;
+            metricsMeta = { device: deviceId, session: sessionId, firmware: sanitizeVersion(firmware) };
+
+            if (framed) {
+                loadLogFormats();
+                socket.write(`BOWIE-ACK proto=2 next=${frameProgress.get(progressKey) || 0} metrics=1\n`);
+            } else {
+                socket.write('BOWIE-ACK\n');
+            }
             handshakeDone = true;
 
-            console.log(`📡 Phone intake: ${deviceId} (boot=${bootId}) connected, logging to ${logFilePath}`);
+            console.log(`📡 Phone intake: ${deviceId} (boot=${bootId}${framed ? ', framed' : ''}) connected, logging to ${logFilePath}`);
 
             // Store active connection
             activePhoneConnections.set(deviceId, { socket, sessionDir, logFilePath });
-
-            // Write any remainder after the handshake line
-            if (remainder.length > 0) {
-                appendLogData(logFilePath, remainder);
-            }
-            return;
         }
 
-        // Post-handshake: raw log data, append to file
-        appendLogData(logFilePath, data.toString());
+        if (framed) {
+            drainFrames();
+        } else if (buf.length > 0) {
+            // Raw log data, append to file
+            appendLogData(logFilePath, buf.toString());
+            buf = Buffer.alloc(0);
+        }
     });
 
     socket.on('error', (err) => {
@@ -734,6 +1321,7 @@ app.get('/telnet/:device', (req, res) => {
 app.listen(PORT, '0.0.0.0', () => {
     console.log(`📡 Phone Log Receiver running on port ${PORT}`);
     console.log(`   Log directory: ${LOG_DIR}`);
+    console.log(`   Metrics directory: ${METRICS_DIR}`);
     console.log(`   Retention: ${LOG_RETENTION_DAYS} days`);
     console.log(`   Max size per device: ${MAX_LOG_SIZE_MB} MB`);
 });